@@ -41,6 +41,8 @@
 #include "ffactory.h"
 #include "saveloadstatus.h"
 #include "wwprofile.h"
+#include "workerpool.h"
+#include "systimer.h"
 
 ///////////////////////////////////////////////////////////////////////
 //	Local prototypes
@@ -251,13 +253,16 @@ void
 AssetDependencyManager::Load_Assets (ChunkLoadClass &cload)
 {
 	WWLOG_PREPARE_TIME_AND_MEMORY("AssetDependencyManager::Load_Assets (ChunkLoadClass &cload)");
+	WW3DAssetManager *asset_mgr = WW3DAssetManager::Get_Instance ();
+	DynamicVectorClass<StringClass> filename_list;
+
 	cload.Open_Chunk ();
 	WWASSERT (cload.Cur_Chunk_ID () == CHUNKID_FILE_LIST);
 	if (cload.Cur_Chunk_ID () == CHUNKID_FILE_LIST) {
 
 		//
 		//	Read the filename of each asset from the chunk and
-		// load its assets into the asset manager.
+		// collect the ones the asset manager doesn't have yet.
 		//
 		while (cload.Open_Micro_Chunk ()) {
 			switch (cload.Cur_Micro_Chunk_ID ())
@@ -277,15 +282,17 @@ AssetDependencyManager::Load_Assets (ChunkLoadClass &cload)
 					//
 					StringClass render_obj_name(0,true);
 					::Asset_Name_From_Filename (render_obj_name,filename);
-					INIT_SUB_STATUS(filename);
 
 					//
-					//	Load the assets from this file into the asset manager
+					//	Skip files already loaded or already in the list
 					//
-					if (WW3DAssetManager::Get_Instance ()->Render_Obj_Exists (render_obj_name) == false) {
-						WW3DAssetManager::Get_Instance ()->Load_3D_Assets (filename);
+					bool skip = asset_mgr->Render_Obj_Exists (render_obj_name);
+					for (int index = 0; !skip && index < filename_list.Count (); index ++) {
+						skip = (filename_list[index].Compare_No_Case (filename) == 0);
+					}
+					if (skip == false) {
+						filename_list.Add (filename);
 					}
-//	WWLOG_INTERMEDIATE(filename);
 				}
 				break;
 
@@ -299,6 +306,28 @@ AssetDependencyManager::Load_Assets (ChunkLoadClass &cload)
 	}
 
 	cload.Close_Chunk ();
+
+	//
+	//	Load the files into the asset manager. The worker pool reads (and where
+	// it can, parses) the files while this thread adds them in list order.
+	//
+	int count = filename_list.Count ();
+	if (count > 0) {
+		DynamicVectorClass<const char *> name_ptrs;
+		for (int index = 0; index < count; index ++) {
+			name_ptrs.Add (filename_list[index]);
+		}
+
+		StringClass status(0,true);
+		status.Format ("%d files", count);
+		INIT_SUB_STATUS(status);
+
+		unsigned long start_time = TIMEGETTIME ();
+		asset_mgr->Load_3D_Assets_Batched (&name_ptrs[0], count);
+		WWDEBUG_SAY (("Preloaded %d asset files on %d worker threads in %d ms\r\n",
+				count, WorkerPoolClass::Get_Thread_Count (), TIMEGETTIME () - start_time));
+	}
+
 	return ;
 }
 
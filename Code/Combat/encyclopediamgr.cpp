@@ -83,6 +83,7 @@ const char *ENCY_INI_FILENAMES[EncyclopediaMgrClass::TYPE_COUNT] =
 ///////////////////////////////////////////////////////////////////////
 BooleanVectorClass	EncyclopediaMgrClass::KnownObjectVector[TYPE_COUNT];
 BooleanVectorClass	EncyclopediaMgrClass::CopyOfKnownObjectVector[TYPE_COUNT];
+bool						EncyclopediaMgrClass::IsChanged = true;
 
 
 //////////////////////////////////////////////////////////////////////
@@ -101,6 +102,7 @@ EncyclopediaMgrClass::Initialize (void)
 	}
 
 	Store_Data ();
+	IsChanged = true;
 	return ;
 }
 
@@ -120,6 +122,7 @@ EncyclopediaMgrClass::Shutdown (void)
 		KnownObjectVector[index].Clear ();
 	}
 
+	IsChanged = true;
 	return ;
 }
 
@@ -187,6 +190,7 @@ EncyclopediaMgrClass::Reveal_Object (TYPE type, int object_id)
 	if (IS_MISSION && object_id < KnownObjectVector[type].Length ()) {
 		retval = (KnownObjectVector[type][object_id] != true);
 		KnownObjectVector[type][object_id] = true;
+		IsChanged |= retval;
 	}
 	
 	return retval;
@@ -223,6 +227,7 @@ void
 EncyclopediaMgrClass::Reveal_Objects (TYPE type)
 {
 	KnownObjectVector[type].Set ();
+	IsChanged = true;
 	return ;
 }
 
@@ -242,6 +247,7 @@ EncyclopediaMgrClass::Reveal_All_Objects (void)
 		KnownObjectVector[index].Set ();
 	}
 
+	IsChanged = true;
 	return ;
 }
 
@@ -255,6 +261,7 @@ void
 EncyclopediaMgrClass::Hide_Objects (TYPE type)
 {
 	KnownObjectVector[type].Reset ();
+	IsChanged = true;
 	return ;
 }
 
@@ -274,6 +281,7 @@ EncyclopediaMgrClass::Hide_All_Objects (void)
 		KnownObjectVector[index].Reset ();
 	}
 
+	IsChanged = true;
 	return ;
 }
 
@@ -492,5 +500,6 @@ EncyclopediaMgrClass::Restore_Data (void)
 		KnownObjectVector[index] = CopyOfKnownObjectVector[index];
 	}
 	
+	IsChanged = true;
 	return ;
 }
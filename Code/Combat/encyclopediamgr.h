@@ -132,6 +132,13 @@ private:
 	bool					Save (ChunkSaveClass &csave);
 	bool					Load (ChunkLoadClass &cload);
 	const char *		Name (void) const					{ return "EncyclopediaMgrClass"; }
+
+	//
+	//	Save only reads the known object bits, which are marked changed whenever they are set
+	//
+	bool					Is_Save_Thread_Safe (void) const	{ return true; }
+	bool					Has_Changed (void) const			{ return IsChanged; }
+	void					Clear_Changed (void)					{ IsChanged = false; }
 								
 	//							
 	//	Save load support	
@@ -148,6 +155,7 @@ private:
 	///////////////////////////////////////////////////////////////////	
 	static BooleanVectorClass	KnownObjectVector[TYPE_COUNT];
 	static BooleanVectorClass	CopyOfKnownObjectVector[TYPE_COUNT];
+	static bool						IsChanged;
 };
 
 
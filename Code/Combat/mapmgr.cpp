@@ -80,6 +80,7 @@ Vector2			MapMgrClass::MapScale (0, 0);
 Vector2			MapMgrClass::MapSize (0, 0);
 uint32			MapMgrClass::CloudVector[CLOUD_VECTOR_SIZE] = { 0 };
 bool				MapMgrClass::EnableVTOL = false;
+bool				MapMgrClass::IsChanged = true;
 
 ////////////////////////////////////////////////////////////////
 //
@@ -145,6 +146,7 @@ MapMgrClass::Set_Map_Texture (const char *filename)
 	//	Cache the texture name
 	//
 	MapTextureName = filename;
+	IsChanged = true;
 	return ;
 }
 
@@ -190,7 +192,8 @@ MapMgrClass::Save (ChunkSaveClass &csave)
 bool
 MapMgrClass::Load (ChunkLoadClass &cload)
 {
-	
+	IsChanged = true;
+
 	while (cload.Open_Chunk ()) {
 		switch (cload.Cur_Chunk_ID ()) {
 			
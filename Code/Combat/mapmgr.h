@@ -95,10 +95,10 @@ public:
 	//
 
 	static const Vector2 &	Get_Map_Scale (void)							{ return MapScale; }
-	static void					Set_Map_Scale (const Vector2 &scale)	{ MapScale = scale; }
+	static void					Set_Map_Scale (const Vector2 &scale)	{ MapScale = scale; IsChanged = true; }
 
 	static const Vector2 &	Get_Map_Center (void)						{ return MapCenterPoint; }
-	static void					Set_Map_Center (const Vector2 &pos)		{ MapCenterPoint = pos; }
+	static void					Set_Map_Center (const Vector2 &pos)		{ MapCenterPoint = pos; IsChanged = true; }
 
 	//
 	//	Cloud support
@@ -107,14 +107,14 @@ public:
 	static void					Clear_Cloud_Cells (const Vector3 &pos, int pixel_radius);
 	static void					Clear_Cloud_Cell (int x_pos, int y_pos);
 	static void					Clear_Cloud_Cell_By_Pixel (int x_pos, int y_pos);
-	static void					Clear_All_Cloud_Cells (void)				{ ::memset (CloudVector, 0, sizeof (CloudVector)); }
-	static void					Cloud_All_Cells (void)						{ ::memset (CloudVector, 0xFF, sizeof (CloudVector)); }
+	static void					Clear_All_Cloud_Cells (void)				{ ::memset (CloudVector, 0, sizeof (CloudVector)); IsChanged = true; }
+	static void					Cloud_All_Cells (void)						{ ::memset (CloudVector, 0xFF, sizeof (CloudVector)); IsChanged = true; }
 	static bool					Is_Cell_Visible (int x_pos, int y_pos);
 
 	//
 	// VTOL Support.  Some maps do not support VTOL aircraft.
 	//
-	static void					Enable_VTOL_Vehicles(bool onoff)			{ EnableVTOL = onoff; }		
+	static void					Enable_VTOL_Vehicles(bool onoff)			{ EnableVTOL = onoff; IsChanged = true; }		
 	static bool					Are_VTOL_Vehicles_Enabled(void)			{ return EnableVTOL; }
 
 	//
@@ -125,14 +125,14 @@ public:
 	//
 	//	Title support
 	//
-	static void					Set_Map_Title (int string_id)	{ MapTitleID = string_id; }
+	static void					Set_Map_Title (int string_id)	{ MapTitleID = string_id; IsChanged = true; }
 	static int					Get_Map_Title (void)				{ return MapTitleID; }
 
 	//
 	//	Player marker control
 	//
 	static bool					Is_Player_Marker_Visible (void)	{ return IsPlayerMarkerVisible; }
-	static void					Show_Player_Marker (bool onoff)	{ IsPlayerMarkerVisible = onoff; }
+	static void					Show_Player_Marker (bool onoff)	{ IsPlayerMarkerVisible = onoff; IsChanged = true; }
 
 protected:
 
@@ -144,6 +144,13 @@ protected:
 	void							On_Post_Load (void);
 	const char *				Name (void) const					{ return "MapMgrClass"; }	
 
+	//
+	//	Save only reads the map settings and the shroud, every setter above marks them changed
+	//
+	bool							Is_Save_Thread_Safe (void) const	{ return true; }
+	bool							Has_Changed (void) const			{ return IsChanged; }
+	void							Clear_Changed (void)					{ IsChanged = false; }
+
 	//
 	//	Save load support
 	//
@@ -162,6 +169,7 @@ private:
 	static Vector2			MapSize;
 	static uint32			CloudVector[CLOUD_VECTOR_SIZE];
 	static bool				EnableVTOL;
+	static bool				IsChanged;
 };
 
 
@@ -205,7 +213,10 @@ MapMgrClass::Clear_Cloud_Cell (const Vector3 &pos)
 	//
 	//	Clear the bit
 	//
-	CloudVector[index] &= ~(1 << bit);
+	if (CloudVector[index] & (1 << bit)) {
+		CloudVector[index] &= ~(1 << bit);
+		IsChanged = true;
+	}
 	return ;
 }
 
@@ -238,7 +249,10 @@ MapMgrClass::Clear_Cloud_Cell (int x_pos, int y_pos)
 	//
 	//	Clear the bit
 	//
-	CloudVector[index] &= ~(1 << bit);
+	if (CloudVector[index] & (1 << bit)) {
+		CloudVector[index] &= ~(1 << bit);
+		IsChanged = true;
+	}
 	return ;
 }
 
@@ -277,7 +291,10 @@ MapMgrClass::Clear_Cloud_Cell_By_Pixel (int x_pos, int y_pos)
 	//
 	//	Clear the bit
 	//
-	CloudVector[index] &= ~(1 << bit);
+	if (CloudVector[index] & (1 << bit)) {
+		CloudVector[index] &= ~(1 << bit);
+		IsChanged = true;
+	}
 	return ;
 }
 
@@ -60,6 +60,7 @@
 #include "wwprofile.h"
 #include <stdlib.h>
 #include "specialbuilds.h"
+#include "savesnapshot.h"
 
 /*
 **
@@ -70,6 +71,12 @@ WideStringClass	SaveGameManager::Description;
 int				SaveGameManager::MissionDescriptionID = 0;
 const char *	SaveGameManager::DefaultDefinitionFilename = "Objects.DDB";
 
+/*
+** Bytes from the last autosave.  Sub-systems which haven't changed since then are written
+** from here instead of being saved again.
+*/
+static SaveSnapshotClass	_AutosaveSnapshot;
+
 /*
 **
 */
@@ -97,6 +104,27 @@ enum	{
 **
 */
 void _cdecl SaveGameManager::Save_Game( const char * filename, ... )
+{
+	va_list arg_list;
+	va_start( arg_list, filename );
+	Save_Game_File( filename, NULL, arg_list );
+	va_end( arg_list );
+}
+
+void _cdecl SaveGameManager::Save_Autosave_Game( const char * filename, ... )
+{
+	va_list arg_list;
+	va_start( arg_list, filename );
+	Save_Game_File( filename, &_AutosaveSnapshot, arg_list );
+	va_end( arg_list );
+}
+
+void	SaveGameManager::Reset_Autosave( void )
+{
+	_AutosaveSnapshot.Reset();
+}
+
+void	SaveGameManager::Save_Game_File( const char * filename, SaveSnapshotClass * snapshot, va_list arg_list )
 {
 	Debug_Say(( "Save Game %s\n", filename ));
 	CurrentGameFilename = filename;
@@ -117,26 +145,25 @@ void _cdecl SaveGameManager::Save_Game( const char * filename, ... )
 
 		_ConversationMgrSaveLoad.Set_Category_To_Save (ConversationMgrClass::CATEGORY_LEVEL);
 
-		SaveLoadSystemClass::Save( csave, _CombatSaveLoad );
-		SaveLoadSystemClass::Save( csave, _ConversationMgrSaveLoad );
-		SaveLoadSystemClass::Save( csave, _PhysDynamicSaveSystem );
-		SaveLoadSystemClass::Save( csave, _TheEncyclopediaMgrSaveLoadSubsystem );
-		SaveLoadSystemClass::Save( csave, _DynamicAudioSaveLoadSubsystem );
-		SaveLoadSystemClass::Save( csave, _TheMapMgrSaveLoadSubsystem );
-
-		va_list arg_list;
-		va_start( arg_list, filename );
+		DynamicVectorClass<SaveLoadSubSystemClass *> sub_systems;
+		sub_systems.Add( &_CombatSaveLoad );
+		sub_systems.Add( &_ConversationMgrSaveLoad );
+		sub_systems.Add( &_PhysDynamicSaveSystem );
+		sub_systems.Add( &_TheEncyclopediaMgrSaveLoadSubsystem );
+		sub_systems.Add( &_DynamicAudioSaveLoadSubsystem );
+		sub_systems.Add( &_TheMapMgrSaveLoadSubsystem );
 
 		bool done = false;
 		while ( !done ) {
 			SaveLoadSubSystemClass * sub_system = va_arg( arg_list, SaveLoadSubSystemClass * );
 			if ( sub_system != NULL ) {
-				SaveLoadSystemClass::Save( csave, *sub_system );
+				sub_systems.Add( sub_system );
 			} else {
 				done = true;
 			}
 		}
-		va_end (arg_list);
+
+		SaveLoadSystemClass::Save( csave, &sub_systems[0], sub_systems.Count(), snapshot );
 
 	csave.End_Chunk();
 
@@ -242,6 +269,7 @@ void	SaveGameManager::Load_Game( const char * filename )
 	WWMEMLOG(MEM_GAMEDATA);
 	Debug_Say(( "Load Game %s\n", filename ));
 	CurrentGameFilename = filename;
+	Reset_Autosave();
 
 	FileClass * file = _TheFileFactory->Get_File( filename );
 	WWASSERT( file );
@@ -522,19 +550,24 @@ void _cdecl SaveGameManager::Save_Save_Load_System( const char * filename, ... )
 	file->Open(FileClass::WRITE);
 	ChunkSaveClass csave(file);
 
+	DynamicVectorClass<SaveLoadSubSystemClass *> sub_systems;
 	va_list arg_list;
 	va_start( arg_list, filename );
 	bool done = false;
 	while ( !done ) {
 		SaveLoadSubSystemClass * sub_system = va_arg( arg_list, SaveLoadSubSystemClass * );
 		if ( sub_system != NULL ) {
-			SaveLoadSystemClass::Save( csave, *sub_system );
+			sub_systems.Add( sub_system );
 		} else {
 			done = true;
 		}
 	}
 	va_end (arg_list);
 
+	if ( sub_systems.Count() > 0 ) {
+		SaveLoadSystemClass::Save( csave, &sub_systems[0], sub_systems.Count() );
+	}
+
 	file->Close();
 	_TheWritingFileFactory->Return_File(file);
 }
@@ -41,6 +41,8 @@
 #include "wwstring.h"
 #include "widestring.h"
 
+class SaveSnapshotClass;
+
 /*
 **
 */
@@ -68,6 +70,8 @@ public:
 
 	// LDD Access - Editor only calls Save_Game, App calls both
 	static void _cdecl Save_Game( const char * filename, ... );
+	static void _cdecl Save_Autosave_Game( const char * filename, ... );
+	static void	Reset_Autosave( void );
 	static void	Load_Game( const char * filename );
 	static void	Pre_Load_Game( const char * filename, StringClass &filename_to_load, StringClass &lsd_filename );
 	static const char * Get_Current_Game_Filename( void )	{ return CurrentGameFilename; }
@@ -85,6 +89,8 @@ public:
 	static void _cdecl Save_Save_Load_System( const char * filename, ... );
 
 protected:
+	static void	Save_Game_File( const char * filename, SaveSnapshotClass * snapshot, va_list arg_list );
+
 	static StringClass		MapFilename;
 	static StringClass		CurrentGameFilename;
 	static WideStringClass	Description;
@@ -46,6 +46,8 @@
 #include "persistfactory.h"
 #include "combatchunkid.h"
 #include "wwprofile.h"
+#include "wwmemlog.h"
+#include "framearena.h"
 
 #include "win.h"
 //#include "systimer.h"		// for timegettime
@@ -111,6 +113,37 @@ void FrameTimeHistogramClass::Get_Report(unsigned* counts)
 	}
 }
 
+// Total number of frames added since the last reset.
+unsigned FrameTimeHistogramClass::Get_Total() const
+{
+	unsigned total=0;
+	for (unsigned i=0;i<SlotCount;++i) {
+		total+=Counts[i];
+	}
+	return total;
+}
+
+// Frame time that the given fraction of the frames came in at or under, to the
+// nearest slot. Frames that landed in the last slot took at least that long.
+float FrameTimeHistogramClass::Get_Percentile(float fraction) const
+{
+	unsigned total=Get_Total();
+	if (total==0) return 0.0f;
+
+	unsigned wanted=unsigned(fraction*float(total)+0.5f);
+	if (wanted<1) wanted=1;
+	if (wanted>total) wanted=total;
+
+	unsigned count=0;
+	for (unsigned i=0;i<SlotCount;++i) {
+		count+=Counts[i];
+		if (count>=wanted) {
+			return Step*float(i);
+		}
+	}
+	return Step*float(SlotCount-1);
+}
+
 // Reset the counts.
 void FrameTimeHistogramClass::Reset()
 {
@@ -300,8 +333,10 @@ void	TimeManager::Update( void )
 {
 	Update_Frame_Time();
 
-	// tell the profiling code that another frame has gone by
+	// tell the profiling and memory logging code that another frame has gone by
 	WWProfileManager::Increment_Frame_Counter();
+	WWMemoryLogClass::Frame_Finished();
+	FrameArenaClass::Get_Frame_Arena()->Reset();
 
 
 #ifdef WWDEBUG
@@ -66,6 +66,8 @@ public:
 
 	void Get_Packed_Report(unsigned char* bytes);	// Normalized counts, as bytes
 	void Get_Report(unsigned* counts);					// Absolute counts
+	unsigned Get_Total() const;
+	float Get_Percentile(float fraction) const;		// In milliseconds, fraction 0..1
 
 };
 
@@ -75,6 +75,7 @@
 #include "shellapi.h"
 #include "netutil.h"
 #include "gamespybanlist.h"
+#include "crc.h"
 
 CGameSpyQnR GameSpyQnR;
 
@@ -129,10 +130,20 @@ void c_basic_callback(char *outbuf, int maxlen, void *userdata)
 	((CGameSpyQnR *)userdata)->basic_callback(outbuf, maxlen);
 }
 
+/*********
+Players joining, leaving or (de)activating change the info and players
+responses.
+**********/
+static class GameSpyQnRPlayerObserver : public Observer<PlayerMgrEvent>
+{
+public:
+	void HandleNotification(PlayerMgrEvent &) { GameSpyQnR.Invalidate_Responses(); }
+} PlayerObserver;
+
 /***********
 A simple game object. Consists of some data and a main loop function.
 ***********/
-CGameSpyQnR::CGameSpyQnR(void) : m_GSInit(FALSE), m_GSEnabled(FALSE)
+CGameSpyQnR::CGameSpyQnR(void) : m_GSInit(FALSE), m_GSEnabled(FALSE), ResponsesDirty(true), SettingsSignature(0)
 {
 	// Secret keys removed per Security review requirements. LFeenanEA - 27th January 2025
 	
@@ -234,6 +245,7 @@ void CGameSpyQnR::Shutdown(void) {
 		ConsoleBox.Print("Shutting down GameSpy Q&R\n");
 		qr_send_exiting(query_reporting_rec);
 		qr_shutdown(query_reporting_rec);
+		Responder.Close();
 		m_GSEnabled = m_GSInit = false;
 	}
 #endif
@@ -284,12 +296,27 @@ void CGameSpyQnR::Init(void) {
 		if (!get_master_count()) {
 			GameSpyQnR.Parse_HeartBeat_List(Get_Default_HeartBeat_List());
 		}
-		test = qr_init(&query_reporting_rec, ip, cUserOptions::GameSpyQueryPort.Get(),
-			gamename, secret_key, c_basic_callback, c_info_callback, c_rules_callback, 
-			c_players_callback, this);
+		// Answer browser queries on a thread of our own, sharing the socket with
+		// the SDK. If the port can't be bound here let the SDK try on its own.
+		if (Responder.Open(ip ? inet_addr(ip) : INADDR_ANY, cUserOptions::GameSpyQueryPort.Get())) {
+			test = qr_init_socket(&query_reporting_rec, Responder.Get_Socket(),
+				gamename, secret_key, c_basic_callback, c_info_callback, c_rules_callback, 
+				c_players_callback, this);
+		} else {
+			test = qr_init(&query_reporting_rec, ip, cUserOptions::GameSpyQueryPort.Get(),
+				gamename, secret_key, c_basic_callback, c_info_callback, c_rules_callback, 
+				c_players_callback, this);
+		}
 		WWASSERT(!test);
 		gcd_init_qr(query_reporting_rec, cdkey_id);
 
+		static bool observing = false;
+		if (!observing) {
+			cPlayerManager::Add_Event_Observer(PlayerObserver);
+			observing = true;
+		}
+		Invalidate_Responses();
+
 		StartTime = time(NULL);
 		m_GSInit = TRUE;
 	}
@@ -330,21 +357,115 @@ void CGameSpyQnR::Think()
 //	DoGameStuff();
 	if (m_GSInit && m_GSEnabled && GameInitMgrClass::Is_LAN_Initialized() &&
 			!CombatManager::Is_Loading_Level()) {
+		Update_Responses();
+
+		// Queries the responder thread couldn't answer from the cached responses
+		if (Responder.Is_Open()) {
+			char query[cGameSpyQueryResponder::MAX_PACKET_SIZE + 1];
+			SOCKADDR_IN from;
+			while (Responder.Get_Forwarded_Query(query, sizeof(query), from)) {
+				qr_parse_query(query_reporting_rec, query, (struct sockaddr *)&from);
+			}
+		}
+
 		qr_process_queries(query_reporting_rec);
 		gcd_think();
 	}
 #endif
 }
 
+/*******************
+Rebuilds the cached responses if a player came, went or changed state, or
+if any of the settings they report changed. Settings have no change
+notification of their own, so a CRC of them is compared instead.
+*****************/
+void CGameSpyQnR::Update_Responses(void)
+{
+	if (The_Game() == NULL) {
+		return;
+	}
+
+	unsigned long signature = Get_Settings_Signature();
+	if (!ResponsesDirty && signature == SettingsSignature) {
+		return;
+	}
+
+	char outbuf[cGameSpyQueryResponder::MAX_RESPONSE_SIZE];
+
+	Build_Basic_Response(outbuf, sizeof(outbuf));
+	Responder.Set_Response(cGameSpyQueryResponder::RESPONSE_BASIC, outbuf);
+	Build_Info_Response(outbuf, sizeof(outbuf));
+	Responder.Set_Response(cGameSpyQueryResponder::RESPONSE_INFO, outbuf);
+	Build_Rules_Response(outbuf, sizeof(outbuf));
+	Responder.Set_Response(cGameSpyQueryResponder::RESPONSE_RULES, outbuf);
+	Build_Players_Response(outbuf, sizeof(outbuf));
+	Responder.Set_Response(cGameSpyQueryResponder::RESPONSE_PLAYERS, outbuf);
+
+	ResponsesDirty = false;
+	SettingsSignature = signature;
+}
+
+unsigned long CGameSpyQnR::Get_Settings_Signature(void)
+{
+	cGameData *game = The_Game();
+	const WCHAR *title = game->Get_Game_Title();
+
+	unsigned long crc = CRC::Memory((unsigned char *)title, wcslen(title) * sizeof(WCHAR));
+	crc = CRC::String(game->Get_Map_Name(), crc);
+	crc = CRC::String(game->Get_Mod_Name(), crc);
+
+	int values[] = {
+		game->Get_Port(),
+		game->Get_Max_Players(),
+		(int)cUserOptions::BandwidthBps.Get(),
+		ConsoleBox.Is_Exclusive(),
+		game->IsDedicated.Get(),
+		game->DriverIsAlwaysGunner.Get(),
+		game->IsPassworded.Get(),
+		game->IsTeamChangingAllowed.Get(),
+		game->IsFriendlyFirePermitted.Get(),
+		game->As_Cnc()->Get_Starting_Credits()
+	};
+	return CRC::Memory((unsigned char *)values, sizeof(values), crc);
+}
+
 /*************
-basic_callback
-sends a (sample) response to the basic query 
+The SDK callbacks. These run inside qr_process_queries or qr_parse_query
+and only copy the cached responses.
+*************/
+void CGameSpyQnR::basic_callback(char *outbuf, int maxlen)
+{
+	if (!maxlen || !outbuf) return;
+	Responder.Get_Response(cGameSpyQueryResponder::RESPONSE_BASIC, outbuf, maxlen);
+}
+
+void CGameSpyQnR::info_callback(char *outbuf, int maxlen)
+{
+	if (!maxlen || !outbuf) return;
+	Responder.Get_Response(cGameSpyQueryResponder::RESPONSE_INFO, outbuf, maxlen);
+}
+
+void CGameSpyQnR::rules_callback(char *outbuf, int maxlen)
+{
+	if (!maxlen || !outbuf) return;
+	Responder.Get_Response(cGameSpyQueryResponder::RESPONSE_RULES, outbuf, maxlen);
+}
+
+void CGameSpyQnR::players_callback(char *outbuf, int maxlen)
+{
+	if (!maxlen || !outbuf) return;
+	Responder.Get_Response(cGameSpyQueryResponder::RESPONSE_PLAYERS, outbuf, maxlen);
+}
+
+/*************
+Build_Basic_Response
+builds the response to the basic query 
 includes the following keys:
 \gamename\
 \gamever\
 \location\
 *************/
-void CGameSpyQnR::basic_callback(char *outbuf, int maxlen)
+void CGameSpyQnR::Build_Basic_Response(char *outbuf, int maxlen)
 {
 
 	WWDEBUG_SAY(("-->GS_QnR -- Basic callback\n"));
@@ -370,8 +491,8 @@ void CGameSpyQnR::basic_callback(char *outbuf, int maxlen)
 }
 
 /************
-info_callback
-Sends a (sample) response to the info query 
+Build_Info_Response
+Builds the response to the info query 
 including the following keys:
 \hostname\
 \hostport\
@@ -381,7 +502,7 @@ including the following keys:
 \maxplayers\
 \gamemode\
 ************/
-void CGameSpyQnR::info_callback(char *outbuf, int maxlen)
+void CGameSpyQnR::Build_Info_Response(char *outbuf, int maxlen)
 {
 
 	WWDEBUG_SAY(("-->GS_QnR -- Info callback\n"));
@@ -452,8 +573,8 @@ void CGameSpyQnR::info_callback(char *outbuf, int maxlen)
 }
 
 /***************
-rules_callback
-Sends a response to the rules query. You may
+Build_Rules_Response
+Builds the response to the rules query. You may
 need to add custom fields for your game in here. Some are provided
 as an example 
 The following rules are included:
@@ -462,7 +583,7 @@ The following rules are included:
 \teamplay\
 \rankedserver\
 ****************/
-void CGameSpyQnR::rules_callback(char *outbuf, int maxlen)
+void CGameSpyQnR::Build_Rules_Response(char *outbuf, int maxlen)
 {
 	static StringClass b;
 	WWDEBUG_SAY(("-->GS_QnR -- Rules callback\n"));
@@ -637,8 +758,8 @@ BOOL CGameSpyQnR::Append_InfoKey_Pair(char *outbuf, int maxlen, const char *key,
 }
 
 /***************
-players_callback
-sends the players and their information. 
+Build_Players_Response
+builds the response listing the players and their information. 
 Note that \ characters are not stripped out of player names. If
 your game allows players or team names with the \ character, you will need
 to strip or change it here. 
@@ -650,7 +771,7 @@ The following keys are included for each player:
 \ping_N\
 \team_N\
 ***************/
-void CGameSpyQnR::players_callback(char *outbuf, int maxlen)
+void CGameSpyQnR::Build_Players_Response(char *outbuf, int maxlen)
 {
 
 	// Send the minimum for now to reduce Bandwidth usage.
@@ -26,6 +26,7 @@ INCLUDES
 #include <GameSpy\gqueryreporting.h>
 #include <WWLib\WideString.h>
 #include "trim.h"
+#include "GameSpy_QueryResponder.h"
 
 /********
 DEFINES
@@ -43,6 +44,12 @@ protected:
 	BOOL Append_InfoKey_Pair(char *outbuf, int maxlen, const char *key, const char *value);
 	BOOL Append_InfoKey_Pair(char *outbuf, int maxlen, const char *key, const StringClass &value);
 	BOOL Append_InfoKey_Pair(char *outbuf, int maxlen, const char *key, const WideStringClass &value);
+	void Update_Responses(void);
+	unsigned long Get_Settings_Signature(void);
+	void Build_Basic_Response(char *outbuf, int maxlen);
+	void Build_Info_Response(char *outbuf, int maxlen);
+	void Build_Rules_Response(char *outbuf, int maxlen);
+	void Build_Players_Response(char *outbuf, int maxlen);
 	static const char *gamename;
 	static const char *bname;
 	static const int prodid;
@@ -50,6 +57,12 @@ protected:
 	static const char *default_heartbeat_list;
 	int StartTime;
 
+	// The responses are built on the main thread when something they report
+	// changes. The responder thread and the SDK callbacks only copy them.
+	cGameSpyQueryResponder Responder;
+	bool ResponsesDirty;
+	unsigned long SettingsSignature;
+
 public:
 	void Init(void);
 	void LaunchArcade(void);
@@ -61,6 +74,7 @@ public:
 	void Enable_Reporting(BOOL enable) { m_GSEnabled = enable; }
 	BOOL IsEnabled(void) { return m_GSEnabled; }
 	void Think();
+	void Invalidate_Responses(void) { ResponsesDirty = true; }
 	void basic_callback(char *outbuf, int maxlen); 
 	void info_callback(char *outbuf, int maxlen);
 	void rules_callback(char *outbuf, int maxlen);
@@ -0,0 +1,362 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//
+// Filename:     GameSpy_QueryResponder.cpp
+// Description:  Answers GameSpy server browser queries from a thread of its own
+//
+
+#include "GameSpy_QueryResponder.h"
+#include "systimer.h"
+#include "wwdebug.h"
+#include <stdio.h>
+#include <string.h>
+
+//
+// The thread wakes this often to see whether it should stop.
+//
+static const int RESPONDER_POLL_MS = 100;
+
+//
+// Room left at the end of a packet for \final\ and \queryid\.
+//
+static const int PACKET_TRAILER_SIZE = 48;
+
+
+//-----------------------------------------------------------------------------
+cGameSpyQueryResponder::cGameSpyQueryResponder(void) :
+	ThreadClass("GameSpy query responder"),
+	Socket(INVALID_SOCKET),
+	ForwardHead(0),
+	ForwardCount(0),
+	QueryRate(DEFAULT_QUERY_RATE),
+	QueryBurst(DEFAULT_QUERY_BURST),
+	QueryId(0),
+	PacketNumber(0),
+	AnsweredCount(0),
+	ForwardedCount(0),
+	DroppedCount(0)
+{
+	for (int i = 0; i < RESPONSE_COUNT; i++) {
+		Responses[i][0] = 0;
+		ResponseLengths[i] = 0;
+	}
+	memset(Sources, 0, sizeof(Sources));
+}
+
+//-----------------------------------------------------------------------------
+cGameSpyQueryResponder::~cGameSpyQueryResponder(void)
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+bool cGameSpyQueryResponder::Open(ULONG ip, USHORT port)
+{
+	WWASSERT(!Is_Open());
+
+	Socket = socket(AF_INET, SOCK_DGRAM, 0);
+	if (Socket == INVALID_SOCKET) {
+		WWDEBUG_SAY(("cGameSpyQueryResponder - socket failed with error code %d\n", WSAGetLastError()));
+		return false;
+	}
+
+	SOCKADDR_IN addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = ip;
+	addr.sin_port = htons(port);
+	if (bind(Socket, (LPSOCKADDR)&addr, sizeof(addr)) == SOCKET_ERROR) {
+		WWDEBUG_SAY(("cGameSpyQueryResponder - bind to port %d failed with error code %d\n", port, WSAGetLastError()));
+		closesocket(Socket);
+		Socket = INVALID_SOCKET;
+		return false;
+	}
+
+	memset(Sources, 0, sizeof(Sources));
+	ForwardHead = 0;
+	ForwardCount = 0;
+
+	Execute();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void cGameSpyQueryResponder::Close(void)
+{
+	if (Is_Open()) {
+		Stop();
+		closesocket(Socket);
+		Socket = INVALID_SOCKET;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void cGameSpyQueryResponder::Set_Response(int type, const char * text)
+{
+	WWASSERT(type >= 0 && type < RESPONSE_COUNT);
+	WWASSERT(text != NULL);
+
+	int length = strlen(text);
+	if (length >= MAX_RESPONSE_SIZE) {
+		WWDEBUG_SAY(("cGameSpyQueryResponder - response %d truncated from %d bytes\n", type, length));
+		length = MAX_RESPONSE_SIZE - 1;
+	}
+
+	CriticalSectionClass::LockClass lock(Lock);
+	memcpy(Responses[type], text, length);
+	Responses[type][length] = 0;
+	ResponseLengths[type] = length;
+}
+
+//-----------------------------------------------------------------------------
+int cGameSpyQueryResponder::Get_Response(int type, char * buffer, int size)
+{
+	WWASSERT(type >= 0 && type < RESPONSE_COUNT);
+	WWASSERT(buffer != NULL && size > 0);
+
+	CriticalSectionClass::LockClass lock(Lock);
+	int length = ResponseLengths[type];
+	if (length >= size) {
+		length = size - 1;
+	}
+	memcpy(buffer, Responses[type], length);
+	buffer[length] = 0;
+	return length;
+}
+
+//-----------------------------------------------------------------------------
+bool cGameSpyQueryResponder::Get_Forwarded_Query(char * buffer, int size, SOCKADDR_IN & from)
+{
+	WWASSERT(buffer != NULL && size > 0);
+
+	CriticalSectionClass::LockClass lock(Lock);
+	if (ForwardCount == 0) {
+		return false;
+	}
+
+	ForwardStruct & forward = ForwardQueue[ForwardHead];
+	strncpy(buffer, forward.Query, size - 1);
+	buffer[size - 1] = 0;
+	from = forward.From;
+
+	ForwardHead = (ForwardHead + 1) % FORWARD_QUEUE_SIZE;
+	ForwardCount--;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void cGameSpyQueryResponder::Set_Rate_Limit(int queries_per_second, int burst)
+{
+	CriticalSectionClass::LockClass lock(Lock);
+	QueryRate = queries_per_second;
+	QueryBurst = (burst > 0) ? burst : 1;
+	memset(Sources, 0, sizeof(Sources));
+}
+
+//-----------------------------------------------------------------------------
+void cGameSpyQueryResponder::Thread_Function(void)
+{
+	char query[MAX_PACKET_SIZE + 1];
+
+	while (running) {
+
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(Socket, &readable);
+		timeval timeout;
+		timeout.tv_sec = 0;
+		timeout.tv_usec = RESPONDER_POLL_MS * 1000;
+		if (select(Socket + 1, &readable, NULL, NULL, &timeout) <= 0) {
+			continue;
+		}
+
+		SOCKADDR_IN from;
+		int from_length = sizeof(from);
+		int length = recvfrom(Socket, query, MAX_PACKET_SIZE, 0, (LPSOCKADDR)&from, &from_length);
+
+		//
+		// A UDP socket reports WSAECONNRESET when an earlier reply was refused,
+		// which is the querier's problem, not ours.
+		//
+		if (length <= 0) {
+			continue;
+		}
+		query[length] = 0;
+
+		if (!Allow_Query(from.sin_addr.s_addr, TIMEGETTIME())) {
+			DroppedCount++;
+			continue;
+		}
+
+		if (!Answer_Query(query, from)) {
+			Forward_Query(query, from);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//
+// One token bucket per source, in a direct mapped table. A source that hashes
+// to a slot another one is using takes it over once the other has been quiet
+// long enough for its bucket to refill; until then the two share a bucket,
+// which only ever limits them harder.
+//
+bool cGameSpyQueryResponder::Allow_Query(ULONG ip, DWORD time)
+{
+	CriticalSectionClass::LockClass lock(Lock);
+
+	if (QueryRate <= 0) {
+		return true;
+	}
+
+	int full = QueryBurst * TOKEN_SCALE;
+	DWORD refill_time = full / QueryRate + 1;
+
+	ULONG hash = ip ^ (ip >> 8) ^ (ip >> 16) ^ (ip >> 24);
+	SourceStruct & source = Sources[hash % SOURCE_TABLE_SIZE];
+
+	DWORD elapsed = time - source.Time;
+	if (elapsed > refill_time) {
+		elapsed = refill_time;
+	}
+
+	if (source.Ip != ip && (source.Ip == 0 || elapsed >= refill_time)) {
+		source.Ip = ip;
+		source.Tokens = full;
+	} else {
+		source.Tokens += elapsed * QueryRate;
+		if (source.Tokens > full) {
+			source.Tokens = full;
+		}
+	}
+	source.Time = time;
+
+	if (source.Tokens < TOKEN_SCALE) {
+		return false;
+	}
+	source.Tokens -= TOKEN_SCALE;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//
+// Queries are a list of \key\ names. Only lists made up entirely of the keys
+// we have responses for are answered here.
+//
+bool cGameSpyQueryResponder::Answer_Query(const char * query, const SOCKADDR_IN & from)
+{
+	if (query[0] != '\\') {
+		return false;
+	}
+
+	int wanted = 0;
+	const char * key = query;
+	while (*key != 0) {
+		while (*key == '\\') {
+			key++;
+		}
+		int length = strcspn(key, "\\");
+		if (length == 0) {
+			break;
+		}
+
+		if (length == 5 && strncmp(key, "basic", 5) == 0) {
+			wanted |= 1 << RESPONSE_BASIC;
+		} else if (length == 4 && strncmp(key, "info", 4) == 0) {
+			wanted |= 1 << RESPONSE_INFO;
+		} else if (length == 5 && strncmp(key, "rules", 5) == 0) {
+			wanted |= 1 << RESPONSE_RULES;
+		} else if (length == 7 && strncmp(key, "players", 7) == 0) {
+			wanted |= 1 << RESPONSE_PLAYERS;
+		} else if (length == 6 && strncmp(key, "status", 6) == 0) {
+			wanted |= (1 << RESPONSE_COUNT) - 1;
+		} else {
+			return false;
+		}
+		key += length;
+	}
+	if (wanted == 0) {
+		return false;
+	}
+
+	//
+	// Copy the responses out so the lock isn't held while sending.
+	//
+	char responses[RESPONSE_COUNT][MAX_RESPONSE_SIZE];
+	int lengths[RESPONSE_COUNT];
+	{
+		CriticalSectionClass::LockClass lock(Lock);
+		for (int type = 0; type < RESPONSE_COUNT; type++) {
+			lengths[type] = 0;
+			if (wanted & (1 << type)) {
+				lengths[type] = ResponseLengths[type];
+				memcpy(responses[type], Responses[type], lengths[type]);
+			}
+		}
+	}
+
+	QueryId++;
+	PacketNumber = 0;
+
+	char packet[MAX_PACKET_SIZE + PACKET_TRAILER_SIZE];
+	int length = 0;
+	for (int type = 0; type < RESPONSE_COUNT; type++) {
+		if (length + lengths[type] > MAX_PACKET_SIZE - PACKET_TRAILER_SIZE) {
+			Send_Packet(packet, length, from, false);
+			length = 0;
+		}
+		memcpy(packet + length, responses[type], lengths[type]);
+		length += lengths[type];
+	}
+	Send_Packet(packet, length, from, true);
+
+	AnsweredCount++;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void cGameSpyQueryResponder::Forward_Query(const char * query, const SOCKADDR_IN & from)
+{
+	CriticalSectionClass::LockClass lock(Lock);
+
+	if (ForwardCount == FORWARD_QUEUE_SIZE) {
+		DroppedCount++;
+		return;
+	}
+
+	ForwardStruct & forward = ForwardQueue[(ForwardHead + ForwardCount) % FORWARD_QUEUE_SIZE];
+	strcpy(forward.Query, query);
+	forward.From = from;
+	ForwardCount++;
+	ForwardedCount++;
+}
+
+//-----------------------------------------------------------------------------
+//
+// Every packet of a response ends with \queryid\<query>.<packet> and the last
+// one with \final\ before that, the same as the SDK sends.
+//
+void cGameSpyQueryResponder::Send_Packet(char * packet, int length, const SOCKADDR_IN & from, bool final)
+{
+	if (final) {
+		length += sprintf(packet + length, "\\final\\");
+	}
+	length += sprintf(packet + length, "\\queryid\\%d.%d", QueryId, ++PacketNumber);
+	sendto(Socket, packet, length, 0, (LPSOCKADDR)&from, sizeof(from));
+}
@@ -0,0 +1,140 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//
+// Filename:     GameSpy_QueryResponder.h
+// Description:  Answers GameSpy server browser queries from a thread of its own
+//
+
+#ifndef __GAMESPY_QUERYRESPONDER_H__
+#define __GAMESPY_QUERYRESPONDER_H__
+
+#include "thread.h"
+#include "mutex.h"
+#include <winsock.h>
+
+//-----------------------------------------------------------------------------
+//
+// cGameSpyQueryResponder owns the GameSpy query socket. Its thread reads every
+// datagram that arrives and answers the \basic\, \info\, \rules\, \players\
+// and \status\ queries server browsers send from responses the main thread
+// serialized beforehand with Set_Response, so a browser refreshing the list
+// costs the game nothing. Anything else (master server challenges, \echo\,
+// CD key traffic) is queued for the main thread, which hands it to the SDK.
+//
+// Each source address gets a token bucket. A source that sends more than the
+// burst, faster than the refill rate, has its queries dropped before they are
+// looked at, whether they would have been answered here or forwarded.
+//
+class cGameSpyQueryResponder : public ThreadClass
+{
+	public:
+		cGameSpyQueryResponder(void);
+		~cGameSpyQueryResponder(void);
+
+		enum {
+			RESPONSE_BASIC,
+			RESPONSE_INFO,
+			RESPONSE_RULES,
+			RESPONSE_PLAYERS,
+			RESPONSE_COUNT
+		};
+
+		enum {MAX_PACKET_SIZE		= 1400};
+		enum {MAX_RESPONSE_SIZE		= 1024};
+		enum {DEFAULT_QUERY_RATE	= 4};		// queries per second per source
+		enum {DEFAULT_QUERY_BURST	= 16};
+
+		//
+		// Bind the socket (ip is in network order, INADDR_ANY for all) and start
+		// the thread.
+		//
+		bool		Open(ULONG ip, USHORT port);
+		void		Close(void);
+		bool		Is_Open(void) const						{return Socket != INVALID_SOCKET;}
+		SOCKET	Get_Socket(void) const					{return Socket;}
+
+		//
+		// Main thread. Replace a pre-serialized response; text is the list of
+		// \key\value pairs without the \final\ or \queryid\ the protocol adds.
+		//
+		void		Set_Response(int type, const char * text);
+		int		Get_Response(int type, char * buffer, int size);
+
+		//
+		// Main thread. Returns false when nothing is waiting. The query is null
+		// terminated.
+		//
+		bool		Get_Forwarded_Query(char * buffer, int size, SOCKADDR_IN & from);
+
+		//
+		// A rate of 0 turns limiting off.
+		//
+		void		Set_Rate_Limit(int queries_per_second, int burst);
+
+		int		Get_Answered_Count(void) const		{return AnsweredCount;}
+		int		Get_Forwarded_Count(void) const		{return ForwardedCount;}
+		int		Get_Dropped_Count(void) const			{return DroppedCount;}
+
+	protected:
+		void		Thread_Function(void);
+
+	private:
+		enum {SOURCE_TABLE_SIZE		= 256};
+		enum {FORWARD_QUEUE_SIZE	= 64};
+		enum {TOKEN_SCALE				= 1000};	// tokens are kept in thousandths
+
+		struct SourceStruct {
+			ULONG		Ip;
+			int		Tokens;
+			DWORD		Time;
+		};
+
+		struct ForwardStruct {
+			SOCKADDR_IN	From;
+			char			Query[MAX_PACKET_SIZE + 1];
+		};
+
+		bool		Allow_Query(ULONG ip, DWORD time);
+		bool		Answer_Query(const char * query, const SOCKADDR_IN & from);
+		void		Forward_Query(const char * query, const SOCKADDR_IN & from);
+		void		Send_Packet(char * packet, int length, const SOCKADDR_IN & from, bool final);
+
+		SOCKET					Socket;
+		CriticalSectionClass	Lock;
+
+		char						Responses[RESPONSE_COUNT][MAX_RESPONSE_SIZE];
+		int						ResponseLengths[RESPONSE_COUNT];
+
+		ForwardStruct			ForwardQueue[FORWARD_QUEUE_SIZE];
+		int						ForwardHead;
+		int						ForwardCount;
+
+		SourceStruct			Sources[SOURCE_TABLE_SIZE];
+		int						QueryRate;
+		int						QueryBurst;
+
+		int						QueryId;
+		int						PacketNumber;
+
+		volatile int			AnsweredCount;
+		volatile int			ForwardedCount;
+		volatile int			DroppedCount;
+};
+
+#endif // __GAMESPY_QUERYRESPONDER_H__
@@ -56,6 +56,8 @@
 #include "autostart.h"
 #include "GameSpy_QnR.h"
 #include "bandwidthcheck.h"
+#include "mainloop.h"
+#include "servertick.h"
 
 
 
@@ -384,6 +386,32 @@ bool ServerSettingsClass::Parse(bool apply)
 		}
 		cUserOptions::NetUpdateRate.Set(nur);
 
+		/*
+		** Get the server tick rate and how many missed ticks to make up after a slow frame.
+		*/
+		int tick_rate = ini.Get_Int(MasterServerSection, "TickRate", cServerTickScheduler::DEFAULT_TICK_RATE);
+		if (tick_rate < 10 || tick_rate > 200) {
+			WWDEBUG_SAY(("Error - Bad TickRate specified - aborting\n"));
+			ConsoleBox.Print("Error - TickRate must be between 10 and 200 - aborting\n");
+			ConsoleBox.Wait_For_Keypress();;
+			return(false);
+		}
+		int catch_up = ini.Get_Int(MasterServerSection, "MaxCatchUpTicks", cServerTickScheduler::DEFAULT_MAX_CATCH_UP_TICKS);
+		if (catch_up < 0 || catch_up > tick_rate) {
+			WWDEBUG_SAY(("Error - Bad MaxCatchUpTicks specified - aborting\n"));
+			ConsoleBox.Print("Error - MaxCatchUpTicks must be between 0 and TickRate - aborting\n");
+			ConsoleBox.Wait_For_Keypress();;
+			return(false);
+		}
+		Set_Server_Tick_Rate(tick_rate, catch_up);
+
+		/*
+		** Get the file to write frame time percentiles to. No file means no report.
+		*/
+		char frame_stats_file[MAX_PATH];
+		ini.Get_String(MasterServerSection, "FrameStatsFile", "", frame_stats_file, sizeof(frame_stats_file));
+		Set_Server_Frame_Stats_File(frame_stats_file);
+
 		/*
 		** Get the remote admin settings.
 		*/
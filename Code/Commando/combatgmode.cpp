@@ -1364,7 +1364,7 @@ void 	CombatGameModeClass::Think()
 		int time=TIMEGETTIME();
 		CombatManager::Request_Autosave( false );
 		SaveGameManager::Set_Description( TRANSLATE( IDS_SAVE_AUTOSAVE ) );
-		SaveGameManager::Save_Game( "save\\autosave.sav", &_CommandoSaveLoad, NULL );
+		SaveGameManager::Save_Autosave_Game( "save\\autosave.sav", &_CommandoSaveLoad, NULL );
 		time=TIMEGETTIME()-time;
 		Debug_Say(( "Autosaving Complete, took %d.%2.2d seconds\n",time/1000,(time/10)%100 ));
 	}
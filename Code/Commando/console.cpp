@@ -88,6 +88,7 @@
 #include "trackedvehicle.h"
 #include "dx8rendererdebugger.h"
 #include "fastallocator.h"
+#include "framearena.h"
 #include <WWOnline\WOLSession.h>
 #include "consolemode.h"
 
@@ -1757,6 +1758,13 @@ void	ConsoleGameModeClass::Update_Memory_Log( void )
 	working_string.Format("TOTAL:              %-10.2f\r\n\r\n",(float)total * OOMEGABYTE);
 	memory_string += working_string;
 
+	// frame arena high water marks (its blocks are already counted in the categories above)
+	FrameArenaClass * arena = FrameArenaClass::Get_Frame_Arena();
+	working_string.Format("%-18s  %-10.2f     %-10.2f\r\n","Frame Arena",
+									(float)arena->Get_Last_Frame_High_Water_Mark() * OOMEGABYTE,
+									(float)arena->Get_High_Water_Mark() * OOMEGABYTE);
+	memory_string += working_string;
+
 	StatisticsDisplayManager::Set_Stat( "memory", memory_string, 0xffffffff );
 }
 
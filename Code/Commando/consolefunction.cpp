@@ -114,6 +114,7 @@
 #include "path.h"
 #include "sctextobj.h"
 #include "consolecommandevent.h"
+#include "wwmemlog.h"
 #include "hudinfo.h"
 #include "physresourcemgr.h"
 #include "cstextobj.h"
@@ -160,6 +161,7 @@
 #include "specialbuilds.h"
 #include "lightsolve.h"
 #include "lightsolvecontext.h"
+#include "framearena.h"
 
 
 
@@ -3185,6 +3187,74 @@ public:
 	}
 };
 
+static void Memlog_Console_Print( const char * text )
+{
+	ConsoleFunctionClass::Print( "%s", text );
+}
+
+class MemlogSampleConsoleFunctionClass : public ConsoleFunctionClass
+{
+public:
+	virtual	const char * Get_Name( void )	{ return "memlog_sample"; }
+	virtual	const char * Get_Help( void )	{ return "MEMLOG_SAMPLE <n> - record the call stack of 1 in n allocations (0=off) and reset the counters."; }
+	virtual	void Activate( const char * input ) {
+		int rate = 0;
+		sscanf( input, "%d", &rate );
+		WWMemoryLogClass::Set_Sample_Rate( rate );
+		WWMemoryLogClass::Reset_Samples();
+		Print( "Allocation sampling rate set to %d\n", WWMemoryLogClass::Get_Sample_Rate() );
+	}
+};
+
+class MemlogDumpConsoleFunctionClass : public ConsoleFunctionClass
+{
+public:
+	virtual	const char * Get_Name( void )	{ return "memlog_dump"; }
+	virtual	const char * Get_Help( void )	{ return "MEMLOG_DUMP [count] - print allocations per frame by category and scope, and the top allocation sites."; }
+	virtual	void Activate( const char * input ) {
+		int count = 10;
+		sscanf( input, "%d", &count );
+		WWMemoryLogClass::Dump_Allocation_Sites( count, Memlog_Console_Print );
+	}
+};
+
+class FrameArenaConsoleFunctionClass : public ConsoleFunctionClass
+{
+public:
+	virtual	const char * Get_Name( void )	{ return "frame_arena"; }
+	virtual	const char * Get_Help( void )	{ return "FRAME_ARENA - print the frame arena capacity and high water marks."; }
+	virtual	void Activate( const char * input ) {
+		FrameArenaClass * arena = FrameArenaClass::Get_Frame_Arena();
+		Print( "Frame arena: capacity %d, last frame %d, peak %d bytes\n",
+			arena->Get_Capacity(), arena->Get_Last_Frame_High_Water_Mark(), arena->Get_High_Water_Mark() );
+	}
+};
+
+class ProfileTraceBeginConsoleFunctionClass : public ConsoleFunctionClass
+{
+public:
+	virtual	const char * Get_Name( void )	{ return "profile_trace_begin"; }
+	virtual	const char * Get_Help( void )	{ return "PROFILE_TRACE_BEGIN - record profile scopes of all threads."; }
+	virtual	void Activate( const char * input ) {
+		WWProfileManager::Begin_Trace();
+	}
+};
+
+class ProfileTraceEndConsoleFunctionClass : public ConsoleFunctionClass
+{
+public:
+	virtual	const char * Get_Name( void )	{ return "profile_trace_end"; }
+	virtual	const char * Get_Help( void )	{ return "PROFILE_TRACE_END [filename] - write the trace for chrome://tracing (default profile_trace.json)."; }
+	virtual	void Activate( const char * input ) {
+		const char * filename = (input != NULL && *input != 0) ? input : "profile_trace.json";
+		if (WWProfileManager::End_Trace( filename )) {
+			Print( "Trace written to %s\n", filename );
+		} else {
+			Print( "Unable to write %s\n", filename );
+		}
+	}
+};
+
 
 class SetTheStarConsoleFunctionClass : public ConsoleFunctionClass
 {
@@ -3564,6 +3634,25 @@ public:
 };
 #endif
 
+class RenderPipelineConsoleFunctionClass : public ConsoleFunctionClass {
+public:
+	virtual	const char * Get_Name( void )	{ return "render_pipeline"; }
+	virtual	const char * Get_Help( void )	{ return "RENDER_PIPELINE [0|1] - Collect the static objects for the next frame on a worker thread."; }
+	virtual	void Activate( const char * input) {
+		int state = 0;
+		int argcount=::sscanf(input, "%d", &state);
+		if (argcount==1) {
+			state=!!state;
+		}
+		else {
+			state=!COMBAT_SCENE->Are_Pipelined_Render_Lists_Enabled();
+		}
+		COMBAT_SCENE->Enable_Pipelined_Render_Lists(state==1);
+
+		Print( "Render pipeline %s\n", state ? "ENABLED" : "DISABLED");
+	}
+};
+
 class StatsConsoleFunctionClass : public ConsoleFunctionClass
 {
 public:
@@ -5038,6 +5127,11 @@ void	ConsoleFunctionManager::Init( void )
 	FunctionList.Add( new PlayerPositionConsoleFunctionClass() );
 	FunctionList.Add( new ProfileCollectBeginConsoleFunctionClass() );
 	FunctionList.Add( new ProfileCollectEndConsoleFunctionClass() );
+	FunctionList.Add( new ProfileTraceBeginConsoleFunctionClass() );
+	FunctionList.Add( new ProfileTraceEndConsoleFunctionClass() );
+	FunctionList.Add( new MemlogSampleConsoleFunctionClass() );
+	FunctionList.Add( new MemlogDumpConsoleFunctionClass() );
+	FunctionList.Add( new FrameArenaConsoleFunctionClass() );
 	FunctionList.Add( new ProjectorDebugConsoleFunctionClass() );
 	//FunctionList.Add( new RadarMaxConsoleFunctionClass() );
 	FunctionList.Add( new RadarToggleConsoleFunctionClass() );
@@ -5170,6 +5264,7 @@ void	ConsoleFunctionManager::Init( void )
 	FunctionList.Add( new EditVehicleConsoleFunctionClass() );
 	FunctionList.Add( new NetUpdateRateConsoleFunctionClass() );
 	FunctionList.Add( new ClientPhysicsOptimizationConsoleFunctionClass() );
+	FunctionList.Add( new RenderPipelineConsoleFunctionClass() );
 #ifndef FREEDEDICATEDSERVER
 	FunctionList.Add( new FPSConsoleFunctionClass() );		// Steve W wanted this.
 #endif //FREEDEDICATEDSERVER
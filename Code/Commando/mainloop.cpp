@@ -65,6 +65,8 @@
 #include "gamespyadmin.h"
 #include "demosupport.h"
 #include "GameSpy_QnR.h"
+#include "servertick.h"
+#include "serverframestats.h"
 
 
 /*
@@ -80,11 +82,57 @@ void Stop_Main_Loop(int exitCode)
 }
 
 
+/*
+** Dedicated server pacing.
+*/
+static cSocketTickClock		ServerTickClock;
+static cServerTickScheduler	ServerTick(&ServerTickClock);
+static cServerFrameStats		ServerFrameStats;
+
+void Set_Server_Tick_Rate(int ticks_per_second, int max_catch_up_ticks)
+{
+	ServerTick.Set_Tick_Rate(ticks_per_second);
+	ServerTick.Set_Max_Catch_Up_Ticks(max_catch_up_ticks);
+}
+
+void Set_Server_Frame_Stats_File(const char * filename)
+{
+	ServerFrameStats.Set_File_Name(filename);
+}
+
+/*
+** Wait for the next server tick. Packets that arrive in the meantime are read
+** as they come instead of sitting in the socket until the next frame.
+*/
+static void Wait_For_Server_Tick(void)
+{
+	WWPROFILE( "Server Tick Wait" );
+
+	ServerTickClock.Set_Socket(cNetwork::PServerConnection->Get_Socket());
+
+	unsigned long wait_start_us = ServerTickClock.Get_Time_Us();
+	unsigned long input_us = 0;
+	while (ServerTick.Wait() == cServerTickScheduler::WAIT_INPUT) {
+		unsigned long input_start_us = ServerTickClock.Get_Time_Us();
+		cNetwork::PServerConnection->Service_Read();
+		input_us += ServerTickClock.Get_Time_Us() - input_start_us;
+	}
+
+	if (ServerFrameStats.Is_Enabled()) {
+		unsigned long wait_us = ServerTickClock.Get_Time_Us() - wait_start_us - input_us;
+		ServerFrameStats.Add(cServerFrameStats::PHASE_INPUT, input_us);
+		ServerFrameStats.Add(cServerFrameStats::PHASE_WAIT, wait_us);
+		ServerFrameStats.Add(cServerFrameStats::PHASE_LATENESS, ServerTick.Get_Tick_Lateness_Us());
+		ServerFrameStats.Update(TIMEGETTIME(), ServerTick.Get_Skipped_Count());
+	}
+}
+
+
 void _Game_Main_Loop_Loop(void)
 {
 	WWPROFILE( "Main Loop" );
 
-	unsigned long time1 = TIMEGETTIME();
+	unsigned long frame_start_us = ServerTickClock.Get_Time_Us();
 
    TimeManager::Update();
 
@@ -98,19 +146,23 @@ void _Game_Main_Loop_Loop(void)
 	}
 }
 
+	unsigned long think_start_us = ServerTickClock.Get_Time_Us();
 {	WWPROFILE( "Think" );
    GameModeManager::Think();
 	GameInitMgrClass::Think();
 }
+	unsigned long think_end_us = ServerTickClock.Get_Time_Us();
 
 {	WWPROFILE( "Dialog Mgr Update" );
    DialogMgrClass::On_Frame_Update ();
 }
 
+	unsigned long objects_start_us = ServerTickClock.Get_Time_Us();
 {	WWPROFILE( "Network Object Mgr Think" );
    NetworkObjectMgrClass::Think ();
 	ServerControl.Service();
 }
+	unsigned long objects_end_us = ServerTickClock.Get_Time_Us();
 
 {	WWPROFILE("GameSpy_QnR");
 	GameSpyQnR.Think();
@@ -174,21 +226,16 @@ void _Game_Main_Loop_Loop(void)
 
 
 	/*
-	** Sleep for a while if we are hogging the CPU.
+	** The dedicated server runs at a fixed tick rate rather than flat out.
 	*/
 	if (cNetwork::I_Am_Only_Server()) {
-		unsigned long time2 = TIMEGETTIME();
-		if (time2 >= time1) {
-
-			/*
-			** 16 (approx) for 60 fps. (1000/60)
-			*/
-			unsigned long diff = time2 - time1;
-			if (diff < 16) {
-				unsigned long sleep_time = 16 - (time2 - time1);
-				Sleep(sleep_time);
-			}
+		if (ServerFrameStats.Is_Enabled()) {
+			unsigned long frame_end_us = ServerTickClock.Get_Time_Us();
+			ServerFrameStats.Add(cServerFrameStats::PHASE_FRAME, frame_end_us - frame_start_us);
+			ServerFrameStats.Add(cServerFrameStats::PHASE_THINK, think_end_us - think_start_us);
+			ServerFrameStats.Add(cServerFrameStats::PHASE_OBJECTS, objects_end_us - objects_start_us);
 		}
+		Wait_For_Server_Tick();
 	}
 }
 
@@ -44,4 +44,8 @@
 int	Game_Main_Loop(void);
 void	Stop_Main_Loop(int exitCode);
 
+// Dedicated server pacing, from the [Server] section of the server settings file.
+void	Set_Server_Tick_Rate(int ticks_per_second, int max_catch_up_ticks);
+void	Set_Server_Frame_Stats_File(const char * filename);
+
 #endif 
\ No newline at end of file
@@ -86,6 +86,7 @@
 #include "dlgcncwinscreen.h"
 #include "consolemode.h"
 #include "CDKeyAuth.h"
+#include "framearena.h"
 
 static int LastSortedSecond;
 
@@ -137,18 +138,21 @@ if (cDevOptions::UseNewTCADO.Is_False()) {
 		count = NetworkObjectMgrClass::Get_Object_Count();
 	}
 
+	/*
+	** The lists only live for this call so they are built in the frame arena, sized for
+	** every network object up front.
+	*/
+	FrameArenaScopeClass arena_scope;
+
 	/*
 	** List of objects requiring frequent updates.
 	*/
-	static DynamicVectorClass<NetworkObjectClass *> object_list;
+	FrameArenaVectorClass<NetworkObjectClass *> object_list(count);
 
 	/*
 	** List of objects requiring guaranteed updates. We can't schedule these.
 	*/
-	static DynamicVectorClass<NetworkObjectClass *> g_object_list;
-
-	object_list.Clear();
-	g_object_list.Clear();
+	FrameArenaVectorClass<NetworkObjectClass *> g_object_list(count);
 
 	SoldierGameObj * player_ptr = GameObjManager::Find_Soldier_Of_Client_ID(client_id);
 
@@ -529,11 +533,11 @@ if (cDevOptions::UseNewTCADO.Is_False()) {
 	count = NetworkObjectMgrClass::Get_Object_Count();
 
 	/*
-	** List of objects requiring frequent updates.
+	** List of objects requiring frequent updates. Built in the frame arena and released
+	** when this call returns.
 	*/
-	static DynamicVectorClass<NetworkObjectClass *> object_list(500);
-	object_list.Reset_Active();
-	object_list.Set_Growth_Step(100);
+	FrameArenaScopeClass arena_scope;
+	FrameArenaVectorClass<NetworkObjectClass *> object_list(count);
 
 	SoldierGameObj * player_ptr = GameObjManager::Find_Soldier_Of_Client_ID(client_id);
 
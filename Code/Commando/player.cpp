@@ -1015,13 +1015,21 @@ void cPlayer::Set_Is_Active(bool flag)
 		if (cNetwork::I_Am_Client()) {
 			if (flag == true) {
 				On_Create();
-	      cPlayerManager::Activated(this);
 			} else {
 				On_Destroy();
-	      cPlayerManager::Deactivated(this);
 			}
 		}
 
+		//
+		// The server needs to hear about it too (the GameSpy query responses
+		// count the active players).
+		//
+		if (flag == true) {
+			cPlayerManager::Activated(this);
+		} else {
+			cPlayerManager::Deactivated(this);
+		}
+
 		if (IsActive.Is_False()) {
 			//
 			// Anyone who leaves will need to be reauthenticated next tim ethey attempt
@@ -0,0 +1,153 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***                            Confidential - Westwood Studios                              ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Commando                                                     *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Commando/serverframestats.cpp                $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "serverframestats.h"
+#include "timemgr.h"
+#include "wwdebug.h"
+#include <stdio.h>
+
+//
+// Quarter millisecond slots up to 100ms. Anything longer lands in the last
+// slot; the max column still shows how long it really was.
+//
+static const unsigned	HISTOGRAM_SLOTS	= 400;
+static const float		HISTOGRAM_STEP		= 0.25f;
+
+static const char * PhaseNames[cServerFrameStats::PHASE_COUNT] = {
+	"frame",
+	"think",
+	"objects",
+	"input",
+	"wait",
+	"lateness"
+};
+
+
+//-----------------------------------------------------------------------------
+cServerFrameStats::cServerFrameStats(void) :
+	IsHeaderWritten(false),
+	ReportIntervalMs(DEFAULT_REPORT_INTERVAL_MS),
+	LastReportMs(0),
+	LastSkippedTicks(0)
+{
+	for (int phase = 0; phase < PHASE_COUNT; phase++) {
+		Histograms[phase] = new FrameTimeHistogramClass(HISTOGRAM_SLOTS, HISTOGRAM_STEP);
+		MaxUs[phase] = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+cServerFrameStats::~cServerFrameStats(void)
+{
+	for (int phase = 0; phase < PHASE_COUNT; phase++) {
+		delete Histograms[phase];
+		Histograms[phase] = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void cServerFrameStats::Set_File_Name(const char * filename)
+{
+	FileName = (filename != NULL) ? filename : "";
+	IsHeaderWritten = false;
+	LastReportMs = 0;
+	Reset();
+}
+
+//-----------------------------------------------------------------------------
+void cServerFrameStats::Add(PhaseType phase, unsigned long time_us)
+{
+	WWASSERT(phase >= 0 && phase < PHASE_COUNT);
+
+	Histograms[phase]->Add(float(time_us) / 1000000.0f);
+	if (time_us > MaxUs[phase]) {
+		MaxUs[phase] = time_us;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void cServerFrameStats::Update(unsigned long time_ms, unsigned long skipped_ticks)
+{
+	if (!Is_Enabled()) {
+		return;
+	}
+
+	if (LastReportMs == 0) {
+		LastReportMs = time_ms;
+		LastSkippedTicks = skipped_ticks;
+		return;
+	}
+
+	if (time_ms - LastReportMs >= ReportIntervalMs) {
+		Write_Report(time_ms, skipped_ticks - LastSkippedTicks);
+		LastReportMs = time_ms;
+		LastSkippedTicks = skipped_ticks;
+		Reset();
+	}
+}
+
+//-----------------------------------------------------------------------------
+void cServerFrameStats::Write_Report(unsigned long time_ms, unsigned long skipped_ticks)
+{
+	FILE * file = fopen(FileName, "a");
+	if (file == NULL) {
+		WWDEBUG_SAY(("cServerFrameStats - can't open %s\n", (const char *)FileName));
+		return;
+	}
+
+	if (!IsHeaderWritten) {
+		fprintf(file, "time_s,phase,count,p50_ms,p90_ms,p99_ms,max_ms,skipped_ticks\n");
+		IsHeaderWritten = true;
+	}
+
+	for (int phase = 0; phase < PHASE_COUNT; phase++) {
+		FrameTimeHistogramClass * histogram = Histograms[phase];
+		fprintf(file, "%lu,%s,%u,%.2f,%.2f,%.2f,%.2f,%lu\n",
+			time_ms / 1000,
+			PhaseNames[phase],
+			histogram->Get_Total(),
+			histogram->Get_Percentile(0.5f),
+			histogram->Get_Percentile(0.9f),
+			histogram->Get_Percentile(0.99f),
+			float(MaxUs[phase]) / 1000.0f,
+			skipped_ticks);
+	}
+
+	fclose(file);
+}
+
+//-----------------------------------------------------------------------------
+void cServerFrameStats::Reset(void)
+{
+	for (int phase = 0; phase < PHASE_COUNT; phase++) {
+		Histograms[phase]->Reset();
+		MaxUs[phase] = 0;
+	}
+}
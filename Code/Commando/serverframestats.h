@@ -0,0 +1,92 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***                            Confidential - Westwood Studios                              ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Commando                                                     *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Commando/serverframestats.h                  $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef __SERVERFRAMESTATS_H__
+#define __SERVERFRAMESTATS_H__
+
+#include "wwstring.h"
+
+class FrameTimeHistogramClass;
+
+//-----------------------------------------------------------------------------
+//
+// Dedicated server frame time telemetry. Each phase of the frame has its own
+// FrameTimeHistogramClass; every report interval the percentiles of each are
+// appended to a CSV file and the histograms start again.
+//
+class cServerFrameStats
+{
+public:
+	cServerFrameStats(void);
+	~cServerFrameStats(void);
+
+	enum PhaseType {
+		PHASE_FRAME,			// all the work of a tick
+		PHASE_THINK,			// game modes, including the network update in a game
+		PHASE_OBJECTS,			// network object manager and server control
+		PHASE_INPUT,			// packets read while waiting for the next tick
+		PHASE_WAIT,				// time spent waiting for the next tick
+		PHASE_LATENESS,		// how late each tick started
+		PHASE_COUNT
+	};
+
+	enum {DEFAULT_REPORT_INTERVAL_MS	= 60000};
+
+	//
+	// An empty name turns the report off.
+	//
+	void					Set_File_Name(const char * filename);
+	bool					Is_Enabled(void) const								{return !FileName.Is_Empty();}
+	void					Set_Report_Interval_Ms(unsigned long interval)	{ReportIntervalMs = interval;}
+
+	void					Add(PhaseType phase, unsigned long time_us);
+
+	//
+	// Call once a frame; writes and resets when the interval is up.
+	//
+	void					Update(unsigned long time_ms, unsigned long skipped_ticks);
+
+private:
+	void					Write_Report(unsigned long time_ms, unsigned long skipped_ticks);
+	void					Reset(void);
+
+	FrameTimeHistogramClass *	Histograms[PHASE_COUNT];
+	unsigned long			MaxUs[PHASE_COUNT];
+
+	StringClass				FileName;
+	bool						IsHeaderWritten;
+	unsigned long			ReportIntervalMs;
+	unsigned long			LastReportMs;
+	unsigned long			LastSkippedTicks;
+};
+
+//-----------------------------------------------------------------------------
+
+#endif	// __SERVERFRAMESTATS_H__
@@ -0,0 +1,201 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***                            Confidential - Westwood Studios                              ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Commando                                                     *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Commando/servertick.cpp                      $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "servertick.h"
+#include "wwdebug.h"
+
+//
+// select and Sleep wake on the 1ms timer tick at best, so the wait is handed
+// back this far ahead of the deadline and the remainder is polled.
+//
+static const unsigned long POLL_MARGIN_US = 1000;
+
+
+//-----------------------------------------------------------------------------
+cSocketTickClock::cSocketTickClock(void) :
+	Socket(INVALID_SOCKET),
+	Frequency(0)
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	Frequency = frequency.QuadPart;
+	WWASSERT(Frequency > 0);
+}
+
+//-----------------------------------------------------------------------------
+unsigned long cSocketTickClock::Get_Time_Us(void)
+{
+	LARGE_INTEGER count;
+	QueryPerformanceCounter(&count);
+
+	__int64 seconds = count.QuadPart / Frequency;
+	__int64 remainder = count.QuadPart % Frequency;
+	return (unsigned long)(seconds * 1000000 + (remainder * 1000000) / Frequency);
+}
+
+//-----------------------------------------------------------------------------
+bool cSocketTickClock::Wait_For_Input(unsigned long timeout_us)
+{
+	if (timeout_us > POLL_MARGIN_US) {
+		return Poll_Socket(timeout_us - POLL_MARGIN_US);
+	}
+
+	if (Poll_Socket(0)) {
+		return true;
+	}
+	Sleep(0);
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+bool cSocketTickClock::Poll_Socket(unsigned long timeout_us)
+{
+	if (Socket == INVALID_SOCKET) {
+		Sleep(timeout_us / 1000);
+		return false;
+	}
+
+	fd_set readable;
+	FD_ZERO(&readable);
+	FD_SET(Socket, &readable);
+
+	timeval timeout;
+	timeout.tv_sec = timeout_us / 1000000;
+	timeout.tv_usec = timeout_us % 1000000;
+
+	int result = select(Socket + 1, &readable, NULL, NULL, &timeout);
+	if (result == SOCKET_ERROR) {
+		//
+		// The socket was closed under us. Fall back to a plain sleep until it
+		// is replaced.
+		//
+		WWDEBUG_SAY(("cSocketTickClock - select failed with error code %d\n", WSAGetLastError()));
+		Socket = INVALID_SOCKET;
+		return false;
+	}
+	return result > 0;
+}
+
+
+//-----------------------------------------------------------------------------
+cServerTickScheduler::cServerTickScheduler(cServerTickClock * clock) :
+	Clock(clock),
+	TickRate(DEFAULT_TICK_RATE),
+	MaxCatchUpTicks(DEFAULT_MAX_CATCH_UP_TICKS),
+	IsStarted(false),
+	GridStart(0),
+	GridTick(0),
+	TickLatenessUs(0),
+	TickCount(0),
+	CatchUpCount(0),
+	SkippedCount(0)
+{
+	WWASSERT(Clock != NULL);
+}
+
+//-----------------------------------------------------------------------------
+void cServerTickScheduler::Set_Tick_Rate(int ticks_per_second)
+{
+	WWASSERT(ticks_per_second > 0 && ticks_per_second <= 1000);
+
+	//
+	// Keep the deadline already promised and start a new grid from it.
+	//
+	if (IsStarted) {
+		GridStart = Get_Deadline();
+		GridTick = 0;
+	}
+	TickRate = ticks_per_second;
+}
+
+//-----------------------------------------------------------------------------
+void cServerTickScheduler::Set_Max_Catch_Up_Ticks(int ticks)
+{
+	WWASSERT(ticks >= 0);
+	MaxCatchUpTicks = ticks;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long cServerTickScheduler::Get_Deadline(void) const
+{
+	return GridStart + (unsigned long)(((__int64)GridTick * 1000000) / TickRate);
+}
+
+//-----------------------------------------------------------------------------
+void cServerTickScheduler::Advance(unsigned long ticks)
+{
+	GridTick += ticks;
+	GridStart += (GridTick / TickRate) * 1000000;
+	GridTick %= TickRate;
+}
+
+//-----------------------------------------------------------------------------
+cServerTickScheduler::WaitResultType cServerTickScheduler::Wait(void)
+{
+	for (;;) {
+
+		unsigned long now = Clock->Get_Time_Us();
+		if (!IsStarted) {
+			GridStart = now;
+			GridTick = 0;
+			IsStarted = true;
+		}
+
+		unsigned long deadline = Get_Deadline();
+		long remaining = (long)(deadline - now);
+		if (remaining > 0) {
+			if (Clock->Wait_For_Input(remaining)) {
+				return WAIT_INPUT;
+			}
+			continue;
+		}
+
+		//
+		// Count the whole ticks missed after this one. Up to MaxCatchUpTicks
+		// of them will run on the following calls without waiting.
+		//
+		unsigned long late = now - deadline;
+		unsigned long behind = (unsigned long)(((__int64)late * TickRate) / 1000000);
+		if (behind > (unsigned long)MaxCatchUpTicks) {
+			unsigned long skipped = behind - MaxCatchUpTicks;
+			Advance(skipped);
+			SkippedCount += skipped;
+			late = now - Get_Deadline();
+		}
+		if (behind > 0) {
+			CatchUpCount++;
+		}
+
+		TickLatenessUs = late;
+		Advance(1);
+		TickCount++;
+		return WAIT_TICK;
+	}
+}
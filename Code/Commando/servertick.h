@@ -0,0 +1,147 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***                            Confidential - Westwood Studios                              ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Commando                                                     *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Commando/servertick.h                        $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef __SERVERTICK_H__
+#define __SERVERTICK_H__
+
+#include "win.h"
+#include <winsock.h>
+
+//-----------------------------------------------------------------------------
+//
+// Where the scheduler gets its time from and how it waits. Times are in
+// microseconds and wrap; only differences are meaningful.
+//
+class cServerTickClock
+{
+public:
+	virtual ~cServerTickClock(void)													{}
+
+	virtual unsigned long	Get_Time_Us(void)										= 0;
+
+	//
+	// Block for up to timeout_us. Returns true as soon as there is input
+	// waiting, false if the time ran out.
+	//
+	virtual bool				Wait_For_Input(unsigned long timeout_us)		= 0;
+};
+
+//-----------------------------------------------------------------------------
+//
+// The real clock. Time comes from the performance counter and waiting is a
+// select on the server socket, so a packet ends the wait the moment it
+// arrives. select only wakes to the timer resolution, so the last stretch
+// before a deadline is polled instead.
+//
+class cSocketTickClock : public cServerTickClock
+{
+public:
+	cSocketTickClock(void);
+
+	void						Set_Socket(SOCKET sock)								{Socket = sock;}
+
+	virtual unsigned long	Get_Time_Us(void);
+	virtual bool				Wait_For_Input(unsigned long timeout_us);
+
+private:
+	bool						Poll_Socket(unsigned long timeout_us);
+
+	SOCKET					Socket;
+	__int64					Frequency;
+};
+
+//-----------------------------------------------------------------------------
+//
+// Runs the dedicated server at a fixed tick rate. Deadlines are kept on an
+// exact grid from the first tick, so time lost to a slow frame is made up by
+// running the following ticks back to back rather than drifting. At most
+// Max_Catch_Up_Ticks missed ticks are made up; beyond that the rest are
+// dropped and the grid moves forward.
+//
+class cServerTickScheduler
+{
+public:
+	cServerTickScheduler(cServerTickClock * clock);
+
+	enum WaitResultType {
+		WAIT_TICK,			// time to run a frame
+		WAIT_INPUT			// input arrived before the next deadline; call Wait again after reading it
+	};
+
+	enum {DEFAULT_TICK_RATE				= 60};
+	enum {DEFAULT_MAX_CATCH_UP_TICKS	= 4};
+
+	void						Set_Tick_Rate(int ticks_per_second);
+	int						Get_Tick_Rate(void) const							{return TickRate;}
+	void						Set_Max_Catch_Up_Ticks(int ticks);
+	int						Get_Max_Catch_Up_Ticks(void) const				{return MaxCatchUpTicks;}
+
+	//
+	// Start the grid again at the next call to Wait, e.g. after a level load.
+	//
+	void						Reset(void)												{IsStarted = false;}
+
+	WaitResultType			Wait(void);
+
+	//
+	// How long after its deadline the tick Wait just returned started.
+	//
+	unsigned long			Get_Tick_Lateness_Us(void) const					{return TickLatenessUs;}
+	unsigned long			Get_Tick_Interval_Us(void) const					{return 1000000 / TickRate;}
+
+	unsigned long			Get_Tick_Count(void) const							{return TickCount;}
+	unsigned long			Get_Catch_Up_Count(void) const					{return CatchUpCount;}
+	unsigned long			Get_Skipped_Count(void) const						{return SkippedCount;}
+
+private:
+	unsigned long			Get_Deadline(void) const;
+	void						Advance(unsigned long ticks);
+
+	cServerTickClock *	Clock;
+	int						TickRate;
+	int						MaxCatchUpTicks;
+
+	//
+	// The next deadline is GridStart + GridTick seconds / TickRate. GridStart
+	// moves on a whole second at a time so the product never overflows.
+	//
+	bool						IsStarted;
+	unsigned long			GridStart;
+	unsigned long			GridTick;
+
+	unsigned long			TickLatenessUs;
+	unsigned long			TickCount;
+	unsigned long			CatchUpCount;
+	unsigned long			SkippedCount;
+};
+
+//-----------------------------------------------------------------------------
+
+#endif	// __SERVERTICK_H__
@@ -78,6 +78,7 @@
 #include "dx8caps.h"
 #include "registry.h"
 #include "specialbuilds.h"
+#include "workerpool.h"
 #include <windows.h>
 #include <lmcons.h>	// UNLEN
 extern SimpleFileFactoryClass RenegadeBaseFileFactory;
@@ -434,6 +435,7 @@ void Game_Shutdown(void)
 	WWSaveLoad::Shutdown();
 	WW3D::Shutdown();
 	WWPhys::Shutdown();
+	WorkerPoolClass::Shutdown();
 
 //	WW3DAssetManager::Get_Instance()->Free_Assets();
 	Debug_Refs();
@@ -38,6 +38,8 @@
 #include "scripts.h"
 #include "dprint.h"
 #include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
 
 /******************************************************************************
 *
@@ -57,7 +59,10 @@
 ******************************************************************************/
 
 ScriptFactory::ScriptFactory(const char* name, const char* param)
-	: mNext(NULL)
+	: mNext(NULL),
+		mParamNameCount(-1),
+		mParamNameBuffer(NULL),
+		mParamNames(NULL)
 {
 	// Save script name
 	assert(name != NULL);
@@ -95,6 +100,14 @@ ScriptFactory::~ScriptFactory()
 
 	ScriptName = NULL;
 	ParamDescription = NULL;
+
+	delete [] mParamNames;
+	mParamNames = NULL;
+
+	if (mParamNameBuffer != NULL) {
+		free(mParamNameBuffer);
+		mParamNameBuffer = NULL;
+	}
 }
 
 
@@ -191,3 +204,99 @@ const char* ScriptFactory::GetParamDescription(void)
 }
 
 
+/******************************************************************************
+*
+* NAME
+*     ScriptFactory::GetParamIndex
+*
+* DESCRIPTION
+*     Find the ordinal position of a named parameter.
+*
+* INPUTS
+*     Name - Name of parameter
+*
+* RESULTS
+*     Index - Ordinal position of parameter, or -1
+*
+******************************************************************************/
+
+int ScriptFactory::GetParamIndex(const char* name)
+{
+	assert(name != NULL);
+
+	if (mParamNameCount < 0) {
+		ParseParamNames();
+	}
+
+	for (int index = 0; index < mParamNameCount; index++) {
+		if (stricmp(mParamNames[index], name) == 0) {
+			return index;
+		}
+	}
+
+	return -1;
+}
+
+
+/******************************************************************************
+*
+* NAME
+*     ScriptFactory::ParseParamNames
+*
+* DESCRIPTION
+*     Split the parameter description ("Name=Default:Type,Name2=...") into
+*     the bare parameter names. Done once per factory rather than on every
+*     lookup.
+*
+* INPUTS
+*     NONE
+*
+* RESULTS
+*     NONE
+*
+******************************************************************************/
+
+void ScriptFactory::ParseParamNames(void)
+{
+	assert(ParamDescription != NULL);
+
+	mParamNameBuffer = strdup(ParamDescription);
+	assert(mParamNameBuffer != NULL);
+
+	// Count the parameters
+	int count = 0;
+	char* param_ptr = mParamNameBuffer;
+	if (*param_ptr) count++;
+	for (; *param_ptr; param_ptr++) {
+		if (*param_ptr == ',') count++;
+	}
+
+	mParamNames = new const char*[count + 1];
+	assert(mParamNames != NULL);
+
+	count = 0;
+	param_ptr = mParamNameBuffer;
+	while (*param_ptr) {
+		// Find where this parameter ends
+		char* next = param_ptr;
+		while (*next && *next != ',') next++;
+		if (*next) *next++ = 0;
+
+		// Strip the name portion from the parameter definition
+		char* tokenEnd = strpbrk(param_ptr, "=:\n");
+
+		if (tokenEnd != NULL) {
+			*tokenEnd = '\0';
+		}
+
+		// Trim white space around the name
+		while (isspace((unsigned char)*param_ptr)) param_ptr++;
+		char* name_end = (param_ptr + strlen(param_ptr));
+		while ((name_end > param_ptr) && isspace((unsigned char)name_end[-1])) *--name_end = '\0';
+
+		mParamNames[count++] = param_ptr;
+		param_ptr = next;
+	}
+
+	mParamNameCount = count;
+}
@@ -50,6 +50,9 @@ class ScriptFactory
 		// Retrieve the parameter description for this ScriptFactory
 		const char* GetParamDescription(void);
 
+		// Retrieve the ordinal position of a named parameter, or -1
+		int GetParamIndex(const char* name);
+
 		// Create and instance of this Script
 		virtual ScriptImpClass* Create(void) = 0;
 
@@ -65,9 +68,16 @@ class ScriptFactory
 		void SetNext(ScriptFactory* link);
 
 	private:
+		void ParseParamNames(void);
+
 		ScriptFactory* mNext;
 		const char * ScriptName;
 		const char * ParamDescription;
+
+		// Parameter names split out of the description on first lookup
+		int mParamNameCount;
+		char* mParamNameBuffer;
+		const char** mParamNames;
 	};
 
 #endif // _SCRIPTFACTORY_H_
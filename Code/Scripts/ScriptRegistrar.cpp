@@ -38,11 +38,18 @@
 #include "scriptfactory.h"
 #include "dprint.h"
 #include <string.h>
+#include <ctype.h>
 #include <assert.h>
 
 // ScriptFactory list
 ScriptFactory* ScriptRegistrar::mScriptFactories = NULL;
 
+// Name hash (open addressing) and index order array of the list
+ScriptFactory** ScriptRegistrar::mHashTable = NULL;
+unsigned int ScriptRegistrar::mHashMask = 0;
+ScriptFactory** ScriptRegistrar::mFactoryArray = NULL;
+int ScriptRegistrar::mFactoryCount = 0;
+
 /******************************************************************************
 *
 * NAME
@@ -66,6 +73,8 @@ void ScriptRegistrar::RegisterScript(ScriptFactory* factory)
 
 		factory->SetNext(mScriptFactories);
 		mScriptFactories = factory;
+
+		ReleaseIndex();
 	}
 }
 
@@ -99,7 +108,8 @@ void ScriptRegistrar::UnregisterScript(ScriptFactory* factory)
 			if (previous == NULL) {
 				mScriptFactories = next;
 			} else {
-				previous->SetNext(next);
+				// SetNext() inserts rather than replaces, so unlink directly
+				previous->mNext = next;
 			}
 
 //			DebugPrint("Unregistered script '%s'\n", factory->GetName());
@@ -109,6 +119,8 @@ void ScriptRegistrar::UnregisterScript(ScriptFactory* factory)
 		previous = current;
 		current = next;
 	}
+
+	ReleaseIndex();
 }
 
 
@@ -132,17 +144,11 @@ ScriptImpClass* ScriptRegistrar::CreateScript(const char* scriptName)
 {
 	assert(scriptName != NULL);
 
-	if (scriptName != NULL) {
-		ScriptFactory* factory = mScriptFactories;
+	ScriptFactory* factory = GetScriptFactory(scriptName);
 
-		while (factory != NULL) {
-			if (stricmp(factory->GetName(), scriptName) == 0) {
-//				DebugPrint("Creating Script '%s'\n", factory->GetName());
-				return factory->Create();
-			}
-
-			factory = factory->GetNext();
-		}
+	if (factory != NULL) {
+//		DebugPrint("Creating Script '%s'\n", factory->GetName());
+		return factory->Create();
 	}
 
 	DebugPrint("Failed to find script '%s'\n", scriptName);
@@ -170,15 +176,19 @@ ScriptFactory* ScriptRegistrar::GetScriptFactory(const char* name)
 {
 	assert(name != NULL);
 
-	if (name != NULL) {
-		ScriptFactory* factory = mScriptFactories;
+	if ((name != NULL) && (mScriptFactories != NULL)) {
+		if (mHashTable == NULL) {
+			BuildIndex();
+		}
+
+		unsigned int slot = (HashName(name) & mHashMask);
 
-		while (factory != NULL) {
-			if (stricmp(factory->GetName(), name) == 0) {
-				return factory;
+		while (mHashTable[slot] != NULL) {
+			if (stricmp(mHashTable[slot]->GetName(), name) == 0) {
+				return mHashTable[slot];
 			}
 
-			factory = factory->GetNext();
+			slot = ((slot + 1) & mHashMask);
 		}
 	}
 
@@ -204,19 +214,15 @@ ScriptFactory* ScriptRegistrar::GetScriptFactory(const char* name)
 
 ScriptFactory* ScriptRegistrar::GetScriptFactory(int index)
 {
-	int count = 0;
-	ScriptFactory* factory = mScriptFactories;
-
-	while (factory != NULL) {
-		if (count == index) {
-			return factory;
-		}
+	if (mFactoryArray == NULL) {
+		BuildIndex();
+	}
 
-		count++;
-		factory = factory->GetNext();
+	if ((index < 0) || (index >= mFactoryCount)) {
+		return NULL;
 	}
 
-	return NULL;
+	return mFactoryArray[index];
 }
 
 
@@ -238,6 +244,35 @@ ScriptFactory* ScriptRegistrar::GetScriptFactory(int index)
 
 int ScriptRegistrar::Count(void)
 {
+	if (mFactoryArray == NULL) {
+		BuildIndex();
+	}
+
+	return mFactoryCount;
+}
+
+
+/******************************************************************************
+*
+* NAME
+*     ScriptRegistrar::BuildIndex
+*
+* DESCRIPTION
+*     Build the name hash table and the index order array from the factory
+*     list.
+*
+* INPUTS
+*     NONE
+*
+* RESULTS
+*     NONE
+*
+******************************************************************************/
+
+void ScriptRegistrar::BuildIndex(void)
+{
+	ReleaseIndex();
+
 	int count = 0;
 	ScriptFactory* factory = mScriptFactories;
 
@@ -246,5 +281,98 @@ int ScriptRegistrar::Count(void)
 		factory = factory->GetNext();
 	}
 
-	return count;
+	// Keep the table at most half full so probe runs stay short
+	unsigned int size = 16;
+
+	while (size < (unsigned int)(count * 2)) {
+		size <<= 1;
+	}
+
+	mHashTable = new ScriptFactory*[size];
+	assert(mHashTable != NULL);
+	memset(mHashTable, 0, (sizeof(ScriptFactory*) * size));
+	mHashMask = (size - 1);
+
+	mFactoryArray = new ScriptFactory*[count + 1];
+	assert(mFactoryArray != NULL);
+	mFactoryCount = count;
+
+	count = 0;
+	factory = mScriptFactories;
+
+	while (factory != NULL) {
+		mFactoryArray[count++] = factory;
+
+		// When two factories share a name the one nearest the head of the
+		// list wins, as it did with the list search.
+		unsigned int slot = (HashName(factory->GetName()) & mHashMask);
+
+		while ((mHashTable[slot] != NULL) && (stricmp(mHashTable[slot]->GetName(), factory->GetName()) != 0)) {
+			slot = ((slot + 1) & mHashMask);
+		}
+
+		if (mHashTable[slot] == NULL) {
+			mHashTable[slot] = factory;
+		}
+
+		factory = factory->GetNext();
+	}
+}
+
+
+/******************************************************************************
+*
+* NAME
+*     ScriptRegistrar::ReleaseIndex
+*
+* DESCRIPTION
+*     Discard the lookup tables after the factory list has changed.
+*
+* INPUTS
+*     NONE
+*
+* RESULTS
+*     NONE
+*
+******************************************************************************/
+
+void ScriptRegistrar::ReleaseIndex(void)
+{
+	delete [] mHashTable;
+	mHashTable = NULL;
+	mHashMask = 0;
+
+	delete [] mFactoryArray;
+	mFactoryArray = NULL;
+	mFactoryCount = 0;
+}
+
+
+/******************************************************************************
+*
+* NAME
+*     ScriptRegistrar::HashName
+*
+* DESCRIPTION
+*     Case insensitive hash of a script name, since names are compared
+*     with stricmp.
+*
+* INPUTS
+*     Name - Name of script
+*
+* RESULTS
+*     Hash
+*
+******************************************************************************/
+
+unsigned int ScriptRegistrar::HashName(const char* name)
+{
+	unsigned int hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash ^= (unsigned int)tolower((unsigned char)*name++);
+		hash *= 16777619U;
+	}
+
+	return hash;
 }
@@ -44,7 +44,19 @@ class ScriptRegistrar
 		static int Count(void);
 
 	private:
+		// Factories are registered by static constructors, before anything
+		// else could be initialized, so the lookup tables are built on first
+		// use and thrown away whenever the list changes.
+		static void BuildIndex(void);
+		static void ReleaseIndex(void);
+		static unsigned int HashName(const char* name);
+
 		static ScriptFactory* mScriptFactories;
+
+		static ScriptFactory** mHashTable;
+		static unsigned int mHashMask;
+		static ScriptFactory** mFactoryArray;
+		static int mFactoryCount;
 	};
 
 #endif // _SCRIPTREGISTRAR_H_
@@ -36,7 +36,6 @@
 #include "scripts.h"
 #include "scriptfactory.h"
 #include "dprint.h"
-#include "strtrim.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -79,6 +78,7 @@ ScriptImpClass::ScriptImpClass()
 	: mOwner(NULL),
 		mArgC(0),
 		mArgV(NULL),
+		mArgBuffer(NULL),
 		AutoVariableList( NULL )
 {
 }
@@ -258,6 +258,7 @@ void ScriptImpClass::Set_Parameters_String(const char* params)
 	}
 
 	if (count == 0) {
+		free(working);
 		return;
 	}
 
@@ -266,12 +267,14 @@ void ScriptImpClass::Set_Parameters_String(const char* params)
 
 	// Create new argument vector
 	mArgC = count;
-	mArgV = new char*[count];
+	mArgV = new ParameterStruct[count];
 	assert(mArgV != NULL);
-	memset(mArgV, 0, (sizeof(char*) * count));
+	memset(mArgV, 0, (sizeof(ParameterStruct) * count));
 
-	// Copy the parameters
+	// Copy the parameters. The strings are left in the working copy, which
+	// the script keeps until the parameters are cleared.
 	strcpy(working, params);
+	mArgBuffer = working;
 
 	count = 0;
 	param_ptr = working;
@@ -290,8 +293,6 @@ void ScriptImpClass::Set_Parameters_String(const char* params)
 	if (count == mArgC - 1) {
 		Set_Parameter(count, "");
 	}
-
-	free(working);
 }
 
 
@@ -358,18 +359,15 @@ void ScriptImpClass::Get_Parameters_String(char* buffer, unsigned int size)
 
 void ScriptImpClass::Clear_Parameters(void)
 {
-	if (mArgV != NULL) {
-		while (mArgC--) {
-			if (mArgV[mArgC] != NULL) {
-				free((void*)mArgV[mArgC]);
-			}
-		}
+	delete [] mArgV;
 
-		delete (void*)mArgV;
+	if (mArgBuffer != NULL) {
+		free(mArgBuffer);
 	}
 
 	mArgC = 0;
 	mArgV = NULL;
+	mArgBuffer = NULL;
 }
 
 
@@ -379,11 +377,11 @@ void ScriptImpClass::Clear_Parameters(void)
 *     ScriptImpClass::Set_Parameter
 *
 * DESCRIPTION
-*     Set a script parameter
+*     Set a script parameter and convert it to its numeric forms.
 *
 * INPUTS
 *     Index - Ordinal position of parameter
-*     Param - Parameter string
+*     Param - Parameter string, which must outlive the parameters
 *
 * RESULTS
 *     NONE
@@ -392,13 +390,14 @@ void ScriptImpClass::Clear_Parameters(void)
 
 void ScriptImpClass::Set_Parameter(int index, const char* str)
 {
-	// Release old parameter
-	if (mArgV[index] != NULL) {
-		free((void*)mArgV[index]);
-	}
-
-	mArgV[index] = strdup(str);
-	assert(mArgV[index] != NULL);
+	assert(Is_Parameter_Index_Valid(index));
+	assert(str != NULL);
+
+	ParameterStruct& param = mArgV[index];
+	param.String = str;
+	param.Int = atoi(str);
+	param.Float = (float)atof(str);
+	param.IsVectorValid = false;
 }
 
 
@@ -443,11 +442,11 @@ const char* ScriptImpClass::Get_Parameter(const char* name)
 
 const char* ScriptImpClass::Get_Parameter(int index)
 {
-	if ((index < 0) || (index >= mArgC)) {
+	if (!Is_Parameter_Index_Valid(index)) {
 		return "";
 	}
 
-	return mArgV[index];
+	return mArgV[index].String;
 }
 
 
@@ -502,9 +501,18 @@ float ScriptImpClass::Get_Float_Parameter(const char* parameterName)
 ******************************************************************************/
 Vector3 ScriptImpClass::Get_Vector3_Parameter( int index )
 {
-	float		x,y,z;
-	::sscanf( Get_Parameter( index ), "%f %f %f", &x, &y, &z );
-	return Vector3( x,y,z );
+	if ( !Is_Parameter_Index_Valid( index ) ) {
+		return Vector3( 0,0,0 );
+	}
+
+	ParameterStruct & param = mArgV[index];
+	if ( !param.IsVectorValid ) {
+		float		x = 0,y = 0,z = 0;
+		::sscanf( param.String, "%f %f %f", &x, &y, &z );
+		param.Vector.Set( x,y,z );
+		param.IsVectorValid = true;
+	}
+	return param.Vector;
 }
 
 
@@ -534,43 +542,8 @@ Vector3 ScriptImpClass::Get_Vector3_Parameter(const char* parameterName)
 
 int ScriptImpClass::Get_Parameter_Index(const char* parameterName)
 {
-	const char* paramDesc = mFactory->GetParamDescription();
-
-	// Make copy of parameter description string to work with.
-	char string[512];
-	strncpy(string, paramDesc, (sizeof(string) - 1));
-	string[sizeof(string)-1] = '\0';
-
-	// Search for the specified parameter
-	int index = 0;
-	char * param_ptr = string;
-	while ( *param_ptr ) {
-		// Find where this parameter ends
-		char * next = param_ptr;
-		while ( *next && *next != ',' ) next++;
-		if ( *next ) *next++ = 0;
-
-		// Strip the name portion from the parameter definition
-		char* tokenEnd = strpbrk(param_ptr, "=:\n");
-
-		if (tokenEnd != NULL) {
-			*tokenEnd = '\0';
-		}
-
-		// Check for specified parameter
-		strtrim(param_ptr);
-
-		if (stricmp(param_ptr, parameterName) == 0) {
-			return index;
-		}
-
-		// Advance to next parameter definition
-		index++;
-
-		param_ptr = next;
-	}
-
-	return -1;
+	assert(mFactory != NULL);
+	return mFactory->GetParamIndex(parameterName);
 }
 
 
@@ -106,14 +106,14 @@ public:
 
 	// Get a parameter as an integer
 	int Get_Int_Parameter(int index)
-		{return atoi(Get_Parameter(index));}
+		{return Is_Parameter_Index_Valid(index) ? mArgV[index].Int : 0;}
 
 	// Get a parameter as an integer
 	int Get_Int_Parameter(const char* parameterName);
 
 	// Get a parameter as a float
 	float Get_Float_Parameter(int index)
-		{return (float)atof(Get_Parameter(index));}
+		{return Is_Parameter_Index_Valid(index) ? mArgV[index].Float : 0.0f;}
 
 	// Get a parameter as a float
 	float Get_Float_Parameter(const char* parameterName);
@@ -175,9 +175,25 @@ private:
 	void Clear_Parameters(void);
 	void Set_Parameter(int index, const char* str);
 
+	bool Is_Parameter_Index_Valid(int index) const
+		{return ((index >= 0) && (index < mArgC));}
+
+	// Parameters are converted once when the parameter string is set, since
+	// scripts tend to read them in every timer and custom event. The vector
+	// form is only wanted by a few scripts, so it is converted on first use.
+	struct ParameterStruct
+	{
+		const char* String;
+		int Int;
+		float Float;
+		bool IsVectorValid;
+		Vector3 Vector;
+	};
+
 	GameObject* mOwner;
 	int mArgC;
-	char** mArgV;
+	ParameterStruct* mArgV;
+	char* mArgBuffer;
 
 	// The factory reference is provided to the script class so that it
 	// knows what it is (IE: Name, Parameter description).
@@ -0,0 +1,252 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Small Object Allocator Benchmark                             *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/allocbench/main.cpp                    $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Times small object allocation with 1, 4 and 16 threads through the system heap, the locked *
+ * ObjectPoolClass and FastFixedAllocator, and the thread cached pool and FastAllocatorGeneral.*
+ * Every object is stamped while it is live so that handing one out twice is caught.          *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "mempool.h"
+#include "FastAllocator.h"
+#include "threadcache.h"
+#include "thread.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const int OPERATIONS_PER_THREAD=2000000;
+const int MAX_LIVE_OBJECTS=256;
+const int MAX_THREADS=16;
+
+static int Failures=0;
+
+struct TestObjectStruct
+{
+	unsigned Stamp;
+	unsigned Data[7];
+};
+
+// ----------------------------------------------------------------------------
+//
+// The allocators being compared. Each one hands out TestObjectStruct sized
+// blocks from any thread.
+//
+// ----------------------------------------------------------------------------
+
+class AllocatorInterface
+{
+public:
+	virtual const char* Get_Name()=0;
+	virtual void* Alloc()=0;
+	virtual void Free(void* ptr)=0;
+};
+
+class MallocAllocator : public AllocatorInterface
+{
+public:
+	const char* Get_Name() { return "malloc/free"; }
+	void* Alloc() { return ::malloc(sizeof(TestObjectStruct)); }
+	void Free(void* ptr) { ::free(ptr); }
+};
+
+class LockedPoolAllocator : public AllocatorInterface
+{
+public:
+	const char* Get_Name() { return "ObjectPoolClass (locked)"; }
+	void* Alloc() { return Pool.Allocate_Object_Memory(); }
+	void Free(void* ptr) { Pool.Free_Object_Memory((TestObjectStruct*)ptr); }
+	ObjectPoolClass<TestObjectStruct,256> Pool;
+};
+
+class CachedPoolAllocator : public AllocatorInterface
+{
+public:
+	const char* Get_Name() { return "ObjectPoolClass (thread cached)"; }
+	void* Alloc() { return Pool.Allocate_Object_Memory(); }
+	void Free(void* ptr) { Pool.Free_Object_Memory((TestObjectStruct*)ptr); }
+	ObjectPoolClass<TestObjectStruct,256,true> Pool;
+};
+
+class LockedFixedAllocator : public AllocatorInterface
+{
+public:
+	LockedFixedAllocator() : Allocator(sizeof(TestObjectStruct)) {}
+	const char* Get_Name() { return "FastFixedAllocator (locked)"; }
+	void* Alloc() { FastCriticalSectionClass::LockClass lock(CS); return Allocator.Alloc(); }
+	void Free(void* ptr) { FastCriticalSectionClass::LockClass lock(CS); Allocator.Free(ptr); }
+	FastFixedAllocator Allocator;
+	FastCriticalSectionClass CS;
+};
+
+class GeneralAllocator : public AllocatorInterface
+{
+public:
+	const char* Get_Name() { return "FastAllocatorGeneral"; }
+	void* Alloc() { return FastAllocatorGeneral::Get_Allocator()->Alloc(sizeof(TestObjectStruct)); }
+	void Free(void* ptr) { FastAllocatorGeneral::Get_Allocator()->Free(ptr); }
+};
+
+// ----------------------------------------------------------------------------
+//
+// Each thread keeps a window of live objects and replaces a pseudo random one
+// per step, so allocation and free order don't simply mirror each other.
+// Now and then an object is handed over to be freed by the next thread.
+//
+// ----------------------------------------------------------------------------
+
+static void* volatile SharedSlots[MAX_THREADS];
+
+class BenchThreadClass : public ThreadClass
+{
+public:
+	BenchThreadClass() : Allocator(NULL), Index(0), ThreadCount(1), Errors(0), StartFlag(NULL) {}
+
+	AllocatorInterface* Allocator;
+	int Index;
+	int ThreadCount;
+	int Errors;
+	volatile bool* StartFlag;
+
+protected:
+	void Thread_Function()
+	{
+		while (!*StartFlag) {
+			Switch_Thread();
+		}
+
+		TestObjectStruct* live[MAX_LIVE_OBJECTS];
+		unsigned stamp=(Index+1)<<24;
+		for (int i=0;i<MAX_LIVE_OBJECTS;++i) {
+			live[i]=(TestObjectStruct*)Allocator->Alloc();
+			live[i]->Stamp=stamp+i;
+		}
+
+		unsigned random=Index*7919+1;
+		for (int op=0;op<OPERATIONS_PER_THREAD;++op) {
+			random=random*1664525+1013904223;
+			int slot=(random>>16)%MAX_LIVE_OBJECTS;
+			TestObjectStruct* obj=live[slot];
+			if ((obj->Stamp>>24)!=(unsigned)(Index+1)) {
+				Errors++;
+			}
+
+			// Swap one object with the shared slot of the next thread now and then
+			if ((op&1023)==0 && ThreadCount>1) {
+				obj->Stamp=0;
+				void* other=InterlockedExchangePointer((void* volatile*)&SharedSlots[(Index+1)%ThreadCount],obj);
+				if (other) Allocator->Free(other);
+			} else {
+				Allocator->Free(obj);
+			}
+
+			obj=(TestObjectStruct*)Allocator->Alloc();
+			obj->Stamp=stamp+slot;
+			live[slot]=obj;
+		}
+
+		for (int i=0;i<MAX_LIVE_OBJECTS;++i) {
+			Allocator->Free(live[i]);
+		}
+	}
+};
+
+static double Run(AllocatorInterface& allocator,int thread_count)
+{
+	BenchThreadClass threads[MAX_THREADS];
+	volatile bool start=false;
+
+	for (int i=0;i<MAX_THREADS;++i) {
+		SharedSlots[i]=NULL;
+	}
+
+	for (int i=0;i<thread_count;++i) {
+		threads[i].Allocator=&allocator;
+		threads[i].Index=i;
+		threads[i].ThreadCount=thread_count;
+		threads[i].StartFlag=&start;
+		threads[i].Execute();
+	}
+
+	LARGE_INTEGER freq,begin,end;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&begin);
+	start=true;
+
+	int errors=0;
+	for (int i=0;i<thread_count;++i) {
+		while (threads[i].Is_Running()) {
+			ThreadClass::Sleep_Ms(1);
+		}
+		errors+=threads[i].Errors;
+	}
+	QueryPerformanceCounter(&end);
+
+	for (int i=0;i<thread_count;++i) {
+		if (SharedSlots[i]) allocator.Free(SharedSlots[i]);
+	}
+
+	if (errors) {
+		printf("%s: %d stamp errors with %d threads FAILED\n",allocator.Get_Name(),errors,thread_count);
+		Failures++;
+	}
+
+	double seconds=double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+	double operations=2.0*OPERATIONS_PER_THREAD*thread_count;
+	return operations/seconds/1000000.0;
+}
+
+int main(void)
+{
+	MallocAllocator malloc_allocator;
+	LockedPoolAllocator locked_pool;
+	CachedPoolAllocator cached_pool;
+	LockedFixedAllocator locked_fixed;
+	GeneralAllocator general;
+	AllocatorInterface* allocators[]={ &malloc_allocator, &locked_pool, &locked_fixed, &cached_pool, &general };
+	static const int thread_counts[]={ 1, 4, 16 };
+
+	printf("%d alloc/free pairs per thread, %d byte objects. Million operations per second:\n\n",OPERATIONS_PER_THREAD,sizeof(TestObjectStruct));
+	printf("%-34s %10s %10s %10s\n","","1 thread","4 threads","16 threads");
+
+	for (int a=0;a<sizeof(allocators)/sizeof(allocators[0]);++a) {
+		printf("%-34s",allocators[a]->Get_Name());
+		for (int t=0;t<sizeof(thread_counts)/sizeof(thread_counts[0]);++t) {
+			printf(" %10.1f",Run(*allocators[a],thread_counts[t]));
+		}
+		printf("\n");
+	}
+
+	// Everything must have come back to the pool
+	if (cached_pool.Pool.Get_Allocated_Object_Count()!=0) {
+		printf("thread cached pool leaked %d objects FAILED\n",cached_pool.Pool.Get_Allocated_Object_Count());
+		Failures++;
+	}
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
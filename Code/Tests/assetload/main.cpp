@@ -0,0 +1,519 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Background Asset Load Test                                   *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/assetload/main.cpp                     $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Loads a set of .w3d files into a headless WW3DAssetManager with Load_3D_Assets, one file   *
+ * at a time, and again with Load_3D_Assets_Async, first with the jobs run inline and then on *
+ * the worker pool, and with Load_3D_Assets_Batched as the level load uses it. The manager    *
+ * must end up the same each time: the same prototypes in the same order, HLOD definitions    *
+ * that save to the same bytes and the same hierarchy trees.                                  *
+ * Names used by more than one file must resolve to the first file's copy, and a loader that  *
+ * isn't thread safe must only ever run on the main thread.                                   *
+ *                                                                                             *
+ * Arguments: [file.w3d ...]    without any, a set of files is generated in the current       *
+ *                              directory and deleted afterwards                               *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "assetmgr.h"
+#include "assetload.h"
+#include "proto.h"
+#include "hlod.h"
+#include "htree.h"
+#include "aabox.h"
+#include "w3d_file.h"
+#include "chunkio.h"
+#include "rawfile.h"
+#include "ramfile.h"
+#include "workerpool.h"
+#include "wwstring.h"
+#include "simplevec.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+	FILE_COUNT=64,
+	PIVOT_COUNT=40,
+	NULL_COUNT=40,
+	BOX_COUNT=20,
+	CHUNK_TEST_OBJECT=0x7F00		// handled by TestLoader, which isn't thread safe
+};
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	if (!ok) {
+		printf("%s FAILED\n",what);
+		Failures++;
+	}
+}
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+WW3DAssetManager The3DAssetManager;
+
+// ----------------------------------------------------------------------------
+//
+// A loader for a made up chunk type, standing in for the loaders that have
+// to stay on the main thread. It counts the calls made from anywhere else.
+//
+// ----------------------------------------------------------------------------
+
+static DWORD MainThreadId;
+static int OffMainThreadLoads=0;
+
+class TestPrototypeClass : public PrototypeClass
+{
+public:
+	TestPrototypeClass(const char * name) : Name(name) {}
+	virtual const char *			Get_Name(void) const			{ return Name; }
+	virtual int						Get_Class_ID(void) const	{ return RenderObjClass::CLASSID_NULL; }
+	virtual RenderObjClass *	Create(void)					{ return NULL; }
+	StringClass						Name;
+};
+
+class TestLoaderClass : public PrototypeLoaderClass
+{
+public:
+	virtual int						Chunk_Type(void) { return CHUNK_TEST_OBJECT; }
+	virtual PrototypeClass *	Load_W3D(ChunkLoadClass & cload)
+	{
+		if (GetCurrentThreadId() != MainThreadId) {
+			OffMainThreadLoads++;
+		}
+		char name[W3D_NAME_LEN*2];
+		if (cload.Read(name,sizeof(name)) != sizeof(name)) {
+			return NULL;
+		}
+		name[sizeof(name)-1]=0;
+		return new TestPrototypeClass(name);
+	}
+};
+
+static TestLoaderClass TestLoader;
+
+// ----------------------------------------------------------------------------
+//
+// Generated files. Each has a hierarchy, an HLOD with a proxy array, null
+// objects, boxes and test objects. Every file also has a box and a hierarchy
+// named after the previous file, so half the names collide.
+//
+// ----------------------------------------------------------------------------
+
+static void Write_Name(char * dest,int size,const char * format,int a,int b=0)
+{
+	memset(dest,0,size);
+	_snprintf(dest,size-1,format,a,b);
+}
+
+static void Write_Hierarchy(ChunkSaveClass & csave,const char * name,int seed)
+{
+	csave.Begin_Chunk(W3D_CHUNK_HIERARCHY);
+
+	W3dHierarchyStruct header;
+	memset(&header,0,sizeof(header));
+	header.Version=W3D_CURRENT_HTREE_VERSION;
+	strncpy(header.Name,name,W3D_NAME_LEN-1);
+	header.NumPivots=PIVOT_COUNT;
+	csave.Begin_Chunk(W3D_CHUNK_HIERARCHY_HEADER);
+	csave.Write(&header,sizeof(header));
+	csave.End_Chunk();
+
+	csave.Begin_Chunk(W3D_CHUNK_PIVOTS);
+	for (int i=0;i<PIVOT_COUNT;i++) {
+		W3dPivotStruct pivot;
+		memset(&pivot,0,sizeof(pivot));
+		Write_Name(pivot.Name,W3D_NAME_LEN,"B%d_%d",seed,i);
+		pivot.ParentIdx=(i==0) ? 0xFFFFFFFF : (uint32)((i*7+seed)%i);
+		pivot.Translation.X=float(i);
+		pivot.Translation.Y=float(seed%13);
+		pivot.Rotation.Q[3]=1.0f;
+		csave.Write(&pivot,sizeof(pivot));
+	}
+	csave.End_Chunk();
+
+	csave.End_Chunk();
+}
+
+static void Write_Sub_Objects(ChunkSaveClass & csave,int chunk_id,int count,int seed)
+{
+	csave.Begin_Chunk(chunk_id);
+
+	W3dHLodArrayHeaderStruct header;
+	header.ModelCount=count;
+	header.MaxScreenSize=float(seed+1);
+	csave.Begin_Chunk(W3D_CHUNK_HLOD_SUB_OBJECT_ARRAY_HEADER);
+	csave.Write(&header,sizeof(header));
+	csave.End_Chunk();
+
+	for (int i=0;i<count;i++) {
+		W3dHLodSubObjectStruct sub;
+		sub.BoneIndex=i%PIVOT_COUNT;
+		Write_Name(sub.Name,sizeof(sub.Name),"N%d.OBJ%d",seed,i);
+		csave.Begin_Chunk(W3D_CHUNK_HLOD_SUB_OBJECT);
+		csave.Write(&sub,sizeof(sub));
+		csave.End_Chunk();
+	}
+
+	csave.End_Chunk();
+}
+
+static void Write_HLod(ChunkSaveClass & csave,int seed)
+{
+	csave.Begin_Chunk(W3D_CHUNK_HLOD);
+
+	W3dHLodHeaderStruct header;
+	memset(&header,0,sizeof(header));
+	header.Version=W3D_CURRENT_HLOD_VERSION;
+	header.LodCount=3;
+	Write_Name(header.Name,W3D_NAME_LEN,"HLOD%d",seed);
+	Write_Name(header.HierarchyName,W3D_NAME_LEN,"TREE%d",seed);
+	csave.Begin_Chunk(W3D_CHUNK_HLOD_HEADER);
+	csave.Write(&header,sizeof(header));
+	csave.End_Chunk();
+
+	for (int lod=0;lod<3;lod++) {
+		Write_Sub_Objects(csave,W3D_CHUNK_HLOD_LOD_ARRAY,4+lod*8,seed);
+	}
+	Write_Sub_Objects(csave,W3D_CHUNK_HLOD_AGGREGATE_ARRAY,2,seed);
+	Write_Sub_Objects(csave,W3D_CHUNK_HLOD_PROXY_ARRAY,5,seed);
+
+	csave.End_Chunk();
+}
+
+static void Write_Box(ChunkSaveClass & csave,const char * name,int seed)
+{
+	W3dBoxStruct box;
+	memset(&box,0,sizeof(box));
+	box.Version=W3D_BOX_CURRENT_VERSION;
+	strncpy(box.Name,name,sizeof(box.Name)-1);
+	box.Extent.X=box.Extent.Y=box.Extent.Z=float(seed+1);
+	csave.Begin_Chunk(W3D_CHUNK_BOX);
+	csave.Write(&box,sizeof(box));
+	csave.End_Chunk();
+}
+
+static bool Write_File(const char * filename,int seed)
+{
+	RawFileClass file(filename);
+	if (!file.Open(FileClass::WRITE)) {
+		return false;
+	}
+	ChunkSaveClass csave(&file);
+	char name[W3D_NAME_LEN*2];
+
+	Write_Name(name,W3D_NAME_LEN,"TREE%d",seed);
+	Write_Hierarchy(csave,name,seed);
+	Write_Name(name,W3D_NAME_LEN,"TREE%d",(seed+FILE_COUNT-1)%FILE_COUNT);
+	Write_Hierarchy(csave,name,seed+1000);
+	Write_HLod(csave,seed);
+
+	for (int i=0;i<NULL_COUNT;i++) {
+		W3dNullObjectStruct null;
+		memset(&null,0,sizeof(null));
+		null.Version=W3D_NULL_OBJECT_CURRENT_VERSION;
+		Write_Name(null.Name,sizeof(null.Name),"N%d.NULL%d",seed,i);
+		csave.Begin_Chunk(W3D_CHUNK_NULL_OBJECT);
+		csave.Write(&null,sizeof(null));
+		csave.End_Chunk();
+
+		if (i%4==0) {
+			Write_Name(name,sizeof(name),"N%d.TEST%d",seed,i);
+			csave.Begin_Chunk(CHUNK_TEST_OBJECT);
+			csave.Write(name,sizeof(name));
+			csave.End_Chunk();
+		}
+	}
+
+	for (int i=0;i<BOX_COUNT;i++) {
+		Write_Name(name,sizeof(name),"N%d.BOX%d",seed,i);
+		Write_Box(csave,name,seed);
+	}
+	Write_Name(name,sizeof(name),"N%d.BOX0",(seed+FILE_COUNT-1)%FILE_COUNT);
+	Write_Box(csave,name,seed+1000);
+
+	file.Close();
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+//
+// What the asset manager holds after a load
+//
+// ----------------------------------------------------------------------------
+
+struct AssetSnapshotStruct
+{
+	AssetSnapshotStruct(void) : Prototypes(0), Trees(0) {}
+
+	int						Prototypes;
+	int						Trees;
+	unsigned long			PrototypeHash;		// names and class ids, in order
+	unsigned long			HLodHash;			// every HLOD definition, saved
+	unsigned long			TreeHash;			// names, bones and parents, in order
+	StringClass				FirstBox;			// who won the collision on N0.BOX0
+	float						FirstBoxExtent;
+};
+
+static unsigned long Hash(unsigned long hash,const void * data,int size)
+{
+	const unsigned char * bytes=(const unsigned char *)data;
+	for (int i=0;i<size;i++) {
+		hash=(hash*16777619UL)^bytes[i];
+	}
+	return hash;
+}
+
+static unsigned long Hash_String(unsigned long hash,const char * string)
+{
+	return Hash(hash,string,strlen(string)+1);
+}
+
+static void Take_Snapshot(AssetSnapshotStruct & snap)
+{
+	snap.Prototypes=0;
+	snap.Trees=0;
+	snap.PrototypeHash=2166136261UL;
+	snap.HLodHash=2166136261UL;
+	snap.TreeHash=2166136261UL;
+	snap.FirstBoxExtent=0.0f;
+
+	static unsigned char buffer[64*1024];
+
+	RenderObjIterator * rit=The3DAssetManager.Create_Render_Obj_Iterator();
+	for (rit->First();!rit->Is_Done();rit->Next()) {
+		const char * name=rit->Current_Item_Name();
+		int class_id=rit->Current_Item_Class_ID();
+		snap.PrototypeHash=Hash_String(snap.PrototypeHash,name);
+		snap.PrototypeHash=Hash(snap.PrototypeHash,&class_id,sizeof(class_id));
+		snap.Prototypes++;
+
+		if (strncmp(name,"HLOD",4)==0) {
+			HLodPrototypeClass * proto=(HLodPrototypeClass *)The3DAssetManager.Find_Prototype(name);
+			RAMFileClass file(buffer,sizeof(buffer));
+			file.Open(FileClass::WRITE);
+			ChunkSaveClass csave(&file);
+			proto->Get_Definition()->Save(csave);
+			snap.HLodHash=Hash(snap.HLodHash,buffer,file.Tell());
+		}
+	}
+	The3DAssetManager.Release_Render_Obj_Iterator(rit);
+
+	PrototypeClass * box=The3DAssetManager.Find_Prototype("N0.BOX0");
+	if (box!=NULL) {
+		snap.FirstBox=box->Get_Name();
+		RenderObjClass * robj=box->Create();
+		AABoxClass bounds;
+		robj->Get_Obj_Space_Bounding_Box(bounds);
+		snap.FirstBoxExtent=bounds.Extent.X;
+		robj->Release_Ref();
+	}
+
+	AssetIterator * tit=The3DAssetManager.Create_HTree_Iterator();
+	for (tit->First();!tit->Is_Done();tit->Next()) {
+		HTreeClass * tree=The3DAssetManager.Get_HTree(tit->Current_Item_Name());
+		tree->Base_Update(Matrix3D(1));
+		snap.TreeHash=Hash_String(snap.TreeHash,tree->Get_Name());
+		for (int i=0;i<tree->Num_Pivots();i++) {
+			int parent=tree->Get_Parent_Index(i);
+			snap.TreeHash=Hash_String(snap.TreeHash,tree->Get_Bone_Name(i));
+			snap.TreeHash=Hash(snap.TreeHash,&parent,sizeof(parent));
+			snap.TreeHash=Hash(snap.TreeHash,&tree->Get_Transform(i),sizeof(Matrix3D));
+		}
+		snap.Trees++;
+	}
+	delete tit;
+}
+
+static void Compare(const AssetSnapshotStruct & a,const AssetSnapshotStruct & b,const char * what)
+{
+	char message[256];
+	sprintf(message,"%s: %d prototypes, expected %d",what,b.Prototypes,a.Prototypes);
+	Check(a.Prototypes==b.Prototypes,message);
+	sprintf(message,"%s: prototype names or order differ",what);
+	Check(a.PrototypeHash==b.PrototypeHash,message);
+	sprintf(message,"%s: HLOD definitions differ",what);
+	Check(a.HLodHash==b.HLodHash,message);
+	sprintf(message,"%s: %d hierarchy trees, expected %d",what,b.Trees,a.Trees);
+	Check(a.Trees==b.Trees,message);
+	sprintf(message,"%s: hierarchy trees differ",what);
+	Check(a.TreeHash==b.TreeHash,message);
+	sprintf(message,"%s: name collision resolved differently",what);
+	Check(a.FirstBox==b.FirstBox && a.FirstBoxExtent==b.FirstBoxExtent,message);
+}
+
+// ----------------------------------------------------------------------------
+
+static double Load_Serial(const char * const * files,int count)
+{
+	LARGE_INTEGER begin,end;
+	QueryPerformanceCounter(&begin);
+	for (int i=0;i<count;i++) {
+		Check(The3DAssetManager.Load_3D_Assets(files[i]),"serial: file didn't load");
+	}
+	QueryPerformanceCounter(&end);
+	return Seconds(begin,end);
+}
+
+static double Load_Async(const char * const * files,int count)
+{
+	LARGE_INTEGER begin,end;
+	QueryPerformanceCounter(&begin);
+	AssetLoadHandleClass * handle=The3DAssetManager.Load_3D_Assets_Async(files,count);
+	Check(handle->Get_File_Count()==count,"async: wrong file count");
+	Check(handle->Wait(),"async: a file didn't load");
+	Check(handle->Is_Ready(),"async: not ready after Wait");
+	Check(handle->Wait(),"async: second Wait");
+	delete handle;
+	QueryPerformanceCounter(&end);
+	return Seconds(begin,end);
+}
+
+static double Load_Batched(const char * const * files,int count)
+{
+	LARGE_INTEGER begin,end;
+	QueryPerformanceCounter(&begin);
+	Check(The3DAssetManager.Load_3D_Assets_Batched(files,count),"batched: a file didn't load");
+	QueryPerformanceCounter(&end);
+	return Seconds(begin,end);
+}
+
+static void Test_Missing_File(void)
+{
+	const char * files[2]={ "assetload_missing.w3d", NULL };
+	AssetLoadHandleClass * handle=The3DAssetManager.Load_3D_Assets_Async(files,1);
+	Check(!handle->Wait(),"missing: a file that doesn't exist loaded");
+	delete handle;
+
+	//
+	// Deleting a handle without waiting still adds the assets
+	//
+	files[0]="assetload000.w3d";
+	handle=The3DAssetManager.Load_3D_Assets_Async(files,1);
+	delete handle;
+	Check(The3DAssetManager.Render_Obj_Exists("HLOD0"),"unwaited: assets not added on delete");
+	The3DAssetManager.Free_Assets();
+}
+
+int main(int argc,char * argv[])
+{
+	MainThreadId=GetCurrentThreadId();
+	The3DAssetManager.Register_Prototype_Loader(&TestLoader);
+
+	SimpleDynVecClass<StringClass> names;
+	bool generated=(argc<2);
+	if (generated) {
+		for (int i=0;i<FILE_COUNT;i++) {
+			StringClass name;
+			name.Format("assetload%03d.w3d",i);
+			if (!Write_File(name,i)) {
+				printf("can't write %s\n",(const char *)name);
+				return 1;
+			}
+			names.Add(name);
+		}
+	} else {
+		for (int i=1;i<argc;i++) {
+			names.Add(StringClass(argv[i]));
+		}
+	}
+
+	SimpleVecClass<const char *> files(names.Count());
+	for (int i=0;i<names.Count();i++) {
+		files[i]=names[i];
+	}
+	int count=names.Count();
+
+	//
+	// The reference: one file at a time on this thread
+	//
+	AssetSnapshotStruct serial;
+	double serial_time=Load_Serial(&files[0],count);
+	Take_Snapshot(serial);
+	The3DAssetManager.Free_Assets();
+	printf("serial: %d files, %d prototypes, %d trees in %.2f ms\n",count,serial.Prototypes,serial.Trees,serial_time*1000.0);
+
+	if (generated) {
+		Check(serial.Prototypes==FILE_COUNT*(1+NULL_COUNT+NULL_COUNT/4+BOX_COUNT),"serial: wrong prototype count");
+		Check(serial.Trees==FILE_COUNT,"serial: wrong tree count");
+		Check(serial.FirstBox=="N0.BOX0" && serial.FirstBoxExtent==1.0f,"serial: later file won a name collision");
+	}
+
+	//
+	// Jobs run inline, then on the workers
+	//
+	WorkerPoolClass::Init(0);
+	AssetSnapshotStruct inline_snap;
+	double inline_time=Load_Async(&files[0],count);
+	Take_Snapshot(inline_snap);
+	The3DAssetManager.Free_Assets();
+	Compare(serial,inline_snap,"inline");
+	printf("async inline: %.2f ms\n",inline_time*1000.0);
+
+	WorkerPoolClass::Shutdown();
+	WorkerPoolClass::Init();
+	AssetSnapshotStruct parallel;
+	double parallel_time=Load_Async(&files[0],count);
+	Take_Snapshot(parallel);
+	The3DAssetManager.Free_Assets();
+	Compare(serial,parallel,"parallel");
+	printf("async on %d workers: %.2f ms (%.2fx)\n",WorkerPoolClass::Get_Thread_Count(),parallel_time*1000.0,
+		(parallel_time>0.0) ? serial_time/parallel_time : 0.0);
+
+	//
+	// The way the level load uses it, a batch at a time
+	//
+	AssetSnapshotStruct batched;
+	double batched_time=Load_Batched(&files[0],count);
+	Take_Snapshot(batched);
+	The3DAssetManager.Free_Assets();
+	Compare(serial,batched,"batched");
+	printf("batched on %d workers: %.2f ms (%.2fx)\n",WorkerPoolClass::Get_Thread_Count(),batched_time*1000.0,
+		(batched_time>0.0) ? serial_time/batched_time : 0.0);
+
+	if (generated) {
+		Test_Missing_File();
+	}
+	Check(OffMainThreadLoads==0,"a loader that isn't thread safe ran on a worker");
+
+	WorkerPoolClass::Shutdown();
+	if (generated) {
+		for (int i=0;i<count;i++) {
+			DeleteFile(files[i]);
+		}
+	}
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
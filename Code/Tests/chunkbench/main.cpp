@@ -0,0 +1,594 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Chunk Reader Benchmark                                       *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/chunkbench/main.cpp                    $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Loads every .w3d in a mix file with a copy of the old ChunkLoadClass, which went to the    *
+ * file for every Read, and with the current one, which reads each top level chunk into       *
+ * memory once. Every chunk is walked the way the mesh loaders do it, a vertex or triangle    *
+ * at a time, and the two must see the same bytes. The mix file can be given on the command   *
+ * line; without one, a mix of mesh-like files is generated. Also checks that bad child       *
+ * chunk sizes are refused, that truncated files fail cleanly, and that Read_Span agrees      *
+ * with Read.                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "chunkio.h"
+#include "mixfile.h"
+#include "ffactory.h"
+#include "ramfile.h"
+#include "wwstring.h"
+#include <windows.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	if (!ok) {
+		printf("%s FAILED\n",what);
+		Failures++;
+	}
+}
+
+enum {
+	FILE_COUNT=200,
+	PASSES=5,
+	ELEMENT_SIZE=12,					// a W3dVectorStruct
+
+	CHUNK_MESH=0x0000,
+	CHUNK_HEADER=0x001F,
+	CHUNK_VERTICES=0x0002,
+	CHUNK_NORMALS=0x0003,
+	CHUNK_TRIANGLES=0x0020,
+	CHUNK_MATERIALS=0x002B,
+	CHUNK_MATERIAL=0x002C,
+	CHUNK_MATERIAL_INFO=0x002D,	// holds micro chunks
+	CHUNK_PADDING=0x00FF
+};
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+// ----------------------------------------------------------------------------
+//
+// The old reader. Every header, Read and Seek went straight to the file, and
+// child chunk sizes were taken on trust.
+//
+// ----------------------------------------------------------------------------
+
+class LegacyChunkLoadClass
+{
+public:
+	LegacyChunkLoadClass(FileClass * file) : File(file), StackIndex(0), InMicroChunk(false), MicroChunkPosition(0)
+	{
+		memset(PositionStack,0,sizeof(PositionStack));
+		memset(HeaderStack,0,sizeof(HeaderStack));
+		memset(&MCHeader,0,sizeof(MCHeader));
+	}
+
+	bool Open_Chunk()
+	{
+		assert(InMicroChunk == false);
+		assert(StackIndex < MAX_STACK_DEPTH-1);
+		if ((StackIndex > 0) && (PositionStack[StackIndex-1] == HeaderStack[StackIndex-1].Get_Size())) {
+			return false;
+		}
+		if (File->Read(&HeaderStack[StackIndex],sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
+			return false;
+		}
+		PositionStack[StackIndex] = 0;
+		StackIndex++;
+		return true;
+	}
+
+	bool Close_Chunk()
+	{
+		assert(InMicroChunk == false);
+		assert(StackIndex > 0);
+		int csize = HeaderStack[StackIndex-1].Get_Size();
+		int pos = PositionStack[StackIndex-1];
+		if (pos < csize) {
+			File->Seek(csize - pos,SEEK_CUR);
+		}
+		StackIndex--;
+		if (StackIndex > 0) {
+			PositionStack[StackIndex - 1] += csize + sizeof(ChunkHeader);
+		}
+		return true;
+	}
+
+	uint32 Cur_Chunk_ID()			{ return HeaderStack[StackIndex-1].Get_Type(); }
+	uint32 Cur_Chunk_Length()		{ return HeaderStack[StackIndex-1].Get_Size(); }
+	int Contains_Chunks()			{ return HeaderStack[StackIndex-1].Get_Sub_Chunk_Flag(); }
+	uint32 Cur_Micro_Chunk_ID()	{ return MCHeader.Get_Type(); }
+	uint32 Cur_Micro_Chunk_Length()	{ return MCHeader.Get_Size(); }
+
+	bool Open_Micro_Chunk()
+	{
+		assert(!InMicroChunk);
+		if (Read(&MCHeader,sizeof(MCHeader)) != sizeof(MCHeader)) {
+			return false;
+		}
+		InMicroChunk = true;
+		MicroChunkPosition = 0;
+		return true;
+	}
+
+	bool Close_Micro_Chunk()
+	{
+		assert(InMicroChunk);
+		InMicroChunk = false;
+		int csize = MCHeader.Get_Size();
+		int pos = MicroChunkPosition;
+		if (pos < csize) {
+			File->Seek(csize - pos,SEEK_CUR);
+			if (StackIndex > 0) {
+				PositionStack[StackIndex-1] += csize - pos;
+			}
+		}
+		return true;
+	}
+
+	uint32 Read(void * buf,uint32 nbytes)
+	{
+		assert(StackIndex >= 1);
+		if (PositionStack[StackIndex-1] + nbytes > (int)HeaderStack[StackIndex-1].Get_Size()) {
+			return 0;
+		}
+		if (InMicroChunk && MicroChunkPosition + nbytes > MCHeader.Get_Size()) {
+			return 0;
+		}
+		if (File->Read(buf,nbytes) != (int)nbytes) {
+			return 0;
+		}
+		PositionStack[StackIndex-1] += nbytes;
+		if (InMicroChunk) {
+			MicroChunkPosition += nbytes;
+		}
+		return nbytes;
+	}
+
+private:
+	enum { MAX_STACK_DEPTH = 256 };
+
+	FileClass *			File;
+	int					StackIndex;
+	uint32				PositionStack[MAX_STACK_DEPTH];
+	ChunkHeader			HeaderStack[MAX_STACK_DEPTH];
+	bool					InMicroChunk;
+	int					MicroChunkPosition;
+	MicroChunkHeader	MCHeader;
+};
+
+// ----------------------------------------------------------------------------
+//
+// Walking the chunks. Everything seen goes into a hash that doesn't care how
+// the bytes were split between reads.
+//
+// ----------------------------------------------------------------------------
+
+static unsigned Hash_Bytes(unsigned hash,const void * data,unsigned size)
+{
+	const unsigned char * bytes=(const unsigned char *)data;
+	for (unsigned i=0;i<size;i++) {
+		hash=(hash^bytes[i])*16777619U;
+	}
+	return hash;
+}
+
+static unsigned Hash_Value(unsigned hash,unsigned value)
+{
+	return Hash_Bytes(hash,&value,sizeof(value));
+}
+
+template <class LOADER>
+static unsigned Walk_Elements(LOADER & cload,unsigned hash,unsigned length)
+{
+	unsigned char element[ELEMENT_SIZE];
+	while (length>=ELEMENT_SIZE) {
+		if (cload.Read(element,ELEMENT_SIZE)!=ELEMENT_SIZE) {
+			return Hash_Value(hash,0xDEAD);
+		}
+		hash=Hash_Bytes(hash,element,ELEMENT_SIZE);
+		length-=ELEMENT_SIZE;
+	}
+	if (length>0 && cload.Read(element,length)==length) {
+		hash=Hash_Bytes(hash,element,length);
+	}
+	return hash;
+}
+
+template <class LOADER>
+static unsigned Walk_Micro_Chunks(LOADER & cload,unsigned hash)
+{
+	while (cload.Open_Micro_Chunk()) {
+		hash=Hash_Value(hash,cload.Cur_Micro_Chunk_ID());
+		unsigned char value[256];
+		unsigned length=cload.Cur_Micro_Chunk_Length();
+		if (length<=sizeof(value) && cload.Read(value,length)==length) {
+			hash=Hash_Bytes(hash,value,length);
+		}
+		cload.Close_Micro_Chunk();
+	}
+	return hash;
+}
+
+template <class LOADER>
+static unsigned Walk_Chunks(LOADER & cload,unsigned hash)
+{
+	while (cload.Open_Chunk()) {
+		hash=Hash_Value(hash,cload.Cur_Chunk_ID());
+		hash=Hash_Value(hash,cload.Cur_Chunk_Length());
+		if (cload.Contains_Chunks()) {
+			hash=Walk_Chunks(cload,hash);
+		} else if (cload.Cur_Chunk_ID()==CHUNK_MATERIAL_INFO) {
+			hash=Walk_Micro_Chunks(cload,hash);
+		} else if (cload.Cur_Chunk_ID()!=CHUNK_PADDING) {
+			hash=Walk_Elements(cload,hash,cload.Cur_Chunk_Length());
+		}
+		cload.Close_Chunk();
+	}
+	return hash;
+}
+
+//
+// The same walk taking each array in one go with Read_Span.
+//
+static unsigned Walk_Chunks_Span(ChunkLoadClass & cload,unsigned hash)
+{
+	while (cload.Open_Chunk()) {
+		hash=Hash_Value(hash,cload.Cur_Chunk_ID());
+		hash=Hash_Value(hash,cload.Cur_Chunk_Length());
+		if (cload.Contains_Chunks()) {
+			hash=Walk_Chunks_Span(cload,hash);
+		} else if (cload.Cur_Chunk_ID()==CHUNK_MATERIAL_INFO) {
+			hash=Walk_Micro_Chunks(cload,hash);
+		} else if (cload.Cur_Chunk_ID()!=CHUNK_PADDING) {
+			unsigned length=cload.Cur_Chunk_Length();
+			const void * span=cload.Read_Span(length);
+			if (span!=NULL) {
+				hash=Hash_Bytes(hash,span,length);
+			} else {
+				hash=Walk_Elements(cload,hash,length);
+			}
+		}
+		cload.Close_Chunk();
+	}
+	return hash;
+}
+
+enum ReaderType {
+	READER_LEGACY,
+	READER_CURRENT,
+	READER_SPAN,
+	READER_COUNT
+};
+
+static const char * ReaderNames[READER_COUNT] = {
+	"old reader",
+	"new reader",
+	"new reader, Read_Span"
+};
+
+static unsigned Load_File(FileClass * file,ReaderType reader)
+{
+	unsigned hash=2166136261U;
+	if (reader==READER_LEGACY) {
+		LegacyChunkLoadClass cload(file);
+		hash=Walk_Chunks(cload,hash);
+	} else {
+		ChunkLoadClass cload(file);
+		hash=(reader==READER_SPAN) ? Walk_Chunks_Span(cload,hash) : Walk_Chunks(cload,hash);
+	}
+	return hash;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Generated meshes: a header, vertex, normal and triangle arrays, and a
+// material list whose info chunks hold micro chunks.
+//
+// ----------------------------------------------------------------------------
+
+static void Write_Array(ChunkSaveClass & csave,uint32 id,unsigned size,unsigned seed)
+{
+	csave.Begin_Chunk(id);
+	for (unsigned i=0;i<size;i+=4) {
+		unsigned value=(seed+i)*2654435761U;
+		csave.Write(&value,(size-i<4) ? size-i : 4);
+	}
+	csave.End_Chunk();
+}
+
+static void Write_Mesh(ChunkSaveClass & csave,int index)
+{
+	unsigned vertices=200+(index*7919)%3000;
+
+	csave.Begin_Chunk(CHUNK_MESH);
+	Write_Array(csave,CHUNK_HEADER,116,index);
+	Write_Array(csave,CHUNK_VERTICES,vertices*12,index+1);
+	Write_Array(csave,CHUNK_NORMALS,vertices*12,index+2);
+	Write_Array(csave,CHUNK_TRIANGLES,vertices*2*32,index+3);
+
+	csave.Begin_Chunk(CHUNK_MATERIALS);
+	for (int m=0;m<1+index%4;m++) {
+		csave.Begin_Chunk(CHUNK_MATERIAL);
+		csave.Begin_Chunk(CHUNK_MATERIAL_INFO);
+		for (int micro=0;micro<6;micro++) {
+			unsigned value=index*31+m*7+micro;
+			csave.Begin_Micro_Chunk(micro);
+			csave.Write(&value,sizeof(value));
+			csave.End_Micro_Chunk();
+		}
+		csave.End_Chunk();
+		Write_Array(csave,CHUNK_VERTICES,48,index+m);
+		csave.End_Chunk();
+	}
+	csave.End_Chunk();
+
+	Write_Array(csave,CHUNK_PADDING,1000,0);
+	csave.End_Chunk();
+}
+
+static bool Create_Mix(const char * filename)
+{
+	MixFileCreator mix(filename);
+	for (int i=0;i<FILE_COUNT;i++) {
+		RAMFileClass file(NULL,1024*1024);
+		file.Open(FileClass::WRITE);
+		ChunkSaveClass csave(&file);
+		Write_Mesh(csave,i);
+		Write_Mesh(csave,i+FILE_COUNT);		// a second mesh in the same file
+		file.Close();
+
+		file.Open(FileClass::READ);
+		char name[64];
+		sprintf(name,"mesh%03d.w3d",i);
+		mix.Add_File(name,&file);
+		file.Close();
+	}
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+
+static void Benchmark(const char * mix_filename,FileFactoryClass * factory,const char * factory_name)
+{
+	MixFileFactoryClass mix(mix_filename,factory);
+	Check(mix.Is_Valid(),"benchmark: can't open the mix file");
+	if (!mix.Is_Valid()) {
+		return;
+	}
+
+	DynamicVectorClass<StringClass> names;
+	mix.Build_Filename_List(names);
+	DynamicVectorClass<StringClass> w3d_names;
+	for (int i=0;i<names.Count();i++) {
+		int length=names[i].Get_Length();
+		if (length>4 && _stricmp((const char *)names[i]+length-4,".w3d")==0) {
+			w3d_names.Add(names[i]);
+		}
+	}
+
+	unsigned hashes[READER_COUNT];
+	double best[READER_COUNT];
+	unsigned total_bytes=0;
+	for (int reader=0;reader<READER_COUNT;reader++) {
+		best[reader]=1.0e9;
+		for (int pass=0;pass<PASSES;pass++) {
+			unsigned hash=0;
+			unsigned bytes=0;
+			LARGE_INTEGER begin,end;
+			QueryPerformanceCounter(&begin);
+			for (int i=0;i<w3d_names.Count();i++) {
+				FileClass * file=mix.Get_File(w3d_names[i]);
+				if (file==NULL) {
+					continue;
+				}
+				file->Open();
+				bytes+=file->Size();
+				hash=Hash_Value(hash,Load_File(file,ReaderType(reader)));
+				file->Close();
+				mix.Return_File(file);
+			}
+			QueryPerformanceCounter(&end);
+			double seconds=Seconds(begin,end);
+			if (seconds<best[reader]) {
+				best[reader]=seconds;
+			}
+			hashes[reader]=hash;
+			total_bytes=bytes;
+		}
+	}
+
+	printf("%s: %d .w3d files, %.1f MB\n",factory_name,w3d_names.Count(),double(total_bytes)/(1024.0*1024.0));
+	for (int reader=0;reader<READER_COUNT;reader++) {
+		printf("  %-24s %8.2f ms  %6.1f MB/s\n",ReaderNames[reader],best[reader]*1000.0,
+			double(total_bytes)/(1024.0*1024.0)/best[reader]);
+	}
+	Check(hashes[READER_CURRENT]==hashes[READER_LEGACY],"benchmark: new reader saw different data");
+	Check(hashes[READER_SPAN]==hashes[READER_LEGACY],"benchmark: Read_Span saw different data");
+}
+
+// ----------------------------------------------------------------------------
+
+static void Write_Header(unsigned char * & pos,uint32 id,uint32 size,bool sub_chunks)
+{
+	ChunkHeader header(id,size);
+	header.Set_Sub_Chunk_Flag(sub_chunks);
+	memcpy(pos,&header,sizeof(header));
+	pos+=sizeof(header);
+}
+
+static void Test_Bad_Child(void)
+{
+	//
+	// The first chunk's child claims 1000 bytes of a 24 byte parent. The
+	// second chunk is good and must still be found.
+	//
+	unsigned char data[256];
+	memset(data,0x5A,sizeof(data));
+	unsigned char * pos=data;
+	Write_Header(pos,1,24,true);
+	Write_Header(pos,2,1000,false);
+	pos+=16;
+	Write_Header(pos,3,4,false);
+	*(uint32 *)pos=0x12345678;
+	pos+=4;
+
+	RAMFileClass file(data,pos-data);
+	file.Open();
+	ChunkLoadClass cload(&file);
+
+	Check(cload.Open_Chunk() && cload.Cur_Chunk_ID()==1,"bad child: parent not opened");
+	Check(!cload.Open_Chunk(),"bad child: oversized child accepted");
+	Check(cload.Cur_Chunk_Depth()==1,"bad child: left in the child");
+	cload.Close_Chunk();
+
+	uint32 value=0;
+	Check(cload.Open_Chunk() && cload.Cur_Chunk_ID()==3,"bad child: next chunk lost");
+	Check(cload.Read(&value,4)==4 && value==0x12345678,"bad child: next chunk misread");
+	cload.Close_Chunk();
+	Check(!cload.Open_Chunk(),"bad child: read past the end");
+	file.Close();
+}
+
+static void Test_Truncated(void)
+{
+	//
+	// A chunk that says it is 100 bytes long in a file that ends after 20.
+	//
+	unsigned char data[64];
+	memset(data,0x11,sizeof(data));
+	unsigned char * pos=data;
+	Write_Header(pos,7,100,false);
+
+	RAMFileClass file(data,8+20);
+	file.Open();
+	ChunkLoadClass cload(&file);
+
+	unsigned char buffer[32];
+	Check(cload.Open_Chunk() && cload.Cur_Chunk_Length()==100,"truncated: chunk not opened");
+	Check(cload.Read(buffer,16)==16,"truncated: data that is there not read");
+	Check(cload.Read(buffer,16)==0,"truncated: read past the end of the file");
+	Check(cload.Read_Span(16)==NULL,"truncated: span past the end of the file");
+	Check(cload.Read(buffer,4)==4,"truncated: last bytes not read");
+	cload.Close_Chunk();
+	Check(!cload.Open_Chunk(),"truncated: chunk after the end of the file");
+	file.Close();
+}
+
+static void Test_Span(void)
+{
+	RAMFileClass file(NULL,1024*1024);
+	file.Open(FileClass::WRITE);
+	ChunkSaveClass csave(&file);
+	Write_Mesh(csave,1);
+	file.Close();
+
+	//
+	// Read_Span agrees with Read, stops at the end of the chunk, and its data
+	// lasts while other chunks are read.
+	//
+	file.Open();
+	ChunkLoadClass span_load(&file);
+	Check(span_load.Open_Chunk() && span_load.Open_Chunk(),"span: header chunk not opened");
+	uint32 length=span_load.Cur_Chunk_Length();
+	const unsigned char * header=(const unsigned char *)span_load.Read_Span(length);
+	Check(header!=NULL,"span: no span");
+	Check(span_load.Read_Span(1)==NULL,"span: span past the end of the chunk");
+	span_load.Close_Chunk();
+	Check(span_load.Open_Chunk() && span_load.Read_Span(12)!=NULL,"span: second chunk");
+	span_load.Close_Chunk();
+
+	file.Seek(0,SEEK_SET);
+	unsigned char copy[116];
+	{
+		ChunkLoadClass cload(&file);
+		cload.Open_Chunk();
+		cload.Open_Chunk();
+		Check(cload.Read(copy,length)==length,"span: read");
+		cload.Close_Chunk();
+		cload.Close_Chunk();
+	}
+	Check(length==sizeof(copy) && header!=NULL && memcmp(copy,header,length)==0,"span: span and read differ");
+	span_load.Close_Chunk();
+	file.Close();
+}
+
+static void Test_Large_Chunk(void)
+{
+	//
+	// Chunks too big to hold in memory are still read, straight from the file.
+	//
+	const unsigned size=17*1024*1024;
+	unsigned char * data=new unsigned char[size+8];
+	memset(data,0,size+8);
+	unsigned char * pos=data;
+	Write_Header(pos,9,size,false);
+	data[8+size-1]=0x77;
+
+	RAMFileClass file(data,size+8);
+	file.Open();
+	ChunkLoadClass cload(&file);
+	Check(cload.Open_Chunk(),"large: not opened");
+	Check(cload.Read_Span(4)==NULL,"large: span of a chunk that isn't in memory");
+	Check(cload.Seek(size-1)==size-1,"large: seek");
+	unsigned char last=0;
+	Check(cload.Read(&last,1)==1 && last==0x77,"large: read");
+	cload.Close_Chunk();
+	file.Close();
+	delete [] data;
+}
+
+int main(int argc,char * argv[])
+{
+	Test_Bad_Child();
+	Test_Truncated();
+	Test_Span();
+	Test_Large_Chunk();
+
+	const char * mix_filename="chunkbench.mix";
+	if (argc>1) {
+		mix_filename=argv[1];
+	} else {
+		Create_Mix(mix_filename);
+	}
+
+	RawFileFactoryClass raw_factory;
+	Benchmark(mix_filename,&raw_factory,"unbuffered files");
+	Benchmark(mix_filename,_TheFileFactory,"game file factory");
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,292 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : DXT Codec Test Program                                       *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/dxttest/main.cpp                       $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Compares the SSE2/AVX2 DXT kernels in DXTCodecClass against the scalar reference and      *
+ * checks the reference output of a synthetic test image against golden checksums.           *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "dxtcodec.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+const unsigned IMAGE_SIZE=64;
+const int FUZZ_BLOCK_COUNT=100000;
+
+static int Failures=0;
+
+static void Check(bool expr,const char* name)
+{
+	printf("%s: %s\n",name,expr ? "passed" : "FAILED");
+	if (!expr) Failures++;
+}
+
+static unsigned Random_State=12345;
+static unsigned Random(void)
+{
+	Random_State=Random_State*1664525+1013904223;
+	return Random_State>>8;
+}
+
+static unsigned Checksum(const void* data,unsigned size)
+{
+	// FNV-1a
+	const unsigned char* ptr=(const unsigned char*)data;
+	unsigned hash=2166136261u;
+	for (unsigned i=0;i<size;++i) {
+		hash^=ptr[i];
+		hash*=16777619u;
+	}
+	return hash;
+}
+
+// Smooth gradients with some noise, a few flat areas and an alpha ramp with a cut-out hole so that
+// every block mode (flat, 4-color, punch-through, 6 and 8 alpha) gets exercised.
+static void Create_Test_Image(unsigned* image)
+{
+	Random_State=12345;
+	for (unsigned y=0;y<IMAGE_SIZE;++y) {
+		for (unsigned x=0;x<IMAGE_SIZE;++x) {
+			unsigned r=x*4;
+			unsigned g=y*4;
+			unsigned b=(x+y)*2;
+			if (y>=48) {
+				r=g=b=0x80;
+			}
+			else if (x>=32) {
+				unsigned noise=Random()&0x1f;
+				r=(r+noise)&0xff;
+				g=(g+noise)&0xff;
+			}
+			unsigned a=255;
+			if (y<32) a=(x*255)/(IMAGE_SIZE-1);
+			int dx=int(x)-48;
+			int dy=int(y)-40;
+			if (dx*dx+dy*dy<36) a=0;
+			image[y*IMAGE_SIZE+x]=(a<<24)|(r<<16)|(g<<8)|b;
+		}
+	}
+}
+
+// Color PSNR of the visible (alpha>=128) pixels, the alpha of DXT1 is only 1 bit
+static double PSNR(const unsigned* a,const unsigned* b,unsigned count)
+{
+	double error=0.0;
+	unsigned samples=0;
+	for (unsigned i=0;i<count;++i) {
+		if ((a[i]>>24)<128) continue;
+		samples++;
+		for (int shift=0;shift<24;shift+=8) {
+			double d=double((a[i]>>shift)&0xff)-double((b[i]>>shift)&0xff);
+			error+=d*d;
+		}
+	}
+	if (error==0.0) return 100.0;
+	error/=samples*3;
+	return 10.0*log10(255.0*255.0/error);
+}
+
+static const char* Format_Name(WW3DFormat format)
+{
+	switch (format) {
+	case WW3D_FORMAT_DXT1: return "DXT1";
+	case WW3D_FORMAT_DXT2: return "DXT2";
+	case WW3D_FORMAT_DXT3: return "DXT3";
+	case WW3D_FORMAT_DXT4: return "DXT4";
+	case WW3D_FORMAT_DXT5: return "DXT5";
+	}
+	return "?";
+}
+
+static const char* Kernel_Name(DXTCodecClass::KernelType kernel)
+{
+	switch (kernel) {
+	case DXTCodecClass::KERNEL_SCALAR: return "scalar";
+	case DXTCodecClass::KERNEL_SSE2: return "SSE2";
+	case DXTCodecClass::KERNEL_AVX2: return "AVX2";
+	}
+	return "?";
+}
+
+// Golden checksums of the scalar reference encode of the test image and of its decoded result
+struct GoldenStruct
+{
+	WW3DFormat Format;
+	unsigned EncodedChecksum;
+	unsigned DecodedChecksum;
+	double MinPSNR;
+};
+
+static const GoldenStruct Golden[]={
+	{ WW3D_FORMAT_DXT1, 0xb467c26e, 0x33a55bcd, 30.0 },
+	{ WW3D_FORMAT_DXT3, 0xaa30093e, 0xb03139eb, 30.0 },
+	{ WW3D_FORMAT_DXT5, 0x193745a7, 0xd8533467, 30.0 },
+};
+
+static void Test_Golden_Image(void)
+{
+	static unsigned image[IMAGE_SIZE*IMAGE_SIZE];
+	static unsigned decoded_reference[IMAGE_SIZE*IMAGE_SIZE];
+	static unsigned decoded[IMAGE_SIZE*IMAGE_SIZE];
+	static unsigned char encoded_reference[IMAGE_SIZE*IMAGE_SIZE];
+	static unsigned char encoded[IMAGE_SIZE*IMAGE_SIZE];
+	char name[256];
+
+	Create_Test_Image(image);
+
+	for (unsigned g=0;g<sizeof(Golden)/sizeof(Golden[0]);++g) {
+		WW3DFormat format=Golden[g].Format;
+		unsigned size=DXTCodecClass::Get_Surface_Size(IMAGE_SIZE,IMAGE_SIZE,format);
+
+		DXTCodecClass::Set_Kernel(DXTCodecClass::KERNEL_SCALAR);
+		DXTCodecClass::Encode_Surface(encoded_reference,(const unsigned char*)image,IMAGE_SIZE*4,IMAGE_SIZE,IMAGE_SIZE,format);
+		DXTCodecClass::Decode_Surface((unsigned char*)decoded_reference,IMAGE_SIZE*4,encoded_reference,IMAGE_SIZE,IMAGE_SIZE,format);
+
+		unsigned encoded_checksum=Checksum(encoded_reference,size);
+		unsigned decoded_checksum=Checksum(decoded_reference,sizeof(decoded_reference));
+		double psnr=PSNR(image,decoded_reference,IMAGE_SIZE*IMAGE_SIZE);
+		printf("%s reference: encoded %08x decoded %08x PSNR %.2f dB\n",Format_Name(format),encoded_checksum,decoded_checksum,psnr);
+
+		sprintf(name,"%s golden encode",Format_Name(format));
+		Check(encoded_checksum==Golden[g].EncodedChecksum,name);
+		sprintf(name,"%s golden decode",Format_Name(format));
+		Check(decoded_checksum==Golden[g].DecodedChecksum,name);
+		sprintf(name,"%s quality",Format_Name(format));
+		Check(psnr>=Golden[g].MinPSNR,name);
+
+		for (int k=DXTCodecClass::KERNEL_SSE2;k<=DXTCodecClass::KERNEL_AVX2;++k) {
+			DXTCodecClass::Set_Kernel((DXTCodecClass::KernelType)k);
+			if (DXTCodecClass::Get_Kernel()!=k) {
+				printf("%s kernel not supported, skipped\n",Kernel_Name((DXTCodecClass::KernelType)k));
+				continue;
+			}
+
+			memset(encoded,0,sizeof(encoded));
+			DXTCodecClass::Encode_Surface(encoded,(const unsigned char*)image,IMAGE_SIZE*4,IMAGE_SIZE,IMAGE_SIZE,format);
+			sprintf(name,"%s %s encode matches reference",Format_Name(format),Kernel_Name((DXTCodecClass::KernelType)k));
+			Check(memcmp(encoded,encoded_reference,size)==0,name);
+
+			memset(decoded,0,sizeof(decoded));
+			DXTCodecClass::Decode_Surface((unsigned char*)decoded,IMAGE_SIZE*4,encoded_reference,IMAGE_SIZE,IMAGE_SIZE,format);
+			sprintf(name,"%s %s decode matches reference",Format_Name(format),Kernel_Name((DXTCodecClass::KernelType)k));
+			Check(memcmp(decoded,decoded_reference,sizeof(decoded))==0,name);
+		}
+	}
+}
+
+// Random block contents hit the mode switches (color0<=color1, alpha0<=alpha1) that an encoder never produces.
+static void Test_Random_Blocks(void)
+{
+	static const WW3DFormat formats[]={
+		WW3D_FORMAT_DXT1,WW3D_FORMAT_DXT2,WW3D_FORMAT_DXT3,WW3D_FORMAT_DXT4,WW3D_FORMAT_DXT5
+	};
+	char name[256];
+
+	for (unsigned f=0;f<sizeof(formats)/sizeof(formats[0]);++f) {
+		WW3DFormat format=formats[f];
+		unsigned block_size=DXTCodecClass::Get_Block_Size(format);
+		bool decode_ok=true;
+		bool encode_ok=true;
+		Random_State=f+1;
+
+		for (int i=0;i<FUZZ_BLOCK_COUNT && decode_ok && encode_ok;++i) {
+			unsigned char block[16];
+			for (unsigned b=0;b<block_size;++b) {
+				block[b]=(unsigned char)Random();
+			}
+			unsigned reference[16];
+			unsigned pixels[16];
+			DXTCodecClass::Set_Kernel(DXTCodecClass::KERNEL_SCALAR);
+			bool reference_alpha=DXTCodecClass::Decode_Block(reference,4,block,format);
+			DXTCodecClass::Set_Kernel(DXTCodecClass::KERNEL_BEST);
+			bool alpha=DXTCodecClass::Decode_Block(pixels,4,block,format);
+			decode_ok=(alpha==reference_alpha) && memcmp(pixels,reference,sizeof(pixels))==0;
+
+			// Re-encode the decoded pixels, including the random alpha
+			unsigned char reference_block[16];
+			unsigned char simd_block[16];
+			DXTCodecClass::Set_Kernel(DXTCodecClass::KERNEL_SCALAR);
+			DXTCodecClass::Encode_Block(reference_block,reference,4,format);
+			DXTCodecClass::Set_Kernel(DXTCodecClass::KERNEL_BEST);
+			DXTCodecClass::Encode_Block(simd_block,reference,4,format);
+			encode_ok=memcmp(reference_block,simd_block,block_size)==0;
+		}
+
+		sprintf(name,"%s random block decode, %s vs scalar",Format_Name(format),Kernel_Name(DXTCodecClass::Get_Kernel()));
+		Check(decode_ok,name);
+		sprintf(name,"%s random block encode, %s vs scalar",Format_Name(format),Kernel_Name(DXTCodecClass::Get_Kernel()));
+		Check(encode_ok,name);
+	}
+}
+
+// Surfaces that aren't a multiple of 4 or of the AVX2 block pair width
+static void Test_Odd_Sizes(void)
+{
+	static const unsigned sizes[][2]={ {1,1}, {2,2}, {4,4}, {12,8}, {20,6} };
+	static unsigned image[IMAGE_SIZE*IMAGE_SIZE];
+	unsigned char encoded[IMAGE_SIZE*IMAGE_SIZE];
+	unsigned reference[32*8];
+	unsigned decoded[32*8];
+	char name[256];
+
+	Create_Test_Image(image);
+
+	for (unsigned s=0;s<sizeof(sizes)/sizeof(sizes[0]);++s) {
+		unsigned w=sizes[s][0];
+		unsigned h=sizes[s][1];
+		DXTCodecClass::Set_Kernel(DXTCodecClass::KERNEL_SCALAR);
+		DXTCodecClass::Encode_Surface(encoded,(const unsigned char*)image,IMAGE_SIZE*4,w,h,WW3D_FORMAT_DXT5);
+		memset(reference,0xcd,sizeof(reference));
+		DXTCodecClass::Decode_Surface((unsigned char*)reference,32*4,encoded,w,h,WW3D_FORMAT_DXT5);
+		DXTCodecClass::Set_Kernel(DXTCodecClass::KERNEL_BEST);
+		memset(decoded,0xcd,sizeof(decoded));
+		DXTCodecClass::Decode_Surface((unsigned char*)decoded,32*4,encoded,w,h,WW3D_FORMAT_DXT5);
+
+		// Pixels outside the surface must not be touched
+		bool clipped=true;
+		for (unsigned y=0;y<8;++y) {
+			for (unsigned x=0;x<32;++x) {
+				if ((x>=w || y>=h) && reference[y*32+x]!=0xcdcdcdcd) clipped=false;
+			}
+		}
+		sprintf(name,"%dx%d decode clipped",w,h);
+		Check(clipped,name);
+		sprintf(name,"%dx%d decode matches reference",w,h);
+		Check(memcmp(reference,decoded,sizeof(decoded))==0,name);
+	}
+}
+
+int main(void)
+{
+	Test_Golden_Image();
+	Test_Random_Blocks();
+	Test_Odd_Sizes();
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Frame Arena Test                                             *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/framearena/main.cpp                    $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Exercises FrameArenaClass with a small block size so every test crosses block boundaries:  *
+ * rewinding to marks and scopes, the end of frame reset and its coalescing of a block chain, *
+ * the high water marks, and FrameArenaVectorClass and the STL allocator growing past the     *
+ * first block.                                                                                *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "framearena.h"
+#include <stdio.h>
+#include <vector>
+
+const int BLOCK_SIZE=4096;
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	printf("%-64s %s\n",what,ok ? "ok" : "FAILED");
+	if (!ok) {
+		Failures++;
+	}
+}
+
+static void Test_Alignment()
+{
+	FrameArenaClass arena(BLOCK_SIZE);
+	bool aligned=true;
+	for (int i=1;i<=64;++i) {
+		int alignment=(i%4==0) ? 16 : 8;
+		char* ptr=(char*)arena.Allocate(i,alignment);
+		aligned&=((size_t)ptr%alignment)==0;
+	}
+	Check(aligned,"allocations honour their alignment");
+}
+
+static void Test_Rewind()
+{
+	FrameArenaClass arena(BLOCK_SIZE);
+	arena.Allocate(100);
+
+	FrameArenaClass::MarkStruct mark=arena.Get_Mark();
+	int used=arena.Get_Used();
+	void* first=arena.Allocate(64);
+	arena.Rewind(mark);
+	Check(arena.Get_Used()==used,"rewind gives back the bytes allocated after the mark");
+	Check(arena.Allocate(64)==first,"allocation after a rewind re-uses the same memory");
+
+	/*
+	** Rewind across a block boundary, the chained block is kept for re-use
+	*/
+	arena.Rewind(mark);
+	for (int i=0;i<4;++i) {
+		arena.Allocate(BLOCK_SIZE/2);
+	}
+	int capacity=arena.Get_Capacity();
+	Check(capacity>BLOCK_SIZE,"allocating past the first block chains another");
+	arena.Rewind(mark);
+	Check(arena.Get_Used()==used,"rewind across blocks gives back the bytes");
+	for (int i=0;i<4;++i) {
+		arena.Allocate(BLOCK_SIZE/2);
+	}
+	Check(arena.Get_Capacity()==capacity,"re-allocating after a rewind re-uses the chained blocks");
+
+	/*
+	** Scopes
+	*/
+	arena.Rewind(mark);
+	{
+		FrameArenaScopeClass scope(&arena);
+		arena.Allocate(3*BLOCK_SIZE);
+	}
+	Check(arena.Get_Used()==used,"a scope rewinds when it ends");
+}
+
+static void Test_Reset()
+{
+	FrameArenaClass arena(BLOCK_SIZE);
+	unsigned generation=arena.Get_Generation();
+
+	/*
+	** Three allocations that don't fit together in one block
+	*/
+	for (int i=0;i<3;++i) {
+		arena.Allocate(BLOCK_SIZE*3/4);
+	}
+	int peak=arena.Get_Frame_High_Water_Mark();
+	Check(peak>=3*(BLOCK_SIZE*3/4),"frame high water mark covers the frame's allocations");
+	Check(arena.Get_Capacity()==3*BLOCK_SIZE,"each allocation got its own block");
+
+	arena.Reset();
+	Check(arena.Get_Generation()==generation+1,"reset starts a new generation");
+	Check(arena.Get_Used()==0,"reset releases everything");
+	Check(arena.Get_Frame_High_Water_Mark()==0,"reset clears the frame high water mark");
+	Check(arena.Get_Last_Frame_High_Water_Mark()==peak,"last frame high water mark is kept");
+	Check(arena.Get_High_Water_Mark()==peak,"overall high water mark is kept");
+
+	/*
+	** The chain was coalesced, the same frame now fits in the one block
+	*/
+	int capacity=arena.Get_Capacity();
+	Check(capacity>=3*BLOCK_SIZE,"reset coalesces the chain into a block as big as the frame");
+	char* first=(char*)arena.Allocate(BLOCK_SIZE*3/4);
+	char* last=NULL;
+	for (int i=0;i<2;++i) {
+		last=(char*)arena.Allocate(BLOCK_SIZE*3/4);
+	}
+	Check(arena.Get_Capacity()==capacity,"next frame needs no new blocks");
+	Check(last-first==2*(BLOCK_SIZE*3/4),"next frame is allocated contiguously");
+
+	/*
+	** A smaller frame leaves the overall peak alone
+	*/
+	arena.Reset();
+	arena.Allocate(16);
+	arena.Reset();
+	Check(arena.Get_Last_Frame_High_Water_Mark()==16,"last frame high water mark follows the frames");
+	Check(arena.Get_High_Water_Mark()==peak,"overall high water mark only grows");
+}
+
+static void Test_Vector()
+{
+	const int COUNT=5000;		// about five blocks of ints
+
+	FrameArenaClass arena(BLOCK_SIZE);
+	{
+		FrameArenaVectorClass<int> list(0,&arena);
+		for (int i=0;i<COUNT;++i) {
+			list.Add(i);
+		}
+
+		bool ok=(list.Count()==COUNT);
+		for (int i=0;ok && i<COUNT;++i) {
+			ok=(list[i]==i);
+		}
+		Check(ok,"FrameArenaVectorClass keeps its contents past the first block");
+		Check(arena.Get_Capacity()>BLOCK_SIZE,"FrameArenaVectorClass storage comes from the arena");
+	}
+
+	{
+		FrameArenaScopeClass scope(&arena);
+		std::vector<int,FrameArenaAllocatorClass<int> > list((FrameArenaAllocatorClass<int>(&arena)));
+		for (int i=0;i<COUNT;++i) {
+			list.push_back(i);
+		}
+
+		bool ok=(list.size()==COUNT);
+		for (int i=0;ok && i<COUNT;++i) {
+			ok=(list[i]==i);
+		}
+		Check(ok,"FrameArenaAllocatorClass vector keeps its contents");
+	}
+	arena.Reset();
+	Check(arena.Get_Used()==0,"reset after the vectors releases everything");
+}
+
+int main(void)
+{
+	Test_Alignment();
+	Test_Rewind();
+	Test_Reset();
+	Test_Vector();
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
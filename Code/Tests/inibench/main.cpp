@@ -0,0 +1,500 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : INI Benchmark                                                *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/inibench/main.cpp                      $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Times loading an INI database and reading typed values out of it against a copy of the    *
+ * old lookup path (a sorted IndexClass that is re-sorted after every insert, and sscanf on   *
+ * every Get_Int or Get_Float), and against reading whole sections with INIBindingClass.      *
+ * The INI files to use can be given on the command line; without any, a table of armor and  *
+ * weapon definitions like the game's is generated. Every value read is checked against the  *
+ * old conversion.                                                                             *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "ini.h"
+#include "inisup.h"
+#include "index.h"
+#include "rawfile.h"
+#include "xstraw.h"
+#include "wwstring.h"
+#include <windows.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+static int Failures=0;
+
+enum {
+	SECTION_COUNT=2000,
+	QUERY_PASSES=20
+};
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+// ----------------------------------------------------------------------------
+//
+// The old lookup path. Sections and entries were kept in an IndexClass, which
+// sorts lazily on the first lookup after an insert; Load checked for a
+// duplicate after every entry it added, so it sorted once per entry. Values
+// were converted from text on every call.
+//
+// ----------------------------------------------------------------------------
+
+class LegacyINIClass
+{
+public:
+	LegacyINIClass(INIClass & ini) : Sections(NULL), SectionCount(0)
+	{
+		List<INISection *> & list=ini.Get_Section_List();
+		for (INISection * section=list.First();section->Is_Valid();section=section->Next()) {
+			SectionCount++;
+		}
+		Sections=new IndexClass<int, INIEntry *>[SectionCount];
+
+		int index=0;
+		for (INISection * section=list.First();section->Is_Valid();section=section->Next()) {
+			SectionIndex.Add_Index(INIClass::CRC(section->Section),index);
+			SectionIndex.Is_Present(0);
+			for (INIEntry * entry=section->EntryList.First();entry->Is_Valid();entry=entry->Next()) {
+				Sections[index].Add_Index(entry->Index_ID(),entry);
+				Sections[index].Is_Present(0);
+			}
+			index++;
+		}
+	}
+	~LegacyINIClass() { delete[] Sections; }
+
+	INIEntry * Find_Entry(char const * section,char const * entry) const
+	{
+		int crc=INIClass::CRC(section);
+		if (!SectionIndex.Is_Present(crc)) {
+			return NULL;
+		}
+		IndexClass<int, INIEntry *> & entries=Sections[SectionIndex[crc]];
+		crc=CRC::String(entry);
+		if (!entries.Is_Present(crc)) {
+			return NULL;
+		}
+		return entries[crc];
+	}
+
+	int Get_Int(char const * section,char const * entry,int defvalue) const
+	{
+		INIEntry * entryptr=Find_Entry(section,entry);
+		if (entryptr && entryptr->Value != NULL) {
+			if (*entryptr->Value=='$') {
+				sscanf(entryptr->Value,"$%x",&defvalue);
+			} else {
+				if (tolower(entryptr->Value[strlen(entryptr->Value)-1])=='h') {
+					sscanf(entryptr->Value,"%xh",&defvalue);
+				} else {
+					defvalue=atoi(entryptr->Value);
+				}
+			}
+		}
+		return defvalue;
+	}
+
+	float Get_Float(char const * section,char const * entry,float defvalue) const
+	{
+		INIEntry * entryptr=Find_Entry(section,entry);
+		if (entryptr != NULL && entryptr->Value != NULL) {
+			float val=defvalue;
+			sscanf(entryptr->Value,"%f",&val);
+			defvalue=val;
+			if (strchr(entryptr->Value,'%') != NULL) {
+				defvalue/=100.0f;
+			}
+		}
+		return defvalue;
+	}
+
+	bool Get_Bool(char const * section,char const * entry,bool defvalue) const
+	{
+		INIEntry * entryptr=Find_Entry(section,entry);
+		if (entryptr && entryptr->Value != NULL) {
+			switch (toupper(*entryptr->Value)) {
+				case 'Y':
+				case 'T':
+				case '1':
+					return true;
+
+				case 'N':
+				case 'F':
+				case '0':
+					return false;
+			}
+		}
+		return defvalue;
+	}
+
+	const char * Get_String(char const * section,char const * entry,const char * defvalue) const
+	{
+		INIEntry * entryptr=Find_Entry(section,entry);
+		return (entryptr && entryptr->Value != NULL) ? entryptr->Value : defvalue;
+	}
+
+private:
+	mutable IndexClass<int, int> SectionIndex;
+	mutable IndexClass<int, INIEntry *> * Sections;
+	int SectionCount;
+};
+
+// ----------------------------------------------------------------------------
+//
+// A definition like the ones the game reads from its INI tables.
+//
+// ----------------------------------------------------------------------------
+
+struct DefinitionStruct
+{
+	int			Cost;
+	int			Color;
+	int			Flags;
+	float			Speed;
+	float			Range;
+	float			Damage;
+	float			Scale;
+	bool			Stealth;
+	bool			Repairable;
+	StringClass	Model;
+	StringClass	Sound;
+};
+
+static void Read_Legacy(const LegacyINIClass & ini,const char * section,DefinitionStruct & def)
+{
+	def.Cost=ini.Get_Int(section,"Cost",def.Cost);
+	def.Color=ini.Get_Int(section,"Color",def.Color);
+	def.Flags=ini.Get_Int(section,"Flags",def.Flags);
+	def.Speed=ini.Get_Float(section,"Speed",def.Speed);
+	def.Range=ini.Get_Float(section,"Range",def.Range);
+	def.Damage=ini.Get_Float(section,"Damage",def.Damage);
+	def.Scale=ini.Get_Float(section,"Scale",def.Scale);
+	def.Stealth=ini.Get_Bool(section,"Stealth",def.Stealth);
+	def.Repairable=ini.Get_Bool(section,"Repairable",def.Repairable);
+	def.Model=ini.Get_String(section,"Model",def.Model);
+	def.Sound=ini.Get_String(section,"Sound",def.Sound);
+}
+
+static void Read_INI(const INIClass & ini,const char * section,DefinitionStruct & def)
+{
+	def.Cost=ini.Get_Int(section,"Cost",def.Cost);
+	def.Color=ini.Get_Int(section,"Color",def.Color);
+	def.Flags=ini.Get_Int(section,"Flags",def.Flags);
+	def.Speed=ini.Get_Float(section,"Speed",def.Speed);
+	def.Range=ini.Get_Float(section,"Range",def.Range);
+	def.Damage=ini.Get_Float(section,"Damage",def.Damage);
+	def.Scale=ini.Get_Float(section,"Scale",def.Scale);
+	def.Stealth=ini.Get_Bool(section,"Stealth",def.Stealth);
+	def.Repairable=ini.Get_Bool(section,"Repairable",def.Repairable);
+	ini.Get_String(def.Model,section,"Model",def.Model);
+	ini.Get_String(def.Sound,section,"Sound",def.Sound);
+}
+
+static void Set_Defaults(DefinitionStruct & def)
+{
+	def.Cost=-1;
+	def.Color=-1;
+	def.Flags=-1;
+	def.Speed=-1.0f;
+	def.Range=-1.0f;
+	def.Damage=-1.0f;
+	def.Scale=-1.0f;
+	def.Stealth=false;
+	def.Repairable=false;
+	def.Model="none";
+	def.Sound="none";
+}
+
+static bool Same(const DefinitionStruct & a,const DefinitionStruct & b)
+{
+	return a.Cost==b.Cost && a.Color==b.Color && a.Flags==b.Flags &&
+		a.Speed==b.Speed && a.Range==b.Range && a.Damage==b.Damage && a.Scale==b.Scale &&
+		a.Stealth==b.Stealth && a.Repairable==b.Repairable &&
+		a.Model==b.Model && a.Sound==b.Sound;
+}
+
+static char * Make_Table(int & length)
+{
+	static const char * bools[]={ "yes", "no", "true", "false", "1", "0" };
+	int size=SECTION_COUNT*400;
+	char * text=new char[size];
+	length=0;
+	length+=sprintf(text+length,"; Generated definitions\n\n");
+	for (int i=0;i<SECTION_COUNT;i++) {
+		length+=sprintf(text+length,"[%s_%04d]\n",(i&1) ? "Weapon" : "Armor",i);
+		length+=sprintf(text+length,"Cost=%d\n",i*25);
+		length+=sprintf(text+length,"Color=%s\n",(i%3==0) ? "$FF8040" : ((i%3==1) ? "1A2Bh" : "255"));
+		length+=sprintf(text+length,"Flags=%d\n",i&15);
+		length+=sprintf(text+length,"Speed=%.3f\n",i*0.125f);
+		length+=sprintf(text+length,"Range=%d.5\n",i%200);
+		length+=sprintf(text+length,"Damage=%d%%\n",i%150);
+		if (i%5) {
+			length+=sprintf(text+length,"Scale=%.2f ; tuned\n",1.0f+(i%7)*0.25f);
+		}
+		length+=sprintf(text+length,"Stealth=%s\n",bools[i%6]);
+		if (i%4) {
+			length+=sprintf(text+length,"Repairable=%s\n",bools[(i/3)%6]);
+		}
+		length+=sprintf(text+length,"Model=%s_%04d.w3d\n",(i&1) ? "w_gun" : "v_tank",i);
+		length+=sprintf(text+length,"Sound=sfx_%d\n\n",i%64);
+	}
+	return text;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Every entry of a loaded INI read through both paths as an int, a float and
+// a bool.
+//
+// ----------------------------------------------------------------------------
+
+static void Check_All_Entries(INIClass & ini,const LegacyINIClass & legacy,const char * name)
+{
+	int entries=0;
+	List<INISection *> & list=ini.Get_Section_List();
+	for (INISection * section=list.First();section->Is_Valid();section=section->Next()) {
+		for (INIEntry * entry=section->EntryList.First();entry->Is_Valid();entry=entry->Next()) {
+			const char * sec=section->Section;
+			const char * ent=entry->Entry;
+			float a=legacy.Get_Float(sec,ent,-7.0f);
+			float b=ini.Get_Float(sec,ent,-7.0f);
+			if (legacy.Get_Int(sec,ent,-7)!=ini.Get_Int(sec,ent,-7) ||
+					(a!=b && !(a!=a && b!=b)) ||
+					legacy.Get_Bool(sec,ent,true)!=ini.Get_Bool(sec,ent,true) ||
+					legacy.Get_Bool(sec,ent,false)!=ini.Get_Bool(sec,ent,false)) {
+				printf("%s [%s] %s=%s converts differently FAILED\n",name,sec,ent,entry->Value);
+				Failures++;
+				return;
+			}
+			entries++;
+		}
+	}
+	printf("%s: %d sections, %d entries checked\n",name,ini.Section_Count(),entries);
+}
+
+static void Time_Entries(INIClass & ini,const LegacyINIClass & legacy)
+{
+	LARGE_INTEGER t0,t1,t2;
+	int queries=0;
+	int legacy_sum=0;
+	int new_sum=0;
+	List<INISection *> & list=ini.Get_Section_List();
+
+	QueryPerformanceCounter(&t0);
+	for (int pass=0;pass<QUERY_PASSES;pass++) {
+		for (INISection * section=list.First();section->Is_Valid();section=section->Next()) {
+			for (INIEntry * entry=section->EntryList.First();entry->Is_Valid();entry=entry->Next()) {
+				legacy_sum+=legacy.Get_Int(section->Section,entry->Entry,0);
+				legacy_sum+=(int)legacy.Get_Float(section->Section,entry->Entry,0.0f);
+				queries+=2;
+			}
+		}
+	}
+	QueryPerformanceCounter(&t1);
+	for (int pass=0;pass<QUERY_PASSES;pass++) {
+		for (INISection * section=list.First();section->Is_Valid();section=section->Next()) {
+			for (INIEntry * entry=section->EntryList.First();entry->Is_Valid();entry=entry->Next()) {
+				new_sum+=ini.Get_Int(section->Section,entry->Entry,0);
+				new_sum+=(int)ini.Get_Float(section->Section,entry->Entry,0.0f);
+			}
+		}
+	}
+	QueryPerformanceCounter(&t2);
+
+	if (legacy_sum!=new_sum) {
+		printf("query results differ FAILED\n");
+		Failures++;
+	}
+	printf("  %d Get_Int/Get_Float queries. Million per second:\n",queries);
+	printf("    old (IndexClass, sscanf)   %8.2f\n",queries/Seconds(t0,t1)/1000000.0);
+	printf("    INIClass                   %8.2f\n",queries/Seconds(t1,t2)/1000000.0);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Load, old index build and lookups on one INI image.
+//
+// ----------------------------------------------------------------------------
+
+static void Time_Load(const char * text,int length,INIClass & ini,LegacyINIClass *& legacy)
+{
+	LARGE_INTEGER t0,t1,t2;
+
+	QueryPerformanceCounter(&t0);
+	BufferStraw straw(text,length);
+	ini.Load(straw);
+	QueryPerformanceCounter(&t1);
+	legacy=new LegacyINIClass(ini);
+	QueryPerformanceCounter(&t2);
+
+	printf("  load                       %8.2f ms\n",Seconds(t0,t1)*1000.0);
+	printf("  old index build            %8.2f ms (was paid on top of the load)\n",Seconds(t1,t2)*1000.0);
+}
+
+static void Generated_Table(void)
+{
+	int length;
+	char * text=Make_Table(length);
+	printf("Generated table, %d bytes:\n",length);
+
+	INIClass ini;
+	LegacyINIClass * legacy=NULL;
+	Time_Load(text,length,ini,legacy);
+	Check_All_Entries(ini,*legacy,"generated");
+	Time_Entries(ini,*legacy);
+
+	// Whole definitions, by name through Get_ and through a binding
+	INIBindingClass binding;
+	binding.Bind_Int("Cost",offsetof(DefinitionStruct,Cost));
+	binding.Bind_Int("Color",offsetof(DefinitionStruct,Color));
+	binding.Bind_Int("Flags",offsetof(DefinitionStruct,Flags));
+	binding.Bind_Float("Speed",offsetof(DefinitionStruct,Speed));
+	binding.Bind_Float("Range",offsetof(DefinitionStruct,Range));
+	binding.Bind_Float("Damage",offsetof(DefinitionStruct,Damage));
+	binding.Bind_Float("Scale",offsetof(DefinitionStruct,Scale));
+	binding.Bind_Bool("Stealth",offsetof(DefinitionStruct,Stealth));
+	binding.Bind_Bool("Repairable",offsetof(DefinitionStruct,Repairable));
+	binding.Bind_String("Model",offsetof(DefinitionStruct,Model));
+	binding.Bind_String("Sound",offsetof(DefinitionStruct,Sound));
+
+	char (*names)[32]=new char[SECTION_COUNT][32];
+	for (int i=0;i<SECTION_COUNT;i++) {
+		sprintf(names[i],"%s_%04d",(i&1) ? "Weapon" : "Armor",i);
+	}
+
+	DefinitionStruct * legacy_defs=new DefinitionStruct[SECTION_COUNT];
+	DefinitionStruct * ini_defs=new DefinitionStruct[SECTION_COUNT];
+	DefinitionStruct * bound_defs=new DefinitionStruct[SECTION_COUNT];
+
+	LARGE_INTEGER t0,t1,t2,t3;
+	QueryPerformanceCounter(&t0);
+	for (int pass=0;pass<QUERY_PASSES;pass++) {
+		for (int i=0;i<SECTION_COUNT;i++) {
+			Set_Defaults(legacy_defs[i]);
+			Read_Legacy(*legacy,names[i],legacy_defs[i]);
+		}
+	}
+	QueryPerformanceCounter(&t1);
+	for (int pass=0;pass<QUERY_PASSES;pass++) {
+		for (int i=0;i<SECTION_COUNT;i++) {
+			Set_Defaults(ini_defs[i]);
+			Read_INI(ini,names[i],ini_defs[i]);
+		}
+	}
+	QueryPerformanceCounter(&t2);
+	for (int pass=0;pass<QUERY_PASSES;pass++) {
+		for (int i=0;i<SECTION_COUNT;i++) {
+			Set_Defaults(bound_defs[i]);
+			binding.Read(ini,names[i],&bound_defs[i]);
+		}
+	}
+	QueryPerformanceCounter(&t3);
+
+	for (int i=0;i<SECTION_COUNT;i++) {
+		if (!Same(legacy_defs[i],ini_defs[i]) || !Same(legacy_defs[i],bound_defs[i])) {
+			printf("definition %s differs FAILED\n",names[i]);
+			Failures++;
+			break;
+		}
+	}
+
+	int reads=SECTION_COUNT*QUERY_PASSES;
+	printf("  %d definitions of %d fields read. Thousand per second:\n",reads,binding.Binding_Count());
+	printf("    old (IndexClass, sscanf)   %8.2f\n",reads/Seconds(t0,t1)/1000.0);
+	printf("    INIClass Get_              %8.2f\n",reads/Seconds(t1,t2)/1000.0);
+	printf("    INIBindingClass::Read      %8.2f\n",reads/Seconds(t2,t3)/1000.0);
+
+	// Writing an entry must replace its converted values
+	ini.Put_Int(names[0],"Cost",1234);
+	ini.Put_String(names[0],"Damage","50%");
+	ini.Put_String(names[0],"Stealth","yes");
+	DefinitionStruct def;
+	Set_Defaults(def);
+	binding.Read(ini,names[0],&def);
+	if (def.Cost!=1234 || def.Damage!=0.5f || !def.Stealth || ini.Get_Int(names[0],"Cost",0)!=1234) {
+		printf("values after Put_ FAILED\n");
+		Failures++;
+	}
+
+	// Write a definition back out and read it into a fresh database
+	INIClass copy;
+	binding.Write(copy,"Copy",&bound_defs[7]);
+	Set_Defaults(def);
+	if (binding.Read(copy,"Copy",&def)!=binding.Binding_Count() || !Same(def,bound_defs[7])) {
+		printf("binding round trip FAILED\n");
+		Failures++;
+	}
+
+	delete[] bound_defs;
+	delete[] ini_defs;
+	delete[] legacy_defs;
+	delete[] names;
+	delete legacy;
+	delete[] text;
+}
+
+static void INI_File(const char * filename)
+{
+	RawFileClass file(filename);
+	int length=file.Size();
+	if (length<=0 || !file.Open()) {
+		printf("can't read %s FAILED\n",filename);
+		Failures++;
+		return;
+	}
+	char * text=new char[length];
+	file.Read(text,length);
+	file.Close();
+
+	printf("\n%s, %d bytes:\n",filename,length);
+	INIClass ini;
+	LegacyINIClass * legacy=NULL;
+	Time_Load(text,length,ini,legacy);
+	Check_All_Entries(ini,*legacy,filename);
+	Time_Entries(ini,*legacy);
+
+	delete legacy;
+	delete[] text;
+}
+
+int main(int argc,char * argv[])
+{
+	Generated_Table();
+	for (int i=1;i<argc;i++) {
+		INI_File(argv[i]);
+	}
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Light Probe Test                                             *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/lightprobe/main.cpp                    $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Bakes a LightProbeGridClass with a wall through the middle of it: the probes on one side    *
+ * see a light, the probes on the other side are in a different vis sector and don't. An      *
+ * object between them must only be lit by the probes on its own side of the wall, and an     *
+ * object whose vis sector has no probes must fall back to collecting the lights itself.      *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "lightprobegrid.h"
+#include "lightenvironment.h"
+#include "wwmath.h"
+#include <stdio.h>
+
+const float SPACING=10.0f;
+const float WALL_X=5.0f;
+const uint32 LIT_SECTOR=1;
+const uint32 DARK_SECTOR=2;
+const uint32 EMPTY_SECTOR=3;
+const float TOLERANCE=0.02f;
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	printf("%-60s %s\n",what,ok ? "ok" : "FAILED");
+	if (!ok) {
+		Failures++;
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// Bake the grid. The light shines along -x and only reaches the probes in
+// front of the wall.
+//
+// ----------------------------------------------------------------------------
+
+static void Bake(LightProbeGridClass & grid)
+{
+	grid.Init(Vector3(0,0,0),Vector3(SPACING,SPACING,SPACING),SPACING);
+
+	for (int i=0;i<grid.Get_Probe_Count();++i) {
+		Vector3 pos=grid.Get_Probe_Position(i);
+
+		LightEnvironmentClass env;
+		env.Reset(pos,Vector3(0,0,0));
+		if (pos.X<WALL_X) {
+			env.Add_Directional_Light(Vector3(1,0,0),Vector3(1,1,1));
+			grid.Set_Probe(i,env,LIT_SECTOR);
+		} else {
+			grid.Set_Probe(i,env,DARK_SECTOR);
+		}
+	}
+}
+
+static float Light_At(const LightProbeGridClass & grid,const LightProbeGridClass::SampleStruct & sample)
+{
+	LightEnvironmentClass env;
+	env.Reset(Vector3(0,0,0),Vector3(0,0,0));
+	grid.Apply(sample,&env);
+
+	float total=env.Get_Equivalent_Ambient().X;
+	for (int i=0;i<env.Get_Light_Count();++i) {
+		total+=env.Get_Light_Diffuse(i).X;
+	}
+	return total;
+}
+
+int main(void)
+{
+	LightProbeGridClass grid;
+	Bake(grid);
+
+	const Vector3 point(WALL_X,WALL_X,WALL_X);
+	LightProbeGridClass::SampleStruct all;
+	Check(grid.Find_Probes(point,&all),"point between the probes is inside the grid");
+
+	/*
+	** Without vis the light leaks halfway through the wall
+	*/
+	float leaked=Light_At(grid,all);
+	Check(WWMath::Fabs(leaked-0.5f)<TOLERANCE,"unfiltered probes blend the light through the wall");
+
+	/*
+	** Behind the wall the light is occluded
+	*/
+	LightProbeGridClass::SampleStruct dark=all;
+	Check(grid.Select_Probes(&dark,DARK_SECTOR),"dark side has probes");
+	Check(Light_At(grid,dark)<TOLERANCE,"occluded light does not reach the dark side");
+
+	/*
+	** In front of the wall it gets the whole light
+	*/
+	LightProbeGridClass::SampleStruct lit=all;
+	Check(grid.Select_Probes(&lit,LIT_SECTOR),"lit side has probes");
+	Check(WWMath::Fabs(Light_At(grid,lit)-1.0f)<TOLERANCE,"lit side gets the full light");
+
+	/*
+	** No probes in the object's sector
+	*/
+	LightProbeGridClass::SampleStruct empty=all;
+	Check(!grid.Select_Probes(&empty,EMPTY_SECTOR),"sector without probes falls back to the lights");
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,330 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Name and String Benchmark                                    *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/namebench/main.cpp                     $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Times looking assets up by name the way the asset manager used to (CRC_Stringi and         *
+ * stricmp down the hash chain) against interned NameClass lookups, and times the string     *
+ * churn of a level load (short names copied and appended) on 1, 4 and 16 threads           *
+ * against a heap copy per string, which is what StringClass used to do for every non-empty  *
+ * string.                                                                                     *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "nametable.h"
+#include "wwstring.h"
+#include "realcrc.h"
+#include "thread.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int Failures=0;
+
+enum {
+	ASSET_COUNT=20000,
+	LOOKUP_COUNT=2000000,
+	HASH_TABLE_SIZE=4096,
+	HASH_MASK=HASH_TABLE_SIZE-1,
+	MAX_THREADS=16,
+	STRINGS_PER_THREAD=200000
+};
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+// ----------------------------------------------------------------------------
+//
+// A prototype table like WW3DAssetManager's, keyed both ways.
+//
+// ----------------------------------------------------------------------------
+
+struct AssetStruct
+{
+	char				Name[32];
+	NameClass		HashName;
+	AssetStruct *	NextHash;
+	AssetStruct *	NextName;
+};
+
+static AssetStruct *	Assets;
+static AssetStruct *	CrcTable[HASH_TABLE_SIZE];
+static AssetStruct *	NameTable[HASH_TABLE_SIZE];
+
+static AssetStruct * Find_Crc(const char * name)
+{
+	int hash=CRC_Stringi(name) & HASH_MASK;
+	for (AssetStruct * test=CrcTable[hash];test!=NULL;test=test->NextHash) {
+		if (stricmp(test->Name,name)==0) {
+			return test;
+		}
+	}
+	return NULL;
+}
+
+static AssetStruct * Find_Name(const char * name)
+{
+	NameClass key=NameClass::Find(name);
+	if (key.Is_Empty()) {
+		return NULL;
+	}
+	for (AssetStruct * test=NameTable[key.Get_Hash() & HASH_MASK];test!=NULL;test=test->NextName) {
+		if (test->HashName==key) {
+			return test;
+		}
+	}
+	return NULL;
+}
+
+static void Asset_Lookups(void)
+{
+	static const char * prefixes[]={ "W_", "C_", "V_", "P_", "DSP_", "MG_", "LVL_" };
+	static const char * suffixes[]={ "", ".W3D", "_SKIN", "_LOD1", ".TGA" };
+
+	Assets=new AssetStruct[ASSET_COUNT];
+	for (int i=0;i<ASSET_COUNT;i++) {
+		AssetStruct & asset=Assets[i];
+		sprintf(asset.Name,"%sASSET_%05d%s",prefixes[i%7],i,suffixes[(i/7)%5]);
+		asset.HashName=NameClass(asset.Name);
+
+		int hash=CRC_Stringi(asset.Name) & HASH_MASK;
+		asset.NextHash=CrcTable[hash];
+		CrcTable[hash]=&asset;
+
+		hash=asset.HashName.Get_Hash() & HASH_MASK;
+		asset.NextName=NameTable[hash];
+		NameTable[hash]=&asset;
+	}
+
+	// Queries in the lower case the game data mostly uses, one in eight missing
+	char (*queries)[32]=new char[LOOKUP_COUNT][32];
+	unsigned random=1;
+	for (int i=0;i<LOOKUP_COUNT;i++) {
+		random=random*1664525+1013904223;
+		int index=(random>>8)%ASSET_COUNT;
+		if ((i&7)==7) {
+			sprintf(queries[i],"missing_%05d.w3d",index);
+		} else {
+			strcpy(queries[i],Assets[index].Name);
+			strlwr(queries[i]);
+		}
+	}
+
+	LARGE_INTEGER t0,t1,t2;
+	int crc_found=0;
+	int name_found=0;
+
+	QueryPerformanceCounter(&t0);
+	for (int i=0;i<LOOKUP_COUNT;i++) {
+		crc_found+=(Find_Crc(queries[i])!=NULL);
+	}
+	QueryPerformanceCounter(&t1);
+	for (int i=0;i<LOOKUP_COUNT;i++) {
+		name_found+=(Find_Name(queries[i])!=NULL);
+	}
+	QueryPerformanceCounter(&t2);
+
+	for (int i=0;i<LOOKUP_COUNT;i+=97) {
+		if (Find_Crc(queries[i])!=Find_Name(queries[i])) {
+			printf("lookup of %s differs FAILED\n",queries[i]);
+			Failures++;
+			break;
+		}
+	}
+	if (crc_found!=name_found) {
+		printf("found %d vs %d FAILED\n",crc_found,name_found);
+		Failures++;
+	}
+
+	printf("%d assets, %d lookups (%d found). Million lookups per second:\n\n",ASSET_COUNT,LOOKUP_COUNT,name_found);
+	printf("  CRC_Stringi + stricmp  %8.2f\n",LOOKUP_COUNT/Seconds(t0,t1)/1000000.0);
+	printf("  NameClass::Find        %8.2f\n",LOOKUP_COUNT/Seconds(t1,t2)/1000000.0);
+
+	// With the names already interned (what callers holding a NameClass pay)
+	NameClass * keys=new NameClass[LOOKUP_COUNT/8];
+	int key_expected=0;
+	for (int i=0;i<LOOKUP_COUNT/8;i++) {
+		keys[i]=NameClass::Find(queries[i]);
+		key_expected+=8*(Find_Crc(queries[i])!=NULL);
+	}
+	int key_found=0;
+	QueryPerformanceCounter(&t0);
+	for (int pass=0;pass<8;pass++) {
+		for (int i=0;i<LOOKUP_COUNT/8;i++) {
+			const NameClass & key=keys[i];
+			if (!key.Is_Empty()) {
+				for (AssetStruct * test=NameTable[key.Get_Hash() & HASH_MASK];test!=NULL;test=test->NextName) {
+					if (test->HashName==key) {
+						key_found++;
+						break;
+					}
+				}
+			}
+		}
+	}
+	QueryPerformanceCounter(&t1);
+	printf("  interned NameClass     %8.2f\n",LOOKUP_COUNT/Seconds(t0,t1)/1000000.0);
+	if (key_found!=key_expected) {
+		printf("interned lookups found %d of %d FAILED\n",key_found,key_expected);
+		Failures++;
+	}
+	printf("\n%d names interned, %d bytes\n\n",NameClass::Get_Name_Count(),NameClass::Get_Memory_Used());
+
+	delete[] keys;
+	delete[] queries;
+	delete[] Assets;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Level load string churn. Each thread copies definition and asset names
+// into a list and appends extensions, like the definition and asset loaders
+// do.
+//
+// ----------------------------------------------------------------------------
+
+class ChurnThreadClass : public ThreadClass
+{
+public:
+	ChurnThreadClass() : Index(0), UseStringClass(true), Errors(0), StartFlag(NULL) {}
+
+	int Index;
+	bool UseStringClass;
+	int Errors;
+	volatile bool* StartFlag;
+
+protected:
+	void Thread_Function()
+	{
+		while (!*StartFlag) {
+			Switch_Thread();
+		}
+
+		enum { LIST_SIZE=64, POOL_SIZE=1024 };
+		static char pool[MAX_THREADS][POOL_SIZE][16];
+		for (int i=0;i<POOL_SIZE;i++) {
+			sprintf(pool[Index][i],"obj%d_%d",Index,i);
+		}
+
+		if (UseStringClass) {
+			StringClass list[LIST_SIZE];
+			for (int i=0;i<STRINGS_PER_THREAD;i++) {
+				StringClass name(pool[Index][i&(POOL_SIZE-1)]);
+				StringClass & copy=list[i&(LIST_SIZE-1)];
+				copy=name;
+				copy+=".w3d";
+				if (copy[0]!='o') {
+					Errors++;
+				}
+			}
+		} else {
+			char * list[LIST_SIZE]={ NULL };
+			for (int i=0;i<STRINGS_PER_THREAD;i++) {
+				const char * source=pool[Index][i&(POOL_SIZE-1)];
+				char * name=new char[strlen(source)+1];
+				strcpy(name,source);
+				char *& copy=list[i&(LIST_SIZE-1)];
+				delete[] copy;
+				copy=new char[strlen(name)+5];
+				strcpy(copy,name);
+				strcat(copy,".w3d");
+				delete[] name;
+				if (copy[0]!='o') {
+					Errors++;
+				}
+			}
+			for (int i=0;i<LIST_SIZE;i++) {
+				delete[] list[i];
+			}
+		}
+	}
+};
+
+static double Churn(int thread_count,bool use_string_class)
+{
+	ChurnThreadClass threads[MAX_THREADS];
+	volatile bool start=false;
+
+	for (int i=0;i<thread_count;++i) {
+		threads[i].Index=i;
+		threads[i].UseStringClass=use_string_class;
+		threads[i].StartFlag=&start;
+		threads[i].Execute();
+	}
+
+	LARGE_INTEGER begin,end;
+	QueryPerformanceCounter(&begin);
+	start=true;
+
+	int errors=0;
+	for (int i=0;i<thread_count;++i) {
+		while (threads[i].Is_Running()) {
+			ThreadClass::Sleep_Ms(1);
+		}
+		errors+=threads[i].Errors;
+	}
+	QueryPerformanceCounter(&end);
+
+	if (errors) {
+		printf("%d bad strings with %d threads FAILED\n",errors,thread_count);
+		Failures++;
+	}
+	return double(STRINGS_PER_THREAD)*thread_count/Seconds(begin,end)/1000000.0;
+}
+
+int main(void)
+{
+	Asset_Lookups();
+
+	// Short strings must stay correct through copies and appends
+	StringClass a("short");
+	StringClass b(a);
+	b+="_and_now_much_longer_than_inline";
+	StringClass c(b);
+	c.Erase(5,c.Get_Length()-5);
+	if (a!="short" || c!="short" || b.Get_Length()!=37 || c.Get_Length()!=5) {
+		printf("StringClass contents FAILED\n");
+		Failures++;
+	}
+
+	static const int thread_counts[]={ 1, 4, 16 };
+	printf("%d names per thread. Million names per second:\n\n",STRINGS_PER_THREAD);
+	printf("%-26s %10s %10s %10s\n","","1 thread","4 threads","16 threads");
+	for (int mode=0;mode<2;mode++) {
+		printf("%-26s",mode ? "StringClass" : "heap copy per string");
+		for (int t=0;t<sizeof(thread_counts)/sizeof(thread_counts[0]);++t) {
+			printf(" %10.2f",Churn(thread_counts[t],mode!=0));
+		}
+		printf("\n");
+	}
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
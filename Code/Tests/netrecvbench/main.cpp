@@ -0,0 +1,354 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Packet Receive Path Benchmark                                *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/netrecvbench/main.cpp                  $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Replays a stream of captured datagrams through the server receive path: header parse,      *
+ * sender lookup and handing the packet to a receive window. The old path (full packet copy,  *
+ * linear address search, copy into the window) is timed against the new one (receive into   *
+ * a pooled packet, parse in place, hashed address lookup, adopt the packet). Both must       *
+ * produce the same packets.                                                                  *
+ *                                                                                             *
+ * With no arguments a stream from 32 clients is made up. Otherwise the argument names a      *
+ * capture file of records: ULONG ip, USHORT port (both network order), USHORT byte count,    *
+ * then the datagram bytes.                                                                    *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "wwpacket.h"
+#include "packettype.h"
+#include "rhostmap.h"
+#include "simplevec.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const int CLIENT_COUNT=32;
+const int DATAGRAM_COUNT=200000;
+const int PASSES=5;
+const int WINDOW_PACKETS=64;		// packets held by the "receive windows" before delivery
+
+static int Failures=0;
+
+// ----------------------------------------------------------------------------
+//
+// The captured stream
+//
+// ----------------------------------------------------------------------------
+
+struct DatagramStruct
+{
+	ULONG				Ip;
+	USHORT			Port;
+	USHORT			Size;
+	int				Offset;			// into StreamBytes
+};
+
+static SimpleDynVecClass<DatagramStruct>	Stream;
+static SimpleDynVecClass<unsigned char>	StreamBytes;
+static SimpleDynVecClass<SOCKADDR_IN>		Clients;
+
+static void Add_Datagram(ULONG ip,USHORT port,const unsigned char * data,int size)
+{
+	DatagramStruct datagram;
+	datagram.Ip=ip;
+	datagram.Port=port;
+	datagram.Size=(USHORT)size;
+	datagram.Offset=StreamBytes.Count();
+	Stream.Add(datagram);
+	if (size>0) {
+		memcpy(StreamBytes.Add_Multiple(size),data,size);
+	}
+}
+
+static void Add_Client(ULONG ip,USHORT port)
+{
+	for (int i=0;i<Clients.Count();++i) {
+		if (Clients[i].sin_addr.s_addr==ip && Clients[i].sin_port==port) {
+			return;
+		}
+	}
+	SOCKADDR_IN address;
+	memset(&address,0,sizeof(address));
+	address.sin_family=AF_INET;
+	address.sin_addr.s_addr=ip;
+	address.sin_port=port;
+	Clients.Add(address);
+}
+
+static void Make_Stream()
+{
+	int ids[CLIENT_COUNT];
+	for (int c=0;c<CLIENT_COUNT;++c) {
+		// Several clients share each address, as they do behind a NAT
+		Add_Client(htonl(0x0a000001+c/4),htons((USHORT)(4096+c)));
+		ids[c]=0;
+	}
+
+	unsigned random=12345;
+	for (int i=0;i<DATAGRAM_COUNT;++i) {
+		random=random*1664525+1013904223;
+		int c=(random>>8)%CLIENT_COUNT;
+		int payload_bytes=8+((random>>16)%200);
+
+		cPacket packet;
+		for (int b=0;b<payload_bytes;++b) {
+			packet.Add((BYTE)(b*31+i));
+		}
+		packet.Set_Type(((random>>4)&1) ? PACKETTYPE_RELIABLE : PACKETTYPE_UNRELIABLE);
+		packet.Set_Id(ids[c]++);
+		packet.Set_Sender_Id(c+1);
+
+		cPacket full_packet;
+		cPacket::Construct_Full_Packet(full_packet,packet);
+		Add_Datagram(Clients[c].sin_addr.s_addr,Clients[c].sin_port,(unsigned char *)full_packet.Get_Data(),full_packet.Get_Compressed_Size_Bytes());
+		packet.Flush();
+		full_packet.Flush();
+	}
+}
+
+static bool Load_Stream(const char * filename)
+{
+	FILE * file=fopen(filename,"rb");
+	if (file==NULL) {
+		printf("Can't open %s\n",filename);
+		return false;
+	}
+
+	unsigned char data[MAX_BUFFER_SIZE];
+	ULONG ip;
+	USHORT port;
+	USHORT size;
+	while (fread(&ip,sizeof(ip),1,file)==1 && fread(&port,sizeof(port),1,file)==1 && fread(&size,sizeof(size),1,file)==1) {
+		if (size>MAX_BUFFER_SIZE || fread(data,1,size,file)!=size) {
+			printf("%s is truncated or corrupt\n",filename);
+			break;
+		}
+		Add_Client(ip,port);
+		Add_Datagram(ip,port,data,size);
+	}
+	fclose(file);
+	return Stream.Count()>0;
+}
+
+// ----------------------------------------------------------------------------
+//
+// The receive paths. Each one leaves the packet it kept in the result, or NULL if
+// the datagram was dropped. The recvfrom copy into the buffer is the same in
+// both.
+//
+// ----------------------------------------------------------------------------
+
+struct ResultStruct
+{
+	int				RHostId;
+	cPacket *		Packet;
+};
+
+static cRemoteHostMap	RHostMap;
+
+static int Linear_Find(const SOCKADDR_IN & address)
+{
+	for (int i=0;i<Clients.Count();++i) {
+		if (Clients[i].sin_addr.s_addr==address.sin_addr.s_addr && Clients[i].sin_port==address.sin_port) {
+			return i;
+		}
+	}
+	return cRemoteHostMap::INVALID_ID;
+}
+
+static void Old_Receive(const DatagramStruct & datagram,ResultStruct & result)
+{
+	cPacket packet;							// Receive_Packet's stack packet
+	cPacket full_packet;						// Receive_Wrapper's stack packet
+
+	memcpy(full_packet.Get_Data(),&StreamBytes[datagram.Offset],datagram.Size);
+	SOCKADDR_IN & from=full_packet.Get_From_Address_Wrapper()->FromAddress;
+	from.sin_addr.s_addr=datagram.Ip;
+	from.sin_port=datagram.Port;
+
+	full_packet.Set_Bit_Length(datagram.Size*8);
+	cPacket::Construct_App_Packet(packet,full_packet);
+	full_packet.Flush();
+
+	result.RHostId=Linear_Find(packet.Get_From_Address_Wrapper()->FromAddress);
+	result.Packet=NULL;
+	if (result.RHostId!=cRemoteHostMap::INVALID_ID) {
+		result.Packet=new cPacket;
+		*result.Packet=packet;				// cRemoteHost::Add_Packet's copy
+	}
+	packet.Flush();
+}
+
+static cPacket * ReceivePacket=NULL;
+
+static void New_Receive(const DatagramStruct & datagram,ResultStruct & result)
+{
+	cPacket & packet=*ReceivePacket;
+	packet.Reset_For_Receive();
+
+	memcpy(packet.Get_Data(),&StreamBytes[datagram.Offset],datagram.Size);
+	SOCKADDR_IN & from=packet.Get_From_Address_Wrapper()->FromAddress;
+	from.sin_addr.s_addr=datagram.Ip;
+	from.sin_port=datagram.Port;
+
+	result.Packet=NULL;
+	result.RHostId=cRemoteHostMap::INVALID_ID;
+	if (!packet.Construct_App_Packet_In_Place(datagram.Size)) {
+		return;
+	}
+
+	result.RHostId=RHostMap.Find(from);
+	if (result.RHostId!=cRemoteHostMap::INVALID_ID) {
+		result.Packet=ReceivePacket;		// cRemoteHost::Adopt_Packet
+		ReceivePacket=new cPacket;
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+typedef void (*ReceiveFunctionType)(const DatagramStruct & datagram,ResultStruct & result);
+
+static unsigned Checksum;
+
+static void Deliver(cPacket * packet)
+{
+	// Read the payload the way the application would
+	while (packet->Get_Bit_Length()-packet->Get_Bit_Read_Position()>=8) {
+		BYTE value;
+		packet->Get(value);
+		Checksum=Checksum*33+value;
+	}
+	packet->Flush();
+	delete packet;
+}
+
+static double Run(ReceiveFunctionType function)
+{
+	ResultStruct result;
+	cPacket * window[WINDOW_PACKETS];
+	memset(window,0,sizeof(window));
+	int next=0;
+
+	LARGE_INTEGER freq,begin,end;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&begin);
+
+	for (int pass=0;pass<PASSES;++pass) {
+		for (int i=0;i<Stream.Count();++i) {
+			function(Stream[i],result);
+			if (result.Packet!=NULL) {
+				if (window[next]!=NULL) {
+					Deliver(window[next]);
+				}
+				window[next]=result.Packet;
+				next=(next+1)%WINDOW_PACKETS;
+			}
+		}
+	}
+	for (int i=0;i<WINDOW_PACKETS;++i) {
+		if (window[i]!=NULL) {
+			Deliver(window[i]);
+		}
+	}
+
+	QueryPerformanceCounter(&end);
+	double seconds=double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+	return seconds*1000000000.0/(double(PASSES)*Stream.Count());
+}
+
+static void Verify()
+{
+	int mismatches=0;
+	for (int i=0;i<Stream.Count();++i) {
+		ResultStruct old_result;
+		ResultStruct new_result;
+		Old_Receive(Stream[i],old_result);
+		New_Receive(Stream[i],new_result);
+
+		bool same=(old_result.RHostId==new_result.RHostId) && ((old_result.Packet==NULL)==(new_result.Packet==NULL));
+		if (same && old_result.Packet!=NULL) {
+			cPacket & a=*old_result.Packet;
+			cPacket & b=*new_result.Packet;
+			same=
+				a.Get_Type()==b.Get_Type() &&
+				a.Get_Id()==b.Get_Id() &&
+				a.Get_Sender_Id()==b.Get_Sender_Id() &&
+				a.Get_Bit_Length()==b.Get_Bit_Length() &&
+				a.Get_Bit_Read_Position()==b.Get_Bit_Read_Position() &&
+				memcmp(a.Get_Data(),b.Get_Data(),a.Get_Compressed_Size_Bytes())==0;
+		}
+		if (!same && mismatches++<10) {
+			printf("datagram %d: receive paths disagree FAILED\n",i);
+		}
+
+		if (old_result.Packet) { old_result.Packet->Flush(); delete old_result.Packet; }
+		if (new_result.Packet) { new_result.Packet->Flush(); delete new_result.Packet; }
+	}
+	if (mismatches) {
+		Failures++;
+	}
+}
+
+int main(int argc,char * argv[])
+{
+	if (argc>1) {
+		if (!Load_Stream(argv[1])) {
+			return 1;
+		}
+	} else {
+		Make_Stream();
+	}
+
+	for (int i=0;i<Clients.Count();++i) {
+		RHostMap.Add(Clients[i],i);
+	}
+	ReceivePacket=new cPacket;
+
+	printf("%d datagrams, %d bytes, from %d addresses\n",Stream.Count(),StreamBytes.Count(),Clients.Count());
+
+	Verify();
+
+	Checksum=0;
+	double old_ns=Run(Old_Receive);
+	unsigned old_checksum=Checksum;
+
+	Checksum=0;
+	double new_ns=Run(New_Receive);
+	if (Checksum!=old_checksum) {
+		printf("delivered payloads differ FAILED\n");
+		Failures++;
+	}
+
+	printf("\nnanoseconds per datagram:\n");
+	printf("%-54s %8.1f\n","copy, Construct_App_Packet, linear search, copy",old_ns);
+	printf("%-54s %8.1f\n","pooled, parse in place, hashed lookup, adopt",new_ns);
+
+	delete ReceivePacket;
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,428 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Reliable Delivery Soak Test                                  *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/netsoak/main.cpp                       $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Pushes reliable packets through a pair of cPacketWindows over a simulated link with the     *
+ * same packet loss and latency range settings as cConnection::Set_Packet_Loss and            *
+ * Set_Packet_Latency_Range. Checks that every packet is delivered once and in order, that    *
+ * the windows drain, and times acknowledgement against the old per packet list search.       *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "packetwindow.h"
+#include "wwpacket.h"
+#include "packettype.h"
+#include "slist.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const int TICK_MS=10;
+const int PACKETS_PER_TICK=4;
+const int MAX_TICKS=200000;
+
+static int Failures=0;
+
+// ----------------------------------------------------------------------------
+//
+// The simulated link. Every datagram gets its own random latency in the
+// configured range, so packets overtake each other just as they do on the
+// internet.
+//
+// ----------------------------------------------------------------------------
+
+struct DatagramStruct
+{
+	int				DeliverTime;
+	int				Type;
+	int				Id;
+	int				TopId;
+	ULONG				Mask;
+};
+
+class LinkClass
+{
+public:
+	LinkClass(int loss_percent,int min_latency_ms,int max_latency_ms) :
+		LossPercent(loss_percent),
+		MinLatencyMs(min_latency_ms),
+		MaxLatencyMs(max_latency_ms),
+		Sent(0),
+		Lost(0)
+	{
+	}
+
+	void Send(int now,int type,int id,int top_id=0,ULONG mask=0)
+	{
+		Sent++;
+		if ((rand()%100)<LossPercent) {
+			Lost++;
+			return;
+		}
+
+		DatagramStruct * datagram=new DatagramStruct;
+		datagram->DeliverTime=now+MinLatencyMs+(rand()%(MaxLatencyMs-MinLatencyMs+1));
+		datagram->Type=type;
+		datagram->Id=id;
+		datagram->TopId=top_id;
+		datagram->Mask=mask;
+		InFlight.Add_Tail(datagram);
+	}
+
+	// Returns a datagram that has arrived by now, the caller deletes it
+	DatagramStruct * Receive(int now)
+	{
+		for (SLNode<DatagramStruct> * node=InFlight.Head();node!=NULL;node=node->Next()) {
+			DatagramStruct * datagram=node->Data();
+			if (datagram->DeliverTime<=now) {
+				InFlight.Remove(datagram);
+				return datagram;
+			}
+		}
+		return NULL;
+	}
+
+	bool Is_Empty() const { return InFlight.Is_Empty(); }
+
+	int		LossPercent;
+	int		MinLatencyMs;
+	int		MaxLatencyMs;
+	int		Sent;
+	int		Lost;
+	SList<DatagramStruct>	InFlight;
+};
+
+// ----------------------------------------------------------------------------
+//
+// One direction of a reliable connection, as cConnection drives it: the
+// sender queues and resends, the receiver processes in sequence and answers
+// everything that arrived in a tick with one bitfield ack.
+//
+// ----------------------------------------------------------------------------
+
+struct SoakResultStruct
+{
+	int	Ticks;
+	int	DataSent;
+	int	AcksSent;
+	int	Delivered;
+	int	Duplicates;
+	int	LargestWindow;
+};
+
+static bool Soak(int loss_percent,int min_latency_ms,int max_latency_ms,int packet_count,SoakResultStruct & result)
+{
+	LinkClass data_link(loss_percent,min_latency_ms,max_latency_ms);
+	LinkClass ack_link(loss_percent,min_latency_ms,max_latency_ms);
+
+	cPacketWindow send_window;
+	cPacketWindow rcv_window;
+	int * send_times=new int[packet_count];
+	int resend_timeout_ms=2*max_latency_ms+100;	// cRemoteHost adapts this to the measured ping
+	int next_send_id=0;
+	int next_rcv_id=0;
+	bool ok=true;
+
+	memset(&result,0,sizeof(result));
+
+	int now=0;
+	for (int tick=0;tick<MAX_TICKS;++tick,now+=TICK_MS) {
+
+		// Queue new packets
+		for (int i=0;i<PACKETS_PER_TICK && next_send_id<packet_count;++i) {
+			cPacket * p_packet=new cPacket;
+			p_packet->Set_Type(PACKETTYPE_RELIABLE);
+			p_packet->Set_Id(next_send_id);
+			send_times[next_send_id]=now-resend_timeout_ms;
+			send_window.Add(p_packet);
+			next_send_id++;
+		}
+		if (send_window.Get_End_Id()-send_window.Get_Base_Id()>result.LargestWindow) {
+			result.LargestWindow=send_window.Get_End_Id()-send_window.Get_Base_Id();
+		}
+
+		// Send and resend
+		for (int id=send_window.Get_Base_Id();id<send_window.Get_End_Id();++id) {
+			if (send_window.Peek(id)!=NULL && now-send_times[id]>=resend_timeout_ms) {
+				data_link.Send(now,PACKETTYPE_RELIABLE,id);
+				send_times[id]=now;
+			}
+		}
+
+		// Receive data
+		int ack_lowest_id=-1;
+		DatagramStruct * datagram;
+		while ((datagram=data_link.Receive(now))!=NULL) {
+			cPacket * p_packet=new cPacket;
+			p_packet->Set_Type(datagram->Type);
+			p_packet->Set_Id(datagram->Id);
+			if (rcv_window.Add(p_packet)!=cPacketWindow::ADDED) {
+				delete p_packet;
+				result.Duplicates++;
+			}
+			if (ack_lowest_id<0 || datagram->Id<ack_lowest_id) {
+				ack_lowest_id=datagram->Id;
+			}
+			delete datagram;
+		}
+
+		// Process in sequence
+		cPacket * p_packet;
+		while ((p_packet=rcv_window.Peek(next_rcv_id))!=NULL) {
+			if (p_packet->Get_Id()!=result.Delivered) {
+				printf("  delivered packet %d when %d was expected FAILED\n",p_packet->Get_Id(),result.Delivered);
+				ok=false;
+			}
+			result.Delivered++;
+			delete rcv_window.Remove(next_rcv_id);
+			next_rcv_id++;
+			rcv_window.Set_Base_Id(next_rcv_id);
+		}
+
+		// Ack the way cConnection::Send_Pending_Acks does
+		if (ack_lowest_id>=0) {
+			int first_missing_id;
+			ULONG mask;
+			int top_id=rcv_window.Get_End_Id()-1;
+			rcv_window.Get_Ack_Bitfield(top_id,first_missing_id,mask);
+			ack_link.Send(now,PACKETTYPE_ACK_BITFIELD,first_missing_id,top_id,mask);
+
+			if (ack_lowest_id<=top_id-cPacketWindow::ACK_MASK_BITS && ack_lowest_id>=next_rcv_id) {
+				top_id=ack_lowest_id+cPacketWindow::ACK_MASK_BITS-1;
+				rcv_window.Get_Ack_Bitfield(top_id,first_missing_id,mask);
+				ack_link.Send(now,PACKETTYPE_ACK_BITFIELD,first_missing_id,top_id,mask);
+			}
+		}
+
+		// Receive acks
+		while ((datagram=ack_link.Receive(now))!=NULL) {
+			cPacket * p_newest=NULL;
+			send_window.Acknowledge(datagram->Id,datagram->TopId,datagram->Mask,&p_newest);
+			delete p_newest;
+			delete datagram;
+		}
+
+		if (next_send_id==packet_count && send_window.Get_Count()==0) {
+			result.Ticks=tick+1;
+			break;
+		}
+	}
+
+	result.DataSent=data_link.Sent;
+	result.AcksSent=ack_link.Sent;
+
+	if (result.Delivered!=packet_count) {
+		printf("  %d of %d packets delivered FAILED\n",result.Delivered,packet_count);
+		ok=false;
+	}
+	if (send_window.Get_Count()!=0 || rcv_window.Get_Count()!=0) {
+		printf("  %d packets left in send window, %d in receive window FAILED\n",send_window.Get_Count(),rcv_window.Get_Count());
+		ok=false;
+	}
+
+	// Anything still on the wire is a late duplicate and must be rejected
+	while (!data_link.Is_Empty()) {
+		DatagramStruct * datagram=data_link.Receive(0x7fffffff);
+		cPacket * p_packet=new cPacket;
+		p_packet->Set_Id(datagram->Id);
+		if (rcv_window.Add(p_packet)==cPacketWindow::ADDED) {
+			printf("  late duplicate of packet %d accepted FAILED\n",datagram->Id);
+			ok=false;
+		} else {
+			delete p_packet;
+		}
+		delete datagram;
+	}
+
+	while (!ack_link.Is_Empty()) {
+		delete ack_link.Receive(0x7fffffff);
+	}
+
+	delete [] send_times;
+	return ok;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Acknowledge a window of outstanding packets where every other one arrived.
+// The old code searched the send list once per ack packet; the window clears
+// the lot from one bitfield.
+//
+// ----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+//
+// A packet too far ahead of the window must be refused as out of range (so
+// that the caller can drop the connection) rather than as a duplicate.
+//
+// ----------------------------------------------------------------------------
+
+static bool Check_Out_Of_Range(void)
+{
+	bool ok=true;
+	cPacketWindow window;
+
+	cPacket * p_packet=new cPacket;
+	p_packet->Set_Id(cPacketWindow::MAX_CAPACITY);
+	if (window.Add(p_packet)!=cPacketWindow::OUT_OF_RANGE) {
+		printf("packet %d ahead of the window not refused as out of range FAILED\n",cPacketWindow::MAX_CAPACITY);
+		ok=false;
+	} else {
+		delete p_packet;
+	}
+
+	p_packet=new cPacket;
+	p_packet->Set_Id(cPacketWindow::MAX_CAPACITY-1);
+	if (window.Add(p_packet)!=cPacketWindow::ADDED) {
+		printf("packet %d at the end of the window refused FAILED\n",cPacketWindow::MAX_CAPACITY-1);
+		delete p_packet;
+		ok=false;
+	}
+
+	p_packet=new cPacket;
+	p_packet->Set_Id(cPacketWindow::MAX_CAPACITY-1);
+	if (window.Add(p_packet)!=cPacketWindow::DISCARDED) {
+		printf("duplicate packet not discarded FAILED\n");
+		ok=false;
+	} else {
+		delete p_packet;
+	}
+
+	window.Delete_All();
+	return ok;
+}
+
+static double Seconds(LARGE_INTEGER begin,LARGE_INTEGER end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+static void Time_Acks(int outstanding,int rounds)
+{
+	LARGE_INTEGER begin,end;
+
+	QueryPerformanceCounter(&begin);
+	for (int round=0;round<rounds;++round) {
+		SList<cPacket> list;
+		for (int id=0;id<outstanding;++id) {
+			cPacket * p_packet=new cPacket;
+			p_packet->Set_Id(id);
+			list.Add_Tail(p_packet);
+		}
+		for (int id=outstanding-1;id>=0;id-=2) {
+			for (SLNode<cPacket> * node=list.Head();node!=NULL;node=node->Next()) {
+				if (node->Data()->Get_Id()==id) {
+					cPacket * p_packet=node->Data();
+					list.Remove(p_packet);
+					delete p_packet;
+					break;
+				}
+			}
+		}
+		for (SLNode<cPacket> * node=list.Head();node!=NULL;node=node->Next()) {
+			delete node->Data();
+		}
+		list.Remove_All();
+	}
+	QueryPerformanceCounter(&end);
+	double list_time=Seconds(begin,end);
+
+	QueryPerformanceCounter(&begin);
+	for (int round=0;round<rounds;++round) {
+		cPacketWindow window;
+		for (int id=0;id<outstanding;++id) {
+			cPacket * p_packet=new cPacket;
+			p_packet->Set_Id(id);
+			window.Add(p_packet);
+		}
+		for (int top=outstanding-1;top>=0;top-=cPacketWindow::ACK_MASK_BITS) {
+			cPacket * p_newest=NULL;
+			window.Acknowledge(0,top,0xaaaaaaaa,&p_newest);
+			delete p_newest;
+		}
+		window.Delete_All();
+	}
+	QueryPerformanceCounter(&end);
+	double window_time=Seconds(begin,end);
+
+	printf("%6d outstanding: list %8.2f us, window %8.2f us per round\n",
+		outstanding,list_time*1000000.0/rounds,window_time*1000000.0/rounds);
+}
+
+int main(void)
+{
+	struct ScenarioStruct {
+		int LossPercent;
+		int MinLatencyMs;
+		int MaxLatencyMs;
+	};
+	static const ScenarioStruct scenarios[]={
+		{ 0, 0, 0 },
+		{ 2, 30, 60 },
+		{ 10, 50, 250 },
+		{ 25, 100, 400 },
+		{ 40, 200, 800 },
+	};
+	const int packet_count=20000;
+
+	srand(1);
+
+	printf("%d reliable packets, %d per %d ms tick:\n\n",packet_count,PACKETS_PER_TICK,TICK_MS);
+	printf("%6s %10s %8s %8s %8s %8s %8s\n","loss","latency","ticks","sent","acks","dups","window");
+
+	for (int i=0;i<sizeof(scenarios)/sizeof(scenarios[0]);++i) {
+		const ScenarioStruct & s=scenarios[i];
+		SoakResultStruct result;
+		bool ok=Soak(s.LossPercent,s.MinLatencyMs,s.MaxLatencyMs,packet_count,result);
+
+		printf("%5d%% %4d-%4dms %8d %8d %8d %8d %8d\n",s.LossPercent,s.MinLatencyMs,s.MaxLatencyMs,
+			result.Ticks,result.DataSent,result.AcksSent,result.Duplicates,result.LargestWindow);
+
+		// One ack per tick at most, however many packets arrived in it
+		if (result.AcksSent>=result.DataSent) {
+			printf("  %d acks for %d packets FAILED\n",result.AcksSent,result.DataSent);
+			ok=false;
+		}
+		if (!ok) {
+			Failures++;
+		}
+	}
+
+	if (!Check_Out_Of_Range()) {
+		Failures++;
+	}
+
+	printf("\n");
+	Time_Acks(64,2000);
+	Time_Acks(1024,200);
+	Time_Acks(8192,10);
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
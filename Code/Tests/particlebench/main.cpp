@@ -0,0 +1,738 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Particle Benchmark                                           *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/particlebench/main.cpp                 $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Runs synthetic particle buffers through every ParticleKernelClass kernel and compares them  *
+ * with the loops ParticleBufferClass used to run, including wrapped buffers, random tables    *
+ * shorter than the buffer and particles that are out of age order. Then times 100k particles  *
+ * split between smoke, explosion and weather emitters, serially and across the worker pool.   *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "partkernel.h"
+#include "vector3.h"
+#include "workerpool.h"
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+enum {
+	FRAME_MS=33,
+	TEST_FRAMES=40,
+	PASSES=50,
+	MAX_KEYS=4,
+	MAX_RANDOM_ENTRIES=1024,
+	GUARD=8
+};
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	if (!ok) {
+		printf("%s FAILED\n",what);
+		Failures++;
+	}
+}
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+static unsigned Random_State=12345;
+static unsigned Random(void)
+{
+	Random_State=Random_State*1664525+1013904223;
+	return Random_State>>8;
+}
+
+static float Random_Float(float min,float max)
+{
+	return min+(max-min)*(float)(Random()&0xffff)/65535.0f;
+}
+
+static const char * Kernel_Name(ParticleKernelClass::KernelType kernel)
+{
+	switch (kernel) {
+		case ParticleKernelClass::KERNEL_SCALAR:	return "scalar";
+		case ParticleKernelClass::KERNEL_SSE2:		return "SSE2";
+		case ParticleKernelClass::KERNEL_AVX2:		return "AVX2";
+		default:												return "best";
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// Emitter settings, roughly what the game's emitters use. Keyframe times are
+// fractions of the lifetime, a property with a single key and no randomizer
+// is constant and has no per-particle array, as in ParticleBufferClass.
+//
+// ----------------------------------------------------------------------------
+
+struct PropertySettingsStruct
+{
+	int		KeyCount;
+	float		Times[MAX_KEYS];
+	float		Values[MAX_KEYS];
+	float		Random;
+};
+
+struct EmitterSettingsStruct
+{
+	const char *				Name;
+	int							BufferCount;
+	unsigned int				BufferSize;
+	unsigned int				MaxAge;
+	Vector3						Accel;			// per ms^2
+	bool							PingPong;
+	PropertySettingsStruct	Color;			// grey level, all three components
+	PropertySettingsStruct	Alpha;
+	PropertySettingsStruct	Size;
+};
+
+static const EmitterSettingsStruct Emitters[]=
+{
+	{	"smoke",			40,	1000,	4000,	Vector3(0.0f,0.0f,0.0f),		false,
+		{ 3, { 0.0f,0.3f,0.8f },		{ 0.2f,0.5f,0.6f },			0.1f },
+		{ 3, { 0.0f,0.1f,0.7f },		{ 0.0f,0.6f,0.0f },			0.05f },
+		{ 2, { 0.0f,1.0f },				{ 0.5f,3.0f },					0.25f } },
+	{	"explosion",	100,	300,	1500,	Vector3(0.0f,0.0f,-9.8e-6f),	true,
+		{ 2, { 0.0f,0.4f },				{ 1.0f,0.3f },					0.0f },
+		{ 2, { 0.0f,0.9f },				{ 1.0f,0.0f },					0.0f },
+		{ 3, { 0.0f,0.2f,0.9f },		{ 0.2f,2.0f,-0.5f },			0.1f } },
+	{	"weather",		2,		15000,	3000,	Vector3(0.0f,0.0f,-2.0e-6f),	false,
+		{ 1, { 0.0f },						{ 0.8f },						0.0f },
+		{ 1, { 0.0f },						{ 0.6f },						0.0f },
+		{ 1, { 0.0f },						{ 0.05f },						0.02f } },
+};
+
+static const int EMITTER_COUNT=sizeof(Emitters)/sizeof(Emitters[0]);
+
+
+// ----------------------------------------------------------------------------
+//
+// One keyframed property, laid out like the ParticleBufferClass arrays
+//
+// ----------------------------------------------------------------------------
+
+struct PropertyStruct
+{
+	PropertyStruct(void) : Components(0), KeyCount(0), RandomMask(0), Random(NULL) {}
+	~PropertyStruct(void) { delete [] Random; }
+
+	bool Is_Constant(void) const { return Random==NULL; }
+
+	void Init(const PropertySettingsStruct & settings,int components,unsigned int max_age,unsigned int buffer_size)
+	{
+		Components=components;
+		KeyCount=settings.KeyCount;
+		for (int k=0;k<KeyCount;++k) {
+			Times[k]=(unsigned int)(settings.Times[k]*max_age);
+			for (int c=0;c<Components;++c) {
+				Values[k*Components+c]=settings.Values[k]*(1.0f-0.1f*c);
+			}
+		}
+		for (int k=0;k<KeyCount;++k) {
+			for (int c=0;c<Components;++c) {
+				Deltas[k*Components+c]=(k+1<KeyCount) ?
+					(Values[(k+1)*Components+c]-Values[k*Components+c])/(float)(Times[k+1]-Times[k]) : 0.0f;
+			}
+		}
+
+		delete [] Random;
+		Random=NULL;
+		if (KeyCount==1 && settings.Random==0.0f) {
+			return;
+		}
+
+		// Power of two no bigger than MAX_RANDOM_ENTRIES, one zero entry without a randomizer
+		unsigned int entries=1;
+		if (settings.Random!=0.0f) {
+			while (entries<buffer_size && entries<MAX_RANDOM_ENTRIES) entries<<=1;
+		}
+		RandomMask=entries-1;
+		Random=new float[entries*Components];
+		for (unsigned int i=0;i<entries*Components;++i) {
+			Random[i]=Random_Float(-settings.Random,settings.Random);
+		}
+	}
+
+	void Copy_Random(const PropertyStruct & src)
+	{
+		if (Random!=NULL) {
+			memcpy(Random,src.Random,sizeof(float)*(RandomMask+1)*Components);
+		}
+	}
+
+	ParticleKernelClass::KeyTrackStruct Get_Track(bool clamp) const
+	{
+		ParticleKernelClass::KeyTrackStruct track;
+		track.Components=Components;
+		track.Times=Times;
+		track.Values=Values;
+		track.Deltas=Deltas;
+		track.Random=Random;
+		track.RandomMask=RandomMask;
+		track.ClampToZero=clamp;
+		return track;
+	}
+
+	int				Components;
+	int				KeyCount;
+	unsigned int	Times[MAX_KEYS];
+	float				Values[MAX_KEYS*3];
+	float				Deltas[MAX_KEYS*3];
+	unsigned int	RandomMask;
+	float *			Random;
+};
+
+
+// ----------------------------------------------------------------------------
+//
+// A particle buffer without a renderer. It is kept full: the particles that
+// reach their max age at the start of a frame are reborn at the emitter as
+// the newest ones, so the buffer wraps around like the real one. Each buffer
+// has its own random numbers so it can be updated on any thread.
+//
+// ----------------------------------------------------------------------------
+
+struct SimBufferStruct
+{
+	SimBufferStruct(const EmitterSettingsStruct & settings) :
+		Settings(settings),
+		MaxNum(settings.BufferSize),
+		Start(Random()%settings.BufferSize),
+		Time(100000+Random()%1000),
+		Frame(0),
+		Seed(Random())
+	{
+		Position[0]=new Vector3[MaxNum+GUARD];
+		Position[1]=new Vector3[MaxNum+GUARD];
+		Velocity=new Vector3[MaxNum+GUARD];
+		TimeStamp=new unsigned int[MaxNum+GUARD];
+		Color=new Vector3[MaxNum+GUARD];
+		Alpha=new float[MaxNum+GUARD];
+		Size=new float[MaxNum+GUARD];
+		memset(Color,0xcd,sizeof(Vector3)*(MaxNum+GUARD));
+		memset(Alpha,0xcd,sizeof(float)*(MaxNum+GUARD));
+		memset(Size,0xcd,sizeof(float)*(MaxNum+GUARD));
+
+		ColorProp.Init(settings.Color,3,settings.MaxAge,MaxNum);
+		AlphaProp.Init(settings.Alpha,1,settings.MaxAge,MaxNum);
+		SizeProp.Init(settings.Size,1,settings.MaxAge,MaxNum);
+
+		// Oldest particle at Start, all of them under max age
+		for (unsigned int j=0;j<MaxNum;++j) {
+			unsigned int i=(Start+j)%MaxNum;
+			TimeStamp[i]=Time-(settings.MaxAge-1)+(unsigned int)((unsigned long long)j*(settings.MaxAge-1)/MaxNum);
+			Spawn(i);
+		}
+	}
+
+	~SimBufferStruct(void)
+	{
+		delete [] Position[0];
+		delete [] Position[1];
+		delete [] Velocity;
+		delete [] TimeStamp;
+		delete [] Color;
+		delete [] Alpha;
+		delete [] Size;
+	}
+
+	float Seed_Float(float min,float max)
+	{
+		Seed=Seed*1664525+1013904223;
+		return min+(max-min)*(float)((Seed>>8)&0xffff)/65535.0f;
+	}
+
+	void Spawn(unsigned int i)
+	{
+		Velocity[i].X=Seed_Float(-0.01f,0.01f);
+		Velocity[i].Y=Seed_Float(-0.01f,0.01f);
+		Velocity[i].Z=Seed_Float(0.0f,0.02f);
+		Position[0][i].X=Seed_Float(-1.0f,1.0f);
+		Position[0][i].Y=Seed_Float(-1.0f,1.0f);
+		Position[0][i].Z=0.0f;
+		Position[1][i]=Position[0][i];
+	}
+
+	// Copy the particle state of another buffer with the same settings
+	void Copy(const SimBufferStruct & src)
+	{
+		Start=src.Start;
+		Time=src.Time;
+		Frame=src.Frame;
+		Seed=src.Seed;
+		memcpy(Position[0],src.Position[0],sizeof(Vector3)*MaxNum);
+		memcpy(Position[1],src.Position[1],sizeof(Vector3)*MaxNum);
+		memcpy(Velocity,src.Velocity,sizeof(Vector3)*MaxNum);
+		memcpy(TimeStamp,src.TimeStamp,sizeof(unsigned int)*MaxNum);
+		ColorProp.Copy_Random(src.ColorProp);
+		AlphaProp.Copy_Random(src.AlphaProp);
+		SizeProp.Copy_Random(src.SizeProp);
+	}
+
+	bool Same(const SimBufferStruct & other) const
+	{
+		return	Start==other.Start &&
+					memcmp(Position[0],other.Position[0],sizeof(Vector3)*MaxNum)==0 &&
+					memcmp(Position[1],other.Position[1],sizeof(Vector3)*MaxNum)==0 &&
+					memcmp(Velocity,other.Velocity,sizeof(Vector3)*MaxNum)==0 &&
+					(ColorProp.Is_Constant() || memcmp(Color,other.Color,sizeof(Vector3)*MaxNum)==0) &&
+					(AlphaProp.Is_Constant() || memcmp(Alpha,other.Alpha,sizeof(float)*MaxNum)==0) &&
+					(SizeProp.Is_Constant() || memcmp(Size,other.Size,sizeof(float)*MaxNum)==0);
+	}
+
+	bool Guard_Intact(void) const
+	{
+		const unsigned char * bytes[3]={ (const unsigned char *)(Color+MaxNum),(const unsigned char *)(Alpha+MaxNum),(const unsigned char *)(Size+MaxNum) };
+		unsigned int sizes[3]={ sizeof(Vector3)*GUARD,sizeof(float)*GUARD,sizeof(float)*GUARD };
+		for (int a=0;a<3;++a) {
+			for (unsigned int i=0;i<sizes[a];++i) {
+				if (bytes[a][i]!=0xcd) return false;
+			}
+		}
+		return true;
+	}
+
+	const EmitterSettingsStruct &	Settings;
+	unsigned int						MaxNum;
+	unsigned int						Start;			// oldest particle, also one past the newest
+	unsigned int						Time;
+	unsigned int						Frame;
+	unsigned int						Seed;
+	Vector3 *							Position[2];
+	Vector3 *							Velocity;
+	unsigned int *						TimeStamp;
+	Vector3 *							Color;
+	float *								Alpha;
+	float *								Size;
+	PropertyStruct						ColorProp;
+	PropertyStruct						AlphaProp;
+	PropertyStruct						SizeProp;
+};
+
+
+// ----------------------------------------------------------------------------
+//
+// One frame of a buffer. The reference does it the way ParticleBufferClass
+// used to, a particle at a time on Vector3s.
+//
+// ----------------------------------------------------------------------------
+
+static void Respawn(SimBufferStruct & b)
+{
+	b.Time+=FRAME_MS;
+	b.Frame++;
+	while (b.Time-b.TimeStamp[b.Start]>=b.Settings.MaxAge) {
+		b.TimeStamp[b.Start]=b.Time;
+		b.Spawn(b.Start);
+		if (++b.Start==b.MaxNum) b.Start=0;
+	}
+}
+
+static void Reference_Property(const PropertyStruct & prop,float * out,const SimBufferStruct & b,bool clamp)
+{
+	unsigned int key=prop.KeyCount-1;
+	for (unsigned int j=0;j<b.MaxNum;++j) {
+		unsigned int part=(b.Start+j)%b.MaxNum;
+		unsigned int part_age=b.Time-b.TimeStamp[part];
+		for (; part_age<prop.Times[key]; key--);
+
+		if (prop.Components==3) {
+			const Vector3 * values=(const Vector3 *)prop.Values;
+			const Vector3 * deltas=(const Vector3 *)prop.Deltas;
+			const Vector3 * random=(const Vector3 *)prop.Random;
+			((Vector3 *)out)[part]=values[key]+
+				deltas[key]*(float)(part_age-prop.Times[key])+
+				random[part & prop.RandomMask];
+		} else {
+			out[part]=prop.Values[key]+
+				prop.Deltas[key]*(float)(part_age-prop.Times[key])+
+				prop.Random[part & prop.RandomMask];
+			if (clamp) {
+				out[part]=(out[part]>=0.0f) ? out[part] : 0.0f;
+			}
+		}
+	}
+}
+
+static void Reference_Frame(SimBufferStruct & b)
+{
+	Respawn(b);
+
+	float fp_elapsed_time=(float)FRAME_MS;
+	bool has_accel=(b.Settings.Accel.X!=0.0f || b.Settings.Accel.Y!=0.0f || b.Settings.Accel.Z!=0.0f);
+	Vector3 delta_v=b.Settings.Accel*fp_elapsed_time;
+	Vector3 accel_p=b.Settings.Accel*(0.5f*fp_elapsed_time*fp_elapsed_time);
+	int pingpong=b.Settings.PingPong ? (b.Frame & 0x1) : 0;
+	Vector3 * position=b.Position[pingpong];
+	Vector3 * prev_pos=b.Position[pingpong ^ 0x1];
+
+	for (unsigned int i=0;i<b.MaxNum;++i) {
+		if (has_accel) {
+			if (b.Settings.PingPong) {
+				position[i]=prev_pos[i]+b.Velocity[i]*fp_elapsed_time+accel_p;
+			} else {
+				position[i]+=b.Velocity[i]*fp_elapsed_time+accel_p;
+			}
+			b.Velocity[i]+=delta_v;
+		} else {
+			position[i]+=b.Velocity[i]*fp_elapsed_time;
+		}
+	}
+
+	if (!b.ColorProp.Is_Constant()) Reference_Property(b.ColorProp,&b.Color[0].X,b,false);
+	if (!b.AlphaProp.Is_Constant()) Reference_Property(b.AlphaProp,b.Alpha,b,false);
+	if (!b.SizeProp.Is_Constant()) Reference_Property(b.SizeProp,b.Size,b,true);
+}
+
+// Same frame through ParticleKernelClass, as ParticleBufferClass does it now
+static void Kernel_Property(const PropertyStruct & prop,float * out,const SimBufferStruct & b,bool clamp)
+{
+	ParticleKernelClass::KeyTrackStruct track=prop.Get_Track(clamp);
+	unsigned int key=prop.KeyCount-1;
+	ParticleKernelClass::Interpolate(track,out,b.TimeStamp,b.Start,b.MaxNum,b.Time,key);
+	ParticleKernelClass::Interpolate(track,out,b.TimeStamp,0,b.Start,b.Time,key);
+}
+
+static void Kernel_Frame(SimBufferStruct & b)
+{
+	Respawn(b);
+
+	float fp_elapsed_time=(float)FRAME_MS;
+	bool has_accel=(b.Settings.Accel.X!=0.0f || b.Settings.Accel.Y!=0.0f || b.Settings.Accel.Z!=0.0f);
+	Vector3 delta_v=b.Settings.Accel*fp_elapsed_time;
+	Vector3 accel_p=b.Settings.Accel*(0.5f*fp_elapsed_time*fp_elapsed_time);
+	int pingpong=b.Settings.PingPong ? (b.Frame & 0x1) : 0;
+	float * position=&b.Position[pingpong][0].X;
+	const float * prev_pos=(b.Settings.PingPong && has_accel) ? &b.Position[pingpong ^ 0x1][0].X : NULL;
+
+	// The two subranges of the circular buffer
+	unsigned int ranges[2][2]={ { b.Start,b.MaxNum },{ 0,b.Start } };
+	for (int r=0;r<2;++r) {
+		unsigned int first=ranges[r][0];
+		ParticleKernelClass::Integrate(position+first*3,prev_pos ? prev_pos+first*3 : NULL,&b.Velocity[first].X,
+			ranges[r][1]-first,fp_elapsed_time,has_accel ? &accel_p.X : NULL,&delta_v.X);
+	}
+
+	if (!b.ColorProp.Is_Constant()) Kernel_Property(b.ColorProp,&b.Color[0].X,b,false);
+	if (!b.AlphaProp.Is_Constant()) Kernel_Property(b.AlphaProp,b.Alpha,b,false);
+	if (!b.SizeProp.Is_Constant()) Kernel_Property(b.SizeProp,b.Size,b,true);
+}
+
+static void Kernel_Frame_Job(void * data,int index)
+{
+	Kernel_Frame(*((SimBufferStruct **)data)[index]);
+}
+
+static bool Close(const float * a,const float * b,unsigned int count)
+{
+	for (unsigned int i=0;i<count;++i) {
+		float tolerance=1.0e-5f*(1.0f+(float)fabs(a[i]));
+		if (fabs(a[i]-b[i])>tolerance) return false;
+	}
+	return true;
+}
+
+static bool Close(const SimBufferStruct & a,const SimBufferStruct & b)
+{
+	return	a.Start==b.Start &&
+				Close(&a.Position[0][0].X,&b.Position[0][0].X,a.MaxNum*3) &&
+				Close(&a.Position[1][0].X,&b.Position[1][0].X,a.MaxNum*3) &&
+				Close(&a.Velocity[0].X,&b.Velocity[0].X,a.MaxNum*3) &&
+				(a.ColorProp.Is_Constant() || Close(&a.Color[0].X,&b.Color[0].X,a.MaxNum*3)) &&
+				(a.AlphaProp.Is_Constant() || Close(a.Alpha,b.Alpha,a.MaxNum)) &&
+				(a.SizeProp.Is_Constant() || Close(a.Size,b.Size,a.MaxNum));
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// Interpolate() on its own: odd counts, every start alignment, a random table
+// shorter than the range and ages that aren't in order. The reference carries
+// the keyframe along the way the original loop did.
+//
+// ----------------------------------------------------------------------------
+
+static void Test_Interpolate(void)
+{
+	static const unsigned int counts[]={ 0,1,2,3,4,5,7,8,9,15,16,17,31,100,1000 };
+	static const float times[4]={ 0.0f,0.25f,0.5f,0.75f };
+	static const float values[4]={ 1.0f,-2.0f,0.5f,3.0f };
+	PropertySettingsStruct settings;
+	settings.KeyCount=4;
+	memcpy(settings.Times,times,sizeof(times));
+	memcpy(settings.Values,values,sizeof(values));
+	settings.Random=0.5f;
+
+	const unsigned int max_age=1000;
+	const unsigned int current_time=50000;
+	char name[256];
+
+	for (int components=1;components<=3;components+=2) {
+		for (int table=0;table<3;++table) {
+			PropertyStruct prop;
+			prop.Init(settings,components,max_age,table==0 ? 1 : (table==1 ? 16 : 2048));
+
+			for (unsigned int c=0;c<sizeof(counts)/sizeof(counts[0]);++c) {
+				for (int order=0;order<2;++order) {
+					unsigned int first=Random()%20;
+					unsigned int end=first+counts[c];
+					unsigned int * ts=new unsigned int[end+GUARD];
+					for (unsigned int i=0;i<end;++i) {
+						unsigned int age=(end>1) ? (max_age-1)-(unsigned int)((unsigned long long)i*(max_age-1)/(end-1)) : 0;
+						if (order==1 && (Random()&3)==0) {
+							age=Random()%max_age;
+						}
+						ts[i]=current_time-age;
+					}
+
+					float * ref=new float[(end+GUARD)*components];
+					float * scalar=new float[(end+GUARD)*components];
+					float * out=new float[(end+GUARD)*components];
+					memset(scalar,0xcd,sizeof(float)*(end+GUARD)*components);
+					memset(out,0xcd,sizeof(float)*(end+GUARD)*components);
+
+					unsigned int ref_key=prop.KeyCount-1;
+					for (unsigned int i=first;i<end;++i) {
+						unsigned int part_age=current_time-ts[i];
+						for (; part_age<prop.Times[ref_key]; ref_key--);
+						for (int k=0;k<components;++k) {
+							float s=prop.Values[ref_key*components+k]+
+								prop.Deltas[ref_key*components+k]*(float)(part_age-prop.Times[ref_key])+
+								prop.Random[(i & prop.RandomMask)*components+k];
+							ref[i*components+k]=(s>=0.0f) ? s : 0.0f;
+						}
+					}
+
+					ParticleKernelClass::KeyTrackStruct track=prop.Get_Track(true);
+					unsigned int scalar_key=prop.KeyCount-1;
+					ParticleKernelClass::Set_Kernel(ParticleKernelClass::KERNEL_SCALAR);
+					ParticleKernelClass::Interpolate(track,scalar,ts,first,end,current_time,scalar_key);
+					sprintf(name,"interpolate %d components, table %d, %d particles, order %d: scalar matches reference",components,table,counts[c],order);
+					Check(Close(scalar+first*components,ref+first*components,(end-first)*components) && scalar_key==ref_key,name);
+
+					for (int k=ParticleKernelClass::KERNEL_SSE2;k<ParticleKernelClass::KERNEL_BEST;++k) {
+						ParticleKernelClass::Set_Kernel((ParticleKernelClass::KernelType)k);
+						if (ParticleKernelClass::Get_Kernel()!=k) {
+							continue;
+						}
+						unsigned int key=prop.KeyCount-1;
+						ParticleKernelClass::Interpolate(track,out,ts,first,end,current_time,key);
+						sprintf(name,"interpolate %d components, table %d, %d particles, order %d: %s matches scalar",
+							components,table,counts[c],order,Kernel_Name((ParticleKernelClass::KernelType)k));
+						Check(	memcmp(out,scalar,sizeof(float)*(end+GUARD)*components)==0 && key==scalar_key,name);
+					}
+
+					delete [] ts;
+					delete [] ref;
+					delete [] scalar;
+					delete [] out;
+				}
+			}
+		}
+	}
+
+	ParticleKernelClass::Set_Kernel(ParticleKernelClass::KERNEL_BEST);
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// Whole buffers for a number of frames, every emitter type and kernel
+//
+// ----------------------------------------------------------------------------
+
+static void Test_Emitters(void)
+{
+	char name[256];
+
+	for (int e=0;e<EMITTER_COUNT;++e) {
+		EmitterSettingsStruct settings=Emitters[e];
+		const unsigned int sizes[]={ 1,7,33,settings.BufferSize };
+		for (unsigned int s=0;s<sizeof(sizes)/sizeof(sizes[0]);++s) {
+			settings.BufferSize=sizes[s];
+			SimBufferStruct reference(settings);
+			SimBufferStruct scalar(settings);
+			SimBufferStruct buffer(settings);
+			scalar.Copy(reference);
+
+			ParticleKernelClass::Set_Kernel(ParticleKernelClass::KERNEL_SCALAR);
+			for (int f=0;f<TEST_FRAMES;++f) {
+				Reference_Frame(reference);
+				Kernel_Frame(scalar);
+			}
+			sprintf(name,"%s, %d particles: scalar matches reference",Emitters[e].Name,sizes[s]);
+			Check(Close(scalar,reference),name);
+
+			for (int k=ParticleKernelClass::KERNEL_SSE2;k<ParticleKernelClass::KERNEL_BEST;++k) {
+				ParticleKernelClass::Set_Kernel((ParticleKernelClass::KernelType)k);
+				if (ParticleKernelClass::Get_Kernel()!=k) {
+					continue;
+				}
+
+				SimBufferStruct start(settings);
+				scalar.Copy(start);
+				buffer.Copy(start);
+				for (int f=0;f<TEST_FRAMES;++f) {
+					ParticleKernelClass::Set_Kernel(ParticleKernelClass::KERNEL_SCALAR);
+					Kernel_Frame(scalar);
+					ParticleKernelClass::Set_Kernel((ParticleKernelClass::KernelType)k);
+					Kernel_Frame(buffer);
+				}
+				sprintf(name,"%s, %d particles: %s matches scalar",Emitters[e].Name,sizes[s],Kernel_Name((ParticleKernelClass::KernelType)k));
+				Check(buffer.Same(scalar),name);
+				sprintf(name,"%s, %d particles: %s stays in bounds",Emitters[e].Name,sizes[s],Kernel_Name((ParticleKernelClass::KernelType)k));
+				Check(buffer.Guard_Intact(),name);
+			}
+		}
+	}
+
+	ParticleKernelClass::Set_Kernel(ParticleKernelClass::KERNEL_BEST);
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// 100k particles in a scene full of emitters. Each buffer is updated by one
+// job, like ParticleBufferClass::Update_Particle_Buffers() does it, and the
+// result must not depend on which thread ran it.
+//
+// ----------------------------------------------------------------------------
+
+static void Time_Scene(void)
+{
+	int buffer_count=0;
+	unsigned int particle_count=0;
+	for (int e=0;e<EMITTER_COUNT;++e) {
+		buffer_count+=Emitters[e].BufferCount;
+		particle_count+=Emitters[e].BufferCount*Emitters[e].BufferSize;
+	}
+
+	SimBufferStruct ** serial=new SimBufferStruct *[buffer_count];
+	SimBufferStruct ** parallel=new SimBufferStruct *[buffer_count];
+	int index=0;
+	for (int e=0;e<EMITTER_COUNT;++e) {
+		for (int i=0;i<Emitters[e].BufferCount;++i,++index) {
+			serial[index]=new SimBufferStruct(Emitters[e]);
+			parallel[index]=new SimBufferStruct(Emitters[e]);
+			parallel[index]->Copy(*serial[index]);
+		}
+	}
+
+	printf("\n%d particles in %d buffers, %d worker threads\n",particle_count,buffer_count,WorkerPoolClass::Get_Thread_Count());
+	LARGE_INTEGER begin,end;
+
+	QueryPerformanceCounter(&begin);
+	for (int pass=0;pass<PASSES;++pass) {
+		for (int i=0;i<buffer_count;++i) {
+			Reference_Frame(*serial[i]);
+		}
+	}
+	QueryPerformanceCounter(&end);
+	double reference_time=Seconds(begin,end)/PASSES;
+	printf("  reference:        %7.3f ms/frame\n",reference_time*1000.0);
+
+	for (int k=ParticleKernelClass::KERNEL_SCALAR;k<ParticleKernelClass::KERNEL_BEST;++k) {
+		ParticleKernelClass::Set_Kernel((ParticleKernelClass::KernelType)k);
+		if (ParticleKernelClass::Get_Kernel()!=k) {
+			continue;
+		}
+
+		// Every kernel starts from the same state
+		for (int i=0;i<buffer_count;++i) {
+			serial[i]->Copy(*parallel[i]);
+		}
+
+		QueryPerformanceCounter(&begin);
+		for (int pass=0;pass<PASSES;++pass) {
+			for (int i=0;i<buffer_count;++i) {
+				Kernel_Frame(*serial[i]);
+			}
+		}
+		QueryPerformanceCounter(&end);
+		double serial_time=Seconds(begin,end)/PASSES;
+
+		printf("  %-8s serial:  %7.3f ms/frame (%.2fx, %.1f Mparticles/s)\n",
+			Kernel_Name((ParticleKernelClass::KernelType)k),
+			serial_time*1000.0,
+			reference_time/serial_time,
+			particle_count/serial_time/1.0e6);
+	}
+
+	// The last kernel again, one job per buffer across the workers
+	QueryPerformanceCounter(&begin);
+	for (int pass=0;pass<PASSES;++pass) {
+		WorkerPoolClass::Parallel_For(Kernel_Frame_Job,parallel,buffer_count);
+	}
+	QueryPerformanceCounter(&end);
+	double parallel_time=Seconds(begin,end)/PASSES;
+	printf("  %-8s workers: %7.3f ms/frame (%.2fx, %.1f Mparticles/s)\n",
+		Kernel_Name(ParticleKernelClass::Get_Kernel()),
+		parallel_time*1000.0,
+		reference_time/parallel_time,
+		particle_count/parallel_time/1.0e6);
+
+	bool same=true;
+	for (int i=0;i<buffer_count;++i) {
+		same=same && parallel[i]->Same(*serial[i]);
+	}
+	Check(same,"scene: workers match serial");
+
+	ParticleKernelClass::Set_Kernel(ParticleKernelClass::KERNEL_BEST);
+
+	for (int i=0;i<buffer_count;++i) {
+		delete serial[i];
+		delete parallel[i];
+	}
+	delete [] serial;
+	delete [] parallel;
+}
+
+int main(int argc,char * argv[])
+{
+	// No worker threads first, then the real pool
+	WorkerPoolClass::Init(0);
+	Test_Interpolate();
+	Test_Emitters();
+	WorkerPoolClass::Shutdown();
+
+	WorkerPoolClass::Init();
+	Test_Interpolate();
+	Test_Emitters();
+	Time_Scene();
+	WorkerPoolClass::Shutdown();
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,329 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Physics Timestep Benchmark                                   *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/physbench/main.cpp                     $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Runs a headless PhysicsSceneClass with hundreds of rigid body "vehicles" dropped in small  *
+ * piles and walking HumanPhysClass "soldiers" on a flat box, and reports the time spent      *
+ * stepping the objects per frame along with how PhysIslandSchedulerClass splits them into    *
+ * islands of objects that could touch.                                                        *
+ *                                                                                             *
+ * The scene is run once per island seed. Seed 0 steps the objects with                       *
+ * PhysicsSceneClass::Update; the others step the same objects island by island in a shuffled *
+ * order. Objects in different islands can't touch during a step, so every seed must leave    *
+ * every object in exactly the same state.                                                    *
+ *                                                                                             *
+ * Arguments: [vehicle count] [soldier count] [frames]                                         *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "pscene.h"
+#include "rbody.h"
+#include "humanphys.h"
+#include "staticphys.h"
+#include "physcontrol.h"
+#include "wwphys.h"
+#include "boxrobj.h"
+#include "assetmgr.h"
+#include "coltype.h"
+#include "simplevec.h"
+#include "physisland.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const float FRAME_TIME=1.0f/30.0f;				// one substep of PhysicsSceneClass::Update
+const int PILE_SIZE=4;						// vehicles per pile
+const float PILE_SPACING=12.0f;
+const float SOLDIER_SPACING=4.0f;
+
+static int VehicleCount=300;
+static int SoldierCount=300;
+static int FrameCount=300;
+
+static int Failures=0;
+
+WW3DAssetManager The3DAssetManager;
+
+// Objects keep a pointer to their definition, and the rigid body reads its drag and collision
+// settings from it every step.  The defaults are fine here.
+static RigidBodyDefClass	VehicleDef;
+static HumanPhysDefClass	SoldierDef;
+static StaticPhysDefClass	GroundDef;
+
+// ----------------------------------------------------------------------------
+//
+// The final state of every object, in the order they were created
+//
+// ----------------------------------------------------------------------------
+
+struct ObjectStateStruct
+{
+	Matrix3D			Transform;
+	Vector3			Velocity;
+};
+
+struct RunResultStruct
+{
+	double			MsPerFrame;
+	double			WorstMs;
+	int				IslandsPerStep;
+	int				ObjectsPerStep;
+	int				LargestIsland;
+	SimpleDynVecClass<ObjectStateStruct>	States;
+};
+
+// ----------------------------------------------------------------------------
+
+static OBBoxRenderObjClass * Create_Box_Model(const Vector3 & center,const Vector3 & extent)
+{
+	OBBoxRenderObjClass * box=new OBBoxRenderObjClass(OBBoxClass(center,extent));
+	box->Set_Collision_Type(COLLISION_TYPE_PHYSICAL);
+	return box;
+}
+
+static void Build_Scene(PhysicsSceneClass * scene,SimpleDynVecClass<MoveablePhysClass *> & objects,PhysControllerClass * controllers)
+{
+	/*
+	** Ground
+	*/
+	float half_size=PILE_SPACING*(float)(sqrt((double)VehicleCount/PILE_SIZE)+2.0)+SOLDIER_SPACING*(float)(sqrt((double)SoldierCount)+2.0);
+	OBBoxRenderObjClass * ground_model=Create_Box_Model(Vector3(0,0,-1),Vector3(half_size,half_size,1));
+	StaticPhysClass * ground=NEW_REF(StaticPhysClass,());
+	ground->Init(GroundDef);
+	ground->Set_Model(ground_model);
+	scene->Add_Static_Object(ground);
+	ground->Release_Ref();
+	ground_model->Release_Ref();
+
+	/*
+	** Vehicles, in piles of four dropped a little above the ground so that each pile
+	** lands and settles as one island
+	*/
+	int piles=(VehicleCount+PILE_SIZE-1)/PILE_SIZE;
+	int row=(int)sqrt((double)piles)+1;
+	for (int i=0;i<VehicleCount;++i) {
+		int pile=i/PILE_SIZE;
+		int slot=i%PILE_SIZE;
+		Vector3 pos(-half_size*0.5f+PILE_SPACING*(pile%row),-half_size*0.5f+PILE_SPACING*(pile/row),1.5f);
+		pos.X+=(slot&1) ? 1.2f : -1.2f;
+		pos.Y+=(slot&2) ? 0.3f : -0.3f;
+		pos.Z+=2.5f*(slot>>1);
+
+		OBBoxRenderObjClass * model=Create_Box_Model(Vector3(0,0,0),Vector3(1,1,1));
+		RigidBodyClass * vehicle=NEW_REF(RigidBodyClass,());
+		vehicle->Init(VehicleDef);
+		vehicle->Set_Model(model);
+		vehicle->Set_Mass(1000.0f);
+		Matrix3D tm(1);
+		tm.Rotate_Z(0.1f*slot);
+		tm.Set_Translation(pos);
+		vehicle->Set_Transform(tm);
+		vehicle->Set_Velocity(Vector3(0.5f*(slot-1.5f),0,0));
+		scene->Add_Dynamic_Object(vehicle);
+		objects.Add(vehicle);
+		model->Release_Ref();
+	}
+
+	/*
+	** Soldiers walk in columns next to the vehicle piles
+	*/
+	row=(int)sqrt((double)SoldierCount)+1;
+	for (int i=0;i<SoldierCount;++i) {
+		Vector3 pos(half_size*0.5f+SOLDIER_SPACING*(i%row),-half_size*0.5f+SOLDIER_SPACING*(i/row),0.05f);
+
+		OBBoxRenderObjClass * model=Create_Box_Model(Vector3(0,0,1),Vector3(0.4f,0.4f,1));
+		HumanPhysClass * soldier=NEW_REF(HumanPhysClass,());
+		soldier->Init(SoldierDef);
+		soldier->Set_Model(model);
+		soldier->Set_Position(pos);
+		soldier->Set_Heading(((i*7)%16)*DEG_TO_RADF(22.5f));
+
+		controllers[i].Set_Move_Forward(((i%3)==0) ? 0.0f : 1.0f);
+		controllers[i].Set_Turn_Left(((i%5)==0) ? 0.5f : 0.0f);
+		soldier->Set_Controller(&controllers[i]);
+
+		scene->Add_Dynamic_Object(soldier);
+		objects.Add(soldier);
+		model->Release_Ref();
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// The timestep part of PhysicsSceneClass::Update, island by island. The rest
+// of Update doesn't touch these objects.
+//
+// ----------------------------------------------------------------------------
+
+static void Step_Islands(PhysIslandSchedulerClass & scheduler,SimpleDynVecClass<MoveablePhysClass *> & objects)
+{
+	for (int island=0;island<scheduler.Get_Island_Count();++island) {
+		for (int i=0;i<scheduler.Get_Island_Size(island);++i) {
+			PhysClass * obj=scheduler.Peek_Island_Object(island,i);
+			if ((obj!=NULL) && obj->Is_Object_Simulating()) {
+				obj->Timestep(FRAME_TIME);
+			}
+		}
+	}
+	for (int i=0;i<objects.Count();++i) {
+		if (objects[i]->Is_Object_Simulating()) {
+			objects[i]->Post_Timestep_Process();
+		}
+	}
+}
+
+static void Run(unsigned seed,RunResultStruct & result)
+{
+	PhysicsSceneClass * scene=NEW_REF(PhysicsSceneClass,());
+	PhysIslandSchedulerClass scheduler;
+	scheduler.Set_Seed(seed);
+
+	SimpleDynVecClass<MoveablePhysClass *> objects;
+	PhysControllerClass * controllers=new PhysControllerClass[SoldierCount];
+	Build_Scene(scene,objects,controllers);
+
+	LARGE_INTEGER freq,begin,end;
+	QueryPerformanceFrequency(&freq);
+
+	double total=0.0;
+	int object_total=0;
+	int island_total=0;
+	result.WorstMs=0.0;
+	result.LargestIsland=0;
+
+	for (int frame=0;frame<FrameCount;++frame) {
+
+		/*
+		** Build the islands every frame, even when the scene steps the objects, so
+		** the statistics are the same for every seed
+		*/
+		scheduler.Reset();
+		for (int i=0;i<objects.Count();++i) {
+			if (objects[i]->Is_Object_Simulating()) {
+				scheduler.Add_Object(objects[i]);
+			}
+		}
+		scheduler.Build_Islands(FRAME_TIME);
+		object_total+=scheduler.Get_Object_Count();
+		island_total+=scheduler.Get_Island_Count();
+		result.LargestIsland=MAX(result.LargestIsland,scheduler.Get_Largest_Island_Size());
+
+		QueryPerformanceCounter(&begin);
+		if (seed==0) {
+			scene->Update(FRAME_TIME,frame);
+		} else {
+			Step_Islands(scheduler,objects);
+		}
+		QueryPerformanceCounter(&end);
+		scheduler.Reset();
+
+		double ms=double(end.QuadPart-begin.QuadPart)*1000.0/double(freq.QuadPart);
+		total+=ms;
+		result.WorstMs=MAX(result.WorstMs,ms);
+	}
+	result.MsPerFrame=total/FrameCount;
+	result.ObjectsPerStep=object_total/FrameCount;
+	result.IslandsPerStep=island_total/FrameCount;
+
+	result.States.Delete_All();
+	for (int i=0;i<objects.Count();++i) {
+		ObjectStateStruct state;
+		memset(&state,0,sizeof(state));
+		state.Transform=objects[i]->Get_Transform();
+		objects[i]->Get_Velocity(&state.Velocity);
+		result.States.Add(state);
+
+		scene->Remove_Object(objects[i]);
+		objects[i]->Release_Ref();
+	}
+
+	scene->Remove_All();
+	scene->Release_Ref();
+	delete [] controllers;
+}
+
+static void Compare(const char * name,const RunResultStruct & a,const RunResultStruct & b)
+{
+	if (a.States.Count()!=b.States.Count()) {
+		printf("%s: object counts differ FAILED\n",name);
+		Failures++;
+		return;
+	}
+
+	int mismatches=0;
+	for (int i=0;i<a.States.Count();++i) {
+		if (memcmp(&a.States[i],&b.States[i],sizeof(ObjectStateStruct))!=0) {
+			if (mismatches++<10) {
+				const Vector3 & pa=a.States[i].Transform.Get_Translation();
+				const Vector3 & pb=b.States[i].Transform.Get_Translation();
+				printf("%s: object %d at (%f,%f,%f) vs (%f,%f,%f)\n",name,i,pa.X,pa.Y,pa.Z,pb.X,pb.Y,pb.Z);
+			}
+		}
+	}
+	if (mismatches) {
+		printf("%s: %d objects ended in different states FAILED\n",name,mismatches);
+		Failures++;
+	}
+}
+
+int main(int argc,char * argv[])
+{
+	if (argc>1) VehicleCount=atoi(argv[1]);
+	if (argc>2) SoldierCount=atoi(argv[2]);
+	if (argc>3) FrameCount=atoi(argv[3]);
+	if ((VehicleCount<0) || (SoldierCount<0) || (FrameCount<=0)) {
+		printf("usage: physbench [vehicle count] [soldier count] [frames]\n");
+		return 1;
+	}
+
+	WWPhys::Init();
+
+	static const unsigned seeds[]={ 0, 0, 0x1234, 0xbeef };
+	const int seed_count=sizeof(seeds)/sizeof(seeds[0]);
+	RunResultStruct results[seed_count];
+
+	printf("%d vehicles, %d soldiers, %d frames of %.1f ms\n\n",VehicleCount,SoldierCount,FrameCount,FRAME_TIME*1000.0f);
+	printf("%-10s %12s %12s %10s %10s %10s\n","seed","ms/frame","worst ms","objects","islands","largest");
+
+	for (int i=0;i<seed_count;++i) {
+		Run(seeds[i],results[i]);
+		printf("%-10x %12.3f %12.3f %10d %10d %10d\n",seeds[i],results[i].MsPerFrame,results[i].WorstMs,results[i].ObjectsPerStep,results[i].IslandsPerStep,results[i].LargestIsland);
+	}
+	printf("\n");
+
+	Compare("repeat run",results[0],results[1]);
+	for (int i=2;i<seed_count;++i) {
+		char name[32];
+		sprintf(name,"seed %x",seeds[i]);
+		Compare(name,results[0],results[i]);
+	}
+
+	WWPhys::Shutdown();
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
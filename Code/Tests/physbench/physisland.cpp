@@ -0,0 +1,382 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Physics Timestep Benchmark                                   *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/physbench/physisland.cpp               $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   PhysIslandSchedulerClass::PhysIslandSchedulerClass -- Constructor                         *
+ *   PhysIslandSchedulerClass::~PhysIslandSchedulerClass -- Destructor                         *
+ *   PhysIslandSchedulerClass::Set_Seed -- Sets the seed used to order the islands             *
+ *   PhysIslandSchedulerClass::Reset -- Releases all objects                                   *
+ *   PhysIslandSchedulerClass::Add_Object -- Adds an object to be scheduled                    *
+ *   PhysIslandSchedulerClass::Build_Islands -- Groups the objects into islands                *
+ *   PhysIslandSchedulerClass::Remove_Object -- Flags an object which has left the scene       *
+ *   PhysIslandSchedulerClass::Get_Island_Size -- Returns the number of objects in an island   *
+ *   PhysIslandSchedulerClass::Peek_Island_Object -- Returns an object in an island            *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "physisland.h"
+#include "phys.h"
+#include "movephys.h"
+#include "wwdebug.h"
+#include <stdlib.h>
+
+
+/*
+** Swept boxes are grown by this much so that objects which come to rest against each
+** other (and so have a contact but no closing velocity) still end up in one island.
+*/
+const float ISLAND_MARGIN = 0.25f;
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::PhysIslandSchedulerClass -- Constructor                           *
+ *=============================================================================================*/
+PhysIslandSchedulerClass::PhysIslandSchedulerClass(void) :
+	Seed(0),
+	RandomState(0),
+	IslandCount(0),
+	LargestIsland(0)
+{
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::~PhysIslandSchedulerClass -- Destructor                           *
+ *=============================================================================================*/
+PhysIslandSchedulerClass::~PhysIslandSchedulerClass(void)
+{
+	Reset();
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::Set_Seed -- Sets the seed used to order the islands               *
+ *                                                                                             *
+ * Zero keeps the islands in the order of their first object.  Any other value restarts the    *
+ * shuffle sequence so that two runs with the same seed visit the islands in the same order.   *
+ *=============================================================================================*/
+void PhysIslandSchedulerClass::Set_Seed(unsigned seed)
+{
+	Seed = seed;
+	RandomState = seed;
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::Reset -- Releases all objects                                     *
+ *=============================================================================================*/
+void PhysIslandSchedulerClass::Reset(void)
+{
+	for (int i=0; i<Objects.Count(); i++) {
+		Objects[i].Obj->Release_Ref();
+	}
+	Objects.Delete_All(false);
+	Lookup.Delete_All(false);
+	IslandCount = 0;
+	LargestIsland = 0;
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::Add_Object -- Adds an object to be scheduled                      *
+ *=============================================================================================*/
+void PhysIslandSchedulerClass::Add_Object(PhysClass * obj)
+{
+	WWASSERT(obj != NULL);
+	obj->Add_Ref();
+
+	ObjectStruct * entry = Objects.Add_Multiple(1);
+	entry->Obj = obj;
+	entry->Parent = Objects.Count() - 1;
+	entry->Island = -1;
+	entry->Removed = false;
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::Build_Islands -- Groups the objects into islands                  *
+ *                                                                                             *
+ * The swept boxes are sorted on their minimum x and swept for overlaps, joining overlapping  *
+ * objects with a union-find whose root is always the lowest index in the set.                 *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * dt - length of the step the objects are about to take                                     *
+ *=============================================================================================*/
+void PhysIslandSchedulerClass::Build_Islands(float dt)
+{
+	int count = Objects.Count();
+	int i,j;
+
+	/*
+	** Compute the swept boxes
+	*/
+	Sorted.Delete_All(false);
+	Sorted.Add_Multiple(count);
+	Lookup.Delete_All(false);
+	Lookup.Add_Multiple(count);
+
+	for (i=0; i<count; i++) {
+		ObjectStruct & entry = Objects[i];
+		const AABoxClass & box = entry.Obj->Get_Cull_Box();
+		entry.Min = box.Center - box.Extent;
+		entry.Max = box.Center + box.Extent;
+		entry.Parent = i;
+
+		MoveablePhysClass * moveable = entry.Obj->As_MoveablePhysClass();
+		if (moveable != NULL) {
+			Vector3 move;
+			moveable->Get_Velocity(&move);
+			move *= dt;
+			for (j=0; j<3; j++) {
+				if (move[j] < 0.0f) {
+					entry.Min[j] += move[j];
+				} else {
+					entry.Max[j] += move[j];
+				}
+			}
+		}
+		entry.Min -= Vector3(ISLAND_MARGIN,ISLAND_MARGIN,ISLAND_MARGIN);
+		entry.Max += Vector3(ISLAND_MARGIN,ISLAND_MARGIN,ISLAND_MARGIN);
+
+		Sorted[i].MinX = entry.Min.X;
+		Sorted[i].Index = i;
+		Lookup[i].Obj = entry.Obj;
+		Lookup[i].Index = i;
+	}
+
+	if (count > 1) {
+		qsort(&Lookup[0],count,sizeof(LookupStruct),Lookup_Compare);
+	}
+
+	/*
+	** Riders always move with their carrier
+	*/
+	for (i=0; i<count; i++) {
+		MoveablePhysClass * moveable = Objects[i].Obj->As_MoveablePhysClass();
+		PhysClass * carrier = (moveable != NULL) ? moveable->Peek_Carrier_Object() : NULL;
+		if (carrier != NULL) {
+			j = Find_Object(carrier);
+			if (j != -1) {
+				Join(i,j);
+			}
+		}
+	}
+
+	/*
+	** Sweep and prune along x
+	*/
+	if (count > 1) {
+		qsort(&Sorted[0],count,sizeof(SortStruct),Sort_Compare);
+	}
+
+	for (i=0; i<count; i++) {
+		const ObjectStruct & a = Objects[Sorted[i].Index];
+		for (j=i+1; (j<count) && (Sorted[j].MinX <= a.Max.X); j++) {
+			const ObjectStruct & b = Objects[Sorted[j].Index];
+			if (	(a.Min.Y <= b.Max.Y) && (b.Min.Y <= a.Max.Y) &&
+					(a.Min.Z <= b.Max.Z) && (b.Min.Z <= a.Max.Z))
+			{
+				Join(Sorted[i].Index,Sorted[j].Index);
+			}
+		}
+	}
+
+	/*
+	** Number the islands in the order of their root.  Since the root is the lowest index,
+	** it is always seen before the rest of its island.
+	*/
+	IslandCount = 0;
+	IslandStart.Delete_All(false);
+	for (i=0; i<count; i++) {
+		int root = Find_Root(i);
+		if (root == i) {
+			Objects[i].Island = IslandCount++;
+			IslandStart.Add(0);
+		} else {
+			Objects[i].Island = Objects[root].Island;
+		}
+		IslandStart[Objects[i].Island]++;
+	}
+	IslandStart.Add(0);
+
+	/*
+	** Turn the sizes into start positions and place the objects, which keeps each island
+	** in add order.
+	*/
+	LargestIsland = 0;
+	int start = 0;
+	for (i=0; i<IslandCount; i++) {
+		int size = IslandStart[i];
+		LargestIsland = MAX(LargestIsland,size);
+		IslandStart[i] = start;
+		start += size;
+	}
+	IslandStart[IslandCount] = start;
+
+	IslandObjects.Delete_All(false);
+	IslandObjects.Add_Multiple(count);
+	Sorted.Delete_All(false);
+	Sorted.Add_Multiple(IslandCount);
+	for (i=0; i<IslandCount; i++) {
+		Sorted[i].Index = IslandStart[i];		// re-used as the fill position of each island
+	}
+	for (i=0; i<count; i++) {
+		IslandObjects[Sorted[Objects[i].Island].Index++] = i;
+	}
+
+	/*
+	** Order the islands
+	*/
+	IslandOrder.Delete_All(false);
+	IslandOrder.Add_Multiple(IslandCount);
+	for (i=0; i<IslandCount; i++) {
+		IslandOrder[i] = i;
+	}
+	if (Seed != 0) {
+		for (i=IslandCount-1; i>0; i--) {
+			j = Next_Random() % (i+1);
+			int tmp = IslandOrder[i];
+			IslandOrder[i] = IslandOrder[j];
+			IslandOrder[j] = tmp;
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::Remove_Object -- Flags an object which has left the scene         *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * obj - object which was removed, it doesn't have to be in the schedule                      *
+ *=============================================================================================*/
+void PhysIslandSchedulerClass::Remove_Object(PhysClass * obj)
+{
+	int index = Find_Object(obj);
+	if (index != -1) {
+		Objects[index].Removed = true;
+	}
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::Get_Island_Size -- Returns the number of objects in an island     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * island - position of the island in the schedule                                            *
+ *=============================================================================================*/
+int PhysIslandSchedulerClass::Get_Island_Size(int island) const
+{
+	WWASSERT((island >= 0) && (island < IslandCount));
+	int index = IslandOrder[island];
+	return IslandStart[index+1] - IslandStart[index];
+}
+
+
+/***********************************************************************************************
+ * PhysIslandSchedulerClass::Peek_Island_Object -- Returns an object in an island              *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * island - position of the island in the schedule                                            *
+ * index - which object in the island                                                         *
+ *=============================================================================================*/
+PhysClass * PhysIslandSchedulerClass::Peek_Island_Object(int island,int index) const
+{
+	WWASSERT((index >= 0) && (index < Get_Island_Size(island)));
+	const ObjectStruct & entry = Objects[IslandObjects[IslandStart[IslandOrder[island]] + index]];
+	return entry.Removed ? NULL : entry.Obj;
+}
+
+
+int PhysIslandSchedulerClass::Find_Object(PhysClass * obj) const
+{
+	int lo = 0;
+	int hi = Lookup.Count() - 1;
+	while (lo <= hi) {
+		int mid = (lo + hi) / 2;
+		if (Lookup[mid].Obj == obj) {
+			return Lookup[mid].Index;
+		} else if (Lookup[mid].Obj < obj) {
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+	return -1;
+}
+
+
+int PhysIslandSchedulerClass::Find_Root(int index)
+{
+	int root = index;
+	while (Objects[root].Parent != root) {
+		root = Objects[root].Parent;
+	}
+	while (Objects[index].Parent != root) {
+		int next = Objects[index].Parent;
+		Objects[index].Parent = root;
+		index = next;
+	}
+	return root;
+}
+
+
+void PhysIslandSchedulerClass::Join(int a,int b)
+{
+	a = Find_Root(a);
+	b = Find_Root(b);
+	if (a < b) {
+		Objects[b].Parent = a;
+	} else if (b < a) {
+		Objects[a].Parent = b;
+	}
+}
+
+
+unsigned PhysIslandSchedulerClass::Next_Random(void)
+{
+	RandomState = RandomState * 1664525 + 1013904223;
+	return RandomState >> 8;
+}
+
+
+int PhysIslandSchedulerClass::Sort_Compare(const void * a,const void * b)
+{
+	const SortStruct * sa = (const SortStruct *)a;
+	const SortStruct * sb = (const SortStruct *)b;
+	if (sa->MinX < sb->MinX) return -1;
+	if (sa->MinX > sb->MinX) return 1;
+	return sa->Index - sb->Index;
+}
+
+
+int PhysIslandSchedulerClass::Lookup_Compare(const void * a,const void * b)
+{
+	const LookupStruct * la = (const LookupStruct *)a;
+	const LookupStruct * lb = (const LookupStruct *)b;
+	if (la->Obj < lb->Obj) return -1;
+	if (la->Obj > lb->Obj) return 1;
+	return 0;
+}
@@ -0,0 +1,141 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Physics Timestep Benchmark                                   *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/physbench/physisland.h                 $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef PHYSISLAND_H
+#define PHYSISLAND_H
+
+#include "always.h"
+#include "vector3.h"
+#include "simplevec.h"
+
+class PhysClass;
+
+
+/**
+** PhysIslandSchedulerClass
+** Groups the objects that are about to be timestepped into "islands" of objects which could
+** touch during the step.  Each object's cull box is swept by its velocity over the step; any
+** two objects whose swept boxes overlap, and any rider and its carrier, end up in the same
+** island.  Objects in different islands cannot affect each other during the step.
+**
+** The schedule only depends on the order the objects were added in and on the seed.  Islands
+** are ordered by their first object and the objects in an island keep their add order.  A
+** non-zero seed shuffles the island order with a fixed generator, which is a cheap way to
+** check that the result of a step doesn't depend on the island order.
+**
+** This is a measuring tool for the benchmark, not part of the scene's timestep.  It shows how
+** the objects would split up for a parallel stepper and checks that the island order doesn't
+** matter, but PhysClass::Timestep still can't run on more than one thread at a time: moving an
+** object re-links it in the culling systems and observers call back into game code.
+*/
+class PhysIslandSchedulerClass
+{
+public:
+
+	PhysIslandSchedulerClass(void);
+	~PhysIslandSchedulerClass(void);
+
+	void					Set_Seed(unsigned seed);
+	unsigned				Get_Seed(void) const											{ return Seed; }
+
+	/*
+	** Building the schedule.  The scheduler holds a reference to each object until Reset.
+	*/
+	void					Reset(void);
+	void					Add_Object(PhysClass * obj);
+	void					Build_Islands(float dt);
+
+	/*
+	** Flags an object that has left the scene so that it won't be handed out again
+	*/
+	void					Remove_Object(PhysClass * obj);
+
+	/*
+	** Walking the schedule
+	*/
+	int					Get_Object_Count(void) const								{ return Objects.Count(); }
+	int					Get_Island_Count(void) const								{ return IslandCount; }
+	int					Get_Island_Size(int island) const;
+	PhysClass *			Peek_Island_Object(int island,int index) const;		// NULL once removed
+	int					Get_Largest_Island_Size(void) const						{ return LargestIsland; }
+
+protected:
+
+	int					Find_Object(PhysClass * obj) const;
+	int					Find_Root(int index);
+	void					Join(int a,int b);
+	unsigned				Next_Random(void);
+
+	struct ObjectStruct
+	{
+		PhysClass *		Obj;
+		Vector3			Min;
+		Vector3			Max;
+		int				Parent;
+		int				Island;
+		bool				Removed;
+	};
+
+	struct SortStruct
+	{
+		float				MinX;
+		int				Index;
+	};
+
+	struct LookupStruct
+	{
+		PhysClass *		Obj;
+		int				Index;
+	};
+
+	static int			Sort_Compare(const void * a,const void * b);
+	static int			Lookup_Compare(const void * a,const void * b);
+
+	unsigned									Seed;
+	unsigned									RandomState;
+
+	SimpleDynVecClass<ObjectStruct>	Objects;
+	SimpleDynVecClass<SortStruct>		Sorted;
+	SimpleDynVecClass<LookupStruct>	Lookup;			// objects sorted by address
+	SimpleDynVecClass<int>				IslandStart;		// first entry in IslandObjects, plus one past the end
+	SimpleDynVecClass<int>				IslandOrder;		// island number for each position in the schedule
+	SimpleDynVecClass<int>				IslandObjects;		// object indices grouped by island
+	int										IslandCount;
+	int										LargestIsland;
+
+private:
+
+	// not implemented
+	PhysIslandSchedulerClass(const PhysIslandSchedulerClass &);
+	PhysIslandSchedulerClass & operator = (const PhysIslandSchedulerClass &);
+};
+
+
+#endif //PHYSISLAND_H
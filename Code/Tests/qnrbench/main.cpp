@@ -0,0 +1,619 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : GameSpy Query Load Test                                      *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/qnrbench/main.cpp                      $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Sends thousands of server browser queries over loopback from many source addresses to a    *
+ * simulated server and measures the time its main thread spends on them: first the old way   *
+ * (the main loop reads the socket and builds every response from the game state), then with  *
+ * cGameSpyQueryResponder answering from responses rebuilt only when the state changes.       *
+ * Both must send the same responses. A second run floods the responder from one address and  *
+ * checks the rate limit drops the flood but not the well behaved sources.                    *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "GameSpy_QueryResponder.h"
+#include "wwstring.h"
+#include "widestring.h"
+#include "trim.h"
+#include "thread.h"
+#include <windows.h>
+#include <winsock.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const int SERVER_PORT=25300;
+const int SOURCE_COUNT=16;
+const int QUERY_COUNT=20000;
+const int MAX_OUTSTANDING=8;		// per source, so the socket buffers never overflow
+const int PLAYER_COUNT=32;
+const int STATE_CHANGE_FRAMES=200;	// a player joins or leaves this often
+
+static int Failures=0;
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+static SOCKADDR_IN Make_Address(const char * ip,int port)
+{
+	SOCKADDR_IN addr;
+	memset(&addr,0,sizeof(addr));
+	addr.sin_family=AF_INET;
+	addr.sin_addr.s_addr=inet_addr(ip);
+	addr.sin_port=htons((USHORT)port);
+	return addr;
+}
+
+// ----------------------------------------------------------------------------
+//
+// The game state the responses report, and the response builders from
+// CGameSpyQnR.
+//
+// ----------------------------------------------------------------------------
+
+struct PlayerStruct
+{
+	WideStringClass	Name;
+	bool					Active;
+};
+
+static PlayerStruct		Players[PLAYER_COUNT];
+static WideStringClass	GameTitle(L"Renegade Load Test Server - All Welcome");
+static StringClass		MapName("C&C_Walls_Flying.mix");
+static int					MaxPlayers=PLAYER_COUNT;
+
+static void Append_InfoKey_Pair(char * outbuf,int maxlen,const char * key,const char * value)
+{
+	int clen=strlen(outbuf);
+	if (clen+strlen(key)+strlen(value)+3>(unsigned int)maxlen) return;
+
+	char * s=new char[strlen(value)+1];
+	strcpy(s,value);
+	for (char * t=s;*t;t++) {
+		if (*t=='\\') *t='/';
+	}
+	sprintf(&outbuf[clen],"\\%s\\%s",key,strtrim(s));
+	delete [] s;
+}
+
+static void Build_Basic(char * outbuf,int maxlen)
+{
+	StringClass b(true);
+	b.Format("%d",4242);
+	sprintf(outbuf,"\\gamename\\%s\\gamever\\%s","ccrenegade",b.Peek_Buffer());
+}
+
+static void Build_Info(char * outbuf,int maxlen)
+{
+	outbuf[0]=0;
+	StringClass value(true);
+
+	GameTitle.Convert_To(value);
+	if (value.Get_Length()>25) {
+		value[25]=0;
+	}
+	Append_InfoKey_Pair(outbuf,maxlen,"hostname",value);
+	value.Format("%d",4848);
+	Append_InfoKey_Pair(outbuf,maxlen,"hostport",value);
+
+	value=MapName;
+	char * s=value.Peek_Buffer();
+	char * t=strrchr(s,'.');
+	if (t) value.Erase(t-s,s+strlen(s)-t);
+	Append_InfoKey_Pair(outbuf,maxlen,"mapname",value);
+	Append_InfoKey_Pair(outbuf,maxlen,"gametype","C&C");
+
+	int pcount=0;
+	for (int i=0;i<PLAYER_COUNT;i++) {
+		if (Players[i].Active) {
+			pcount++;
+		}
+	}
+	value.Format("%d",pcount);
+	Append_InfoKey_Pair(outbuf,maxlen,"numplayers",value);
+	value.Format("%d",MaxPlayers);
+	Append_InfoKey_Pair(outbuf,maxlen,"maxplayers",value);
+}
+
+static void Build_Rules(char * outbuf,int maxlen)
+{
+	outbuf[0]=0;
+	StringClass value(true);
+	value.Format("%d",1500000);
+	Append_InfoKey_Pair(outbuf,maxlen,"BW",value);
+	Append_InfoKey_Pair(outbuf,maxlen,"CSVR","0");
+	Append_InfoKey_Pair(outbuf,maxlen,"DED","1");
+	Append_InfoKey_Pair(outbuf,maxlen,"DG","1");
+	Append_InfoKey_Pair(outbuf,maxlen,"password","0");
+	Append_InfoKey_Pair(outbuf,maxlen,"TC","1");
+	Append_InfoKey_Pair(outbuf,maxlen,"FF","0");
+	value.Format("%d",1000);
+	Append_InfoKey_Pair(outbuf,maxlen,"SC",value);
+}
+
+static void Build_Players(char * outbuf,int maxlen)
+{
+	outbuf[0]=0;
+}
+
+typedef void (*BuildFunction)(char * outbuf,int maxlen);
+static BuildFunction Builders[cGameSpyQueryResponder::RESPONSE_COUNT]={ Build_Basic, Build_Info, Build_Rules, Build_Players };
+
+// ----------------------------------------------------------------------------
+//
+// The old path: qr_process_queries on the main thread reading every query
+// and calling back into the game for each part of the response.
+//
+// ----------------------------------------------------------------------------
+
+static int Legacy_QueryId=0;
+
+static void Legacy_Send(SOCKET sock,char * packet,int length,const SOCKADDR_IN & from,int packet_number,bool final)
+{
+	if (final) {
+		length+=sprintf(packet+length,"\\final\\");
+	}
+	length+=sprintf(packet+length,"\\queryid\\%d.%d",Legacy_QueryId,packet_number);
+	sendto(sock,packet,length,0,(LPSOCKADDR)&from,sizeof(from));
+}
+
+static int Legacy_Process_Queries(SOCKET sock)
+{
+	int count=0;
+	for (;;) {
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(sock,&readable);
+		timeval timeout={ 0, 0 };
+		if (select(sock+1,&readable,NULL,NULL,&timeout)<=0) {
+			return count;
+		}
+
+		char query[cGameSpyQueryResponder::MAX_PACKET_SIZE+1];
+		SOCKADDR_IN from;
+		int from_length=sizeof(from);
+		int length=recvfrom(sock,query,cGameSpyQueryResponder::MAX_PACKET_SIZE,0,(LPSOCKADDR)&from,&from_length);
+		if (length<=0) {
+			continue;
+		}
+		query[length]=0;
+		count++;
+
+		char packet[cGameSpyQueryResponder::MAX_PACKET_SIZE+64];
+		int packet_length=0;
+		Legacy_QueryId++;
+
+		if (strncmp(query,"\\echo\\",6)==0) {
+			packet_length=sprintf(packet,"\\echo\\%s",query+6);
+			Legacy_Send(sock,packet,packet_length,from,1,true);
+			continue;
+		}
+
+		packet[0]=0;
+		for (char * key=strtok(query,"\\");key!=NULL;key=strtok(NULL,"\\")) {
+			static const char * names[]={ "basic", "info", "rules", "players" };
+			for (int type=0;type<cGameSpyQueryResponder::RESPONSE_COUNT;type++) {
+				if (strcmp(key,names[type])==0 || strcmp(key,"status")==0) {
+					Builders[type](packet+packet_length,cGameSpyQueryResponder::MAX_PACKET_SIZE-packet_length);
+					packet_length+=strlen(packet+packet_length);
+				}
+			}
+		}
+		Legacy_Send(sock,packet,packet_length,from,1,true);
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// The new path. The main thread rebuilds the responses when the state
+// changes and answers what the responder forwards (here only \echo\).
+//
+// ----------------------------------------------------------------------------
+
+static bool ResponsesDirty=true;
+
+static int Responder_Think(cGameSpyQueryResponder & responder)
+{
+	if (ResponsesDirty) {
+		char outbuf[cGameSpyQueryResponder::MAX_RESPONSE_SIZE];
+		for (int type=0;type<cGameSpyQueryResponder::RESPONSE_COUNT;type++) {
+			Builders[type](outbuf,sizeof(outbuf));
+			responder.Set_Response(type,outbuf);
+		}
+		ResponsesDirty=false;
+	}
+
+	int count=0;
+	char query[cGameSpyQueryResponder::MAX_PACKET_SIZE+1];
+	SOCKADDR_IN from;
+	while (responder.Get_Forwarded_Query(query,sizeof(query),from)) {
+		char packet[cGameSpyQueryResponder::MAX_PACKET_SIZE+64];
+		int length=sprintf(packet,"\\echo\\%s\\final\\\\queryid\\0.1",query+6);
+		sendto(responder.Get_Socket(),packet,length,0,(LPSOCKADDR)&from,sizeof(from));
+		count++;
+	}
+	return count;
+}
+
+static void Change_State(int frame)
+{
+	int index=(frame/STATE_CHANGE_FRAMES)%PLAYER_COUNT;
+	Players[index].Active=!Players[index].Active;
+	ResponsesDirty=true;
+}
+
+// ----------------------------------------------------------------------------
+//
+// The server browsers. Each source address keeps a few queries outstanding
+// and counts the responses that come back complete.
+//
+// ----------------------------------------------------------------------------
+
+class BrowserThreadClass : public ThreadClass
+{
+public:
+	BrowserThreadClass() : QueriesPerSource(0), Sent(0), Answered(0), BadResponses(0), Done(false) {}
+
+	int QueriesPerSource;
+	volatile int Sent;
+	volatile int Answered;
+	volatile int BadResponses;
+	volatile bool Done;
+
+protected:
+	void Thread_Function()
+	{
+		SOCKET sockets[SOURCE_COUNT];
+		int sent[SOURCE_COUNT];
+		int answered[SOURCE_COUNT];
+		SOCKADDR_IN server=Make_Address("127.0.0.1",SERVER_PORT);
+
+		for (int i=0;i<SOURCE_COUNT;i++) {
+			char ip[32];
+			sprintf(ip,"127.0.0.%d",i+2);
+			sockets[i]=socket(AF_INET,SOCK_DGRAM,0);
+			SOCKADDR_IN local=Make_Address(ip,0);
+			bind(sockets[i],(LPSOCKADDR)&local,sizeof(local));
+			sent[i]=0;
+			answered[i]=0;
+		}
+
+		static const char * queries[]={ "\\status\\", "\\status\\", "\\info\\", "\\status\\",
+			"\\basic\\\\info\\", "\\status\\", "\\rules\\", "\\echo\\ping" };
+
+		DWORD last_progress=GetTickCount();
+		while (running && GetTickCount()-last_progress<2000) {
+			bool finished=true;
+			for (int i=0;i<SOURCE_COUNT;i++) {
+				if (answered[i]<QueriesPerSource) {
+					finished=false;
+				}
+				while (sent[i]<QueriesPerSource && sent[i]-answered[i]<MAX_OUTSTANDING) {
+					const char * query=queries[(sent[i]+i)%8];
+					sendto(sockets[i],query,strlen(query),0,(LPSOCKADDR)&server,sizeof(server));
+					sent[i]++;
+					Sent++;
+				}
+
+				for (;;) {
+					fd_set readable;
+					FD_ZERO(&readable);
+					FD_SET(sockets[i],&readable);
+					timeval timeout={ 0, 0 };
+					if (select(sockets[i]+1,&readable,NULL,NULL,&timeout)<=0) {
+						break;
+					}
+					char packet[cGameSpyQueryResponder::MAX_PACKET_SIZE+64];
+					int length=recv(sockets[i],packet,sizeof(packet)-1,0);
+					if (length<=0) {
+						break;
+					}
+					packet[length]=0;
+					if (strstr(packet,"\\final\\\\queryid\\")==NULL) {
+						BadResponses++;
+					}
+					answered[i]++;
+					Answered++;
+					last_progress=GetTickCount();
+				}
+			}
+			if (finished) {
+				break;
+			}
+			Switch_Thread();
+		}
+
+		for (int i=0;i<SOURCE_COUNT;i++) {
+			closesocket(sockets[i]);
+		}
+		Done=true;
+	}
+};
+
+// ----------------------------------------------------------------------------
+//
+// One query sent straight to a server, for comparing responses.
+//
+// ----------------------------------------------------------------------------
+
+static bool Query_Once(const char * query,char * response,int size,cGameSpyQueryResponder * responder,SOCKET legacy)
+{
+	SOCKET sock=socket(AF_INET,SOCK_DGRAM,0);
+	SOCKADDR_IN local=Make_Address("127.0.0.1",0);
+	bind(sock,(LPSOCKADDR)&local,sizeof(local));
+	SOCKADDR_IN server=Make_Address("127.0.0.1",SERVER_PORT);
+	sendto(sock,query,strlen(query),0,(LPSOCKADDR)&server,sizeof(server));
+
+	bool ok=false;
+	for (int tries=0;tries<500 && !ok;tries++) {
+		if (legacy!=INVALID_SOCKET) {
+			Legacy_Process_Queries(legacy);
+		} else {
+			Responder_Think(*responder);
+		}
+		fd_set readable;
+		FD_ZERO(&readable);
+		FD_SET(sock,&readable);
+		timeval timeout={ 0, 2000 };
+		if (select(sock+1,&readable,NULL,NULL,&timeout)>0) {
+			int length=recv(sock,response,size-1,0);
+			if (length>0) {
+				response[length]=0;
+				char * queryid=strstr(response,"\\queryid\\");
+				if (queryid!=NULL) {
+					*queryid=0;
+				}
+				ok=true;
+			}
+		}
+	}
+	closesocket(sock);
+	return ok;
+}
+
+// ----------------------------------------------------------------------------
+//
+// The load test. Returns main thread seconds spent on queries.
+//
+// ----------------------------------------------------------------------------
+
+static void Reset_State(void)
+{
+	for (int i=0;i<PLAYER_COUNT;i++) {
+		Players[i].Name.Format(L"Player%d",i);
+		Players[i].Active=(i<PLAYER_COUNT/2);
+	}
+	ResponsesDirty=true;
+}
+
+static double Run_Load(bool use_responder,int & frames,int & handled_on_main)
+{
+	Reset_State();
+
+	SOCKET legacy=INVALID_SOCKET;
+	cGameSpyQueryResponder responder;
+	if (use_responder) {
+		responder.Set_Rate_Limit(0,0);
+		if (!responder.Open(inet_addr("127.0.0.1"),SERVER_PORT)) {
+			printf("responder can't bind port %d FAILED\n",SERVER_PORT);
+			Failures++;
+			return 0.0;
+		}
+		Responder_Think(responder);
+	} else {
+		legacy=socket(AF_INET,SOCK_DGRAM,0);
+		SOCKADDR_IN addr=Make_Address("127.0.0.1",SERVER_PORT);
+		if (bind(legacy,(LPSOCKADDR)&addr,sizeof(addr))==SOCKET_ERROR) {
+			printf("can't bind port %d FAILED\n",SERVER_PORT);
+			Failures++;
+			closesocket(legacy);
+			return 0.0;
+		}
+	}
+
+	BrowserThreadClass browsers;
+	browsers.QueriesPerSource=QUERY_COUNT/SOURCE_COUNT;
+	browsers.Execute();
+
+	double main_seconds=0.0;
+	handled_on_main=0;
+	frames=0;
+	while (!browsers.Done) {
+		LARGE_INTEGER t0,t1;
+		QueryPerformanceCounter(&t0);
+		if (use_responder) {
+			handled_on_main+=Responder_Think(responder);
+		} else {
+			handled_on_main+=Legacy_Process_Queries(legacy);
+		}
+		QueryPerformanceCounter(&t1);
+		main_seconds+=Seconds(t0,t1);
+
+		// The rest of the frame
+		frames++;
+		if ((frames%STATE_CHANGE_FRAMES)==0) {
+			Change_State(frames);
+		}
+		ThreadClass::Sleep_Ms(1);
+	}
+
+	if (browsers.Answered!=QUERY_COUNT || browsers.BadResponses!=0) {
+		printf("%d of %d queries answered, %d bad FAILED\n",browsers.Answered,QUERY_COUNT,browsers.BadResponses);
+		Failures++;
+	}
+
+	if (use_responder) {
+		responder.Close();
+	} else {
+		closesocket(legacy);
+	}
+	return main_seconds;
+}
+
+static void Compare_Responses(void)
+{
+	static const char * queries[]={ "\\status\\", "\\basic\\", "\\info\\", "\\rules\\", "\\basic\\\\info\\" };
+	const int count=sizeof(queries)/sizeof(queries[0]);
+	char legacy_response[count][cGameSpyQueryResponder::MAX_PACKET_SIZE+64];
+	char new_response[count][cGameSpyQueryResponder::MAX_PACKET_SIZE+64];
+
+	SOCKET legacy=socket(AF_INET,SOCK_DGRAM,0);
+	SOCKADDR_IN addr=Make_Address("127.0.0.1",SERVER_PORT);
+	bind(legacy,(LPSOCKADDR)&addr,sizeof(addr));
+	for (int i=0;i<count;i++) {
+		Query_Once(queries[i],legacy_response[i],sizeof(legacy_response[i]),NULL,legacy);
+	}
+	closesocket(legacy);
+
+	cGameSpyQueryResponder responder;
+	responder.Open(inet_addr("127.0.0.1"),SERVER_PORT);
+	ResponsesDirty=true;
+	Responder_Think(responder);
+	for (int i=0;i<count;i++) {
+		Query_Once(queries[i],new_response[i],sizeof(new_response[i]),&responder,INVALID_SOCKET);
+	}
+	responder.Close();
+
+	for (int i=0;i<count;i++) {
+		if (strcmp(legacy_response[i],new_response[i])!=0 || strstr(new_response[i],"\\final\\")==NULL) {
+			printf("response to %s differs FAILED\n  old: %s\n  new: %s\n",queries[i],legacy_response[i],new_response[i]);
+			Failures++;
+		}
+	}
+	printf("\\status\\ response: %s\n\n",new_response[0]);
+}
+
+// ----------------------------------------------------------------------------
+//
+// One source floods the responder while others query politely.
+//
+// ----------------------------------------------------------------------------
+
+static void Flood(void)
+{
+	const int FLOOD_COUNT=5000;
+	const int POLITE_SOURCES=8;
+	const int POLITE_QUERIES=4;
+
+	cGameSpyQueryResponder responder;
+	if (!responder.Open(inet_addr("127.0.0.1"),SERVER_PORT)) {
+		printf("responder can't bind port %d FAILED\n",SERVER_PORT);
+		Failures++;
+		return;
+	}
+	ResponsesDirty=true;
+	Responder_Think(responder);
+
+	SOCKADDR_IN server=Make_Address("127.0.0.1",SERVER_PORT);
+	SOCKET flooder=socket(AF_INET,SOCK_DGRAM,0);
+	SOCKADDR_IN local=Make_Address("127.0.0.200",0);
+	bind(flooder,(LPSOCKADDR)&local,sizeof(local));
+
+	SOCKET polite[POLITE_SOURCES];
+	for (int i=0;i<POLITE_SOURCES;i++) {
+		char ip[32];
+		sprintf(ip,"127.0.1.%d",i+2);
+		polite[i]=socket(AF_INET,SOCK_DGRAM,0);
+		local=Make_Address(ip,0);
+		bind(polite[i],(LPSOCKADDR)&local,sizeof(local));
+	}
+
+	DWORD start=GetTickCount();
+	for (int i=0;i<FLOOD_COUNT;i++) {
+		sendto(flooder,"\\status\\",8,0,(LPSOCKADDR)&server,sizeof(server));
+		if ((i%(FLOOD_COUNT/POLITE_QUERIES))==0) {
+			for (int p=0;p<POLITE_SOURCES;p++) {
+				sendto(polite[p],"\\info\\",6,0,(LPSOCKADDR)&server,sizeof(server));
+			}
+		}
+		if ((i&63)==0) {
+			ThreadClass::Switch_Thread();
+		}
+	}
+	ThreadClass::Sleep_Ms(500);
+	DWORD elapsed=GetTickCount()-start;
+
+	int flood_answers=0;
+	char packet[cGameSpyQueryResponder::MAX_PACKET_SIZE+64];
+	ULONG nonblocking=1;
+	ioctlsocket(flooder,FIONBIO,&nonblocking);
+	while (recv(flooder,packet,sizeof(packet),0)>0) {
+		flood_answers++;
+	}
+	int polite_answers=0;
+	for (int p=0;p<POLITE_SOURCES;p++) {
+		ioctlsocket(polite[p],FIONBIO,&nonblocking);
+		while (recv(polite[p],packet,sizeof(packet),0)>0) {
+			polite_answers++;
+		}
+		closesocket(polite[p]);
+	}
+	closesocket(flooder);
+	responder.Close();
+
+	int allowed=cGameSpyQueryResponder::DEFAULT_QUERY_BURST+cGameSpyQueryResponder::DEFAULT_QUERY_RATE*(elapsed/1000+1);
+	printf("Flood of %d queries from one address over %d ms: %d answered, %d dropped\n",FLOOD_COUNT,elapsed,flood_answers,responder.Get_Dropped_Count());
+	printf("%d of %d queries from %d other addresses answered\n",polite_answers,POLITE_SOURCES*POLITE_QUERIES,POLITE_SOURCES);
+	if (flood_answers>allowed || flood_answers==0) {
+		printf("flood answered %d times, limit allows %d FAILED\n",flood_answers,allowed);
+		Failures++;
+	}
+	if (polite_answers!=POLITE_SOURCES*POLITE_QUERIES) {
+		printf("polite sources were limited FAILED\n");
+		Failures++;
+	}
+}
+
+int main(void)
+{
+	WSADATA winsock_data;
+	if (WSAStartup(MAKEWORD(1,1),&winsock_data)!=0) {
+		printf("WSAStartup FAILED\n");
+		return 1;
+	}
+
+	Reset_State();
+	Compare_Responses();
+
+	int frames;
+	int handled;
+	printf("%d queries from %d addresses, a player joins or leaves every %d frames.\n\n",QUERY_COUNT,SOURCE_COUNT,STATE_CHANGE_FRAMES);
+	printf("%-32s %10s %12s %14s %10s\n","","frames","main ms","main us/query","on main");
+	double legacy_seconds=Run_Load(false,frames,handled);
+	printf("%-32s %10d %12.2f %14.2f %10d\n","main loop builds every response",frames,legacy_seconds*1000.0,legacy_seconds*1000000.0/QUERY_COUNT,handled);
+	double new_seconds=Run_Load(true,frames,handled);
+	printf("%-32s %10d %12.2f %14.2f %10d\n\n","cGameSpyQueryResponder",frames,new_seconds*1000.0,new_seconds*1000000.0/QUERY_COUNT,handled);
+
+	Flood();
+
+	WSACleanup();
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,684 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Save/Load Benchmark                                          *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/saveloadbench/main.cpp                 $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Builds a world of game objects spread over several save-load sub-systems, some of which     *
+ * are thread safe, with pointers between objects in different sub-systems. Saving the list    *
+ * of sub-systems on the worker pool must give exactly the bytes of saving them one at a time  *
+ * and an incremental save after changing a few objects must match a full save while only      *
+ * re-saving the objects that changed. The file is then loaded into an empty world and every   *
+ * object and pointer is checked.                                                              *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "saveload.h"
+#include "saveloadsubsystem.h"
+#include "saveloadids.h"
+#include "savesnapshot.h"
+#include "persist.h"
+#include "persistfactory.h"
+#include "chunkio.h"
+#include "memfile.h"
+#include "workerpool.h"
+#include "vector.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	if (!ok) {
+		printf("%s FAILED\n",what);
+		Failures++;
+	}
+}
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+enum {
+	OBJECT_COUNT=8000,
+	SUB_SYSTEM_COUNT=4,
+	DIRTY_COUNT=80,
+	PASSES=5,
+
+	CHUNKID_SUB_SYSTEM=CHUNKID_PHYSTEST_BEGIN+0x800,		// one per sub-system
+	CHUNKID_GAME_OBJ=CHUNKID_PHYSTEST_BEGIN+0x810,
+
+	CHUNKID_SYS_VARIABLES=0x0100,
+	CHUNKID_SYS_OBJECTS,
+
+	CHUNKID_OBJ_VARIABLES=0x0200,
+	CHUNKID_OBJ_HISTORY,
+
+	MICROCHUNKID_ID=1,
+	MICROCHUNKID_POSITION,
+	MICROCHUNKID_HEALTH,
+	MICROCHUNKID_TARGET,
+	MICROCHUNKID_NAME,
+	MICROCHUNKID_SYS_SERIAL,
+
+	HISTORY_LENGTH=24
+};
+
+
+// ----------------------------------------------------------------------------
+//
+// A game object with some state, a pointer to another object and a block of
+// bulk data so saving it takes a little while.
+//
+// ----------------------------------------------------------------------------
+
+class GameObjClass : public PersistClass
+{
+public:
+	GameObjClass(void) : ID(0), Health(0), Target(NULL), SaveCount(0), Touched(false)
+	{
+		memset(Position,0,sizeof(Position));
+		memset(Name,0,sizeof(Name));
+		memset(History,0,sizeof(History));
+	}
+
+	virtual const PersistFactoryClass & Get_Factory(void) const;
+	virtual bool Save(ChunkSaveClass & csave);
+	virtual bool Load(ChunkLoadClass & cload);
+
+	void Randomize(int id)
+	{
+		ID=id;
+		for (int i=0; i<3; i++) {
+			Position[i]=(float)(rand()%10000)*0.25f;
+		}
+		Health=rand()%200;
+		sprintf(Name,"obj%05d",id);
+		for (int i=0; i<HISTORY_LENGTH; i++) {
+			History[i][0]=Position[0]+i;
+			History[i][1]=Position[1]-i;
+			History[i][2]=Position[2]*0.5f;
+		}
+	}
+
+	int					ID;
+	float					Position[3];
+	int					Health;
+	GameObjClass *		Target;
+	char					Name[16];
+	float					History[HISTORY_LENGTH][3];
+	int					SaveCount;
+	bool					Touched;
+};
+
+static SimplePersistFactoryClass<GameObjClass,CHUNKID_GAME_OBJ> _GameObjFactory;
+
+const PersistFactoryClass & GameObjClass::Get_Factory(void) const
+{
+	return _GameObjFactory;
+}
+
+bool GameObjClass::Save(ChunkSaveClass & csave)
+{
+	SaveCount++;
+
+	csave.Begin_Chunk(CHUNKID_OBJ_VARIABLES);
+	WRITE_MICRO_CHUNK(csave,MICROCHUNKID_ID,ID);
+	WRITE_MICRO_CHUNK(csave,MICROCHUNKID_POSITION,Position);
+	WRITE_MICRO_CHUNK(csave,MICROCHUNKID_HEALTH,Health);
+	WRITE_MICRO_CHUNK(csave,MICROCHUNKID_TARGET,Target);
+	WRITE_MICRO_CHUNK(csave,MICROCHUNKID_NAME,Name);
+	csave.End_Chunk();
+
+	csave.Begin_Chunk(CHUNKID_OBJ_HISTORY);
+	csave.Write(History,sizeof(History));
+	csave.End_Chunk();
+	return true;
+}
+
+bool GameObjClass::Load(ChunkLoadClass & cload)
+{
+	while (cload.Open_Chunk()) {
+		switch (cload.Cur_Chunk_ID()) {
+			case CHUNKID_OBJ_VARIABLES:
+				while (cload.Open_Micro_Chunk()) {
+					switch (cload.Cur_Micro_Chunk_ID()) {
+						READ_MICRO_CHUNK(cload,MICROCHUNKID_ID,ID);
+						READ_MICRO_CHUNK(cload,MICROCHUNKID_POSITION,Position);
+						READ_MICRO_CHUNK(cload,MICROCHUNKID_HEALTH,Health);
+						READ_MICRO_CHUNK(cload,MICROCHUNKID_TARGET,Target);
+						READ_MICRO_CHUNK(cload,MICROCHUNKID_NAME,Name);
+					}
+					cload.Close_Micro_Chunk();
+				}
+				break;
+
+			case CHUNKID_OBJ_HISTORY:
+				cload.Read(History,sizeof(History));
+				break;
+		}
+		cload.Close_Chunk();
+	}
+
+	if (Target != NULL) {
+		REQUEST_POINTER_REMAP((void **)&Target);
+	}
+	return true;
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// A sub-system owning a list of objects. It counts its saves, keeps a cache
+// of its objects' bytes and can claim to be thread safe.
+//
+// ----------------------------------------------------------------------------
+
+class WorldSaveLoadClass : public SaveLoadSubSystemClass
+{
+public:
+	WorldSaveLoadClass(int index,bool thread_safe) :
+		Index(index),
+		ThreadSafe(thread_safe),
+		UseCache(false),
+		Serial(0),
+		SaveCalls(0),
+		IsChanged(true)
+	{
+	}
+
+	~WorldSaveLoadClass(void) { Clear(); }
+
+	virtual uint32 Chunk_ID(void) const { return CHUNKID_SUB_SYSTEM+Index; }
+
+	void Add(GameObjClass * obj)		{ Objects.Add(obj); Cache.Set_Dirty(obj); }
+	void Touch(GameObjClass * obj)	{ obj->Health++; obj->Touched=true; Cache.Set_Dirty(obj); }
+	void Remove(int index)
+	{
+		Cache.Remove(Objects[index]);
+		delete Objects[index];
+		Objects.Delete(index);
+	}
+
+	void Clear(void)
+	{
+		for (int i=0; i<Objects.Count(); i++) {
+			delete Objects[i];
+		}
+		Objects.Delete_All();
+		Cache.Reset();
+		IsChanged=true;
+	}
+
+	int Index;
+	bool ThreadSafe;
+	bool UseCache;
+	int Serial;
+	int SaveCalls;
+	bool IsChanged;
+	DynamicVectorClass<GameObjClass *> Objects;
+	PersistCacheClass Cache;
+
+protected:
+	virtual bool Contains_Data(void) const { return Objects.Count() > 0; }
+	virtual bool Is_Save_Thread_Safe(void) const { return ThreadSafe; }
+	virtual bool Has_Changed(void) const { return IsChanged || Cache.Has_Changed(); }
+	virtual void Clear_Changed(void) { IsChanged=false; Cache.Clear_Changed(); }
+	virtual const char * Name(void) const { return "WorldSaveLoadClass"; }
+
+	virtual bool Save(ChunkSaveClass & csave)
+	{
+		SaveCalls++;
+
+		csave.Begin_Chunk(CHUNKID_SYS_VARIABLES);
+		WRITE_MICRO_CHUNK(csave,MICROCHUNKID_SYS_SERIAL,Serial);
+		csave.End_Chunk();
+
+		csave.Begin_Chunk(CHUNKID_SYS_OBJECTS);
+		for (int i=0; i<Objects.Count(); i++) {
+			GameObjClass * obj=Objects[i];
+			if (UseCache) {
+				Cache.Save(csave,obj);
+			} else {
+				csave.Begin_Chunk(obj->Get_Factory().Chunk_ID());
+				obj->Get_Factory().Save(csave,obj);
+				csave.End_Chunk();
+			}
+		}
+		csave.End_Chunk();
+		return true;
+	}
+
+	virtual bool Load(ChunkLoadClass & cload)
+	{
+		while (cload.Open_Chunk()) {
+			switch (cload.Cur_Chunk_ID()) {
+				case CHUNKID_SYS_VARIABLES:
+					while (cload.Open_Micro_Chunk()) {
+						switch (cload.Cur_Micro_Chunk_ID()) {
+							READ_MICRO_CHUNK(cload,MICROCHUNKID_SYS_SERIAL,Serial);
+						}
+						cload.Close_Micro_Chunk();
+					}
+					break;
+
+				case CHUNKID_SYS_OBJECTS:
+					while (cload.Open_Chunk()) {
+						PersistFactoryClass * factory=SaveLoadSystemClass::Find_Persist_Factory(cload.Cur_Chunk_ID());
+						if (factory != NULL) {
+							Objects.Add((GameObjClass *)factory->Load(cload));
+						}
+						cload.Close_Chunk();
+					}
+					break;
+			}
+			cload.Close_Chunk();
+		}
+		return true;
+	}
+};
+
+// Two of the sub-systems are thread safe, one isn't and one stays empty
+static WorldSaveLoadClass _World0(0,true);
+static WorldSaveLoadClass _World1(1,false);
+static WorldSaveLoadClass _World2(2,true);
+static WorldSaveLoadClass _World3(3,true);
+
+static WorldSaveLoadClass * Worlds[SUB_SYSTEM_COUNT]={ &_World0,&_World1,&_World2,&_World3 };
+static SaveLoadSubSystemClass * SaveList[SUB_SYSTEM_COUNT]={ &_World0,&_World1,&_World2,&_World3 };
+
+
+static void Build_World(void)
+{
+	srand(1234);
+
+	DynamicVectorClass<GameObjClass *> all;
+	for (int i=0; i<OBJECT_COUNT; i++) {
+		GameObjClass * obj=new GameObjClass;
+		obj->Randomize(i);
+		all.Add(obj);
+		Worlds[i%(SUB_SYSTEM_COUNT-1)]->Add(obj);
+	}
+
+	// Point objects at each other, across sub-systems
+	for (int i=0; i<OBJECT_COUNT; i++) {
+		if ((i%3) != 0) {
+			all[i]->Target=all[rand()%OBJECT_COUNT];
+		}
+	}
+
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		Worlds[i]->Serial=1000+i;
+	}
+}
+
+static void Clear_World(void)
+{
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		Worlds[i]->Clear();
+	}
+}
+
+static int Total_Save_Count(void)
+{
+	int count=0;
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		for (int j=0; j<Worlds[i]->Objects.Count(); j++) {
+			count+=Worlds[i]->Objects[j]->SaveCount;
+		}
+	}
+	return count;
+}
+
+// The old way: each sub-system in turn, straight into the file
+static void Save_Serial(MemoryFileClass & file)
+{
+	file.Open(FileClass::WRITE);
+	ChunkSaveClass csave(&file);
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		SaveLoadSystemClass::Save(csave,*Worlds[i]);
+	}
+	file.Close();
+}
+
+// A serial save that ignores the object caches
+static void Save_Uncached(MemoryFileClass & file)
+{
+	bool use_cache[SUB_SYSTEM_COUNT];
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		use_cache[i]=Worlds[i]->UseCache;
+		Worlds[i]->UseCache=false;
+	}
+	Save_Serial(file);
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		Worlds[i]->UseCache=use_cache[i];
+	}
+}
+
+static bool Save_List(MemoryFileClass & file,SaveSnapshotClass * snapshot)
+{
+	file.Open(FileClass::WRITE);
+	ChunkSaveClass csave(&file);
+	bool ok=SaveLoadSystemClass::Save(csave,SaveList,SUB_SYSTEM_COUNT,snapshot);
+	file.Close();
+	return ok;
+}
+
+static bool Same(MemoryFileClass & a,MemoryFileClass & b)
+{
+	return	a.Get_Length() == b.Get_Length() &&
+				memcmp(a.Get_Buffer(),b.Get_Buffer(),a.Get_Length()) == 0;
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// The serial and list saves must agree for any worker count
+//
+// ----------------------------------------------------------------------------
+
+static void Test_Parallel(MemoryFileClass & serial)
+{
+	MemoryFileClass parallel;
+
+	WorkerPoolClass::Init(0);
+	Check(Save_List(parallel,NULL),"inline list save");
+	Check(Same(serial,parallel),"inline list save matches serial save");
+	WorkerPoolClass::Shutdown();
+
+	WorkerPoolClass::Init();
+	Check(Save_List(parallel,NULL),"parallel list save");
+	Check(Same(serial,parallel),"parallel list save matches serial save");
+
+	// An empty list writes nothing
+	parallel.Open(FileClass::WRITE);
+	ChunkSaveClass csave(&parallel);
+	Check(SaveLoadSystemClass::Save(csave,NULL,0),"empty list save");
+	parallel.Close();
+	Check(parallel.Get_Length() == 0,"empty list save is empty");
+
+	// Whole chunks copied into an open chunk land inside it
+	MemoryFileClass nested_serial;
+	MemoryFileClass nested_list;
+	nested_serial.Open(FileClass::WRITE);
+	ChunkSaveClass serial_save(&nested_serial);
+	serial_save.Begin_Chunk(0x1234);
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		SaveLoadSystemClass::Save(serial_save,*Worlds[i]);
+	}
+	serial_save.End_Chunk();
+	nested_serial.Close();
+
+	nested_list.Open(FileClass::WRITE);
+	ChunkSaveClass list_save(&nested_list);
+	list_save.Begin_Chunk(0x1234);
+	SaveLoadSystemClass::Save(list_save,SaveList,SUB_SYSTEM_COUNT);
+	list_save.End_Chunk();
+	nested_list.Close();
+	Check(Same(nested_serial,nested_list),"nested list save matches serial save");
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// Incremental saves only re-save what changed and still match a full save
+//
+// ----------------------------------------------------------------------------
+
+static void Test_Incremental(void)
+{
+	SaveSnapshotClass snapshot;
+	MemoryFileClass incremental;
+	MemoryFileClass full;
+
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		Worlds[i]->UseCache=true;
+	}
+
+	// The first save with a snapshot saves everything
+	Check(Save_List(incremental,&snapshot),"first incremental save");
+	Save_Uncached(full);
+	Check(Same(incremental,full),"first incremental save matches full save");
+	Check(snapshot.Get_Size() == incremental.Get_Length(),"snapshot keeps every sub-system");
+
+	// Nothing changed, nothing is saved
+	int saves=Total_Save_Count();
+	int calls0=_World0.SaveCalls;
+	Check(Save_List(incremental,&snapshot),"unchanged incremental save");
+	Check(Same(incremental,full),"unchanged incremental save matches full save");
+	Check(Total_Save_Count() == saves,"unchanged incremental save saves no objects");
+	Check(_World0.SaveCalls == calls0,"unchanged sub-system isn't saved");
+
+	// Change a few objects in two of the sub-systems, add one and remove one
+	for (int i=0; i<DIRTY_COUNT; i++) {
+		WorldSaveLoadClass * world=(i&1) ? &_World1 : &_World2;
+		world->Touch(world->Objects[(i*37)%world->Objects.Count()]);
+	}
+
+	GameObjClass * added=new GameObjClass;
+	added->Randomize(OBJECT_COUNT);
+	added->Target=_World0.Objects[0];
+	added->Touched=true;
+	_World2.Add(added);
+
+	for (int index=_World1.Objects.Count()-1; index>=0; index--) {
+		GameObjClass * obj=_World1.Objects[index];
+		bool targeted=false;
+		for (int i=0; i<SUB_SYSTEM_COUNT && !targeted; i++) {
+			for (int j=0; j<Worlds[i]->Objects.Count(); j++) {
+				if (Worlds[i]->Objects[j]->Target == obj) {
+					targeted=true;
+					break;
+				}
+			}
+		}
+		if (!targeted && !obj->Touched) {
+			_World1.Remove(index);
+			break;
+		}
+	}
+
+	int expected=0;
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		for (int j=0; j<Worlds[i]->Objects.Count(); j++) {
+			if (Worlds[i]->Objects[j]->Touched) {
+				expected++;
+			}
+		}
+	}
+	saves=Total_Save_Count();
+	calls0=_World0.SaveCalls;
+
+	LARGE_INTEGER begin,end;
+	QueryPerformanceCounter(&begin);
+	Check(Save_List(incremental,&snapshot),"incremental save");
+	QueryPerformanceCounter(&end);
+	double incremental_time=Seconds(begin,end);
+
+	int dirty=Total_Save_Count()-saves;
+	Check(dirty == expected,"incremental save only re-saves changed objects");
+	Check(_World0.SaveCalls == calls0,"incremental save skips unchanged sub-system");
+
+	Save_Uncached(full);
+	Check(Same(incremental,full),"incremental save matches full save");
+
+	printf("incremental save: %d objects re-saved, %.2f ms\n",dirty,incremental_time*1000.0);
+
+	// Resetting the snapshot makes the next save a full one
+	snapshot.Reset();
+	Check(snapshot.Get_Size() == 0,"reset snapshot is empty");
+	Check(Save_List(incremental,&snapshot),"save after reset");
+	Check(Same(incremental,full),"save after reset matches full save");
+
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		Worlds[i]->UseCache=false;
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// Load the file into an empty world and compare it with the saved one
+//
+// ----------------------------------------------------------------------------
+
+struct SavedObjStruct
+{
+	int		SubSystem;
+	int		ID;
+	float		Position[3];
+	int		Health;
+	int		TargetID;
+	char		Name[16];
+	float		History[HISTORY_LENGTH][3];
+};
+
+static void Test_Round_Trip(MemoryFileClass & file)
+{
+	//
+	// Remember what was saved, by id
+	//
+	SavedObjStruct * saved=new SavedObjStruct[OBJECT_COUNT+1];
+	int saved_count=0;
+	int serials[SUB_SYSTEM_COUNT];
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		serials[i]=Worlds[i]->Serial;
+		for (int j=0; j<Worlds[i]->Objects.Count(); j++) {
+			GameObjClass * obj=Worlds[i]->Objects[j];
+			SavedObjStruct & rec=saved[saved_count++];
+			rec.SubSystem=i;
+			rec.ID=obj->ID;
+			memcpy(rec.Position,obj->Position,sizeof(rec.Position));
+			rec.Health=obj->Health;
+			rec.TargetID=(obj->Target != NULL) ? obj->Target->ID : -1;
+			memcpy(rec.Name,obj->Name,sizeof(rec.Name));
+			memcpy(rec.History,obj->History,sizeof(rec.History));
+		}
+	}
+
+	Clear_World();
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		Worlds[i]->Serial=0;
+	}
+
+	LARGE_INTEGER begin,end;
+	QueryPerformanceCounter(&begin);
+	file.Open();
+	ChunkLoadClass cload(&file);
+	Check(SaveLoadSystemClass::Load(cload),"load");
+	file.Close();
+	QueryPerformanceCounter(&end);
+	printf("load: %.2f ms\n",Seconds(begin,end)*1000.0);
+
+	int index=0;
+	bool objects_ok=true;
+	bool targets_ok=true;
+	for (int i=0; i<SUB_SYSTEM_COUNT; i++) {
+		Check(Worlds[i]->Objects.Count() == 0 || Worlds[i]->Serial == serials[i],"sub-system variables round trip");
+		for (int j=0; j<Worlds[i]->Objects.Count(); j++) {
+			GameObjClass * obj=Worlds[i]->Objects[j];
+			if (index >= saved_count) {
+				objects_ok=false;
+				break;
+			}
+			SavedObjStruct & rec=saved[index++];
+			if (	rec.SubSystem != i || rec.ID != obj->ID || rec.Health != obj->Health ||
+					memcmp(rec.Position,obj->Position,sizeof(rec.Position)) != 0 ||
+					memcmp(rec.Name,obj->Name,sizeof(rec.Name)) != 0 ||
+					memcmp(rec.History,obj->History,sizeof(rec.History)) != 0)
+			{
+				objects_ok=false;
+			}
+			if ((obj->Target != NULL ? obj->Target->ID : -1) != rec.TargetID) {
+				targets_ok=false;
+			}
+		}
+	}
+	Check(index == saved_count,"every object loads");
+	Check(objects_ok,"objects round trip");
+	Check(targets_ok,"pointers between sub-systems are remapped");
+
+	//
+	// The loaded world saves the same way serially and in parallel too
+	//
+	MemoryFileClass serial;
+	MemoryFileClass parallel;
+	Save_Serial(serial);
+	Check(Save_List(parallel,NULL),"save of loaded world");
+	Check(Same(serial,parallel),"loaded world list save matches serial save");
+
+	delete [] saved;
+}
+
+
+int main(int argc,char * argv[])
+{
+	Build_World();
+
+	MemoryFileClass serial;
+	Save_Serial(serial);
+	printf("%d objects, %d sub-systems, %d byte file\n",OBJECT_COUNT,SUB_SYSTEM_COUNT,serial.Get_Length());
+
+	Test_Parallel(serial);
+	printf("%d worker threads\n",WorkerPoolClass::Get_Thread_Count());
+
+	//
+	// Time the serial and list saves
+	//
+	MemoryFileClass parallel;
+	double serial_time=0.0;
+	double parallel_time=0.0;
+	for (int pass=0; pass<PASSES; pass++) {
+		LARGE_INTEGER begin,end;
+		QueryPerformanceCounter(&begin);
+		Save_Serial(serial);
+		QueryPerformanceCounter(&end);
+		serial_time+=Seconds(begin,end);
+
+		QueryPerformanceCounter(&begin);
+		Save_List(parallel,NULL);
+		QueryPerformanceCounter(&end);
+		parallel_time+=Seconds(begin,end);
+	}
+	Check(Same(serial,parallel),"timed list save matches serial save");
+	printf("serial save:   %.2f ms\n",serial_time*1000.0/PASSES);
+	printf("parallel save: %.2f ms\n",parallel_time*1000.0/PASSES);
+
+	Test_Incremental();
+
+	Save_Serial(serial);
+	Test_Round_Trip(serial);
+
+	Clear_World();
+	WorkerPoolClass::Shutdown();
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
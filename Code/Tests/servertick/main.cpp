@@ -0,0 +1,293 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Server Tick Scheduler Test                                    *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/servertick/main.cpp                    $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Runs cServerTickScheduler against a simulated clock: steady ticks stay on the grid, input   *
+ * ends a wait the moment it arrives, slow frames are caught up to the limit and the rest     *
+ * dropped, the clock wrapping is harmless and changing the rate keeps the promised deadline. *
+ * Finishes with a second of real ticks on the socket clock and reports how late they were.   *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "servertick.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	if (!ok) {
+		printf("%s FAILED\n",what);
+		Failures++;
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// Simulated time. Waiting moves the clock on to the deadline or to the next
+// scripted input, whichever is first; frames move it on by their length.
+//
+// ----------------------------------------------------------------------------
+
+class SimulatedClockClass : public cServerTickClock
+{
+public:
+	enum {MAX_INPUTS=64};
+
+	SimulatedClockClass(unsigned long start) : Now(start), InputCount(0), NextInput(0), WaitCount(0) {}
+
+	virtual unsigned long Get_Time_Us(void) { return Now; }
+
+	virtual bool Wait_For_Input(unsigned long timeout_us)
+	{
+		WaitCount++;
+		if (NextInput<InputCount && long(Inputs[NextInput]-Now)<=long(timeout_us)) {
+			if (long(Inputs[NextInput]-Now)>0) {
+				Now=Inputs[NextInput];
+			}
+			NextInput++;
+			return true;
+		}
+		Now+=timeout_us;
+		return false;
+	}
+
+	void Advance(unsigned long us) { Now+=us; }
+	void Add_Input(unsigned long time) { if (InputCount<MAX_INPUTS) Inputs[InputCount++]=time; }
+
+	unsigned long Now;
+	unsigned long Inputs[MAX_INPUTS];
+	int InputCount;
+	int NextInput;
+	int WaitCount;
+};
+
+static unsigned long Grid(unsigned long start,int rate,unsigned long tick)
+{
+	return start+(unsigned long)((tick/rate)*1000000+((tick%rate)*1000000)/rate);
+}
+
+// ----------------------------------------------------------------------------
+
+static void Test_Steady(void)
+{
+	const int RATE=60;
+	const int TICKS=RATE*600;
+	SimulatedClockClass clock(1000);
+	cServerTickScheduler scheduler(&clock);
+	scheduler.Set_Tick_Rate(RATE);
+
+	bool on_grid=true;
+	for (int i=0;i<TICKS;i++) {
+		if (scheduler.Wait()!=cServerTickScheduler::WAIT_TICK) {
+			Check(false,"steady: unexpected input");
+			return;
+		}
+		if (clock.Now!=Grid(1000,RATE,i) || scheduler.Get_Tick_Lateness_Us()!=0) {
+			on_grid=false;
+		}
+		clock.Advance(3000+(i*7919)%9000);		// frames of 3 to 12ms
+	}
+	Check(on_grid,"steady: ticks off the grid");
+	Check(scheduler.Get_Catch_Up_Count()==0 && scheduler.Get_Skipped_Count()==0,"steady: ticks made up or skipped");
+
+	//
+	// Ten minutes of ticks take ten minutes, less one tick.
+	//
+	unsigned long elapsed=clock.Now-1000;
+	printf("steady: %d ticks at %d Hz, last tick at %.6f s\n",TICKS,RATE,double(Grid(1000,RATE,TICKS-1)-1000)/1000000.0);
+	Check(Grid(1000,RATE,TICKS)-1000==600000000,"steady: grid drifts");
+	Check(elapsed>=600000000-1000000/RATE && elapsed<600000000+12000,"steady: wrong elapsed time");
+}
+
+static void Test_Input(void)
+{
+	const int RATE=30;
+	SimulatedClockClass clock(50000);
+	cServerTickScheduler scheduler(&clock);
+	scheduler.Set_Tick_Rate(RATE);
+
+	scheduler.Wait();		// tick 0 at 50000
+	unsigned long deadline=Grid(50000,RATE,1);
+
+	clock.Advance(4000);
+	clock.Add_Input(deadline-20000);
+	clock.Add_Input(deadline-19900);	// arrives while the first is being read
+	clock.Add_Input(deadline-100);
+
+	Check(scheduler.Wait()==cServerTickScheduler::WAIT_INPUT,"input: first packet didn't end the wait");
+	Check(clock.Now==deadline-20000,"input: first packet not handled on arrival");
+	clock.Advance(300);
+
+	Check(scheduler.Wait()==cServerTickScheduler::WAIT_INPUT,"input: queued packet not picked up");
+	Check(clock.Now==deadline-19700,"input: queued packet waited");
+	clock.Advance(300);
+
+	Check(scheduler.Wait()==cServerTickScheduler::WAIT_INPUT,"input: late packet didn't end the wait");
+	Check(clock.Now==deadline-100,"input: late packet not handled on arrival");
+	clock.Advance(500);		// reading it overruns the deadline
+
+	Check(scheduler.Wait()==cServerTickScheduler::WAIT_TICK,"input: no tick after the packets");
+	unsigned long lateness=scheduler.Get_Tick_Lateness_Us();
+	Check(clock.Now==deadline+400 && lateness==400,"input: wrong tick lateness");
+
+	Check(scheduler.Wait()==cServerTickScheduler::WAIT_TICK && clock.Now==Grid(50000,RATE,2),"input: next tick off the grid");
+	printf("input: 3 packets handled on arrival, tick started %lu us late\n",lateness);
+}
+
+static void Test_Overrun(int catch_up)
+{
+	const int RATE=60;
+	SimulatedClockClass clock(0x10000);
+	cServerTickScheduler scheduler(&clock);
+	scheduler.Set_Tick_Rate(RATE);
+	scheduler.Set_Max_Catch_Up_Ticks(catch_up);
+
+	for (int i=0;i<10;i++) {
+		scheduler.Wait();
+		clock.Advance(5000);
+	}
+
+	//
+	// A 190ms frame misses 10 deadlines after tick 11's.
+	//
+	scheduler.Wait();
+	clock.Advance(190000);
+	unsigned long late=clock.Now-Grid(0x10000,RATE,11);
+	int missed=int((late*RATE)/1000000);
+
+	//
+	// The catch up frames take no time, so every tick due runs straight away.
+	//
+	int immediate=0;
+	for (;;) {
+		int waits=clock.WaitCount;
+		scheduler.Wait();
+		if (clock.WaitCount!=waits) {
+			break;
+		}
+		immediate++;
+	}
+
+	int expected_run=(missed<catch_up ? missed : catch_up)+1;
+	int expected_skipped=(missed>catch_up) ? missed-catch_up : 0;
+	char what[128];
+	sprintf(what,"overrun %d: %d ticks run back to back, expected %d",catch_up,immediate,expected_run);
+	Check(immediate==expected_run,what);
+	sprintf(what,"overrun %d: %lu ticks skipped, expected %d",catch_up,scheduler.Get_Skipped_Count(),expected_skipped);
+	Check(int(scheduler.Get_Skipped_Count())==expected_skipped,what);
+
+	//
+	// The next wait ends on the original grid.
+	//
+	bool on_grid=false;
+	for (unsigned long k=0;k<100;k++) {
+		if (Grid(0x10000,RATE,k)==clock.Now) on_grid=true;
+	}
+	Check(on_grid,"overrun: grid moved");
+	printf("overrun with catch up %d: 190 ms frame, %d ticks back to back, %lu skipped\n",
+		catch_up,immediate,scheduler.Get_Skipped_Count());
+}
+
+static void Test_Wrap(void)
+{
+	const int RATE=50;
+	unsigned long start=0xFFFFFFFFUL-45000;
+	SimulatedClockClass clock(start);
+	cServerTickScheduler scheduler(&clock);
+	scheduler.Set_Tick_Rate(RATE);
+
+	bool ok=true;
+	for (int i=0;i<20;i++) {
+		scheduler.Wait();
+		if (clock.Now!=Grid(start,RATE,i) || scheduler.Get_Tick_Lateness_Us()!=0) ok=false;
+		clock.Advance(2000);
+	}
+	Check(ok,"wrap: ticks off the grid across the clock wrapping");
+	Check(scheduler.Get_Skipped_Count()==0 && scheduler.Get_Catch_Up_Count()==0,"wrap: ticks skipped");
+}
+
+static void Test_Rate_Change(void)
+{
+	SimulatedClockClass clock(0);
+	cServerTickScheduler scheduler(&clock);
+	scheduler.Set_Tick_Rate(20);
+
+	scheduler.Wait();
+	scheduler.Wait();
+	Check(clock.Now==50000,"rate: 20 Hz");
+
+	//
+	// The 100ms deadline was already promised; 40 Hz ticks follow on from it.
+	//
+	scheduler.Set_Tick_Rate(40);
+	scheduler.Wait();
+	Check(clock.Now==100000,"rate: promised deadline not kept");
+	scheduler.Wait();
+	Check(clock.Now==125000,"rate: 40 Hz");
+	Check(scheduler.Get_Skipped_Count()==0,"rate: ticks skipped");
+}
+
+// ----------------------------------------------------------------------------
+
+static void Test_Real_Clock(void)
+{
+	const int RATE=60;
+	cSocketTickClock clock;
+	cServerTickScheduler scheduler(&clock);
+	scheduler.Set_Tick_Rate(RATE);
+
+	unsigned long worst=0;
+	unsigned long total=0;
+	unsigned long start=clock.Get_Time_Us();
+	for (int i=0;i<=RATE;i++) {
+		scheduler.Wait();
+		unsigned long lateness=scheduler.Get_Tick_Lateness_Us();
+		total+=lateness;
+		if (lateness>worst) worst=lateness;
+	}
+	unsigned long elapsed=clock.Get_Time_Us()-start;
+
+	printf("real clock: %d ticks in %.3f s, lateness average %lu us, worst %lu us\n",
+		RATE,double(elapsed)/1000000.0,total/(RATE+1),worst);
+	Check(elapsed>=990000 && elapsed<1500000,"real clock: a second of ticks took the wrong time");
+}
+
+int main(void)
+{
+	Test_Steady();
+	Test_Input();
+	Test_Overrun(cServerTickScheduler::DEFAULT_MAX_CATCH_UP_TICKS);
+	Test_Overrun(0);
+	Test_Overrun(20);
+	Test_Wrap();
+	Test_Rate_Change();
+	Test_Real_Clock();
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
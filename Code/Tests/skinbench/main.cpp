@@ -0,0 +1,365 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Skinning Benchmark                                           *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/skinbench/main.cpp                     $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Deforms synthetic skinned meshes with every SkinKernelClass kernel, serially and split      *
+ * across the worker pool, and compares them with the original per-vertex code. Meshes of      *
+ * awkward sizes, bones with very short runs and unsorted bone links are included. Then times  *
+ * a crowd of characters with each kernel.                                                     *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "skinkernel.h"
+#include "matrix3d.h"
+#include "vector3.h"
+#include "workerpool.h"
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+enum {
+	BONE_COUNT=48,
+	CROWD_SIZE=32,
+	CROWD_VERTEX_COUNT=3000,
+	PASSES=50,
+	GUARD=8
+};
+
+static int Failures=0;
+
+static void Check(bool ok,const char * what)
+{
+	if (!ok) {
+		printf("%s FAILED\n",what);
+		Failures++;
+	}
+}
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+static unsigned Random_State=12345;
+static unsigned Random(void)
+{
+	Random_State=Random_State*1664525+1013904223;
+	return Random_State>>8;
+}
+
+static float Random_Float(float min,float max)
+{
+	return min+(max-min)*(float)(Random()&0xffff)/65535.0f;
+}
+
+static const char * Kernel_Name(SkinKernelClass::KernelType kernel)
+{
+	switch (kernel) {
+		case SkinKernelClass::KERNEL_SCALAR:	return "scalar";
+		case SkinKernelClass::KERNEL_SSE:		return "SSE";
+		case SkinKernelClass::KERNEL_AVX2:		return "AVX2";
+		default:											return "best";
+	}
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// A skinned mesh: vertices, unit normals and bone links. Sorted meshes have
+// runs of random length per bone like the exporter writes them.
+//
+// ----------------------------------------------------------------------------
+
+struct SkinMeshStruct
+{
+	SkinMeshStruct(int count) : Count(count)
+	{
+		Verts=new Vector3[count+1];
+		Norms=new Vector3[count+1];
+		Links=new uint16[count+1];
+	}
+	~SkinMeshStruct(void)
+	{
+		delete [] Verts;
+		delete [] Norms;
+		delete [] Links;
+	}
+
+	int		Count;
+	Vector3*	Verts;
+	Vector3*	Norms;
+	uint16*	Links;
+};
+
+static void Build_Mesh(SkinMeshStruct & mesh,int max_run,bool sorted)
+{
+	int bone=0;
+	int run=0;
+	for (int i=0;i<mesh.Count;++i) {
+		mesh.Verts[i].Set(Random_Float(-2.0f,2.0f),Random_Float(-2.0f,2.0f),Random_Float(0.0f,4.0f));
+		mesh.Norms[i].Set(Random_Float(-1.0f,1.0f),Random_Float(-1.0f,1.0f),Random_Float(-1.0f,1.0f));
+		mesh.Norms[i].Normalize();
+
+		if (sorted) {
+			if (run<=0) {
+				bone=Random()%BONE_COUNT;
+				run=1+Random()%max_run;
+			}
+			run--;
+			mesh.Links[i]=(uint16)bone;
+		} else {
+			mesh.Links[i]=(uint16)(Random()%BONE_COUNT);
+		}
+	}
+}
+
+static void Build_Bones(Matrix3D * bones)
+{
+	for (int i=0;i<BONE_COUNT;++i) {
+		bones[i].Make_Identity();
+		bones[i].Rotate_X(Random_Float(-3.0f,3.0f));
+		bones[i].Rotate_Y(Random_Float(-3.0f,3.0f));
+		bones[i].Rotate_Z(Random_Float(-3.0f,3.0f));
+		bones[i].Set_Translation(Vector3(Random_Float(-50.0f,50.0f),Random_Float(-50.0f,50.0f),Random_Float(-5.0f,5.0f)));
+	}
+}
+
+static bool Close(const Vector3 * a,const Vector3 * b,int count)
+{
+	for (int i=0;i<count;++i) {
+		for (int j=0;j<3;++j) {
+			float tolerance=1.0e-5f*(1.0f+(float)fabs(a[i][j]));
+			if (fabs(a[i][j]-b[i][j])>tolerance) return false;
+		}
+	}
+	return true;
+}
+
+// Everything past the end of the mesh must be left alone
+static void Fill_Guard(Vector3 * dst,int count)
+{
+	memset(dst,0xcd,sizeof(Vector3)*(count+GUARD));
+}
+
+static bool Guard_Intact(const Vector3 * dst,int count)
+{
+	const unsigned char * bytes=(const unsigned char *)(dst+count);
+	for (unsigned i=0;i<sizeof(Vector3)*GUARD;++i) {
+		if (bytes[i]!=0xcd) return false;
+	}
+	return true;
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// Every kernel, with and without normals and worker threads, against the
+// reference. The SIMD kernels round exactly like the scalar kernel.
+//
+// ----------------------------------------------------------------------------
+
+static void Test_Mesh(const SkinMeshStruct & mesh,const Matrix3D * bones,const char * what)
+{
+	int count=mesh.Count;
+	Vector3 * ref_verts=new Vector3[count+GUARD];
+	Vector3 * ref_norms=new Vector3[count+GUARD];
+	Vector3 * scalar_verts=new Vector3[count+GUARD];
+	Vector3 * scalar_norms=new Vector3[count+GUARD];
+	Vector3 * verts=new Vector3[count+GUARD];
+	Vector3 * norms=new Vector3[count+GUARD];
+	char name[256];
+
+	SkinKernelClass::Deform_Reference(ref_verts,ref_norms,mesh.Verts,mesh.Norms,mesh.Links,count,bones);
+
+	SkinKernelClass::Set_Kernel(SkinKernelClass::KERNEL_SCALAR);
+	SkinKernelClass::Enable_Parallel(false);
+	SkinKernelClass::Deform(scalar_verts,scalar_norms,mesh.Verts,mesh.Norms,mesh.Links,count,bones);
+	sprintf(name,"%s: scalar matches reference",what);
+	Check(Close(scalar_verts,ref_verts,count) && Close(scalar_norms,ref_norms,count),name);
+
+	for (int k=SkinKernelClass::KERNEL_SCALAR;k<SkinKernelClass::KERNEL_BEST;++k) {
+		SkinKernelClass::Set_Kernel((SkinKernelClass::KernelType)k);
+		if (SkinKernelClass::Get_Kernel()!=k) {
+			continue;
+		}
+
+		for (int parallel=0;parallel<2;++parallel) {
+			SkinKernelClass::Enable_Parallel(parallel!=0);
+			const char * mode=parallel ? "parallel" : "serial";
+
+			Fill_Guard(verts,count);
+			Fill_Guard(norms,count);
+			SkinKernelClass::Deform(verts,norms,mesh.Verts,mesh.Norms,mesh.Links,count,bones);
+			sprintf(name,"%s: %s %s matches scalar",what,Kernel_Name((SkinKernelClass::KernelType)k),mode);
+			Check(	memcmp(verts,scalar_verts,sizeof(Vector3)*count)==0 &&
+						memcmp(norms,scalar_norms,sizeof(Vector3)*count)==0,name);
+			sprintf(name,"%s: %s %s stays in bounds",what,Kernel_Name((SkinKernelClass::KernelType)k),mode);
+			Check(Guard_Intact(verts,count) && Guard_Intact(norms,count),name);
+
+			// Positions only
+			Fill_Guard(verts,count);
+			SkinKernelClass::Deform(verts,NULL,mesh.Verts,NULL,mesh.Links,count,bones);
+			sprintf(name,"%s: %s %s positions only",what,Kernel_Name((SkinKernelClass::KernelType)k),mode);
+			Check(	memcmp(verts,scalar_verts,sizeof(Vector3)*count)==0 && Guard_Intact(verts,count),name);
+		}
+	}
+
+	SkinKernelClass::Set_Kernel(SkinKernelClass::KERNEL_BEST);
+	SkinKernelClass::Enable_Parallel(true);
+
+	delete [] ref_verts;
+	delete [] ref_norms;
+	delete [] scalar_verts;
+	delete [] scalar_norms;
+	delete [] verts;
+	delete [] norms;
+}
+
+static void Test_Kernels(const Matrix3D * bones)
+{
+	static const int sizes[]={ 0,1,2,3,4,5,7,8,9,11,16,17,100,1023,4096,20001 };
+	char what[64];
+
+	for (unsigned s=0;s<sizeof(sizes)/sizeof(sizes[0]);++s) {
+		SkinMeshStruct mesh(sizes[s]);
+		Build_Mesh(mesh,40,true);
+		sprintf(what,"%d vertices",sizes[s]);
+		Test_Mesh(mesh,bones,what);
+	}
+
+	// Runs shorter than a SIMD register
+	SkinMeshStruct short_runs(5000);
+	Build_Mesh(short_runs,3,true);
+	Test_Mesh(short_runs,bones,"short runs");
+
+	// A new bone on every vertex
+	SkinMeshStruct unsorted(5000);
+	Build_Mesh(unsorted,1,false);
+	Test_Mesh(unsorted,bones,"unsorted");
+}
+
+
+// ----------------------------------------------------------------------------
+//
+// Skin a crowd of characters with each kernel
+//
+// ----------------------------------------------------------------------------
+
+static void Time_Crowd(const Matrix3D * bones)
+{
+	SkinMeshStruct * crowd[CROWD_SIZE];
+	for (int i=0;i<CROWD_SIZE;++i) {
+		crowd[i]=new SkinMeshStruct(CROWD_VERTEX_COUNT);
+		Build_Mesh(*crowd[i],60,true);
+	}
+	Vector3 * verts=new Vector3[CROWD_VERTEX_COUNT];
+	Vector3 * norms=new Vector3[CROWD_VERTEX_COUNT];
+
+	// One big mesh to show the worker split
+	SkinMeshStruct big(CROWD_SIZE*CROWD_VERTEX_COUNT);
+	Build_Mesh(big,60,true);
+	Vector3 * big_verts=new Vector3[big.Count];
+	Vector3 * big_norms=new Vector3[big.Count];
+
+	printf("\n%d characters of %d vertices, %d worker threads\n",CROWD_SIZE,CROWD_VERTEX_COUNT,WorkerPoolClass::Get_Thread_Count());
+	double reference_time=0.0;
+	LARGE_INTEGER begin,end;
+
+	QueryPerformanceCounter(&begin);
+	for (int pass=0;pass<PASSES;++pass) {
+		for (int i=0;i<CROWD_SIZE;++i) {
+			SkinKernelClass::Deform_Reference(verts,norms,crowd[i]->Verts,crowd[i]->Norms,crowd[i]->Links,crowd[i]->Count,bones);
+		}
+	}
+	QueryPerformanceCounter(&end);
+	reference_time=Seconds(begin,end)/PASSES;
+	printf("  reference:        %7.3f ms/frame\n",reference_time*1000.0);
+
+	for (int k=SkinKernelClass::KERNEL_SCALAR;k<SkinKernelClass::KERNEL_BEST;++k) {
+		SkinKernelClass::Set_Kernel((SkinKernelClass::KernelType)k);
+		if (SkinKernelClass::Get_Kernel()!=k) {
+			continue;
+		}
+
+		SkinKernelClass::Enable_Parallel(false);
+		QueryPerformanceCounter(&begin);
+		for (int pass=0;pass<PASSES;++pass) {
+			for (int i=0;i<CROWD_SIZE;++i) {
+				SkinKernelClass::Deform(verts,norms,crowd[i]->Verts,crowd[i]->Norms,crowd[i]->Links,crowd[i]->Count,bones);
+			}
+		}
+		QueryPerformanceCounter(&end);
+		double crowd_time=Seconds(begin,end)/PASSES;
+
+		SkinKernelClass::Enable_Parallel(true);
+		QueryPerformanceCounter(&begin);
+		for (int pass=0;pass<PASSES;++pass) {
+			SkinKernelClass::Deform(big_verts,big_norms,big.Verts,big.Norms,big.Links,big.Count,bones);
+		}
+		QueryPerformanceCounter(&end);
+		double big_time=Seconds(begin,end)/PASSES;
+
+		printf("  %-8s crowd:   %7.3f ms/frame (%.2fx), one mesh split across workers: %7.3f ms (%.1f Mverts/s)\n",
+			Kernel_Name((SkinKernelClass::KernelType)k),
+			crowd_time*1000.0,
+			reference_time/crowd_time,
+			big_time*1000.0,
+			big.Count/big_time/1.0e6);
+	}
+
+	SkinKernelClass::Set_Kernel(SkinKernelClass::KERNEL_BEST);
+	SkinKernelClass::Enable_Parallel(true);
+
+	for (int i=0;i<CROWD_SIZE;++i) {
+		delete crowd[i];
+	}
+	delete [] verts;
+	delete [] norms;
+	delete [] big_verts;
+	delete [] big_norms;
+}
+
+int main(int argc,char * argv[])
+{
+	Matrix3D bones[BONE_COUNT];
+	Build_Bones(bones);
+
+	// No worker threads first, then the real pool
+	WorkerPoolClass::Init(0);
+	Test_Kernels(bones);
+	WorkerPoolClass::Shutdown();
+
+	WorkerPoolClass::Init();
+	Test_Kernels(bones);
+	Time_Crowd(bones);
+	WorkerPoolClass::Shutdown();
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
@@ -0,0 +1,302 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : DynamicVectorClass Benchmark                                 *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/vectorbench/main.cpp                   $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Times appending to, erasing from and refilling DynamicVectorClass against a copy of the    *
+ * old fixed step growth for the element types the engine stores: object pointers, ints,     *
+ * Vector3s and StringClass. The contents of both vectors are checked after every test.       *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "vector.h"
+#include "wwstring.h"
+#include "vector3.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int Failures=0;
+
+// ----------------------------------------------------------------------------
+//
+// The old DynamicVectorClass behaviour: grow by a fixed GrowthStep of 10 and
+// copy every element through its assignment operator on each resize and
+// delete.
+//
+// ----------------------------------------------------------------------------
+
+template<class T>
+class LegacyVectorClass
+{
+public:
+	LegacyVectorClass() : Vector(NULL), VectorMax(0), ActiveCount(0), GrowthStep(10) {}
+	~LegacyVectorClass() { delete[] Vector; }
+
+	int Count() const { return ActiveCount; }
+	T& operator[](int index) { return Vector[index]; }
+
+	bool Resize(int newsize)
+	{
+		T* newptr=new T[newsize];
+		int copycount=(newsize<VectorMax) ? newsize : VectorMax;
+		for (int index=0;index<copycount;index++) {
+			newptr[index]=Vector[index];
+		}
+		delete[] Vector;
+		Vector=newptr;
+		VectorMax=newsize;
+		return true;
+	}
+
+	bool Add(T const& object)
+	{
+		if (ActiveCount>=VectorMax) {
+			Resize(VectorMax+GrowthStep);
+		}
+		Vector[ActiveCount++]=object;
+		return true;
+	}
+
+	bool Delete(int index)
+	{
+		if (index<ActiveCount) {
+			ActiveCount--;
+			for (int i=index;i<ActiveCount;i++) {
+				Vector[i]=Vector[i+1];
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void Delete_All()
+	{
+		int len=VectorMax;
+		delete[] Vector;
+		Vector=NULL;
+		VectorMax=0;
+		ActiveCount=0;
+		Resize(len);
+	}
+
+protected:
+	T* Vector;
+	int VectorMax;
+	int ActiveCount;
+	int GrowthStep;
+};
+
+// ----------------------------------------------------------------------------
+//
+// Element values.  Every type is made from an int so the contents of the two
+// vectors can be compared.
+//
+// ----------------------------------------------------------------------------
+
+struct PhysPtrType
+{
+	typedef void* Type;
+	static const char* Get_Name() { return "object pointer"; }
+	static Type Make(int i) { return (void*)(size_t)(i*16); }
+	static bool Equal(const Type& a,const Type& b) { return a==b; }
+};
+
+struct IntType
+{
+	typedef int Type;
+	static const char* Get_Name() { return "int"; }
+	static Type Make(int i) { return i; }
+	static bool Equal(const Type& a,const Type& b) { return a==b; }
+};
+
+struct Vector3Type
+{
+	typedef Vector3 Type;
+	static const char* Get_Name() { return "Vector3"; }
+	static Type Make(int i) { return Vector3((float)i,(float)(i+1),(float)(i+2)); }
+	static bool Equal(const Type& a,const Type& b) { return a==b; }
+};
+
+struct StringType
+{
+	typedef StringClass Type;
+	static const char* Get_Name() { return "StringClass"; }
+	static Type Make(int i) { StringClass str; str.Format("definition_%d",i); return str; }
+	static bool Equal(const Type& a,const Type& b) { return ::strcmp(a,b)==0; }
+};
+
+// ----------------------------------------------------------------------------
+//
+// Tests.  Each returns the time in milliseconds for one vector type.
+//
+// ----------------------------------------------------------------------------
+
+static double Seconds(const LARGE_INTEGER& begin,const LARGE_INTEGER& end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+template<class E,class V>
+static void Fill(V& vector,typename E::Type* values,int count)
+{
+	for (int i=0;i<count;i++) {
+		vector.Add(values[i]);
+	}
+}
+
+template<class E,class V1,class V2>
+static void Check(const char* test,V1& a,V2& b)
+{
+	bool ok=(a.Count()==b.Count());
+	for (int i=0;ok && i<a.Count();i++) {
+		ok=E::Equal(a[i],b[i]);
+	}
+	if (!ok) {
+		printf("%s %s: contents differ FAILED\n",E::Get_Name(),test);
+		Failures++;
+	}
+}
+
+template<class E>
+static void Run(int count)
+{
+	typedef typename E::Type T;
+	T* values=new T[count];
+	for (int i=0;i<count;i++) {
+		values[i]=E::Make(i);
+	}
+
+	LARGE_INTEGER t0,t1,t2;
+	double legacy_ms,new_ms;
+	printf("%-16s %7d",E::Get_Name(),count);
+
+	// Append
+	{
+		LegacyVectorClass<T> legacy;
+		DynamicVectorClass<T> vector;
+		QueryPerformanceCounter(&t0);
+		Fill<E>(legacy,values,count);
+		QueryPerformanceCounter(&t1);
+		Fill<E>(vector,values,count);
+		QueryPerformanceCounter(&t2);
+		legacy_ms=Seconds(t0,t1)*1000.0;
+		new_ms=Seconds(t1,t2)*1000.0;
+		printf(" %9.2f %9.2f",legacy_ms,new_ms);
+		Check<E>("append",legacy,vector);
+	}
+
+	// Erase every other element from the front half
+	{
+		LegacyVectorClass<T> legacy;
+		DynamicVectorClass<T> vector;
+		Fill<E>(legacy,values,count);
+		Fill<E>(vector,values,count);
+		int erase_count=MIN(count/2,2000);
+		QueryPerformanceCounter(&t0);
+		for (int i=0;i<erase_count;i++) {
+			legacy.Delete(i);
+		}
+		QueryPerformanceCounter(&t1);
+		for (int i=0;i<erase_count;i++) {
+			vector.Delete(i);
+		}
+		QueryPerformanceCounter(&t2);
+		legacy_ms=Seconds(t0,t1)*1000.0;
+		new_ms=Seconds(t1,t2)*1000.0;
+		printf(" %9.2f %9.2f",legacy_ms,new_ms);
+		Check<E>("erase",legacy,vector);
+	}
+
+	// Clear and refill, the way the per-frame lists are used
+	{
+		LegacyVectorClass<T> legacy;
+		DynamicVectorClass<T> vector;
+		Fill<E>(legacy,values,count);
+		Fill<E>(vector,values,count);
+		QueryPerformanceCounter(&t0);
+		for (int frame=0;frame<10;frame++) {
+			legacy.Delete_All();
+			Fill<E>(legacy,values,count);
+		}
+		QueryPerformanceCounter(&t1);
+		for (int frame=0;frame<10;frame++) {
+			vector.Delete_All();
+			Fill<E>(vector,values,count);
+		}
+		QueryPerformanceCounter(&t2);
+		legacy_ms=Seconds(t0,t1)*1000.0;
+		new_ms=Seconds(t1,t2)*1000.0;
+		printf(" %9.2f %9.2f\n",legacy_ms,new_ms);
+		Check<E>("refill",legacy,vector);
+	}
+
+	delete[] values;
+}
+
+template<class E>
+static void Run_All(void)
+{
+	static const int counts[]={ 100, 1000, 10000, 50000 };
+	for (int i=0;i<sizeof(counts)/sizeof(counts[0]);i++) {
+		Run<E>(counts[i]);
+	}
+}
+
+int main(void)
+{
+	printf("Milliseconds, old fixed step vector vs DynamicVectorClass:\n\n");
+	printf("%-16s %7s %19s %19s %19s\n","","count","append","erase","10x refill");
+
+	Run_All<PhysPtrType>();
+	Run_All<IntType>();
+	Run_All<Vector3Type>();
+	Run_All<StringType>();
+
+	// Reserve and Shrink_To_Fit
+	DynamicVectorClass<int> vector;
+	vector.Reserve(1000);
+	int length=vector.Length();
+	for (int i=0;i<1000;i++) {
+		vector.Add(i);
+	}
+	if (length!=1000 || vector.Length()!=1000) {
+		printf("Reserve resized the vector FAILED\n");
+		Failures++;
+	}
+	for (int i=0;i<500;i++) {
+		vector.Delete(vector.Count()-1);
+	}
+	vector.Shrink_To_Fit();
+	if (vector.Length()!=500 || vector[499]!=499) {
+		printf("Shrink_To_Fit FAILED\n");
+		Failures++;
+	}
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
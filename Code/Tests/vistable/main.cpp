@@ -0,0 +1,308 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Vis Table Test Program                                       *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/Tests/vistable/main.cpp                      $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Checks the SSE2 VisTableClass bit operations against a bit by bit reference, round trips   *
+ * tables through both compression codecs, and walks a camera through a set of vis sectors    *
+ * to report the decompression cost per sector change with the LZO and run length codecs.     *
+ *                                                                                             *
+ * Arguments: [vis object count] [vis sector count]                                            *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "vistable.h"
+#include "vistablemgr.h"
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int ObjectCount=20000;
+static int SectorCount=500;
+
+const int SECTOR_CHANGES=5000;
+
+static int Failures=0;
+
+static void Check(bool expr,const char* name)
+{
+	if (!expr) {
+		printf("%s: FAILED\n",name);
+		Failures++;
+	}
+}
+
+static unsigned Random_State=12345;
+static unsigned Random(void)
+{
+	Random_State=Random_State*1664525+1013904223;
+	return Random_State>>8;
+}
+
+static double Seconds(const LARGE_INTEGER & begin,const LARGE_INTEGER & end)
+{
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return double(end.QuadPart-begin.QuadPart)/double(freq.QuadPart);
+}
+
+// Vis tables are mostly long runs of invisible objects with clusters of visible ones (objects
+// near each other get consecutive ids).  density is the fraction of the table in clusters.
+static VisTableClass * Create_Table(int bit_count,int id,float density)
+{
+	VisTableClass * table=NEW_REF(VisTableClass,(bit_count,id));
+	int i=0;
+	while (i<bit_count) {
+		int run=1+Random()%200;
+		bool visible=(Random()%1000)<(unsigned)(density*1000.0f);
+		for (int j=0;(j<run) && (i<bit_count);++j,++i) {
+			if (visible && ((density>=1.0f) || (Random()%4!=0))) {
+				table->Set_Bit(i,true);
+			}
+		}
+	}
+	table->Set_Bit(0,true);
+	return table;
+}
+
+static int Reference_Count(const VisTableClass & table)
+{
+	int count=0;
+	for (int i=0;i<table.Get_Bit_Count();++i) {
+		if (table.Get_Bit(i)) count++;
+	}
+	return count;
+}
+
+static int Reference_Differences(const VisTableClass & a,const VisTableClass & b)
+{
+	int count=0;
+	for (int i=0;i<a.Get_Bit_Count();++i) {
+		if ((a.Get_Bit(i)!=0)!=(b.Get_Bit(i)!=0)) count++;
+	}
+	return count;
+}
+
+static bool Same_Bits(const VisTableClass & a,const VisTableClass & b)
+{
+	return Reference_Differences(a,b)==0;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Bit operations, every kernel must give the same answers as the bit by bit versions
+//
+// ----------------------------------------------------------------------------
+
+static void Test_Bit_Operations(VisTableClass::KernelType kernel,const char * name)
+{
+	VisTableClass::Set_Kernel(kernel);
+	printf("%s bit operations\n",name);
+
+	// odd sizes to exercise the scalar tails of the SSE2 loops
+	static const int sizes[]={1,31,32,33,127,128,129,1000,ObjectCount};
+	for (int s=0;s<sizeof(sizes)/sizeof(sizes[0]);++s) {
+		int bit_count=sizes[s];
+		VisTableClass * a=Create_Table(bit_count,0,0.3f);
+		VisTableClass * b=Create_Table(bit_count,1,0.5f);
+
+		int count_a=Reference_Count(*a);
+		int diffs=Reference_Differences(*a,*b);
+
+		Check(a->Count_True_Bits()==count_a,"Count_True_Bits");
+		Check(a->Count_Differences(*b)==diffs,"Count_Differences");
+
+		VisTableClass merged(*a);
+		merged.Merge(*b);
+		int count_or=Reference_Count(merged);
+		bool merge_ok=true;
+		for (int i=0;i<bit_count;++i) {
+			merge_ok&=((merged.Get_Bit(i)!=0)==((a->Get_Bit(i)!=0)||(b->Get_Bit(i)!=0)));
+		}
+		Check(merge_ok,"Merge");
+
+		float expected=(count_or==0) ? 1.0f : 1.0f-(float)diffs/(float)count_or;
+		Check(a->Match_Fraction(*b)==expected,"Match_Fraction");
+
+		VisTableClass inverted(*a);
+		inverted.Invert();
+		bool invert_ok=true;
+		for (int i=0;i<bit_count;++i) {
+			invert_ok&=((inverted.Get_Bit(i)!=0)!=(a->Get_Bit(i)!=0));
+		}
+		Check(invert_ok,"Invert");
+
+		REF_PTR_RELEASE(a);
+		REF_PTR_RELEASE(b);
+	}
+}
+
+static void Time_Bit_Operations(VisTableClass::KernelType kernel,const char * name)
+{
+	VisTableClass::Set_Kernel(kernel);
+
+	const int TABLE_COUNT=64;
+	VisTableClass * tables[TABLE_COUNT];
+	int i,j;
+	Random_State=12345;
+	for (i=0;i<TABLE_COUNT;++i) {
+		tables[i]=Create_Table(ObjectCount,i,0.3f);
+	}
+
+	// all pairs, the way Optimize_Visibility_Data compares sectors
+	LARGE_INTEGER begin,end;
+	QueryPerformanceCounter(&begin);
+	float total=0.0f;
+	for (i=0;i<TABLE_COUNT;++i) {
+		for (j=0;j<TABLE_COUNT;++j) {
+			total+=tables[i]->Match_Fraction(*tables[j]);
+			total+=(float)tables[i]->Count_Differences(*tables[j]);
+		}
+	}
+	QueryPerformanceCounter(&end);
+
+	printf("%-8s %12.3f us per table pair (%g)\n",name,Seconds(begin,end)*1000000.0/(TABLE_COUNT*TABLE_COUNT),total);
+
+	for (i=0;i<TABLE_COUNT;++i) {
+		REF_PTR_RELEASE(tables[i]);
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// Codecs, tables must come back the same no matter how they were compressed
+//
+// ----------------------------------------------------------------------------
+
+static void Test_Codecs(void)
+{
+	printf("codec round trips\n");
+
+	static const float densities[]={0.0f,0.01f,0.2f,0.6f,1.0f};
+	static const int sizes[]={1,32,100,ObjectCount,70000*32};
+	for (int d=0;d<sizeof(densities)/sizeof(densities[0]);++d) {
+		for (int s=0;s<sizeof(sizes)/sizeof(sizes[0]);++s) {
+			VisTableClass * table=Create_Table(sizes[s],0,densities[d]);
+			for (int c=0;c<=CompressedVisTableClass::CODEC_BEST;++c) {
+				CompressedVisTableClass::Set_Preferred_Codec((CompressedVisTableClass::CodecType)c);
+				CompressedVisTableClass ctable(table);
+				Check((c==CompressedVisTableClass::CODEC_BEST) || (ctable.Get_Codec()==c),"Codec");
+
+				CompressedVisTableClass copy(ctable);
+				VisTableClass * result=NEW_REF(VisTableClass,(&copy,sizes[s],0));
+				Check(Same_Bits(*table,*result),"Round trip");
+				REF_PTR_RELEASE(result);
+			}
+			REF_PTR_RELEASE(table);
+		}
+	}
+	CompressedVisTableClass::Set_Preferred_Codec(CompressedVisTableClass::CODEC_BEST);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Walk a camera through the sectors and measure what the sector changes cost.  The camera
+// mostly moves between neighboring sectors and sometimes jumps somewhere else.
+//
+// ----------------------------------------------------------------------------
+
+static void Time_Sector_Changes(CompressedVisTableClass::CodecType codec,const char * name,int budget)
+{
+	CompressedVisTableClass::Set_Preferred_Codec(codec);
+
+	VisTableMgrClass mgr;
+	mgr.Allocate_Vis_Object_ID(ObjectCount-1);
+	mgr.Allocate_Vis_Sector_ID(SectorCount);
+	mgr.Set_Cache_Budget(budget);
+
+	int i;
+	int compressed_bytes=0;
+	Random_State=12345;
+	for (i=0;i<SectorCount;++i) {
+		VisTableClass * table=Create_Table(ObjectCount,i,0.2f);
+		CompressedVisTableClass ctable(table);
+		compressed_bytes+=ctable.Get_Byte_Count();
+		mgr.Update_Vis_Table(i,table);
+		REF_PTR_RELEASE(table);
+	}
+
+	mgr.Reset_Statistics();
+	int sector=0;
+	int largest_cache=0;
+	for (i=0;i<SECTOR_CHANGES;++i) {
+		if (Random()%10==0) {
+			sector=Random()%SectorCount;
+		} else {
+			sector=(sector+SectorCount+(int)(Random()%5)-2)%SectorCount;
+		}
+		VisTableClass * pvs=mgr.Get_Vis_Table(sector);
+		Check((pvs!=NULL) && (pvs->Get_Vis_Sector_ID()==sector),"Get_Vis_Table");
+		REF_PTR_RELEASE(pvs);
+		largest_cache=MAX(largest_cache,mgr.Get_Cache_Size());
+		mgr.Notify_Frame_Ended();
+	}
+
+	const VisTableMgrClass::StatsStruct & stats=mgr.Get_Statistics();
+	float per_change=stats.DecompressMicroseconds/(float)SECTOR_CHANGES;
+	float per_decompression=(stats.Decompressions>0) ? stats.DecompressMicroseconds/(float)stats.Decompressions : 0.0f;
+	printf("%-6s %8dK %10d %10d %10.2f %10.2f %10dK\n",
+		name,budget/1024,compressed_bytes/SectorCount,stats.Decompressions,per_decompression,per_change,largest_cache/1024);
+
+	// the cache can only go over budget by the table that was just added
+	VisTableClass sample(ObjectCount,0);
+	Check(largest_cache<=MAX(budget,sample.Get_Memory_Size()),"Cache budget");
+
+	CompressedVisTableClass::Set_Preferred_Codec(CompressedVisTableClass::CODEC_BEST);
+}
+
+int main(int argc,char * argv[])
+{
+	if (argc>1) ObjectCount=atoi(argv[1]);
+	if (argc>2) SectorCount=atoi(argv[2]);
+	if ((ObjectCount<=1) || (SectorCount<=0)) {
+		printf("usage: vistable [vis object count] [vis sector count]\n");
+		return 1;
+	}
+
+	Test_Bit_Operations(VisTableClass::KERNEL_SCALAR,"scalar");
+	Test_Bit_Operations(VisTableClass::KERNEL_SSE2,"sse2");
+	Test_Codecs();
+
+	printf("\n%d vis objects, %d sectors\n\n",ObjectCount,SectorCount);
+	Time_Bit_Operations(VisTableClass::KERNEL_SCALAR,"scalar");
+	Time_Bit_Operations(VisTableClass::KERNEL_SSE2,"sse2");
+	VisTableClass::Set_Kernel(VisTableClass::KERNEL_BEST);
+
+	printf("\n%-6s %9s %10s %10s %10s %10s %11s\n","codec","budget","bytes","decomps","us/decomp","us/change","max cache");
+	static const int budgets[]={4096*1024,256*1024,0};
+	for (int b=0;b<sizeof(budgets)/sizeof(budgets[0]);++b) {
+		Time_Sector_Changes(CompressedVisTableClass::CODEC_LZO,"lzo",budgets[b]);
+		Time_Sector_Changes(CompressedVisTableClass::CODEC_RLE,"rle",budgets[b]);
+		Time_Sector_Changes(CompressedVisTableClass::CODEC_BEST,"best",budgets[b]);
+	}
+
+	printf("\n%d failures\n",Failures);
+	return Failures ? 1 : 0;
+}
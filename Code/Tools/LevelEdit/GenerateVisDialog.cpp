@@ -163,6 +163,11 @@ GenerateVisDialogClass::OnOK (void)
 		// Now vis the light sources
 		//
 		scene->Generate_Light_Vis ();
+
+		//
+		// The light probes use the light vis, so bake them last
+		//
+		scene->Bake_Light_Probes ();
 	}
 
 	//
@@ -191,13 +191,18 @@ LightSolveProgressDialog::Update_Stats (void)
 	int current	= progress->Get_Processed_Object_Count ();
 	
 	CString status_text;
-	status_text.Format ("%d of %d objects solved.", current, total);
+	status_text.Format ("%d of %d objects solved (%d worker threads).", current, total, progress->Get_Worker_Count ());
 	SetDlgItemText (IDC_STATUS_TEXT,status_text);
 
 	//
-	//	Update the progress bar
+	//	Update the progress bar, the vertex counts are collected from all of
+	// the worker threads so they move more smoothly than the object count
 	//
-	if (total > 0) {
+	int total_verts	= progress->Get_Total_Vertex_Count ();
+	int current_verts	= progress->Get_Processed_Vertex_Count ();
+	if (total_verts > 0) {
+		m_ProgressBar.SetPos ((int)(((__int64)current_verts * 100) / total_verts));
+	} else if (total > 0) {
 		m_ProgressBar.SetPos ((current * 100) / total);
 	}
 
@@ -134,6 +134,7 @@
 #include "mixfiledatabase.h"
 #include "assetpackagemgr.h"
 #include "lightsolveoptionsdialog.h"
+#include "workerpool.h"
 
 
 #ifdef _DEBUG
@@ -1776,6 +1777,7 @@ CMainFrame::OnDestroy (void)
 	//WW3D::Flush_Texture_Cache ();
 	WW3D::Shutdown ();	
 	SAFE_DELETE (_pThe3DAssetManager);
+	WorkerPoolClass::Shutdown ();
 
 	::RemoveProp (m_AniToolbar, "ALLOW_UPDATE");
 
@@ -169,6 +169,12 @@ OptimizingVisDialogClass::Update_Stats (void)
 	
 	CString status_text;
 	status_text.Format ("%d of %d operations completed.", current, total);
+	if (current > 0 && current < total) {
+		int seconds = (int)m_ProgressStats->Get_Estimated_Seconds_Remaining ();
+		CString eta_text;
+		eta_text.Format ("  About %d:%02d remaining.", seconds / 60, seconds % 60);
+		status_text += eta_text;
+	}
 	SetDlgItemText (IDC_STATUS_TEXT,status_text);
 
 	//
@@ -399,10 +399,19 @@ WWAudioClass::Find_Cached_Buffer (const char *string_id)
 	WWASSERT (string_id != NULL);
 	if (string_id != NULL) {
 
+		//
+		// Every cached buffer's name is interned, so a name that isn't
+		// can't be in the cache.
+		//
+		NameClass name = NameClass::Find (string_id);
+		if (name.Is_Empty ()) {
+			return NULL;
+		}
+
 		//
 		// Determine which index in our hash table to use
 		//
-		int hash_index = ::CRC_Stringi (string_id) & CACHE_HASH_MASK;
+		int hash_index = name.Get_Hash () & CACHE_HASH_MASK;
 
 		//
 		// Loop through all the buffers at this hash index and try to find
@@ -414,7 +423,7 @@ WWAudioClass::Find_Cached_Buffer (const char *string_id)
 			// Is this the sound buffer we were looking for?
 			//
 			CACHE_ENTRY_STRUCT &info = m_CachedBuffers[hash_index][index];
-			if (::lstrcmpi (info.string_id, string_id) == 0) {
+			if (info.name == name) {
 				sound_buffer = info.buffer;
 				sound_buffer->Add_Ref ();
 				break;
@@ -513,7 +522,8 @@ WWAudioClass::Cache_Buffer
 			//
 			// Determine which index in our hash table to use
 			//
-			int hash_index = ::CRC_Stringi (string_id) & CACHE_HASH_MASK;
+			NameClass name (string_id);
+			int hash_index = name.Get_Hash () & CACHE_HASH_MASK;
 
 			//
 			// Add this buffer to the hash table at the given index.
@@ -522,6 +532,7 @@ WWAudioClass::Cache_Buffer
 			//
 			CACHE_ENTRY_STRUCT info;
 			info.string_id = (char *)string_id;
+			info.name = name;
 			info.buffer = buffer;
 			m_CachedBuffers[hash_index].Add (info);
 
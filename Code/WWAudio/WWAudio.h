@@ -55,6 +55,7 @@
 #include "SoundBuffer.H"
 #include "AudioEvents.H"
 #include "wwstring.h"
+#include "nametable.h"
 
 #include "audio_crate.hpp"
 
@@ -600,12 +601,13 @@ private:
 	typedef struct _CACHE_ENTRY_STRUCT
 	{
 		char *					string_id;
+		NameClass				name;			// interned string_id
 		SoundBufferClass *	buffer;
 
 		_CACHE_ENTRY_STRUCT (void)
 			: string_id (0), buffer (NULL) {}
 
-		_CACHE_ENTRY_STRUCT &operator= (const _CACHE_ENTRY_STRUCT &src) { string_id = ::strdup (src.string_id); REF_PTR_SET (buffer, src.buffer); return *this; }
+		_CACHE_ENTRY_STRUCT &operator= (const _CACHE_ENTRY_STRUCT &src) { string_id = ::strdup (src.string_id); name = src.name; REF_PTR_SET (buffer, src.buffer); return *this; }
 		bool operator== (const _CACHE_ENTRY_STRUCT &src) { return false; }
 		bool operator!= (const _CACHE_ENTRY_STRUCT &src) { return true; }
 	} CACHE_ENTRY_STRUCT;
@@ -242,6 +242,7 @@ class AggregateLoaderClass : public PrototypeLoaderClass
 
 		virtual int						Chunk_Type (void)  { return W3D_CHUNK_AGGREGATE; }
 		virtual PrototypeClass *	Load_W3D (ChunkLoadClass &chunk_load);
+		virtual bool					Is_Thread_Safe (void) { return true; }
 };
 
 
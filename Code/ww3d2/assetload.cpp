@@ -0,0 +1,246 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "assetload.h"
+#include "assetmgr.h"
+#include "proto.h"
+#include "htree.h"
+#include "w3d_file.h"
+#include "chunkio.h"
+#include "ramfile.h"
+#include "ffactory.h"
+#include "wwdebug.h"
+#include "wwmemlog.h"
+#include "wwprofile.h"
+
+
+// ----------------------------------------------------------------------------
+//
+// The file factory isn't thread safe, so files are fetched and returned on
+// the calling thread. The jobs only open, read and close their own file.
+//
+// ----------------------------------------------------------------------------
+
+AssetLoadHandleClass::AssetLoadHandleClass(WW3DAssetManager * manager,const char * const * filenames,int count) :
+	Manager(manager),
+	Files(NULL),
+	FileCount(count),
+	IsPublished(false),
+	Result(false)
+{
+	WWASSERT(Manager != NULL);
+	WWASSERT(count >= 0);
+
+	//
+	// Snapshot the loaders the jobs may use. A loader only counts if it is the
+	// one the manager would pick for its chunk type.
+	//
+	for (int i=0; i<Manager->PrototypeLoaders.Count(); i++) {
+		PrototypeLoaderClass * loader = Manager->PrototypeLoaders[i];
+		if (	loader != NULL && loader->Is_Thread_Safe() &&
+				Manager->Find_Prototype_Loader(loader->Chunk_Type()) == loader)
+		{
+			Loaders.Add(loader);
+		}
+	}
+
+	Files = new FileStruct[(count > 0) ? count : 1];
+	for (int i=0; i<count; i++) {
+		Files[i].File = _TheFileFactory->Get_File(filenames[i]);
+	}
+
+	for (int i=0; i<count; i++) {
+		WorkerPoolClass::Submit(Load_File_Job,this,i,Jobs);
+	}
+}
+
+AssetLoadHandleClass::~AssetLoadHandleClass(void)
+{
+	Wait();
+	delete [] Files;
+	Files = NULL;
+}
+
+bool AssetLoadHandleClass::Wait(void)
+{
+	if (IsPublished) {
+		return Result;
+	}
+
+	WWPROFILE( "AssetLoadHandleClass::Wait" );
+	Jobs.Wait();
+
+	Result = true;
+	for (int i=0; i<FileCount; i++) {
+		if (!Publish_File(Files[i])) {
+			Result = false;
+		}
+		Free_File(Files[i]);
+	}
+
+	IsPublished = true;
+	return Result;
+}
+
+PrototypeLoaderClass * AssetLoadHandleClass::Find_Loader(int chunk_id) const
+{
+	for (int i=0; i<Loaders.Count(); i++) {
+		if (Loaders[i]->Chunk_Type() == chunk_id) {
+			return Loaders[i];
+		}
+	}
+	return NULL;
+}
+
+void AssetLoadHandleClass::Load_File_Job(void * data,int index)
+{
+	AssetLoadHandleClass * handle = (AssetLoadHandleClass *)data;
+	handle->Load_File(handle->Files[index]);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Runs on a worker. Reads the whole file and parses the chunks that don't
+// need the asset manager; the rest are recorded as not parsed.
+//
+// ----------------------------------------------------------------------------
+
+void AssetLoadHandleClass::Load_File(FileStruct & file)
+{
+	WWPROFILE( "AssetLoadHandleClass::Load_File" );
+	WWMEMLOG(MEM_GEOMETRY);
+
+	if (file.File == NULL || !file.File->Is_Available() || !file.File->Open()) {
+		return;
+	}
+
+	file.Size = file.File->Size();
+	if (file.Size > 0) {
+		file.Buffer = new unsigned char[file.Size];
+		file.Size = file.File->Read(file.Buffer,file.Size);
+	}
+	file.File->Close();
+	file.Loaded = true;
+
+	if (file.Size <= 0) {
+		return;
+	}
+
+	RAMFileClass ramfile(file.Buffer,file.Size);
+	ramfile.Open();
+	ChunkLoadClass cload(&ramfile);
+
+	while (cload.Open_Chunk()) {
+
+		ChunkStruct chunk;
+		chunk.Tree = NULL;
+		chunk.Prototype = NULL;
+		chunk.Parsed = false;
+
+		int chunk_id = cload.Cur_Chunk_ID();
+		if (chunk_id == W3D_CHUNK_HIERARCHY) {
+
+			WWMEMLOG(MEM_ANIMATION);
+			HTreeClass * tree = new HTreeClass;
+			if (tree->Load_W3D(cload) == HTreeClass::OK) {
+				chunk.Tree = tree;
+			} else {
+				delete tree;
+			}
+			chunk.Parsed = true;
+
+		} else {
+
+			PrototypeLoaderClass * loader = Find_Loader(chunk_id);
+			if (loader != NULL) {
+				chunk.Prototype = loader->Load_W3D(cload);
+				chunk.Parsed = true;
+			}
+		}
+
+		cload.Close_Chunk();
+		file.Chunks.Add(chunk);
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// Runs on the waiting thread. Walks the file again in step with the parsed
+// results, adding those and loading the skipped chunks in their place.
+//
+// ----------------------------------------------------------------------------
+
+bool AssetLoadHandleClass::Publish_File(FileStruct & file)
+{
+	if (!file.Loaded) {
+		return false;
+	}
+
+	if (file.Size <= 0) {
+		return true;
+	}
+
+	RAMFileClass ramfile(file.Buffer,file.Size);
+	ramfile.Open();
+	ChunkLoadClass cload(&ramfile);
+
+	int index = 0;
+	while (cload.Open_Chunk()) {
+
+		WWASSERT(index < file.Chunks.Count());
+		ChunkStruct & chunk = file.Chunks[index++];
+
+		if (!chunk.Parsed) {
+			Manager->Load_Chunk(cload);
+		} else if (chunk.Tree != NULL) {
+			Manager->HTreeManager.Add_Tree(chunk.Tree);
+		} else if (chunk.Prototype != NULL) {
+			Manager->Accept_Prototype(chunk.Prototype);
+		} else if (cload.Cur_Chunk_ID() != W3D_CHUNK_HIERARCHY) {
+			WWDEBUG_SAY(("Could not generate prototype!  Chunk  = %d\r\n",cload.Cur_Chunk_ID()));
+		}
+		chunk.Tree = NULL;
+		chunk.Prototype = NULL;
+
+		cload.Close_Chunk();
+	}
+
+	return true;
+}
+
+void AssetLoadHandleClass::Free_File(FileStruct & file)
+{
+	//
+	// Anything still here wasn't published
+	//
+	for (int i=0; i<file.Chunks.Count(); i++) {
+		delete file.Chunks[i].Tree;
+		delete file.Chunks[i].Prototype;
+	}
+	file.Chunks.Delete_All();
+
+	delete [] file.Buffer;
+	file.Buffer = NULL;
+	file.Size = 0;
+
+	if (file.File != NULL) {
+		_TheFileFactory->Return_File(file.File);
+		file.File = NULL;
+	}
+}
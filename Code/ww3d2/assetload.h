@@ -0,0 +1,110 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ASSETLOAD_H
+#define ASSETLOAD_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+#include "workerpool.h"
+#include "simplevec.h"
+
+class WW3DAssetManager;
+class PrototypeLoaderClass;
+class PrototypeClass;
+class HTreeClass;
+class FileClass;
+
+// ----------------------------------------------------------------------------
+//
+// AssetLoadHandleClass is a batch of w3d files being loaded by
+// WW3DAssetManager::Load_3D_Assets_Async().
+//
+// Each file is read into memory by a WorkerPoolClass job, which then builds
+// the hierarchy trees and every prototype whose loader says it is thread safe.
+// Meshes, animations and anything else that shares objects through the asset
+// manager are left for the waiting thread.
+//
+// Wait() hands the results to the asset manager in file and chunk order,
+// loading the chunks the workers skipped as it reaches them, so the manager
+// ends up exactly as it would after calling Load_3D_Assets() on each file.
+// Only the thread that owns the asset manager should call Wait() or delete
+// the handle; deleting it waits first.
+//
+// ----------------------------------------------------------------------------
+
+class AssetLoadHandleClass
+{
+public:
+	~AssetLoadHandleClass(void);
+
+	// True once every file has been read and parsed, so Wait() won't block
+	bool Is_Ready(void) const { return Jobs.Is_Done(); }
+
+	// Add the assets to the manager, false if any of the files couldn't be opened
+	bool Wait(void);
+
+	int Get_File_Count(void) const { return FileCount; }
+
+private:
+	AssetLoadHandleClass(WW3DAssetManager * manager,const char * const * filenames,int count);
+
+	struct ChunkStruct
+	{
+		HTreeClass *		Tree;
+		PrototypeClass *	Prototype;
+		bool					Parsed;
+	};
+
+	struct FileStruct
+	{
+		FileStruct(void) : File(NULL), Buffer(NULL), Size(0), Loaded(false) {}
+
+		FileClass *							File;
+		unsigned char *					Buffer;
+		int									Size;
+		bool									Loaded;
+		SimpleDynVecClass<ChunkStruct>	Chunks;
+	};
+
+	static void Load_File_Job(void * data,int index);
+	void Load_File(FileStruct & file);
+	bool Publish_File(FileStruct & file);
+	void Free_File(FileStruct & file);
+	PrototypeLoaderClass * Find_Loader(int chunk_id) const;
+
+	WW3DAssetManager *								Manager;
+	FileStruct *										Files;
+	int													FileCount;
+	SimpleDynVecClass<PrototypeLoaderClass *>	Loaders;			// thread safe loaders, copied at creation
+	JobGroupClass										Jobs;
+	bool													IsPublished;
+	bool													Result;
+
+	friend class WW3DAssetManager;
+
+	// Not Implemented
+	AssetLoadHandleClass(const AssetLoadHandleClass &);
+	AssetLoadHandleClass & operator=(const AssetLoadHandleClass &);
+};
+
+#endif
@@ -38,7 +38,11 @@
  *   WW3DAssetManager::Free -- free all memory (un-needed?)                                    *
  *   WW3DAssetManager::Free_Assets -- Release all loaded assets                                *
  *   WW3DAssetManager::Load_3D_Assets -- Load 3D assets from a .W3D file                       *
+ *   WW3DAssetManager::Load_3D_Assets_Async -- Start loading .W3D files in the background      *
+ *   WW3DAssetManager::Load_3D_Assets_Batched -- Load a list of .W3D files using the workers   *
+ *   WW3DAssetManager::Load_Chunk -- Load one top level chunk of a .W3D file                   *
  *   WW3DAssetManager::Load_Prototype -- loads a prototype from a W3D chunk                    *
+ *   WW3DAssetManager::Accept_Prototype -- add a loaded prototype unless its name is taken     *
  *   WW3DAssetManager::Create_Render_Obj -- Create a render object for the user                *
  *   WW3DAssetManager::Render_Obj_Exists -- Check whether a render object with the given name  *
  *   WW3DAssetManager::Create_Render_Obj_Iterator -- Create an iterator which can enumerate al *
@@ -64,6 +68,7 @@
  *   WW3DAssetManager::Find_Prototype_Loader -- find the loader that handles this chunk type   *
  *   WW3DAssetManager::Add_Prototype -- adds the prototype to the hash table                   *
  *   WW3DAssetManager::Find_Prototype -- searches the hash table for the prototype             *
+ *   WW3DAssetManager::Find_Prototype -- searches the hash table for an interned name          *
  *   WW3DAssetManager::Open_Texture_File_Cache -- Turn on the texture cache system.            * 
  *   WW3DAssetManager::Close_Texture_File_Cache -- Turn off the texture cache system.          * 
  *   CachedTextureFileClass::getMipmapData -- get data for texture - check to see if in cache. * 
@@ -111,6 +116,7 @@
 #include "texture.h"
 #include "wwprofile.h"
 #include "assetstatus.h"
+#include "assetload.h"
 
 /*
 ** Static member variable which keeps track of the single instanced asset manager
@@ -544,24 +550,7 @@ bool WW3DAssetManager::Load_3D_Assets(FileClass & w3dfile)
 	ChunkLoadClass cload(&w3dfile);
 
 	while (cload.Open_Chunk()) {
-
-		switch (cload.Cur_Chunk_ID()) {
-
-			case W3D_CHUNK_HIERARCHY:
-				HTreeManager.Load_Tree(cload);
-				break;
-
-			case W3D_CHUNK_ANIMATION:
-			case W3D_CHUNK_COMPRESSED_ANIMATION:
-			case W3D_CHUNK_MORPH_ANIMATION:
-				HAnimManager.Load_Anim(cload);
-				break;
-        
-			default:
-				Load_Prototype(cload);
-				break;
-		}
-
+		Load_Chunk(cload);
 		cload.Close_Chunk();
 	}
 
@@ -571,6 +560,119 @@ bool WW3DAssetManager::Load_3D_Assets(FileClass & w3dfile)
 }
 
 
+/***********************************************************************************************
+ * WW3DAssetManager::Load_3D_Assets_Async -- Start loading .W3D files in the background        *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * filenames - names to pass to _TheFileFactory                                                *
+ * count - number of names                                                                     *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * handle to wait on, the caller deletes it                                                    *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * The assets don't exist until Wait() has been called on the handle. Managers that override  *
+ * Load_3D_Assets(FileClass &) are bypassed.                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+AssetLoadHandleClass * WW3DAssetManager::Load_3D_Assets_Async(const char * filename)
+{
+	return Load_3D_Assets_Async(&filename,1);
+}
+
+AssetLoadHandleClass * WW3DAssetManager::Load_3D_Assets_Async(const char * const * filenames,int count)
+{
+	WWPROFILE( "WW3DAssetManager::Load_3D_Assets_Async" );
+	return new AssetLoadHandleClass(this,filenames,count);
+}
+
+
+/***********************************************************************************************
+ * WW3DAssetManager::Load_3D_Assets_Batched -- Load a list of .W3D files using the workers     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * filenames - names to pass to _TheFileFactory                                                *
+ * count - number of names                                                                     *
+ * batch_size - files per Load_3D_Assets_Async handle                                          *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * true if every file loaded                                                                   *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * The assets are added in list order, as calling Load_3D_Assets on each file would. Only a   *
+ * couple of batches are held in memory at a time.                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool WW3DAssetManager::Load_3D_Assets_Batched(const char * const * filenames,int count,int batch_size)
+{
+	WWPROFILE( "WW3DAssetManager::Load_3D_Assets_Batched" );
+	WWASSERT(batch_size > 0);
+
+	bool result = true;
+	AssetLoadHandleClass * pending = NULL;
+
+	for (int first=0; first<count; first+=batch_size) {
+
+		//
+		// Start the next batch before adding the last one so the workers
+		// keep reading while this thread builds the meshes and animations
+		//
+		AssetLoadHandleClass * next = Load_3D_Assets_Async(filenames+first,MIN(batch_size,count-first));
+		if (pending != NULL) {
+			if (!pending->Wait()) {
+				result = false;
+			}
+			delete pending;
+		}
+		pending = next;
+	}
+
+	if (pending != NULL) {
+		if (!pending->Wait()) {
+			result = false;
+		}
+		delete pending;
+	}
+
+	return result;
+}
+
+
+/***********************************************************************************************
+ * WW3DAssetManager::Load_Chunk -- Load one top level chunk of a .W3D file                     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * cload - positioned on an open top level chunk                                               *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WW3DAssetManager::Load_Chunk(ChunkLoadClass & cload)
+{
+	switch (cload.Cur_Chunk_ID()) {
+
+		case W3D_CHUNK_HIERARCHY:
+			HTreeManager.Load_Tree(cload);
+			break;
+
+		case W3D_CHUNK_ANIMATION:
+		case W3D_CHUNK_COMPRESSED_ANIMATION:
+		case W3D_CHUNK_MORPH_ANIMATION:
+			HAnimManager.Load_Anim(cload);
+			break;
+      
+		default:
+			Load_Prototype(cload);
+			break;
+	}
+}
+
+
 /***********************************************************************************************
  * WW3DAssetManager::Load_Prototype -- loads a prototype from a W3D chunk                      *
  *                                                                                             *
@@ -618,32 +720,7 @@ bool WW3DAssetManager::Load_Prototype(ChunkLoadClass & cload)
 		return false;
 	}
 
-	/*
-	** Now, see if the prototype that we loaded has a duplicate
-	** name with any of our currently loaded prototypes (can't have that!)
-	*/
-	if (newproto != NULL) {
-
-		if (!Render_Obj_Exists(newproto->Get_Name())) {
-				
-			/*
-			** Add the new, unique prototype to our list
-			*/
-			Add_Prototype(newproto);
-
-		} else {
-
-			/*
-			** Warn the user about a name collision with this prototype 
-			** and dump it
-			*/
-			WWDEBUG_SAY(("Render Object Name Collision: %s\r\n",newproto->Get_Name()));
-			delete newproto;
-			newproto = NULL;
-			return false;
-		}
-	
-	} else {
+	if (newproto == NULL) {
 
 		/*
 		** Warn user that a prototype was not generated from this 
@@ -653,6 +730,47 @@ bool WW3DAssetManager::Load_Prototype(ChunkLoadClass & cload)
 		return false;
 	}
 	
+	return Accept_Prototype(newproto);
+}
+
+
+/***********************************************************************************************
+ * WW3DAssetManager::Accept_Prototype -- add a loaded prototype unless its name is taken       *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * newproto - prototype returned by a loader                                                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * true if the prototype was added                                                             *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * A rejected prototype is deleted.                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool WW3DAssetManager::Accept_Prototype(PrototypeClass * newproto)
+{
+	WWASSERT(newproto != NULL);
+
+	/*
+	** Now, see if the prototype that we loaded has a duplicate
+	** name with any of our currently loaded prototypes (can't have that!)
+	*/
+	if (Render_Obj_Exists(newproto->Get_Name())) {
+
+		/*
+		** Warn the user about a name collision with this prototype 
+		** and dump it
+		*/
+		WWDEBUG_SAY(("Render Object Name Collision: %s\r\n",newproto->Get_Name()));
+		delete newproto;
+		return false;
+	}
+
+	/*
+	** Add the new, unique prototype to our list
+	*/
+	Add_Prototype(newproto);
 	return true;
 }
 
@@ -1410,11 +1528,13 @@ PrototypeLoaderClass * WW3DAssetManager::Find_Prototype_Loader(int chunk_id)
  *   7/29/98    GTH : Created.                                                                 *
  *   12/8/98    GTH : Renamed to simply Add_Prototype                                          *
  *   2/19/99    EHC : Now adds the prototype to the prototype list                             *
+ *              : Interns the name and hashes on the interned name                             *
  *=============================================================================================*/
 void WW3DAssetManager::Add_Prototype(PrototypeClass * newproto)
 {
 	WWASSERT(newproto != NULL);
-	int hash = CRC_Stringi(newproto->Get_Name()) & PROTOTYPE_HASH_MASK;
+	newproto->HashName = NameClass(newproto->Get_Name());
+	int hash = newproto->HashName.Get_Hash() & PROTOTYPE_HASH_MASK;
 	newproto->NextHash = PrototypeHashTable[hash];
 	PrototypeHashTable[hash] = newproto;
 	Prototypes.Add(newproto);
@@ -1441,16 +1561,15 @@ void WW3DAssetManager::Remove_Prototype(PrototypeClass *proto)
 		//
 		// Find the prototype in the hash table.
 		//
-		const char *pname = proto->Get_Name ();
 		bool bfound = false;
 		PrototypeClass *prev = NULL;
-		int hash = CRC_Stringi(pname) & PROTOTYPE_HASH_MASK;				
+		int hash = proto->HashName.Get_Hash() & PROTOTYPE_HASH_MASK;				
 		for (PrototypeClass *test = PrototypeHashTable[hash];
 			  (test != NULL) && (bfound == false);
 			  test = test->NextHash) {
 			
 			// Is this the prototype?
-			if (::stricmp (test->Get_Name(), pname) == 0) {
+			if (test->HashName == proto->HashName) {
 				
 				// Remove this prototype from the linked list for this hash index.
 				if (prev == NULL) {
@@ -1526,12 +1645,36 @@ PrototypeClass * WW3DAssetManager::Find_Prototype(const char * name)
 		return &(_NullPrototype);
 	}
 	
-	// Find the prototype
-	int hash = CRC_Stringi(name) & PROTOTYPE_HASH_MASK;
+	// A name that was never interned can't belong to a prototype
+	return Find_Prototype(NameClass::Find(name));
+}
+
+
+/***********************************************************************************************
+ * WW3DAssetManager::Find_Prototype -- searches the hash table for an interned name            *
+ *                                                                                             *
+ * Every prototype name is interned when the prototype is added so this only compares         *
+ * the interned entries, no strings.                                                           *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+PrototypeClass * WW3DAssetManager::Find_Prototype(const NameClass & name)
+{
+	if (name.Is_Empty()) {
+		return NULL;
+	}
+
+	int hash = name.Get_Hash() & PROTOTYPE_HASH_MASK;
 	PrototypeClass * test = PrototypeHashTable[hash];
 
 	while (test != NULL) {
-		if (stricmp(test->Get_Name(),name) == 0) {
+		if (test->HashName == name) {
 			return test;
 		}
 		test = test->NextHash;
@@ -65,6 +65,7 @@ class	FontCharsClass;
 class RenderObjClass;
 class HModelClass;
 class PrototypeClass;
+class NameClass;
 class HTreeManagerClass;
 class HAnimManagerClass;
 class HAnimIterator;
@@ -74,6 +75,7 @@ class StreamingTextureClass;
 struct StreamingTextureConfig;
 class TextureClass;
 class MetalMapManagerClass;
+class AssetLoadHandleClass;
 
 /*
 ** AssetIterator
@@ -210,6 +212,21 @@ public:
 	virtual bool						Load_3D_Assets( const char * filename);
 	virtual bool						Load_3D_Assets(FileClass & assetfile);
 
+	/*
+	** Load w3d files in the background. The files are read and, where the loaders
+	** allow it, parsed by WorkerPoolClass jobs; nothing is added to the asset manager
+	** until Wait() is called on the returned handle, which then adds everything in
+	** file order just as Load_3D_Assets would have. The caller deletes the handle.
+	*/
+	virtual AssetLoadHandleClass *	Load_3D_Assets_Async(const char * filename);
+	virtual AssetLoadHandleClass *	Load_3D_Assets_Async(const char * const * filenames,int count);
+
+	/*
+	** Load a list of w3d files with Load_3D_Assets_Async, a batch at a time, reading the
+	** next batch while the last one is added. Returns false if any of the files didn't load.
+	*/
+	bool									Load_3D_Assets_Batched(const char * const * filenames,int count,int batch_size=16);
+
 	/*
 	** Get rid of all of the currently loaded assets
 	*/
@@ -299,6 +316,7 @@ public:
 	void									Remove_Prototype(PrototypeClass *proto);
 	void									Remove_Prototype(const char *name);
 	PrototypeClass *					Find_Prototype(const char * name);
+	PrototypeClass *					Find_Prototype(const NameClass & name);
 
 	/*
 	** Load on Demand
@@ -333,6 +351,8 @@ protected:
 
 	PrototypeLoaderClass *			Find_Prototype_Loader(int chunk_id);
 	bool									Load_Prototype(ChunkLoadClass & cload);
+	bool									Accept_Prototype(PrototypeClass * newproto);
+	void									Load_Chunk(ChunkLoadClass & cload);
 
 	/*
 	** Compile time control over the dynamic arrays:
@@ -428,6 +448,9 @@ protected:
 	friend class Font3DDataIterator;
 	friend class TextureIterator;
 
+	// Background loads publish through the protected load functions
+	friend class AssetLoadHandleClass;
+
 	// Font3DInstance need access to the Font3DData
 	friend class Font3DInstanceClass;
 };
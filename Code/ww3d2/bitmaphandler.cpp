@@ -18,6 +18,7 @@
 
 #include "bitmaphandler.h"
 #include "wwdebug.h"
+#include "dxtcodec.h"
 
 void Bitmap_Assert(bool condition)
 {
@@ -152,6 +153,49 @@ void BitmapHandlerClass::Copy_Image(
 	WWASSERT(dest_surface_width);
 	WWASSERT(dest_surface_height);
 
+	// Compressed destination? Convert the source to 32 bit first if needed and encode.
+	if (DXTCodecClass::Is_DXT_Format(dest_surface_format)) {
+		WWASSERT(!DXTCodecClass::Is_DXT_Format(src_surface_format));
+		unsigned char* argb_surface=src_surface;
+		unsigned argb_pitch=src_surface_pitch;
+		if (src_surface_format!=WW3D_FORMAT_A8R8G8B8 || 
+			src_surface_width!=dest_surface_width || 
+			src_surface_height!=dest_surface_height) {
+			argb_pitch=dest_surface_width*4;
+			argb_surface=new unsigned char[argb_pitch*dest_surface_height];
+			Copy_Image(
+				argb_surface,
+				dest_surface_width,
+				dest_surface_height,
+				argb_pitch,
+				WW3D_FORMAT_A8R8G8B8,
+				src_surface,
+				src_surface_width,
+				src_surface_height,
+				src_surface_pitch,
+				src_surface_format,
+				src_palette,
+				src_palette_bpp,
+				false);
+		}
+
+		DXTCodecClass::Encode_Surface(dest_surface,argb_surface,argb_pitch,dest_surface_width,dest_surface_height,dest_surface_format);
+
+		if (argb_surface!=src_surface) {
+			delete[] argb_surface;
+		}
+
+		// Generate the next mip level in place to the source surface, the same as with the uncompressed formats
+		if (generate_mip_level) {
+			WWASSERT(src_surface_format==WW3D_FORMAT_A8R8G8B8);
+			WWASSERT(src_surface_width==dest_surface_width && src_surface_height==dest_surface_height);
+			if (dest_surface_width>1 && dest_surface_height>1) {
+				Create_Mipmap_B8G8R8A8(src_surface,src_surface_pitch,src_surface,src_surface_pitch,dest_surface_width,dest_surface_height);
+			}
+		}
+		return;
+	}
+
 	// Bumpmap?
 	if (dest_surface_format==WW3D_FORMAT_U8V8 ||
 		dest_surface_format==WW3D_FORMAT_L6V5U5 ||
@@ -233,6 +233,7 @@ class BoxLoaderClass : public PrototypeLoaderClass
 public:
 	virtual int						Chunk_Type (void)  { return W3D_CHUNK_BOX; }
 	virtual PrototypeClass *	Load_W3D(ChunkLoadClass & cload);
+	virtual bool					Is_Thread_Safe(void) { return true; }
 };
 
 /*
@@ -142,6 +142,7 @@ public:
 
 	virtual int						Chunk_Type(void) { return W3D_CHUNK_COLLECTION; }
 	virtual PrototypeClass *	Load_W3D(ChunkLoadClass & cload);
+	virtual bool					Is_Thread_Safe(void) { return true; }
 };
 
 extern CollectionLoaderClass _CollectionLoader;
@@ -0,0 +1,918 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "dxtcodec.h"
+#include "cpudetect.h"
+#include "wwdebug.h"
+#include <string.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+
+DXTCodecClass::KernelType DXTCodecClass::Kernel=DXTCodecClass::KERNEL_BEST;
+
+// ----------------------------------------------------------------------------
+//
+// Shared helpers. The endpoint expansion and interpolation must match the
+// original DDSFileClass decoder exactly, as that's what the content was
+// tuned against.
+//
+// ----------------------------------------------------------------------------
+
+WWINLINE static unsigned RGB565_To_ARGB8888(unsigned short rgb)
+{
+	unsigned rgba=0;
+	rgba|=unsigned(rgb&0x001f)<<3;
+	rgba|=unsigned(rgb&0x07e0)<<5;
+	rgba|=unsigned(rgb&0xf800)<<8;
+	return rgba;
+}
+
+WWINLINE static unsigned Combine_Colors(unsigned col1, unsigned col2, unsigned rel)
+{
+	const unsigned R_B_MASK=0x00ff00ff;
+	const unsigned G_MASK=0x0000ff00;
+
+	unsigned rel2=255-rel;
+
+	unsigned r_b_col1=col1&R_B_MASK;
+	r_b_col1*=rel;
+	unsigned r_b_col2=col2&R_B_MASK;
+	r_b_col2*=rel2;
+	r_b_col1+=r_b_col2;
+	r_b_col1>>=8;
+	r_b_col1&=R_B_MASK;
+
+	unsigned g_col1=col1&G_MASK;
+	g_col1*=rel;
+	unsigned g_col2=col2&G_MASK;
+	g_col2*=rel2;
+	g_col1+=g_col2;
+	g_col1>>=8;
+	g_col1&=G_MASK;
+
+	return r_b_col1|g_col1;
+}
+
+WWINLINE static unsigned short Read_U16(const unsigned char* ptr)
+{
+	return (unsigned short)(ptr[0]|(ptr[1]<<8));
+}
+
+WWINLINE static void Write_U16(unsigned char* ptr,unsigned value)
+{
+	ptr[0]=(unsigned char)(value);
+	ptr[1]=(unsigned char)(value>>8);
+}
+
+// Build the 8-entry interpolated alpha table of DXT4/DXT5 block
+static void Build_Alpha_Palette(unsigned* alphas,unsigned alpha0,unsigned alpha1)
+{
+	alphas[0]=alpha0;
+	alphas[1]=alpha1;
+
+	// 8-alpha or 6-alpha block?
+	if (alpha0>alpha1) {
+		alphas[2]=(6*alpha0+1*alpha1+3) / 7;   // bit code 010
+		alphas[3]=(5*alpha0+2*alpha1+3) / 7;   // bit code 011
+		alphas[4]=(4*alpha0+3*alpha1+3) / 7;   // bit code 100
+		alphas[5]=(3*alpha0+4*alpha1+3) / 7;   // bit code 101
+		alphas[6]=(2*alpha0+5*alpha1+3) / 7;   // bit code 110
+		alphas[7]=(1*alpha0+6*alpha1+3) / 7;   // bit code 111
+	}
+	else {
+		alphas[2]=(4*alpha0+1*alpha1+2) / 5;   // Bit code 010
+		alphas[3]=(3*alpha0+2*alpha1+2) / 5;   // Bit code 011
+		alphas[4]=(2*alpha0+3*alpha1+2) / 5;   // Bit code 100
+		alphas[5]=(1*alpha0+4*alpha1+2) / 5;   // Bit code 101
+		alphas[6]=0;                           // Bit code 110
+		alphas[7]=255;                         // Bit code 111
+	}
+}
+
+// Extract the sixteen 3-bit alpha indices of DXT4/DXT5 block
+WWINLINE static void Read_Alpha_Indices(unsigned* indices,const unsigned char* alpha_block)
+{
+	for (int a=0;a<2;++a) {
+		unsigned bits=alpha_block[2]|(alpha_block[3]<<8)|(alpha_block[4]<<16);
+		for (int i=0;i<8;++i) {
+			*indices++=(bits>>(i*3))&7;
+		}
+		alpha_block+=3;
+	}
+}
+
+// Build the four color palette of a color block. DXT1 blocks can use the 3-color + transparent
+// mode, the color blocks of other formats always use the 4-color mode.
+WWINLINE static bool Build_Color_Palette(unsigned* palette,const unsigned char* color_block,bool allow_three_color)
+{
+	unsigned col0=RGB565_To_ARGB8888(Read_U16(color_block));
+	unsigned col1=RGB565_To_ARGB8888(Read_U16(color_block+2));
+	palette[0]=col0|0xff000000;
+	palette[1]=col1|0xff000000;
+	if (col0>col1 || !allow_three_color) {
+		palette[2]=Combine_Colors(col1,col0,85)|0xff000000;
+		palette[3]=Combine_Colors(col0,col1,85)|0xff000000;
+		return false;
+	}
+	palette[2]=Combine_Colors(col1,col0,128)|0xff000000;
+	palette[3]=0x00000000;
+	return true;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DXTCodecClass::Is_DXT_Format(WW3DFormat format)
+{
+	return
+		format==WW3D_FORMAT_DXT1 ||
+		format==WW3D_FORMAT_DXT2 ||
+		format==WW3D_FORMAT_DXT3 ||
+		format==WW3D_FORMAT_DXT4 ||
+		format==WW3D_FORMAT_DXT5;
+}
+
+unsigned DXTCodecClass::Get_Block_Size(WW3DFormat format)
+{
+	WWASSERT(Is_DXT_Format(format));
+	return format==WW3D_FORMAT_DXT1 ? 8 : 16;
+}
+
+unsigned DXTCodecClass::Get_Surface_Size(unsigned width, unsigned height, WW3DFormat format)
+{
+	return ((width+3)/4)*((height+3)/4)*Get_Block_Size(format);
+}
+
+void DXTCodecClass::Set_Kernel(KernelType kernel)
+{
+	Kernel=kernel;
+}
+
+DXTCodecClass::KernelType DXTCodecClass::Get_Kernel()
+{
+	if (Kernel>=KERNEL_AVX2 && CPUDetectClass::Has_AVX2_Instruction_Set()) return KERNEL_AVX2;
+	if (Kernel>=KERNEL_SSE2 && CPUDetectClass::Has_SSE2_Instruction_Set()) return KERNEL_SSE2;
+	return KERNEL_SCALAR;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Scalar reference decoder
+//
+// ----------------------------------------------------------------------------
+
+bool DXTCodecClass::Decode_Block_Reference(unsigned* dest,unsigned dest_pitch,const unsigned char* block,WW3DFormat format)
+{
+	WWASSERT(Is_DXT_Format(format));
+
+	unsigned alpha_values[16];
+	unsigned palette[4];
+	bool contains_alpha=false;
+
+	if (format==WW3D_FORMAT_DXT1) {
+		bool three_color=Build_Color_Palette(palette,block,true);
+		for (int y=0;y<4;++y,dest+=dest_pitch) {
+			unsigned line=block[4+y];
+			for (int x=0;x<4;++x,line>>=2) {
+				if (three_color && (line&3)==3) contains_alpha=true;
+				dest[x]=palette[line&3];
+			}
+		}
+		return contains_alpha;
+	}
+
+	if (format==WW3D_FORMAT_DXT2 || format==WW3D_FORMAT_DXT3) {
+		// Explicit 4-bit alpha, two pixels per byte with the first pixel in the low nibble
+		for (int i=0;i<16;++i) {
+			unsigned nibble=(block[i>>1]>>((i&1)*4))&0xf;
+			alpha_values[i]=nibble|(nibble<<4);
+		}
+	}
+	else {
+		unsigned alphas[8];
+		unsigned alpha_indices[16];
+		Build_Alpha_Palette(alphas,block[0],block[1]);
+		Read_Alpha_Indices(alpha_indices,block);
+		for (int i=0;i<16;++i) {
+			alpha_values[i]=alphas[alpha_indices[i]];
+		}
+	}
+
+	const unsigned char* color_block=block+8;
+	Build_Color_Palette(palette,color_block,false);
+	const unsigned* alpha_ptr=alpha_values;
+	for (int y=0;y<4;++y,dest+=dest_pitch) {
+		unsigned line=color_block[4+y];
+		for (int x=0;x<4;++x,line>>=2) {
+			unsigned alpha_value=*alpha_ptr++;
+			if (alpha_value!=255) contains_alpha=true;
+			dest[x]=(palette[line&3]&0x00ffffff)|(alpha_value<<24);
+		}
+	}
+	return contains_alpha;
+}
+
+// ----------------------------------------------------------------------------
+//
+// SSE2 decoder. The color palette is built with 16 bit multiplies that give
+// the same result as Combine_Colors() and the pixels are selected from the
+// palette with compare masks. Each __m128i holds one row of the block.
+//
+// ----------------------------------------------------------------------------
+
+struct DXTBlockSSE2
+{
+	__m128i Palette;
+	__m128i Indices[4];
+	__m128i Alpha[4];
+	bool ContainsAlpha;
+};
+
+WWINLINE static __m128i Color_Palette_SSE2(const unsigned char* color_block,bool three_color)
+{
+	const __m128i zero=_mm_setzero_si128();
+	unsigned col0=RGB565_To_ARGB8888(Read_U16(color_block));
+	unsigned col1=RGB565_To_ARGB8888(Read_U16(color_block+2));
+
+	// 16 bit channels, col0 in the low half and col1 in the high half (and the other way around)
+	__m128i c01=_mm_unpacklo_epi8(_mm_set_epi32(0,0,col1,col0),zero);
+	__m128i c10=_mm_shuffle_epi32(c01,_MM_SHUFFLE(1,0,3,2));
+
+	// Low half is the second interpolated color, high half the third: (c1*w+c0*(255-w))>>8 and (c0*w+c1*(255-w))>>8
+	__m128i weight=_mm_set1_epi16(three_color ? 128 : 85);
+	__m128i inverse_weight=_mm_set1_epi16(three_color ? 127 : 170);
+	__m128i c23=_mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c10,weight),_mm_mullo_epi16(c01,inverse_weight)),8);
+
+	__m128i palette=_mm_or_si128(_mm_packus_epi16(c01,c23),_mm_set1_epi32((int)0xff000000));
+	if (three_color) {
+		palette=_mm_and_si128(palette,_mm_set_epi32(0,-1,-1,-1));
+	}
+	return palette;
+}
+
+// Expand the four 2-bit color indices of two rows into 32 bit lanes
+WWINLINE static void Color_Indices_SSE2(__m128i* indices,unsigned line0,unsigned line1)
+{
+	const __m128i zero=_mm_setzero_si128();
+	__m128i lines=_mm_set_epi16(
+		(short)line1,(short)line1,(short)line1,(short)line1,
+		(short)line0,(short)line0,(short)line0,(short)line0);
+	// Shift each pixel's bits to the top of a 8 bit field by multiplying with powers of four
+	lines=_mm_mullo_epi16(lines,_mm_set_epi16(1,4,16,64,1,4,16,64));
+	lines=_mm_and_si128(_mm_srli_epi16(lines,6),_mm_set1_epi16(3));
+	indices[0]=_mm_unpacklo_epi16(lines,zero);
+	indices[1]=_mm_unpackhi_epi16(lines,zero);
+}
+
+// Spread 16 alpha bytes into the top byte of four rows of 32 bit pixels
+WWINLINE static void Expand_Alpha_SSE2(__m128i* alpha,__m128i alpha_bytes)
+{
+	const __m128i zero=_mm_setzero_si128();
+	__m128i lo=_mm_unpacklo_epi8(zero,alpha_bytes);
+	__m128i hi=_mm_unpackhi_epi8(zero,alpha_bytes);
+	alpha[0]=_mm_unpacklo_epi16(zero,lo);
+	alpha[1]=_mm_unpackhi_epi16(zero,lo);
+	alpha[2]=_mm_unpacklo_epi16(zero,hi);
+	alpha[3]=_mm_unpackhi_epi16(zero,hi);
+}
+
+WWINLINE static __m128i Explicit_Alpha_SSE2(const unsigned char* alpha_block)
+{
+	__m128i packed=_mm_loadl_epi64((const __m128i*)alpha_block);
+	__m128i nibble_mask=_mm_set1_epi8(0x0f);
+	__m128i lo=_mm_and_si128(packed,nibble_mask);
+	__m128i hi=_mm_and_si128(_mm_srli_epi16(packed,4),nibble_mask);
+	__m128i nibbles=_mm_unpacklo_epi8(lo,hi);
+	return _mm_or_si128(nibbles,_mm_slli_epi16(nibbles,4));
+}
+
+WWINLINE static __m128i Interpolated_Alpha_SSE2(const unsigned char* alpha_block)
+{
+	unsigned alpha0=alpha_block[0];
+	unsigned alpha1=alpha_block[1];
+
+	__m128i a0=_mm_set1_epi16((short)alpha0);
+	__m128i a1=_mm_set1_epi16((short)alpha1);
+	__m128i table;
+	if (alpha0>alpha1) {
+		// (w0*a0+w1*a1+3)/7, division done as a 16 bit reciprocal multiply (exact for the value range)
+		__m128i sum=_mm_add_epi16(
+			_mm_add_epi16(_mm_mullo_epi16(a0,_mm_set_epi16(1,2,3,4,5,6,0,7)),_mm_mullo_epi16(a1,_mm_set_epi16(6,5,4,3,2,1,7,0))),
+			_mm_set1_epi16(3));
+		table=_mm_mulhi_epu16(sum,_mm_set1_epi16(9363));
+	}
+	else {
+		__m128i sum=_mm_add_epi16(
+			_mm_add_epi16(_mm_mullo_epi16(a0,_mm_set_epi16(0,0,1,2,3,4,0,5)),_mm_mullo_epi16(a1,_mm_set_epi16(0,0,4,3,2,1,5,0))),
+			_mm_set1_epi16(2));
+		table=_mm_mulhi_epu16(sum,_mm_set1_epi16(13108));
+		table=_mm_or_si128(_mm_and_si128(table,_mm_set_epi16(0,0,-1,-1,-1,-1,-1,-1)),_mm_set_epi16(255,0,0,0,0,0,0,0));
+	}
+
+	unsigned char alphas[16];
+	_mm_storeu_si128((__m128i*)alphas,_mm_packus_epi16(table,table));
+
+	unsigned alpha_indices[16];
+	Read_Alpha_Indices(alpha_indices,alpha_block);
+	unsigned char values[16];
+	for (int i=0;i<16;++i) {
+		values[i]=alphas[alpha_indices[i]];
+	}
+	return _mm_loadu_si128((const __m128i*)values);
+}
+
+static void Prepare_Block_SSE2(DXTBlockSSE2& decoded,const unsigned char* block,WW3DFormat format)
+{
+	const unsigned char* color_block=block;
+	if (format==WW3D_FORMAT_DXT1) {
+		unsigned col0=Read_U16(block);
+		unsigned col1=Read_U16(block+2);
+		bool three_color=col0<=col1;
+		decoded.Palette=Color_Palette_SSE2(color_block,three_color);
+		for (int i=0;i<4;++i) {
+			decoded.Alpha[i]=_mm_setzero_si128();
+		}
+		// Any index of 3 in the 3-color mode means transparency
+		unsigned bits=block[4]|(block[5]<<8)|(block[6]<<16)|(block[7]<<24);
+		decoded.ContainsAlpha=three_color && (bits&(bits>>1)&0x55555555)!=0;
+	}
+	else {
+		color_block=block+8;
+		__m128i alpha_bytes;
+		if (format==WW3D_FORMAT_DXT2 || format==WW3D_FORMAT_DXT3) {
+			alpha_bytes=Explicit_Alpha_SSE2(block);
+		}
+		else {
+			alpha_bytes=Interpolated_Alpha_SSE2(block);
+		}
+		decoded.ContainsAlpha=_mm_movemask_epi8(_mm_cmpeq_epi8(alpha_bytes,_mm_set1_epi8(-1)))!=0xffff;
+		Expand_Alpha_SSE2(decoded.Alpha,alpha_bytes);
+		decoded.Palette=_mm_and_si128(Color_Palette_SSE2(color_block,false),_mm_set1_epi32(0x00ffffff));
+	}
+	Color_Indices_SSE2(decoded.Indices,color_block[4],color_block[5]);
+	Color_Indices_SSE2(decoded.Indices+2,color_block[6],color_block[7]);
+}
+
+WWINLINE static __m128i Select_Row_SSE2(__m128i palette,__m128i indices,__m128i alpha)
+{
+	__m128i row=_mm_and_si128(_mm_cmpeq_epi32(indices,_mm_setzero_si128()),_mm_shuffle_epi32(palette,_MM_SHUFFLE(0,0,0,0)));
+	row=_mm_or_si128(row,_mm_and_si128(_mm_cmpeq_epi32(indices,_mm_set1_epi32(1)),_mm_shuffle_epi32(palette,_MM_SHUFFLE(1,1,1,1))));
+	row=_mm_or_si128(row,_mm_and_si128(_mm_cmpeq_epi32(indices,_mm_set1_epi32(2)),_mm_shuffle_epi32(palette,_MM_SHUFFLE(2,2,2,2))));
+	row=_mm_or_si128(row,_mm_and_si128(_mm_cmpeq_epi32(indices,_mm_set1_epi32(3)),_mm_shuffle_epi32(palette,_MM_SHUFFLE(3,3,3,3))));
+	return _mm_or_si128(row,alpha);
+}
+
+static bool Decode_Block_SSE2(unsigned* dest,unsigned dest_pitch,const unsigned char* block,WW3DFormat format)
+{
+	DXTBlockSSE2 decoded;
+	Prepare_Block_SSE2(decoded,block,format);
+	for (int y=0;y<4;++y,dest+=dest_pitch) {
+		_mm_storeu_si128((__m128i*)dest,Select_Row_SSE2(decoded.Palette,decoded.Indices[y],decoded.Alpha[y]));
+	}
+	return decoded.ContainsAlpha;
+}
+
+// ----------------------------------------------------------------------------
+//
+// AVX2 decoder, two horizontally adjacent blocks at a time. Each 128 bit lane
+// holds one block so the in-lane shuffles pick from the right palette.
+//
+// ----------------------------------------------------------------------------
+
+static bool Decode_Block_Pair_AVX2(unsigned* dest,unsigned dest_pitch,const unsigned char* block,WW3DFormat format)
+{
+	DXTBlockSSE2 left;
+	DXTBlockSSE2 right;
+	Prepare_Block_SSE2(left,block,format);
+	Prepare_Block_SSE2(right,block+DXTCodecClass::Get_Block_Size(format),format);
+
+	__m256i palette=_mm256_set_m128i(right.Palette,left.Palette);
+	__m256i p0=_mm256_shuffle_epi32(palette,_MM_SHUFFLE(0,0,0,0));
+	__m256i p1=_mm256_shuffle_epi32(palette,_MM_SHUFFLE(1,1,1,1));
+	__m256i p2=_mm256_shuffle_epi32(palette,_MM_SHUFFLE(2,2,2,2));
+	__m256i p3=_mm256_shuffle_epi32(palette,_MM_SHUFFLE(3,3,3,3));
+	__m256i one=_mm256_set1_epi32(1);
+	__m256i two=_mm256_set1_epi32(2);
+	__m256i three=_mm256_set1_epi32(3);
+
+	for (int y=0;y<4;++y,dest+=dest_pitch) {
+		__m256i indices=_mm256_set_m128i(right.Indices[y],left.Indices[y]);
+		__m256i row=_mm256_and_si256(_mm256_cmpeq_epi32(indices,_mm256_setzero_si256()),p0);
+		row=_mm256_or_si256(row,_mm256_and_si256(_mm256_cmpeq_epi32(indices,one),p1));
+		row=_mm256_or_si256(row,_mm256_and_si256(_mm256_cmpeq_epi32(indices,two),p2));
+		row=_mm256_or_si256(row,_mm256_and_si256(_mm256_cmpeq_epi32(indices,three),p3));
+		row=_mm256_or_si256(row,_mm256_set_m128i(right.Alpha[y],left.Alpha[y]));
+		_mm256_storeu_si256((__m256i*)dest,row);
+	}
+	return left.ContainsAlpha || right.ContainsAlpha;
+}
+
+// ----------------------------------------------------------------------------
+
+bool DXTCodecClass::Decode_Block(unsigned* dest,unsigned dest_pitch,const unsigned char* block,WW3DFormat format)
+{
+	WWASSERT(Is_DXT_Format(format));
+	if (Get_Kernel()==KERNEL_SCALAR) {
+		return Decode_Block_Reference(dest,dest_pitch,block,format);
+	}
+	return Decode_Block_SSE2(dest,dest_pitch,block,format);
+}
+
+bool DXTCodecClass::Decode_Surface(
+	unsigned char* dest_surface,
+	unsigned dest_pitch,
+	const unsigned char* src_blocks,
+	unsigned width,
+	unsigned height,
+	WW3DFormat format)
+{
+	WWASSERT(dest_surface);
+	WWASSERT(src_blocks);
+	WWASSERT(Is_DXT_Format(format));
+
+	KernelType kernel=Get_Kernel();
+	unsigned block_size=Get_Block_Size(format);
+	unsigned blocks_x=(width+3)/4;
+	unsigned blocks_y=(height+3)/4;
+	bool contains_alpha=false;
+
+	for (unsigned by=0;by<blocks_y;++by) {
+		unsigned* dest_row=(unsigned*)(dest_surface+by*4*dest_pitch);
+		unsigned rows=height-by*4;
+		if (rows>4) rows=4;
+
+		unsigned bx=0;
+		if (rows==4) {
+			if (kernel==KERNEL_AVX2) {
+				for (;bx+2<=width/4;bx+=2,src_blocks+=block_size*2) {
+					contains_alpha|=Decode_Block_Pair_AVX2(dest_row+bx*4,dest_pitch/4,src_blocks,format);
+				}
+			}
+			for (;bx<width/4;++bx,src_blocks+=block_size) {
+				contains_alpha|=Decode_Block(dest_row+bx*4,dest_pitch/4,src_blocks,format);
+			}
+		}
+
+		// Partial blocks are decoded to a temporary buffer and clipped
+		for (;bx<blocks_x;++bx,src_blocks+=block_size) {
+			unsigned block_pixels[16];
+			contains_alpha|=Decode_Block(block_pixels,4,src_blocks,format);
+			unsigned columns=width-bx*4;
+			if (columns>4) columns=4;
+			for (unsigned y=0;y<rows;++y) {
+				unsigned* dest=(unsigned*)(dest_surface+(by*4+y)*dest_pitch)+bx*4;
+				memcpy(dest,block_pixels+y*4,columns*4);
+			}
+		}
+	}
+	return contains_alpha;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Encoder helpers shared by the scalar and SSE2 encoders. The per-block
+// palette setup is done in scalar code in both so that the results match.
+//
+// ----------------------------------------------------------------------------
+
+WWINLINE static unsigned ARGB8888_To_RGB565(unsigned argb)
+{
+	return ((argb>>8)&0xf800)|((argb>>5)&0x07e0)|((argb>>3)&0x001f);
+}
+
+// Standard bit-replicating expansion, this is what the hardware uses when sampling
+WWINLINE static unsigned RGB565_To_RGB888(unsigned rgb)
+{
+	unsigned r=(rgb>>11)&0x1f;
+	unsigned g=(rgb>>5)&0x3f;
+	unsigned b=rgb&0x1f;
+	r=(r<<3)|(r>>2);
+	g=(g<<2)|(g>>4);
+	b=(b<<3)|(b>>2);
+	return (r<<16)|(g<<8)|b;
+}
+
+WWINLINE static unsigned Channel(unsigned argb,int shift)
+{
+	return (argb>>shift)&0xff;
+}
+
+// Shrink the min-max bounding box by 1/16 of its size on each channel, this reduces the error
+// introduced by the extreme endpoints.
+static void Inset_Bounding_Box(unsigned& min_color,unsigned& max_color)
+{
+	unsigned new_min=0;
+	unsigned new_max=0;
+	for (int shift=0;shift<24;shift+=8) {
+		unsigned mn=Channel(min_color,shift);
+		unsigned mx=Channel(max_color,shift);
+		unsigned inset=(mx-mn)>>4;
+		new_min|=(mn+inset)<<shift;
+		new_max|=(mx-inset)<<shift;
+	}
+	min_color=new_min;
+	max_color=new_max;
+}
+
+// Endpoints and the (alpha-less) interpolated palette of a 4-color or a 3-color block
+static void Build_Encode_Palette(unsigned* palette,unsigned color0,unsigned color1,bool three_color)
+{
+	unsigned c0=RGB565_To_RGB888(color0);
+	unsigned c1=RGB565_To_RGB888(color1);
+	palette[0]=c0;
+	palette[1]=c1;
+	palette[2]=0;
+	palette[3]=0;
+	for (int shift=0;shift<24;shift+=8) {
+		unsigned a=Channel(c0,shift);
+		unsigned b=Channel(c1,shift);
+		if (three_color) {
+			palette[2]|=((a+b)/2)<<shift;
+		}
+		else {
+			palette[2]|=((2*a+b)/3)<<shift;
+			palette[3]|=((a+2*b)/3)<<shift;
+		}
+	}
+}
+
+WWINLINE static unsigned Color_Distance(unsigned a,unsigned b)
+{
+	unsigned distance=0;
+	for (int shift=0;shift<24;shift+=8) {
+		int d=int(Channel(a,shift))-int(Channel(b,shift));
+		distance+=d<0 ? -d : d;
+	}
+	return distance;
+}
+
+WWINLINE static void Write_Color_Block(unsigned char* color_block,unsigned color0,unsigned color1,unsigned indices)
+{
+	Write_U16(color_block,color0);
+	Write_U16(color_block+2,color1);
+	color_block[4]=(unsigned char)(indices);
+	color_block[5]=(unsigned char)(indices>>8);
+	color_block[6]=(unsigned char)(indices>>16);
+	color_block[7]=(unsigned char)(indices>>24);
+}
+
+WWINLINE static void Write_Alpha_Block(unsigned char* alpha_block,unsigned alpha0,unsigned alpha1,const unsigned char* indices)
+{
+	alpha_block[0]=(unsigned char)alpha0;
+	alpha_block[1]=(unsigned char)alpha1;
+	for (int a=0;a<2;++a) {
+		unsigned bits=0;
+		for (int i=0;i<8;++i) {
+			bits|=unsigned(*indices++)<<(i*3);
+		}
+		alpha_block[2]=(unsigned char)(bits);
+		alpha_block[3]=(unsigned char)(bits>>8);
+		alpha_block[4]=(unsigned char)(bits>>16);
+		alpha_block+=3;
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// Scalar reference encoder
+//
+// ----------------------------------------------------------------------------
+
+static void Encode_Color_Block_Reference(unsigned char* color_block,const unsigned* pixels,bool allow_punch_through)
+{
+	bool punch_through=false;
+	if (allow_punch_through) {
+		for (int i=0;i<16;++i) {
+			if ((pixels[i]>>24)<128) punch_through=true;
+		}
+	}
+
+	unsigned min_color=0x00ffffff;
+	unsigned max_color=0;
+	bool any_opaque=false;
+	for (int i=0;i<16;++i) {
+		if (punch_through && (pixels[i]>>24)<128) continue;
+		any_opaque=true;
+		unsigned new_min=0;
+		unsigned new_max=0;
+		for (int shift=0;shift<24;shift+=8) {
+			unsigned c=Channel(pixels[i],shift);
+			unsigned mn=Channel(min_color,shift);
+			unsigned mx=Channel(max_color,shift);
+			new_min|=(c<mn ? c : mn)<<shift;
+			new_max|=(c>mx ? c : mx)<<shift;
+		}
+		min_color=new_min;
+		max_color=new_max;
+	}
+
+	if (!any_opaque) {
+		Write_Color_Block(color_block,0,0,0xffffffff);
+		return;
+	}
+
+	Inset_Bounding_Box(min_color,max_color);
+	unsigned color_max=ARGB8888_To_RGB565(max_color);
+	unsigned color_min=ARGB8888_To_RGB565(min_color);
+
+	unsigned palette[4];
+	unsigned color0;
+	unsigned color1;
+	int palette_count;
+	if (punch_through) {
+		// color0<=color1 selects the 3-color + transparent mode
+		color0=color_min;
+		color1=color_max;
+		palette_count=3;
+	}
+	else {
+		color0=color_max;
+		color1=color_min;
+		palette_count=4;
+		if (color0==color1) {
+			Write_Color_Block(color_block,color0,color1,0);
+			return;
+		}
+	}
+	Build_Encode_Palette(palette,color0,color1,punch_through);
+
+	unsigned indices=0;
+	for (int i=0;i<16;++i) {
+		unsigned index=3;
+		if (!punch_through || (pixels[i]>>24)>=128) {
+			unsigned best=Color_Distance(pixels[i],palette[0]);
+			index=0;
+			for (int p=1;p<palette_count;++p) {
+				unsigned distance=Color_Distance(pixels[i],palette[p]);
+				if (distance<best) {
+					best=distance;
+					index=p;
+				}
+			}
+		}
+		indices|=index<<(i*2);
+	}
+	Write_Color_Block(color_block,color0,color1,indices);
+}
+
+static void Encode_Explicit_Alpha_Reference(unsigned char* alpha_block,const unsigned* pixels)
+{
+	for (int i=0;i<8;++i) {
+		alpha_block[i]=(unsigned char)(((pixels[i*2]>>28)&0xf)|((pixels[i*2+1]>>24)&0xf0));
+	}
+}
+
+static void Encode_Interpolated_Alpha_Reference(unsigned char* alpha_block,const unsigned* pixels)
+{
+	unsigned min_alpha=255;
+	unsigned max_alpha=0;
+	for (int i=0;i<16;++i) {
+		unsigned a=pixels[i]>>24;
+		if (a<min_alpha) min_alpha=a;
+		if (a>max_alpha) max_alpha=a;
+	}
+
+	unsigned char indices[16];
+	memset(indices,0,sizeof(indices));
+	if (max_alpha!=min_alpha) {
+		// alpha0>alpha1 selects the 8-alpha mode
+		unsigned alphas[8];
+		Build_Alpha_Palette(alphas,max_alpha,min_alpha);
+		for (int i=0;i<16;++i) {
+			int a=pixels[i]>>24;
+			unsigned best=255;
+			for (int p=0;p<8;++p) {
+				int d=a-int(alphas[p]);
+				unsigned distance=d<0 ? -d : d;
+				if (p==0 || distance<best) {
+					best=distance;
+					indices[i]=(unsigned char)p;
+				}
+			}
+		}
+	}
+	Write_Alpha_Block(alpha_block,max_alpha,min_alpha,indices);
+}
+
+void DXTCodecClass::Encode_Block_Reference(unsigned char* block,const unsigned* src,unsigned src_pitch,WW3DFormat format)
+{
+	WWASSERT(Is_DXT_Format(format));
+
+	unsigned pixels[16];
+	for (int y=0;y<4;++y) {
+		memcpy(pixels+y*4,src+y*src_pitch,16);
+	}
+
+	if (format==WW3D_FORMAT_DXT1) {
+		Encode_Color_Block_Reference(block,pixels,true);
+		return;
+	}
+
+	if (format==WW3D_FORMAT_DXT2 || format==WW3D_FORMAT_DXT3) {
+		Encode_Explicit_Alpha_Reference(block,pixels);
+	}
+	else {
+		Encode_Interpolated_Alpha_Reference(block,pixels);
+	}
+	Encode_Color_Block_Reference(block+8,pixels,false);
+}
+
+// ----------------------------------------------------------------------------
+//
+// SSE2 encoder. Bounding boxes, distances and index selection are done on
+// all 16 pixels at once, blocks that need the DXT1 punch-through mode are
+// rare and go through the reference code.
+//
+// ----------------------------------------------------------------------------
+
+// Per-pixel sum of absolute RGB differences, one pixel per 32 bit lane
+WWINLINE static __m128i Color_Distance_SSE2(__m128i pixels,__m128i color)
+{
+	const __m128i byte_mask=_mm_set1_epi32(0x00ff00ff);
+	__m128i diff=_mm_or_si128(_mm_subs_epu8(pixels,color),_mm_subs_epu8(color,pixels));
+	diff=_mm_and_si128(diff,_mm_set1_epi32(0x00ffffff));
+	__m128i sum=_mm_add_epi16(_mm_and_si128(diff,byte_mask),_mm_and_si128(_mm_srli_epi32(diff,8),byte_mask));
+	return _mm_and_si128(_mm_add_epi32(sum,_mm_srli_epi32(sum,16)),_mm_set1_epi32(0xffff));
+}
+
+static void Encode_Color_Block_SSE2(unsigned char* color_block,const __m128i* rows)
+{
+	__m128i mn=_mm_min_epu8(_mm_min_epu8(rows[0],rows[1]),_mm_min_epu8(rows[2],rows[3]));
+	__m128i mx=_mm_max_epu8(_mm_max_epu8(rows[0],rows[1]),_mm_max_epu8(rows[2],rows[3]));
+	mn=_mm_min_epu8(mn,_mm_shuffle_epi32(mn,_MM_SHUFFLE(1,0,3,2)));
+	mx=_mm_max_epu8(mx,_mm_shuffle_epi32(mx,_MM_SHUFFLE(1,0,3,2)));
+	mn=_mm_min_epu8(mn,_mm_shuffle_epi32(mn,_MM_SHUFFLE(2,3,0,1)));
+	mx=_mm_max_epu8(mx,_mm_shuffle_epi32(mx,_MM_SHUFFLE(2,3,0,1)));
+
+	unsigned min_color=unsigned(_mm_cvtsi128_si32(mn))&0x00ffffff;
+	unsigned max_color=unsigned(_mm_cvtsi128_si32(mx))&0x00ffffff;
+	Inset_Bounding_Box(min_color,max_color);
+	unsigned color0=ARGB8888_To_RGB565(max_color);
+	unsigned color1=ARGB8888_To_RGB565(min_color);
+	if (color0==color1) {
+		Write_Color_Block(color_block,color0,color1,0);
+		return;
+	}
+
+	unsigned palette[4];
+	Build_Encode_Palette(palette,color0,color1,false);
+
+	unsigned indices=0;
+	for (int y=0;y<4;++y) {
+		__m128i best=Color_Distance_SSE2(rows[y],_mm_set1_epi32(palette[0]));
+		__m128i index=_mm_setzero_si128();
+		for (int p=1;p<4;++p) {
+			__m128i distance=Color_Distance_SSE2(rows[y],_mm_set1_epi32(palette[p]));
+			__m128i closer=_mm_cmplt_epi32(distance,best);
+			best=_mm_or_si128(_mm_and_si128(closer,distance),_mm_andnot_si128(closer,best));
+			index=_mm_or_si128(_mm_and_si128(closer,_mm_set1_epi32(p)),_mm_andnot_si128(closer,index));
+		}
+		// Gather the four 2-bit indices of the row: lane x shifted left by 2*x
+		index=_mm_or_si128(index,_mm_srli_epi64(index,30));
+		unsigned row=(_mm_cvtsi128_si32(index)&0xf)|((_mm_cvtsi128_si32(_mm_srli_si128(index,8))&0xf)<<4);
+		indices|=row<<(y*8);
+	}
+	Write_Color_Block(color_block,color0,color1,indices);
+}
+
+static void Encode_Interpolated_Alpha_SSE2(unsigned char* alpha_block,const __m128i* rows)
+{
+	__m128i a01=_mm_packs_epi32(_mm_srli_epi32(rows[0],24),_mm_srli_epi32(rows[1],24));
+	__m128i a23=_mm_packs_epi32(_mm_srli_epi32(rows[2],24),_mm_srli_epi32(rows[3],24));
+	__m128i alpha=_mm_packus_epi16(a01,a23);
+
+	__m128i mn=_mm_min_epu8(alpha,_mm_srli_si128(alpha,8));
+	__m128i mx=_mm_max_epu8(alpha,_mm_srli_si128(alpha,8));
+	mn=_mm_min_epu8(mn,_mm_srli_si128(mn,4));
+	mx=_mm_max_epu8(mx,_mm_srli_si128(mx,4));
+	mn=_mm_min_epu8(mn,_mm_srli_si128(mn,2));
+	mx=_mm_max_epu8(mx,_mm_srli_si128(mx,2));
+	mn=_mm_min_epu8(mn,_mm_srli_si128(mn,1));
+	mx=_mm_max_epu8(mx,_mm_srli_si128(mx,1));
+	unsigned min_alpha=_mm_cvtsi128_si32(mn)&0xff;
+	unsigned max_alpha=_mm_cvtsi128_si32(mx)&0xff;
+
+	unsigned char indices[16];
+	if (max_alpha==min_alpha) {
+		memset(indices,0,sizeof(indices));
+	}
+	else {
+		unsigned alphas[8];
+		Build_Alpha_Palette(alphas,max_alpha,min_alpha);
+
+		// Unsigned byte compare done as signed compare of sign-flipped values
+		const __m128i sign=_mm_set1_epi8(-128);
+		__m128i palette_alpha=_mm_set1_epi8((char)alphas[0]);
+		__m128i best=_mm_or_si128(_mm_subs_epu8(alpha,palette_alpha),_mm_subs_epu8(palette_alpha,alpha));
+		__m128i index=_mm_setzero_si128();
+		for (int p=1;p<8;++p) {
+			palette_alpha=_mm_set1_epi8((char)alphas[p]);
+			__m128i distance=_mm_or_si128(_mm_subs_epu8(alpha,palette_alpha),_mm_subs_epu8(palette_alpha,alpha));
+			__m128i closer=_mm_cmplt_epi8(_mm_xor_si128(distance,sign),_mm_xor_si128(best,sign));
+			best=_mm_or_si128(_mm_and_si128(closer,distance),_mm_andnot_si128(closer,best));
+			index=_mm_or_si128(_mm_and_si128(closer,_mm_set1_epi8((char)p)),_mm_andnot_si128(closer,index));
+		}
+		_mm_storeu_si128((__m128i*)indices,index);
+	}
+	Write_Alpha_Block(alpha_block,max_alpha,min_alpha,indices);
+}
+
+static void Encode_Block_SSE2(unsigned char* block,const unsigned* src,unsigned src_pitch,WW3DFormat format)
+{
+	__m128i rows[4];
+	for (int y=0;y<4;++y) {
+		rows[y]=_mm_loadu_si128((const __m128i*)(src+y*src_pitch));
+	}
+
+	if (format==WW3D_FORMAT_DXT1) {
+		// Any alpha below 128 (sign bit of the pixel clear) needs the punch-through mode
+		__m128i all=_mm_and_si128(_mm_and_si128(rows[0],rows[1]),_mm_and_si128(rows[2],rows[3]));
+		if (_mm_movemask_ps(_mm_castsi128_ps(all))!=0xf) {
+			DXTCodecClass::Encode_Block_Reference(block,src,src_pitch,format);
+			return;
+		}
+		Encode_Color_Block_SSE2(block,rows);
+		return;
+	}
+
+	if (format==WW3D_FORMAT_DXT2 || format==WW3D_FORMAT_DXT3) {
+		unsigned pixels[16];
+		for (int y=0;y<4;++y) {
+			_mm_storeu_si128((__m128i*)(pixels+y*4),rows[y]);
+		}
+		Encode_Explicit_Alpha_Reference(block,pixels);
+	}
+	else {
+		Encode_Interpolated_Alpha_SSE2(block,rows);
+	}
+	Encode_Color_Block_SSE2(block+8,rows);
+}
+
+// ----------------------------------------------------------------------------
+
+void DXTCodecClass::Encode_Block(unsigned char* block,const unsigned* src,unsigned src_pitch,WW3DFormat format)
+{
+	WWASSERT(Is_DXT_Format(format));
+	if (Get_Kernel()==KERNEL_SCALAR) {
+		Encode_Block_Reference(block,src,src_pitch,format);
+	}
+	else {
+		Encode_Block_SSE2(block,src,src_pitch,format);
+	}
+}
+
+void DXTCodecClass::Encode_Surface(
+	unsigned char* dest_blocks,
+	const unsigned char* src_surface,
+	unsigned src_pitch,
+	unsigned width,
+	unsigned height,
+	WW3DFormat format)
+{
+	WWASSERT(dest_blocks);
+	WWASSERT(src_surface);
+	WWASSERT(width && height);
+
+	unsigned block_size=Get_Block_Size(format);
+	unsigned blocks_x=(width+3)/4;
+	unsigned blocks_y=(height+3)/4;
+
+	for (unsigned by=0;by<blocks_y;++by) {
+		for (unsigned bx=0;bx<blocks_x;++bx,dest_blocks+=block_size) {
+			if (bx*4+4<=width && by*4+4<=height) {
+				const unsigned* src=(const unsigned*)(src_surface+by*4*src_pitch)+bx*4;
+				Encode_Block(dest_blocks,src,src_pitch/4,format);
+				continue;
+			}
+
+			// Partial block, replicate the edge pixels
+			unsigned block_pixels[16];
+			for (unsigned y=0;y<4;++y) {
+				unsigned sy=by*4+y;
+				if (sy>=height) sy=height-1;
+				const unsigned* src=(const unsigned*)(src_surface+sy*src_pitch);
+				for (unsigned x=0;x<4;++x) {
+					unsigned sx=bx*4+x;
+					if (sx>=width) sx=width-1;
+					block_pixels[y*4+x]=src[sx];
+				}
+			}
+			Encode_Block(dest_blocks,block_pixels,4,format);
+		}
+	}
+}
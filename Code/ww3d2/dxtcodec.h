@@ -0,0 +1,113 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef DXTCODEC_H
+#define DXTCODEC_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+#include "ww3dformat.h"
+
+// ----------------------------------------------------------------------------
+//
+// Block decoder and encoder for the DXT1-DXT5 (BC1-BC3) compressed formats.
+//
+// Decoding always produces A8R8G8B8 pixels and is bit-exact with the original
+// per-pixel DDSFileClass code: 565 endpoints are expanded by shifting only and
+// the interpolated colors use the same 85/256 and 128/256 weights. DXT2 and
+// DXT4 are decoded as DXT3 and DXT5 without un-premultiplying the color.
+//
+// Encoding is a fast bounding-box fit intended for compressing textures at
+// load time, not for offline quality. DXT1 blocks with any alpha below 128
+// are encoded as 3-color punch-through blocks.
+//
+// The SSE2 and AVX2 kernels are chosen at runtime and produce the exact same
+// output as the scalar reference. Set_Kernel() can be used to force a kernel
+// (the tests use it to compare the kernels against each other).
+//
+// ----------------------------------------------------------------------------
+
+class DXTCodecClass
+{
+public:
+	enum KernelType {
+		KERNEL_SCALAR=0,
+		KERNEL_SSE2,
+		KERNEL_AVX2,
+		KERNEL_BEST
+	};
+
+	static bool Is_DXT_Format(WW3DFormat format);
+
+	// Size of one 4x4 block in bytes, 8 for DXT1 and 16 for DXT2-DXT5
+	static unsigned Get_Block_Size(WW3DFormat format);
+
+	// Size of a surface in bytes, partial blocks are rounded up
+	static unsigned Get_Surface_Size(unsigned width, unsigned height, WW3DFormat format);
+
+	// Select the decoding/encoding kernel. KERNEL_BEST picks the fastest one supported by the cpu,
+	// requesting a kernel that isn't supported falls back to the next best one.
+	static void Set_Kernel(KernelType kernel);
+	static KernelType Get_Kernel();
+
+	// Decode one 4x4 block into A8R8G8B8 pixels. Returns true if any pixel in the block has alpha < 255.
+	static bool Decode_Block(
+		unsigned* dest,						// Destination pixels
+		unsigned dest_pitch,					// Destination pitch, in pixels
+		const unsigned char* block,		// Compressed block
+		WW3DFormat format);
+
+	// Decode a whole surface into A8R8G8B8 pixels. Surfaces smaller than 4x4 are
+	// clipped. Returns true if any decoded pixel has alpha < 255.
+	static bool Decode_Surface(
+		unsigned char* dest_surface,		// Destination A8R8G8B8 surface
+		unsigned dest_pitch,					// Destination pitch, in bytes
+		const unsigned char* src_blocks,	// Compressed surface
+		unsigned width,
+		unsigned height,
+		WW3DFormat format);
+
+	// Encode one 4x4 block of A8R8G8B8 pixels.
+	static void Encode_Block(
+		unsigned char* block,				// Destination block
+		const unsigned* src,					// Source pixels
+		unsigned src_pitch,					// Source pitch, in pixels
+		WW3DFormat format);
+
+	// Encode a whole A8R8G8B8 surface. Edge pixels are replicated to fill partial blocks.
+	static void Encode_Surface(
+		unsigned char* dest_blocks,		// Destination compressed surface
+		const unsigned char* src_surface,// Source A8R8G8B8 surface
+		unsigned src_pitch,					// Source pitch, in bytes
+		unsigned width,
+		unsigned height,
+		WW3DFormat format);
+
+	// The scalar reference implementations, always available.
+	static bool Decode_Block_Reference(unsigned* dest,unsigned dest_pitch,const unsigned char* block,WW3DFormat format);
+	static void Encode_Block_Reference(unsigned char* block,const unsigned* src,unsigned src_pitch,WW3DFormat format);
+
+private:
+	static KernelType Kernel;
+};
+
+#endif
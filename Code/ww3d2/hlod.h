@@ -290,6 +290,7 @@ class HLodLoaderClass : public PrototypeLoaderClass
 public:
 	virtual int						Chunk_Type (void)  { return W3D_CHUNK_HLOD; }
 	virtual PrototypeClass *	Load_W3D(ChunkLoadClass & cload);
+	virtual bool					Is_Thread_Safe(void) { return true; }
 };
 
 
@@ -38,6 +38,7 @@
  *   HTreeManagerClass::Free -- de-allocate all memory in use                                  * 
  *   HTreeManagerClass::Free_All_Trees -- de-allocates all hierarchy trees currently loaded    * 
  *   HTreeManagerClass::Load_Tree -- load a hierarchy tree from a file                         * 
+ *   HTreeManagerClass::Add_Tree -- add a loaded hierarchy tree to the manager                 * 
  *   HTreeManagerClass::Get_Tree_ID -- look up the ID of a named hierarchy tree                * 
  *   HTreeManagerClass::Get_Tree -- get a pointer to the specified hierarchy tree              * 
  *   HTreeManagerClass::Get_Tree -- get a pointer to the specified hierarchy tree              * 
@@ -49,6 +50,7 @@
 #include "htree.h"
 #include "chunkio.h"
 #include "wwmemlog.h"
+#include "wwdebug.h"
 
 
 /*********************************************************************************************** 
@@ -158,30 +160,52 @@ int HTreeManagerClass::Load_Tree(ChunkLoadClass & cload)
 		delete newtree;
 		goto Error;
 
-	} else if (Get_Tree_ID(newtree->Get_Name()) != -1) {
+	}
+
+	return Add_Tree(newtree);
+
+Error:
+
+	return 1;
+
+}
+
+/*********************************************************************************************** 
+ * HTreeManagerClass::Add_Tree -- add a loaded hierarchy tree to the manager                   * 
+ *                                                                                             * 
+ * INPUT:                                                                                      * 
+ * newtree - a tree that has been loaded, possibly on another thread                           * 
+ *                                                                                             * 
+ * OUTPUT:                                                                                     * 
+ * 0 if the tree was added, 1 if it was rejected                                               * 
+ *                                                                                             * 
+ * WARNINGS:                                                                                   * 
+ * The manager owns the tree afterwards; a rejected tree is deleted.                           * 
+ *                                                                                             * 
+ * HISTORY:                                                                                    * 
+ *=============================================================================================*/
+int HTreeManagerClass::Add_Tree(HTreeClass * newtree)
+{
+	WWASSERT(newtree != NULL);
+
+	if (Get_Tree_ID(newtree->Get_Name()) != -1) {
 		
 		// tree with this name already exists, reject it!	
 		delete newtree;
-		goto Error;
-
-	} else {
+		return 1;
 
-		// ok, accept this hierarchy tree!
-		TreePtr[NumTrees] = newtree;
-		NumTrees++;
-
-		// Insert to hash table for fast name based search
-		StringClass lower_case_name(newtree->Get_Name(),true);
-		_strlwr(lower_case_name.Peek_Buffer());
-		TreeHash.Insert(lower_case_name,newtree);
 	}
 
-	return 0;
-
-Error:
+	// ok, accept this hierarchy tree!
+	TreePtr[NumTrees] = newtree;
+	NumTrees++;
 
-	return 1;
+	// Insert to hash table for fast name based search
+	StringClass lower_case_name(newtree->Get_Name(),true);
+	_strlwr(lower_case_name.Peek_Buffer());
+	TreeHash.Insert(lower_case_name,newtree);
 
+	return 0;
 }
 
 /*********************************************************************************************** 
@@ -69,6 +69,7 @@ public:
 	~HTreeManagerClass(void);
 
 	int							Load_Tree(ChunkLoadClass & cload);
+	int							Add_Tree(HTreeClass * newtree);
 	int							Num_Trees(void) { return NumTrees; }
 	HTreeClass *				Get_Tree(const char * name);
 	HTreeClass *				Get_Tree(int id);
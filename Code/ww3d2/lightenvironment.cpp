@@ -212,7 +212,23 @@ void LightEnvironmentClass::Add_Light(const LightClass & light)
 	*/
 	InputLightStruct new_light;
 	new_light.Init(light,ObjectCenter);
+	Add_Input_Light(new_light);
+}
+
+
+void LightEnvironmentClass::Add_Directional_Light(const Vector3 & direction,const Vector3 & diffuse)
+{
+	InputLightStruct new_light;
+	new_light.Direction = direction;
+	new_light.Ambient.Set(0,0,0);
+	new_light.Diffuse = diffuse;
+	new_light.DiffuseRejected = false;
+	Add_Input_Light(new_light);
+}
 
+
+void LightEnvironmentClass::Add_Input_Light(const InputLightStruct & new_light)
+{
 	/*
 	** Add in the ambient component
 	*/
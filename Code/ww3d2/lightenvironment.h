@@ -89,6 +89,13 @@ public:
 	*/
 	void					Reset(const Vector3 & object_center,const Vector3 & scene_ambient);
 	void					Add_Light(const LightClass & light);
+
+	/*
+	** Adding pre-computed lighting (such as baked light probes).  The direction is the
+	** world space direction *towards* the light, the same as Get_Light_Direction returns.
+	*/
+	void					Add_Ambient(const Vector3 & ambient)		{ OutputAmbient += ambient; }
+	void					Add_Directional_Light(const Vector3 & direction,const Vector3 & diffuse);
 	void					Pre_Render_Update(const Matrix3D & camera_tm);
 
 	/*
@@ -131,6 +138,8 @@ protected:
 		Vector3			Diffuse;							// diffuse color * attenuation
 	};
 
+	void					Add_Input_Light(const InputLightStruct & new_light);
+
 	/*
 	** Member variables
 	*/
@@ -45,6 +45,7 @@
 #include "camera.h"
 #include "dx8renderer.h"
 #include "hashtemplate.h"
+#include "skinkernel.h"
 
 
 /*
@@ -270,47 +271,34 @@ void MeshModelClass::Shadow_Render(SpecialRenderInfoClass & rinfo,const Matrix3D
 // Destination pointers MUST point to arrays large enough to hold all vertices
 void MeshModelClass::get_deformed_vertices(Vector3 *dst_vert,const HTreeClass * htree)
 {
-	Vector3 * src_vert = Vertex->Get_Array();
-	uint16 * bonelink = VertexBoneLink->Get_Array();
-	for (int vi = 0; vi < Get_Vertex_Count(); vi++) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-		Matrix3D::Transform_Vector(tm, src_vert[vi], &(dst_vert[vi]));
-	}
+	SkinKernelClass::Deform(
+		dst_vert,
+		NULL,
+		Vertex->Get_Array(),
+		NULL,
+		VertexBoneLink->Get_Array(),
+		Get_Vertex_Count(),
+		htree);
 }
 
 
 // Destination pointers MUST point to arrays large enough to hold all vertices
 void MeshModelClass::get_deformed_vertices(Vector3 *dst_vert, Vector3 *dst_norm,const HTreeClass * htree)
 {
-	int vi;
-	int vertex_count=Get_Vertex_Count();
-	Vector3 * src_vert = Vertex->Get_Array();
 #if (OPTIMIZE_VNORMS)
 	Vector3 * src_norm = (Vector3 *)Get_Vertex_Normal_Array();
 #else
 	Vector3 * src_norm = VertexNorm->Get_Array();
 #endif
-	uint16 * bonelink = VertexBoneLink->Get_Array();
-
-	for (vi = 0; vi < vertex_count;) {
-		const Matrix3D & tm = htree->Get_Transform(bonelink[vi]);
-
-		// Make a copy so we can set the translation to zero
-		Matrix3D mytm=tm;		
-
-		int idx=bonelink[vi];
-		int cnt;
-		for (cnt = vi; cnt < vertex_count; cnt++) {
-			if (idx!=bonelink[cnt]) {
-				break;
-			}
-		}
 
-		VectorProcessorClass::Transform(dst_vert+vi,src_vert+vi,mytm,cnt-vi);
-		mytm.Set_Translation(Vector3(0.0f,0.0f,0.0f));
-		VectorProcessorClass::Transform(dst_norm+vi,src_norm+vi,mytm,cnt-vi);
-		vi=cnt;
-	}
+	SkinKernelClass::Deform(
+		dst_vert,
+		dst_norm,
+		Vertex->Get_Array(),
+		src_norm,
+		VertexBoneLink->Get_Array(),
+		Get_Vertex_Count(),
+		htree);
 }
 
 // Destination pointer MUST point to arrays large enough to hold all vertices
@@ -89,6 +89,7 @@ class NullLoaderClass : public PrototypeLoaderClass
 public:
 	virtual int						Chunk_Type(void) { return W3D_CHUNK_NULL_OBJECT; }
 	virtual PrototypeClass *	Load_W3D(ChunkLoadClass & cload);
+	virtual bool					Is_Thread_Safe(void) { return true; }
 };
 
 
@@ -50,6 +50,8 @@
 #include "texture.h"
 #include "dx8wrapper.h"
 #include "vector3.h"
+#include "partkernel.h"
+#include "workerpool.h"
 
 // A random permutation of the numbers 0 to 15 - used for LOD particle decimation.
 // It was generated by the amazingly high-tech method of pulling numbers out of a hat.
@@ -2462,9 +2464,6 @@ void ParticleBufferClass::Update_Visual_Particle_State(void)
 
 	// The following back-to-back pair of "for" loops traverses the circular
 	// buffer subranges in proper order.
-	unsigned int ckey = NumColorKeyFrames - 1;
-	unsigned int akey = NumAlphaKeyFrames - 1;
-	unsigned int skey = NumSizeKeyFrames - 1;
 	unsigned int rkey = NumRotationKeyFrames - 1;
 	unsigned int fkey = NumFrameKeyFrames - 1;
 	unsigned int bkey = NumBlurTimeKeyFrames -1;
@@ -2487,48 +2486,57 @@ void ParticleBufferClass::Update_Visual_Particle_State(void)
 		position = Position[0]->Get_Array();
 	}
 
+	// Color, alpha and size are interpolated by the particle kernels, one
+	// property at a time over both subranges.
+	ParticleKernelClass::KeyTrackStruct track;
+	if (color) {
+		unsigned int ckey = NumColorKeyFrames - 1;
+		track.Components = 3;
+		track.Times = ColorKeyFrameTimes;
+		track.Values = &ColorKeyFrameValues[0].X;
+		track.Deltas = &ColorKeyFrameDeltas[0].X;
+		track.Random = &RandomColorEntries[0].X;
+		track.RandomMask = NumRandomColorEntriesMinus1;
+		track.ClampToZero = false;
+		ParticleKernelClass::Interpolate(track, &color[0].X, TimeStamp, Start, sub1_end, current_time, ckey);
+		ParticleKernelClass::Interpolate(track, &color[0].X, TimeStamp, sub2_start, End, current_time, ckey);
+	}
+
+	if (alpha) {
+		unsigned int akey = NumAlphaKeyFrames - 1;
+		track.Components = 1;
+		track.Times = AlphaKeyFrameTimes;
+		track.Values = AlphaKeyFrameValues;
+		track.Deltas = AlphaKeyFrameDeltas;
+		track.Random = RandomAlphaEntries;
+		track.RandomMask = NumRandomAlphaEntriesMinus1;
+		track.ClampToZero = false;
+		ParticleKernelClass::Interpolate(track, alpha, TimeStamp, Start, sub1_end, current_time, akey);
+		ParticleKernelClass::Interpolate(track, alpha, TimeStamp, sub2_start, End, current_time, akey);
+	}
+
+	// Size (unlike color and alpha) isn't clamped in the engine, so negative
+	// values are clamped to zero here.
+	if (size) {
+		unsigned int skey = NumSizeKeyFrames - 1;
+		track.Components = 1;
+		track.Times = SizeKeyFrameTimes;
+		track.Values = SizeKeyFrameValues;
+		track.Deltas = SizeKeyFrameDeltas;
+		track.Random = RandomSizeEntries;
+		track.RandomMask = NumRandomSizeEntriesMinus1;
+		track.ClampToZero = true;
+		ParticleKernelClass::Interpolate(track, size, TimeStamp, Start, sub1_end, current_time, skey);
+		ParticleKernelClass::Interpolate(track, size, TimeStamp, sub2_start, End, current_time, skey);
+	}
+
+	// The rest of the state is done per particle.
+	if (!orientation && !frame && !ucoord && !tailposition) return;
 
 	for (part = Start; part < sub1_end; part++) {
 
 		unsigned int part_age = current_time - TimeStamp[part];
 
-		// Ensure the current color keyframe is correct, and calculate color state
-		if (color) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < ColorKeyFrameTimes[ckey]; ckey--);
-
-			color[part] = ColorKeyFrameValues[ckey] +
-							ColorKeyFrameDeltas[ckey] * (float)(part_age - ColorKeyFrameTimes[ckey]) +
-							RandomColorEntries[part & NumRandomColorEntriesMinus1];
-		}
-
-		// Ensure the current alpha keyframe is correct, and calculate alpha state
-		if (alpha) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < AlphaKeyFrameTimes[akey]; akey--);
-
-			alpha[part] = AlphaKeyFrameValues[akey] +
-				AlphaKeyFrameDeltas[akey] * (float)(part_age - AlphaKeyFrameTimes[akey]) +
-				RandomAlphaEntries[part & NumRandomAlphaEntriesMinus1];
-		}
-
-		// Ensure the current size keyframe is correct, and calculate size state
-		if (size) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < SizeKeyFrameTimes[skey]; skey--);
-
-			size[part] = SizeKeyFrameValues[skey] +
-				SizeKeyFrameDeltas[skey] * (float)(part_age - SizeKeyFrameTimes[skey]) +
-				RandomSizeEntries[part & NumRandomSizeEntriesMinus1];
-
-			// Size (unlike color and alpha) isn't clamped in the engine, so we need to clamp
-			// negative values to zero here:
-			size[part] = (size[part] >= 0.0f) ? size[part] : 0.0f;
-		}
-
 		// Ensure the current rotation keyframe is correct, and calculate orientation state
 		if (orientation) {
 			// We go from older to younger particles, so we go backwards from the last keyframe until
@@ -2591,44 +2599,6 @@ void ParticleBufferClass::Update_Visual_Particle_State(void)
 
 		unsigned int part_age = current_time - TimeStamp[part];
 
-		// Ensure the current color keyframe is correct, and calculate color state
-		if (color) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < ColorKeyFrameTimes[ckey]; ckey--);
-
-			color[part] = 
-					ColorKeyFrameValues[ckey] +
-					ColorKeyFrameDeltas[ckey] * (float)(part_age - ColorKeyFrameTimes[ckey]) +
-					RandomColorEntries[part & NumRandomColorEntriesMinus1];
-		}
-
-		// Ensure the current alpha keyframe is correct, and calculate alpha state
-		if (alpha) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < AlphaKeyFrameTimes[akey]; akey--);
-
-			alpha[part] = AlphaKeyFrameValues[akey] +
-				AlphaKeyFrameDeltas[akey] * (float)(part_age - AlphaKeyFrameTimes[akey]) +
-				RandomAlphaEntries[part & NumRandomAlphaEntriesMinus1];
-		}
-
-		// Ensure the current size keyframe is correct, and calculate size state
-		if (size) {
-			// We go from older to younger particles, so we go backwards from the last keyframe until
-			// age >= keytime. This loop must terminate because the 0th keytime is 0.
-			for (; part_age < SizeKeyFrameTimes[skey]; skey--);
-
-			size[part] = SizeKeyFrameValues[skey] +
-				SizeKeyFrameDeltas[skey] * (float)(part_age - SizeKeyFrameTimes[skey]) +
-				RandomSizeEntries[part & NumRandomSizeEntriesMinus1];
-
-			// Size (unlike color) isn't clamped in the engine, so we need to
-			// clamp negative values to zero here:
-			size[part] = (size[part] >= 0.0f) ? size[part] : 0.0f;
-		}
-
 		// Ensure the current rotation keyframe is correct, and calculate orientation state
 		if (orientation) {
 			// We go from older to younger particles, so we go backwards from the last keyframe until
@@ -2752,6 +2722,47 @@ void ParticleBufferClass::Update_Bounding_Box(void)
 }
 
 
+void ParticleBufferClass::Update_Particle_Buffers(ParticleBufferClass ** buffers, int count)
+{
+	if (count <= 0) return;
+
+	// Buffers don't share any particle state, and the emitters have already
+	// queued this frame's new particles in On_Frame_Update().
+	WorkerPoolClass::Parallel_For(Update_Particle_Buffer_Job, buffers, count);
+}
+
+
+void ParticleBufferClass::Update_Particle_Buffers(RefRenderObjListClass & list)
+{
+	if (WorkerPoolClass::Get_Thread_Count() == 0) return;
+
+	WWPROFILE("ParticleBuffer::Update_Particle_Buffers");
+
+	SimpleDynVecClass<ParticleBufferClass *> buffers;
+	RefRenderObjListIterator it(&list);
+	for (it.First(); !it.Is_Done(); it.Next()) {
+		RenderObjClass * obj = it.Peek_Obj();
+		if (obj->Class_ID() == CLASSID_PARTICLEBUFFER) {
+			buffers.Add((ParticleBufferClass *)obj);
+		}
+	}
+
+	if (buffers.Count() > 1) {
+		Update_Particle_Buffers(&buffers[0], buffers.Count());
+	}
+}
+
+
+void ParticleBufferClass::Update_Particle_Buffer_Job(void * data, int index)
+{
+	ParticleBufferClass * buffer = ((ParticleBufferClass **)data)[index];
+
+	// Update_Bounding_Box() updates the kinematic state first, and leaves the
+	// box ready for the culling that follows.
+	buffer->Update_Bounding_Box();
+}
+
+
 // NOTE: typically, the number of new particles created in a frame is small
 // relative to the total number of particles, so this is not the most
 // performance-critical particle function. New particles are copied from the
@@ -2882,7 +2893,6 @@ void ParticleBufferClass::Update_Non_New_Particles(unsigned int elapsed)
 	// to two subranges. Find the Start - End subranges.
 	unsigned int sub1_end;		// End of subrange 1.
 	unsigned int sub2_start;	// Start of subrange 2.
-	unsigned int i;				// Loop index.
 	if ((Start < End) || ((Start == End) && NonNewNum ==0)) {
 		sub1_end = End;
 		sub2_start = End;
@@ -2893,56 +2903,27 @@ void ParticleBufferClass::Update_Non_New_Particles(unsigned int elapsed)
 
 	float fp_elapsed_time = (float)elapsed;
 
-	// Update position and velocity for all particles.
+	// Update position and velocity for all particles. With pingpong enabled
+	// and acceleration the new position is computed from the previous one,
+	// otherwise the position is moved in place.
+	Vector3 *position;
+	Vector3 *prev_pos = NULL;
 	if (PingPongPosition) {
-
 		int pingpong = WW3D::Get_Frame_Count() & 0x1;
-		Vector3 *position = Position[pingpong]->Get_Array();
-		Vector3 *prev_pos = Position[pingpong ^ 0x1]->Get_Array();
-
-		if (HasAccel) {
-			Vector3 delta_v = Accel * fp_elapsed_time;
-			Vector3 accel_p = Accel * (0.5f * fp_elapsed_time * fp_elapsed_time);
-			for (i = Start; i < sub1_end; i++) {
-				position[i] = prev_pos[i] + Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] = prev_pos[i] + Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-		} else {
-			for (i = Start; i < sub1_end; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
-		}
+		position = Position[pingpong]->Get_Array();
+		if (HasAccel) prev_pos = Position[pingpong ^ 0x1]->Get_Array();
 	} else {
+		position = Position[0]->Get_Array();
+	}
 
-		Vector3 *position = Position[0]->Get_Array();
+	Vector3 delta_v = Accel * fp_elapsed_time;
+	Vector3 accel_p = Accel * (0.5f * fp_elapsed_time * fp_elapsed_time);
+	const float *accel_ptr = HasAccel ? &accel_p.X : NULL;
 
-		if (HasAccel) {
-			Vector3 delta_v = Accel * fp_elapsed_time;
-			Vector3 accel_p = Accel * (0.5f * fp_elapsed_time * fp_elapsed_time);
-			for (i = Start; i < sub1_end; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time + accel_p;
-				Velocity[i] += delta_v;
-			}
-		} else {
-			for (i = Start; i < sub1_end; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
-			for (i = sub2_start; i < End; i++) {
-				position[i] += Velocity[i] * fp_elapsed_time;
-			}
-		}
-	}
+	ParticleKernelClass::Integrate(&position[Start].X, prev_pos ? &prev_pos[Start].X : NULL, &Velocity[Start].X,
+		sub1_end - Start, fp_elapsed_time, accel_ptr, &delta_v.X);
+	ParticleKernelClass::Integrate(&position[sub2_start].X, prev_pos ? &prev_pos[sub2_start].X : NULL, &Velocity[sub2_start].X,
+		End - sub2_start, fp_elapsed_time, accel_ptr, &delta_v.X);
 }
 
 void ParticleBufferClass::Get_Color_Key_Frames (ParticlePropertyStruct<Vector3> &colors) const
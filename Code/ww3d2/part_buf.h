@@ -229,6 +229,16 @@ class ParticleBufferClass : public RenderObjClass
 		// Global control of particle LOD.  
 		static void				Set_LOD_Max_Screen_Size(int lod_level,float max_screen_size);
 		static float			Get_LOD_Max_Screen_Size(int lod_level);
+
+		// Bring the particles of several buffers up to date at once, spread
+		// across the WorkerPoolClass threads. Each buffer is updated exactly as
+		// it would be on its own, so the result doesn't depend on the threads.
+		static void				Update_Particle_Buffers(ParticleBufferClass ** buffers, int count);
+
+		// Same for the particle buffers in a scene's update list, called after
+		// their On_Frame_Update(). Without worker threads this does nothing and
+		// the buffers update when they are first rendered or culled.
+		static void				Update_Particle_Buffers(RefRenderObjListClass & list);
 			
 	protected:
 
@@ -256,6 +266,9 @@ class ParticleBufferClass : public RenderObjClass
 		// Update the bounding box. (Updates the particle state if it needs to).
 		void Update_Bounding_Box(void);
 
+		// Worker job for Update_Particle_Buffers()
+		static void Update_Particle_Buffer_Job(void * data, int index);
+
 		// Helper function for Render_Particles and Render_LineGroup
 		void Generate_APT(ShareBufferClass <unsigned int> **apt,unsigned int &active_point_count);
 		void Combine_Color_And_Alpha();
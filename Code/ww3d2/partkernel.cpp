@@ -0,0 +1,412 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "partkernel.h"
+#include "cpudetect.h"
+#include "wwdebug.h"
+#include <emmintrin.h>
+#include <immintrin.h>
+
+ParticleKernelClass::KernelType ParticleKernelClass::Kernel=ParticleKernelClass::KERNEL_BEST;
+
+void ParticleKernelClass::Set_Kernel(KernelType kernel)
+{
+	Kernel=kernel;
+}
+
+ParticleKernelClass::KernelType ParticleKernelClass::Get_Kernel()
+{
+	if (Kernel>=KERNEL_AVX2 && CPUDetectClass::Has_AVX2_Instruction_Set()) return KERNEL_AVX2;
+	if (Kernel>=KERNEL_SSE2 && CPUDetectClass::Has_SSE2_Instruction_Set()) return KERNEL_SSE2;
+	return KERNEL_SCALAR;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Four or eight Vector3s fill three registers, so a Vector3 that is the same
+// for every particle is repeated across 24 floats and loaded from there.
+//
+// ----------------------------------------------------------------------------
+
+struct Vec3PatternStruct
+{
+	Vec3PatternStruct(const float * v)
+	{
+		for (int i=0;i<24;++i) {
+			F[i]=v[i%3];
+		}
+	}
+
+	float F[24];
+};
+
+// Exact unsigned to float conversion, cvtepi32 is signed only
+WWINLINE static __m128 U32_To_Float_SSE2(__m128i x)
+{
+	__m128 hi=_mm_cvtepi32_ps(_mm_srli_epi32(x,16));
+	__m128 lo=_mm_cvtepi32_ps(_mm_and_si128(x,_mm_set1_epi32(0xffff)));
+	return _mm_add_ps(_mm_mul_ps(hi,_mm_set1_ps(65536.0f)),lo);
+}
+
+WWINLINE static __m256 U32_To_Float_AVX2(__m256i x)
+{
+	__m256 hi=_mm256_cvtepi32_ps(_mm256_srli_epi32(x,16));
+	__m256 lo=_mm256_cvtepi32_ps(_mm256_and_si256(x,_mm256_set1_epi32(0xffff)));
+	return _mm256_add_ps(_mm256_mul_ps(hi,_mm256_set1_ps(65536.0f)),lo);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Scalar kernels. These are the loops ParticleBufferClass used to do on
+// Vector3s, one component at a time with the operations in the same order.
+//
+// ----------------------------------------------------------------------------
+
+static void Integrate_Scalar(float * p,const float * prev,float * v,unsigned int count,float t,const float * ap,const float * dv)
+{
+	if (ap==NULL) {
+		for (unsigned int i=0;i<count*3;++i) {
+			p[i]+=v[i]*t;
+		}
+	} else if (prev==NULL) {
+		for (unsigned int i=0;i<count;++i,p+=3,v+=3) {
+			for (int c=0;c<3;++c) {
+				p[c]+=v[c]*t+ap[c];
+				v[c]+=dv[c];
+			}
+		}
+	} else {
+		for (unsigned int i=0;i<count;++i,p+=3,prev+=3,v+=3) {
+			for (int c=0;c<3;++c) {
+				p[c]=prev[c]+v[c]*t+ap[c];
+				v[c]+=dv[c];
+			}
+		}
+	}
+}
+
+static void Interpolate1_Scalar(float * out,const unsigned int * ts,unsigned int count,unsigned int base,
+	const float * value,const float * delta,const float * random,bool random_step,bool clamp)
+{
+	for (unsigned int i=0;i<count;++i) {
+		float s=value[0]+delta[0]*(float)(base-ts[i])+random[random_step ? i : 0];
+		if (clamp) {
+			s=(s>=0.0f) ? s : 0.0f;
+		}
+		out[i]=s;
+	}
+}
+
+static void Interpolate3_Scalar(float * out,const unsigned int * ts,unsigned int count,unsigned int base,
+	const float * value,const float * delta,const float * random,bool random_step,bool clamp)
+{
+	for (unsigned int i=0;i<count;++i,out+=3) {
+		float f=(float)(base-ts[i]);
+		const float * r=random_step ? random+i*3 : random;
+		for (int c=0;c<3;++c) {
+			float s=value[c]+delta[c]*f+r[c];
+			if (clamp) {
+				s=(s>=0.0f) ? s : 0.0f;
+			}
+			out[c]=s;
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// SSE2 kernels, four particles at a time. The integration doesn't care which
+// component a float is, only the acceleration has to line up with it.
+//
+// ----------------------------------------------------------------------------
+
+static void Integrate_SSE2(float * p,const float * prev,float * v,unsigned int count,float t,const float * ap,const float * dv)
+{
+	__m128 vt=_mm_set1_ps(t);
+	unsigned int i=0;
+
+	if (ap==NULL) {
+		for (;i+4<=count;i+=4,p+=12,v+=12) {
+			for (int j=0;j<12;j+=4) {
+				_mm_storeu_ps(p+j,_mm_add_ps(_mm_loadu_ps(p+j),_mm_mul_ps(_mm_loadu_ps(v+j),vt)));
+			}
+		}
+	} else {
+		Vec3PatternStruct accel(ap);
+		Vec3PatternStruct dvel(dv);
+		for (;i+4<=count;i+=4,p+=12,v+=12) {
+			for (int j=0;j<12;j+=4) {
+				__m128 vel=_mm_loadu_ps(v+j);
+				__m128 a=_mm_loadu_ps(accel.F+j);
+				if (prev==NULL) {
+					_mm_storeu_ps(p+j,_mm_add_ps(_mm_loadu_ps(p+j),_mm_add_ps(_mm_mul_ps(vel,vt),a)));
+				} else {
+					_mm_storeu_ps(p+j,_mm_add_ps(_mm_add_ps(_mm_loadu_ps(prev+j),_mm_mul_ps(vel,vt)),a));
+				}
+				_mm_storeu_ps(v+j,_mm_add_ps(vel,_mm_loadu_ps(dvel.F+j)));
+			}
+			if (prev!=NULL) prev+=12;
+		}
+	}
+
+	Integrate_Scalar(p,prev,v,count-i,t,ap,dv);
+}
+
+WWINLINE static __m128 Clamp_SSE2(__m128 s,bool clamp)
+{
+	return clamp ? _mm_and_ps(_mm_cmpge_ps(s,_mm_setzero_ps()),s) : s;
+}
+
+static void Interpolate1_SSE2(float * out,const unsigned int * ts,unsigned int count,unsigned int base,
+	const float * value,const float * delta,const float * random,bool random_step,bool clamp)
+{
+	__m128i b=_mm_set1_epi32((int)base);
+	__m128 v=_mm_set1_ps(value[0]);
+	__m128 d=_mm_set1_ps(delta[0]);
+	__m128 r=_mm_set1_ps(random[0]);
+	unsigned int i=0;
+
+	for (;i+4<=count;i+=4) {
+		__m128 f=U32_To_Float_SSE2(_mm_sub_epi32(b,_mm_loadu_si128((const __m128i *)(ts+i))));
+		if (random_step) {
+			r=_mm_loadu_ps(random+i);
+		}
+		_mm_storeu_ps(out+i,Clamp_SSE2(_mm_add_ps(_mm_add_ps(v,_mm_mul_ps(d,f)),r),clamp));
+	}
+
+	Interpolate1_Scalar(out+i,ts+i,count-i,base,value,delta,random_step ? random+i : random,random_step,clamp);
+}
+
+static void Interpolate3_SSE2(float * out,const unsigned int * ts,unsigned int count,unsigned int base,
+	const float * value,const float * delta,const float * random,bool random_step,bool clamp)
+{
+	Vec3PatternStruct vp(value);
+	Vec3PatternStruct dp(delta);
+	Vec3PatternStruct rp(random);
+	__m128i b=_mm_set1_epi32((int)base);
+	__m128 v[3],d[3],r[3];
+	for (int j=0;j<3;++j) {
+		v[j]=_mm_loadu_ps(vp.F+j*4);
+		d[j]=_mm_loadu_ps(dp.F+j*4);
+		r[j]=_mm_loadu_ps(rp.F+j*4);
+	}
+	unsigned int i=0;
+
+	for (;i+4<=count;i+=4) {
+		__m128 f=U32_To_Float_SSE2(_mm_sub_epi32(b,_mm_loadu_si128((const __m128i *)(ts+i))));
+		__m128 fx[3];
+		fx[0]=_mm_shuffle_ps(f,f,_MM_SHUFFLE(1,0,0,0));
+		fx[1]=_mm_shuffle_ps(f,f,_MM_SHUFFLE(2,2,1,1));
+		fx[2]=_mm_shuffle_ps(f,f,_MM_SHUFFLE(3,3,3,2));
+		for (int j=0;j<3;++j) {
+			if (random_step) {
+				r[j]=_mm_loadu_ps(random+i*3+j*4);
+			}
+			_mm_storeu_ps(out+i*3+j*4,Clamp_SSE2(_mm_add_ps(_mm_add_ps(v[j],_mm_mul_ps(d[j],fx[j])),r[j]),clamp));
+		}
+	}
+
+	Interpolate3_Scalar(out+i*3,ts+i,count-i,base,value,delta,random_step ? random+i*3 : random,random_step,clamp);
+}
+
+// ----------------------------------------------------------------------------
+//
+// AVX2 kernels, eight particles at a time. No FMA, so the results are the
+// same as the SSE2 and scalar kernels.
+//
+// ----------------------------------------------------------------------------
+
+static void Integrate_AVX2(float * p,const float * prev,float * v,unsigned int count,float t,const float * ap,const float * dv)
+{
+	__m256 vt=_mm256_set1_ps(t);
+	unsigned int i=0;
+
+	if (ap==NULL) {
+		for (;i+8<=count;i+=8,p+=24,v+=24) {
+			for (int j=0;j<24;j+=8) {
+				_mm256_storeu_ps(p+j,_mm256_add_ps(_mm256_loadu_ps(p+j),_mm256_mul_ps(_mm256_loadu_ps(v+j),vt)));
+			}
+		}
+	} else {
+		Vec3PatternStruct accel(ap);
+		Vec3PatternStruct dvel(dv);
+		for (;i+8<=count;i+=8,p+=24,v+=24) {
+			for (int j=0;j<24;j+=8) {
+				__m256 vel=_mm256_loadu_ps(v+j);
+				__m256 a=_mm256_loadu_ps(accel.F+j);
+				if (prev==NULL) {
+					_mm256_storeu_ps(p+j,_mm256_add_ps(_mm256_loadu_ps(p+j),_mm256_add_ps(_mm256_mul_ps(vel,vt),a)));
+				} else {
+					_mm256_storeu_ps(p+j,_mm256_add_ps(_mm256_add_ps(_mm256_loadu_ps(prev+j),_mm256_mul_ps(vel,vt)),a));
+				}
+				_mm256_storeu_ps(v+j,_mm256_add_ps(vel,_mm256_loadu_ps(dvel.F+j)));
+			}
+			if (prev!=NULL) prev+=24;
+		}
+	}
+	_mm256_zeroupper();
+
+	Integrate_SSE2(p,prev,v,count-i,t,ap,dv);
+}
+
+WWINLINE static __m256 Clamp_AVX2(__m256 s,bool clamp)
+{
+	return clamp ? _mm256_and_ps(_mm256_cmp_ps(s,_mm256_setzero_ps(),_CMP_GE_OQ),s) : s;
+}
+
+static void Interpolate1_AVX2(float * out,const unsigned int * ts,unsigned int count,unsigned int base,
+	const float * value,const float * delta,const float * random,bool random_step,bool clamp)
+{
+	__m256i b=_mm256_set1_epi32((int)base);
+	__m256 v=_mm256_set1_ps(value[0]);
+	__m256 d=_mm256_set1_ps(delta[0]);
+	__m256 r=_mm256_set1_ps(random[0]);
+	unsigned int i=0;
+
+	for (;i+8<=count;i+=8) {
+		__m256 f=U32_To_Float_AVX2(_mm256_sub_epi32(b,_mm256_loadu_si256((const __m256i *)(ts+i))));
+		if (random_step) {
+			r=_mm256_loadu_ps(random+i);
+		}
+		_mm256_storeu_ps(out+i,Clamp_AVX2(_mm256_add_ps(_mm256_add_ps(v,_mm256_mul_ps(d,f)),r),clamp));
+	}
+	_mm256_zeroupper();
+
+	Interpolate1_SSE2(out+i,ts+i,count-i,base,value,delta,random_step ? random+i : random,random_step,clamp);
+}
+
+static void Interpolate3_AVX2(float * out,const unsigned int * ts,unsigned int count,unsigned int base,
+	const float * value,const float * delta,const float * random,bool random_step,bool clamp)
+{
+	Vec3PatternStruct vp(value);
+	Vec3PatternStruct dp(delta);
+	Vec3PatternStruct rp(random);
+	__m256i b=_mm256_set1_epi32((int)base);
+	__m256i idx[3];
+	idx[0]=_mm256_setr_epi32(0,0,0,1,1,1,2,2);
+	idx[1]=_mm256_setr_epi32(2,3,3,3,4,4,4,5);
+	idx[2]=_mm256_setr_epi32(5,5,6,6,6,7,7,7);
+	__m256 v[3],d[3],r[3];
+	for (int j=0;j<3;++j) {
+		v[j]=_mm256_loadu_ps(vp.F+j*8);
+		d[j]=_mm256_loadu_ps(dp.F+j*8);
+		r[j]=_mm256_loadu_ps(rp.F+j*8);
+	}
+	unsigned int i=0;
+
+	for (;i+8<=count;i+=8) {
+		__m256 f=U32_To_Float_AVX2(_mm256_sub_epi32(b,_mm256_loadu_si256((const __m256i *)(ts+i))));
+		for (int j=0;j<3;++j) {
+			if (random_step) {
+				r[j]=_mm256_loadu_ps(random+i*3+j*8);
+			}
+			__m256 fx=_mm256_permutevar8x32_ps(f,idx[j]);
+			_mm256_storeu_ps(out+i*3+j*8,Clamp_AVX2(_mm256_add_ps(_mm256_add_ps(v[j],_mm256_mul_ps(d[j],fx)),r[j]),clamp));
+		}
+	}
+	_mm256_zeroupper();
+
+	Interpolate3_SSE2(out+i*3,ts+i,count-i,base,value,delta,random_step ? random+i*3 : random,random_step,clamp);
+}
+
+void ParticleKernelClass::Integrate(
+	float * position,
+	const float * prev_pos,
+	float * velocity,
+	unsigned int count,
+	float elapsed,
+	const float * accel_p,
+	const float * delta_v)
+{
+	if (count==0) return;
+	WWASSERT(position!=NULL && velocity!=NULL);
+	WWASSERT(accel_p==NULL || delta_v!=NULL);
+
+	switch (Get_Kernel()) {
+		case KERNEL_AVX2:	Integrate_AVX2(position,prev_pos,velocity,count,elapsed,accel_p,delta_v); break;
+		case KERNEL_SSE2:	Integrate_SSE2(position,prev_pos,velocity,count,elapsed,accel_p,delta_v); break;
+		default:				Integrate_Scalar(position,prev_pos,velocity,count,elapsed,accel_p,delta_v); break;
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// The particles are split into runs that share a keyframe, found the same way
+// the original loop did it, and the runs where the random table wraps. Each
+// piece then only needs its ages to be computed.
+//
+// ----------------------------------------------------------------------------
+
+void ParticleKernelClass::Interpolate(
+	const KeyTrackStruct & track,
+	float * out,
+	const unsigned int * timestamps,
+	unsigned int first,
+	unsigned int end,
+	unsigned int current_time,
+	unsigned int & key)
+{
+	WWASSERT(track.Components==1 || track.Components==3);
+
+	typedef void (*InterpolateFunc)(float *,const unsigned int *,unsigned int,unsigned int,const float *,const float *,const float *,bool,bool);
+	InterpolateFunc interpolate;
+	KernelType kernel=Get_Kernel();
+	if (track.Components==3) {
+		interpolate=(kernel==KERNEL_AVX2) ? Interpolate3_AVX2 : (kernel==KERNEL_SSE2) ? Interpolate3_SSE2 : Interpolate3_Scalar;
+	} else {
+		interpolate=(kernel==KERNEL_AVX2) ? Interpolate1_AVX2 : (kernel==KERNEL_SSE2) ? Interpolate1_SSE2 : Interpolate1_Scalar;
+	}
+
+	int components=track.Components;
+	unsigned int mask=track.RandomMask;
+	unsigned int part=first;
+
+	while (part<end) {
+
+		// We go from older to younger particles, so we go backwards from the last keyframe until
+		// age >= keytime. This loop must terminate because the 0th keytime is 0.
+		unsigned int age=current_time-timestamps[part];
+		for (; age<track.Times[key]; key--);
+
+		unsigned int key_time=track.Times[key];
+		unsigned int run_end=end;
+		if (key>0) {
+			run_end=part+1;
+			while (run_end<end && current_time-timestamps[run_end]>=key_time) run_end++;
+		}
+
+		// age - keytime, for each particle in the run
+		unsigned int base=current_time-key_time;
+		const float * value=track.Values+key*components;
+		const float * delta=track.Deltas+key*components;
+
+		while (part<run_end) {
+			unsigned int count=run_end-part;
+			const float * random=track.Random;
+			if (mask!=0) {
+				unsigned int index=part & mask;
+				if (count>mask+1-index) count=mask+1-index;
+				random+=index*components;
+			}
+			interpolate(out+part*components,timestamps+part,count,base,value,delta,random,mask!=0,track.ClampToZero);
+			part+=count;
+		}
+	}
+}
@@ -0,0 +1,100 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#ifndef PARTKERNEL_H
+#define PARTKERNEL_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+
+// ----------------------------------------------------------------------------
+//
+// The per-particle loops of ParticleBufferClass: moving the particles along
+// their velocities and interpolating the color, opacity and size keyframes.
+//
+// The particle arrays are walked as flat float arrays, Vector3 arrays three
+// floats per particle. The SSE2 and AVX2 kernels do four or eight particles
+// at a time and round exactly like the scalar kernel, which is always
+// available, so the results don't depend on the cpu.
+//
+// ----------------------------------------------------------------------------
+
+class ParticleKernelClass
+{
+public:
+	enum KernelType {
+		KERNEL_SCALAR=0,
+		KERNEL_SSE2,
+		KERNEL_AVX2,
+		KERNEL_BEST
+	};
+
+	// Select the kernel. KERNEL_BEST picks the fastest one supported by the cpu,
+	// requesting a kernel that isn't supported falls back to the next best one.
+	static void Set_Kernel(KernelType kernel);
+	static KernelType Get_Kernel();
+
+	// One keyframed property. Values, Deltas and Random hold Components floats
+	// (1 or 3) per entry. Random is indexed by particle index & RandomMask, a
+	// mask of zero means every particle uses the first entry.
+	struct KeyTrackStruct
+	{
+		int							Components;
+		const unsigned int *		Times;			// 0th entry is always 0
+		const float *				Values;
+		const float *				Deltas;
+		const float *				Random;
+		unsigned int				RandomMask;
+		bool							ClampToZero;	// clamp negative results to zero (size)
+	};
+
+	// Move particles [0,count) by elapsed milliseconds. Without acceleration
+	// (accel_p NULL) positions are moved in place. With it, the new position
+	// is computed from prev_pos if it isn't NULL, otherwise from position, and
+	// delta_v is added to the velocities. accel_p and delta_v are Vector3s.
+	static void Integrate(
+		float * position,
+		const float * prev_pos,
+		float * velocity,
+		unsigned int count,
+		float elapsed,
+		const float * accel_p,
+		const float * delta_v);
+
+	// Interpolate a property for particles [first,end), oldest first. key is
+	// the current keyframe, which only ever moves back, and is left on the
+	// keyframe of the last particle so the next range can carry on from it.
+	static void Interpolate(
+		const KeyTrackStruct & track,
+		float * out,
+		const unsigned int * timestamps,
+		unsigned int first,
+		unsigned int end,
+		unsigned int current_time,
+		unsigned int & key);
+
+private:
+	static KernelType Kernel;
+};
+
+#endif
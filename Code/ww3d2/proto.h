@@ -45,6 +45,7 @@
 #include "always.h"
 #include <stdlib.h>
 #include "w3d_file.h"
+#include "nametable.h"
 
 class RenderObjClass;
 class ChunkLoadClass;
@@ -97,6 +98,7 @@ public:
 private:
 
 	PrototypeClass *				NextHash;
+	NameClass						HashName;			// interned Get_Name(), set by Add_Prototype
 
 	// Not Implemented
 	PrototypeClass(const PrototypeClass & that);
@@ -122,6 +124,10 @@ public:
 ** This is the interface for an object which recognizes a certain
 ** chunk type in a W3D file and can load it and create a PrototypeClass
 ** for it.  
+**
+** Is_Thread_Safe tells the asset manager that Load_W3D only builds objects
+** which it owns outright (no textures, no asset manager lookups, no shared
+** references) so it can be run on a worker thread.
 */
 class PrototypeLoaderClass 
 {
@@ -133,6 +139,7 @@ public:
 
 	virtual int						Chunk_Type(void) = 0;
 	virtual PrototypeClass *	Load_W3D(ChunkLoadClass & cload) = 0;
+	virtual bool					Is_Thread_Safe(void) { return false; }
 
 private:
 
@@ -160,6 +167,7 @@ public:
 
 	virtual int						Chunk_Type(void) { return W3D_CHUNK_HMODEL; }
 	virtual PrototypeClass *	Load_W3D(ChunkLoadClass & cload);
+	virtual bool					Is_Thread_Safe(void) { return true; }
 };
 
 
@@ -67,6 +67,7 @@
 #include "dx8wrapper.h"
 #include "sortingrenderer.h"
 #include "coltest.h"
+#include "part_buf.h"
 
 
 /*
@@ -540,6 +541,7 @@ void SimpleSceneClass::Customized_Render(RenderInfoClass & rinfo)
 	for (it.First(); !it.Is_Done(); it.Next()) {
 		it.Peek_Obj()->On_Frame_Update();
 	}
+	ParticleBufferClass::Update_Particle_Buffers(UpdateList);
 
 	// apply only the first four lights in the scene
 	// derived classes should use light environment
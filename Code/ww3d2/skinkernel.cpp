@@ -0,0 +1,330 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "skinkernel.h"
+#include "htree.h"
+#include "matrix3d.h"
+#include "vector3.h"
+#include "vp.h"
+#include "cpudetect.h"
+#include "workerpool.h"
+#include "wwdebug.h"
+#include <xmmintrin.h>
+#include <immintrin.h>
+
+SkinKernelClass::KernelType SkinKernelClass::Kernel=SkinKernelClass::KERNEL_BEST;
+bool SkinKernelClass::ParallelEnabled=true;
+
+void SkinKernelClass::Set_Kernel(KernelType kernel)
+{
+	Kernel=kernel;
+}
+
+SkinKernelClass::KernelType SkinKernelClass::Get_Kernel()
+{
+	if (Kernel>=KERNEL_AVX2 && CPUDetectClass::Has_AVX2_Instruction_Set()) return KERNEL_AVX2;
+	if (Kernel>=KERNEL_SSE && CPUDetectClass::Has_SSE_Instruction_Set()) return KERNEL_SSE;
+	return KERNEL_SCALAR;
+}
+
+// ----------------------------------------------------------------------------
+//
+// The work for one call to Deform(). Bones come either from the htree or from
+// an array, looked up once per run of vertices.
+//
+// ----------------------------------------------------------------------------
+
+struct SkinJobStruct
+{
+	Vector3*				DstVert;
+	Vector3*				DstNorm;
+	const Vector3*		SrcVert;
+	const Vector3*		SrcNorm;
+	const uint16*		BoneLinks;
+	int					VertexCount;
+	const HTreeClass*	Tree;
+	const Matrix3D*	Bones;
+	SkinKernelClass::KernelType Kernel;
+
+	WWINLINE const Matrix3D& Get_Bone(int index) const
+	{
+		return Tree ? Tree->Get_Transform(index) : Bones[index];
+	}
+};
+
+// ----------------------------------------------------------------------------
+//
+// Scalar kernel. The sums are done in the same order as the SIMD kernels.
+//
+// ----------------------------------------------------------------------------
+
+WWINLINE static void Transform_Scalar(float* dst,const float* src,const Matrix3D& tm,int count,bool translate)
+{
+	float tx=translate ? tm[0][3] : 0.0f;
+	float ty=translate ? tm[1][3] : 0.0f;
+	float tz=translate ? tm[2][3] : 0.0f;
+	for (int i=0;i<count;++i,src+=3,dst+=3) {
+		float x=src[0];
+		float y=src[1];
+		float z=src[2];
+		dst[0]=tm[0][0]*x+tm[0][1]*y+tm[0][2]*z+tx;
+		dst[1]=tm[1][0]*x+tm[1][1]*y+tm[1][2]*z+ty;
+		dst[2]=tm[2][0]*x+tm[2][1]*y+tm[2][2]*z+tz;
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// SSE kernel. Four Vector3s are loaded as three registers
+//   a=[x0 y0 z0 x1] b=[y1 z1 x2 y2] c=[z2 x3 y3 z3]
+// and shuffled into x, y and z registers and back. The AVX2 kernel uses the
+// same shuffles, which work on each 128 bit half of a 256 bit register.
+//
+// ----------------------------------------------------------------------------
+
+#define SKIN_SWIZZLE_IN(SHUFFLE,a,b,c,x,y,z)																	\
+	x=SHUFFLE(a,SHUFFLE(b,c,_MM_SHUFFLE(1,1,2,2)),_MM_SHUFFLE(2,0,3,0));								\
+	y=SHUFFLE(SHUFFLE(a,b,_MM_SHUFFLE(0,0,1,1)),SHUFFLE(b,c,_MM_SHUFFLE(2,2,3,3)),_MM_SHUFFLE(2,0,2,0));	\
+	z=SHUFFLE(SHUFFLE(a,b,_MM_SHUFFLE(1,1,2,2)),SHUFFLE(c,c,_MM_SHUFFLE(3,3,0,0)),_MM_SHUFFLE(2,0,2,0));
+
+#define SKIN_SWIZZLE_OUT(SHUFFLE,UNPACKLO,UNPACKHI,x,y,z,a,b,c)												\
+	a=SHUFFLE(UNPACKLO(x,y),SHUFFLE(z,x,_MM_SHUFFLE(1,1,0,0)),_MM_SHUFFLE(2,0,1,0));					\
+	b=SHUFFLE(SHUFFLE(y,z,_MM_SHUFFLE(1,1,1,1)),UNPACKHI(x,y),_MM_SHUFFLE(1,0,2,0));					\
+	c=SHUFFLE(SHUFFLE(z,x,_MM_SHUFFLE(3,3,2,2)),SHUFFLE(y,z,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(2,0,2,0));
+
+static void Transform_SSE(float* dst,const float* src,const Matrix3D& tm,int count,bool translate)
+{
+	__m128 m00=_mm_set1_ps(tm[0][0]), m01=_mm_set1_ps(tm[0][1]), m02=_mm_set1_ps(tm[0][2]);
+	__m128 m10=_mm_set1_ps(tm[1][0]), m11=_mm_set1_ps(tm[1][1]), m12=_mm_set1_ps(tm[1][2]);
+	__m128 m20=_mm_set1_ps(tm[2][0]), m21=_mm_set1_ps(tm[2][1]), m22=_mm_set1_ps(tm[2][2]);
+	__m128 tx=_mm_set1_ps(translate ? tm[0][3] : 0.0f);
+	__m128 ty=_mm_set1_ps(translate ? tm[1][3] : 0.0f);
+	__m128 tz=_mm_set1_ps(translate ? tm[2][3] : 0.0f);
+
+	int i=0;
+	for (;i+4<=count;i+=4,src+=12,dst+=12) {
+		__m128 a=_mm_loadu_ps(src);
+		__m128 b=_mm_loadu_ps(src+4);
+		__m128 c=_mm_loadu_ps(src+8);
+		__m128 x,y,z;
+		SKIN_SWIZZLE_IN(_mm_shuffle_ps,a,b,c,x,y,z);
+
+		__m128 rx=_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00,x),_mm_mul_ps(m01,y)),_mm_mul_ps(m02,z)),tx);
+		__m128 ry=_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m10,x),_mm_mul_ps(m11,y)),_mm_mul_ps(m12,z)),ty);
+		__m128 rz=_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m20,x),_mm_mul_ps(m21,y)),_mm_mul_ps(m22,z)),tz);
+
+		SKIN_SWIZZLE_OUT(_mm_shuffle_ps,_mm_unpacklo_ps,_mm_unpackhi_ps,rx,ry,rz,a,b,c);
+		_mm_storeu_ps(dst,a);
+		_mm_storeu_ps(dst+4,b);
+		_mm_storeu_ps(dst+8,c);
+	}
+
+	Transform_Scalar(dst,src,tm,count-i,translate);
+}
+
+// ----------------------------------------------------------------------------
+//
+// AVX2 kernel, eight vertices at a time. The low half of each register holds
+// vertices 0-3 and the high half vertices 4-7. No FMA, so the results are the
+// same as the SSE and scalar kernels.
+//
+// ----------------------------------------------------------------------------
+
+static void Transform_AVX2(float* dst,const float* src,const Matrix3D& tm,int count,bool translate)
+{
+	__m256 m00=_mm256_set1_ps(tm[0][0]), m01=_mm256_set1_ps(tm[0][1]), m02=_mm256_set1_ps(tm[0][2]);
+	__m256 m10=_mm256_set1_ps(tm[1][0]), m11=_mm256_set1_ps(tm[1][1]), m12=_mm256_set1_ps(tm[1][2]);
+	__m256 m20=_mm256_set1_ps(tm[2][0]), m21=_mm256_set1_ps(tm[2][1]), m22=_mm256_set1_ps(tm[2][2]);
+	__m256 tx=_mm256_set1_ps(translate ? tm[0][3] : 0.0f);
+	__m256 ty=_mm256_set1_ps(translate ? tm[1][3] : 0.0f);
+	__m256 tz=_mm256_set1_ps(translate ? tm[2][3] : 0.0f);
+
+	int i=0;
+	for (;i+8<=count;i+=8,src+=24,dst+=24) {
+		__m256 a=_mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src)),_mm_loadu_ps(src+12),1);
+		__m256 b=_mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src+4)),_mm_loadu_ps(src+16),1);
+		__m256 c=_mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src+8)),_mm_loadu_ps(src+20),1);
+		__m256 x,y,z;
+		SKIN_SWIZZLE_IN(_mm256_shuffle_ps,a,b,c,x,y,z);
+
+		__m256 rx=_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00,x),_mm256_mul_ps(m01,y)),_mm256_mul_ps(m02,z)),tx);
+		__m256 ry=_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m10,x),_mm256_mul_ps(m11,y)),_mm256_mul_ps(m12,z)),ty);
+		__m256 rz=_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m20,x),_mm256_mul_ps(m21,y)),_mm256_mul_ps(m22,z)),tz);
+
+		SKIN_SWIZZLE_OUT(_mm256_shuffle_ps,_mm256_unpacklo_ps,_mm256_unpackhi_ps,rx,ry,rz,a,b,c);
+		_mm_storeu_ps(dst,_mm256_castps256_ps128(a));
+		_mm_storeu_ps(dst+4,_mm256_castps256_ps128(b));
+		_mm_storeu_ps(dst+8,_mm256_castps256_ps128(c));
+		_mm_storeu_ps(dst+12,_mm256_extractf128_ps(a,1));
+		_mm_storeu_ps(dst+16,_mm256_extractf128_ps(b,1));
+		_mm_storeu_ps(dst+20,_mm256_extractf128_ps(c,1));
+	}
+	_mm256_zeroupper();
+
+	Transform_SSE(dst,src,tm,count-i,translate);
+}
+
+#undef SKIN_SWIZZLE_IN
+#undef SKIN_SWIZZLE_OUT
+
+// ----------------------------------------------------------------------------
+//
+// Deform vertices [first,last) of a job, one run of vertices per bone
+//
+// ----------------------------------------------------------------------------
+
+static void Deform_Range(const SkinJobStruct& job,int first,int last)
+{
+	typedef void (*TransformFunc)(float*,const float*,const Matrix3D&,int,bool);
+	TransformFunc transform=Transform_Scalar;
+	if (job.Kernel==SkinKernelClass::KERNEL_AVX2) transform=Transform_AVX2;
+	else if (job.Kernel==SkinKernelClass::KERNEL_SSE) transform=Transform_SSE;
+
+	const uint16* links=job.BoneLinks;
+	bool normals=(job.DstNorm!=NULL && job.SrcNorm!=NULL);
+
+	for (int vi=first;vi<last;) {
+		int bone=links[vi];
+		int end=vi+1;
+		while (end<last && links[end]==bone) ++end;
+
+		const Matrix3D& tm=job.Get_Bone(bone);
+		transform(&job.DstVert[vi].X,&job.SrcVert[vi].X,tm,end-vi,true);
+		if (normals) {
+			transform(&job.DstNorm[vi].X,&job.SrcNorm[vi].X,tm,end-vi,false);
+		}
+		vi=end;
+	}
+}
+
+static void Deform_Slice_Job(void* data,int index)
+{
+	const SkinJobStruct& job=*(const SkinJobStruct*)data;
+	int first=index*SkinKernelClass::SLICE_VERTEX_COUNT;
+	int last=first+SkinKernelClass::SLICE_VERTEX_COUNT;
+	if (last>job.VertexCount) last=job.VertexCount;
+	Deform_Range(job,first,last);
+}
+
+static void Deform_Job(SkinJobStruct& job,bool parallel)
+{
+	if (job.VertexCount<=0) return;
+
+	WWASSERT(job.DstVert!=NULL && job.SrcVert!=NULL && job.BoneLinks!=NULL);
+	WWASSERT(job.DstVert!=job.SrcVert);
+
+	if (	parallel &&
+			job.VertexCount>=SkinKernelClass::PARALLEL_VERTEX_COUNT &&
+			WorkerPoolClass::Get_Thread_Count()>0)
+	{
+		int slices=(job.VertexCount+SkinKernelClass::SLICE_VERTEX_COUNT-1)/SkinKernelClass::SLICE_VERTEX_COUNT;
+		WorkerPoolClass::Parallel_For(Deform_Slice_Job,&job,slices);
+	} else {
+		Deform_Range(job,0,job.VertexCount);
+	}
+}
+
+void SkinKernelClass::Deform(
+	Vector3* dst_vert,
+	Vector3* dst_norm,
+	const Vector3* src_vert,
+	const Vector3* src_norm,
+	const uint16* bone_links,
+	int vertex_count,
+	const HTreeClass* htree)
+{
+	WWASSERT(htree!=NULL);
+
+	SkinJobStruct job;
+	job.DstVert=dst_vert;
+	job.DstNorm=dst_norm;
+	job.SrcVert=src_vert;
+	job.SrcNorm=src_norm;
+	job.BoneLinks=bone_links;
+	job.VertexCount=vertex_count;
+	job.Tree=htree;
+	job.Bones=NULL;
+	job.Kernel=Get_Kernel();
+	Deform_Job(job,ParallelEnabled);
+}
+
+void SkinKernelClass::Deform(
+	Vector3* dst_vert,
+	Vector3* dst_norm,
+	const Vector3* src_vert,
+	const Vector3* src_norm,
+	const uint16* bone_links,
+	int vertex_count,
+	const Matrix3D* bone_transforms)
+{
+	WWASSERT(bone_transforms!=NULL);
+
+	SkinJobStruct job;
+	job.DstVert=dst_vert;
+	job.DstNorm=dst_norm;
+	job.SrcVert=src_vert;
+	job.SrcNorm=src_norm;
+	job.BoneLinks=bone_links;
+	job.VertexCount=vertex_count;
+	job.Tree=NULL;
+	job.Bones=bone_transforms;
+	job.Kernel=Get_Kernel();
+	Deform_Job(job,ParallelEnabled);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Reference version, as MeshModelClass::get_deformed_vertices() used to do it
+//
+// ----------------------------------------------------------------------------
+
+void SkinKernelClass::Deform_Reference(
+	Vector3* dst_vert,
+	Vector3* dst_norm,
+	const Vector3* src_vert,
+	const Vector3* src_norm,
+	const uint16* bone_links,
+	int vertex_count,
+	const Matrix3D* bone_transforms)
+{
+	if (dst_norm==NULL || src_norm==NULL) {
+		for (int vi=0;vi<vertex_count;vi++) {
+			const Matrix3D& tm=bone_transforms[bone_links[vi]];
+			Matrix3D::Transform_Vector(tm,src_vert[vi],&(dst_vert[vi]));
+		}
+		return;
+	}
+
+	for (int vi=0;vi<vertex_count;) {
+		Matrix3D mytm=bone_transforms[bone_links[vi]];
+
+		int idx=bone_links[vi];
+		int cnt;
+		for (cnt=vi;cnt<vertex_count;cnt++) {
+			if (idx!=bone_links[cnt]) {
+				break;
+			}
+		}
+
+		VectorProcessorClass::Transform(dst_vert+vi,src_vert+vi,mytm,cnt-vi);
+		mytm.Set_Translation(Vector3(0.0f,0.0f,0.0f));
+		VectorProcessorClass::Transform(dst_norm+vi,src_norm+vi,mytm,cnt-vi);
+		vi=cnt;
+	}
+}
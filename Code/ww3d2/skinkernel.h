@@ -0,0 +1,113 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef SKINKERNEL_H
+#define SKINKERNEL_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+#include "bittype.h"
+
+class Vector3;
+class Matrix3D;
+class HTreeClass;
+
+// ----------------------------------------------------------------------------
+//
+// Rigid (one bone per vertex) skinning of vertex positions and normals, used
+// by MeshModelClass::get_deformed_vertices().
+//
+// Vertices are deformed in runs that share a bone, which is how the exporter
+// sorts them, so each bone's matrix is set up once per run. The SSE and AVX2
+// kernels load four or eight Vector3s at a time, swizzle them into x, y and z
+// registers, transform them and swizzle them back. Both round exactly like the
+// scalar kernel, which is always available; the reference version is the
+// original per-vertex code and is kept for the tests.
+//
+// Meshes with at least PARALLEL_VERTEX_COUNT vertices are split into slices
+// that run on the WorkerPoolClass threads, when there are any. Every vertex is
+// computed the same way whichever slice it lands in.
+//
+// ----------------------------------------------------------------------------
+
+class SkinKernelClass
+{
+public:
+	enum KernelType {
+		KERNEL_SCALAR=0,
+		KERNEL_SSE,
+		KERNEL_AVX2,
+		KERNEL_BEST
+	};
+
+	enum {
+		PARALLEL_VERTEX_COUNT=4096,
+		SLICE_VERTEX_COUNT=1024
+	};
+
+	// Select the kernel. KERNEL_BEST picks the fastest one supported by the cpu,
+	// requesting a kernel that isn't supported falls back to the next best one.
+	static void Set_Kernel(KernelType kernel);
+	static KernelType Get_Kernel();
+
+	// Allow large meshes to be split across the worker threads
+	static void Enable_Parallel(bool onoff)		{ ParallelEnabled=onoff; }
+	static bool Is_Parallel_Enabled()				{ return ParallelEnabled; }
+
+	// Deform vertices and, if both normal pointers are non-NULL, normals. Normals
+	// only get the rotation part of the bone transform. The destination arrays
+	// must not overlap the sources.
+	static void Deform(
+		Vector3* dst_vert,
+		Vector3* dst_norm,
+		const Vector3* src_vert,
+		const Vector3* src_norm,
+		const uint16* bone_links,
+		int vertex_count,
+		const HTreeClass* htree);
+
+	// Same, with the bone transforms in an array indexed by bone link
+	static void Deform(
+		Vector3* dst_vert,
+		Vector3* dst_norm,
+		const Vector3* src_vert,
+		const Vector3* src_norm,
+		const uint16* bone_links,
+		int vertex_count,
+		const Matrix3D* bone_transforms);
+
+	// The original one vertex at a time code
+	static void Deform_Reference(
+		Vector3* dst_vert,
+		Vector3* dst_norm,
+		const Vector3* src_vert,
+		const Vector3* src_norm,
+		const uint16* bone_links,
+		int vertex_count,
+		const Matrix3D* bone_transforms);
+
+private:
+	static KernelType Kernel;
+	static bool ParallelEnabled;
+};
+
+#endif
@@ -26,6 +26,7 @@
 #include "D3dx8math.h"
 #include "statistics.h"
 #include <wwprofile.h>
+#include "framearena.h"
 
 bool SortingRendererClass::_EnableTriangleDraw=true;
 
@@ -209,86 +210,6 @@ static SortingNodeStruct* Get_Sorting_Struct()
 	return state;
 }
 
-// ----------------------------------------------------------------------------
-//
-// Temporary arrays for the sorting system
-//
-// ----------------------------------------------------------------------------
-
-static float* vertex_z_array;
-static float* polygon_z_array;
-static unsigned * node_id_array;
-static unsigned * sorted_node_id_array;
-static ShortVectorIStruct* polygon_index_array;
-static unsigned vertex_z_array_count;
-static unsigned polygon_z_array_count;
-static unsigned node_id_array_count;
-static unsigned sorted_node_id_array_count;
-static unsigned polygon_index_array_count;
-TempIndexStruct* temp_index_array;
-unsigned temp_index_array_count;
-
-static TempIndexStruct* Get_Temp_Index_Array(unsigned count)
-{
-	if (count>temp_index_array_count) {
-		delete[] temp_index_array;
-		temp_index_array=new TempIndexStruct[count];
-		temp_index_array_count=count;
-	}
-	return temp_index_array;
-}
-
-static float* Get_Vertex_Z_Array(unsigned count)
-{
-	if (count>vertex_z_array_count) {
-		delete[] vertex_z_array;
-		vertex_z_array=new float[count];
-		vertex_z_array_count=count;
-	}
-	return vertex_z_array;
-}
-
-static float* Get_Polygon_Z_Array(unsigned count)
-{
-	if (count>polygon_z_array_count) {
-		delete[] polygon_z_array;
-		polygon_z_array=new float[count];
-		polygon_z_array_count=count;
-	}
-	return polygon_z_array;
-}
-
-static unsigned * Get_Node_Id_Array(unsigned count)
-{
-	if (count>node_id_array_count) {
-		delete[] node_id_array;
-		node_id_array=new unsigned[count];
-		node_id_array_count=count;
-	}
-	return node_id_array;
-}
-
-static unsigned * Get_Sorted_Node_Id_Array(unsigned count)
-{
-	if (count>sorted_node_id_array_count) {
-		delete[] sorted_node_id_array;
-		sorted_node_id_array=new unsigned[count];
-		sorted_node_id_array_count=count;
-	}
-	return sorted_node_id_array;
-}
-
-static ShortVectorIStruct* Get_Polygon_Index_Array(unsigned count)
-{
-	if (count>polygon_index_array_count) {
-		delete[] polygon_index_array;
-		polygon_index_array=new ShortVectorIStruct[count];
-		polygon_index_array_count=count;
-	}
-	return polygon_index_array;
-}
-
-
 // ----------------------------------------------------------------------------
 //
 // Insert triangles to the sorting system.
@@ -492,10 +413,21 @@ void SortingRendererClass::Flush_Sorting_Pool()
 	SNAPSHOT_SAY(("SortingSystem - Flush \n"));
 
 	unsigned node_id;
+
+	// The temporary sorting arrays come from the frame arena and are released when we return
+	FrameArenaScopeClass arena_scope;
+	FrameArenaClass* arena=arena_scope.Get_Arena();
+
+	unsigned max_vertex_count=0;
+	for (node_id=0;node_id<overlapping_node_count;++node_id) {
+		max_vertex_count=MAX(max_vertex_count,(unsigned)overlapping_nodes[node_id]->vertex_count);
+	}
+	float* vertex_z_array=arena->Allocate_Array<float>(max_vertex_count);
+
 	// Fill dynamic index buffer with sorting index buffer vertices
-	unsigned * node_id_array=Get_Node_Id_Array(overlapping_polygon_count);
-	float* polygon_z_array=Get_Polygon_Z_Array(overlapping_polygon_count);
-	ShortVectorIStruct* polygon_idx_array=(ShortVectorIStruct*)Get_Polygon_Index_Array(overlapping_polygon_count);
+	unsigned * node_id_array=arena->Allocate_Array<unsigned>(overlapping_polygon_count);
+	float* polygon_z_array=arena->Allocate_Array<float>(overlapping_polygon_count);
+	ShortVectorIStruct* polygon_idx_array=arena->Allocate_Array<ShortVectorIStruct>(overlapping_polygon_count);
 
 	DynamicVBAccessClass dyn_vb_access(BUFFER_TYPE_DYNAMIC_DX8,dynamic_fvf_type,overlapping_vertex_count);
 	{
@@ -506,7 +438,6 @@ void SortingRendererClass::Flush_Sorting_Pool()
 		unsigned vertex_array_offset=0;
 		for (node_id=0;node_id<overlapping_node_count;++node_id) {
 			SortingNodeStruct* state=overlapping_nodes[node_id];
-			float* vertex_z_array=Get_Vertex_Z_Array(state->vertex_count);
 
 			VertexFormatXYZNDUV2* src_verts=NULL;
 			SortingVertexBufferClass* vertex_buffer=static_cast<SortingVertexBufferClass*>(state->sorting_state.vertex_buffer);
@@ -568,7 +499,7 @@ void SortingRendererClass::Flush_Sorting_Pool()
 		}
 	}
 
-	TempIndexStruct* tis=Get_Temp_Index_Array(overlapping_polygon_count);
+	TempIndexStruct* tis=arena->Allocate_Array<TempIndexStruct>(overlapping_polygon_count);
 	for (unsigned a=0;a<overlapping_polygon_count;++a) {
 		tis[a]=TempIndexStruct(polygon_idx_array[a],node_id_array[a]);
 	}
@@ -705,23 +636,5 @@ void SortingRendererClass::Deinit()
 		delete head;
 	}
 
-	delete[] vertex_z_array;
-	vertex_z_array=NULL;
-	vertex_z_array_count=0;
-	delete[] polygon_z_array;
-	polygon_z_array=NULL;
-	polygon_z_array_count=0;
-	delete[] node_id_array;
-	node_id_array=NULL;
-	node_id_array_count=0;
-	delete[] sorted_node_id_array;
-	sorted_node_id_array=NULL;
-	sorted_node_id_array_count=0;
-	delete[] polygon_index_array;
-	polygon_index_array=NULL;
-	polygon_index_array_count=0;
-	delete[] temp_index_array;
-	temp_index_array=NULL;
-	temp_index_array_count=0;
 }
 
@@ -39,6 +39,7 @@
 #include "texturethumbnail.h"
 #include "ddsfile.h"
 #include "bitmaphandler.h"
+#include "dxtcodec.h"
 
 bool TextureLoader::TextureLoadSuspended;
 
@@ -1381,6 +1382,19 @@ bool TextureLoadTaskClass::Begin_Uncompressed_Load(void)
 		Format = Get_Valid_Texture_Format(Format, false);
 	}
 
+	// Optionally compress the texture while loading so it stays compressed in memory. The blocks
+	// are encoded by DXTCodecClass in Load_Uncompressed_Mipmap().
+	if (	WW3D::Get_Texture_Compression_On_Load() 
+		&&	Texture->Is_Compression_Allowed() 
+		&&	Width >= 4 
+		&&	Height >= 4) {
+		WW3DFormat compressed_format = Has_Alpha(Format) ? WW3D_FORMAT_DXT5 : WW3D_FORMAT_DXT1;
+		compressed_format = Get_Valid_Texture_Format(compressed_format, true);
+		if (DXTCodecClass::Is_DXT_Format(compressed_format)) {
+			Format = compressed_format;
+		}
+	}
+
 	D3DTexture = DX8Wrapper::_Create_DX8_Texture(
 		Width, 
 		Height, 
@@ -1508,7 +1522,8 @@ bool TextureLoadTaskClass::Load_Uncompressed_Mipmap(void)
 		||	src_format	== WW3D_FORMAT_P8 
 		|| src_format	== WW3D_FORMAT_L8 
 		|| src_width	!= width 
-		|| src_height	!= height) {
+		|| src_height	!= height
+		|| DXTCodecClass::Is_DXT_Format(Get_Format())) {	// The encoder needs 32 bit source for the mip levels
 
 		converted_surface = new unsigned char[width*height*4];
 		dest_format = Get_Valid_Texture_Format(WW3D_FORMAT_A8R8G8B8, false);
@@ -206,6 +206,7 @@ bool														WW3D::ExposePrelit = false;
 
 bool														WW3D::SnapshotActivated=false;
 bool														WW3D::ThumbnailEnabled=true;
+bool														WW3D::TextureCompressionOnLoad=false;
 
 WW3D::MeshDrawModeEnum								WW3D::MeshDrawMode = MESH_DRAW_MODE_OLD;
 WW3D::NPatchesGapFillingModeEnum					WW3D::NPatchesGapFillingMode = NPATCHES_GAP_FILLING_ENABLED;
@@ -208,6 +208,13 @@ public:
 	static void					Set_Thumbnail_Enabled(bool b) { ThumbnailEnabled=b; }
 	static bool					Get_Thumbnail_Enabled() { return ThumbnailEnabled; }
 
+	/*
+	** Texture compression on load - uncompressed (targa) textures that allow compression
+	** are encoded to DXT1/DXT5 while loading if the hardware supports it.
+	*/
+	static void					Set_Texture_Compression_On_Load(bool b) { TextureCompressionOnLoad=b; }
+	static bool					Get_Texture_Compression_On_Load() { return TextureCompressionOnLoad; }
+
 	static void					Enable_Sorting(bool onoff);
 	static bool					Is_Sorting_Enabled(void)					{ return IsSortingEnabled; }
 
@@ -345,6 +352,7 @@ private:
 
 	static bool							SnapshotActivated;
 	static bool							ThumbnailEnabled;
+	static bool							TextureCompressionOnLoad;
 
 	static MeshDrawModeEnum			MeshDrawMode;
 	static NPatchesGapFillingModeEnum NPatchesGapFillingMode;
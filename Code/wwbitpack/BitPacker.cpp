@@ -197,6 +197,18 @@ void cBitPacker::Set_Bit_Write_Position(UINT position)
 	BitWritePosition = position;
 }
 
+//-----------------------------------------------------------------------------
+//
+// Also only for use by a packet class when data is received, to read a header
+// and then rewind to the start of the payload once it has been moved down.
+//
+
+void cBitPacker::Set_Bit_Read_Position(UINT position)
+{
+	WWASSERT(position <= BitWritePosition);
+	BitReadPosition = position;
+}
+
 
 
 
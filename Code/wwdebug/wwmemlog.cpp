@@ -43,7 +43,16 @@
 #include "wwdebug.h"
 #include "vector.h"
 #include "fastallocator.h"
+#include "wwprofile.h"
 #include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+** Symbol lookup for the allocation site dump lives in wwlib (except.cpp)
+*/
+void Load_Image_Helper(void);
+bool Lookup_Symbol(void *code_ptr, char *symbol, int &displacement);
 
 #define USE_FAST_ALLOCATOR
 
@@ -116,17 +125,83 @@ static const char * _MemoryCategoryNames[] =
 class MemoryCounterClass
 {
 public:
-	MemoryCounterClass(void) : CurrentAllocation(0), PeakAllocation(0) { }
+	MemoryCounterClass(void) : CurrentAllocation(0), PeakAllocation(0) { Reset_Frame_Counters(); }
 
-	void		Memory_Allocated(int size)						{ CurrentAllocation+=size; PeakAllocation = max(PeakAllocation,CurrentAllocation); }
+	void		Memory_Allocated(int size)						{ CurrentAllocation+=size; PeakAllocation = max(PeakAllocation,CurrentAllocation); FrameCount++; FrameSize+=size; }
 	void		Memory_Released(int size)						{ CurrentAllocation-=size; }
 
 	int		Get_Current_Allocated_Memory(void)			{ return CurrentAllocation; }
 	int		Get_Peak_Allocated_Memory(void)				{ return PeakAllocation; }
 
+	/*
+	** Allocation rate tracking.  FrameCount/FrameSize accumulate during the current frame and
+	** are latched into the "last frame" values by Frame_Finished.
+	*/
+	void		Frame_Finished(void);
+	void		Reset_Frame_Counters(void);
+
+	int		Get_Last_Frame_Count(void)						{ return LastFrameCount; }
+	int		Get_Last_Frame_Size(void)						{ return LastFrameSize; }
+	int		Get_Peak_Frame_Count(void)						{ return PeakFrameCount; }
+	__int64	Get_Total_Frame_Count(void)					{ return TotalFrameCount; }
+	__int64	Get_Total_Frame_Size(void)						{ return TotalFrameSize; }
+
 protected:
 	int		CurrentAllocation;
 	int		PeakAllocation;
+
+	int		FrameCount;
+	int		FrameSize;
+	int		LastFrameCount;
+	int		LastFrameSize;
+	int		PeakFrameCount;
+	__int64	TotalFrameCount;
+	__int64	TotalFrameSize;
+};
+
+void MemoryCounterClass::Frame_Finished(void)
+{
+	LastFrameCount = FrameCount;
+	LastFrameSize = FrameSize;
+	PeakFrameCount = max(PeakFrameCount,FrameCount);
+	TotalFrameCount += FrameCount;
+	TotalFrameSize += FrameSize;
+	FrameCount = 0;
+	FrameSize = 0;
+}
+
+void MemoryCounterClass::Reset_Frame_Counters(void)
+{
+	FrameCount = 0;
+	FrameSize = 0;
+	LastFrameCount = 0;
+	LastFrameSize = 0;
+	PeakFrameCount = 0;
+	TotalFrameCount = 0;
+	TotalFrameSize = 0;
+}
+
+
+
+/**
+** AllocationSiteStruct
+** One entry in the allocation sampler's site table.  A site is identified by the hash of its
+** call stack and the WWPROFILE scope that was active on the main thread.  Samples/Bytes only
+** count the sampled allocations; multiply by the sample rate to estimate the real numbers.
+*/
+const int MAX_ALLOCATION_SITES = 4096;					// must be a power of two
+const int MAX_ALLOCATION_SITE_PROBES = 32;
+const int MAX_ALLOCATION_SITE_FRAMES = 12;
+
+struct AllocationSiteStruct
+{
+	unsigned			Hash;
+	const char *	Scope;
+	int				Category;
+	int				FrameCount;
+	void *			Frames[MAX_ALLOCATION_SITE_FRAMES];
+	unsigned			Samples;
+	unsigned			Bytes;
 };
 
 
@@ -219,11 +294,33 @@ public:
 
 	void				Init();
 
+	/*
+	** Allocation rate tracking and sampling
+	*/
+	MemLogClass(void) : _FramesSinceReset(0), _SampleRate(0), _SampleCountdown(0), _Sites(NULL), _DroppedSamples(0) { }
+	~MemLogClass(void);
+
+	void				Frame_Finished(void);
+	int				Get_Frame_Allocation_Count(int category);
+	int				Get_Frame_Allocated_Memory(int category);
+
+	void				Set_Sample_Rate(int rate);
+	int				Get_Sample_Rate(void)							{ return _SampleRate; }
+	bool				Should_Sample(void)								{ return (_SampleRate > 0) && (::InterlockedDecrement(&_SampleCountdown) == 0); }
+	void				Record_Sample(int category,int size,void ** frames,int frame_count,unsigned hash,const char * scope);
+	void				Reset_Samples(void);
+	void				Dump_Allocation_Sites(int max_sites,void (*print)(const char *));
+
 private:
 
 	MemoryCounterClass		_MemoryCounters[MEM_COUNT];
 	ActiveCategoryClass		_ActiveCategoryTracker;
 
+	int							_FramesSinceReset;
+	int							_SampleRate;
+	volatile long				_SampleCountdown;		// every allocating thread counts down, the one reaching zero samples
+	AllocationSiteStruct *	_Sites;
+	unsigned						_DroppedSamples;
 };
 
 
@@ -456,6 +553,266 @@ void MemLogClass::Pop_Active_Category(void)
 	_ActiveCategoryTracker.Pop();
 }
 
+MemLogClass::~MemLogClass(void)
+{
+	if (_Sites != NULL) {
+		FREE_MEMORY(_Sites);
+		_Sites = NULL;
+	}
+}
+
+void MemLogClass::Frame_Finished(void)
+{
+	int total_count = 0;
+	int total_size = 0;
+	{
+		MemLogMutexLockClass lock;
+		for (int i=0; i<MEM_COUNT; i++) {
+			_MemoryCounters[i].Frame_Finished();
+			total_count += _MemoryCounters[i].Get_Last_Frame_Count();
+			total_size += _MemoryCounters[i].Get_Last_Frame_Size();
+		}
+		_FramesSinceReset++;
+	}
+
+	WWPROFILE_COUNTER("Allocations",total_count);
+	WWPROFILE_COUNTER("Allocated Bytes",total_size);
+}
+
+int MemLogClass::Get_Frame_Allocation_Count(int category)
+{
+	MemLogMutexLockClass lock;
+	return _MemoryCounters[category].Get_Last_Frame_Count();
+}
+
+int MemLogClass::Get_Frame_Allocated_Memory(int category)
+{
+	MemLogMutexLockClass lock;
+	return _MemoryCounters[category].Get_Last_Frame_Size();
+}
+
+void MemLogClass::Set_Sample_Rate(int rate)
+{
+	MemLogMutexLockClass lock;
+
+	/*
+	** The site table is allocated straight from the underlying allocator so that it
+	** doesn't show up in the log itself.
+	*/
+	if ((rate > 0) && (_Sites == NULL)) {
+		_Sites = (AllocationSiteStruct *)ALLOC_MEMORY(sizeof(AllocationSiteStruct) * MAX_ALLOCATION_SITES);
+		if (_Sites == NULL) {
+			rate = 0;
+		} else {
+			memset(_Sites,0,sizeof(AllocationSiteStruct) * MAX_ALLOCATION_SITES);
+		}
+	}
+	_SampleRate = max(rate,0);
+	::InterlockedExchange(&_SampleCountdown,_SampleRate);
+}
+
+void MemLogClass::Record_Sample(int category,int size,void ** frames,int frame_count,unsigned hash,const char * scope)
+{
+	::InterlockedExchange(&_SampleCountdown,_SampleRate);
+	MemLogMutexLockClass lock;
+	if (_Sites == NULL) {
+		return;
+	}
+
+	unsigned index = hash ^ ((unsigned)scope >> 4);
+	for (int probe=0; probe<MAX_ALLOCATION_SITE_PROBES; probe++) {
+		AllocationSiteStruct & site = _Sites[(index + probe) & (MAX_ALLOCATION_SITES - 1)];
+
+		if (site.Samples == 0) {
+			site.Hash = hash;
+			site.Scope = scope;
+			site.Category = category;
+			site.FrameCount = frame_count;
+			memcpy(site.Frames,frames,sizeof(void*) * frame_count);
+		}
+
+		if ((site.Hash == hash) && (site.Scope == scope) && (site.Category == category) && (site.FrameCount == frame_count)) {
+			site.Samples++;
+			site.Bytes += size;
+			return;
+		}
+	}
+	_DroppedSamples++;
+}
+
+void MemLogClass::Reset_Samples(void)
+{
+	MemLogMutexLockClass lock;
+	if (_Sites != NULL) {
+		memset(_Sites,0,sizeof(AllocationSiteStruct) * MAX_ALLOCATION_SITES);
+	}
+	for (int i=0; i<MEM_COUNT; i++) {
+		_MemoryCounters[i].Reset_Frame_Counters();
+	}
+	_FramesSinceReset = 0;
+	_DroppedSamples = 0;
+}
+
+static int __cdecl _Site_Compare(const void * a,const void * b)
+{
+	unsigned samples_a = ((const AllocationSiteStruct *)a)->Samples;
+	unsigned samples_b = ((const AllocationSiteStruct *)b)->Samples;
+	if (samples_a != samples_b) {
+		return (samples_a < samples_b) ? 1 : -1;
+	}
+	return 0;
+}
+
+struct AllocationScopeStruct
+{
+	const char *	Scope;
+	unsigned			Samples;
+	unsigned			Bytes;
+};
+
+static int __cdecl _Scope_Compare(const void * a,const void * b)
+{
+	unsigned samples_a = ((const AllocationScopeStruct *)a)->Samples;
+	unsigned samples_b = ((const AllocationScopeStruct *)b)->Samples;
+	if (samples_a != samples_b) {
+		return (samples_a < samples_b) ? 1 : -1;
+	}
+	return 0;
+}
+
+static void _Print_Line(void (*print)(const char *),const char * text)
+{
+	if (print != NULL) {
+		print(text);
+	} else {
+		WWRELEASE_SAY(("%s",text));
+	}
+}
+
+void MemLogClass::Dump_Allocation_Sites(int max_sites,void (*print)(const char *))
+{
+	const int MAX_SCOPES = 64;
+
+	MemoryCounterClass counters[MEM_COUNT];
+	AllocationScopeStruct scopes[MAX_SCOPES];
+	AllocationSiteStruct * sites = NULL;
+	int site_count = 0;
+	int scope_count = 0;
+	int frames;
+	int rate;
+	unsigned dropped;
+	char line[512];
+	int i;
+
+	/*
+	** Copy everything we need out of the log so that printing (which may allocate) happens
+	** outside of the lock.
+	*/
+	{
+		MemLogMutexLockClass lock;
+		memcpy(counters,_MemoryCounters,sizeof(counters));
+		frames = max(_FramesSinceReset,1);
+		rate = _SampleRate;
+		dropped = _DroppedSamples;
+
+		if (_Sites != NULL) {
+			sites = (AllocationSiteStruct *)ALLOC_MEMORY(sizeof(AllocationSiteStruct) * MAX_ALLOCATION_SITES);
+			if (sites != NULL) {
+				for (i=0; i<MAX_ALLOCATION_SITES; i++) {
+					if (_Sites[i].Samples != 0) {
+						sites[site_count++] = _Sites[i];
+					}
+				}
+			}
+		}
+	}
+
+	sprintf(line,"Allocations over %d frames:\n",frames);
+	_Print_Line(print,line);
+	_Print_Line(print,"  Category             allocs/frame   bytes/frame  peak allocs/frame\n");
+	for (i=0; i<MEM_COUNT; i++) {
+		if (counters[i].Get_Total_Frame_Count() == 0) {
+			continue;
+		}
+		sprintf(line,"  %-18s %14.1f %13.0f %18d\n",
+			_MemoryCategoryNames[i],
+			(double)counters[i].Get_Total_Frame_Count() / frames,
+			(double)counters[i].Get_Total_Frame_Size() / frames,
+			counters[i].Get_Peak_Frame_Count());
+		_Print_Line(print,line);
+	}
+
+	if (rate == 0 || site_count == 0) {
+		_Print_Line(print,"Allocation sampling is off (or nothing was sampled).\n");
+		if (sites != NULL) {
+			FREE_MEMORY(sites);
+		}
+		return;
+	}
+
+	/*
+	** Collapse the sites by WWPROFILE scope
+	*/
+	for (i=0; i<site_count; i++) {
+		int s;
+		for (s=0; s<scope_count; s++) {
+			if (scopes[s].Scope == sites[i].Scope) break;
+		}
+		if (s == scope_count) {
+			if (scope_count == MAX_SCOPES) continue;
+			scopes[s].Scope = sites[i].Scope;
+			scopes[s].Samples = 0;
+			scopes[s].Bytes = 0;
+			scope_count++;
+		}
+		scopes[s].Samples += sites[i].Samples;
+		scopes[s].Bytes += sites[i].Bytes;
+	}
+	qsort(scopes,scope_count,sizeof(AllocationScopeStruct),_Scope_Compare);
+
+	sprintf(line,"Sampled 1 in %d allocations, %d sites, %d samples dropped.  Estimated rates by profile scope:\n",rate,site_count,dropped);
+	_Print_Line(print,line);
+	for (i=0; i<scope_count; i++) {
+		sprintf(line,"  %-32.64s %10.1f allocs/frame %12.0f bytes/frame\n",
+			scopes[i].Scope ? scopes[i].Scope : "<other thread>",
+			(double)scopes[i].Samples * rate / frames,
+			(double)scopes[i].Bytes * rate / frames);
+		_Print_Line(print,line);
+	}
+
+	/*
+	** Top allocation sites with their call stacks
+	*/
+	qsort(sites,site_count,sizeof(AllocationSiteStruct),_Site_Compare);
+	if (max_sites <= 0 || max_sites > site_count) {
+		max_sites = site_count;
+	}
+
+	Load_Image_Helper();
+	for (i=0; i<max_sites; i++) {
+		AllocationSiteStruct & site = sites[i];
+		sprintf(line,"#%d: %.1f allocs/frame, %.0f bytes/frame, category %s, scope %.64s\n",
+			i+1,
+			(double)site.Samples * rate / frames,
+			(double)site.Bytes * rate / frames,
+			_MemoryCategoryNames[site.Category],
+			site.Scope ? site.Scope : "<other thread>");
+		_Print_Line(print,line);
+
+		for (int f=0; f<site.FrameCount; f++) {
+			char symbol[1024];
+			int displacement = 0;
+			if (!Lookup_Symbol(site.Frames[f],symbol,displacement)) {
+				strcpy(symbol,"?");
+			}
+			sprintf(line,"    %08X %.256s + %d\n",(unsigned)site.Frames[f],symbol,displacement);
+			_Print_Line(print,line);
+		}
+	}
+
+	FREE_MEMORY(sites);
+}
+
 
 
 /***************************************************************************************************
@@ -649,6 +1006,19 @@ void * WWMemoryLogClass::Allocate_Memory(size_t size)
 			** Record this allocation
 			*/
 			int active_category = WWMemoryLogClass::Register_Memory_Allocated(size);
+			AllocateCount++;
+
+			/*
+			** Every Nth allocation records its call stack.  Skip this function and the
+			** application's operator new.
+			*/
+			MemLogClass * log = Get_Log();
+			if (log->Should_Sample()) {
+				void * frames[MAX_ALLOCATION_SITE_FRAMES];
+				unsigned long hash = 0;
+				int frame_count = RtlCaptureStackBackTrace(2,MAX_ALLOCATION_SITE_FRAMES,frames,&hash);
+				log->Record_Sample(active_category,size,frames,frame_count,hash,WWProfileManager::Get_Current_Scope_Name());
+			}
 
 			/*
 			** Write our logging structure into the beginning of the buffer.  I'm using
@@ -709,6 +1079,7 @@ void WWMemoryLogClass::Release_Memory(void *ptr)
 			*/
 			WWMemoryLogClass::Register_Memory_Released(memlog->Category,memlog->Size);
 			FREE_MEMORY((void*)memlog);
+			FreeCount++;
 
 		} else {
 
@@ -746,3 +1117,50 @@ void WWMemoryLogClass::Init()
 {
 	Get_Log()->Init();
 }
+
+
+/***************************************************************************************************
+**
+** Allocation rate tracking and sampling
+**
+** Frame_Finished should be called once per frame (TimeManager::Update does this).  The sampler
+** adds no cost to unsampled allocations beyond a countdown, so it can be left running on a
+** server while looking for subsystems that allocate inside the frame loop.
+**
+***************************************************************************************************/
+void WWMemoryLogClass::Frame_Finished(void)
+{
+#if (DISABLE_MEMLOG == 0)
+	Get_Log()->Frame_Finished();
+#endif
+}
+
+int WWMemoryLogClass::Get_Frame_Allocation_Count(int category)
+{
+	return Get_Log()->Get_Frame_Allocation_Count(category);
+}
+
+int WWMemoryLogClass::Get_Frame_Allocated_Memory(int category)
+{
+	return Get_Log()->Get_Frame_Allocated_Memory(category);
+}
+
+void WWMemoryLogClass::Set_Sample_Rate(int rate)
+{
+	Get_Log()->Set_Sample_Rate(rate);
+}
+
+int WWMemoryLogClass::Get_Sample_Rate(void)
+{
+	return Get_Log()->Get_Sample_Rate();
+}
+
+void WWMemoryLogClass::Reset_Samples(void)
+{
+	Get_Log()->Reset_Samples();
+}
+
+void WWMemoryLogClass::Dump_Allocation_Sites(int max_sites,void (*print)(const char *))
+{
+	Get_Log()->Dump_Allocation_Sites(max_sites,print);
+}
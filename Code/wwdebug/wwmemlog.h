@@ -124,6 +124,22 @@ public:
 	static int				Get_Free_Count();			// Return allocate count since last reset
 
 	static void				Init();
+
+	/*
+	** Per-frame allocation tracking.  Every allocation is counted against its category for the
+	** current frame; call Frame_Finished once per frame to latch the totals.  In addition, one
+	** of every 'rate' allocations records its call stack, category and the active WWPROFILE
+	** scope so that the worst allocation sites can be dumped.  A rate of 0 disables sampling.
+	*/
+	static void				Frame_Finished(void);
+	static int				Get_Frame_Allocation_Count(int category);	// allocations in the last finished frame
+	static int				Get_Frame_Allocated_Memory(int category);	// bytes allocated in the last finished frame
+
+	static void				Set_Sample_Rate(int rate);
+	static int				Get_Sample_Rate(void);
+	static void				Reset_Samples(void);
+	static void				Dump_Allocation_Sites(int max_sites,void (*print)(const char *) = NULL);
+
 protected:
 
 	/*
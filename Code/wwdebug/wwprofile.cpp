@@ -40,6 +40,7 @@
  *   WWProfileHierachyNodeClass::Return -- Stop timing, record results                         *
  *   WWProfileManager::Start_Profile -- Begin a named profile                                  *
  *   WWProfileManager::Stop_Profile -- Stop timing and record the results.                     *
+ *   WWProfileManager::Get_Current_Scope_Name -- Name of the innermost open WWPROFILE scope    *
  *   WWProfileManager::Reset -- Reset the contents of the profiling system                     *
  *   WWProfileManager::Increment_Frame_Counter -- Increment the frame counter                  *
  *   WWProfileManager::Get_Time_Since_Reset -- returns the elapsed time since last reset       *
@@ -47,6 +48,14 @@
  *   WWProfileManager::Release_Iterator -- Return an iterator for the profile tree             *
  *   WWProfileManager::Get_In_Order_Iterator -- Creates an "in-order" iterator for the profile *
  *   WWProfileManager::Release_In_Order_Iterator -- Return an "in-order" iterator              *
+ *   WWProfileManager::Record_Trace_Event -- Append an event to the calling thread's trace ring  *
+ *   WWProfileManager::Begin_Trace -- Start recording trace events on all threads              *
+ *   WWProfileManager::End_Trace -- Stop recording and optionally write the trace out          *
+ *   WWProfileManager::Release_Thread_Trace_Buffer -- Recycle the thread's trace buffer        *
+ *   WWProfileManager::Set_Thread_Name -- Name the calling thread in trace output              *
+ *   WWProfileManager::Record_Counter -- Record a counter value on the trace timeline          *
+ *   WWProfileManager::Flush_Trace_Buffers -- Drain every thread's ring into its event list    *
+ *   WWProfileManager::Write_Chrome_Trace -- Write the collected events as Chrome trace JSON   *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
@@ -60,6 +69,9 @@
 #include "ffactory.h"
 #include "simplevec.h"
 #include "cpudetect.h"
+#include "mutex.h"
+#include <stdio.h>
+#include <string.h>
 
 static SimpleDynVecClass<WWProfileHierachyNodeClass*> ProfileCollectVector;
 static double TotalFrameTimes;
@@ -315,6 +327,617 @@ int									WWProfileManager::FrameCounter = 0;
 __int64								WWProfileManager::ResetTime = 0;
 
 static unsigned int				ThreadID = static_cast<unsigned int>(-1);
+volatile bool						WWProfileManager::TraceEnabled = false;
+
+
+/***************************************************************************************************
+**
+** Trace recording
+**
+** Every thread that enters a profile scope while a trace is running gets its own ring of events.
+** The owning thread is the only writer of Head and Flush_Trace_Buffers is the only writer of
+** Tail, so recording an event never takes a lock.  The rings are drained into per-thread event
+** lists once per frame; events that don't fit in a ring are counted and dropped.
+**
+** When a thread exits its buffer is marked as exited.  It stays in the list until its events
+** have been written or discarded, and is then moved to a free list and reused by the next
+** thread that needs one, so thread churn doesn't grow the number of buffers.
+**
+***************************************************************************************************/
+enum {
+	TRACE_EVENT_BEGIN = 0,
+	TRACE_EVENT_END,
+	TRACE_EVENT_COUNTER,
+	TRACE_EVENT_FRAME,
+
+	TRACE_RING_SIZE				= 16384,				// must be a power of two
+	TRACE_RING_MASK				= TRACE_RING_SIZE - 1,
+	TRACE_RING_END_RESERVE		= 64,					// slots only END events may use, so open scopes can close
+	TRACE_MAX_THREAD_EVENTS		= 1024 * 1024,		// drained events kept per thread before the trace stops
+	TRACE_MAX_TRACKED_DEPTH		= 64,
+};
+
+struct WWProfileTraceEventStruct
+{
+	__int64							Ticks;
+	const char *					Name;
+	int								Value;
+	int								Type;
+};
+
+class WWProfileThreadBufferClass
+{
+public:
+	WWProfileThreadBufferClass( unsigned thread_id ) :
+		ThreadID( thread_id ),
+		Head( 0 ),
+		Tail( 0 ),
+		Dropped( 0 ),
+		Session( 0 ),
+		Depth( 0 ),
+		SkipMask( 0 ),
+		Exited( false ),
+		Next( NULL )
+	{
+		Name[0] = 0;
+	}
+
+	void Reset( unsigned thread_id )
+	{
+		ThreadID = thread_id;
+		Name[0] = 0;
+		Head = 0;
+		Tail = 0;
+		Dropped = 0;
+		Session = 0;
+		Depth = 0;
+		SkipMask = 0;
+		Exited = false;
+		Events.Delete_All();
+	}
+
+	unsigned								ThreadID;
+	char									Name[64];
+
+	volatile unsigned					Head;				// written by the owning thread only
+	volatile unsigned					Tail;				// written by Flush_Trace_Buffers only
+	unsigned								Dropped;
+
+	// Scope tracking of the owning thread, used to keep BEGIN/END pairs balanced when an
+	// event is dropped or a scope straddles the start of a trace.
+	unsigned								Session;
+	unsigned								Depth;
+	unsigned __int64					SkipMask;
+
+	WWProfileTraceEventStruct		Ring[TRACE_RING_SIZE];
+	SimpleDynVecClass<WWProfileTraceEventStruct>	Events;
+
+	bool									Exited;			// owning thread has exited, set under TraceLock
+	WWProfileThreadBufferClass *	Next;
+};
+
+__declspec( thread ) static WWProfileThreadBufferClass *	ThreadTraceBuffer = NULL;
+__declspec( thread ) static const char *						ThreadTraceName = NULL;
+
+static WWProfileThreadBufferClass *		TraceBufferList = NULL;
+static WWProfileThreadBufferClass *		FreeTraceBufferList = NULL;
+static FastCriticalSectionClass			TraceLock;
+static volatile unsigned					TraceSession = 0;
+static __int64									TraceStartTime = 0;
+static int										TraceFrameCounter = 0;
+
+
+static WWProfileThreadBufferClass * Create_Thread_Trace_Buffer( void )
+{
+	FastCriticalSectionClass::LockClass lock( TraceLock );
+
+	WWProfileThreadBufferClass * buffer = FreeTraceBufferList;
+	if (buffer != NULL) {
+		FreeTraceBufferList = buffer->Next;
+		buffer->Reset( ::GetCurrentThreadId() );
+	} else {
+		buffer = new WWProfileThreadBufferClass( ::GetCurrentThreadId() );
+	}
+
+	if (ThreadTraceName != NULL) {
+		strncpy( buffer->Name, ThreadTraceName, sizeof( buffer->Name ) - 1 );
+		buffer->Name[sizeof( buffer->Name ) - 1] = 0;
+	}
+
+	buffer->Next = TraceBufferList;
+	TraceBufferList = buffer;
+	return buffer;
+}
+
+
+/*
+** Move the buffers of exited threads that have nothing left to write to the free list.
+** TraceLock must be held.
+*/
+static void Recycle_Exited_Trace_Buffers( void )
+{
+	WWProfileThreadBufferClass ** link = &TraceBufferList;
+	while (*link != NULL) {
+		WWProfileThreadBufferClass * buffer = *link;
+		if (buffer->Exited && buffer->Head == buffer->Tail && buffer->Events.Count() == 0) {
+			*link = buffer->Next;
+			buffer->Events.Delete_All();
+			buffer->Next = FreeTraceBufferList;
+			FreeTraceBufferList = buffer;
+		} else {
+			link = &buffer->Next;
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * WWProfileManager::Record_Trace_Event -- Append an event to the calling thread's trace ring  *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * type - TRACE_EVENT_xxx                                                                      *
+ * name - static string naming the event                                                       *
+ * value - counter value or frame number                                                       *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Only called while TraceEnabled is set.  Lock free except for the first event of a thread.   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWProfileManager::Record_Trace_Event( int type, const char * name, int value )
+{
+	WWProfileThreadBufferClass * buffer = ThreadTraceBuffer;
+	if (buffer == NULL) {
+		buffer = ThreadTraceBuffer = Create_Thread_Trace_Buffer();
+	}
+
+	if (buffer->Session != TraceSession) {
+		buffer->Session = TraceSession;
+		buffer->Depth = 0;
+		buffer->SkipMask = 0;
+	}
+
+	unsigned head = buffer->Head;
+	unsigned used = head - buffer->Tail;
+
+	if (type == TRACE_EVENT_END) {
+
+		// An END whose BEGIN was never recorded (dropped, or opened before the trace started)
+		// is discarded along with it.
+		if (buffer->Depth == 0) {
+			return;
+		}
+		buffer->Depth--;
+		if (buffer->Depth < TRACE_MAX_TRACKED_DEPTH && (buffer->SkipMask & ((unsigned __int64)1 << buffer->Depth))) {
+			return;
+		}
+		if (used >= TRACE_RING_SIZE) {
+			buffer->Dropped++;
+			return;
+		}
+
+	} else {
+
+		bool full = (used >= TRACE_RING_SIZE - TRACE_RING_END_RESERVE);
+		if (type == TRACE_EVENT_BEGIN) {
+			if (buffer->Depth < TRACE_MAX_TRACKED_DEPTH) {
+				unsigned __int64 bit = (unsigned __int64)1 << buffer->Depth;
+				if (full) {
+					buffer->SkipMask |= bit;
+				} else {
+					buffer->SkipMask &= ~bit;
+				}
+			}
+			buffer->Depth++;
+		}
+		if (full) {
+			buffer->Dropped++;
+			return;
+		}
+	}
+
+	WWProfileTraceEventStruct & event = buffer->Ring[head & TRACE_RING_MASK];
+	WWProfile_Get_Ticks( &event.Ticks );
+	event.Name = name;
+	event.Value = value;
+	event.Type = type;
+
+	// The volatile store publishes the event to Flush_Trace_Buffers
+	buffer->Head = head + 1;
+}
+
+
+/***********************************************************************************************
+ * WWProfileManager::Begin_Trace -- Start recording trace events on all threads                *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Any events left over from a previous trace are discarded.                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWProfileManager::Begin_Trace( void )
+{
+	FastCriticalSectionClass::LockClass lock( TraceLock );
+
+	for (WWProfileThreadBufferClass * buffer = TraceBufferList; buffer != NULL; buffer = buffer->Next) {
+		buffer->Tail = buffer->Head;
+		buffer->Dropped = 0;
+		buffer->Events.Delete_All();
+	}
+	Recycle_Exited_Trace_Buffers();
+
+	TraceSession++;
+	TraceFrameCounter = 0;
+	WWProfile_Get_Ticks( &TraceStartTime );
+	TraceEnabled = true;
+}
+
+
+/***********************************************************************************************
+ * WWProfileManager::End_Trace -- Stop recording and optionally write the trace out            *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * filename - file to write the Chrome trace to, or NULL to discard the events                 *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * false if the trace file could not be written                                                *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool WWProfileManager::End_Trace( const char * filename )
+{
+	TraceEnabled = false;
+	Flush_Trace_Buffers();
+
+	bool retval = true;
+	if (filename != NULL) {
+		retval = Write_Chrome_Trace( filename );
+	}
+
+	FastCriticalSectionClass::LockClass lock( TraceLock );
+	for (WWProfileThreadBufferClass * buffer = TraceBufferList; buffer != NULL; buffer = buffer->Next) {
+		buffer->Events.Delete_All();
+	}
+	Recycle_Exited_Trace_Buffers();
+	return retval;
+}
+
+
+/***********************************************************************************************
+ * WWProfileManager::Release_Thread_Trace_Buffer -- Recycle the thread's trace buffer          *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Called when a thread exits.  Events the thread recorded during a running trace are kept     *
+ * until the trace ends; after that the buffer is reused by another thread.                    *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWProfileManager::Release_Thread_Trace_Buffer( void )
+{
+	WWProfileThreadBufferClass * buffer = ThreadTraceBuffer;
+	ThreadTraceBuffer = NULL;
+	ThreadTraceName = NULL;
+	if (buffer == NULL) {
+		return;
+	}
+
+	FastCriticalSectionClass::LockClass lock( TraceLock );
+	buffer->Exited = true;
+
+	// Outside of a trace the ring only holds stale events that Begin_Trace would skip anyway
+	if (!TraceEnabled && buffer->Events.Count() == 0) {
+		buffer->Tail = buffer->Head;
+	}
+	Recycle_Exited_Trace_Buffers();
+}
+
+
+/*
+** Threads that weren't started through ThreadClass never call Release_Thread_Trace_Buffer
+** themselves, so a TLS callback does it for every thread as it exits.
+*/
+#ifdef _MSC_VER
+static void NTAPI WWProfile_Thread_Exit_Callback( PVOID module, DWORD reason, PVOID reserved )
+{
+	if (reason == DLL_THREAD_DETACH) {
+		WWProfileManager::Release_Thread_Trace_Buffer();
+	}
+}
+
+#ifdef _M_IX86
+#pragma comment( linker, "/INCLUDE:__tls_used" )
+#pragma comment( linker, "/INCLUDE:_WWProfileThreadExitCallback" )
+#else
+#pragma comment( linker, "/INCLUDE:_tls_used" )
+#pragma comment( linker, "/INCLUDE:WWProfileThreadExitCallback" )
+#endif
+
+#pragma data_seg( ".CRT$XLB" )
+extern "C" PIMAGE_TLS_CALLBACK WWProfileThreadExitCallback = WWProfile_Thread_Exit_Callback;
+#pragma data_seg()
+#endif
+
+
+/***********************************************************************************************
+ * WWProfileManager::Set_Thread_Name -- Name the calling thread in trace output                *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * name - thread name, must stay valid for the life of the thread                              *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWProfileManager::Set_Thread_Name( const char * name )
+{
+	ThreadTraceName = name;
+
+	WWProfileThreadBufferClass * buffer = ThreadTraceBuffer;
+	if (buffer != NULL && name != NULL) {
+		FastCriticalSectionClass::LockClass lock( TraceLock );
+		strncpy( buffer->Name, name, sizeof( buffer->Name ) - 1 );
+		buffer->Name[sizeof( buffer->Name ) - 1] = 0;
+	}
+}
+
+
+/***********************************************************************************************
+ * WWProfileManager::Record_Counter -- Record a counter value on the trace timeline            *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * name - static string naming the counter                                                     *
+ * value - current value of the counter                                                        *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWProfileManager::Record_Counter( const char * name, int value )
+{
+	if (TraceEnabled) {
+		Record_Trace_Event( TRACE_EVENT_COUNTER, name, value );
+	}
+}
+
+
+/***********************************************************************************************
+ * WWProfileManager::Flush_Trace_Buffers -- Drain every thread's ring into its event list      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Called once per frame from Increment_Frame_Counter.  If a thread exceeds                    *
+ * TRACE_MAX_THREAD_EVENTS the trace is stopped rather than silently losing the tail.          *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void WWProfileManager::Flush_Trace_Buffers( void )
+{
+	FastCriticalSectionClass::LockClass lock( TraceLock );
+
+	for (WWProfileThreadBufferClass * buffer = TraceBufferList; buffer != NULL; buffer = buffer->Next) {
+		unsigned head = buffer->Head;
+		unsigned tail = buffer->Tail;
+		int count = head - tail;
+		if (count == 0) {
+			continue;
+		}
+
+		int needed = buffer->Events.Count() + count;
+		if (needed > TRACE_MAX_THREAD_EVENTS) {
+			if (TraceEnabled) {
+				WWDEBUG_SAY(( "WWProfile: trace buffer of thread %d is full, trace stopped\n", buffer->ThreadID ));
+				TraceEnabled = false;
+			}
+			buffer->Dropped += count;
+			buffer->Tail = head;
+			continue;
+		}
+
+		if (needed > buffer->Events.Length()) {
+			buffer->Events.Resize( MAX( needed, buffer->Events.Length() * 2 ) );
+		}
+		WWProfileTraceEventStruct * dest = buffer->Events.Add_Multiple( count );
+		for (; tail != head; ++tail) {
+			*dest++ = buffer->Ring[tail & TRACE_RING_MASK];
+		}
+		buffer->Tail = head;
+	}
+}
+
+
+/*
+** Helpers for the Chrome trace writer.  Output is batched into a fixed buffer and
+** written whenever it fills up.
+*/
+class WWProfileTraceWriterClass
+{
+public:
+	WWProfileTraceWriterClass( FileClass * file ) : File( file ), Length( 0 ), EventCount( 0 ) {}
+	~WWProfileTraceWriterClass( void ) { Flush(); }
+
+	void Write( const char * text )
+	{
+		while (*text) {
+			if (Length == sizeof( Buffer )) {
+				Flush();
+			}
+			Buffer[Length++] = *text++;
+		}
+	}
+
+	void Write_Name( const char * name )
+	{
+		char tmp[2] = { 0, 0 };
+		for (const char * c = name; *c; ++c) {
+			if (*c == '"' || *c == '\\') {
+				Write( "\\" );
+			}
+			tmp[0] = ((unsigned char)*c < 32) ? ' ' : *c;
+			Write( tmp );
+		}
+	}
+
+	void Begin_Event( const char * name, const char * phase, unsigned thread_id, double ts )
+	{
+		char tmp[128];
+		Write( EventCount++ ? ",\n{" : "\n{" );
+		if (name != NULL) {
+			Write( "\"name\":\"" );
+			Write_Name( name );
+			Write( "\"," );
+		}
+		sprintf( tmp, "\"ph\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", phase, thread_id, ts );
+		Write( tmp );
+	}
+
+	void Flush( void )
+	{
+		if (Length > 0) {
+			File->Write( Buffer, Length );
+			Length = 0;
+		}
+	}
+
+private:
+	FileClass *		File;
+	char				Buffer[16384];
+	int				Length;
+	int				EventCount;
+};
+
+
+/***********************************************************************************************
+ * WWProfileManager::Write_Chrome_Trace -- Write the collected events as Chrome trace JSON     *
+ *                                                                                             *
+ *    The output loads in chrome://tracing and in the Perfetto UI.  Scopes are written as      *
+ *    B/E pairs, counters as C events and frame markers as global instant events.              *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * filename - name of the file to create                                                       *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * false if the file could not be opened                                                       *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Call Flush_Trace_Buffers (or End_Trace) first to include the events still in the rings.    *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool WWProfileManager::Write_Chrome_Trace( const char * filename )
+{
+	FileClass * file = _TheWritingFileFactory->Get_File( filename );
+	if (file == NULL) {
+		return false;
+	}
+	if (!file->Open( FileClass::WRITE )) {
+		_TheWritingFileFactory->Return_File( file );
+		return false;
+	}
+
+	FastCriticalSectionClass::LockClass lock( TraceLock );
+
+	double usec_per_tick = CPUDetectClass::Get_Inv_Processor_Ticks_Per_Second() * 1000000.0;
+	unsigned total_dropped = 0;
+	char tmp[128];
+
+	{
+		WWProfileTraceWriterClass writer( file );
+		writer.Write( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" );
+
+		for (WWProfileThreadBufferClass * buffer = TraceBufferList; buffer != NULL; buffer = buffer->Next) {
+			total_dropped += buffer->Dropped;
+			if (buffer->Events.Count() == 0) {
+				continue;
+			}
+
+			// Thread name metadata
+			writer.Begin_Event( "thread_name", "M", buffer->ThreadID, 0.0 );
+			writer.Write( ",\"args\":{\"name\":\"" );
+			if (buffer->Name[0] != 0) {
+				writer.Write_Name( buffer->Name );
+			} else if (buffer->ThreadID == ThreadID) {
+				writer.Write( "Main" );
+			} else {
+				sprintf( tmp, "Thread %u", buffer->ThreadID );
+				writer.Write( tmp );
+			}
+			writer.Write( "\"}}" );
+
+			int depth = 0;
+			double ts = 0.0;
+			for (int i = 0; i < buffer->Events.Count(); ++i) {
+				const WWProfileTraceEventStruct & event = buffer->Events[i];
+				if (event.Ticks < TraceStartTime) {
+					continue;
+				}
+				ts = double( event.Ticks - TraceStartTime ) * usec_per_tick;
+
+				switch (event.Type) {
+				case TRACE_EVENT_BEGIN:
+					writer.Begin_Event( event.Name, "B", buffer->ThreadID, ts );
+					writer.Write( "}" );
+					depth++;
+					break;
+
+				case TRACE_EVENT_END:
+					if (depth > 0) {
+						writer.Begin_Event( NULL, "E", buffer->ThreadID, ts );
+						writer.Write( "}" );
+						depth--;
+					}
+					break;
+
+				case TRACE_EVENT_COUNTER:
+					writer.Begin_Event( event.Name, "C", buffer->ThreadID, ts );
+					sprintf( tmp, ",\"args\":{\"value\":%d}}", event.Value );
+					writer.Write( tmp );
+					break;
+
+				case TRACE_EVENT_FRAME:
+					writer.Begin_Event( event.Name, "i", buffer->ThreadID, ts );
+					sprintf( tmp, ",\"s\":\"g\",\"args\":{\"frame\":%d}}", event.Value );
+					writer.Write( tmp );
+					break;
+				}
+			}
+
+			// Close any scope that was still open when the trace stopped
+			while (depth-- > 0) {
+				writer.Begin_Event( NULL, "E", buffer->ThreadID, ts );
+				writer.Write( "}" );
+			}
+		}
+
+		writer.Write( "\n]}\n" );
+	}
+
+	file->Close();
+	_TheWritingFileFactory->Return_File( file );
+
+	if (total_dropped != 0) {
+		WWDEBUG_SAY(( "WWProfile: %d trace events were dropped\n", total_dropped ));
+	}
+	return true;
+}
 
 
 /***********************************************************************************************
@@ -337,6 +960,10 @@ static unsigned int				ThreadID = static_cast<unsigned int>(-1);
  *=============================================================================================*/
 void	WWProfileManager::Start_Profile( const char * name )
 {
+	if (TraceEnabled) {
+		Record_Trace_Event( TRACE_EVENT_BEGIN, name, 0 );
+	}
+
 	if (::GetCurrentThreadId() != ThreadID) {
 		return;
 	}
@@ -351,6 +978,10 @@ void	WWProfileManager::Start_Profile( const char * name )
 
 void	WWProfileManager::Start_Root_Profile( const char * name )
 {
+	if (TraceEnabled) {
+		Record_Trace_Event( TRACE_EVENT_BEGIN, name, 0 );
+	}
+
 	if (::GetCurrentThreadId() != ThreadID) {
 		return;
 	}
@@ -377,6 +1008,10 @@ void	WWProfileManager::Start_Root_Profile( const char * name )
  *=============================================================================================*/
 void	WWProfileManager::Stop_Profile( void )
 {
+	if (TraceEnabled) {
+		Record_Trace_Event( TRACE_EVENT_END, NULL, 0 );
+	}
+
 	if (::GetCurrentThreadId() != ThreadID) {
 		return;
 	}
@@ -390,6 +1025,10 @@ void	WWProfileManager::Stop_Profile( void )
 
 void	WWProfileManager::Stop_Root_Profile( void )
 {
+	if (TraceEnabled) {
+		Record_Trace_Event( TRACE_EVENT_END, NULL, 0 );
+	}
+
 	if (::GetCurrentThreadId() != ThreadID) {
 		return;
 	}
@@ -402,6 +1041,28 @@ void	WWProfileManager::Stop_Root_Profile( void )
 }
 
 
+/***********************************************************************************************
+ * WWProfileManager::Get_Current_Scope_Name -- Name of the innermost open WWPROFILE scope      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * static name of the current node, or NULL when called from a thread other than the one     *
+ * that owns the profile tree                                                                  *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+const char * WWProfileManager::Get_Current_Scope_Name( void )
+{
+	if (::GetCurrentThreadId() != ThreadID) {
+		return NULL;
+	}
+	return CurrentNode->Get_Name();
+}
+
+
 /***********************************************************************************************
  * WWProfileManager::Reset -- Reset the contents of the profiling system                       *
  *                                                                                             *
@@ -441,6 +1102,11 @@ void	WWProfileManager::Reset( void )
  *=============================================================================================*/
 void WWProfileManager::Increment_Frame_Counter( void )
 {
+	if (TraceEnabled) {
+		Record_Trace_Event( TRACE_EVENT_FRAME, "Frame", TraceFrameCounter++ );
+		Flush_Trace_Buffers();
+	}
+
 	if (ProfileCollecting) {
 		float time=Get_Time_Since_Reset();
 		TotalFrameTimes+=time;
@@ -519,11 +1185,26 @@ void	WWProfileManager::Begin_Collecting()
 	Reset();
 	ProfileCollecting=true;
 	TotalFrameTimes=0.0;
+	Begin_Trace();
 }
 
 void	WWProfileManager::End_Collecting(const char* filename)
 {
 	int i;
+
+	// The per-thread timeline goes next to the main thread tree, e.g. profile_log.json
+	if (filename) {
+		StringClass trace_name(filename,true);
+		const char* ext=strrchr(filename,'.');
+		if (ext) {
+			trace_name.Erase(int(ext-filename),int(strlen(ext)));
+		}
+		trace_name+=".json";
+		End_Trace(trace_name);
+	} else {
+		End_Trace(NULL);
+	}
+
 	if (filename && ProfileCollectVector.Count()!=0) {
 		FileClass * file= _TheWritingFileFactory->Get_File(filename);	
 		if (file != NULL) {
@@ -50,8 +50,10 @@ typedef signed long long __int64;
 typedef signed long long _int64;
 #endif
 
-// enable profiling by default in debug mode.
-#ifdef WWDEBUG
+// enable profiling by default in debug mode. Release builds (e.g. the dedicated server) may
+// define ENABLE_WWPROFILE themselves; when no trace is running a scope costs a flag test and
+// a thread id compare.
+#if defined(WWDEBUG) && !defined(ENABLE_WWPROFILE)
 #define ENABLE_WWPROFILE	
 #endif
 
@@ -181,16 +183,32 @@ public:
 	static	void								Release_In_Order_Iterator( WWProfileInOrderIterator * iterator );
 
 	static	WWProfileHierachyNodeClass *	Get_Root( void ) { return &Root; }
+	static	const char *					Get_Current_Scope_Name( void );		// NULL if not called from the profiled thread
 
 	static	void								Begin_Collecting();
 	static	void								End_Collecting(const char* filename);
 
+	// Trace recording. While tracing, every WWPROFILE scope on every thread is
+	// recorded into a lock-free buffer owned by that thread. The buffers are
+	// drained once per frame and can be written out as a Chrome trace (JSON).
+	static	void								Begin_Trace( void );
+	static	bool								End_Trace( const char * filename );
+	static	bool								Is_Tracing( void )							{ return TraceEnabled; }
+	static	void								Set_Thread_Name( const char * name );
+	static	void								Release_Thread_Trace_Buffer( void );		// call when a thread exits
+	static	void								Record_Counter( const char * name, int value );
+	static	void								Flush_Trace_Buffers( void );
+	static	bool								Write_Chrome_Trace( const char * filename );
+
 private:
+	static	void								Record_Trace_Event( int type, const char * name, int value );
+
 	static	WWProfileHierachyNodeClass		Root;
 	static	WWProfileHierachyNodeClass *	CurrentNode;
 	static	WWProfileHierachyNodeClass *	CurrentRootNode;
 	static	int									FrameCounter;
 	static	__int64								ResetTime;
+	static	volatile bool						TraceEnabled;
 
 	friend	class		WWProfileInOrderIterator;
 };
@@ -219,9 +237,11 @@ public:
 #ifdef ENABLE_WWPROFILE
 #define	WWPROFILE( name )						WWProfileSampleClass _wwprofile( name, false )
 #define	WWROOTPROFILE( name )				WWProfileSampleClass _wwprofile( name, true )
+#define	WWPROFILE_COUNTER( name, value )	if (WWProfileManager::Is_Tracing()) WWProfileManager::Record_Counter( name, value ); else (void)0
 #else
 #define	WWPROFILE( name )
 #define	WWROOTPROFILE( name )
+#define	WWPROFILE_COUNTER( name, value )
 #endif
 
 
@@ -34,7 +34,12 @@ FastAllocatorGeneral::FastAllocatorGeneral() : MemoryLeakLogEnabled(false), Allo
 {
 	int alloc_size=ALLOC_STEP;
 	for (int i=0;i<MAX_ALLOC_SIZE/ALLOC_STEP;++i) {
+#ifdef FAST_ALLOCATOR_THREAD_CACHE
+		// Roughly the same 8k chunks as FastFixedAllocator
+		allocators[i].Init(alloc_size,(8*1024)/alloc_size);
+#else
 	   allocators[i].Init(alloc_size);
+#endif
 		alloc_size+=ALLOC_STEP;
 	}
 }
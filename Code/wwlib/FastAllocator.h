@@ -37,6 +37,11 @@
 
 //#define MEMORY_OVERWRITE_TEST
 
+// FastAllocatorGeneral keeps per thread caches of each size bucket instead of
+// locking the bucket on every allocation. Comment out to go back to the locked
+// FastFixedAllocator buckets.
+#define FAST_ALLOCATOR_THREAD_CACHE
+
 
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -45,6 +50,7 @@
 #include "always.h"
 #include "wwdebug.h"
 #include "mutex.h"
+#include "threadcache.h"
 #include <malloc.h>
 #include <stddef.h> //size_t & ptrdiff_t definition
 #include <string.h>
@@ -375,8 +381,12 @@ public:
 	static FastAllocatorGeneral* Get_Allocator();
 
 protected:
+#ifdef FAST_ALLOCATOR_THREAD_CACHE
+	ThreadCachedAllocatorClass allocators[MAX_ALLOC_SIZE/ALLOC_STEP];
+#else
    FastFixedAllocator allocators[MAX_ALLOC_SIZE/ALLOC_STEP];
 	FastCriticalSectionClass CriticalSections[MAX_ALLOC_SIZE/ALLOC_STEP];
+#endif
 	bool MemoryLeakLogEnabled;
 
 	unsigned AllocatedWithMalloc;
@@ -389,7 +399,9 @@ WWINLINE unsigned FastAllocatorGeneral::Get_Total_Heap_Size()
 {
 	int size=AllocatedWithMalloc;
 	for (int i=0;i<MAX_ALLOC_SIZE/ALLOC_STEP;++i) {
+#ifndef FAST_ALLOCATOR_THREAD_CACHE
 		FastCriticalSectionClass::LockClass lock(CriticalSections[i]);
+#endif
 		size+=allocators[i].Get_Heap_Size();
 	}
 	return size;
@@ -399,7 +411,9 @@ WWINLINE unsigned FastAllocatorGeneral::Get_Total_Allocated_Size()
 {
 	int size=AllocatedWithMalloc;
 	for (int i=0;i<MAX_ALLOC_SIZE/ALLOC_STEP;++i) {
+#ifndef FAST_ALLOCATOR_THREAD_CACHE
 		FastCriticalSectionClass::LockClass lock(CriticalSections[i]);
+#endif
 		size+=allocators[i].Get_Allocated_Size();
 	}
 	return size;
@@ -409,7 +423,9 @@ WWINLINE unsigned FastAllocatorGeneral::Get_Total_Allocation_Count()
 {
 	int count=AllocatedWithMallocCount;
 	for (int i=0;i<MAX_ALLOC_SIZE/ALLOC_STEP;++i) {
+#ifndef FAST_ALLOCATOR_THREAD_CACHE
 		FastCriticalSectionClass::LockClass lock(CriticalSections[i]);
+#endif
 		count+=allocators[i].Get_Allocation_Count();
 	}
 	return count;
@@ -440,10 +456,14 @@ WWINLINE void* FastAllocatorGeneral::Alloc(unsigned int n)
 	}
 	if (n<MAX_ALLOC_SIZE) {
 		int index=(n)/ALLOC_STEP;
+#ifdef FAST_ALLOCATOR_THREAD_CACHE
+		pMemory = allocators[index].Alloc();
+#else
 		{
 			FastCriticalSectionClass::LockClass lock(CriticalSections[index]);
 			pMemory = allocators[index].Alloc();
 		}
+#endif
 	}
    else {
 		if (re_entrancy==1) {
@@ -481,7 +501,9 @@ WWINLINE void FastAllocatorGeneral::Free(void* pAlloc)
 
 		if (size<MAX_ALLOC_SIZE) {
 			int index=size/ALLOC_STEP;
+#ifndef FAST_ALLOCATOR_THREAD_CACHE
 			FastCriticalSectionClass::LockClass lock(CriticalSections[index]);
+#endif
          allocators[index].Free(n);
 		}
       else {
@@ -43,8 +43,10 @@
  *   ChunkSaveClass::Write -- write an IOVector3Struct                                         *
  *   ChunkSaveClass::Write -- write an IOVector4Struct                                         *
  *   ChunkSaveClass::Write -- write an IOQuaternionStruct                                      *
+ *   ChunkSaveClass::Write_Chunks -- copies in chunks saved somewhere else                     *
  *   ChunkSaveClass::Cur_Chunk_Depth -- returns the current chunk recursion depth (debugging)  * 
  *   ChunkLoadClass::ChunkLoadClass -- Constructor                                             * 
+ *   ChunkLoadClass::~ChunkLoadClass -- Destructor                                             *
  *   ChunkLoadClass::Open_Chunk -- Open a chunk in the file, reads in the chunk header         * 
  *   ChunkLoadClass::Peek_Next_Chunk -- sneak peek into the next chunk that will be opened     *
  *   ChunkLoadClass::Close_Chunk -- Close a chunk, seeks to the end if needed                  * 
@@ -61,6 +63,10 @@
  *   ChunkLoadClass::Read -- read an IOVector3Struct                                           *
  *   ChunkLoadClass::Read -- read an IOVector4Struct                                           *
  *   ChunkLoadClass::Read -- read an IOQuaternionStruct                                        *
+ *   ChunkLoadClass::Read_Span -- returns a pointer to the next bytes without copying them     *
+ *   ChunkLoadClass::Load_View -- reads the current top level chunk into memory                *
+ *   ChunkLoadClass::Read_Bytes -- copies bytes from memory or the file                        *
+ *   ChunkLoadClass::Skip_Bytes -- skips bytes in memory or the file                           *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include "chunkio.h"
@@ -356,6 +362,51 @@ uint32 ChunkSaveClass::Write(const IOQuaternionStruct & q)
 	return Write(&q,sizeof(q));
 }
 
+/***********************************************************************************************
+ * ChunkSaveClass::Write_Chunks -- copies in chunks saved somewhere else                       *
+ *                                                                                             *
+ * The buffer must hold one or more whole chunks, headers included, such as the contents of a  *
+ * file written by another ChunkSaveClass with no chunk left open.  Chunk headers only hold    *
+ * sizes, never file positions, so the result is the same as saving the chunks here directly.  *
+ * This lets parts of a file be saved separately (or ahead of time) and stitched together.     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * buf - the chunk data                                                                        *
+ * nbytes - size of the data                                                                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * number of bytes written                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Like Begin_Chunk, this can't be mixed with data in the same chunk                           *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+uint32 ChunkSaveClass::Write_Chunks(const void * buf, uint32 nbytes)
+{
+	assert(!InMicroChunk);
+	assert(nbytes == 0 || nbytes >= sizeof(ChunkHeader));
+
+	if (nbytes == 0) {
+		return 0;
+	}
+
+	// The parent, if any, now contains chunks
+	if (StackIndex > 0) {
+		HeaderStack[StackIndex-1].Set_Sub_Chunk_Flag(true);
+	}
+
+	if (File->Write(buf,nbytes) != (int)nbytes) return 0;
+
+	// track them in the wrapping chunk
+	if (StackIndex > 0) {
+		HeaderStack[StackIndex-1].Add_Size(nbytes);
+	}
+
+	return nbytes;
+}
+
+
 /*********************************************************************************************** 
  * ChunkSaveClass::Cur_Chunk_Depth -- returns the current chunk recursion depth (debugging)    * 
  *                                                                                             * 
@@ -388,6 +439,11 @@ int ChunkSaveClass::Cur_Chunk_Depth(void)
  *=============================================================================================*/
 ChunkLoadClass::ChunkLoadClass(FileClass * file) :
 	File(file),
+	ViewState(VIEW_NONE),
+	ViewBuffer(NULL),
+	ViewBufferSize(0),
+	ViewSize(0),
+	ViewOffset(0),
 	StackIndex(0),
 	InMicroChunk(false),
 	MicroChunkPosition(0)
@@ -398,6 +454,24 @@ ChunkLoadClass::ChunkLoadClass(FileClass * file) :
 }
 
 
+/***********************************************************************************************
+ * ChunkLoadClass::~ChunkLoadClass -- Destructor                                               *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+ChunkLoadClass::~ChunkLoadClass()
+{
+	delete [] ViewBuffer;
+	ViewBuffer = NULL;
+}
+
+
 /*********************************************************************************************** 
  * ChunkLoadClass::Open_Chunk -- Open a chunk in the file, reads in the chunk header           * 
  *                                                                                             * 
@@ -423,9 +497,32 @@ bool ChunkLoadClass::Open_Chunk()
 		return false;
 	}
 
-	// read the chunk header
-	if (File->Read(&HeaderStack[StackIndex],sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
-		return false;
+	if (StackIndex == 0) {
+
+		// read the chunk header
+		if (File->Read(&HeaderStack[0],sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
+			return false;
+		}
+
+		// the contents are read into memory when something first asks for them
+		ViewState = (HeaderStack[0].Get_Size() <= MAX_VIEW_SIZE) ? VIEW_PENDING : VIEW_NONE;
+
+	} else {
+
+		// read the chunk header
+		if (!Read_Bytes(&HeaderStack[StackIndex],sizeof(ChunkHeader))) {
+			return false;
+		}
+
+		// a chunk read from memory has to fit in what is left of its parent
+		if (ViewState == VIEW_LOADED) {
+			uint32 parent_size = HeaderStack[StackIndex-1].Get_Size();
+			uint32 used = PositionStack[StackIndex-1] + sizeof(ChunkHeader);
+			if ((used > parent_size) || (HeaderStack[StackIndex].Get_Size() > parent_size - used)) {
+				ViewOffset -= sizeof(ChunkHeader);
+				return false;
+			}
+		}
 	}
 
 	PositionStack[StackIndex] = 0;
@@ -461,12 +558,22 @@ bool ChunkLoadClass::Peek_Next_Chunk(uint32 * set_id,uint32 * set_size)
 
 	// peek at the next chunk header, return false if the read fails
 	ChunkHeader temp_header;
-	if (File->Read(&temp_header,sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
-		return false;
-	}
+	if ((StackIndex > 0) && Load_View()) {
+
+		if (ViewOffset + sizeof(ChunkHeader) > ViewSize) {
+			return false;
+		}
+		memcpy(&temp_header,ViewBuffer + ViewOffset,sizeof(ChunkHeader));
+
+	} else {
 
-	int seek_offset = sizeof(ChunkHeader);
-	File->Seek(-seek_offset,SEEK_CUR);
+		if (File->Read(&temp_header,sizeof(ChunkHeader)) != sizeof(ChunkHeader)) {
+			return false;
+		}
+
+		int seek_offset = sizeof(ChunkHeader);
+		File->Seek(-seek_offset,SEEK_CUR);
+	}
 	
 	if (set_id != NULL) {
 		*set_id = temp_header.Get_Type();
@@ -501,8 +608,16 @@ bool ChunkLoadClass::Close_Chunk()
 	int csize = HeaderStack[StackIndex-1].Get_Size();
 	int pos = PositionStack[StackIndex-1];
 	
-	if (pos < csize) {
-		File->Seek(csize - pos,SEEK_CUR);
+	if (StackIndex == 1) {
+
+		// the file is already past a top level chunk that was read into memory
+		if ((ViewState != VIEW_LOADED) && (pos < csize)) {
+			File->Seek(csize - pos,SEEK_CUR);
+		}
+		ViewState = VIEW_NONE;
+
+	} else if (pos < csize) {
+		Skip_Bytes(csize - pos);
 	}
 
 	StackIndex--;
@@ -638,7 +753,7 @@ bool ChunkLoadClass::Close_Micro_Chunk()
 	// seek the file past this micro chunk 
 	if (pos < csize) {
 
-		File->Seek(csize - pos,SEEK_CUR);
+		Skip_Bytes(csize - pos);
 		
 		// update the tracking variables for where we are in the normal chunk.
 		if (StackIndex > 0) {
@@ -706,8 +821,7 @@ uint32 ChunkLoadClass::Seek(uint32 nbytes)
 		return 0;
 	}
 	
-	uint32 curpos=File->Tell();
-	if (File->Seek(nbytes,SEEK_CUR)-curpos != (int)nbytes) {
+	if (!Skip_Bytes(nbytes)) {
 		return 0;
 	}
 
@@ -748,7 +862,7 @@ uint32 ChunkLoadClass::Read(void * buf,uint32 nbytes)
 		return 0;
 	}
 	
-	if (File->Read(buf,nbytes) != (int)nbytes) {
+	if (!Read_Bytes(buf,nbytes)) {
 		return 0;
 	}
 
@@ -764,6 +878,149 @@ uint32 ChunkLoadClass::Read(void * buf,uint32 nbytes)
 }
 
 
+/***********************************************************************************************
+ * ChunkLoadClass::Read_Span -- returns a pointer to the next bytes without copying them       *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * nbytes - number of bytes wanted                                                             *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * pointer to the bytes, NULL if they are not available from memory                            *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * The pointer is only good until the top level chunk is closed. Returns NULL without          *
+ * moving if the chunk is too big to be held in memory; use Read in that case.                 *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+const void * ChunkLoadClass::Read_Span(uint32 nbytes)
+{
+	assert(StackIndex >= 1);
+
+	// Don't read if we would go past the end of the current chunk
+	if (PositionStack[StackIndex-1] + nbytes > (int)HeaderStack[StackIndex-1].Get_Size()) {
+		return NULL;
+	}
+
+	// Don't read if we are in a micro chunk and would go past the end of it
+	if (InMicroChunk && MicroChunkPosition + nbytes > MCHeader.Get_Size()) {
+		return NULL;
+	}
+
+	if (!Load_View() || (ViewOffset + nbytes > ViewSize)) {
+		return NULL;
+	}
+
+	const void * span = ViewBuffer + ViewOffset;
+	ViewOffset += nbytes;
+
+	// Update our position in the chunk
+	PositionStack[StackIndex-1] += nbytes;
+
+	// Update our position in the micro chunk if we are in one
+	if (InMicroChunk) {
+		MicroChunkPosition += nbytes;
+	}
+
+	return span;
+}
+
+
+/***********************************************************************************************
+ * ChunkLoadClass::Load_View -- reads the current top level chunk into memory                  *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * true if the top level chunk is in memory                                                    *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * A short read (truncated file) leaves a short view; reads past its end fail as they          *
+ * would have done from the file.                                                              *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool ChunkLoadClass::Load_View()
+{
+	if (ViewState == VIEW_PENDING) {
+
+		assert(StackIndex >= 1 && PositionStack[0] == 0);
+
+		uint32 size = HeaderStack[0].Get_Size();
+		if (size > ViewBufferSize) {
+			delete [] ViewBuffer;
+			ViewBuffer = new uint8[size];
+			ViewBufferSize = size;
+		}
+
+		int count = (size > 0) ? File->Read(ViewBuffer,size) : 0;
+		ViewSize = (count > 0) ? count : 0;
+		ViewOffset = 0;
+		ViewState = VIEW_LOADED;
+	}
+
+	return (ViewState == VIEW_LOADED);
+}
+
+
+/***********************************************************************************************
+ * ChunkLoadClass::Read_Bytes -- copies bytes from memory or the file                          *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * buf - destination                                                                           *
+ * nbytes - number of bytes to read                                                            *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * true if all of the bytes were read                                                          *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool ChunkLoadClass::Read_Bytes(void * buf,uint32 nbytes)
+{
+	if (Load_View()) {
+		if (ViewOffset + nbytes > ViewSize) {
+			return false;
+		}
+		memcpy(buf,ViewBuffer + ViewOffset,nbytes);
+		ViewOffset += nbytes;
+		return true;
+	}
+
+	return (File->Read(buf,nbytes) == (int)nbytes);
+}
+
+
+/***********************************************************************************************
+ * ChunkLoadClass::Skip_Bytes -- skips bytes in memory or the file                             *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * nbytes - number of bytes to skip                                                            *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * true if all of the bytes were skipped                                                       *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool ChunkLoadClass::Skip_Bytes(uint32 nbytes)
+{
+	if (Load_View()) {
+		if (ViewOffset + nbytes > ViewSize) {
+			ViewOffset = ViewSize;
+			return false;
+		}
+		ViewOffset += nbytes;
+		return true;
+	}
+
+	uint32 curpos=File->Tell();
+	return (File->Seek(nbytes,SEEK_CUR)-curpos == (int)nbytes);
+}
+
+
 /***********************************************************************************************
  * ChunkLoadClass::Read -- read an IOVector2Struct                                             *
  *                                                                                             *
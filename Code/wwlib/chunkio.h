@@ -154,6 +154,9 @@ public:
 	uint32				Write(const IOVector4Struct & v);
 	uint32				Write(const IOQuaternionStruct & q);
 
+	// Copy in complete chunks that were saved with another ChunkSaveClass
+	uint32				Write_Chunks(const void *buf, uint32 nbytes);
+
 private:
 
 	enum { MAX_STACK_DEPTH = 256 };
@@ -178,12 +181,19 @@ private:
 ** wrap an instance of one of these objects around an opened file
 ** to easily parse the chunks in the file
 **
+** The first time anything inside a top level chunk is read, the whole chunk is
+** read into memory with a single file read and everything below it is served
+** from there, so loaders making thousands of small reads don't each go to the
+** file. Chunk headers read from memory are checked against their parent's bounds.
+** Top level chunks bigger than MAX_VIEW_SIZE are read from the file as before.
+**
 **************************************************************************************/
 class ChunkLoadClass
 {
 public:
 
 	ChunkLoadClass(FileClass * file);
+	~ChunkLoadClass();
 
 	// Chunk methods
 	bool					Open_Chunk();
@@ -213,12 +223,31 @@ public:
 	// this, then you are probably hacking so be careful!
 	bool					Peek_Next_Chunk(uint32 * set_id,uint32 * set_size);
 
+	// Zero copy version of Read. Returns a pointer to the next nbytes of the current
+	// chunk and moves past them, or NULL if they can't be read or the chunk isn't in
+	// memory (Read still works then). The data stays valid until the top level chunk
+	// is closed.
+	const void *		Read_Span(uint32 nbytes);
+
 private:
 
 	enum { MAX_STACK_DEPTH = 256 };
+	enum { MAX_VIEW_SIZE = 16 * 1024 * 1024 };
+
+	bool					Load_View();
+	bool					Read_Bytes(void * buf, uint32 nbytes);
+	bool					Skip_Bytes(uint32 nbytes);
 
 	FileClass *			File;
 
+	// In-memory copy of the open top level chunk's contents
+	enum ViewStateType { VIEW_NONE, VIEW_PENDING, VIEW_LOADED };
+	ViewStateType		ViewState;
+	uint8 *				ViewBuffer;
+	uint32				ViewBufferSize;
+	uint32				ViewSize;
+	uint32				ViewOffset;
+
 	// Chunk reading support
 	int					StackIndex;
 	uint32				PositionStack[MAX_STACK_DEPTH];
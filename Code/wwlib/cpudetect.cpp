@@ -24,6 +24,7 @@
 #pragma warning (disable : 4201)	// Nonstandard extension - nameless struct
 #include <windows.h>
 #include "systimer.h"
+#include <immintrin.h>
 
 struct OSInfoStruct {
 	const char* Code;
@@ -111,6 +112,7 @@ bool CPUDetectClass::HasCPUIDInstruction=false;
 bool CPUDetectClass::HasRDTSCInstruction=false;
 bool CPUDetectClass::HasSSESupport=false;
 bool CPUDetectClass::HasSSE2Support=false;
+bool CPUDetectClass::HasAVX2Support=false;
 bool CPUDetectClass::HasCMOVSupport=false;
 bool CPUDetectClass::HasMMXSupport=false;
 bool CPUDetectClass::Has3DNowSupport=false;
@@ -868,6 +870,16 @@ void CPUDetectClass::Init_Processor_Features()
 	HasSSESupport=!!(FeatureBits&(1<<25));
 	HasSSE2Support=!!(FeatureBits&(1<<26));
 
+	// AVX2 needs both the cpu support and the OS saving the YMM registers (OSXSAVE + XCR0 bits 1 and 2)
+	HasAVX2Support=false;
+	if ((id.Ecx&(1<<27)) && (id.Ecx&(1<<28)) && (_xgetbv(0)&6)==6) {
+		CPUIDStruct max_id(0);
+		if (max_id.Eax>=7) {
+			CPUIDStruct ext_features(7);
+			HasAVX2Support=!!(ext_features.Ebx&(1<<5));
+		}
+	}
+
 	Has3DNowSupport=false;
 	ExtendedFeatureBits=0;
 	if (ProcessorManufacturer==MANUFACTURER_AMD) {
@@ -994,6 +1006,7 @@ void CPUDetectClass::Init_Processor_Log()
 	SYSLOG(("MMX: %s\r\n",CPUDetectClass::Has_MMX_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("SSE: %s\r\n",CPUDetectClass::Has_SSE_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("SSE2: %s\r\n",CPUDetectClass::Has_SSE2_Instruction_Set() ? "Yes" : "No"));
+	SYSLOG(("AVX2: %s\r\n",CPUDetectClass::Has_AVX2_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("3DNow!: %s\r\n",CPUDetectClass::Has_3DNow_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("Extended 3DNow!: %s\r\n",CPUDetectClass::Has_Extended_3DNow_Instruction_Set() ? "Yes" : "No"));
 	SYSLOG(("CPU Feature bits: 0x%x\r\n",CPUDetectClass::Get_Feature_Bits()));
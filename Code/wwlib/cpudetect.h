@@ -149,6 +149,7 @@ public:
 	inline static bool Has_MMX_Instruction_Set() { return HasMMXSupport; }
 	inline static bool Has_SSE_Instruction_Set() { return HasSSESupport; }
 	inline static bool Has_SSE2_Instruction_Set() { return HasSSE2Support; }
+	inline static bool Has_AVX2_Instruction_Set() { return HasAVX2Support; }
 	inline static bool Has_3DNow_Instruction_Set() { return Has3DNowSupport; }
 	inline static bool Has_Extended_3DNow_Instruction_Set() { return HasExtended3DNowSupport; }
 
@@ -290,6 +291,7 @@ private:
 	static bool HasRDTSCInstruction;
 	static bool HasSSESupport;
 	static bool HasSSE2Support;
+	static bool HasAVX2Support;
 	static bool HasCMOVSupport;
 	static bool HasMMXSupport;
 	static bool Has3DNowSupport;
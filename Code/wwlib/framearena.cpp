@@ -0,0 +1,169 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "framearena.h"
+#include "thread.h"
+#include "wwdebug.h"
+#include "wwprofile.h"
+
+
+// ----------------------------------------------------------------------------
+
+FrameArenaClass::FrameArenaClass(int block_size)
+	:
+	Head(NULL),
+	Current(NULL),
+	Offset(0),
+	UsedBefore(0),
+	BlockSize(block_size),
+	Capacity(0),
+	FrameHighWater(0),
+	LastFrameHighWater(0),
+	HighWater(0),
+	Generation(0),
+	OwnerThreadID(ThreadClass::_Get_Current_Thread_ID())
+{
+	WWASSERT(BlockSize>0);
+}
+
+FrameArenaClass::~FrameArenaClass()
+{
+	Free_Blocks();
+}
+
+FrameArenaClass* FrameArenaClass::Get_Frame_Arena()
+{
+	static FrameArenaClass _FrameArena;
+	return &_FrameArena;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Blocks are allocated with the data following the header. Sizes are rounded
+// up to 4k so that a coalesced block has some slack for the next frame.
+//
+// ----------------------------------------------------------------------------
+
+FrameArenaClass::BlockStruct* FrameArenaClass::Allocate_Block(int size)
+{
+	size=(size+4095)&~4095;
+	BlockStruct* block=(BlockStruct*)new char[sizeof(BlockStruct)+size];
+	block->Next=NULL;
+	block->Size=size;
+	Capacity+=size;
+	return block;
+}
+
+void FrameArenaClass::Free_Blocks()
+{
+	while (Head) {
+		BlockStruct* next=Head->Next;
+		delete[] (char*)Head;
+		Head=next;
+	}
+	Current=NULL;
+	Offset=0;
+	UsedBefore=0;
+	Capacity=0;
+}
+
+// ----------------------------------------------------------------------------
+//
+// The current block is full: move on to the next block in the chain, inserting
+// a new one if the next block is missing or too small for this request.
+//
+// ----------------------------------------------------------------------------
+
+void* FrameArenaClass::Allocate_Slow(int size,int alignment)
+{
+	WWASSERT(size>=0);
+	WWASSERT(alignment>0 && (alignment&(alignment-1))==0);
+	WWASSERT(OwnerThreadID==ThreadClass::_Get_Current_Thread_ID());
+
+	int needed=size+alignment;
+	BlockStruct* next=Head;
+	if (Current) {
+		UsedBefore+=Current->Size;
+		next=Current->Next;
+	}
+
+	if (next==NULL || next->Size<needed) {
+		BlockStruct* block=Allocate_Block(MAX(BlockSize,needed));
+		block->Next=next;
+		if (Current) {
+			Current->Next=block;
+		} else {
+			Head=block;
+		}
+		next=block;
+	}
+
+	Current=next;
+	Offset=0;
+	return Allocate(size,alignment);
+}
+
+// ----------------------------------------------------------------------------
+
+FrameArenaClass::MarkStruct FrameArenaClass::Get_Mark() const
+{
+	MarkStruct mark;
+	mark.Block=Current;
+	mark.Offset=Offset;
+	mark.UsedBefore=UsedBefore;
+	return mark;
+}
+
+void FrameArenaClass::Rewind(const MarkStruct& mark)
+{
+	Current=(BlockStruct*)mark.Block;
+	Offset=mark.Offset;
+	UsedBefore=mark.UsedBefore;
+}
+
+// ----------------------------------------------------------------------------
+//
+// End of frame. Everything allocated from the arena is released. If the frame
+// needed more than one block, the chain is replaced by one block holding all
+// of it so the next frame runs entirely in the fast path.
+//
+// ----------------------------------------------------------------------------
+
+void FrameArenaClass::Reset()
+{
+	LastFrameHighWater=FrameHighWater;
+	if (FrameHighWater>HighWater) {
+		HighWater=FrameHighWater;
+	}
+
+	if (Head!=NULL && Head->Next!=NULL) {
+		int size=Capacity;
+		Free_Blocks();
+		Head=Allocate_Block(size);
+		WWDEBUG_SAY(("FrameArena: grown to %d bytes (high water %d)\n",Capacity,HighWater));
+	}
+
+	Current=Head;
+	Offset=0;
+	UsedBefore=0;
+	FrameHighWater=0;
+	Generation++;
+
+	WWPROFILE_COUNTER("Frame Arena Bytes",LastFrameHighWater);
+}
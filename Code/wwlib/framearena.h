@@ -0,0 +1,226 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+#include "vector.h"
+#include <stddef.h>
+
+// ----------------------------------------------------------------------------
+//
+// FrameArenaClass is a linear (bump) allocator for temporaries that live no
+// longer than a frame. Allocation is a pointer increment; nothing is ever
+// freed individually. Memory is reclaimed either by rewinding to a mark
+// (see FrameArenaScopeClass) or by Reset() at the end of the frame.
+//
+// The arena grows by chaining extra blocks. On Reset() a chain is coalesced
+// into a single block big enough for the frame, so in the steady state the
+// arena does no heap allocation at all.
+//
+// An arena is not thread safe. Get_Frame_Arena() returns the main thread
+// arena which is reset once per frame by TimeManager::Update().
+//
+// ----------------------------------------------------------------------------
+
+class FrameArenaClass
+{
+public:
+	enum {
+		DEFAULT_BLOCK_SIZE=64*1024,
+		DEFAULT_ALIGNMENT=8
+	};
+
+	struct MarkStruct
+	{
+		void *		Block;
+		int			Offset;
+		int			UsedBefore;
+	};
+
+	FrameArenaClass(int block_size=DEFAULT_BLOCK_SIZE);
+	~FrameArenaClass();
+
+	void* Allocate(int size,int alignment=DEFAULT_ALIGNMENT);
+
+	template <class T> T* Allocate_Array(int count)
+	{
+		return (T*)Allocate(count*int(sizeof(T)),int(__alignof(T)));
+	}
+
+	// Rewind to an earlier mark. Everything allocated after the mark is invalid.
+	MarkStruct Get_Mark() const;
+	void Rewind(const MarkStruct& mark);
+
+	// Release everything allocated this frame.
+	void Reset();
+
+	int Get_Used() const { return UsedBefore+Offset; }
+	int Get_Capacity() const { return Capacity; }
+	int Get_Frame_High_Water_Mark() const { return FrameHighWater; }		// peak bytes in use this frame
+	int Get_Last_Frame_High_Water_Mark() const { return LastFrameHighWater; }
+	int Get_High_Water_Mark() const { return HighWater; }					// peak bytes in use since creation
+	unsigned Get_Generation() const { return Generation; }
+
+	static FrameArenaClass* Get_Frame_Arena();
+
+private:
+	struct BlockStruct
+	{
+		BlockStruct* Next;
+		int Size;
+	};
+
+	static char* Block_Data(BlockStruct* block) { return (char*)(block+1); }
+
+	BlockStruct* Allocate_Block(int size);
+	void* Allocate_Slow(int size,int alignment);
+	void Free_Blocks();
+
+	BlockStruct* Head;
+	BlockStruct* Current;
+	int Offset;				// offset into the current block
+	int UsedBefore;		// bytes consumed by the blocks before the current one
+	int BlockSize;
+	int Capacity;
+	int FrameHighWater;
+	int LastFrameHighWater;
+	int HighWater;
+	unsigned Generation;
+	unsigned OwnerThreadID;
+
+	// Not copyable
+	FrameArenaClass(const FrameArenaClass&);
+	FrameArenaClass& operator=(const FrameArenaClass&);
+};
+
+WWINLINE void* FrameArenaClass::Allocate(int size,int alignment)
+{
+	if (Current) {
+		char* base=Block_Data(Current);
+		char* ptr=(char*)(((size_t)(base+Offset)+alignment-1)&~(size_t)(alignment-1));
+		int end=int(ptr-base)+size;
+		if (end<=Current->Size) {
+			Offset=end;
+			if (UsedBefore+Offset>FrameHighWater) FrameHighWater=UsedBefore+Offset;
+			return ptr;
+		}
+	}
+	return Allocate_Slow(size,alignment);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Rewinds the arena to where it was when the scope was entered. Use this
+// around code that may run many times a frame (or outside of the frame loop)
+// so its temporaries don't accumulate until the end of frame reset.
+//
+// ----------------------------------------------------------------------------
+
+class FrameArenaScopeClass
+{
+public:
+	FrameArenaScopeClass(FrameArenaClass* arena=FrameArenaClass::Get_Frame_Arena()) : Arena(arena), Mark(arena->Get_Mark()) {}
+	~FrameArenaScopeClass() { Arena->Rewind(Mark); }
+
+	FrameArenaClass* Get_Arena() { return Arena; }
+
+private:
+	FrameArenaClass* Arena;
+	FrameArenaClass::MarkStruct Mark;
+
+	FrameArenaScopeClass(const FrameArenaScopeClass&);
+	FrameArenaScopeClass& operator=(const FrameArenaScopeClass&);
+};
+
+// ----------------------------------------------------------------------------
+//
+// DynamicVectorClass whose storage comes from a frame arena. It grows
+// geometrically (old storage is simply abandoned in the arena) and must not
+// outlive the frame or the FrameArenaScopeClass it was filled in. Like
+// SimpleVecClass, only use it for memcopy-able types; element destructors
+// are never run.
+//
+// ----------------------------------------------------------------------------
+
+template <class T>
+class FrameArenaVectorClass : public DynamicVectorClass<T>
+{
+public:
+	FrameArenaVectorClass(int initial_size=0,FrameArenaClass* arena=FrameArenaClass::Get_Frame_Arena())
+		: DynamicVectorClass<T>(0), Arena(arena)
+	{
+		if (initial_size>0) Resize(initial_size);
+	}
+
+	virtual bool Resize(int newsize,T const * array=0)
+	{
+		if (array==0 && newsize>0) {
+			if (newsize>this->Length()) newsize=MAX(newsize,this->Length()*2);
+			array=Arena->Allocate_Array<T>(newsize);
+		}
+		return DynamicVectorClass<T>::Resize(newsize,array);
+	}
+
+protected:
+	virtual bool Is_Growable() const { return true; }
+
+	FrameArenaClass* Arena;
+};
+
+// ----------------------------------------------------------------------------
+//
+// STL allocator on top of a frame arena, e.g.
+// std::vector<int,FrameArenaAllocatorClass<int> > list(FrameArenaAllocatorClass<int>(arena));
+// deallocate() is a no-op; the memory is reclaimed with the arena.
+//
+// ----------------------------------------------------------------------------
+
+template <class T>
+class FrameArenaAllocatorClass
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template <class U> struct rebind { typedef FrameArenaAllocatorClass<U> other; };
+
+	FrameArenaAllocatorClass(FrameArenaClass* arena=FrameArenaClass::Get_Frame_Arena()) : Arena(arena) {}
+	template <class U> FrameArenaAllocatorClass(const FrameArenaAllocatorClass<U>& that) : Arena(that.Arena) {}
+
+	T* allocate(size_t count) { return Arena->Allocate_Array<T>(int(count)); }
+	void deallocate(T*,size_t) {}
+
+	template <class U> bool operator==(const FrameArenaAllocatorClass<U>& that) const { return Arena==that.Arena; }
+	template <class U> bool operator!=(const FrameArenaAllocatorClass<U>& that) const { return Arena!=that.Arena; }
+
+	FrameArenaClass* Arena;
+};
+
+#endif
@@ -82,6 +82,10 @@
  *   INIClass::CRC - returns a (hopefully) unique 32-bit value for a string                    *
  *    -- Displays debug information when a duplicate entry is found in an INI file             *
  *   INIClass::Enumerate_Entries -- Count how many entries begin with a certain prefix followed by a range *
+ *   INIEntry::Parse_Value -- Converts the value to the types the Get_ functions return.      *
+ *   INIBindingClass::Bind -- Adds a field to the binding.                                    *
+ *   INIBindingClass::Read -- Reads a section into the bound fields of an object.             *
+ *   INIBindingClass::Write -- Writes the bound fields of an object to a section.             *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include	"always.h"
@@ -130,6 +134,61 @@ INIEntry::~INIEntry(void)
 	Value = NULL;
 }
 
+
+/***********************************************************************************************
+ * INIEntry::Parse_Value -- Converts the value to the types the Get_ functions return.        *
+ *                                                                                             *
+ *    The conversions match what Get_Int, Get_Float and Get_Bool did with the text on every   *
+ *    call: "$1F" and "1Fh" are hex, a '%' anywhere makes Get_Float divide by 100 and a bool  *
+ *    only looks at the first character. A value that doesn't parse leaves the default.       *
+ *                                                                                             *
+ * INPUT:   none                                                                               *
+ *                                                                                             *
+ * OUTPUT:  none                                                                               *
+ *                                                                                             *
+ * WARNINGS:   none                                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void INIEntry::Parse_Value(void)
+{
+	IntValue = 0;
+	FloatValue = 0.0f;
+	Flags = 0;
+	if (Value == NULL) return;
+
+	char * end;
+	int len = strlen(Value);
+	if (*Value == '$') {
+		IntValue = (int)strtoul(Value+1, &end, 16);
+		if (end != Value+1) Flags |= INT_VALID;
+	} else if (len > 0 && tolower(Value[len-1]) == 'h') {
+		IntValue = (int)strtoul(Value, &end, 16);
+		if (end != Value) Flags |= INT_VALID;
+	} else {
+		IntValue = atoi(Value);
+		Flags |= INT_VALID;
+	}
+
+	FloatValue = strtof(Value, &end);
+	if (end != Value) Flags |= FLOAT_VALID;
+	if (strchr(Value, '%') != NULL) Flags |= FLOAT_PERCENT;
+
+	switch (toupper(*Value)) {
+		case 'Y':
+		case 'T':
+		case '1':
+			Flags |= BOOL_VALID | BOOL_TRUE;
+			break;
+
+		case 'N':
+		case 'F':
+		case '0':
+			Flags |= BOOL_VALID;
+			break;
+	}
+}
+
 INISection::~INISection(void)
 {
 	free(Section);
@@ -145,7 +204,7 @@ bool INIClass::Is_Loaded(void) const
 void INIClass::Initialize(void)
 {
 	SectionList = new List<INISection *> ();
-	SectionIndex = new IndexClass<int, INISection *> ();
+	SectionIndex = new INIIndexClass<INISection *> ();
 	Filename = nstrdup("<unknown>");
 }
 
@@ -717,16 +776,13 @@ int INIClass::Save(Pipe & pipe) const
  *   07/02/1996 JLB : Created.                                                                 *
  *   11/02/1996 JLB : Uses index manager.                                                      *
  *   12/08/1996 EHC : Uses member CRC function                                                 *
+ *              : Uses hashed index                                                            *
  *=============================================================================================*/
 INISection * INIClass::Find_Section(char const * section) const
 {
 	if (section != NULL) {
 //		long crc = CRCEngine()(section, strlen(section));
-		long crc = CRC(section);
-
-		if (SectionIndex->Is_Present(crc)) {
-			return((*SectionIndex)[crc]);
-		}
+		return(SectionIndex->Find(CRC(section)));
 	}
 	return(NULL);
 }
@@ -1321,17 +1377,8 @@ int INIClass::Get_Int(char const * section, char const * entry, int defvalue) co
 	if (section == NULL || entry == NULL) return(defvalue);
 
 	INIEntry * entryptr = Find_Entry(section, entry);
-	if (entryptr && entryptr->Value != NULL) {
-
-		if (*entryptr->Value == '$') {
-			sscanf(entryptr->Value, "$%x", &defvalue);
-		} else {
-			if (tolower(entryptr->Value[strlen(entryptr->Value)-1]) == 'h') {
-				sscanf(entryptr->Value, "%xh", &defvalue);
-			} else {
-				defvalue = atoi(entryptr->Value);
-			}
-		}
+	if (entryptr != NULL && (entryptr->Flags & INIEntry::INT_VALID)) {
+		defvalue = entryptr->IntValue;
 	}
 	return(defvalue);
 }
@@ -1493,10 +1540,10 @@ float INIClass::Get_Float(char const * section, char const * entry, float defval
 
 	INIEntry * entryptr = Find_Entry(section, entry);
 	if (entryptr != NULL && entryptr->Value != NULL) {
-		float val = defvalue;
-		sscanf(entryptr->Value, "%f", &val);
-		defvalue = val;
-		if (strchr(entryptr->Value, '%') != NULL) {
+		if (entryptr->Flags & INIEntry::FLOAT_VALID) {
+			defvalue = entryptr->FloatValue;
+		}
+		if (entryptr->Flags & INIEntry::FLOAT_PERCENT) {
 			defvalue /= 100.0f;
 		}
 	}
@@ -1561,9 +1608,11 @@ double INIClass::Get_Double(char const * section, char const * entry, double def
 	INIEntry * entryptr = Find_Entry(section, entry);
 	if (entryptr != NULL && entryptr->Value != NULL) {
 		float val = defvalue;
-		sscanf(entryptr->Value, "%f", &val);
+		if (entryptr->Flags & INIEntry::FLOAT_VALID) {
+			val = entryptr->FloatValue;
+		}
 		defvalue = val;
-		if (strchr(entryptr->Value, '%') != NULL) {
+		if (entryptr->Flags & INIEntry::FLOAT_PERCENT) {
 			defvalue /= 100.0f;
 		}
 	}
@@ -1948,18 +1997,8 @@ bool INIClass::Get_Bool(char const * section, char const * entry, bool defvalue)
 	if (section == NULL || entry == NULL) return(defvalue);
 
 	INIEntry * entryptr = Find_Entry(section, entry);
-	if (entryptr && entryptr->Value != NULL) {
-		switch (toupper(*entryptr->Value)) {
-			case 'Y':
-			case 'T':
-			case '1':
-				return(true);
-
-			case 'N':
-			case 'F':
-			case '0':
-				return(false);
-		}
+	if (entryptr != NULL && (entryptr->Flags & INIEntry::BOOL_VALID)) {
+		return((entryptr->Flags & INIEntry::BOOL_TRUE) != 0);
 	}
 	return(defvalue);
 }
@@ -2198,10 +2237,7 @@ INIEntry * INISection::Find_Entry(char const * entry) const
 {
 	if (entry != NULL) {
 //		int crc = CRCEngine()(entry, strlen(entry));
-		int crc = CRC::String(entry);
-		if (EntryIndex.Is_Present(crc)) {
-			return(EntryIndex[crc]);
-		}
+		return(EntryIndex.Find(CRC::String(entry)));
 	}
 	return(NULL);
 }
@@ -2368,3 +2404,167 @@ void	INIClass::Keep_Blank_Entries (bool keep_blanks)
 	KeepBlankEntries = keep_blanks;
 }
 
+
+
+INIBindingClass::INIBindingClass(void) :
+	Bindings(NULL),
+	BindingCount(0),
+	BindingSize(0)
+{
+}
+
+
+INIBindingClass::~INIBindingClass(void)
+{
+	for (int index = 0; index < BindingCount; index++) {
+		free(Bindings[index].Entry);
+	}
+	delete [] Bindings;
+}
+
+
+/***********************************************************************************************
+ * INIBindingClass::Bind -- Adds a field to the binding.                                       *
+ *                                                                                             *
+ * INPUT:   entry    -- The entry name the field is read from.                                 *
+ *                                                                                             *
+ *          type     -- The type of the field.                                                 *
+ *                                                                                             *
+ *          offset   -- Offset of the field in the bound structure (use offsetof).             *
+ *                                                                                             *
+ * OUTPUT:  none                                                                               *
+ *                                                                                             *
+ * WARNINGS:   none                                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void INIBindingClass::Bind(char const * entry, BindingType type, int offset)
+{
+	assert(entry != NULL);
+
+	if (BindingCount == BindingSize) {
+		BindingSize = (BindingSize == 0) ? 16 : BindingSize * 2;
+		BindingStruct * bindings = new BindingStruct[BindingSize];
+		for (int index = 0; index < BindingCount; index++) {
+			bindings[index] = Bindings[index];
+		}
+		delete [] Bindings;
+		Bindings = bindings;
+	}
+
+	BindingStruct & binding = Bindings[BindingCount++];
+	binding.Entry = strdup(entry);
+	binding.ID = CRC::String(entry);
+	binding.Type = type;
+	binding.Offset = offset;
+}
+
+
+/***********************************************************************************************
+ * INIBindingClass::Read -- Reads a section into the bound fields of an object.                *
+ *                                                                                             *
+ *    The section is looked up once and each entry by its precomputed CRC. Values are          *
+ *    converted the same way Get_Int, Get_Float, Get_Bool and Get_String do, with the          *
+ *    field's current value as the default.                                                    *
+ *                                                                                             *
+ * INPUT:   ini      -- The INI database to read from.                                         *
+ *                                                                                             *
+ *          section  -- The section to read.                                                   *
+ *                                                                                             *
+ *          object   -- The structure the fields were bound to.                                *
+ *                                                                                             *
+ * OUTPUT:  Returns with the number of bound entries present in the section.                   *
+ *                                                                                             *
+ * WARNINGS:   none                                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+int INIBindingClass::Read(INIClass const & ini, char const * section, void * object) const
+{
+	INISection * secptr = ini.Find_Section(section);
+	if (secptr == NULL || object == NULL) return(0);
+
+	int found = 0;
+	for (int index = 0; index < BindingCount; index++) {
+		BindingStruct const & binding = Bindings[index];
+		INIEntry * entryptr = secptr->EntryIndex.Find(binding.ID);
+		if (entryptr == NULL || entryptr->Value == NULL) continue;
+
+		void * field = (char *)object + binding.Offset;
+		switch (binding.Type) {
+			case TYPE_INT:
+				if (entryptr->Flags & INIEntry::INT_VALID) {
+					*(int *)field = entryptr->IntValue;
+				}
+				break;
+
+			case TYPE_FLOAT:
+				if (entryptr->Flags & INIEntry::FLOAT_VALID) {
+					*(float *)field = entryptr->FloatValue;
+				}
+				if (entryptr->Flags & INIEntry::FLOAT_PERCENT) {
+					*(float *)field /= 100.0f;
+				}
+				break;
+
+			case TYPE_BOOL:
+				if (entryptr->Flags & INIEntry::BOOL_VALID) {
+					*(bool *)field = (entryptr->Flags & INIEntry::BOOL_TRUE) != 0;
+				}
+				break;
+
+			case TYPE_STRING:
+				*(StringClass *)field = entryptr->Value;
+				break;
+		}
+		found++;
+	}
+	return(found);
+}
+
+
+/***********************************************************************************************
+ * INIBindingClass::Write -- Writes the bound fields of an object to a section.                *
+ *                                                                                             *
+ * INPUT:   ini      -- The INI database to write to.                                          *
+ *                                                                                             *
+ *          section  -- The section to write.                                                  *
+ *                                                                                             *
+ *          object   -- The structure the fields were bound to.                                *
+ *                                                                                             *
+ * OUTPUT:  Returns with the number of entries written.                                        *
+ *                                                                                             *
+ * WARNINGS:   none                                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+int INIBindingClass::Write(INIClass & ini, char const * section, void const * object) const
+{
+	if (section == NULL || object == NULL) return(0);
+
+	int written = 0;
+	for (int index = 0; index < BindingCount; index++) {
+		BindingStruct const & binding = Bindings[index];
+		void const * field = (char const *)object + binding.Offset;
+		bool ok = false;
+		switch (binding.Type) {
+			case TYPE_INT:
+				ok = ini.Put_Int(section, binding.Entry, *(int const *)field);
+				break;
+
+			case TYPE_FLOAT:
+				ok = ini.Put_Float(section, binding.Entry, *(float const *)field);
+				break;
+
+			case TYPE_BOOL:
+				ok = ini.Put_Bool(section, binding.Entry, *(bool const *)field);
+				break;
+
+			case TYPE_STRING:
+				ok = ini.Put_String(section, binding.Entry, *(StringClass const *)field);
+				break;
+		}
+		if (ok) written++;
+	}
+	return(written);
+}
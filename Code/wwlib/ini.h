@@ -65,7 +65,7 @@ template<class T> class TPoint3D;
 template<class T> class TPoint2D;
 template<class T> class TRect;
 template<class T> class List;
-template<class T, class U> class IndexClass;
+template<class T> class INIIndexClass;
 
 #ifndef NULL
 #define NULL 0L
@@ -190,7 +190,7 @@ class INIClass {
 		*/
 		List<INISection *> & Get_Section_List() { return * SectionList; }
 
-		IndexClass<int, INISection *> & Get_Section_Index() { return * SectionIndex; }
+		INIIndexClass<INISection *> & Get_Section_Index() { return * SectionIndex; }
 
 
 		/*
@@ -222,7 +222,7 @@ class INIClass {
 		*/
 		List<INISection *> * SectionList;
 
-		IndexClass<int, INISection *> * SectionIndex;
+		INIIndexClass<INISection *> * SectionIndex;
 
 		/*
 		**	Ensure that the copy constructor and assignment operator never exist.
@@ -241,4 +241,57 @@ class INIClass {
 		static bool KeepBlankEntries;
 };
 
+
+/*
+**	Binds the fields of a structure to the entries of a section so the whole section can be
+**	read into the structure with one section lookup. The entry names are hashed once, when they
+**	are bound, and a binding is usually built once and used for every object (and section) of
+**	that type. Fields whose entry is missing keep their value, so set the defaults first.
+**
+**		binding.Bind_Float("DecalSize", offsetof(SurfaceEffectClass, DecalSize));
+**		binding.Read(*ini, section_name, surface_effect);
+*/
+class INIBindingClass {
+	public:
+		INIBindingClass(void);
+		~INIBindingClass(void);
+
+		void Bind_Int(char const * entry, int offset) {Bind(entry, TYPE_INT, offset);}
+		void Bind_Float(char const * entry, int offset) {Bind(entry, TYPE_FLOAT, offset);}
+		void Bind_Bool(char const * entry, int offset) {Bind(entry, TYPE_BOOL, offset);}
+		void Bind_String(char const * entry, int offset) {Bind(entry, TYPE_STRING, offset);}		// StringClass field
+
+		int Binding_Count(void) const {return(BindingCount);}
+
+		/*
+		**	Returns the number of fields that were found in the section (or written).
+		*/
+		int Read(INIClass const & ini, char const * section, void * object) const;
+		int Write(INIClass & ini, char const * section, void const * object) const;
+
+	private:
+		enum BindingType {
+			TYPE_INT,
+			TYPE_FLOAT,
+			TYPE_BOOL,
+			TYPE_STRING
+		};
+
+		struct BindingStruct {
+			char * Entry;
+			int ID;
+			BindingType Type;
+			int Offset;
+		};
+
+		void Bind(char const * entry, BindingType type, int offset);
+
+		BindingStruct * Bindings;
+		int BindingCount;
+		int BindingSize;
+
+		INIBindingClass(INIBindingClass const & rvalue);
+		INIBindingClass operator = (INIBindingClass const & rvalue);
+};
+
 #endif
\ No newline at end of file
@@ -46,22 +46,62 @@
 
 #include	"listnode.h"
 #include	"index.h"
+#include "hashtemplate.h"
 #include "crc.h"
 
 
+/*
+**	Sections and entries are indexed by the CRC of their name in a hash table. Unlike
+**	IndexClass it never needs sorting and a lookup doesn't write anything, so a loaded
+**	INI can be read from more than one thread.
+*/
+template<class T>
+class INIIndexClass {
+	public:
+		INIIndexClass(void) : IndexCount(0) {}
+
+		bool Add_Index(int id, T data) {Table.Insert(id, data);IndexCount++;return(true);}
+		bool Remove_Index(int id) {if (!Table.Exists(id)) return(false);Table.Remove(id);IndexCount--;return(true);}
+		bool Is_Present(int id) const {return(Table.Exists(id));}
+		T Find(int id) const {T data = NULL;Table.Get(id, data);return(data);}
+		int Count(void) const {return(IndexCount);}
+		void Clear(void) {Table.Remove_All();IndexCount = 0;}
+
+	private:
+		HashTemplateClass<int, T> Table;
+		int IndexCount;
+};
+
+
 /*
 **	The value entries for the INI file are stored as objects of this type.
 **	The entry identifier and value string are combined into this object.
 */
 struct INIEntry : public Node<INIEntry *> {
-	INIEntry(char * entry = NULL, char * value = NULL) : Entry(entry), Value(value) {}
+	INIEntry(char * entry = NULL, char * value = NULL) : Entry(entry), Value(value) {Parse_Value();}
 	~INIEntry(void);
 //	~INIEntry(void) {free(Entry);Entry = NULL;free(Value);Value = NULL;}
 //	int Index_ID(void) const {return(CRCEngine()(Entry, strlen(Entry)));};
 	int Index_ID(void) const { return CRC::String(Entry);};
 
+	/*
+	**	The value is converted to the common types once, when the entry is created. Writing
+	**	an entry replaces it, so the converted values are never stale.
+	*/
+	enum {
+		INT_VALID		= 0x01,
+		FLOAT_VALID		= 0x02,
+		FLOAT_PERCENT	= 0x04,		// value contains a '%', Get_Float divides by 100
+		BOOL_VALID		= 0x08,
+		BOOL_TRUE		= 0x10
+	};
+	void Parse_Value(void);
+
 	char * Entry;
 	char * Value;
+	int IntValue;
+	float FloatValue;
+	int Flags;
 };
 
 /*
@@ -78,7 +118,7 @@ struct INISection : public Node<INISection *> {
 
 		char * Section;
 		List<INIEntry *> EntryList;
-		IndexClass<int, INIEntry *> EntryIndex;
+		INIIndexClass<INIEntry *> EntryIndex;
 
 	private:
 		INISection(INISection const & rvalue);
@@ -0,0 +1,194 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "always.h"
+#include "memfile.h"
+#include <string.h>
+
+
+MemoryFileClass::MemoryFileClass(int reserve) :
+	Buffer(NULL),
+	MaxLength(0),
+	Length(0),
+	Offset(0),
+	IsOpen(false)
+{
+	if (reserve > 0) {
+		Reserve(reserve);
+	}
+}
+
+MemoryFileClass::~MemoryFileClass(void)
+{
+	Free();
+}
+
+void MemoryFileClass::Reserve(int size)
+{
+	if (size <= MaxLength) {
+		return;
+	}
+
+	//
+	// Grow by at least half again so long files don't copy on every write
+	//
+	int newmax = MaxLength + (MaxLength >> 1);
+	if (newmax < size) {
+		newmax = size;
+	}
+	if (newmax < 256) {
+		newmax = 256;
+	}
+
+	unsigned char * newbuf = new unsigned char[newmax];
+	if (Length > 0) {
+		memcpy(newbuf,Buffer,Length);
+	}
+	delete [] Buffer;
+	Buffer = newbuf;
+	MaxLength = newmax;
+}
+
+void MemoryFileClass::Free(void)
+{
+	delete [] Buffer;
+	Buffer = NULL;
+	MaxLength = 0;
+	Length = 0;
+	Offset = 0;
+}
+
+int MemoryFileClass::Create(void)
+{
+	if (!Is_Open()) {
+		Length = 0;
+		return(true);
+	}
+	return(false);
+}
+
+int MemoryFileClass::Delete(void)
+{
+	return Create();
+}
+
+bool MemoryFileClass::Is_Available(int)
+{
+	return(true);
+}
+
+bool MemoryFileClass::Is_Open(void) const
+{
+	return(IsOpen);
+}
+
+int MemoryFileClass::Open(char const *, int access)
+{
+	return(Open(access));
+}
+
+int MemoryFileClass::Open(int access)
+{
+	if (Is_Open()) {
+		return(false);
+	}
+
+	if (access == WRITE) {
+		Length = 0;
+	}
+	Offset = 0;
+	IsOpen = true;
+	return(true);
+}
+
+int MemoryFileClass::Read(void * buffer, int size)
+{
+	if (buffer == NULL || size <= 0 || !Is_Open()) {
+		return(0);
+	}
+
+	int avail = Length - Offset;
+	if (size > avail) {
+		size = avail;
+	}
+	if (size <= 0) {
+		return(0);
+	}
+
+	memcpy(buffer,Buffer + Offset,size);
+	Offset += size;
+	return(size);
+}
+
+int MemoryFileClass::Seek(int pos, int dir)
+{
+	if (!Is_Open()) {
+		return(Offset);
+	}
+
+	switch (dir) {
+		case SEEK_CUR:
+			pos += Offset;
+			break;
+
+		case SEEK_END:
+			pos += Length;
+			break;
+
+		default:
+			break;
+	}
+
+	if (pos < 0) {
+		pos = 0;
+	}
+	Offset = pos;
+	return(Offset);
+}
+
+int MemoryFileClass::Size(void)
+{
+	return(Length);
+}
+
+int MemoryFileClass::Write(void const * buffer, int size)
+{
+	if (buffer == NULL || size <= 0 || !Is_Open()) {
+		return(0);
+	}
+
+	int end = Offset + size;
+	Reserve(end);
+
+	if (Offset > Length) {
+		memset(Buffer + Length,0,Offset - Length);
+	}
+
+	memcpy(Buffer + Offset,buffer,size);
+	Offset = end;
+	if (end > Length) {
+		Length = end;
+	}
+	return(size);
+}
+
+void MemoryFileClass::Close(void)
+{
+	IsOpen = false;
+}
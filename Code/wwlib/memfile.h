@@ -0,0 +1,87 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef MEMFILE_H
+#define MEMFILE_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "wwfile.h"
+
+// ----------------------------------------------------------------------------
+//
+// MemoryFileClass is a "file" that lives in a heap buffer which grows as it is
+// written, for building files in memory when the final size isn't known, such
+// as a ChunkSaveClass writing into a buffer that is copied somewhere else
+// later. Unlike RAMFileClass the buffer always belongs to the object.
+//
+// Seeking past the end and writing fills the gap with zeros. Open() for WRITE
+// empties the file but keeps the buffer, so one object can be reused for many
+// files without reallocating.
+//
+// ----------------------------------------------------------------------------
+
+class MemoryFileClass : public FileClass
+{
+public:
+	MemoryFileClass(int reserve = 0);
+	virtual ~MemoryFileClass(void);
+
+	virtual char const * File_Name(void) const {return("UNKNOWN");}
+	virtual char const * Set_Name(char const * ) {return(File_Name());}
+	virtual int Create(void);
+	virtual int Delete(void);
+	virtual bool Is_Available(int forced=false);
+	virtual bool Is_Open(void) const;
+	virtual int Open(char const * filename, int access=READ);
+	virtual int Open(int access=READ);
+	virtual int Read(void * buffer, int size);
+	virtual int Seek(int pos, int dir=SEEK_CUR);
+	virtual int Size(void);
+	virtual int Write(void const * buffer, int size);
+	virtual void Close(void);
+	virtual void Error(int , int = false, char const * =NULL) {}
+	virtual void Bias(int , int =-1) {}
+
+	// The contents of the file, valid until the next write or Free()
+	const unsigned char * Get_Buffer(void) const { return Buffer; }
+	int Get_Length(void) const { return Length; }
+
+	// Make sure the buffer can hold at least this many bytes
+	void Reserve(int size);
+
+	// Release the buffer
+	void Free(void);
+
+private:
+
+	unsigned char *	Buffer;
+	int					MaxLength;
+	int					Length;
+	int					Offset;
+	bool					IsOpen;
+
+	// Not Implemented
+	MemoryFileClass(const MemoryFileClass &);
+	MemoryFileClass & operator=(const MemoryFileClass &);
+};
+
+#endif
@@ -38,6 +38,7 @@
  *   ObjectPoolClass::Free_Object -- releases obj back into the pool                           *
  *   ObjectPoolClass::Allocate_Object_Memory -- internal function which returns memory for an  *
  *   ObjectPoolClass::Free_Object_Memory -- internal function, returns object's memory to the  *
+ *   ObjectPoolClass::Get_Allocated_Object_Count -- number of objects currently handed out     *
  *   AutoPoolClass::operator new -- overriden new which calls the internal ObjectPool          *
  *   AutoPoolClass::operator delete -- overriden delete which calls the internal ObjectPool    *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
@@ -53,6 +54,7 @@
 #include "bittype.h"
 #include "wwdebug.h"
 #include "mutex.h"
+#include "threadcache.h"
 #include <new.h>
 #include <stdlib.h>
 #include <stddef.h>
@@ -73,9 +75,30 @@
 ** ListNodeClass * node = NodePool.Allocate_Object();
 ** NodePool.Free_Object(node);
 **
+** Pools normally share one free list protected by a lock. Set THREAD_CACHED for pools
+** which are hit from several threads at once; each thread then allocates from its own
+** cache (see ThreadCachedAllocatorClass) and the lock is never taken.
+**
 **********************************************************************************************/
-template<class T,int BLOCK_SIZE = 64> 
-class ObjectPoolClass
+
+/*
+** Only thread cached pools carry a ThreadCachedAllocatorClass; for the others this base
+** is empty.
+*/
+template<bool THREAD_CACHED>
+class ObjectPoolThreadCacheClass
+{
+};
+
+template<>
+class ObjectPoolThreadCacheClass<true>
+{
+protected:
+	ThreadCachedAllocatorClass	ThreadCache;
+};
+
+template<class T,int BLOCK_SIZE = 64,bool THREAD_CACHED = false> 
+class ObjectPoolClass : public ObjectPoolThreadCacheClass<THREAD_CACHED>
 {
 public:
 
@@ -88,6 +111,8 @@ public:
 	T *		Allocate_Object_Memory(void);
 	void		Free_Object_Memory(T * obj);
 
+	int		Get_Allocated_Object_Count(void) const;
+
 protected:
 
 	T	*		FreeListHead;			
@@ -127,13 +152,16 @@ protected:
 ** ListNode.cpp:
 ** DEFINE_AUTO_POOL(ListNodeClass);	
 **
+** Use AutoPoolClass<T,BLOCK_SIZE,true> and DEFINE_THREAD_CACHED_AUTO_POOL for a thread
+** cached pool.
+**
 ** function do_stuff(void) {
 **		ListNodeClass * node = new ListNodeClass;
 **		delete node;
 ** }
 **
 **********************************************************************************************/
-template<class T, int BLOCK_SIZE = 64> 
+template<class T, int BLOCK_SIZE = 64, bool THREAD_CACHED = false> 
 class AutoPoolClass 
 {
 public:
@@ -148,7 +176,7 @@ private:
 	static void		operator delete[] (void * memory);
 
 	// This must be staticly declared by user
-	static ObjectPoolClass<T,BLOCK_SIZE>	Allocator;
+	static ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>	Allocator;
 
 };
 
@@ -160,6 +188,9 @@ private:
 #define DEFINE_AUTO_POOL(T,BLOCKSIZE) \
 ObjectPoolClass<T,BLOCKSIZE> AutoPoolClass<T,BLOCKSIZE>::Allocator;
 
+#define DEFINE_THREAD_CACHED_AUTO_POOL(T,BLOCKSIZE) \
+ObjectPoolClass<T,BLOCKSIZE,true> AutoPoolClass<T,BLOCKSIZE,true>::Allocator;
+
 
 /***********************************************************************************************
  * ObjectPoolClass::ObjectPoolClass -- constructor for ObjectPoolClass                         *
@@ -174,13 +205,16 @@ ObjectPoolClass<T,BLOCKSIZE> AutoPoolClass<T,BLOCKSIZE>::Allocator;
  *                                                                                             *
  * HISTORY:                                                                                    *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE> 
-ObjectPoolClass<T,BLOCK_SIZE>::ObjectPoolClass(void) : 
+template<class T,int BLOCK_SIZE,bool THREAD_CACHED> 
+ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::ObjectPoolClass(void) : 
 	FreeListHead(NULL),
 	BlockListHead(NULL),
 	FreeObjectCount(0),
 	TotalObjectCount(0) 
 { 
+	if constexpr (THREAD_CACHED) {
+		this->ThreadCache.Init(sizeof(T),BLOCK_SIZE);
+	}
 }
 	
 /***********************************************************************************************
@@ -196,11 +230,14 @@ ObjectPoolClass<T,BLOCK_SIZE>::ObjectPoolClass(void) :
  *                                                                                             *
  * HISTORY:                                                                                    *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE> 
-ObjectPoolClass<T,BLOCK_SIZE>::~ObjectPoolClass(void)
+template<class T,int BLOCK_SIZE,bool THREAD_CACHED> 
+ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::~ObjectPoolClass(void)
 {
 	// assert that the user gave back all of the memory he was using
 	WWASSERT(FreeObjectCount == TotalObjectCount);
+	if constexpr (THREAD_CACHED) {
+		WWASSERT(this->ThreadCache.Get_Allocation_Count() == 0);
+	}
 
 	// delete all of the blocks we allocated
 	int block_count = 0;
@@ -229,8 +266,8 @@ ObjectPoolClass<T,BLOCK_SIZE>::~ObjectPoolClass(void)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE> 
-T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object(void)
+template<class T,int BLOCK_SIZE,bool THREAD_CACHED> 
+T * ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::Allocate_Object(void)
 {
 	// allocate memory for the object
 	T * obj = Allocate_Object_Memory();
@@ -251,8 +288,8 @@ T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object(void)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE> 
-void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object(T * obj)
+template<class T,int BLOCK_SIZE,bool THREAD_CACHED> 
+void ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::Free_Object(T * obj)
 {
 	// destruct the object
 	obj->T::~T();
@@ -273,9 +310,13 @@ void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object(T * obj)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE> 
-T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object_Memory(void)
+template<class T,int BLOCK_SIZE,bool THREAD_CACHED> 
+T * ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::Allocate_Object_Memory(void)
 {
+	if constexpr (THREAD_CACHED) {
+		return (T*)this->ThreadCache.Alloc();
+	}
+
 	FastCriticalSectionClass::LockClass lock(ObjectPoolCS);
 
 	if ( FreeListHead == 0 ) {  
@@ -317,18 +358,45 @@ T * ObjectPoolClass<T,BLOCK_SIZE>::Allocate_Object_Memory(void)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T,int BLOCK_SIZE> 
-void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object_Memory(T * obj)
+template<class T,int BLOCK_SIZE,bool THREAD_CACHED> 
+void ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::Free_Object_Memory(T * obj)
 {
+	WWASSERT(obj != NULL);
+	if constexpr (THREAD_CACHED) {
+		this->ThreadCache.Free(obj);
+		return;
+	}
+
 	FastCriticalSectionClass::LockClass lock(ObjectPoolCS);
 
-	WWASSERT(obj != NULL);
 	*(T**)(obj) = FreeListHead;		// Link to the Head
 	FreeListHead = obj;					// Set the Head
 	FreeObjectCount++;
 }
 
 
+/***********************************************************************************************
+ * ObjectPoolClass::Get_Allocated_Object_Count -- number of objects currently handed out       *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T,int BLOCK_SIZE,bool THREAD_CACHED> 
+int ObjectPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::Get_Allocated_Object_Count(void) const
+{
+	if constexpr (THREAD_CACHED) {
+		return (int)this->ThreadCache.Get_Allocation_Count();
+	} else {
+		return TotalObjectCount - FreeObjectCount;
+	}
+}
+
+
 /***********************************************************************************************
  * AutoPoolClass::operator new -- overriden new which calls the internal ObjectPool            *
  *                                                                                             *
@@ -341,8 +409,8 @@ void ObjectPoolClass<T,BLOCK_SIZE>::Free_Object_Memory(T * obj)
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T, int BLOCK_SIZE>
-void * AutoPoolClass<T,BLOCK_SIZE>::operator new( size_t size ) 
+template<class T, int BLOCK_SIZE, bool THREAD_CACHED>
+void * AutoPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::operator new( size_t size ) 
 {
 	WWASSERT(size == sizeof(T));
 	return (void *)(Allocator.Allocate_Object_Memory());
@@ -361,8 +429,8 @@ void * AutoPoolClass<T,BLOCK_SIZE>::operator new( size_t size )
  * HISTORY:                                                                                    *
  *   7/29/99    GTH : Created.                                                                 *
  *=============================================================================================*/
-template<class T, int BLOCK_SIZE>
-void AutoPoolClass<T,BLOCK_SIZE>::operator delete( void * memory ) 
+template<class T, int BLOCK_SIZE, bool THREAD_CACHED>
+void AutoPoolClass<T,BLOCK_SIZE,THREAD_CACHED>::operator delete( void * memory ) 
 {
 	if ( memory == 0 ) return;
 	Allocator.Free_Object_Memory((T*)memory);
@@ -0,0 +1,170 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "nametable.h"
+#include "mutex.h"
+#include "wwdebug.h"
+#include <windows.h>
+#include <string.h>
+
+
+// ----------------------------------------------------------------------------
+//
+// The table is a fixed array of buckets, each a singly linked list with the
+// newest entry at the head. Entries are written completely before they are
+// linked in and are never unlinked, so a reader walking a bucket always sees
+// a valid list without taking the lock. Writers hold _NameLock, re-check the
+// bucket and publish the new head with an interlocked exchange.
+//
+// Entries are carved from large blocks that are never freed.
+//
+// ----------------------------------------------------------------------------
+
+enum {
+	NAME_HASH_TABLE_SIZE=8192,
+	NAME_HASH_MASK=NAME_HASH_TABLE_SIZE-1,
+	NAME_BLOCK_SIZE=32*1024
+};
+
+static void * volatile				_NameTable[NAME_HASH_TABLE_SIZE];
+static FastCriticalSectionClass	_NameLock;
+static char *							_NameBlock;
+static int								_NameBlockUsed=NAME_BLOCK_SIZE;
+static int								_NameCount;
+static int								_NameMemory;
+
+
+static inline unsigned char Fold_Case(char ch)
+{
+	unsigned char c=(unsigned char)ch;
+	return ((c>='A') && (c<='Z')) ? (unsigned char)(c+('a'-'A')) : c;
+}
+
+static bool Names_Match(const char * a,const char * b,int length)
+{
+	for (int i=0;i<length;i++) {
+		if (Fold_Case(a[i])!=Fold_Case(b[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void * Allocate_Entry(int size)
+{
+	size=(size+7)&~7;
+	_NameMemory+=size;
+
+	// Names too long to share a block get one of their own
+	if (size>NAME_BLOCK_SIZE/4) {
+		return new char[size];
+	}
+
+	if (_NameBlockUsed+size>NAME_BLOCK_SIZE) {
+		_NameBlock=new char[NAME_BLOCK_SIZE];
+		_NameBlockUsed=0;
+	}
+	void * entry=_NameBlock+_NameBlockUsed;
+	_NameBlockUsed+=size;
+	return entry;
+}
+
+
+/*
+** FNV-1a over the lower case characters
+*/
+unsigned NameClass::Hash(const char * name,int * length)
+{
+	unsigned hash=2166136261u;
+	const char * ch=name;
+	while (*ch!=0) {
+		hash^=Fold_Case(*ch++);
+		hash*=16777619u;
+	}
+	if (length!=NULL) {
+		*length=int(ch-name);
+	}
+	return hash;
+}
+
+const NameClass::EntryStruct * NameClass::Find_Entry(const char * name,unsigned hash,int length)
+{
+	const EntryStruct * entry=(const EntryStruct *)_NameTable[hash&NAME_HASH_MASK];
+	while (entry!=NULL) {
+		if ((entry->Hash==hash) && (entry->Length==length) && Names_Match(entry->Name,name,length)) {
+			return entry;
+		}
+		entry=entry->Next;
+	}
+	return NULL;
+}
+
+NameClass::NameClass(const char * name) : Entry(NULL)
+{
+	WWASSERT(name!=NULL);
+	if (name==NULL) {
+		return;
+	}
+
+	int length;
+	unsigned hash=Hash(name,&length);
+	Entry=Find_Entry(name,hash,length);
+	if (Entry!=NULL) {
+		return;
+	}
+
+	FastCriticalSectionClass::LockClass lock(_NameLock);
+
+	// Someone may have added it while we were waiting for the lock
+	Entry=Find_Entry(name,hash,length);
+	if (Entry==NULL) {
+		EntryStruct * entry=(EntryStruct *)Allocate_Entry(int(sizeof(EntryStruct))+length);
+		entry->Hash=hash;
+		entry->Length=length;
+		::memcpy(entry->Name,name,length+1);
+
+		void * volatile * bucket=&_NameTable[hash&NAME_HASH_MASK];
+		entry->Next=(EntryStruct *)*bucket;
+		::InterlockedExchangePointer((void **)bucket,entry);
+
+		_NameCount++;
+		Entry=entry;
+	}
+}
+
+NameClass NameClass::Find(const char * name)
+{
+	if (name==NULL) {
+		return NameClass();
+	}
+
+	int length;
+	unsigned hash=Hash(name,&length);
+	return NameClass(Find_Entry(name,hash,length));
+}
+
+int NameClass::Get_Name_Count()
+{
+	return _NameCount;
+}
+
+int NameClass::Get_Memory_Used()
+{
+	return _NameMemory+int(sizeof(_NameTable));
+}
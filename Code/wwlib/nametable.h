@@ -0,0 +1,87 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef NAMETABLE_H
+#define NAMETABLE_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+
+// ----------------------------------------------------------------------------
+//
+// NameClass is a handle to an interned, case insensitive name. Every
+// spelling of a name ("Weapon.W3D", "weapon.w3d") maps to the same entry in
+// a global table, so two names compare equal exactly when their handles do
+// and the hash is computed once when the name is interned.
+//
+// Constructing a NameClass from a string adds it to the table. Find() only
+// looks a string up, which is what lookups by name want: a string that was
+// never interned can't be the name of anything.
+//
+// Entries are never freed. The table is meant for asset, definition and
+// sound names, not for arbitrary text. Lookups take no lock; adding a name
+// takes a short lock so names can be interned from loader threads.
+//
+// ----------------------------------------------------------------------------
+
+class NameClass
+{
+public:
+	NameClass() : Entry(NULL) {}
+	explicit NameClass(const char * name);
+
+	// The interned name, or an empty handle if the name was never interned
+	static NameClass Find(const char * name);
+
+	bool Is_Empty() const { return Entry==NULL; }
+
+	// The first spelling that was interned
+	const char * Peek_Name() const { return (Entry!=NULL) ? Entry->Name : ""; }
+	int Get_Length() const { return (Entry!=NULL) ? Entry->Length : 0; }
+	unsigned Get_Hash() const { return (Entry!=NULL) ? Entry->Hash : 0; }
+
+	bool operator==(const NameClass & that) const { return Entry==that.Entry; }
+	bool operator!=(const NameClass & that) const { return Entry!=that.Entry; }
+
+	// Case insensitive hash of a string, the same one Get_Hash() returns
+	static unsigned Hash(const char * name,int * length=NULL);
+
+	static int Get_Name_Count();
+	static int Get_Memory_Used();
+
+private:
+	struct EntryStruct
+	{
+		EntryStruct * volatile	Next;
+		unsigned						Hash;
+		int							Length;
+		char							Name[1];
+	};
+
+	NameClass(const EntryStruct * entry) : Entry(entry) {}
+
+	static const EntryStruct * Find_Entry(const char * name,unsigned hash,int length);
+
+	const EntryStruct * Entry;
+};
+
+#endif
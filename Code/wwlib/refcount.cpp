@@ -40,6 +40,7 @@
 
 
 #include "refcount.h"
+#include "mutex.h"
 #include <windows.h>
 
 
@@ -50,9 +51,15 @@
 /*
 ** Static variables for the reference counting system
 */
-int							RefCountClass::TotalRefs = 0;
+long							RefCountClass::TotalRefs = 0;
 RefCountListClass			RefCountClass::ActiveRefList;
 
+/*
+** Objects can be created and destroyed on worker threads (see RefCountClass).  The
+** total is kept with interlocked operations and only the active ref list is locked.
+*/
+static FastCriticalSectionClass	ActiveRefLock;
+
 
 
 /***********************************************************************************************
@@ -69,9 +76,12 @@ RefCountListClass			RefCountClass::ActiveRefList;
  *=============================================================================================*/
 RefCountClass *	RefCountClass::Add_Active_Ref(RefCountClass *obj) 
 { 
-	ActiveRefList.Add_Head(&(obj->ActiveRefNode)); 
 	obj->ActiveRefInfo.File = NULL;	// default to no debug information added.
 	obj->ActiveRefInfo.Line = 0;
+	{
+		FastCriticalSectionClass::LockClass lock(ActiveRefLock);
+		ActiveRefList.Add_Head(&(obj->ActiveRefNode)); 
+	}
 	return obj;
 }
 
@@ -117,6 +127,7 @@ void RefCountClass::Remove_Active_Ref(RefCountClass * obj)
 #ifdef PARANOID_REFCOUNTS
 	assert(Validate_Active_Ref(obj));
 #endif
+	FastCriticalSectionClass::LockClass lock(ActiveRefLock);
 	obj->ActiveRefNode.Unlink(); 
 }
 
@@ -134,6 +145,7 @@ void RefCountClass::Remove_Active_Ref(RefCountClass * obj)
  *=============================================================================================*/
 bool RefCountClass::Validate_Active_Ref(RefCountClass * obj)
 {
+	FastCriticalSectionClass::LockClass lock(ActiveRefLock);
 	RefCountNodeClass *node = ActiveRefList.First();
 	while (node) {
 		if (node->Get() == obj) return true;
@@ -159,8 +171,7 @@ void	RefCountClass::Inc_Total_Refs(RefCountClass * obj)
 #ifdef PARANOID_REFCOUNTS
 	assert(Validate_Active_Ref(obj));
 #endif
-	TotalRefs++;
-
+	::InterlockedIncrement(&TotalRefs);
 }
 
 // SKB 7/21/99 Set BreakOnRefernce to a pointer and it will break when called.
@@ -197,7 +208,7 @@ void	RefCountClass::Dec_Total_Refs(RefCountClass * obj)
 #ifdef PARANOID_REFCOUNTS
 	assert(Validate_Active_Ref(obj));
 #endif
-	TotalRefs--;
+	::InterlockedDecrement(&TotalRefs);
 
 	// See if programmer set break on for a specific address.
 	if (obj == BreakOnReference) {
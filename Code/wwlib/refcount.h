@@ -96,6 +96,13 @@ struct ActiveRefStruct
 **			if you keep the pointer, you MUST Add_Ref() and Release_Ref() it
 **			otherwise, you DO NOT Add_Ref() or Release_Ref() it
 **
+**		The reference count itself is not atomic.  An object may be created and
+**			released on any thread (e.g. a WorkerPoolClass job), but only one
+**			thread at a time may Add_Ref() or Release_Ref() it; hand it to another
+**			thread only after the first one is done with it (e.g. after waiting
+**			on the job).  The debug-only totals and active ref list are shared and
+**			are safe to update from any thread.
+**
 */
 
 typedef DataNode<RefCountClass *>	RefCountNodeClass;
@@ -170,7 +177,7 @@ public:
 	** of references that have been made.  Once you've released all of your
 	** objects, it should go to zero.  
 	*/
-	static int			Total_Refs(void)							{ return TotalRefs; }
+	static int			Total_Refs(void)							{ return (int)TotalRefs; }
 
 protected:
 
@@ -196,7 +203,7 @@ private:
 	** Sum of all references to RefCountClass's.  Should equal zero after
 	** everything has been released.
 	*/
-	static int			TotalRefs;
+	static long			TotalRefs;
 
 	/*
 	** increments the total reference count
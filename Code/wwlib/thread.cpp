@@ -21,6 +21,8 @@
 #include "thread.h"
 #include "except.h"
 #include "wwdebug.h"
+#include "wwprofile.h"
+#include "threadcache.h"
 #include <process.h>
 #include <windows.h>
 #pragma warning ( push )
@@ -51,6 +53,7 @@ void __cdecl ThreadClass::Internal_Thread_Function(void* params)
 	ThreadClass* tc=reinterpret_cast<ThreadClass*>(params);
 	tc->running=true;
 	tc->ThreadID = GetCurrentThreadId();
+	WWProfileManager::Set_Thread_Name(tc->ThreadName);
 
 #ifdef _WIN32
 	Register_Thread_ID(tc->ThreadID, tc->ThreadName);
@@ -67,6 +70,12 @@ void __cdecl ThreadClass::Internal_Thread_Function(void* params)
 	tc->Thread_Function();
 #endif //_WIN32
 
+	// Hand this thread's cached pool memory back to the shared depots
+	ThreadCachedAllocatorClass::Flush_Thread_Caches();
+
+	// Let another thread reuse this one's profile trace buffer
+	WWProfileManager::Release_Thread_Trace_Buffer();
+
 #ifdef _WIN32
 	Unregister_Thread_ID(tc->ThreadID, tc->ThreadName);
 #endif // _WIN32
@@ -0,0 +1,397 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "threadcache.h"
+#include "mutex.h"
+#include "wwdebug.h"
+#include <windows.h>
+#include <malloc.h>
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+//
+// All of the allocator's own memory comes from malloc rather than new, because
+// FastAllocatorGeneral may be sitting underneath the global operator new.
+//
+// Each thread has one table holding its caches for every allocator slot. The
+// tables are kept in a list so that statistics can be gathered and so that a
+// destroyed allocator can clear its slot in every thread.
+//
+// ----------------------------------------------------------------------------
+
+struct ThreadCachedAllocatorClass::ThreadTableStruct
+{
+	CacheStruct Caches[MAX_ALLOCATORS];		// must come first, _ThreadCaches points at it
+	ThreadTableStruct* Next;
+	ThreadTableStruct* Prev;
+};
+
+static ThreadCachedAllocatorClass* _Allocators[ThreadCachedAllocatorClass::MAX_ALLOCATORS];
+static FastCriticalSectionClass _RegistryLock;
+
+ThreadCachedAllocatorClass::ThreadTableStruct* ThreadCachedAllocatorClass::_ThreadTables;
+__declspec(thread) ThreadCachedAllocatorClass::CacheStruct* ThreadCachedAllocatorClass::_ThreadCaches;
+
+static inline unsigned Stack_Index(__int64 head) { return (unsigned)(head&0xffffffff); }
+static inline unsigned Stack_Tag(__int64 head) { return (unsigned)(head>>32); }
+static inline __int64 Make_Stack_Head(unsigned index,unsigned tag) { return ((__int64)tag<<32)|index; }
+
+
+// ----------------------------------------------------------------------------
+
+ThreadCachedAllocatorClass::ThreadCachedAllocatorClass(unsigned object_size,unsigned objects_per_chunk)
+	:
+	ObjectSize(0),
+	ChunkSize(0),
+	ObjectsPerChunk(0),
+	Slot(-1),
+	Chunks(NULL),
+	ChunkCount(0),
+	RetiredCount(0),
+	MagazineCount(0)
+{
+	FullMagazines.Head=0;
+	EmptyMagazines.Head=0;
+	memset((void*)Segments,0,sizeof(Segments));
+
+	if (object_size>0) {
+		Init(object_size,objects_per_chunk);
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// Object sizes are rounded up to pointer alignment. The allocator takes a
+// slot in every thread's cache table.
+//
+// ----------------------------------------------------------------------------
+
+void ThreadCachedAllocatorClass::Init(unsigned object_size,unsigned objects_per_chunk)
+{
+	WWASSERT(Slot<0);
+
+	ObjectSize=(MAX(object_size,(unsigned)sizeof(void*))+sizeof(void*)-1)&~(sizeof(void*)-1);
+	ObjectsPerChunk=MAX(objects_per_chunk,1u);
+	ChunkSize=sizeof(void*)+ObjectsPerChunk*ObjectSize;
+
+	FastCriticalSectionClass::LockClass lock(_RegistryLock);
+	for (int i=0;i<MAX_ALLOCATORS;++i) {
+		if (_Allocators[i]==NULL) {
+			_Allocators[i]=this;
+			Slot=i;
+			break;
+		}
+	}
+	WWASSERT(Slot>=0);
+}
+
+ThreadCachedAllocatorClass::~ThreadCachedAllocatorClass()
+{
+	if (Slot>=0) {
+		FastCriticalSectionClass::LockClass lock(_RegistryLock);
+		for (ThreadTableStruct* table=_ThreadTables;table;table=table->Next) {
+			memset(&table->Caches[Slot],0,sizeof(CacheStruct));
+		}
+		_Allocators[Slot]=NULL;
+	}
+
+	void* chunk=Chunks;
+	while (chunk) {
+		void* next=*(void**)chunk;
+		::free(chunk);
+		chunk=next;
+	}
+	for (int i=0;i<MAX_SEGMENTS;++i) {
+		::free(Segments[i]);
+	}
+}
+
+// ----------------------------------------------------------------------------
+//
+// The calling thread's cache table is created on its first allocation.
+//
+// ----------------------------------------------------------------------------
+
+ThreadCachedAllocatorClass::CacheStruct* ThreadCachedAllocatorClass::Create_Thread_Caches()
+{
+	ThreadTableStruct* table=(ThreadTableStruct*)::malloc(sizeof(ThreadTableStruct));
+	memset(table,0,sizeof(ThreadTableStruct));
+
+	{
+		FastCriticalSectionClass::LockClass lock(_RegistryLock);
+		table->Next=_ThreadTables;
+		if (_ThreadTables) _ThreadTables->Prev=table;
+		_ThreadTables=table;
+	}
+
+	_ThreadCaches=table->Caches;
+	return _ThreadCaches;
+}
+
+void ThreadCachedAllocatorClass::Flush_Thread_Caches()
+{
+	if (_ThreadCaches==NULL) return;
+	ThreadTableStruct* table=(ThreadTableStruct*)_ThreadCaches;
+
+	{
+		FastCriticalSectionClass::LockClass lock(_RegistryLock);
+		for (int i=0;i<MAX_ALLOCATORS;++i) {
+			ThreadCachedAllocatorClass* allocator=_Allocators[i];
+			if (allocator==NULL) continue;
+
+			CacheStruct& cache=_ThreadCaches[i];
+			if (cache.Loaded) allocator->Release_Magazine(cache.Loaded);
+			if (cache.Previous) allocator->Release_Magazine(cache.Previous);
+			InterlockedExchangeAdd(&allocator->RetiredCount,cache.AllocCount-cache.FreeCount);
+		}
+
+		if (table->Prev) table->Prev->Next=table->Next;
+		else _ThreadTables=table->Next;
+		if (table->Next) table->Next->Prev=table->Prev;
+	}
+
+	_ThreadCaches=NULL;
+	::free(table);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Threads that were not started through ThreadClass (thread pools, threads
+// created by the OS or by third party code) never call Flush_Thread_Caches()
+// themselves. This TLS callback runs in every thread as it exits and returns
+// its magazines to the depots. Flushing twice is harmless.
+//
+// ----------------------------------------------------------------------------
+
+#ifdef _MSC_VER
+static void NTAPI Thread_Cache_Exit_Callback(PVOID module,DWORD reason,PVOID reserved)
+{
+	if (reason==DLL_THREAD_DETACH) {
+		ThreadCachedAllocatorClass::Flush_Thread_Caches();
+	}
+}
+
+#ifdef _M_IX86
+#pragma comment(linker,"/INCLUDE:__tls_used")
+#pragma comment(linker,"/INCLUDE:_ThreadCacheExitCallback")
+#else
+#pragma comment(linker,"/INCLUDE:_tls_used")
+#pragma comment(linker,"/INCLUDE:ThreadCacheExitCallback")
+#endif
+
+#pragma data_seg(".CRT$XLB")
+extern "C" PIMAGE_TLS_CALLBACK ThreadCacheExitCallback=Thread_Cache_Exit_Callback;
+#pragma data_seg()
+#endif
+
+unsigned ThreadCachedAllocatorClass::Get_Allocation_Count() const
+{
+	FastCriticalSectionClass::LockClass lock(_RegistryLock);
+	int count=RetiredCount;
+	for (ThreadTableStruct* table=_ThreadTables;table;table=table->Next) {
+		const CacheStruct& cache=table->Caches[Slot];
+		count+=cache.AllocCount-cache.FreeCount;
+	}
+	return count;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Both of the thread's magazines are empty: swap in a full one from the depot,
+// or carve a new chunk if the depot is empty too.
+//
+// ----------------------------------------------------------------------------
+
+void* ThreadCachedAllocatorClass::Alloc_Slow(CacheStruct& cache)
+{
+	if (cache.Previous && cache.Previous->Count>0) {
+		MagazineStruct* tmp=cache.Loaded;
+		cache.Loaded=cache.Previous;
+		cache.Previous=tmp;
+	} else {
+		MagazineStruct* full=Pop(FullMagazines);
+		if (full==NULL) {
+			full=Allocate_Chunk();
+		}
+		if (cache.Loaded) {
+			Push(EmptyMagazines,cache.Loaded);
+		}
+		cache.Loaded=full;
+	}
+
+	cache.AllocCount++;
+	return cache.Loaded->Objects[--cache.Loaded->Count];
+}
+
+// ----------------------------------------------------------------------------
+//
+// Both of the thread's magazines are full: hand one to the depot and continue
+// with an empty one.
+//
+// ----------------------------------------------------------------------------
+
+void ThreadCachedAllocatorClass::Free_Slow(CacheStruct& cache,void* object)
+{
+	WWASSERT(object!=NULL);
+
+	if (cache.Loaded==NULL) {
+		cache.Loaded=Get_Empty_Magazine();
+	} else if (cache.Previous && cache.Previous->Count<MAGAZINE_SIZE) {
+		MagazineStruct* tmp=cache.Loaded;
+		cache.Loaded=cache.Previous;
+		cache.Previous=tmp;
+	} else {
+		if (cache.Previous) {
+			Push(FullMagazines,cache.Previous);
+		}
+		cache.Previous=cache.Loaded;
+		cache.Loaded=Get_Empty_Magazine();
+	}
+
+	cache.FreeCount++;
+	cache.Loaded->Objects[cache.Loaded->Count++]=object;
+}
+
+// ----------------------------------------------------------------------------
+//
+// Takes a new chunk from the heap and splits it into magazines. One is
+// returned, the rest go to the depot.
+//
+// ----------------------------------------------------------------------------
+
+ThreadCachedAllocatorClass::MagazineStruct* ThreadCachedAllocatorClass::Allocate_Chunk()
+{
+	char* chunk=(char*)::malloc(ChunkSize);
+	WWASSERT(chunk!=NULL);
+
+	void* head;
+	do {
+		head=Chunks;
+		*(void**)chunk=head;
+	} while (InterlockedCompareExchangePointer((void* volatile*)&Chunks,chunk,head)!=head);
+	InterlockedIncrement(&ChunkCount);
+
+	char* object=chunk+sizeof(void*);
+	MagazineStruct* first=NULL;
+	for (unsigned i=0;i<ObjectsPerChunk;i+=MAGAZINE_SIZE) {
+		MagazineStruct* magazine=Get_Empty_Magazine();
+		magazine->Count=MIN(ObjectsPerChunk-i,(unsigned)MAGAZINE_SIZE);
+		for (unsigned j=0;j<magazine->Count;++j) {
+			magazine->Objects[j]=object;
+			object+=ObjectSize;
+		}
+
+		if (first==NULL) {
+			first=magazine;
+		} else {
+			Push(FullMagazines,magazine);
+		}
+	}
+	return first;
+}
+
+// ----------------------------------------------------------------------------
+
+ThreadCachedAllocatorClass::MagazineStruct* ThreadCachedAllocatorClass::Get_Magazine(unsigned index) const
+{
+	WWASSERT(index>0);
+	unsigned offset=index-1;
+	unsigned segment_size=FIRST_SEGMENT_SIZE;
+	int segment=0;
+	while (offset>=segment_size) {
+		offset-=segment_size;
+		segment_size*=2;
+		segment++;
+	}
+	return &Segments[segment][offset];
+}
+
+ThreadCachedAllocatorClass::MagazineStruct* ThreadCachedAllocatorClass::New_Magazine()
+{
+	unsigned index=InterlockedIncrement(&MagazineCount);
+
+	unsigned offset=index-1;
+	unsigned segment_size=FIRST_SEGMENT_SIZE;
+	int segment=0;
+	while (offset>=segment_size) {
+		offset-=segment_size;
+		segment_size*=2;
+		segment++;
+	}
+	WWASSERT(segment<MAX_SEGMENTS);
+
+	// The first thread to need a segment allocates it
+	if (Segments[segment]==NULL) {
+		MagazineStruct* magazines=(MagazineStruct*)::malloc(segment_size*sizeof(MagazineStruct));
+		if (InterlockedCompareExchangePointer((void* volatile*)&Segments[segment],magazines,NULL)!=NULL) {
+			::free(magazines);
+		}
+	}
+
+	MagazineStruct* magazine=&Segments[segment][offset];
+	magazine->Index=index;
+	magazine->Next=0;
+	magazine->Count=0;
+	return magazine;
+}
+
+ThreadCachedAllocatorClass::MagazineStruct* ThreadCachedAllocatorClass::Get_Empty_Magazine()
+{
+	MagazineStruct* magazine=Pop(EmptyMagazines);
+	if (magazine==NULL) {
+		magazine=New_Magazine();
+	}
+	return magazine;
+}
+
+void ThreadCachedAllocatorClass::Release_Magazine(MagazineStruct* magazine)
+{
+	Push(magazine->Count>0 ? FullMagazines : EmptyMagazines,magazine);
+}
+
+// ----------------------------------------------------------------------------
+//
+// Lock-free depot stacks. Magazines are never freed while the allocator is
+// alive, so reading the Next field of a magazine that another thread has just
+// popped is harmless; the tag makes the compare-exchange fail in that case.
+//
+// ----------------------------------------------------------------------------
+
+void ThreadCachedAllocatorClass::Push(StackStruct& stack,MagazineStruct* magazine)
+{
+	__int64 head;
+	do {
+		head=stack.Head;
+		magazine->Next=Stack_Index(head);
+	} while (InterlockedCompareExchange64(&stack.Head,Make_Stack_Head(magazine->Index,Stack_Tag(head)+1),head)!=head);
+}
+
+ThreadCachedAllocatorClass::MagazineStruct* ThreadCachedAllocatorClass::Pop(StackStruct& stack)
+{
+	__int64 head;
+	MagazineStruct* magazine;
+	do {
+		head=stack.Head;
+		if (Stack_Index(head)==0) {
+			return NULL;
+		}
+		magazine=Get_Magazine(Stack_Index(head));
+	} while (InterlockedCompareExchange64(&stack.Head,Make_Stack_Head(magazine->Next,Stack_Tag(head)+1),head)!=head);
+	return magazine;
+}
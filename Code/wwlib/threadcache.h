@@ -0,0 +1,172 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef THREADCACHE_H
+#define THREADCACHE_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+
+// ----------------------------------------------------------------------------
+//
+// ThreadCachedAllocatorClass is a fixed size allocator that can be used from
+// any number of threads without taking a lock in the common case.
+//
+// Each thread keeps two "magazines" (small stacks of free objects) per
+// allocator. Alloc and Free only touch the calling thread's magazines. When
+// both are empty (or both full) a whole magazine is exchanged with the
+// allocator's depot, which is a lock-free stack. Memory is taken from the
+// heap in chunks and is not returned until the allocator is destroyed.
+//
+// Objects may be freed from a different thread than the one that allocated
+// them. A thread's magazines are flushed back to the depots when it exits,
+// whether or not it was started through ThreadClass.
+//
+// ----------------------------------------------------------------------------
+
+class ThreadCachedAllocatorClass
+{
+public:
+	enum {
+		MAGAZINE_SIZE=32,
+		MAX_ALLOCATORS=256
+	};
+
+	ThreadCachedAllocatorClass(unsigned object_size=0,unsigned objects_per_chunk=256);
+	~ThreadCachedAllocatorClass();
+
+	// Sets the object size after construction, must be called before first use.
+	void Init(unsigned object_size,unsigned objects_per_chunk=256);
+
+	void* Alloc();
+	void Free(void* object);
+
+	unsigned Get_Object_Size() const { return ObjectSize; }
+	unsigned Get_Heap_Size() const { return (unsigned)ChunkCount*ChunkSize; }
+	unsigned Get_Allocation_Count() const;
+	unsigned Get_Allocated_Size() const { return Get_Allocation_Count()*ObjectSize; }
+
+	// Return the calling thread's magazines of every allocator to the depots.
+	static void Flush_Thread_Caches();
+
+private:
+	struct MagazineStruct
+	{
+		unsigned Index;
+		unsigned Next;				// index of the next magazine in a depot stack
+		unsigned Count;
+		void* Objects[MAGAZINE_SIZE];
+	};
+
+	struct CacheStruct
+	{
+		MagazineStruct* Loaded;
+		MagazineStruct* Previous;
+		int AllocCount;
+		int FreeCount;
+	};
+
+	// A lock-free stack of magazines. The head holds a magazine index and a
+	// tag that changes on every update, so a pop can't be fooled by a magazine
+	// that was popped and pushed back in the meantime.
+	struct StackStruct
+	{
+		volatile __int64 Head;
+	};
+
+	// Magazines live in segments that double in size, so that they can be
+	// referred to by index and are never moved or freed while in use.
+	enum {
+		FIRST_SEGMENT_SIZE=16,
+		MAX_SEGMENTS=20
+	};
+
+	// Every thread has a table with its caches for all allocators
+	struct ThreadTableStruct;
+	static ThreadTableStruct* _ThreadTables;
+	static __declspec(thread) CacheStruct* _ThreadCaches;
+	static CacheStruct* Create_Thread_Caches();
+
+	WWINLINE CacheStruct& Get_Cache()
+	{
+		CacheStruct* caches=_ThreadCaches;
+		if (caches==NULL) caches=Create_Thread_Caches();
+		return caches[Slot];
+	}
+
+	void* Alloc_Slow(CacheStruct& cache);
+	void Free_Slow(CacheStruct& cache,void* object);
+
+	MagazineStruct* Get_Magazine(unsigned index) const;
+	MagazineStruct* New_Magazine();
+	MagazineStruct* Get_Empty_Magazine();
+	MagazineStruct* Allocate_Chunk();
+	void Push(StackStruct& stack,MagazineStruct* magazine);
+	MagazineStruct* Pop(StackStruct& stack);
+	void Release_Magazine(MagazineStruct* magazine);
+
+	unsigned ObjectSize;
+	unsigned ChunkSize;
+	unsigned ObjectsPerChunk;
+	int Slot;
+
+	StackStruct FullMagazines;
+	StackStruct EmptyMagazines;
+
+	void* volatile Chunks;
+	volatile long ChunkCount;
+	volatile long RetiredCount;
+
+	MagazineStruct* volatile Segments[MAX_SEGMENTS];
+	volatile long MagazineCount;
+
+	// Not copyable
+	ThreadCachedAllocatorClass(const ThreadCachedAllocatorClass&);
+	ThreadCachedAllocatorClass& operator=(const ThreadCachedAllocatorClass&);
+};
+
+// ----------------------------------------------------------------------------
+
+WWINLINE void* ThreadCachedAllocatorClass::Alloc()
+{
+	CacheStruct& cache=Get_Cache();
+	MagazineStruct* magazine=cache.Loaded;
+	if (magazine && magazine->Count>0) {
+		cache.AllocCount++;
+		return magazine->Objects[--magazine->Count];
+	}
+	return Alloc_Slow(cache);
+}
+
+WWINLINE void ThreadCachedAllocatorClass::Free(void* object)
+{
+	CacheStruct& cache=Get_Cache();
+	MagazineStruct* magazine=cache.Loaded;
+	if (magazine && magazine->Count<MAGAZINE_SIZE) {
+		cache.FreeCount++;
+		magazine->Objects[magazine->Count++]=object;
+		return;
+	}
+	Free_Slow(cache,object);
+}
+
+#endif
@@ -49,6 +49,10 @@
  *   DynamicVectorClass<T>::ID -- Find matching value in the dynamic vector.                   *
  *   DynamicVectorClass<T>::Uninitialized_Add -- Add an empty place to the vector.             *
  *   DynamicVectorClass<T>::Insert -- insert an object at the desired index                    *
+ *   VectorClass<T>::Move_Elements -- Moves elements within or between vector arrays.          *
+ *   DynamicVectorClass<T>::Grow -- Makes room for at least one more element.                  *
+ *   DynamicVectorClass<T>::Reserve -- Makes room for a number of elements.                    *
+ *   DynamicVectorClass<T>::Shrink_To_Fit -- Frees the unused part of the vector.              *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 #if _MSC_VER >= 1000
 #pragma once
@@ -62,6 +66,8 @@
 #include	<stdlib.h>
 #include <string.h>
 #include <new.h>
+#include <utility>
+#include <type_traits>
 
 #ifdef _MSC_VER
 #pragma warning (disable : 4702) // unreachable code, happens with some uses of these templates
@@ -108,6 +114,12 @@ class VectorClass
 
 	protected:
 
+		/*
+		**	Moves elements from one place to another (the ranges may overlap). Types that
+		**	can be copied with memcpy are, everything else is move assigned.
+		*/
+		static void Move_Elements(T * dest, T * src, int count);
+
 		/*
 		**	This is a pointer to the allocated vector array of elements.
 		*/
@@ -434,14 +446,12 @@ bool VectorClass<T>::Resize(int newsize, T const * array)
 		if (Vector != NULL) {
 
 			/*
-			**	Copy as much of the old vector into the new vector as possible. This
+			**	Move as much of the old vector into the new vector as possible. This
 			**	presumes that there is a functional assignment operator for each
 			**	of the objects in the vector.
 			*/
 			int copycount = (newsize < VectorMax) ? newsize : VectorMax;
-			for (int index = 0; index < copycount; index++) {
-				newptr[index] = Vector[index];
-			}
+			Move_Elements(newptr, Vector, copycount);
 
 			/*
 			**	Delete the old vector. This might cause the destructors to be called
@@ -474,14 +484,55 @@ bool VectorClass<T>::Resize(int newsize, T const * array)
 
 
 
+/***********************************************************************************************
+ * VectorClass<T>::Move_Elements -- Moves elements within or between vector arrays.            *
+ *                                                                                             *
+ *    Types that are trivially copyable are moved with a single memmove. Anything else is      *
+ *    move assigned one element at a time, in the direction that is safe for overlapping       *
+ *    ranges. The source elements are left in a valid but unspecified state.                   *
+ *                                                                                             *
+ * INPUT:   dest  -- Where the elements go.                                                    *
+ *                                                                                             *
+ *          src   -- Where the elements come from.                                             *
+ *                                                                                             *
+ *          count -- Number of elements to move.                                               *
+ *                                                                                             *
+ * OUTPUT:  none                                                                               *
+ *                                                                                             *
+ * WARNINGS:   Both ranges must hold constructed objects.                                      *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T>
+void VectorClass<T>::Move_Elements(T * dest, T * src, int count)
+{
+	if (count <= 0 || dest == src) return;
+
+	if constexpr (std::is_trivially_copyable<T>::value) {
+		memmove(dest, src, count * sizeof(T));
+	} else {
+		if (dest < src) {
+			for (int index = 0; index < count; index++) {
+				dest[index] = std::move(src[index]);
+			}
+		} else {
+			for (int index = count-1; index >= 0; index--) {
+				dest[index] = std::move(src[index]);
+			}
+		}
+	}
+}
+
+
 /**************************************************************************
 **	This derivative vector class adds the concept of adding and deleting
 **	objects. The objects are packed to the beginning of the vector array.
 **	If this is instantiated for a class object, then the assignment operator
 **	and the equality operator must be supported. If the vector allocates its
 **	own memory, then the vector can grow if it runs out of room adding items.
-**	The growth rate is controlled by setting the growth step rate. A growth
-**	step rate of zero disallows growing.
+**	It grows by half its current size, but never by less than the growth step,
+**	so appending is amortized constant time. A growth step rate of zero
+**	disallows growing.
 */
 template<class T>
 class DynamicVectorClass : public VectorClass<T>
@@ -508,6 +559,7 @@ class DynamicVectorClass : public VectorClass<T>
 
 		// Add object to vector (growing as necessary).
 		bool Add(T const & object);
+		bool Add(T && object);
 		bool Add_Head(T const & object);
 		bool Insert(int index,T const & object);
 
@@ -526,6 +578,12 @@ class DynamicVectorClass : public VectorClass<T>
 		// Fetch current growth step rate.
 		int Growth_Step(void) {return GrowthStep;};
 
+		// Make room for this many objects in total so they can be added without growing.
+		bool Reserve(int count);
+
+		// Free the part of the vector past the active objects.
+		void Shrink_To_Fit(void);
+
 		virtual int ID(T const * ptr) {return(VectorClass<T>::ID(ptr));};
 		virtual int ID(T const & ptr);
 
@@ -545,6 +603,17 @@ class DynamicVectorClass : public VectorClass<T>
 
 	protected:
 
+		/*
+		**	Grows the vector by half its size or the growth step, whichever is larger.
+		*/
+		bool Grow(void);
+
+		/*
+		**	A vector may only grow if it owns its memory (or has none yet). Derived
+		**	classes that supply their own storage from Resize can override this.
+		*/
+		virtual bool Is_Growable(void) const {return(this->IsAllocated || !this->VectorMax);};
+
 		/*
 		**	This is a count of the number of active objects in this
 		**	vector. The memory array often times is bigger than this
@@ -554,9 +623,9 @@ class DynamicVectorClass : public VectorClass<T>
 
 		/*
 		**	If there is insufficient room in the vector array for a new
-		**	object to be added, then the vector will grow by the number
-		**	of objects specified by this value. This is controlled by
-		**	the Set_Growth_Step() function.
+		**	object to be added, then the vector will grow by half its
+		**	size or by this value, whichever is larger. This is controlled
+		**	by the Set_Growth_Step() function.
 		*/
 		int GrowthStep;
 };
@@ -670,8 +739,8 @@ template<class T>
 bool DynamicVectorClass<T>::Add(T const & object)
 {
 	if (ActiveCount >= this->Length()) {
-		if ((this->IsAllocated || !this->VectorMax) && GrowthStep > 0) {
-			if (!Resize(this->Length() + GrowthStep)) {
+		if (Is_Growable() && GrowthStep > 0) {
+			if (!Grow()) {
 
 				/*
 				**	Failure to increase the size of the vector is an error condition.
@@ -697,6 +766,19 @@ bool DynamicVectorClass<T>::Add(T const & object)
 }
 
 
+template<class T>
+bool DynamicVectorClass<T>::Add(T && object)
+{
+	if (ActiveCount >= this->Length()) {
+		if (!Is_Growable() || GrowthStep <= 0 || !Grow()) {
+			return(false);
+		}
+	}
+	(*this)[ActiveCount++] = std::move(object);
+	return(true);
+}
+
+
 /***********************************************************************************************
  * DynamicVectorClass<T>::Add_Head -- Adds element to head of the list.                        *
  *                                                                                             *
@@ -716,8 +798,8 @@ template<class T>
 bool DynamicVectorClass<T>::Add_Head(T const & object)
 {
 	if (ActiveCount >= this->Length()) {
-		if ((this->IsAllocated || !this->VectorMax) && GrowthStep > 0) {
-			if (!Resize(this->Length() + GrowthStep)) {
+		if (Is_Growable() && GrowthStep > 0) {
+			if (!Grow()) {
 
 				/*
 				**	Failure to increase the size of the vector is an error condition.
@@ -739,7 +821,7 @@ bool DynamicVectorClass<T>::Add_Head(T const & object)
 	**	There is room for the new object now. Add it to the end of the object vector.
 	*/
 	if (ActiveCount) {
-		memmove(&(*this)[1], &(*this)[0], ActiveCount * sizeof(T));
+		this->Move_Elements(&(*this)[1], &(*this)[0], ActiveCount);
 	}
 	(*this)[0] = object;
 	ActiveCount++;
@@ -768,8 +850,8 @@ bool DynamicVectorClass<T>::Insert(int index,T const & object)
 	if (index > ActiveCount) return false;
 
 	if (ActiveCount >= this->Length()) {
-		if ((this->IsAllocated || !this->VectorMax) && GrowthStep > 0) {
-			if (!Resize(this->Length() + GrowthStep)) {
+		if (Is_Growable() && GrowthStep > 0) {
+			if (!Grow()) {
 
 				/*
 				**	Failure to increase the size of the vector is an error condition.
@@ -791,7 +873,7 @@ bool DynamicVectorClass<T>::Insert(int index,T const & object)
 	**	There is room for the new object now. Add it at the desired position.
 	*/
 	if (index < ActiveCount) {
-		memmove(&(*this)[index+1], &(*this)[index], (ActiveCount-index) * sizeof(T));
+		this->Move_Elements(&(*this)[index+1], &(*this)[index], ActiveCount-index);
 	}
 	(*this)[index] = object;
 	ActiveCount++;
@@ -850,14 +932,13 @@ bool DynamicVectorClass<T>::Delete(int index)
 		ActiveCount--;
 
 		/*
-		**	If there are any objects past the index that was deleted, copy those
+		**	If there are any objects past the index that was deleted, move those
 		**	objects down in order to fill the hole. A simple memory copy is
-		**	not sufficient since the vector could contain class objects that
-		**	need to use the assignment operator for movement.
+		**	only used for types that allow it; class objects are move assigned.
 		*/
 //		(&(*this)[index])->~ T ();
-		for (int i = index; i < ActiveCount; i++) {
-			(*this)[i] = (*this)[i+1];
+		if (index < ActiveCount) {
+			this->Move_Elements(&(*this)[index], &(*this)[index+1], ActiveCount-index);
 		}
 		return(true);
 	}
@@ -868,9 +949,84 @@ bool DynamicVectorClass<T>::Delete(int index)
 template<class T>
 void DynamicVectorClass<T>::Delete_All(void) 
 {
-	int len = this->VectorMax;
-	Clear();		// Forces destructor call on each object.
-	Resize(len);
+	/*
+	**	Objects without destructors can simply be forgotten; the memory is kept.
+	*/
+	if constexpr (std::is_trivially_destructible<T>::value) {
+		ActiveCount = 0;
+	} else {
+		int len = this->VectorMax;
+		Clear();		// Forces destructor call on each object.
+		Resize(len);
+	}
+}
+
+
+/***********************************************************************************************
+ * DynamicVectorClass<T>::Grow -- Makes room for at least one more element.                    *
+ *                                                                                             *
+ *    The vector grows by half its current size so that adding N objects only resizes it      *
+ *    O(log N) times. The growth step is the smallest amount it will grow by.                  *
+ *                                                                                             *
+ * INPUT:   none                                                                               *
+ *                                                                                             *
+ * OUTPUT:  bool; Was the vector resized?                                                      *
+ *                                                                                             *
+ * WARNINGS:   The caller checks whether the vector is allowed to grow.                        *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T>
+bool DynamicVectorClass<T>::Grow(void)
+{
+	int step = this->Length() / 2;
+	if (step < GrowthStep) step = GrowthStep;
+	return(Resize(this->Length() + step));
+}
+
+
+/***********************************************************************************************
+ * DynamicVectorClass<T>::Reserve -- Makes room for a number of elements.                      *
+ *                                                                                             *
+ *    Use this before adding a known number of objects so the vector is only resized once.     *
+ *                                                                                             *
+ * INPUT:   count -- Total number of objects the vector should be able to hold.                *
+ *                                                                                             *
+ * OUTPUT:  bool; Is there room for that many objects now?                                     *
+ *                                                                                             *
+ * WARNINGS:   Fails if the vector may not grow (it uses memory it doesn't own).               *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T>
+bool DynamicVectorClass<T>::Reserve(int count)
+{
+	if (count <= this->Length()) return(true);
+	if (!Is_Growable()) return(false);
+	return(Resize(count));
+}
+
+
+/***********************************************************************************************
+ * DynamicVectorClass<T>::Shrink_To_Fit -- Frees the unused part of the vector.                *
+ *                                                                                             *
+ *    Resizes the vector to exactly the number of active objects. Vectors that use memory      *
+ *    they don't own are left alone.                                                           *
+ *                                                                                             *
+ * INPUT:   none                                                                               *
+ *                                                                                             *
+ * OUTPUT:  none                                                                               *
+ *                                                                                             *
+ * WARNINGS:   none                                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+template<class T>
+void DynamicVectorClass<T>::Shrink_To_Fit(void)
+{
+	if (ActiveCount < this->Length() && this->IsAllocated) {
+		Resize(ActiveCount);
+	}
 }
 
 
@@ -899,7 +1055,7 @@ T * DynamicVectorClass<T>::Uninitialized_Add(void)
 	if (ActiveCount >= this->Length()) {
 //		if ((IsAllocated || !VectorMax) && GrowthStep > 0) {
 		if (GrowthStep > 0) {
-			if (!Resize(this->Length() + GrowthStep)) {
+			if (!Grow()) {
 
 				/*
 				**	Failure to increase the size of the vector is an error condition.
@@ -1016,8 +1172,8 @@ class BooleanVectorClass
 			return(-1);
 		}
 
-		// Accessors (usefull for saving the bit vector)
-		const VectorClass<unsigned char> &	Get_Bit_Array(void)	{ return BitArray; }
+		// Accessors (usefull for saving the bit vector, so the last fetched value is written back first)
+		const VectorClass<unsigned char> &	Get_Bit_Array(void)	{ if (LastIndex != -1) Fixup(-1); return BitArray; }
 
 	protected:
 
@@ -0,0 +1,229 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "workerpool.h"
+#include "thread.h"
+#include "mutex.h"
+#include "simplevec.h"
+#include "wwdebug.h"
+#include <windows.h>
+#include <stdio.h>
+
+
+struct WorkerJobStruct
+{
+	WorkerPoolClass::JobFunctionType	Function;
+	void *									Data;
+	int										Index;
+	JobGroupClass *						Group;
+};
+
+class WorkerThreadClass : public ThreadClass
+{
+public:
+	WorkerThreadClass(const char * name) : ThreadClass(name) {}
+	void Request_Stop() { running=false; }
+
+protected:
+	virtual void Thread_Function();
+};
+
+// ----------------------------------------------------------------------------
+//
+// The queue is a ring buffer that doubles when full, protected by one
+// critical section. Idle workers sleep on a semaphore with one count per
+// queued job.
+//
+// The lock and the ring buffer are allocated on first use and never freed.
+// A program that doesn't call Shutdown() still has its workers running while
+// the static destructors run at exit, and they must not find the lock gone.
+//
+// ----------------------------------------------------------------------------
+
+struct WorkerQueueStruct
+{
+	CriticalSectionClass					Lock;
+	SimpleVecClass<WorkerJobStruct>	Jobs;
+};
+
+static WorkerQueueStruct & Get_Queue()
+{
+	static WorkerQueueStruct * queue=new WorkerQueueStruct;
+	return *queue;
+}
+
+static int								_QueueHead;
+static int								_QueueCount;
+static HANDLE							_JobSemaphore;
+
+static WorkerThreadClass *			_Workers[WorkerPoolClass::MAX_THREADS];
+static int								_WorkerCount;
+static bool								_Initialized;
+
+
+void WorkerThreadClass::Thread_Function()
+{
+	while (running) {
+		::WaitForSingleObject(_JobSemaphore,100);
+		while (running && WorkerPoolClass::Run_Pending_Job()) {
+		}
+	}
+}
+
+void JobGroupClass::Wait()
+{
+	while (Pending>0) {
+		if (!WorkerPoolClass::Run_Pending_Job()) {
+			ThreadClass::Switch_Thread();
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+void WorkerPoolClass::Init(int thread_count)
+{
+	WorkerQueueStruct & queue=Get_Queue();
+	CriticalSectionClass::LockClass lock(queue.Lock);
+	if (_Initialized) {
+		return;
+	}
+
+	if (thread_count<0) {
+		SYSTEM_INFO info;
+		::GetSystemInfo(&info);
+		thread_count=(int)info.dwNumberOfProcessors-1;
+	}
+	thread_count=MIN(thread_count,(int)MAX_THREADS);
+
+	queue.Jobs.Resize(256);
+	_QueueHead=0;
+	_QueueCount=0;
+	_JobSemaphore=::CreateSemaphore(NULL,0,0x7fffffff,NULL);
+
+	for (int i=0;i<thread_count;++i) {
+		char name[32];
+		sprintf(name,"Worker %d",i);
+		_Workers[i]=new WorkerThreadClass(name);
+		_Workers[i]->Execute();
+	}
+	_WorkerCount=MAX(thread_count,0);
+	_Initialized=true;
+
+	WWDEBUG_SAY(("WorkerPoolClass: started %d worker threads\n",_WorkerCount));
+}
+
+void WorkerPoolClass::Shutdown()
+{
+	if (!_Initialized) {
+		return;
+	}
+
+	for (int i=0;i<_WorkerCount;++i) {
+		_Workers[i]->Request_Stop();
+	}
+	::ReleaseSemaphore(_JobSemaphore,_WorkerCount,NULL);
+	for (int i=0;i<_WorkerCount;++i) {
+		_Workers[i]->Stop();
+		delete _Workers[i];
+		_Workers[i]=NULL;
+	}
+
+	// Anything still queued runs here so no group is left waiting
+	while (Run_Pending_Job()) {
+	}
+
+	::CloseHandle(_JobSemaphore);
+	_JobSemaphore=NULL;
+	_WorkerCount=0;
+	_Initialized=false;
+}
+
+int WorkerPoolClass::Get_Thread_Count()
+{
+	if (!_Initialized) {
+		Init();
+	}
+	return _WorkerCount;
+}
+
+// ----------------------------------------------------------------------------
+
+void WorkerPoolClass::Submit(JobFunctionType function,void * data,int index,JobGroupClass & group)
+{
+	if (Get_Thread_Count()==0) {
+		function(data,index);
+		return;
+	}
+
+	::InterlockedIncrement(&group.Pending);
+	{
+		WorkerQueueStruct & queue=Get_Queue();
+		CriticalSectionClass::LockClass lock(queue.Lock);
+
+		if (_QueueCount==queue.Jobs.Length()) {
+			int old_size=queue.Jobs.Length();
+			SimpleVecClass<WorkerJobStruct> old_queue(old_size);
+			for (int i=0;i<old_size;++i) {
+				old_queue[i]=queue.Jobs[(_QueueHead+i)%old_size];
+			}
+			queue.Jobs.Resize(old_size*2);
+			for (int i=0;i<old_size;++i) {
+				queue.Jobs[i]=old_queue[i];
+			}
+			_QueueHead=0;
+		}
+
+		WorkerJobStruct & job=queue.Jobs[(_QueueHead+_QueueCount)%queue.Jobs.Length()];
+		job.Function=function;
+		job.Data=data;
+		job.Index=index;
+		job.Group=&group;
+		_QueueCount++;
+	}
+	::ReleaseSemaphore(_JobSemaphore,1,NULL);
+}
+
+void WorkerPoolClass::Parallel_For(JobFunctionType function,void * data,int count)
+{
+	JobGroupClass group;
+	for (int i=0;i<count;++i) {
+		Submit(function,data,i,group);
+	}
+	group.Wait();
+}
+
+bool WorkerPoolClass::Run_Pending_Job()
+{
+	WorkerJobStruct job;
+	{
+		WorkerQueueStruct & queue=Get_Queue();
+		CriticalSectionClass::LockClass lock(queue.Lock);
+		if (_QueueCount==0) {
+			return false;
+		}
+		job=queue.Jobs[_QueueHead];
+		_QueueHead=(_QueueHead+1)%queue.Jobs.Length();
+		_QueueCount--;
+	}
+
+	job.Function(job.Data,job.Index);
+	::InterlockedDecrement(&job.Group->Pending);
+	return true;
+}
@@ -0,0 +1,97 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#include "always.h"
+
+// ----------------------------------------------------------------------------
+//
+// JobGroupClass counts the jobs of one batch of work that are still pending.
+// Wait() runs queued jobs on the calling thread until the whole group is
+// done, so waiting never leaves a processor idle.
+//
+// ----------------------------------------------------------------------------
+
+class JobGroupClass
+{
+public:
+	JobGroupClass() : Pending(0) {}
+	~JobGroupClass() { Wait(); }
+
+	bool Is_Done() const { return Pending==0; }
+	int Get_Pending_Count() const { return Pending; }
+	void Wait();
+
+private:
+	volatile long Pending;
+
+	friend class WorkerPoolClass;
+
+	JobGroupClass(const JobGroupClass&);
+	JobGroupClass& operator=(const JobGroupClass&);
+};
+
+// ----------------------------------------------------------------------------
+//
+// WorkerPoolClass is a shared pool of ThreadClass workers fed from a single
+// job queue. A job is a function, a data pointer and an index, so the same
+// function can be submitted once per element of an array.
+//
+// The pool starts on first use with one worker per processor beyond the
+// first. Init(0) makes every job run inline in Submit(), which is useful for
+// debugging and for checking that parallel results match serial ones.
+// Programs stop the workers with Shutdown() on their way out, after the last
+// system that submits jobs has shut down.
+//
+// Jobs must not touch reference counts, render objects or anything else that
+// isn't thread safe unless the submitting code guarantees exclusive access.
+//
+// ----------------------------------------------------------------------------
+
+class WorkerPoolClass
+{
+public:
+	typedef void (*JobFunctionType)(void * data,int index);
+
+	enum {
+		MAX_THREADS=32
+	};
+
+	// Start the workers, thread_count<0 means one per processor beyond the first
+	static void Init(int thread_count=-1);
+	static void Shutdown();
+	static int Get_Thread_Count();
+
+	// Queue a job. Runs it immediately if there are no worker threads.
+	static void Submit(JobFunctionType function,void * data,int index,JobGroupClass & group);
+
+	// Run function(data,i) for i in [0,count) and wait for all of them
+	static void Parallel_For(JobFunctionType function,void * data,int count);
+
+	// Run one queued job on the calling thread, returns false if the queue was empty
+	static bool Run_Pending_Job();
+};
+
+#endif
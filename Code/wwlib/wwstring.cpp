@@ -37,7 +37,6 @@
 #include "wwstring.h"
 #include "win.h"
 #include "wwmemlog.h"
-#include "mutex.h"
 #include <stdio.h>
 
 
@@ -45,10 +44,7 @@
 //	Static member initialzation
 ///////////////////////////////////////////////////////////////////
 
-FastCriticalSectionClass StringClass::m_Mutex;
-
 TCHAR		StringClass::m_NullChar					= 0;
-TCHAR *	StringClass::m_EmptyString				= &m_NullChar;
 
 //
 // A trick to optimize strings that are allocated from the stack and used only temporarily
@@ -56,7 +52,7 @@ TCHAR *	StringClass::m_EmptyString				= &m_NullChar;
 // For alignment reasons we need twice as large block...
 char StringClass::m_TempStrings[(StringClass::MAX_TEMP_STRING*2)*StringClass::MAX_TEMP_BYTES];
 
-unsigned StringClass::ReservedMask=0;
+volatile long StringClass::ReservedMask=0;
 
 ///////////////////////////////////////////////////////////////////
 //
@@ -68,8 +64,11 @@ StringClass::Get_String (int length, bool is_temp)
 {
 	WWMEMLOG(MEM_STRINGS);
 
-	if (!is_temp && length == 0) {
-		m_Buffer = m_EmptyString;
+	//
+	//	Short strings are kept inline, temporary or not
+	//
+	if (length < INLINE_SIZE) {
+		Free_String ();
 		return;
 	}
 
@@ -78,26 +77,24 @@ StringClass::Get_String (int length, bool is_temp)
 	//
 	//	Should we attempt to use a temp buffer for this string?
 	//
-	if (is_temp && length <= MAX_TEMP_LEN && ReservedMask!=ALL_TEMP_STRINGS_USED_MASK) {
+	if (is_temp && length <= MAX_TEMP_LEN) {
 
 		//
-		//	Make sure no one else is requesting a temp pointer
-		// at the same time we are. There is a slight possibility that another
-		// thread stole the last available buffer in between the if sentence and
-		// the mutex lock, but that is a feature by design and doesn't cause
-		// anything bad to happen.
+		//	Claim the lowest free temp buffer by setting its bit in the
+		// reserved mask.  If another thread changed the mask in the meantime
+		// just look again; there is no lock so building strings on several
+		// threads doesn't serialize.
 		//
-		FastCriticalSectionClass::LockClass m(m_Mutex);
+		long mask = ReservedMask;
+		while (mask != ALL_TEMP_STRINGS_USED_MASK) {
+			
+			int index = 0;
+			while (mask & (1 << index)) {
+				index ++;
+			}
 
-		//
-		//	Try to find an available temporary buffer
-		//
-		// TODO: Don't loop, there are better ways
-		unsigned mask=1;
-		for (int index = 0; index < MAX_TEMP_STRING; index ++, mask<<=1) {
-			unsigned mask=1<<index;
-			if (!(ReservedMask&mask)) {
-				ReservedMask|=mask;
+			long prev_mask = InterlockedCompareExchange (&ReservedMask, mask | (1 << index), mask);
+			if (prev_mask == mask) {
 				
 				//
 				//	Grab this unused buffer for our string
@@ -112,19 +109,16 @@ StringClass::Get_String (int length, bool is_temp)
 				Set_Buffer_And_Allocated_Length (string, MAX_TEMP_LEN);
 				break;
 			}
+			mask = prev_mask;
 		}
 	}
 
 	if (string == NULL) {
 		
 		//
-		//	Allocate a new string as necessary
+		//	Allocate a new string
 		//
-		if (length > 0) {
-			Set_Buffer_And_Allocated_Length (Allocate_Buffer (length), length);
-		} else {
-			Free_String ();
-		}
+		Set_Buffer_And_Allocated_Length (Allocate_Buffer (length), length);
 	}
 }
 
@@ -147,7 +141,7 @@ StringClass::Resize (int new_len)
 		// string.
 		//
 		TCHAR *new_buffer = Allocate_Buffer (new_len);
-		_tcscpy (new_buffer, m_Buffer);
+		_tcscpy (new_buffer, Current_Buffer ());
 
 		//
 		//	Switch to the new buffer
@@ -189,13 +183,13 @@ StringClass::Uninitialised_Grow (int new_len)
 
 ///////////////////////////////////////////////////////////////////
 //
-//	Uninitialised_Grow
+//	Free_String
 //
 ///////////////////////////////////////////////////////////////////
 void
 StringClass::Free_String (void)
 {
-	if (m_Buffer != m_EmptyString) {
+	if (!Is_Inline ()) {
 
 		unsigned buffer_base=reinterpret_cast<unsigned>(m_Buffer-sizeof (StringClass::_HEADER));
 		unsigned temp_base=reinterpret_cast<unsigned>(m_TempStrings+MAX_TEMP_BYTES*MAX_TEMP_STRING);
@@ -204,14 +198,16 @@ StringClass::Free_String (void)
 			m_Buffer[0] = 0;
 
 			//
-			//	Make sure no one else is changing the reserved mask
-			// at the same time we are.
+			//	Clear our bit in the reserved mask, retrying if someone else
+			// changed the mask at the same time.
 			//
-			FastCriticalSectionClass::LockClass m(m_Mutex);
-
 			unsigned index=(buffer_base/MAX_TEMP_BYTES)&(MAX_TEMP_STRING-1);
-			unsigned mask=1<<index;
-			ReservedMask&=~mask;
+			long mask=1<<index;
+			long old_mask=ReservedMask;
+			long prev_mask;
+			while ((prev_mask=InterlockedCompareExchange (&ReservedMask, old_mask & ~mask, old_mask)) != old_mask) {
+				old_mask=prev_mask;
+			}
 		}
 		else {
 
@@ -222,12 +218,12 @@ StringClass::Free_String (void)
 			delete [] buffer;
 		}
 
-		//
-		//	Reset the buffer
-		//
-		m_Buffer = m_EmptyString;
 	}
 
+	//
+	//	Back to an empty inline string
+	//
+	Set_Inline_Empty ();
 	return ;
 }
 
@@ -243,8 +239,9 @@ StringClass::Format_Args (const TCHAR *format, const va_list & arg_list )
 	//
 	// Make a guess at the maximum length of the resulting string
 	//
-	TCHAR temp_buffer[512] = { 0 };
+	TCHAR temp_buffer[512];
 	int retval = 0;
+	temp_buffer[0] = m_NullChar;
 
 	//
 	//	Format the string
@@ -254,6 +251,7 @@ StringClass::Format_Args (const TCHAR *format, const va_list & arg_list )
 	#else
 		retval = _vsnprintf (temp_buffer, 512, format, arg_list);
 	#endif
+	temp_buffer[511] = m_NullChar;
 	
 	//
 	//	Copy the string into our buffer
@@ -278,8 +276,9 @@ StringClass::Format (const TCHAR *format, ...)
 	//
 	// Make a guess at the maximum length of the resulting string
 	//
-	TCHAR temp_buffer[512] = { 0 };
+	TCHAR temp_buffer[512];
 	int retval = 0;
+	temp_buffer[0] = m_NullChar;
 
 	//
 	//	Format the string
@@ -289,6 +288,7 @@ StringClass::Format (const TCHAR *format, ...)
 	#else
 		retval = _vsnprintf (temp_buffer, 512, format, arg_list);
 	#endif
+	temp_buffer[511] = m_NullChar;
 	
 	//
 	//	Copy the string into our buffer
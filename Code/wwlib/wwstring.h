@@ -67,6 +67,10 @@
 //	in it refers to a count of characters.  If the name contains 'byte'
 // it is talking about the memory size.
 //
+//	Short strings are stored inside the object itself; longer ones
+// live in a temp buffer or on the heap.  Nothing in the object points
+// at the object, so a StringClass can still be moved with memcpy.
+//
 //////////////////////////////////////////////////////////////////////
 class StringClass
 {
@@ -78,6 +82,7 @@ public:
 	StringClass (bool hint_temporary);
 	StringClass (int initial_len = 0, bool hint_temporary = false);
 	StringClass (const StringClass &string, bool hint_temporary = false);
+	inline StringClass (StringClass &&string);
 	StringClass (const TCHAR *string, bool hint_temporary = false);
 	StringClass (TCHAR ch, bool hint_temporary = false);
 	StringClass (const WCHAR *string, bool hint_temporary = false);
@@ -90,6 +95,7 @@ public:
 	bool operator!= (const TCHAR *rvalue) const;
 
 	inline const StringClass &operator= (const StringClass &string);
+	inline const StringClass &operator= (StringClass &&string);
 	inline const StringClass &operator= (const TCHAR *string);
 	inline const StringClass &operator= (TCHAR ch);
 	inline const StringClass &operator= (const WCHAR *string);
@@ -161,6 +167,19 @@ private:
 		ALL_TEMP_STRINGS_USED_MASK = 0xff
 	};
 
+	//
+	//	Inline storage.  The last character of m_Inline is a tag: the length of
+	// an inline string (zero if it isn't known) or HEAP_TAG when m_Buffer
+	// points at a temp or heap buffer (which has a HEADER in front of it).
+	//
+	enum
+	{
+		INLINE_BYTES		= 16,
+		INLINE_SIZE			= INLINE_BYTES / sizeof (TCHAR),
+		MAX_INLINE_LEN		= INLINE_SIZE - 2,
+		HEAP_TAG				= INLINE_SIZE
+	};
+
 	////////////////////////////////////////////////////////////
 	//	Private methods
 	////////////////////////////////////////////////////////////
@@ -175,23 +194,28 @@ private:
 	inline HEADER * Get_Header (void) const;
 	int			Get_Allocated_Length (void) const;
 
+	inline bool		Is_Inline (void) const			{ return m_Inline[INLINE_SIZE - 1] != HEAP_TAG; }
+	inline TCHAR *	Current_Buffer (void) const	{ return Is_Inline () ? (TCHAR *)m_Inline : m_Buffer; }
+	inline void		Set_Inline_Empty (void)			{ m_Inline[0] = m_NullChar; m_Inline[INLINE_SIZE - 1] = 0; }
+
 	void			Set_Buffer_And_Allocated_Length (TCHAR *buffer, int length);
 
 	////////////////////////////////////////////////////////////
 	//	Private member data
 	////////////////////////////////////////////////////////////
-	TCHAR *		m_Buffer;
+	union
+	{
+		TCHAR *		m_Buffer;
+		TCHAR			m_Inline[INLINE_SIZE];
+	};
 
 	////////////////////////////////////////////////////////////
 	//	Static member data
 	////////////////////////////////////////////////////////////
-	static unsigned ReservedMask;
+	static volatile long ReservedMask;
 	static char m_TempStrings[];
 
-	static FastCriticalSectionClass m_Mutex;
-
 	static TCHAR	m_NullChar;
-	static TCHAR *	m_EmptyString;
 };
 
 ///////////////////////////////////////////////////////////////////
@@ -200,15 +224,32 @@ private:
 inline const StringClass &
 StringClass::operator= (const StringClass &string)
 {	
-	int len = string.Get_Length();
-	Uninitialised_Grow(len+1);
-	Store_Length(len);
+	if (this != &string) {
+		int len = string.Get_Length();
+		Uninitialised_Grow(len+1);
+		Store_Length(len);
 
-	::memcpy (m_Buffer, string.m_Buffer, (len+1) * sizeof (TCHAR));		
+		::memcpy (Current_Buffer (), string.Current_Buffer (), (len+1) * sizeof (TCHAR));		
+	}
 	return (*this);
 
 }
 
+///////////////////////////////////////////////////////////////////
+//	operator=
+//
+//	Swaps with the other string, which is left to free our buffer.
+///////////////////////////////////////////////////////////////////
+inline const StringClass &
+StringClass::operator= (StringClass &&string)
+{
+	TCHAR temp[INLINE_SIZE];
+	::memcpy (temp, m_Inline, sizeof (m_Inline));
+	::memcpy (m_Inline, string.m_Inline, sizeof (m_Inline));
+	::memcpy (string.m_Inline, temp, sizeof (m_Inline));
+	return (*this);
+}
+
 ///////////////////////////////////////////////////////////////////
 //	operator=
 ///////////////////////////////////////////////////////////////////
@@ -221,7 +262,7 @@ StringClass::operator= (const TCHAR *string)
 		Uninitialised_Grow (len+1);
 		Store_Length (len);
 
-		::memcpy (m_Buffer, string, (len + 1) * sizeof (TCHAR));		
+		::memcpy (Current_Buffer (), string, (len + 1) * sizeof (TCHAR));		
 	}
 
 	return (*this);
@@ -250,8 +291,9 @@ StringClass::operator= (TCHAR ch)
 {
 	Uninitialised_Grow (2);
 
-	m_Buffer[0] = ch;
-	m_Buffer[1] = m_NullChar;
+	TCHAR *buffer	= Current_Buffer ();
+	buffer[0]		= ch;
+	buffer[1]		= m_NullChar;
 	Store_Length (1);
 
 	return (*this);
@@ -262,10 +304,10 @@ StringClass::operator= (TCHAR ch)
 ///////////////////////////////////////////////////////////////////
 inline
 StringClass::StringClass (bool hint_temporary)
-	:	m_Buffer (m_EmptyString)
 {
+	Set_Inline_Empty ();
 	Get_String (MAX_TEMP_LEN, hint_temporary);
-	m_Buffer[0]	= m_NullChar;
+	Current_Buffer ()[0] = m_NullChar;
 
 	return ;
 }
@@ -275,21 +317,34 @@ StringClass::StringClass (bool hint_temporary)
 ///////////////////////////////////////////////////////////////////
 inline
 StringClass::StringClass (int initial_len, bool hint_temporary)
-	:	m_Buffer (m_EmptyString)
 {
+	Set_Inline_Empty ();
 	Get_String (initial_len, hint_temporary);
-	m_Buffer[0]	= m_NullChar;
+	Current_Buffer ()[0] = m_NullChar;
 
 	return ;
 }
 
+///////////////////////////////////////////////////////////////////
+//	StringClass
+//
+//	Takes the other string's buffer, leaving it empty.
+///////////////////////////////////////////////////////////////////
+inline
+StringClass::StringClass (StringClass &&string)
+{
+	::memcpy (m_Inline, string.m_Inline, sizeof (m_Inline));
+	string.Set_Inline_Empty ();
+	return ;
+}
+
 ///////////////////////////////////////////////////////////////////
 //	StringClass
 ///////////////////////////////////////////////////////////////////
 inline
 StringClass::StringClass (TCHAR ch, bool hint_temporary)
-	:	m_Buffer (m_EmptyString)
 {
+	Set_Inline_Empty ();
 	Get_String (2, hint_temporary);
 	(*this) = ch;
 	return ;
@@ -300,8 +355,8 @@ StringClass::StringClass (TCHAR ch, bool hint_temporary)
 ///////////////////////////////////////////////////////////////////
 inline
 StringClass::StringClass (const StringClass &string, bool hint_temporary)
- 	:	m_Buffer (m_EmptyString)
 {
+	Set_Inline_Empty ();
 	if (hint_temporary || (string.Get_Length()>0)) {
 		Get_String (string.Get_Length()+1, hint_temporary);
 	}
@@ -315,8 +370,8 @@ StringClass::StringClass (const StringClass &string, bool hint_temporary)
 ///////////////////////////////////////////////////////////////////
 inline
 StringClass::StringClass (const TCHAR *string, bool hint_temporary)
-	:	m_Buffer (m_EmptyString)
 {
+	Set_Inline_Empty ();
 	int len=string ? _tcsclen(string) : 0;
 	if (hint_temporary || len>0) {
 		Get_String (len+1, hint_temporary);
@@ -331,8 +386,8 @@ StringClass::StringClass (const TCHAR *string, bool hint_temporary)
 ///////////////////////////////////////////////////////////////////
 inline
 StringClass::StringClass (const WCHAR *string, bool hint_temporary)
-	:	m_Buffer (m_EmptyString)
 {
+	Set_Inline_Empty ();
 	int len = string ? wcslen (string) : 0;
 	if (hint_temporary || len > 0) {
 		Get_String (len + 1, hint_temporary);
@@ -359,7 +414,7 @@ StringClass::~StringClass (void)
 inline bool
 StringClass::Is_Empty (void) const
 {
-	return (m_Buffer[0] == m_NullChar);
+	return (Current_Buffer ()[0] == m_NullChar);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -368,7 +423,7 @@ StringClass::Is_Empty (void) const
 inline int
 StringClass::Compare (const TCHAR *string) const
 {
-	return _tcscmp (m_Buffer, string);
+	return _tcscmp (Current_Buffer (), string);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -377,7 +432,7 @@ StringClass::Compare (const TCHAR *string) const
 inline int
 StringClass::Compare_No_Case (const TCHAR *string) const
 {
-	return _tcsicmp (m_Buffer, string);
+	return _tcsicmp (Current_Buffer (), string);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -387,7 +442,7 @@ inline const TCHAR &
 StringClass::operator[] (int index) const
 {
 	WWASSERT (index >= 0 && index < Get_Length ());
-	return m_Buffer[index];
+	return Current_Buffer ()[index];
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -397,7 +452,7 @@ inline TCHAR &
 StringClass::operator[] (int index)
 {
 	WWASSERT (index >= 0 && index < Get_Length ());
-	return m_Buffer[index];
+	return Current_Buffer ()[index];
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -406,7 +461,7 @@ StringClass::operator[] (int index)
 inline
 StringClass::operator const TCHAR * (void) const
 {
-	return m_Buffer;
+	return Current_Buffer ();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -433,7 +488,7 @@ StringClass::operator!= (const TCHAR *rvalue) const
 inline bool
 StringClass::operator < (const TCHAR *string) const
 {
-	return (_tcscmp (m_Buffer, string) < 0);
+	return (_tcscmp (Current_Buffer (), string) < 0);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -442,7 +497,7 @@ StringClass::operator < (const TCHAR *string) const
 inline bool
 StringClass::operator <= (const TCHAR *string) const
 {
-	return (_tcscmp (m_Buffer, string) <= 0);
+	return (_tcscmp (Current_Buffer (), string) <= 0);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -451,7 +506,7 @@ StringClass::operator <= (const TCHAR *string) const
 inline bool
 StringClass::operator > (const TCHAR *string) const
 {
-	return (_tcscmp (m_Buffer, string) > 0);
+	return (_tcscmp (Current_Buffer (), string) > 0);
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -460,7 +515,7 @@ StringClass::operator > (const TCHAR *string) const
 inline bool
 StringClass::operator >= (const TCHAR *string) const
 {
-	return (_tcscmp (m_Buffer, string) >= 0);
+	return (_tcscmp (Current_Buffer (), string) >= 0);
 }
 
 
@@ -478,8 +533,9 @@ StringClass::Erase (int start_index, int char_count)
 			char_count = len - start_index;
 		}
 
-		::memmove (	&m_Buffer[start_index],
-						&m_Buffer[start_index + char_count],
+		TCHAR *buffer = Current_Buffer ();
+		::memmove (	&buffer[start_index],
+						&buffer[start_index + char_count],
 						(len - (start_index + char_count) + 1) * sizeof (TCHAR));
 
 		Store_Length( len - char_count );
@@ -494,7 +550,8 @@ StringClass::Erase (int start_index, int char_count)
 ///////////////////////////////////////////////////////////////////
 inline void StringClass::Trim(void)
 {
-	strtrim(m_Buffer);
+	strtrim(Current_Buffer ());
+	Store_Length (0);
 }
 
 
@@ -519,7 +576,7 @@ StringClass::operator+= (const TCHAR *string)
 	//
 	//	Copy the new string onto our the end of our existing buffer
 	//
-	::memcpy (&m_Buffer[cur_len], string, (src_len + 1) * sizeof (TCHAR));
+	::memcpy (&Current_Buffer ()[cur_len], string, (src_len + 1) * sizeof (TCHAR));
 	return (*this);
 }
 
@@ -532,8 +589,9 @@ StringClass::operator+= (TCHAR ch)
 	int cur_len = Get_Length ();
 	Resize (cur_len + 2);
 
-	m_Buffer[cur_len]			= ch;
-	m_Buffer[cur_len + 1]	= m_NullChar;
+	TCHAR *buffer				= Current_Buffer ();
+	buffer[cur_len]			= ch;
+	buffer[cur_len + 1]		= m_NullChar;
 	
 	if (ch != m_NullChar) {
 		Store_Length (cur_len + 1);
@@ -550,7 +608,7 @@ StringClass::Get_Buffer (int new_length)
 {
 	Uninitialised_Grow (new_length);
 
-	return m_Buffer;
+	return Current_Buffer ();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -559,7 +617,7 @@ StringClass::Get_Buffer (int new_length)
 inline TCHAR *
 StringClass::Peek_Buffer (void)
 {
-	return m_Buffer;
+	return Current_Buffer ();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -568,7 +626,7 @@ StringClass::Peek_Buffer (void)
 inline const TCHAR *
 StringClass::Peek_Buffer (void) const
 {
-	return m_Buffer;
+	return Current_Buffer ();
 }
 
 ///////////////////////////////////////////////////////////////////
@@ -591,7 +649,7 @@ StringClass::operator+= (const StringClass &string)
 		//
 		//	Copy the new string onto our the end of our existing buffer
 		//
-		::memcpy (&m_Buffer[cur_len], (const TCHAR *)string, (src_len + 1) * sizeof (TCHAR));				
+		::memcpy (&Current_Buffer ()[cur_len], (const TCHAR *)string, (src_len + 1) * sizeof (TCHAR));				
 	}
 
 	return (*this);
@@ -639,12 +697,15 @@ operator+ (const StringClass &string1, const TCHAR *string2)
 inline int
 StringClass::Get_Allocated_Length (void) const
 {
-	int allocated_length = 0;
+	//
+	//	Inline strings can hold everything but the tag
+	//
+	int allocated_length = INLINE_SIZE - 1;
 
 	//
 	//	Read the allocated length from the header
 	//
-	if (m_Buffer != m_EmptyString) {		
+	if (!Is_Inline ()) {		
 		HEADER *header		= Get_Header ();
 		allocated_length	= header->allocated_length;		
 	}
@@ -665,7 +726,18 @@ StringClass::Get_Length (void) const
 {
 	int length = 0;
 
-	if (m_Buffer != m_EmptyString) {
+	if (Is_Inline ()) {
+
+		//
+		//	The length of an inline string is in the tag
+		//
+		length = m_Inline[INLINE_SIZE - 1];
+		if (length == 0 && m_Inline[0] != m_NullChar) {
+			length = _tcslen (m_Inline);
+			((StringClass *)this)->Store_Length (length);
+		}
+
+	} else {
 		
 		//
 		//	Read the length from the header
@@ -691,23 +763,21 @@ StringClass::Get_Length (void) const
 //
 // Set buffer pointer and init size variable. Length is set to 0
 // as the contents of the new buffer are not necessarily defined.
+// The buffer is a temp or heap buffer with a header.
 ///////////////////////////////////////////////////////////////////
 inline void
 StringClass::Set_Buffer_And_Allocated_Length (TCHAR *buffer, int length)
 {
+	WWASSERT (buffer != NULL);
 	Free_String ();
-	m_Buffer = buffer;
+	m_Buffer							= buffer;
+	m_Inline[INLINE_SIZE - 1]	= HEAP_TAG;
 
 	//
-	//	Update the header (if necessary)
+	//	Update the header
 	//
-	if (m_Buffer != m_EmptyString) {
-		Store_Allocated_Length (length);
-		Store_Length (0);		
-	} else {
-		WWASSERT (length == 0);
-	}
-
+	Store_Allocated_Length (length);
+	Store_Length (0);		
 	return ;
 }
 
@@ -751,11 +821,11 @@ StringClass::Get_Header (void) const
 inline void
 StringClass::Store_Allocated_Length (int allocated_length)
 {
-	if (m_Buffer != m_EmptyString) {
+	if (!Is_Inline ()) {
 		HEADER *header					= Get_Header ();
 		header->allocated_length	= allocated_length;
 	} else {
-		WWASSERT (allocated_length == 0);
+		WWASSERT (allocated_length == INLINE_SIZE - 1);
 	}
 
 	return ;
@@ -770,11 +840,12 @@ StringClass::Store_Allocated_Length (int allocated_length)
 inline void
 StringClass::Store_Length (int length)
 {
-	if (m_Buffer != m_EmptyString) {
+	if (!Is_Inline ()) {
 		HEADER *header		= Get_Header ();
 		header->length		= length;
 	} else {
-		WWASSERT (length == 0);
+		WWASSERT (length >= 0 && length <= MAX_INLINE_LEN);
+		m_Inline[INLINE_SIZE - 1] = (TCHAR)length;
 	}
 
 	return ;
@@ -120,6 +120,7 @@ cConnection::cConnection() :
 	ThisFrameTimeMs(TIMEGETTIME()),
 	IsDestroy(false),
 	PRHost(NULL),
+	PReceivePacket(NULL),
 	AcceptHandler(NULL),
 	RefusalHandler(NULL),
 	ServerBrokenConnectionHandler(NULL),
@@ -164,6 +165,9 @@ cConnection::cConnection() :
 
 	//Init_Stats();
 
+	PReceivePacket = new cPacket;
+	WWASSERT(PReceivePacket != NULL);
+
 	PStatList = new cMsgStatList;
 	WWASSERT(PStatList != NULL);
 	PStatList->Init(PACKETTYPE_COUNT);
@@ -200,6 +204,10 @@ cConnection::~cConnection()
 
 	delete [] PRHost;
 	PRHost = NULL;
+	RHostMap.Remove_All();
+
+	delete PReceivePacket;
+	PReceivePacket = NULL;
 
 	delete PStatList;
 	PStatList = NULL;
@@ -268,6 +276,7 @@ void cConnection::Init_As_Client(LPSOCKADDR_IN p_server_address, unsigned short
    if (!cSinglePlayerData::Is_Single_Player()) {
       PRHost[0]->Set_Address(*p_server_address);
       WWASSERT(cNetUtil::Is_Same_Address(&PRHost[0]->Get_Address(), p_server_address));
+      RHostMap.Add(*p_server_address, 0);
    }
 
 	Init_Stats();
@@ -398,6 +407,7 @@ LPCSTR cConnection::Type_Translation(int type)
 		ADD_CASE(PACKETTYPE_ACCEPT_SC);
 		ADD_CASE(PACKETTYPE_REFUSAL_SC);
 		ADD_CASE(PACKETTYPE_FIREWALL_PROBE);
+		ADD_CASE(PACKETTYPE_ACK_BITFIELD);
 
 	default:
 		DIE;
@@ -598,7 +608,13 @@ bool cConnection::Receive_Packet()
 
    WWASSERT(InitDone);
 
-   cPacket packet;
+	//
+	// Receive into the spare pooled packet. If it ends up in a receive window
+	// it is replaced, otherwise it is reused for the next datagram.
+	//
+	WWASSERT(PReceivePacket != NULL);
+   cPacket & packet = *PReceivePacket;
+	packet.Reset_For_Receive();
 
 	int ret_code = 0;
 
@@ -643,6 +659,11 @@ bool cConnection::Receive_Packet()
       	packet.Flush();
       	return true;
    	}
+#else //WRAPPER_CRC
+   	if (packet.Get_Type() == cPacket::UNDEFINED_TYPE) {
+      	WWDEBUG_SAY(("*** MALFORMED PACKET DISCARDED ***\n"));
+      	return true;
+   	}
 #endif //WRAPPER_CRC
 
 #ifdef WWDEBUG
@@ -750,9 +771,9 @@ bool cConnection::Receive_Packet()
 			}
 
             //
-            // The main purpose of the keepalive is to stimulate this ack.
+            // The main purpose of the keepalive is to stimulate an ack.
             //
-            Send_Ack(p_from_address, packet_id);
+            p_sender_rhost->Set_Ack_Pending(packet_id);
 
 				float packetloss_pc = packet.Get(packetloss_pc);
 
@@ -770,7 +791,9 @@ bool cConnection::Receive_Packet()
             //
             WWASSERT(packet.Is_Flushed());
 
-				p_sender_rhost->Add_Packet(packet, RELIABLE_RCV_LIST);
+				if (!Adopt_Received_Packet(p_sender_rhost, RELIABLE_RCV_LIST)) {
+               CombinedStats.StatSample[STAT_DiscardCount]++;
+				}
 		      return true;
          }
 
@@ -827,7 +850,7 @@ bool cConnection::Receive_Packet()
 					WWASSERT(packet.Is_Flushed());
 
 					WWASSERT(p_sender_rhost != NULL);
-               p_sender_rhost->Add_Packet(packet, RELIABLE_RCV_LIST);
+               Adopt_Received_Packet(p_sender_rhost, RELIABLE_RCV_LIST);
             }
 
 		      return true;
@@ -916,7 +939,9 @@ bool cConnection::Receive_Packet()
 					sender_stats.Set_Last_Unreliable_Packet_Id(packet_id);
 				}
 
-            p_sender_rhost->Add_Packet(packet, UNRELIABLE_RCV_LIST);
+            if (!Adopt_Received_Packet(p_sender_rhost, UNRELIABLE_RCV_LIST)) {
+               CombinedStats.StatSample[STAT_DiscardCount]++;
+            }
 
 			   return true;
          }
@@ -944,19 +969,29 @@ bool cConnection::Receive_Packet()
                return true;
 				}
 
-            Send_Ack(p_from_address, packet_id);
+            //
+            // Acks for everything received this frame go out together, from
+            // Send_Pending_Acks. Duplicates are acked again in case the
+            // previous ack was lost.
+            //
+				WWASSERT(p_sender_rhost != NULL);
+            p_sender_rhost->Set_Ack_Pending(packet_id);
 
             //
 			   // Keep track of how many of each packet is received
 			   //
 
-				WWASSERT(p_sender_rhost != NULL);
 				cNetStats & sender_stats = p_sender_rhost->Get_Stats();
    			sender_stats.StatSample[STAT_MsgRcv]++;
             sender_stats.StatSample[STAT_RPktRcv]++;
             sender_stats.StatSample[STAT_RByteRcv] += ret_code;
 
-            p_sender_rhost->Add_Packet(packet, RELIABLE_RCV_LIST);
+            if (!Adopt_Received_Packet(p_sender_rhost, RELIABLE_RCV_LIST)) {
+               //
+               // Duplicate packet, discard
+               //
+               CombinedStats.StatSample[STAT_DiscardCount]++;
+            }
 
 				return true;
          }
@@ -978,6 +1013,27 @@ bool cConnection::Receive_Packet()
             return true;
          }
 
+      case PACKETTYPE_ACK_BITFIELD: {
+				//
+				// The packet id is the first reliable id the sender hasn't
+				// received yet. See cPacketWindow.
+				//
+            if (!Sender_Id_Tests(packet)) {
+               packet.Flush();
+               return true;
+            }
+
+            WWASSERT(p_sender_rhost != NULL);
+				cNetStats & sender_stats = p_sender_rhost->Get_Stats();
+            sender_stats.StatSample[STAT_AckCountRcv]++;
+
+				int top_id = packet.Get(top_id);
+				ULONG mask = packet.Get(mask);
+            p_sender_rhost->Acknowledge_Packets(packet_id, top_id, mask);
+
+            return true;
+         }
+
       default:
          DIE;
          break;
@@ -998,20 +1054,22 @@ void cConnection::Process_Connection_Request(cPacket & packet)
    int new_rhost_id = ID_UNKNOWN;
 
 	//
-   // Make sure we don't already know him, and find him a slot
+   // Make sure we don't already know him
+   //
+   if (Address_To_Rhostid(p_address) != INVALID_RHOST_ID) {
+      //
+      // He already has an id. This must be a resend or duplicate.
+      //
+      return;
+   }
+
+	//
+   // Find him a slot
    //
    for (int player_id = MinRHost; player_id <= MaxRHost; player_id++) {
-		if (PRHost[player_id] != NULL) {
-         if (!cSinglePlayerData::Is_Single_Player() &&
-            cNetUtil::Is_Same_Address(&(PRHost[player_id]->Get_Address()),
-            p_address)) {
-            //
-            // He already has an id. This must be a resend or duplicate.
-            //
-            return;
-         }
-		} else if (new_rhost_id == ID_UNKNOWN) {
+		if (PRHost[player_id] == NULL) {
 			new_rhost_id = player_id;
+			break;
 		}
    }
 
@@ -1045,6 +1103,9 @@ void cConnection::Process_Connection_Request(cPacket & packet)
       WWASSERT(NumRHosts <= MaxRHost - MinRHost + 1);
       PRHost[new_rhost_id]->Set_Address(*p_address);
 		PRHost[new_rhost_id]->Set_Maximum_Bps(bbo);
+      if (!cSinglePlayerData::Is_Single_Player()) {
+         RHostMap.Add(*p_address, new_rhost_id);
+      }
 
       Send_Accept_Sc(new_rhost_id);
 
@@ -1093,17 +1154,13 @@ int cConnection::Address_To_Rhostid(const SOCKADDR_IN* p_address)
       return INVALID_RHOST_ID;
    }
 
-   //
-   // TSS - this searching is very inefficient.
-   //
-   for (int rhost_id = MinRHost; rhost_id <= MaxRHost; rhost_id++) {
-      if (PRHost[rhost_id] != NULL &&
-         cNetUtil::Is_Same_Address(&(PRHost[rhost_id]->Get_Address()), p_address)) {
-         return rhost_id;
-      }
+   int rhost_id = RHostMap.Find(*p_address);
+   if (rhost_id == cRemoteHostMap::INVALID_ID) {
+      return INVALID_RHOST_ID;
    }
 
-   return INVALID_RHOST_ID;
+   WWASSERT(rhost_id >= MinRHost && rhost_id <= MaxRHost && PRHost[rhost_id] != NULL);
+   return rhost_id;
 }
 
 
@@ -1255,22 +1312,14 @@ int cConnection::Low_Level_Receive_Wrapper(cPacket & packet)
 
 						WWASSERT(ServerBrokenConnectionHandler != NULL);
 
-						for (int i=MinRHost ; i<MaxRHost ; i++) {
-							cRemoteHost *rhost_ptr = PRHost[i];
-
-							if (rhost_ptr) {
-								SOCKADDR_IN rhost_addr = rhost_ptr->Get_Address();
-
-								if (memcmp(ip_address, &rhost_addr.sin_addr.s_addr, 4) == 0) {
-									if (rhost_addr.sin_port == port) {
-										int rhost_id = rhost_ptr->Get_Id();
-                  				Destroy_Connection(rhost_id);
-										ServerBrokenConnectionHandler(rhost_id);
-										found_bad = true;
-										break;
-									}
-								}
-							}
+						ULONG ip;
+						memcpy(&ip, ip_address, 4);
+						int rhost_id = RHostMap.Find(ip, port);
+						if (rhost_id != cRemoteHostMap::INVALID_ID) {
+							WWASSERT(PRHost[rhost_id] != NULL);
+							Destroy_Connection(rhost_id);
+							ServerBrokenConnectionHandler(rhost_id);
+							found_bad = true;
 						}
 						if (!found_bad) {
 							WWDEBUG_SAY(("WSAECONNRESET address not in host list\n"));
@@ -1317,25 +1366,42 @@ int cConnection::Low_Level_Receive_Wrapper(cPacket & packet)
 	return ret_code;
 }
 
+//------------------------------------------------------------------------------------
+//
+// Hand the packet just received to an rhost receive window without copying it.
+// Returns false if the rhost discarded it.
+//
+bool cConnection::Adopt_Received_Packet(cRemoteHost * p_rhost, BYTE list_type)
+{
+	WWASSERT(p_rhost != NULL);
+	WWASSERT(PReceivePacket != NULL);
+
+	if (!p_rhost->Adopt_Packet(PReceivePacket, list_type)) {
+		return false;
+	}
+
+	//
+	// The window owns it now, so get a fresh one for the next receive.
+	//
+	PReceivePacket = new cPacket;
+	WWASSERT(PReceivePacket != NULL);
+	return true;
+}
+
 //------------------------------------------------------------------------------------
 int cConnection::Receive_Wrapper(cPacket & packet)
 {
-	cPacket full_packet;
-	int ret_code = Low_Level_Receive_Wrapper(full_packet);
+	//
+	// The datagram is received straight into the app packet and its header
+	// stripped in place. A packet whose header doesn't fit the datagram is
+	// left with an undefined type.
+	//
+	int ret_code = Low_Level_Receive_Wrapper(packet);
 
 	if (ret_code > 0) {
-		//
-		// We won't be able to read the header from the full packet unless we
-		// set the bit length (approximately).
-		// The returned packet object will have the exact bit length set correctly.
-		//
-		full_packet.Set_Bit_Length(ret_code * 8);
-
-		cPacket::Construct_App_Packet(packet, full_packet);
+		bool is_valid = packet.Construct_App_Packet_In_Place(ret_code);
 
-#ifndef WRAPPER_CRC
-		if (packet.Is_Crc_Correct()) {
-#endif //WRAPPER_CRC
+		if (is_valid) {
 			//
 			// Update receive stats
 			//
@@ -1343,9 +1409,7 @@ int cConnection::Receive_Wrapper(cPacket & packet)
 			WWASSERT(packet_type >= PACKETTYPE_FIRST && packet_type <= PACKETTYPE_LAST);
 			PStatList->Increment_Num_Msg_Recd(packet_type);
 			PStatList->Increment_Num_Byte_Recd(packet_type, ret_code);
-#ifndef WRAPPER_CRC
 		}
-#endif //WRAPPER_CRC
 	}
 
 	return ret_code;
@@ -1717,6 +1781,67 @@ void cConnection::Send_Ack(LPSOCKADDR_IN p_address, int packet_id)
    Send_Packet_To_Address(packet, p_address);
 }
 
+//-----------------------------------------------------------------------------
+void cConnection::Send_Ack_Bitfield(cRemoteHost * p_rhost, int top_id)
+{
+   WWASSERT(p_rhost != NULL);
+   WWASSERT(LocalId != ID_UNKNOWN);
+
+	int first_missing_id;
+	ULONG mask;
+	p_rhost->Get_Ack_Bitfield(top_id, first_missing_id, mask);
+
+	cPacket packet;
+
+	packet.Set_Type(PACKETTYPE_ACK_BITFIELD);
+	packet.Set_Id(first_missing_id);
+	packet.Set_Sender_Id(LocalId);
+	packet.Add(top_id);
+	packet.Add(mask);
+
+   //
+   // Acks are unreliable
+   //
+   p_rhost->Get_Stats().StatSample[STAT_AckCountSent]++;
+   p_rhost->Get_Stats().StatSample[STAT_UPktSent]++;
+   p_rhost->Get_Stats().StatSample[STAT_UByteSent] += packet.Get_Compressed_Size_Bytes();
+
+   Send_Packet_To_Address(packet, &(p_rhost->Get_Address()));
+}
+
+//-----------------------------------------------------------------------------
+//
+// Ack everything that arrived from each remote host this frame, instead of
+// sending one ack per packet. The first ack's mask covers the newest packets.
+// If a packet that was held up behind them arrived too, and is too far back
+// for that mask, it gets a second ack of its own.
+//
+void cConnection::Send_Pending_Acks()
+{
+	if (LocalId == ID_UNKNOWN) {
+		return;
+	}
+
+	for (int rhost_id = MinRHost; rhost_id <= MaxRHost; rhost_id++) {
+
+		cRemoteHost * p_rhost = PRHost[rhost_id];
+		if (p_rhost == NULL || !p_rhost->Is_Ack_Pending()) {
+			continue;
+		}
+
+		int top_id = p_rhost->Get_Packet_Window(RELIABLE_RCV_LIST).Get_End_Id() - 1;
+		Send_Ack_Bitfield(p_rhost, top_id);
+
+		int lowest_id = p_rhost->Get_Ack_Lowest_Id();
+		if (lowest_id <= top_id - cPacketWindow::ACK_MASK_BITS &&
+			lowest_id >= p_rhost->Get_Reliable_Packet_Rcv_Id()) {
+			Send_Ack_Bitfield(p_rhost, lowest_id + cPacketWindow::ACK_MASK_BITS - 1);
+		}
+
+		p_rhost->Clear_Ack_Pending();
+	}
+}
+
 //-----------------------------------------------------------------------------
 void cConnection::Destroy_Connection(int rhost_id)
 {
@@ -1725,6 +1850,9 @@ void cConnection::Destroy_Connection(int rhost_id)
    WWASSERT(InitDone);
    WWASSERT(rhost_id >= MinRHost && rhost_id <= MaxRHost);
    if (PRHost[rhost_id] != NULL) {
+      if (!cSinglePlayerData::Is_Single_Player()) {
+         RHostMap.Remove(PRHost[rhost_id]->Get_Address());
+      }
 		delete PRHost[rhost_id];
 		PRHost[rhost_id] = NULL;
 		NumRHosts--;
@@ -1864,6 +1992,11 @@ void cConnection::Service_Read()
    while (Receive_Packet());
 	}
 
+	{
+	WWPROFILE("Send Acks");
+	Send_Pending_Acks();
+	}
+
    /*
    int time_spent = (int) TIMEGETTIME() - start_time;
 	if (time_spent > cNetUtil::Get_Max_Receive_Time_Ms()) {
@@ -1890,88 +2023,39 @@ void cConnection::Service_Read()
 		if (PRHost[rhost_id] != NULL) {
          PRHost[rhost_id]->Compute_List_Max(RELIABLE_RCV_LIST);
 
-	      for (SLNode<cPacket> * objnode = PRHost[rhost_id]->Get_Packet_List(RELIABLE_RCV_LIST).Head();
-            objnode != NULL;) {
-
-            cPacket * p_packet = objnode->Data();
-            WWASSERT(p_packet != NULL);
-            objnode = objnode->Next();
-
-				int comparison = p_packet->Get_Id() - PRHost[rhost_id]->Get_Reliable_Packet_Rcv_Id();
-
-				if (comparison < 0) {
-					//
-               // Duplicate packet, discard
-               //
-               CombinedStats.StatSample[STAT_DiscardCount]++;
-
-					/*
-					WWDEBUG_SAY(("%s removing duplicate reliable packet (id %d)) [ReliablePacketRcvId is %d]\n",
-                  IsServer ? "Server" : "Client",
-						p_packet->Get_Id(),
-						PRHost[rhost_id]->Get_Reliable_Packet_Rcv_Id()));
-					*/
-
-					PRHost[rhost_id]->Get_Packet_List(RELIABLE_RCV_LIST).Remove_Head();
-					p_packet->Flush();
-					delete p_packet;
-
-            } else if (comparison == 0) {
-
-					/*
-               bool need_abort = false;
-
-					switch (p_packet->Get_Type()) {
-
-                  case PACKETTYPE_KEEPALIVE:
-                  case PACKETTYPE_ACCEPT_SC:
-							//
-							// Don't pass on reliable system packets... they are in
-                     // the list solely to maintain packet sequencing.
-							//
-                     p_packet->Flush();// is this necessary?
-                     break;
+			//
+			// Duplicates were discarded by Add_Packet, so everything in the window
+			// is new. Process packets for as long as the next one in sequence
+			// has arrived.
+			//
+			cPacket * p_packet;
+			while (PRHost[rhost_id] != NULL &&
+				(p_packet = PRHost[rhost_id]->Get_Packet_Window(RELIABLE_RCV_LIST).Peek(
+					PRHost[rhost_id]->Get_Reliable_Packet_Rcv_Id())) != NULL) {
 
-                  case PACKETTYPE_RELIABLE:
-                     need_abort = Demultiplex_R_Or_U_Packet(p_packet, rhost_id);
-                     break;
+				WWASSERT(p_packet->Get_Type() >= PACKETTYPE_FIRST && p_packet->Get_Type() <= PACKETTYPE_LAST);
 
-                  default:
-                     DIE;
-               }
-
-					if (need_abort) {
+				//
+				// Keepalives and accepts are in the window solely to maintain
+				// packet sequencing, don't pass them on.
+				//
+				if (p_packet->Get_Type() == PACKETTYPE_RELIABLE) {
+               bool abort = Demultiplex_R_Or_U_Packet(p_packet, rhost_id);
+					if (abort) {
 						break;
 					}
-					*/
-
-					WWASSERT(p_packet->Get_Type() >= PACKETTYPE_FIRST && p_packet->Get_Type() <= PACKETTYPE_LAST);
-
-					if (p_packet->Get_Type() == PACKETTYPE_RELIABLE) {
-                  bool abort = Demultiplex_R_Or_U_Packet(p_packet, rhost_id);
-						if (abort) {
-							break;
-						}
-					}
-
-					//
-					// This may help detect if the packet got deallocated or something bad...
-					//
-					WWASSERT(p_packet->Get_Type() >= PACKETTYPE_FIRST && p_packet->Get_Type() <= PACKETTYPE_LAST);
+				}
 
-					PRHost[rhost_id]->Get_Packet_List(RELIABLE_RCV_LIST).Remove_Head();
-					p_packet->Flush();
-					delete p_packet;
+				//
+				// This may help detect if the packet got deallocated or something bad...
+				//
+				WWASSERT(p_packet->Get_Type() >= PACKETTYPE_FIRST && p_packet->Get_Type() <= PACKETTYPE_LAST);
 
-					PRHost[rhost_id]->Increment_Reliable_Packet_Rcv_Id();
+				PRHost[rhost_id]->Get_Packet_Window(RELIABLE_RCV_LIST).Remove(p_packet->Get_Id());
+				p_packet->Flush();
+				delete p_packet;
 
-            } else {
-					WWASSERT(comparison > 0);
-					//
-					// We are done... we cannot process the next packet in the list yet.
-					//
-					break;
-				}
+				PRHost[rhost_id]->Increment_Reliable_Packet_Rcv_Id();
          }
 		}
 	}
@@ -2003,28 +2087,27 @@ void cConnection::Service_Read()
 
 			unsigned long list_processing_start = TIMEGETTIME();
 
-	      for (SLNode<cPacket> * objnode = PRHost[rhost_id]->Get_Packet_List(UNRELIABLE_RCV_LIST).Head();
-            objnode != NULL; objnode = objnode->Next()) {
+			//
+			// The window is in id order, so processing it front to back passes
+			// the packets up in sequence even if they arrived out of order.
+			//
+			int end_id = PRHost[rhost_id]->Get_Packet_Window(UNRELIABLE_RCV_LIST).Get_End_Id();
+			for (int packet_id = PRHost[rhost_id]->Get_Packet_Window(UNRELIABLE_RCV_LIST).Get_Base_Id();
+				packet_id < end_id; packet_id++) {
 
-            cPacket * p_packet = objnode->Data();
-            WWASSERT(p_packet != NULL);
-            WWASSERT(p_packet->Get_Id() >= 0);
+            cPacket * p_packet = PRHost[rhost_id]->Get_Packet_Window(UNRELIABLE_RCV_LIST).Peek(packet_id);
+				if (p_packet == NULL) {
+					continue;
+				}
 
 				if (p_packet->Get_Id() < PRHost[rhost_id]->Get_Unreliable_Packet_Rcv_Id()) {
 					//
-               // Duplicate packet, discard
+               // Out of date packet, discard
                //
                CombinedStats.StatSample[STAT_DiscardCount]++;
 
-					/*
-               WWDEBUG_SAY(("Ignoring duplicate unreliable packet (id %d)) [UnreliablePacketRcvId is %d]\n",
-						p_packet->Id, PRHost[rhost_id]->UnreliablePacketRcvId));
-               */
-
             } else {
 
-               //WWASSERT(p_packet->Get_Type() == (BYTE) PACKETTYPE_UNRELIABLE);
-
 					{
 					//WWPROFILE("Demultiplex_R_Or_U_Packet");
                bool abort = Demultiplex_R_Or_U_Packet(p_packet, rhost_id);
@@ -2045,15 +2128,7 @@ void cConnection::Service_Read()
 				//
 				// Destroy list
 				//
-				for (SLNode<cPacket> * objnode = PRHost[rhost_id]->Get_Packet_List(UNRELIABLE_RCV_LIST).Head();
-					objnode != NULL; objnode = objnode->Next()) {
-					cPacket * p_packet = objnode->Data();
-					p_packet->Flush();
-					WWASSERT(p_packet != NULL);
-					delete p_packet;
-				}
-
-				PRHost[rhost_id]->Get_Packet_List(UNRELIABLE_RCV_LIST).Remove_All();
+				PRHost[rhost_id]->Get_Packet_Window(UNRELIABLE_RCV_LIST).Delete_All();
 			}
 		}
 	}
@@ -2082,6 +2157,15 @@ void cConnection::Service_Read()
 				EvictionHandler(rhost_id);
 			}
 		}
+	} else if (PRHost[SERVER_RHOST_ID] != NULL && PRHost[SERVER_RHOST_ID]->Must_Evict() && CanProcess) {
+		//
+		// The server's reliable packets have run too far ahead of what we have
+		// received to ever be delivered in order, so the connection is broken.
+		//
+		WWDEBUG_SAY(("*** WWNET: Reliable receive window overflowed - assuming connection to server is broken.\n"));
+		Destroy_Connection(SERVER_RHOST_ID);
+		WWASSERT(ClientBrokenConnectionHandler != NULL);
+		ClientBrokenConnectionHandler();
 	}
 }
 
@@ -2110,17 +2194,14 @@ void cConnection::Clear_Resend_Counts()
 {
 	//WWDEBUG_SAY(("cConnection::Clear_Resend_Counts()\n"));
 
-   SLNode<cPacket> * objnode;
-	cPacket * p_packet;
 	for (int rhost_id = MinRHost; rhost_id <= MaxRHost; rhost_id++) {
 		if (PRHost[rhost_id] != NULL) {
 
-			for (objnode = PRHost[rhost_id]->Get_Packet_List(RELIABLE_SEND_LIST).Head();
-            objnode != NULL; objnode = objnode->Next()) {
+			cPacketWindow & window = PRHost[rhost_id]->Get_Packet_Window(RELIABLE_SEND_LIST);
+			for (int packet_id = window.Get_Base_Id(); packet_id < window.Get_End_Id(); packet_id++) {
 
-            p_packet = objnode->Data();
-            WWASSERT(p_packet != NULL);
-            if (p_packet->Get_Resend_Count() > 0) {
+            cPacket * p_packet = window.Peek(packet_id);
+            if (p_packet != NULL && p_packet->Get_Resend_Count() > 0) {
 					p_packet->Clear_Resend_Count();
 				}
 			}
@@ -2222,12 +2303,16 @@ void cConnection::Service_Send(bool is_urgent)
          //
          // Send any appropriate reliable queued packets
          //
-	      for (SLNode<cPacket> * objnode = p_rhost->Get_Packet_List(RELIABLE_SEND_LIST).Head();
-            objnode != NULL;) {
+			cPacketWindow & window = p_rhost->Get_Packet_Window(RELIABLE_SEND_LIST);
+	      for (int packet_id = window.Get_Base_Id(); packet_id < window.Get_End_Id(); packet_id++) {
 
-            cPacket * p_packet = objnode->Data();
-            objnode = objnode->Next();
-            WWASSERT(p_packet != NULL);
+            cPacket * p_packet = window.Peek(packet_id);
+				if (p_packet == NULL) {
+					//
+					// Already acked, out of order.
+					//
+					continue;
+				}
 
 				if (p_packet->Get_Resend_Count() > 1) {
 					resent_packets++;
@@ -2352,10 +2437,10 @@ void cConnection::Service_Send(bool is_urgent)
          //
          // Send any appropriate queued packets
          //
-	      for (SLNode<cPacket> * objnode = p_rhost->Get_Packet_List(UNRELIABLE_SEND_LIST).Head();
-            objnode != NULL; objnode = objnode->Next()) {
+			cPacketWindow & window = p_rhost->Get_Packet_Window(UNRELIABLE_SEND_LIST);
+	      for (int packet_id = window.Get_Base_Id(); packet_id < window.Get_End_Id(); packet_id++) {
 
-            cPacket * p_packet = objnode->Data();
+            cPacket * p_packet = window.Peek(packet_id);
             WWASSERT(p_packet != NULL);
 
             p_rhost->Get_Stats().StatSample[STAT_UPktSent]++;
@@ -2368,15 +2453,7 @@ void cConnection::Service_Send(bool is_urgent)
          }
 
 	      // destroy all
-			for (SLNode<cPacket> * objnode = p_rhost->Get_Packet_List(UNRELIABLE_SEND_LIST).Head();
-            objnode != NULL; objnode = objnode->Next()) {
-
-            cPacket * p_packet = objnode->Data();
-            WWASSERT(p_packet != NULL);
-				p_packet->Flush();
-				delete p_packet;
-         }
-			p_rhost->Get_Packet_List(UNRELIABLE_SEND_LIST).Remove_All();
+			window.Delete_All();
       }
    }
 
@@ -38,6 +38,7 @@
 #include "slist.h"
 #include "wwpacket.h"
 #include "packettype.h"
+#include "rhostmap.h"
 
 //
 // A server can have this many clients (a client has only 1 rhost: the server)
@@ -142,6 +143,7 @@ class cConnection
 		void Set_Rhost_Expect_Packet_Flood(int id, bool state);
 		void Allow_Extra_Timeout_For_Loading(void);
 		void Allow_Packet_Processing(bool set) {CanProcess = set;}
+		SOCKET Get_Socket() const {return Sock;}
 
 		void Install_Accept_Handler(Accept_Handler handler);
 		void Install_Refusal_Handler(Refusal_Handler handler);
@@ -178,9 +180,12 @@ class cConnection
       int Send_Wrapper(cPacket & packet, int addressee);
 		int Low_Level_Receive_Wrapper(cPacket & packet);
       int Receive_Wrapper(cPacket & packet);
+      bool Adopt_Received_Packet(cRemoteHost * p_rhost, BYTE list_type);
       void Set_R_And_U_Packet_Id(cPacket & packet, int addressee, BYTE send_type);
       void R_And_U_Send(cPacket & packet, int addressee);
       void Send_Ack(LPSOCKADDR_IN p_address, int reliable_packet_id);
+      void Send_Ack_Bitfield(cRemoteHost * p_rhost, int top_id);
+      void Send_Pending_Acks();
 		void Send_Refusal_Sc(LPSOCKADDR_IN p_address, REFUSAL_CODE refusal_code);
       void Process_Connection_Request(cPacket & packet);
       void Send_Keepalives();
@@ -215,6 +220,8 @@ class cConnection
 		int ServiceCount;
 		bool IsBadConnection;
 		cRemoteHost ** PRHost;
+		cRemoteHostMap RHostMap;	// address -> rhost id
+		cPacket * PReceivePacket;	// received into directly, handed to an rhost when kept
 		int MinRHost;
 		int MaxRHost;
       int					NumRHosts;
@@ -46,8 +46,9 @@ enum
    PACKETTYPE_ACCEPT_SC,
    PACKETTYPE_REFUSAL_SC,
 	PACKETTYPE_FIREWALL_PROBE,
+	PACKETTYPE_ACK_BITFIELD,		// acks every reliable packet received so far, see cPacketWindow
 
-   PACKETTYPE_LAST = PACKETTYPE_FIREWALL_PROBE,
+   PACKETTYPE_LAST = PACKETTYPE_ACK_BITFIELD,
 
 	PACKETTYPE_COUNT
 };
@@ -0,0 +1,267 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//
+// Filename:     packetwindow.cpp
+// Project:      wwnet
+// Description:  Packets queued for or from a remote host, indexed by id
+//
+//-----------------------------------------------------------------------------
+#include "packetwindow.h" // I WANNA BE FIRST!
+
+#include <string.h>
+
+#include "wwpacket.h"
+#include "wwdebug.h"
+
+//-----------------------------------------------------------------------------
+cPacketWindow::cPacketWindow(int capacity) :
+	Slots(NULL),
+	Capacity(1),
+	BaseId(0),
+	EndId(0),
+	Count(0)
+{
+	WWASSERT(capacity > 0);
+
+	//
+	// The capacity must be a power of two so that an id can be masked to a slot.
+	//
+	while (Capacity < capacity) {
+		Capacity <<= 1;
+	}
+
+	Slots = new cPacket * [Capacity];
+	memset(Slots, 0, Capacity * sizeof(cPacket *));
+}
+
+//-----------------------------------------------------------------------------
+cPacketWindow::~cPacketWindow()
+{
+	Delete_All();
+	delete [] Slots;
+	Slots = NULL;
+}
+
+//-----------------------------------------------------------------------------
+void cPacketWindow::Free_Packet(cPacket * p_packet)
+{
+	WWASSERT(p_packet != NULL);
+	p_packet->Flush();
+	delete p_packet;
+}
+
+//-----------------------------------------------------------------------------
+cPacket * cPacketWindow::Peek(int id) const
+{
+	if (id < BaseId || id >= EndId) {
+		return NULL;
+	}
+
+	return Slot(id);
+}
+
+//-----------------------------------------------------------------------------
+//
+// Returns DISCARDED if the packet is older than the window or a duplicate and
+// OUT_OF_RANGE if it is too far ahead of the window for the ring to hold. The
+// window only takes ownership of the packet if it returns ADDED.
+//
+cPacketWindow::ADD_RESULT cPacketWindow::Add(cPacket * p_packet)
+{
+	WWASSERT(p_packet != NULL);
+
+	int id = p_packet->Get_Id();
+	if (id < BaseId) {
+		return DISCARDED;
+	}
+
+	if (id - BaseId >= MAX_CAPACITY) {
+		return OUT_OF_RANGE;
+	}
+
+	if (id - BaseId >= Capacity) {
+		Grow(id);
+	}
+
+	//
+	// Slots outside [BaseId, EndId) are always empty, so an occupied slot
+	// means this is a duplicate.
+	//
+	cPacket * & slot = Slot(id);
+	if (slot != NULL) {
+		return DISCARDED;
+	}
+
+	slot = p_packet;
+	Count++;
+	if (id >= EndId) {
+		EndId = id + 1;
+	}
+
+	return ADDED;
+}
+
+//-----------------------------------------------------------------------------
+cPacket * cPacketWindow::Remove(int id)
+{
+	if (id < BaseId || id >= EndId) {
+		return NULL;
+	}
+
+	cPacket * & slot = Slot(id);
+	cPacket * p_packet = slot;
+	if (p_packet != NULL) {
+		slot = NULL;
+		Count--;
+		WWASSERT(Count >= 0);
+	}
+
+	return p_packet;
+}
+
+//-----------------------------------------------------------------------------
+//
+// Move the start of the window forward. Anything left below the new base is
+// no longer wanted and is deleted.
+//
+void cPacketWindow::Set_Base_Id(int id)
+{
+	WWASSERT(id >= BaseId);
+
+	int last = (id < EndId) ? id : EndId;
+	for (int i = BaseId; i < last && Count > 0; i++) {
+		cPacket * p_packet = Remove(i);
+		if (p_packet != NULL) {
+			Free_Packet(p_packet);
+		}
+	}
+
+	BaseId = id;
+	if (EndId < BaseId) {
+		EndId = BaseId;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void cPacketWindow::Skip_Empty()
+{
+	while (BaseId < EndId && Slot(BaseId) == NULL) {
+		BaseId++;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void cPacketWindow::Delete_All()
+{
+	Set_Base_Id(EndId);
+	WWASSERT(Count == 0);
+}
+
+//-----------------------------------------------------------------------------
+void cPacketWindow::Grow(int id)
+{
+	int new_capacity = Capacity;
+	while (id - BaseId >= new_capacity) {
+		new_capacity <<= 1;
+	}
+
+	cPacket ** new_slots = new cPacket * [new_capacity];
+	memset(new_slots, 0, new_capacity * sizeof(cPacket *));
+
+	for (int i = BaseId; i < EndId; i++) {
+		new_slots[i & (new_capacity - 1)] = Slot(i);
+	}
+
+	delete [] Slots;
+	Slots = new_slots;
+	Capacity = new_capacity;
+}
+
+//-----------------------------------------------------------------------------
+void cPacketWindow::Get_Ack_Bitfield(int top_id, int & first_missing_id, ULONG & mask) const
+{
+	first_missing_id = BaseId;
+	while (first_missing_id < EndId && Slot(first_missing_id) != NULL) {
+		first_missing_id++;
+	}
+
+	mask = 0;
+	for (int bit = 0; bit < ACK_MASK_BITS; bit++) {
+		int id = top_id - bit;
+		if (id <= first_missing_id) {
+			//
+			// The cumulative id covers everything from here down.
+			//
+			break;
+		}
+		if (id < EndId && Slot(id) != NULL) {
+			mask |= (1UL << bit);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void cPacketWindow::Free_Newest(cPacket * p_packet, cPacket ** p_newest)
+{
+	if (*p_newest == NULL || (*p_newest)->Get_Id() < p_packet->Get_Id()) {
+		if (*p_newest != NULL) {
+			Free_Packet(*p_newest);
+		}
+		*p_newest = p_packet;
+	} else {
+		Free_Packet(p_packet);
+	}
+}
+
+//-----------------------------------------------------------------------------
+int cPacketWindow::Acknowledge(int first_missing_id, int top_id, ULONG mask, cPacket ** p_newest)
+{
+	WWASSERT(p_newest != NULL);
+
+	*p_newest = NULL;
+	int removed = 0;
+
+	//
+	// Everything before first_missing_id has arrived.
+	//
+	int last = (first_missing_id < EndId) ? first_missing_id : EndId;
+	for (int id = BaseId; id < last && Count > 0; id++) {
+		cPacket * p_packet = Remove(id);
+		if (p_packet != NULL) {
+			Free_Newest(p_packet, p_newest);
+			removed++;
+		}
+	}
+
+	//
+	// Then the selective part.
+	//
+	for (int bit = 0; mask != 0 && bit < ACK_MASK_BITS; bit++) {
+		if (mask & (1UL << bit)) {
+			mask &= ~(1UL << bit);
+			cPacket * p_packet = Remove(top_id - bit);
+			if (p_packet != NULL) {
+				Free_Newest(p_packet, p_newest);
+				removed++;
+			}
+		}
+	}
+
+	Skip_Empty();
+	return removed;
+}
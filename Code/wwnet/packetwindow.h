@@ -0,0 +1,111 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+//
+// Filename:     packetwindow.h
+// Project:      wwnet
+// Description:  Packets queued for or from a remote host, indexed by id
+//
+//-----------------------------------------------------------------------------
+#if defined(_MSV_VER)
+#pragma once
+#endif
+
+#ifndef PACKETWINDOW_H
+#define PACKETWINDOW_H
+
+#include "bittype.h"
+
+class cPacket;
+
+//-----------------------------------------------------------------------------
+//
+// A cPacketWindow holds the packets with ids in [Base_Id, End_Id). Slots are a
+// ring indexed by packet id, so adding, finding and removing a packet doesn't
+// depend on how many others are queued. The ring doubles if a packet arrives
+// beyond the end of it, up to MAX_CAPACITY.
+//
+// Packets are taken from the cPacket pool. The window owns the packets it
+// holds; Remove() hands ownership back to the caller.
+//
+// Acknowledgements are cumulative plus a bitfield. The id of the ack packet is
+// the first reliable id that hasn't been received yet (everything before it
+// has been). The ack also carries a top id and a mask where bit n is set if
+// top - n has been received. The receiver picks the top id so that the mask
+// covers whatever arrived since its last ack; that way packets that arrive
+// well after a lost one are still acked, and a lost ack is made good by the
+// next one.
+//
+class cPacketWindow
+{
+	public:
+		cPacketWindow(int capacity = DEFAULT_CAPACITY);
+		~cPacketWindow();
+
+		enum {DEFAULT_CAPACITY	= 64};
+		enum {MAX_CAPACITY		= 1 << 16};	// a bogus id can't make the ring huge
+		enum {ACK_MASK_BITS		= 32};
+
+		typedef enum {
+			ADDED,
+			DISCARDED,		// older than the window or a duplicate
+			OUT_OF_RANGE	// more than MAX_CAPACITY ahead of the base id
+		} ADD_RESULT;
+
+		int		Get_Base_Id() const					{return BaseId;}
+		int		Get_End_Id() const					{return EndId;}
+		int		Get_Count() const						{return Count;}
+		int		Get_Capacity() const					{return Capacity;}
+
+		cPacket *	Peek(int id) const;
+		ADD_RESULT	Add(cPacket * p_packet);
+		cPacket *	Remove(int id);
+		void			Set_Base_Id(int id);
+		void			Skip_Empty();
+		void			Delete_All();
+
+		//
+		// Receiving side: describe what has arrived, with the mask ending at top_id.
+		//
+		void			Get_Ack_Bitfield(int top_id, int & first_missing_id, ULONG & mask) const;
+
+		//
+		// Sending side: remove (and delete) every packet covered by an ack. The
+		// newest of them is returned in p_newest instead of being deleted so
+		// that the caller can take a round trip sample from it.
+		//
+		int			Acknowledge(int first_missing_id, int top_id, ULONG mask, cPacket ** p_newest);
+
+	private:
+		cPacketWindow(const cPacketWindow& rhs); // Disallow copy (compile/link time)
+		cPacketWindow& operator=(const cPacketWindow& rhs); // Disallow assignment (compile/link time)
+
+		cPacket * &	Slot(int id) const					{return Slots[id & (Capacity - 1)];}
+		void			Grow(int id);
+		static void	Free_Packet(cPacket * p_packet);
+		static void	Free_Newest(cPacket * p_packet, cPacket ** p_newest);
+
+		cPacket **	Slots;
+		int			Capacity;
+		int			BaseId;
+		int			EndId;
+		int			Count;
+};
+
+//-----------------------------------------------------------------------------
+
+#endif // PACKETWINDOW_H
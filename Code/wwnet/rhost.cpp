@@ -52,6 +52,7 @@ cRemoteHost::cRemoteHost() :
    LastKeepaliveTimeMs(TIMEGETTIME()),
    IsFlowControlEnabled(cConnection::Is_Flow_Control_Enabled()),
    MustEvict(false),
+	AckLowestId(NO_ACK_PENDING),
    LastReliableSendId(-2),		// dummy value
    LastUnreliableSendId(-2),	// dummy value
 	ResendTimeoutMs(cNetUtil::Get_Default_Resend_Timeout_Ms()),
@@ -136,7 +137,7 @@ void cRemoteHost::Set_Last_Service_Count(int service_count)
 void cRemoteHost::Compute_List_Max(int list_type)
 {
 	WWASSERT(list_type >= 0 && list_type < 4);
-	ListMax[list_type] = PacketList[list_type].Get_Count();
+	ListMax[list_type] = PacketWindow[list_type].Get_Count();
 }
 
 //-----------------------------------------------------------------------------
@@ -169,23 +170,37 @@ SOCKADDR_IN & cRemoteHost::Get_Address()
 //-----------------------------------------------------------------------------
 cRemoteHost::~cRemoteHost()
 {
-   SLNode<cPacket> * objnode;
-   cPacket * p_packet;
-   for (int list_type = 0; list_type < 4; list_type++) {
-      for (objnode = PacketList[list_type].Head(); objnode != NULL;) {
-         p_packet = objnode->Data();
-         WWASSERT(p_packet != NULL);
-         objnode = objnode->Next();
-         PacketList[list_type].Remove(p_packet);
-		   p_packet->Flush();
-         delete p_packet;
-      }
-   }
+	//
+	// The packet windows delete anything still queued.
+	//
+}
+
+//-----------------------------------------------------------------------------
+void cRemoteHost::Set_Reliable_Packet_Rcv_Id(int id)
+{
+	ReliablePacketRcvId = id;
+
+	//
+	// Everything before the next expected id has been processed.
+	//
+	if (id > PacketWindow[RELIABLE_RCV_LIST].Get_Base_Id()) {
+		PacketWindow[RELIABLE_RCV_LIST].Set_Base_Id(id);
+	}
 }
 
 //------------------------------------------------------------------------------------
-void cRemoteHost::Add_Packet(cPacket & packet, BYTE list_type)
+//
+// Takes ownership of a heap allocated packet. Returns false if the packet was
+// discarded as a duplicate, as out of date or because it was too far ahead of
+// the window, in which case the caller still owns it. A reliable packet that
+// is too far ahead can never be delivered in order, so the host is flagged for
+// eviction (see Must_Evict).
+//
+bool cRemoteHost::Adopt_Packet(cPacket * p_packet, BYTE list_type)
 {
+	WWASSERT(p_packet != NULL);
+	cPacket & packet = *p_packet;
+
 	WWASSERT(
       list_type == RELIABLE_SEND_LIST   ||
       list_type == RELIABLE_RCV_LIST    ||
@@ -209,37 +224,96 @@ void cRemoteHost::Add_Packet(cPacket & packet, BYTE list_type)
 		LastUnreliableSendId = packet.Get_Id();
    }
 
+	cPacketWindow & window = PacketWindow[list_type];
+
+	if (list_type == UNRELIABLE_RCV_LIST && window.Get_Count() == 0 &&
+		packet.Get_Id() > window.Get_Base_Id()) {
+		//
+		// Unreliable ids can jump after a burst of loss. Don't make the window
+		// span the gap when there's nothing in it.
+		//
+		window.Set_Base_Id(packet.Get_Id());
+	}
+
+	if (packet.Get_Id() < window.Get_Base_Id() || window.Peek(packet.Get_Id()) != NULL) {
+		WWASSERT(list_type == RELIABLE_RCV_LIST || list_type == UNRELIABLE_RCV_LIST);
+		return false;
+	}
+
+	cPacketWindow::ADD_RESULT result = window.Add(p_packet);
+
+	if (result == cPacketWindow::OUT_OF_RANGE) {
+		WWASSERT(list_type == RELIABLE_RCV_LIST || list_type == UNRELIABLE_RCV_LIST);
+
+		if (list_type == UNRELIABLE_RCV_LIST) {
+			//
+			// Unreliable packets that far behind are worthless. Drop them to make
+			// room rather than the newest one.
+			//
+			window.Set_Base_Id(packet.Get_Id() - cPacketWindow::MAX_CAPACITY + 1);
+			result = window.Add(p_packet);
+		} else {
+			WWDEBUG_SAY(("cRemoteHost::Adopt_Packet: reliable packet %d is too far ahead of %d\n",
+				packet.Get_Id(), window.Get_Base_Id()));
+			MustEvict = true;
+		}
+	}
+
+	return result == cPacketWindow::ADDED;
+}
+
+//------------------------------------------------------------------------------------
+//
+// Adds a copy of the packet. Returns false if it was discarded.
+//
+bool cRemoteHost::Add_Packet(cPacket & packet, BYTE list_type)
+{
    cPacket * p_packet = new cPacket;
    WWASSERT(p_packet != NULL);
    *p_packet = packet; // copy data
 
-	if (list_type == RELIABLE_SEND_LIST || list_type == UNRELIABLE_SEND_LIST) {
-		PacketList[list_type].Add_Tail(p_packet);
-	} else {
+	if (!Adopt_Packet(p_packet, list_type)) {
+		p_packet->Flush();
+		delete p_packet;
+		return false;
+	}
 
-		//
-		// Locate insertion point according to packet id
-		//
-		SLNode<cPacket> * objnode;
-		cPacket * obj = NULL;
-		for (objnode = PacketList[list_type].Head(); objnode; objnode = objnode->Next()) {
-			obj = objnode->Data();
-			WWASSERT(obj != NULL);
-
-			if (obj->Get_Id() > packet.Get_Id()) {
-				break;
+	return true;
+}
+
+//------------------------------------------------------------------------------------
+void cRemoteHost::Record_Round_Trip(cPacket * p_packet)
+{
+	WWASSERT(p_packet != NULL);
+
+	// Packets that require a resend shouldn't count towards ping time calculations. It may be being removed because
+	// the ACK to the first send just came in and if we just resent it then the ping time will look really low so we get
+	// biased towards a low resend timeout value on connections of variable quality. ST - 12/7/2001 12:48PM
+	if (p_packet->Get_Resend_Count() == 0 || NumInternalPings == 0) {
+		unsigned long time = TIMEGETTIME();
+		int ping_time = time - p_packet->Get_Send_Time();
+
+		if (p_packet->Get_Resend_Count() != 0) {
+			WWASSERT(NumInternalPings == 0);
+
+			// If we are not getting any timing info at all then we need to do something. Use the first send time. It's going
+			// to make it big but that should cut down on the resends and let us get better timing info.
+			if (NumInternalPings == 0) {
+				ping_time = TIMEGETTIME() - p_packet->Get_First_Send_Time();
 			}
 		}
-
-		//
-		// Insert packet at designated point
-		// TSS - this is inefficient: we have already parsed the
-		// list once
-		//
-		if (objnode == NULL) {
-			PacketList[list_type].Add_Tail(p_packet);
+		TotalInternalPingtimeMs += ping_time;
+		NumInternalPings++;
+		if (NumInternalPings > 0) {
+			AverageInternalPingtimeMs = cMathUtil::Round(TotalInternalPingtimeMs / (double) NumInternalPings);
 		} else {
-			PacketList[list_type].Insert_Before(p_packet, obj);
+			AverageInternalPingtimeMs = 0;
+		}
+		if (ping_time < MinInternalPingtimeMs) {
+			MinInternalPingtimeMs = ping_time;
+		}
+		if (ping_time > MaxInternalPingtimeMs) {
+			MaxInternalPingtimeMs = ping_time;
 		}
 	}
 }
@@ -254,67 +328,60 @@ void cRemoteHost::Remove_Packet(int packet_id, BYTE list_type)
       list_type == UNRELIABLE_SEND_LIST ||
       list_type == UNRELIABLE_RCV_LIST);
 
-   SLNode<cPacket> * objnode;
-	for (objnode = PacketList[list_type].Head(); objnode != NULL;) {
-
-      cPacket * p_packet = objnode->Data();
-      WWASSERT(p_packet != NULL);
-      objnode = objnode->Next();
+	cPacket * p_packet = PacketWindow[list_type].Remove(packet_id);
+	if (p_packet != NULL) {
 
-		if (packet_id == p_packet->Get_Id()) {
-
-         if (list_type == RELIABLE_SEND_LIST) {// &&
+		if (list_type == RELIABLE_SEND_LIST) {
+			Record_Round_Trip(p_packet);
+		}
 
-				// Packets that require a resend shouldn't count towards ping time calculations. It may be being removed because
-				// the ACK to the first send just came in and if we just resent it then the ping time will look really low so we get
-				// biased towards a low resend timeout value on connections of variable quality. ST - 12/7/2001 12:48PM
-				if (p_packet->Get_Resend_Count() == 0 || NumInternalPings == 0) {
-					unsigned long time = TIMEGETTIME();
-					int ping_time = time - p_packet->Get_Send_Time();
+		//
+		// Send windows close up behind acked packets. Receive windows only move
+		// on as packets are processed in order.
+		//
+		if (list_type == RELIABLE_SEND_LIST || list_type == UNRELIABLE_SEND_LIST) {
+			PacketWindow[list_type].Skip_Empty();
+		}
 
-					if (p_packet->Get_Resend_Count() != 0) {
-						WWASSERT(NumInternalPings == 0);
+		p_packet->Flush();
+		delete p_packet;
+	}
+}
 
-						// If we are not getting any timing info at all then we need to do something. Use the first send time. It's going
-						// to make it big but that should cut down on the resends and let us get better timing info.
-						if (NumInternalPings == 0) {
-							ping_time = TIMEGETTIME() - p_packet->Get_First_Send_Time();
-						}
-					}
-					TotalInternalPingtimeMs += ping_time;
-					NumInternalPings++;
-					if (NumInternalPings > 0) {
-						AverageInternalPingtimeMs = cMathUtil::Round(TotalInternalPingtimeMs / (double) NumInternalPings);
-					} else {
-						AverageInternalPingtimeMs = 0;
-					}
-					if (ping_time < MinInternalPingtimeMs) {
-						MinInternalPingtimeMs = ping_time;
-					}
-					if (ping_time > MaxInternalPingtimeMs) {
-						MaxInternalPingtimeMs = ping_time;
-#if (0)
-						int candidate_resend_timeout_ms = (int) (MaxInternalPingtimeMs
-							* 1.1);
-						if (candidate_resend_timeout_ms > ResendTimeoutMs) {
-							ResendTimeoutMs = candidate_resend_timeout_ms;
-							//WWDEBUG_SAY((">> ResendTimeoutMs for rhost %d = %d\n", Id, ResendTimeoutMs));
-						}
-#endif //(0)
-					}
-				}
-			}
+//------------------------------------------------------------------------------------
+//
+// Handle a PACKETTYPE_ACK_BITFIELD. Only the newest packet it covers is used
+// as a round trip sample; older ones may have been waiting on an ack that was
+// lost and would make the ping look worse than it is.
+//
+void cRemoteHost::Acknowledge_Packets(int first_missing_id, int top_id, ULONG mask)
+{
+	cPacket * p_newest = NULL;
+	PacketWindow[RELIABLE_SEND_LIST].Acknowledge(first_missing_id, top_id, mask, &p_newest);
 
-         //if (list_type == RELIABLE_SEND_LIST) {
-				//WWDEBUG_SAY(("Removing packet %d from RELIABLE_SEND_LIST\n", packet_id));
-			//}
+	if (p_newest != NULL) {
+		Record_Round_Trip(p_newest);
+		p_newest->Flush();
+		delete p_newest;
+	}
+}
 
-         PacketList[list_type].Remove(p_packet);
-			p_packet->Flush();
-         delete p_packet;
+//------------------------------------------------------------------------------------
+void cRemoteHost::Get_Ack_Bitfield(int top_id, int & first_missing_id, ULONG & mask) const
+{
+	PacketWindow[RELIABLE_RCV_LIST].Get_Ack_Bitfield(top_id, first_missing_id, mask);
+}
 
-			break;
-      }
+//------------------------------------------------------------------------------------
+//
+// Note that a reliable packet needs acking. Duplicates count too, since the
+// sender only resends when it hasn't seen our ack.
+//
+void cRemoteHost::Set_Ack_Pending(int packet_id)
+{
+	WWASSERT(packet_id >= 0);
+	if (AckLowestId == NO_ACK_PENDING || packet_id < AckLowestId) {
+		AckLowestId = packet_id;
 	}
 }
 
@@ -530,7 +597,7 @@ bool cRemoteHost::Is_Outgoing_Flooded(void)
 	// 2. An excessive number of packets in the out queue that are older than the average ping time. Since acks aren't
 	// coming back we resend more and so exacerbate the problem.
 	//
-	int total_in_queue = PacketList[RELIABLE_SEND_LIST].Get_Count();
+	int total_in_queue = PacketWindow[RELIABLE_SEND_LIST].Get_Count();
 
 	// Let's say that if more than 90% of the packets in the queue have been resent then there is a problem.
 	if (total_in_queue > 20 && (TotalResentPacketsInQueue*10) > (total_in_queue*9)) {
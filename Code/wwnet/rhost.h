@@ -33,6 +33,7 @@
 
 #include "netstats.h"
 #include "wwpacket.h"
+#include "packetwindow.h"
 #include "bittype.h"
 #include "slist.h"
 #include "wwdebug.h"
@@ -67,8 +68,17 @@ class cRemoteHost
       cRemoteHost();
       ~cRemoteHost();
 
-		void Add_Packet(cPacket & packet, BYTE list_type);
+		enum {NO_ACK_PENDING = -1};
+
+		bool Add_Packet(cPacket & packet, BYTE list_type);
+		bool Adopt_Packet(cPacket * p_packet, BYTE list_type);
 		void Remove_Packet(int reliable_packet_id, BYTE list_type);
+		void Acknowledge_Packets(int first_missing_id, int top_id, ULONG mask);
+		void Get_Ack_Bitfield(int top_id, int & first_missing_id, ULONG & mask) const;
+		bool Is_Ack_Pending() const						{return AckLowestId != NO_ACK_PENDING;}
+		int Get_Ack_Lowest_Id() const						{return AckLowestId;}
+		void Set_Ack_Pending(int packet_id);
+		void Clear_Ack_Pending()							{AckLowestId = NO_ACK_PENDING;}
       void Toggle_Flow_Control();
 		void Init_Stats();
 		int Get_Last_Service_Count()						{return LastServiceCount;}
@@ -119,18 +129,18 @@ class cRemoteHost
 
 		void Set_Reliable_Packet_Send_Id(int id)		{ReliablePacketSendId = id;}
 		void Set_Unreliable_Packet_Send_Id(int id)	{UnreliablePacketSendId = id;}
-		void Set_Reliable_Packet_Rcv_Id(int id)		{ReliablePacketRcvId = id;}
+		void Set_Reliable_Packet_Rcv_Id(int id);
 		void Set_Unreliable_Packet_Rcv_Id(int id)		{UnreliablePacketRcvId = id;}
 
 		void Increment_Reliable_Packet_Send_Id()		{ReliablePacketSendId++;}
 		void Increment_Unreliable_Packet_Send_Id()	{UnreliablePacketSendId++;}
-		void Increment_Reliable_Packet_Rcv_Id()		{ReliablePacketRcvId++;}
+		void Increment_Reliable_Packet_Rcv_Id()		{Set_Reliable_Packet_Rcv_Id(ReliablePacketRcvId + 1);}
 		void Increment_Unreliable_Packet_Rcv_Id()		{UnreliablePacketRcvId++;}
 
 		unsigned long Get_Last_Keepalive_Time_Ms() const	{return LastKeepaliveTimeMs;}
 		void Set_Last_Keepalive_Time_Ms(unsigned long time_ms)	{LastKeepaliveTimeMs = time_ms;}
 
-      SList<cPacket> & Get_Packet_List(int index)	{WWASSERT(index >= 0 && index < 4); return PacketList[index];}
+      cPacketWindow & Get_Packet_Window(int index)	{WWASSERT(index >= 0 && index < 4); return PacketWindow[index];}
 
 		bool Must_Evict() const								{return MustEvict;}
 		void Set_Must_Evict(bool flag)					{MustEvict = flag;}
@@ -165,6 +175,7 @@ class cRemoteHost
       cRemoteHost& operator=(const cRemoteHost& rhs); // Disallow assignment (compile/link time)
 		void Dam_The_Flood(void);
 		bool Is_Outgoing_Flooded(void);
+		void Record_Round_Trip(cPacket * p_packet);
 
 
 		cNetStats		Stats;
@@ -183,11 +194,12 @@ class cRemoteHost
 		int				UnreliablePacketSendId;
 		int				ReliablePacketRcvId;
 		int				UnreliablePacketRcvId;
-      SList<cPacket>	PacketList[4];	// list of all player objects
+      cPacketWindow	PacketWindow[4];	// queued packets, indexed by packet id
       int				ListMax[4];
       int				ListProcessingTime[4];
       unsigned long	LastKeepaliveTimeMs;
       bool				MustEvict;
+		int				AckLowestId;		// lowest reliable id received since the last ack
       BOOL				IsFlowControlEnabled;
 		int				LastServiceCount;
 		int				LastContactTime;
@@ -0,0 +1,111 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//
+// Filename:     rhostmap.h
+// Project:      wwnet
+// Description:  Finds the remote host a datagram came from by its address
+//
+//-----------------------------------------------------------------------------
+#if defined(_MSV_VER)
+#pragma once
+#endif
+
+#ifndef RHOSTMAP_H
+#define RHOSTMAP_H
+
+#include "win.h"
+#include <winsock.h>
+
+#include "bittype.h"
+#include "hashtemplate.h"
+
+//-----------------------------------------------------------------------------
+//
+// IP address and port, both in network byte order, as a hash key.
+//
+struct RHostAddressKeyStruct
+{
+	RHostAddressKeyStruct(void) : Ip(0), Port(0) {}
+	RHostAddressKeyStruct(ULONG ip, USHORT port) : Ip(ip), Port(port) {}
+	bool operator == (const RHostAddressKeyStruct & that) const { return ((Ip == that.Ip) && (Port == that.Port)); }
+
+	ULONG		Ip;
+	USHORT	Port;
+};
+
+template<>
+inline unsigned int HashTemplateKeyClass<RHostAddressKeyStruct>::Get_Hash_Value(const RHostAddressKeyStruct& key)
+{
+	//
+	// Clients behind the same NAT differ only in port, so mix it in well.
+	//
+	unsigned int hval = key.Ip ^ ((unsigned int)key.Port * 0x9e3779b1);
+	hval = hval + (hval>>5) + (hval>>10) + (hval >> 20);
+	return hval;
+}
+
+//-----------------------------------------------------------------------------
+//
+// Maps remote host addresses to rhost ids, so that a received datagram can be
+// matched to its sender without comparing it against every remote host.
+//
+class cRemoteHostMap
+{
+	public:
+		enum {INVALID_ID = -1};
+
+		void	Add(const SOCKADDR_IN & address, int rhost_id)
+		{
+			Map.Set_Value(Make_Key(address), rhost_id);
+		}
+
+		void	Remove(const SOCKADDR_IN & address)
+		{
+			Map.Remove(Make_Key(address));
+		}
+
+		void	Remove_All(void)
+		{
+			Map.Remove_All();
+		}
+
+		int	Find(const SOCKADDR_IN & address) const
+		{
+			return Find(address.sin_addr.s_addr, address.sin_port);
+		}
+
+		int	Find(ULONG ip, USHORT port) const
+		{
+			int rhost_id = INVALID_ID;
+			Map.Get(RHostAddressKeyStruct(ip, port), rhost_id);
+			return rhost_id;
+		}
+
+	private:
+		static RHostAddressKeyStruct Make_Key(const SOCKADDR_IN & address)
+		{
+			return RHostAddressKeyStruct(address.sin_addr.s_addr, address.sin_port);
+		}
+
+		HashTemplateClass<RHostAddressKeyStruct, int>	Map;
+};
+
+//-----------------------------------------------------------------------------
+
+#endif // RHOSTMAP_H
@@ -314,6 +314,92 @@ void cPacket::Construct_App_Packet(cPacket & packet, cPacket & full_packet)
 #endif //WRAPPER_CRC
 }
 
+//------------------------------------------------------------------------------------
+//
+// Same as Construct_App_Packet, for a packet whose buffer was received into
+// directly. The header is read where it is and the payload moved down over it,
+// so no second packet is needed. Returns false if the header doesn't describe
+// the datagram it arrived in.
+//
+bool cPacket::Construct_App_Packet_In_Place(UINT byte_count)
+{
+	WWASSERT(Type == UNDEFINED_TYPE);
+	WWASSERT(byte_count <= MAX_BUFFER_SIZE);
+
+#ifndef WRAPPER_CRC
+   int remote_crc;
+#endif //WRAPPER_CRC
+	BYTE type;
+	int packet_id;
+	char sender_id;
+	USHORT bit_size;
+
+	//
+	// We won't be able to read the header unless we set the bit length
+	// (approximately). The exact bit length is set once the header is read.
+	//
+	Set_Bit_Length(byte_count * 8);
+	Set_Bit_Read_Position(0);
+
+#ifndef WRAPPER_CRC
+	Get(remote_crc);
+#endif //WRAPPER_CRC
+	Get(type, BITPACK_PACKET_TYPE);
+	Get(packet_id, BITPACK_PACKET_ID);
+	Get(sender_id);
+	Get(bit_size);
+
+	UINT payload_bytes = (bit_size + 7) / 8;
+	if (payload_bytes + PACKET_HEADER_SIZE > byte_count) {
+#ifndef WRAPPER_CRC
+		Set_Is_Crc_Correct(false);
+#endif //WRAPPER_CRC
+		return false;
+	}
+
+#ifndef WRAPPER_CRC
+
+	int local_crc = CRC::Memory((BYTE *) (Get_Data() + sizeof(CRC_PLACEHOLDER)), ((bit_size / 8) + PACKET_HEADER_SIZE) - sizeof(CRC_PLACEHOLDER));
+	if (local_crc != remote_crc) {
+		Set_Is_Crc_Correct(false);
+		return false;
+	}
+	Set_Is_Crc_Correct(true);
+#endif //WRAPPER_CRC
+
+	Set_Type(type);
+	Set_Id(packet_id);
+	Set_Sender_Id(sender_id);
+
+	memmove(Get_Data(), Get_Data() + PACKET_HEADER_SIZE, payload_bytes);
+	Set_Bit_Length(bit_size);
+	Set_Bit_Read_Position(0);
+	return true;
+}
+
+//------------------------------------------------------------------------------------
+//
+// Make a packet that has been used before ready to be received into again.
+// The buffer isn't cleared since the receive overwrites it, so a packet reset
+// this way mustn't be written to with Add.
+//
+void cPacket::Reset_For_Receive(void)
+{
+	Type				= UNDEFINED_TYPE;
+	Id					= UNDEFINED_ID;
+	SenderId			= UNDEFINED_ID;
+	SendTime			= DefSendTime;
+	FirstSendTime	= DefSendTime;
+	ResendCount		= -1;
+	NumSends			= 1;
+#ifndef WRAPPER_CRC
+	IsCrcCorrect	= false;
+#endif //WRAPPER_CRC
+
+	Set_Bit_Length(0);
+	Set_Bit_Read_Position(0);
+}
+
 
 
 
@@ -88,6 +88,8 @@ class cPacket : public BitStreamClass, public AutoPoolClass<cPacket, 256>
 		static int		Get_Ref_Count()						{return RefCount;}
 		static void		Construct_Full_Packet(cPacket & full_packet, cPacket & src_packet);
 		static void		Construct_App_Packet(cPacket & packet, cPacket & full_packet);
+		bool				Construct_App_Packet_In_Place(UINT byte_count);
+		void				Reset_For_Receive(void);
 		static USHORT	Get_Packet_Header_Size(void)		{return (PACKET_HEADER_SIZE);}
 		//BYTE				Peek_Message_Type() const;
 		static unsigned long Get_Default_Send_Time(void) {return(DefSendTime);}
@@ -59,7 +59,7 @@ class PathfindSectorClass;
 //	PathNodeClass
 //
 /////////////////////////////////////////////////////////////////////////
-class PathNodeClass : public RefCountClass, public HeapNodeClass<float>, public AutoPoolClass<PathNodeClass, 512>
+class PathNodeClass : public RefCountClass, public HeapNodeClass<float>, public AutoPoolClass<PathNodeClass, 512, true>
 {
 	public:
 
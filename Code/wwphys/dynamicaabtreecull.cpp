@@ -956,3 +956,17 @@ void DynamicAABTreeCullClass::Merge_Vis_Object_IDs(uint32 id0,uint32 id1)
 	}
 }
 
+void DynamicAABTreeCullClass::Remap_Vis_Object_IDs(const uint32 * id_map,uint32 id_count)
+{
+	/*
+	** Replace each node's vis object id with id_map[id]
+	*/
+	for (int i=0; i<NodeCount; i++) {
+
+		AABTreeNodeClass * node = IndexedNodes[i];
+		if (node->UserData < id_count) {
+			node->UserData = id_map[node->UserData];
+		}
+	}
+}
+
@@ -139,6 +139,7 @@ public:
 	void					Evaluate_Non_Occluder_Visibility(VisRenderContextClass & context);
 	void					Prune_Redundant_Leaf_Nodes(VisOptimizationContextClass & context);
 	void					Merge_Vis_Object_IDs(uint32 id0,uint32 id1);
+	void					Remap_Vis_Object_IDs(const uint32 * id_map,uint32 id_count);
 
 	/*
 	** Save/Load system.
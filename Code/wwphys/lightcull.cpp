@@ -188,3 +188,23 @@ void StaticLightCullClass::Merge_Vis_Sector_IDs(uint32 id0,uint32 id1)
 		}
 	}
 }
+
+void StaticLightCullClass::Remap_Vis_Sector_IDs(const uint32 * id_map,uint32 id_count)
+{
+	/*
+	** Replace each lightphys object's vis sector id with id_map[id]
+	*/
+	for (int i=0; i<NodeCount; i++) {
+
+		AABTreeNodeClass * node = IndexedNodes[i];
+
+		LightPhysClass * obj = get_first_object(node);
+		while (obj) {
+			uint32 sector_id = obj->Get_Vis_Sector_ID();
+			if (sector_id < id_count) {
+				obj->Set_Vis_Sector_ID(id_map[sector_id]);
+			}
+			obj = get_next_object(obj);
+		}
+	}
+}
@@ -75,6 +75,7 @@ public:
 	*/
 	void					Assign_Vis_IDs(void);
 	void					Merge_Vis_Sector_IDs(uint32 id0,uint32 id1);
+	void					Remap_Vis_Sector_IDs(const uint32 * id_map,uint32 id_count);
 
 	/*
 	** Save-Load support.  
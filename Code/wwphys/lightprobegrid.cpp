@@ -0,0 +1,512 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : WWPhys                                                       *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/wwphys/lightprobegrid.cpp                    $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   LightProbeGridClass::LightProbeGridClass -- Constructor                                   *
+ *   LightProbeGridClass::~LightProbeGridClass -- Destructor                                   *
+ *   LightProbeGridClass::Reset -- Removes all probes                                          *
+ *   LightProbeGridClass::Init -- Sizes the grid to cover a box                                *
+ *   LightProbeGridClass::Get_Probe_Position -- Returns the world space position of a probe    *
+ *   LightProbeGridClass::Set_Probe -- Stores the baked lighting for a probe                   *
+ *   LightProbeGridClass::Invalidate -- Marks the probes inside a box dirty                    *
+ *   LightProbeGridClass::Invalidate_All -- Marks all probes dirty                             *
+ *   LightProbeGridClass::Find_Probes -- Finds the probes around a point                       *
+ *   LightProbeGridClass::Select_Probes -- Keeps only the probes which share a vis id          *
+ *   LightProbeGridClass::Apply -- Adds the blended probe lighting to a light environment      *
+ *   LightProbeGridClass::Save -- Saves the grid                                               *
+ *   LightProbeGridClass::Load -- Loads the grid                                               *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "lightprobegrid.h"
+#include "lightenvironment.h"
+#include "aabox.h"
+#include "chunkio.h"
+#include "wwdebug.h"
+#include "wwmath.h"
+
+
+/*
+** Chunk ID's used by LightProbeGridClass
+*/
+enum
+{
+	LIGHTPROBE_CHUNK_VARIABLES								= 0x00000100,
+	LIGHTPROBE_CHUNK_PROBES,
+	LIGHTPROBE_CHUNK_VIS_IDS,
+
+	LIGHTPROBE_VARIABLE_VERSION							= 0x00,
+	LIGHTPROBE_VARIABLE_MIN,
+	LIGHTPROBE_VARIABLE_SPACING,
+	LIGHTPROBE_VARIABLE_COUNTX,
+	LIGHTPROBE_VARIABLE_COUNTY,
+	LIGHTPROBE_VARIABLE_COUNTZ,
+};
+
+const uint32 LIGHTPROBE_CURRENT_VERSION = 0x00020000;		// 2.0 added the probe vis ids
+
+
+/*
+** Colors are stored as bytes in the range 0..COLOR_RANGE.  The ambient light is clamped
+** to one when it is rendered so nothing is lost there; this leaves some room for
+** over-bright diffuse lights.
+*/
+const float COLOR_RANGE = 2.0f;
+
+/*
+** When the probes around a point are blended, lights from different probes whose
+** directions are within this cosine are treated as the same light.
+*/
+const float LIGHT_MERGE_COS = 0.7f;
+
+
+static uint8 Encode_Color(float value)
+{
+	return (uint8)WWMath::Float_To_Long(WWMath::Clamp(value / COLOR_RANGE,0.0f,1.0f) * 255.0f);
+}
+
+static float Decode_Color(uint8 value)
+{
+	return (float)value * (COLOR_RANGE / 255.0f);
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::LightProbeGridClass -- Constructor                                     *
+ *=============================================================================================*/
+LightProbeGridClass::LightProbeGridClass(void) :
+	Min(0,0,0),
+	Spacing(1.0f),
+	ProbeCount(0)
+{
+	Count[0] = Count[1] = Count[2] = 0;
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::~LightProbeGridClass -- Destructor                                     *
+ *=============================================================================================*/
+LightProbeGridClass::~LightProbeGridClass(void)
+{
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Reset -- Removes all probes                                            *
+ *=============================================================================================*/
+void LightProbeGridClass::Reset(void)
+{
+	Min.Set(0,0,0);
+	Spacing = 1.0f;
+	Count[0] = Count[1] = Count[2] = 0;
+	ProbeCount = 0;
+	Probes.Resize(0);
+	ProbeVisIDs.Resize(0);
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Init -- Sizes the grid to cover a box                                  *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * min,max - box to cover                                                                      *
+ * spacing - desired distance between probes                                                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * The spacing is increased until the grid fits in MAX_PROBES.                                 *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void LightProbeGridClass::Init(const Vector3 & min,const Vector3 & max,float spacing)
+{
+	WWASSERT(spacing > 0.0f);
+	Reset();
+
+	Vector3 size = max - min;
+	for (;;) {
+		for (int i=0; i<3; i++) {
+			Count[i] = (int)WWMath::Floor(WWMath::Max(size[i],0.0f) / spacing) + 2;
+		}
+		if ((double)Count[0] * Count[1] * Count[2] <= MAX_PROBES) {
+			break;
+		}
+		spacing *= 1.25f;
+	}
+
+	Min = min;
+	Spacing = spacing;
+	ProbeCount = Count[0] * Count[1] * Count[2];
+	Probes.Resize(ProbeCount);
+	Probes.Zero_Memory();
+	ProbeVisIDs.Resize(ProbeCount);
+	ProbeVisIDs.Zero_Memory();
+	Invalidate_All();
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Get_Probe_Position -- Returns the world space position of a probe      *
+ *=============================================================================================*/
+Vector3 LightProbeGridClass::Get_Probe_Position(int index) const
+{
+	WWASSERT((index >= 0) && (index < ProbeCount));
+	int x = index % Count[0];
+	int y = (index / Count[0]) % Count[1];
+	int z = index / (Count[0] * Count[1]);
+	return Min + Spacing * Vector3((float)x,(float)y,(float)z);
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Set_Probe -- Stores the baked lighting for a probe                     *
+ *                                                                                             *
+ * The strongest lights in the environment are kept, any others are folded into the ambient   *
+ * light the same way LightEnvironmentClass treats lights under the LOD cutoff.                *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * index - probe to set                                                                        *
+ * env - lighting at the probe, reset with a black scene ambient and without the sun          *
+ * vis_object_id - vis id the lights at the probe were vis-tested against                     *
+ *=============================================================================================*/
+void LightProbeGridClass::Set_Probe(int index,const LightEnvironmentClass & env,uint32 vis_object_id)
+{
+	WWASSERT((index >= 0) && (index < ProbeCount));
+	ProbeVisIDs[index] = vis_object_id;
+
+	int order[8];
+	int light_count = env.Get_Light_Count();
+	WWASSERT(light_count <= 8);
+	int i,j;
+	for (i=0; i<light_count; i++) {
+		order[i] = i;
+	}
+	for (i=1; i<light_count; i++) {
+		for (j=i; (j>0) && (env.Get_Light_Diffuse(order[j]).Length2() > env.Get_Light_Diffuse(order[j-1]).Length2()); j--) {
+			int tmp = order[j];
+			order[j] = order[j-1];
+			order[j-1] = tmp;
+		}
+	}
+
+	Vector3 ambient = env.Get_Equivalent_Ambient();
+	for (i=MAX_PROBE_LIGHTS; i<light_count; i++) {
+		ambient += env.Get_Light_Diffuse(order[i]);
+	}
+
+	ProbeStruct & probe = Probes[index];
+	int kept = MIN(light_count,(int)MAX_PROBE_LIGHTS);
+	probe.Flags = (uint8)kept;
+	for (j=0; j<3; j++) {
+		probe.Ambient[j] = Encode_Color(ambient[j]);
+	}
+	for (i=0; i<kept; i++) {
+		Vector3 dir = env.Get_Light_Direction(order[i]);
+		const Vector3 & diffuse = env.Get_Light_Diffuse(order[i]);
+		for (j=0; j<3; j++) {
+			probe.Lights[i].Direction[j] = (sint8)WWMath::Float_To_Long(WWMath::Clamp(dir[j],-1.0f,1.0f) * 127.0f);
+			probe.Lights[i].Diffuse[j] = Encode_Color(diffuse[j]);
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Invalidate -- Marks the probes inside a box dirty                      *
+ *=============================================================================================*/
+void LightProbeGridClass::Invalidate(const AABoxClass & box)
+{
+	if (ProbeCount == 0) {
+		return;
+	}
+
+	int lo[3],hi[3];
+	for (int i=0; i<3; i++) {
+		lo[i] = (int)WWMath::Ceil((box.Center[i] - box.Extent[i] - Min[i]) / Spacing);
+		hi[i] = (int)WWMath::Floor((box.Center[i] + box.Extent[i] - Min[i]) / Spacing);
+		lo[i] = MAX(lo[i],0);
+		hi[i] = MIN(hi[i],Count[i] - 1);
+	}
+
+	for (int z=lo[2]; z<=hi[2]; z++) {
+		for (int y=lo[1]; y<=hi[1]; y++) {
+			for (int x=lo[0]; x<=hi[0]; x++) {
+				Probes[Probe_Index(x,y,z)].Flags |= PROBE_DIRTY;
+			}
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Invalidate_All -- Marks all probes dirty                               *
+ *=============================================================================================*/
+void LightProbeGridClass::Invalidate_All(void)
+{
+	for (int i=0; i<ProbeCount; i++) {
+		Probes[i].Flags |= PROBE_DIRTY;
+	}
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Find_Probes -- Finds the probes around a point                         *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * point - world space position to sample                                                      *
+ * sample - receives the eight surrounding probes and their trilinear weights                  *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * false if the point is outside of the grid                                                   *
+ *=============================================================================================*/
+bool LightProbeGridClass::Find_Probes(const Vector3 & point,SampleStruct * sample) const
+{
+	WWASSERT(sample != NULL);
+	if (ProbeCount == 0) {
+		return false;
+	}
+
+	int cell[3];
+	float frac[3];
+	for (int i=0; i<3; i++) {
+		float f = (point[i] - Min[i]) / Spacing;
+		if ((f < 0.0f) || (f > (float)(Count[i] - 1))) {
+			return false;
+		}
+		cell[i] = MIN((int)f,Count[i] - 2);
+		frac[i] = f - (float)cell[i];
+	}
+
+	for (int corner=0; corner<8; corner++) {
+		int dx = corner & 1;
+		int dy = (corner >> 1) & 1;
+		int dz = (corner >> 2) & 1;
+		sample->Index[corner] = Probe_Index(cell[0] + dx,cell[1] + dy,cell[2] + dz);
+		sample->Weight[corner] =
+			(dx ? frac[0] : 1.0f - frac[0]) *
+			(dy ? frac[1] : 1.0f - frac[1]) *
+			(dz ? frac[2] : 1.0f - frac[2]);
+	}
+	return true;
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Select_Probes -- Keeps only the probes which share a vis id            *
+ *                                                                                             *
+ * A probe baked with a different vis id may see lights that the object can't (or miss ones  *
+ * that it can), for example when there is a wall between them.  Those probes get no weight   *
+ * and the weights of the rest are scaled back up to one.                                      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * sample - probes from Find_Probes, the weights are modified                                  *
+ * vis_object_id - vis id of the object being lit                                              *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * false if none of the probes share the object's vis id                                       *
+ *=============================================================================================*/
+bool LightProbeGridClass::Select_Probes(SampleStruct * sample,uint32 vis_object_id) const
+{
+	WWASSERT(sample != NULL);
+
+	float total = 0.0f;
+	int corner;
+	for (corner=0; corner<8; corner++) {
+		if (ProbeVisIDs[sample->Index[corner]] != vis_object_id) {
+			sample->Weight[corner] = 0.0f;
+		}
+		total += sample->Weight[corner];
+	}
+
+	if (total <= WWMATH_EPSILON) {
+		return false;
+	}
+
+	float scale = 1.0f / total;
+	for (corner=0; corner<8; corner++) {
+		sample->Weight[corner] *= scale;
+	}
+	return true;
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Apply -- Adds the blended probe lighting to a light environment        *
+ *                                                                                             *
+ * The ambient lights are blended directly.  A light usually shows up in several of the       *
+ * probes with slightly different directions, so lights pointing the same way are merged and  *
+ * a light that only some of the probes see fades out towards the others.                      *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * The probes should not be dirty.                                                             *
+ *=============================================================================================*/
+void LightProbeGridClass::Apply(const SampleStruct & sample,LightEnvironmentClass * env) const
+{
+	WWASSERT(env != NULL);
+
+	Vector3 ambient(0,0,0);
+	Vector3 directions[8 * MAX_PROBE_LIGHTS];
+	Vector3 diffuse[8 * MAX_PROBE_LIGHTS];
+	int light_count = 0;
+	int i,j;
+
+	for (int corner=0; corner<8; corner++) {
+		float weight = sample.Weight[corner];
+		if (weight <= 0.0f) {
+			continue;
+		}
+
+		const ProbeStruct & probe = Probes[sample.Index[corner]];
+		WWASSERT((probe.Flags & PROBE_DIRTY) == 0);
+		for (j=0; j<3; j++) {
+			ambient[j] += weight * Decode_Color(probe.Ambient[j]);
+		}
+
+		for (i=0; i<(probe.Flags & PROBE_LIGHT_COUNT_MASK); i++) {
+			const ProbeLightStruct & light = probe.Lights[i];
+			Vector3 dir(light.Direction[0],light.Direction[1],light.Direction[2]);
+			dir *= 1.0f / 127.0f;
+			Vector3 color(Decode_Color(light.Diffuse[0]),Decode_Color(light.Diffuse[1]),Decode_Color(light.Diffuse[2]));
+
+			for (j=0; j<light_count; j++) {
+				Vector3 merged_dir = directions[j];
+				merged_dir.Normalize();
+				if (Vector3::Dot_Product(merged_dir,dir) > LIGHT_MERGE_COS) {
+					break;
+				}
+			}
+			if (j == light_count) {
+				directions[j].Set(0,0,0);
+				diffuse[j].Set(0,0,0);
+				light_count++;
+			}
+			directions[j] += weight * dir;
+			diffuse[j] += weight * color;
+		}
+	}
+
+	env->Add_Ambient(ambient);
+	for (i=0; i<light_count; i++) {
+		if (directions[i].Length2() > WWMATH_EPSILON) {
+			directions[i].Normalize();
+			env->Add_Directional_Light(directions[i],diffuse[i]);
+		}
+	}
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Save -- Saves the grid                                                 *
+ *=============================================================================================*/
+void LightProbeGridClass::Save(ChunkSaveClass & csave)
+{
+	uint32 version = LIGHTPROBE_CURRENT_VERSION;
+
+	csave.Begin_Chunk(LIGHTPROBE_CHUNK_VARIABLES);
+	WRITE_MICRO_CHUNK(csave,LIGHTPROBE_VARIABLE_VERSION,version);
+	WRITE_MICRO_CHUNK(csave,LIGHTPROBE_VARIABLE_MIN,Min);
+	WRITE_MICRO_CHUNK(csave,LIGHTPROBE_VARIABLE_SPACING,Spacing);
+	WRITE_MICRO_CHUNK(csave,LIGHTPROBE_VARIABLE_COUNTX,Count[0]);
+	WRITE_MICRO_CHUNK(csave,LIGHTPROBE_VARIABLE_COUNTY,Count[1]);
+	WRITE_MICRO_CHUNK(csave,LIGHTPROBE_VARIABLE_COUNTZ,Count[2]);
+	csave.End_Chunk();
+
+	if (ProbeCount > 0) {
+		csave.Begin_Chunk(LIGHTPROBE_CHUNK_PROBES);
+		csave.Write(&(Probes[0]),ProbeCount * sizeof(ProbeStruct));
+		csave.End_Chunk();
+
+		csave.Begin_Chunk(LIGHTPROBE_CHUNK_VIS_IDS);
+		csave.Write(&(ProbeVisIDs[0]),ProbeCount * sizeof(uint32));
+		csave.End_Chunk();
+	}
+}
+
+
+/***********************************************************************************************
+ * LightProbeGridClass::Load -- Loads the grid                                                 *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Data from a different version is thrown away, which falls back to collecting the lights   *
+ * for each object until the probes are baked again.                                           *
+ *=============================================================================================*/
+void LightProbeGridClass::Load(ChunkLoadClass & cload)
+{
+	Reset();
+
+	uint32 version = 0;
+	int count[3] = { 0, 0, 0 };
+	bool ok = true;
+	bool have_vis_ids = false;
+
+	while (cload.Open_Chunk()) {
+		switch (cload.Cur_Chunk_ID()) {
+
+			case LIGHTPROBE_CHUNK_VARIABLES:
+				while (cload.Open_Micro_Chunk()) {
+					switch(cload.Cur_Micro_Chunk_ID()) {
+						READ_MICRO_CHUNK(cload,LIGHTPROBE_VARIABLE_VERSION,version);
+						READ_MICRO_CHUNK(cload,LIGHTPROBE_VARIABLE_MIN,Min);
+						READ_MICRO_CHUNK(cload,LIGHTPROBE_VARIABLE_SPACING,Spacing);
+						READ_MICRO_CHUNK(cload,LIGHTPROBE_VARIABLE_COUNTX,count[0]);
+						READ_MICRO_CHUNK(cload,LIGHTPROBE_VARIABLE_COUNTY,count[1]);
+						READ_MICRO_CHUNK(cload,LIGHTPROBE_VARIABLE_COUNTZ,count[2]);
+					}
+					cload.Close_Micro_Chunk();
+				}
+				ok = (version == LIGHTPROBE_CURRENT_VERSION) && (Spacing > 0.0f) &&
+						(count[0] >= 2) && (count[1] >= 2) && (count[2] >= 2) &&
+						((double)count[0] * count[1] * count[2] <= MAX_PROBES);
+				break;
+
+			case LIGHTPROBE_CHUNK_PROBES:
+				if (ok && (cload.Cur_Chunk_Length() == count[0] * count[1] * count[2] * sizeof(ProbeStruct))) {
+					Count[0] = count[0];
+					Count[1] = count[1];
+					Count[2] = count[2];
+					ProbeCount = Count[0] * Count[1] * Count[2];
+					Probes.Resize(ProbeCount);
+					cload.Read(&(Probes[0]),ProbeCount * sizeof(ProbeStruct));
+				}
+				break;
+
+			case LIGHTPROBE_CHUNK_VIS_IDS:
+				if ((ProbeCount > 0) && (cload.Cur_Chunk_Length() == ProbeCount * sizeof(uint32))) {
+					ProbeVisIDs.Resize(ProbeCount);
+					cload.Read(&(ProbeVisIDs[0]),ProbeCount * sizeof(uint32));
+					have_vis_ids = true;
+				}
+				break;
+		}
+		cload.Close_Chunk();
+	}
+
+	if ((ProbeCount == 0) || !have_vis_ids) {
+		WWDEBUG_SAY(("Light probe data missing or obsolete, lighting objects from the static lights\r\n"));
+		Reset();
+	}
+}
@@ -0,0 +1,153 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : WWPhys                                                       *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/wwphys/lightprobegrid.h                      $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef LIGHTPROBEGRID_H
+#define LIGHTPROBEGRID_H
+
+#include "always.h"
+#include "vector3.h"
+#include "simplevec.h"
+#include "bittype.h"
+
+class AABoxClass;
+class LightEnvironmentClass;
+class ChunkSaveClass;
+class ChunkLoadClass;
+
+
+/**
+** LightProbeGridClass
+** A regular grid of pre-computed static lighting samples covering the level.  Each probe
+** holds the ambient light and the few strongest directional lights that
+** PhysicsSceneClass::Compute_Static_Lighting would give an object centered on the probe,
+** not counting the scene ambient and the sun.  Objects inside the grid are lit by blending
+** the eight probes around them instead of collecting and vis-testing the static lights.
+**
+** The probes are baked in the level editor and saved with the level's static data.  Probes
+** can be marked dirty (when lights change state) and are then re-baked the next time they
+** are sampled.
+**
+** Each probe remembers the vis id it was baked with.  Only probes with the same vis id as
+** the object being lit can be blended; the lights they saw are exactly the lights the
+** object can see, so light doesn't leak through walls from probes on the other side.
+*/
+class LightProbeGridClass
+{
+public:
+
+	enum
+	{
+		MAX_PROBE_LIGHTS = 2,
+		MAX_PROBES = 256 * 1024,
+	};
+
+	LightProbeGridClass(void);
+	~LightProbeGridClass(void);
+
+	void					Reset(void);
+	bool					Is_Empty(void) const											{ return ProbeCount == 0; }
+
+	/*
+	** Baking.  Init sizes the grid to cover the given box, growing the spacing if needed to
+	** stay under MAX_PROBES; all probes start out dirty.
+	*/
+	void					Init(const Vector3 & min,const Vector3 & max,float spacing);
+	int					Get_Probe_Count(void) const								{ return ProbeCount; }
+	Vector3				Get_Probe_Position(int index) const;
+	float					Get_Spacing(void) const										{ return Spacing; }
+	void					Set_Probe(int index,const LightEnvironmentClass & env,uint32 vis_object_id);
+
+	bool					Is_Probe_Dirty(int index) const							{ return (Probes[index].Flags & PROBE_DIRTY) != 0; }
+	void					Invalidate(const AABoxClass & box);
+	void					Invalidate_All(void);
+
+	/*
+	** Sampling.  Find_Probes returns false if the point is outside of the grid.  Select_Probes
+	** drops the probes baked with a different vis id and re-weights the others; it returns
+	** false if none are left, in which case the object should collect the lights itself.
+	*/
+	struct SampleStruct
+	{
+		int				Index[8];
+		float				Weight[8];
+	};
+
+	bool					Find_Probes(const Vector3 & point,SampleStruct * sample) const;
+	bool					Select_Probes(SampleStruct * sample,uint32 vis_object_id) const;
+	void					Apply(const SampleStruct & sample,LightEnvironmentClass * env) const;
+
+	/*
+	** Save-Load
+	*/
+	void					Save(ChunkSaveClass & csave);
+	void					Load(ChunkLoadClass & cload);
+
+protected:
+
+	enum
+	{
+		PROBE_LIGHT_COUNT_MASK = 0x03,
+		PROBE_DIRTY = 0x80,
+	};
+
+	/*
+	** Colors are stored as bytes covering 0..COLOR_RANGE, directions as signed bytes.
+	*/
+	struct ProbeLightStruct
+	{
+		sint8				Direction[3];
+		uint8				Diffuse[3];
+	};
+
+	struct ProbeStruct
+	{
+		uint8					Ambient[3];
+		uint8					Flags;
+		ProbeLightStruct	Lights[MAX_PROBE_LIGHTS];
+	};
+
+	int					Probe_Index(int x,int y,int z) const					{ return x + Count[0] * (y + Count[1] * z); }
+
+	Vector3								Min;
+	float									Spacing;
+	int									Count[3];
+	int									ProbeCount;
+	SimpleVecClass<ProbeStruct>	Probes;
+	SimpleVecClass<uint32>			ProbeVisIDs;
+
+private:
+
+	// not implemented
+	LightProbeGridClass(const LightProbeGridClass &);
+	LightProbeGridClass & operator = (const LightProbeGridClass &);
+};
+
+
+#endif //LIGHTPROBEGRID_H
@@ -49,62 +49,492 @@
 #include "lightsolvecontext.h"
 #include "lightsolveprogress.h"
 #include "renegadeterrainpatch.h"
+#include "workerpool.h"
+#include "thread.h"
+#include <windows.h>
 
 
+/*
+** The solve is split into one job per mesh (or terrain patch) which runs on the
+** WorkerPoolClass threads. Anything that touches render objects lazily (transforms,
+** vertex normals, sub-object references, materials) is done on the main thread:
+** - before a job is submitted, the mesh transform, vertex and normal arrays are
+**   fetched and the light transforms are validated.
+** - the job only accumulates the light arriving at each vertex.
+** - when a job finishes, the main thread modulates the light by the vertex materials
+**   and installs the result. Installing modifies shared vertex materials so this is
+**   done in the same order as the old serial solve, which keeps the results identical.
+** Ray casts only read the scene: before any job is submitted every static object has its
+** transforms and plane equations validated and the static culling system is frozen until
+** the last job is done.
+*/
+const int LIGHT_SOLVE_BATCH_SIZE = 256;		// vertices per occlusion ray batch
+const unsigned LIGHT_SOLVE_UPDATE_MS = 50;	// how often the observer is updated
+
+
+/**
+** LightSolveRayBatchClass
+** Collects the occlusion rays for a batch of vertices and casts them all at once.
+** Any number of workers can cast at the same time, see Prepare_Ray_Casts.
+*/
+class LightSolveRayBatchClass
+{
+public:
+	void			Reset(void)									{ Rays.Delete_All(false); }
+	int			Add_Ray(const Vector3 & p0,const Vector3 & p1);
+	void			Cast(void);
+	bool			Is_Occluded(int index) const			{ return Rays[index].Occluded; }
+	int			Get_Ray_Count(void) const				{ return Rays.Count(); }
+
+protected:
+
+	struct RayStruct
+	{
+		Vector3	P0;
+		Vector3	P1;
+		bool		Occluded;
+	};
+
+	SimpleDynVecClass<RayStruct>			Rays;
+};
+
+int LightSolveRayBatchClass::Add_Ray(const Vector3 & p0,const Vector3 & p1)
+{
+	RayStruct ray;
+	ray.P0 = p0;
+	ray.P1 = p1;
+	ray.Occluded = false;
+	Rays.Add(ray,LIGHT_SOLVE_BATCH_SIZE);
+	return Rays.Count() - 1;
+}
+
+/*
+** Validate everything a ray cast would otherwise compute lazily so that the casts
+** made by the workers never write to the render objects.
+*/
+static void Prepare_Ray_Casts(RenderObjClass * model)
+{
+	model->Get_Transform();
+	if (model->Class_ID() == RenderObjClass::CLASSID_MESH) {
+		((MeshClass *)model)->Peek_Model()->Get_Plane_Array();
+	}
+
+	for (int i=0; i<model->Get_Num_Sub_Objects(); i++) {
+		RenderObjClass * sub_obj = model->Get_Sub_Object(i);
+		if (sub_obj != NULL) {
+			Prepare_Ray_Casts(sub_obj);
+			REF_PTR_RELEASE(sub_obj);
+		}
+	}
+}
+
+static void Prepare_Ray_Casts(void)
+{
+	RefPhysListIterator it = PhysicsSceneClass::Get_Instance()->Get_Static_Object_Iterator();
+	for ( ; !it.Is_Done(); it.Next()) {
+		RenderObjClass * model = it.Peek_Obj()->Peek_Model();
+		if (model != NULL) {
+			Prepare_Ray_Casts(model);
+		}
+	}
+}
+
+void LightSolveRayBatchClass::Cast(void)
+{
+	if (Rays.Count() == 0) {
+		return;
+	}
+
+#pragma message("need a collision group for light occlusion here...")
+	for (int i=0; i<Rays.Count(); i++) {
+		CastResultStruct res;
+		LineSegClass ray(Rays[i].P0,Rays[i].P1);
+		PhysRayCollisionTestClass raytest(ray,&res,0,COLLISION_TYPE_PROJECTILE);
+		raytest.CheckDynamicObjs = false;
+		PhysicsSceneClass::Get_Instance()->Cast_Ray(raytest);
+
+		Rays[i].Occluded = (res.Fraction < 1.0f);
+	}
+}
+
+
+/**
+** LightSolveLightsClass
+** The lights affecting one static object.  Collected on the main thread and shared
+** by the jobs of all of the meshes in the object.
+*/
+class LightSolveLightsClass
+{
+public:
+	LightSolveLightsClass(void) : FirstJob(0), JobCount(0) {}
+
+	SimpleDynVecClass<LightClass *>		Lights;
+	int											FirstJob;
+	int											JobCount;
+};
+
+
+class LightSolveJobListClass;
+
 /**
 ** VertexSolveClass
-** This class does the job of generated a vertex solve for a mesh.  
+** This class does the job of generated a vertex solve for a mesh.
 */
 class VertexSolveClass
 {
 public:
-	VertexSolveClass(void) {}
-	
-	void Light_Mesh(LightSolveContextClass & context,MeshClass * mesh, NonRefPhysListClass & lights);
-	void Light_Terrain(LightSolveContextClass & context,RenegadeTerrainPatchClass * patch, NonRefPhysListClass & lights);
+	VertexSolveClass(void);
+	~VertexSolveClass(void);
+
+	/*
+	** Main thread: grab everything the job needs from the mesh or terrain patch
+	*/
+	void		Init(LightSolveJobListClass * list,RenderObjClass * model,LightSolveLightsClass * lights);
+
+	/*
+	** Any thread: accumulate the light arriving at each vertex
+	*/
+	void		Compute_Lighting(void);
+
+	/*
+	** Main thread: modulate by the materials and install the solve
+	*/
+	void		Install(void);
+
+	RenderObjClass *			Peek_Model(void)					{ return Model; }
+	int							Get_Vertex_Count(void)			{ return VertexCount; }
+	int							Get_Processed_Vertex_Count(void)	{ return ProcessedVertexCount; }
+	bool							Is_Finished(void)					{ return Finished != 0; }
+	bool							Was_Cancelled(void)				{ return Cancelled; }
 
 protected:
 
-	void Grow_Arrays(int new_vcount);
-	void Add_Light_To_Vertex(LightSolveContextClass & context,int idx,LightClass * light_obj);
+	void		Collect_Rays(LightSolveContextClass & context,int vi,LightClass * light_obj);
+	void		Add_Light_To_Vertex(LightSolveContextClass & context,int vi,LightClass * light_obj);
+	void		Compute_Material_Colors(MeshModelClass * model);
+
+	LightSolveJobListClass *	List;
+	RenderObjClass *				Model;
+	bool								IsTerrain;
+	LightSolveLightsClass *		Lights;
+	Matrix3D							Transform;
+	const Vector3 *				SrcVerts;
+	const Vector3 *				SrcNorms;
+	int								VertexCount;
+
+	volatile long					ProcessedVertexCount;
+	volatile long					Finished;
+	bool								Cancelled;
+
+	LightSolveRayBatchClass		RayBatch;
+	int								NextRay;
 
 	SimpleVecClass<Vector3>		Position;
 	SimpleVecClass<Vector3>		Normal;
-	SimpleVecClass<Vector4>		MeshAmbient;
-	SimpleVecClass<Vector4>		MeshDiffuse;
-
 	SimpleVecClass<Vector4>		AmbientSolve;
 	SimpleVecClass<Vector4>		DiffuseSolve;
-	SimpleVecClass<Vector4>		Solve;
 
+	/*
+	** Scratch arrays for Install, only used from the main thread
+	*/
+	static SimpleVecClass<Vector4>		MeshAmbient;
+	static SimpleVecClass<Vector4>		MeshDiffuse;
+	static SimpleVecClass<Vector4>		Solve;
 };
 
-static VertexSolveClass TheVertexSolver;
+/**
+** LightSolveJobListClass
+** All of the vertex solve jobs for one call to LightSolveClass::Compute_Solve.  Jobs
+** are submitted as soon as they are created and installed in the order they were
+** created.
+*/
+class LightSolveJobListClass
+{
+public:
+	LightSolveJobListClass(LightSolveContextClass & context);
+	~LightSolveJobListClass(void);
 
-void VertexSolveClass::Light_Mesh(LightSolveContextClass & context,MeshClass * mesh, NonRefPhysListClass & lights)
+	LightSolveLightsClass *		Add_Object(StaticPhysClass * obj);
+	void								Add_Mesh(RenderObjClass * model,LightSolveLightsClass * lights);
+	void								Finish(void);
+
+	LightSolveContextClass &	Get_Context(void)				{ return Context; }
+	LightClass *					Peek_Sun(void)					{ return Sun; }
+	const Vector3 &				Get_Scene_Ambient(void)		{ return SceneAmbient; }
+	bool								Is_Main_Thread(void)			{ return ThreadClass::_Get_Current_Thread_ID() == MainThreadID; }
+
+	void								Add_Processed_Vertices(int count)	{ ::InterlockedExchangeAdd(&ProcessedVertexCount,count); }
+	void								Update_Progress(void);
+
+protected:
+
+	static void						Job_Function(void * data,int index);
+	void								Install_Finished_Jobs(void);
+
+	LightSolveContextClass &								Context;
+	LightClass *												Sun;
+	Vector3														SceneAmbient;
+	JobGroupClass												Group;
+	unsigned														MainThreadID;
+	int															TotalVertexCount;
+	volatile long												ProcessedVertexCount;
+	bool															AllJobsAdded;
+
+	SimpleDynVecClass<VertexSolveClass *>				Jobs;
+	SimpleDynVecClass<LightSolveLightsClass *>		Objects;
+	int															NextJob;
+	int															NextObject;
+};
+
+SimpleVecClass<Vector4> VertexSolveClass::MeshAmbient;
+SimpleVecClass<Vector4> VertexSolveClass::MeshDiffuse;
+SimpleVecClass<Vector4> VertexSolveClass::Solve;
+
+static Vector3 _offset (0, 0, 0);
+
+VertexSolveClass::VertexSolveClass(void) :
+	List(NULL),
+	Model(NULL),
+	IsTerrain(false),
+	Lights(NULL),
+	Transform(1),
+	SrcVerts(NULL),
+	SrcNorms(NULL),
+	VertexCount(0),
+	ProcessedVertexCount(0),
+	Finished(0),
+	Cancelled(false),
+	NextRay(0)
+{
+}
+
+VertexSolveClass::~VertexSolveClass(void)
+{
+	REF_PTR_RELEASE(Model);
+}
+
+void VertexSolveClass::Init(LightSolveJobListClass * list,RenderObjClass * model,LightSolveLightsClass * lights)
+{
+	List = list;
+	REF_PTR_SET(Model,model);
+	Lights = lights;
+	Transform = model->Get_Transform();
+
+	if (model->Class_ID() == RenderObjClass::CLASSID_MESH) {
+		MeshModelClass * mesh_model = ((MeshClass *)model)->Peek_Model();
+		IsTerrain = false;
+		VertexCount = mesh_model->Get_Vertex_Count();
+		SrcVerts = mesh_model->Get_Vertex_Array();
+		SrcNorms = mesh_model->Get_Vertex_Normal_Array();
+	} else {
+		RenegadeTerrainPatchClass * patch = (RenegadeTerrainPatchClass *)model;
+		IsTerrain = true;
+		VertexCount = patch->Get_Vertex_Count();
+		SrcVerts = patch->Get_Vertex_Array();
+		SrcNorms = patch->Get_Vertex_Normal_Array();
+	}
+}
+
+void VertexSolveClass::Compute_Lighting(void)
 {
 	int vi;
-	context.Get_Progress().Set_Current_Mesh_Name(mesh->Get_Name());
-	context.Get_Progress().Set_Current_Mesh_Vertex_Count(mesh->Peek_Model()->Get_Vertex_Count());
+	int vcount = VertexCount;
+	LightSolveContextClass & context = List->Get_Context();
+	LightClass * sun = List->Peek_Sun();
+	const Vector3 & scene_ambient = List->Get_Scene_Ambient();
+
+	Position.Uninitialised_Grow(vcount);
+	Normal.Uninitialised_Grow(vcount);
+	AmbientSolve.Uninitialised_Grow(vcount);
+	DiffuseSolve.Uninitialised_Grow(vcount);
 
 	/*
-	** Get the model and initialize our arrays
+	** Transform the positions and normals into world space
 	*/
-	MeshModelClass * model = mesh->Peek_Model();
-	int vcount = model->Get_Vertex_Count();
-	Grow_Arrays(vcount);
+	Matrix3D tm = Transform;
+	VectorProcessorClass::Transform(&(Position[0]), SrcVerts, tm, vcount);
+	tm.Set_Translation(Vector3(0,0,0));
+	VectorProcessorClass::Transform(&(Normal[0]), SrcNorms, tm, vcount);
 
 	/*
-	** Transform the positions and normals into world space
+	** Compute the light solve a batch of vertices at a time.  First collect the
+	** occlusion rays for every vertex and light in the batch, cast them, then
+	** add up the light in exactly the same order as the rays were collected.
 	*/
-	Matrix3D tm = mesh->Get_Transform();
-	const Vector3 * src_verts = model->Get_Vertex_Array();
-	const Vector3 * src_norms = model->Get_Vertex_Normal_Array();
+	for (int batch_start=0; batch_start<vcount; batch_start+=LIGHT_SOLVE_BATCH_SIZE) {
 
-	VectorProcessorClass::Transform(&(Position[0]), src_verts, tm, vcount);
-	tm.Set_Translation(Vector3(0,0,0));
-	VectorProcessorClass::Transform(&(Normal[0]), src_norms, tm, vcount);
+		if (context.Get_Progress().Is_Cancel_Requested()) {
+			Cancelled = true;
+			break;
+		}
+
+		int batch_end = MIN(batch_start + LIGHT_SOLVE_BATCH_SIZE,vcount);
+
+		RayBatch.Reset();
+		for (vi=batch_start; vi<batch_end; vi++) {
+			Collect_Rays(context,vi,sun);
+			for (int li=0; li<Lights->Lights.Count(); li++) {
+				Collect_Rays(context,vi,Lights->Lights[li]);
+			}
+		}
+		RayBatch.Cast();
+
+		NextRay = 0;
+		for (vi=batch_start; vi<batch_end; vi++) {
+
+			AmbientSolve[vi].X = scene_ambient.X;
+			AmbientSolve[vi].Y = scene_ambient.Y;
+			AmbientSolve[vi].Z = scene_ambient.Z;
+			AmbientSolve[vi].W = 1.0f;
+			
+			DiffuseSolve[vi].X = 0.0f;
+			DiffuseSolve[vi].Y = 0.0f;
+			DiffuseSolve[vi].Z = 0.0f;
+			DiffuseSolve[vi].W = 1.0f;		// alpha comes from the material, see Install
+
+			/*
+			** Sun
+			*/
+			Add_Light_To_Vertex(context,vi,sun);
+
+			/*
+			** Other lights
+			*/
+			for (int li=0; li<Lights->Lights.Count(); li++) {
+				Add_Light_To_Vertex(context,vi,Lights->Lights[li]);
+			}
+		}
+		WWASSERT(NextRay == RayBatch.Get_Ray_Count());
+
+		::InterlockedExchangeAdd(&ProcessedVertexCount,batch_end - batch_start);
+		List->Add_Processed_Vertices(batch_end - batch_start);
+
+		/*
+		** When we're running on the main thread (no worker threads) keep the UI alive
+		*/
+		if (List->Is_Main_Thread()) {
+			List->Update_Progress();
+			context.Update_Observer();
+		}
+	}
+
+	if (!Cancelled) {
+		VectorProcessorClass::Clamp(&(AmbientSolve[0]),&(AmbientSolve[0]), 0.0f, 1.0f,vcount);
+		VectorProcessorClass::Clamp(&(DiffuseSolve[0]),&(DiffuseSolve[0]), 0.0f, 1.0f,vcount);
+	}
+
+	Position.Resize(0);
+	Normal.Resize(0);
+	::InterlockedExchange(&Finished,1);
+}
+
+void VertexSolveClass::Collect_Rays(LightSolveContextClass & context,int vi,LightClass * light_obj)
+{
+	if (context.Is_Occlusion_Enabled() && light_obj->Is_Within_Attenuation_Radius(Position[vi])) {
+		Vector3 p0 = Position[vi];
+		Vector3 p1 = light_obj->Get_Position();
+
+		if (light_obj->Get_Type() == LightClass::DIRECTIONAL) {
+			Vector3 dir = -(light_obj->Get_Transform().Get_Z_Vector());
+			p1 = p0 + dir * light_obj->Get_Attenuation_Range();
+		}
+
+		const float MOVE_AMOUNT = 0.25f;		// can't be occluded closer than this
+		Vector3 delta = p1-p0;
+		delta.Normalize();
+		p0 += MOVE_AMOUNT * delta;
+
+		p0 += _offset;
+		p1 += _offset;
+
+		RayBatch.Add_Ray(p0,p1);
+	}
+}
+
+void VertexSolveClass::Add_Light_To_Vertex(LightSolveContextClass & context,int vi,LightClass * light_obj)
+{				
+	if (light_obj->Is_Within_Attenuation_Radius(Position[vi])) {
+	
+		bool is_occluded = false;
+		if (context.Is_Occlusion_Enabled()) {
+			is_occluded = RayBatch.Is_Occluded(NextRay++);
+		}
+
+		if (!is_occluded) {
+
+			Vector3 ambient;
+			Vector3 diffuse;
+			light_obj->Compute_Lighting(Position[vi],Normal[vi],&ambient,&diffuse);
+
+			AmbientSolve[vi] += Vector4(ambient.X,ambient.Y,ambient.Z,0.0f);
+			DiffuseSolve[vi] += Vector4(diffuse.X,diffuse.Y,diffuse.Z,0.0f);
+		}
+	}
+}
+
+void VertexSolveClass::Install(void)
+{
+	int vi;
+	int vcount = VertexCount;
+
+	if (!Cancelled) {
+
+		MeshAmbient.Uninitialised_Grow(vcount);
+		MeshDiffuse.Uninitialised_Grow(vcount);
+		Solve.Uninitialised_Grow(vcount);
+
+		if (IsTerrain) {
+
+			/*
+			** For heightfield terrains, the mesh ambient and diffuse colors are white
+			*/
+			for (int index = 0; index < vcount; index ++) {
+				MeshAmbient[index].Set (1.0F, 1.0F, 1.0F, 1.0F);
+				MeshDiffuse[index].Set (1.0F, 1.0F, 1.0F, 1.0F);
+			}
+
+		} else {
+			Compute_Material_Colors(((MeshClass *)Model)->Peek_Model());
+		}
+
+		/*
+		** Modulate the accumulated light by the material properties
+		*/
+		for (vi=0; vi<vcount; vi++) {
+			Solve[vi].X = AmbientSolve[vi].X * MeshAmbient[vi].X + DiffuseSolve[vi].X * MeshDiffuse[vi].X;
+			Solve[vi].Y = AmbientSolve[vi].Y * MeshAmbient[vi].Y + DiffuseSolve[vi].Y * MeshDiffuse[vi].Y;
+			Solve[vi].Z = AmbientSolve[vi].Z * MeshAmbient[vi].Z + DiffuseSolve[vi].Z * MeshDiffuse[vi].Z;
+			Solve[vi].W = MeshDiffuse[vi].W;
+		}
+		VectorProcessorClass::Clamp(&(Solve[0]),&(Solve[0]), 0.0f, 1.0f,vcount);
+
+		if (IsTerrain) {
+
+			/*
+			**	Pass the resultant vertex colors onto the patch
+			*/
+			RenegadeTerrainPatchClass * patch = (RenegadeTerrainPatchClass *)Model;
+			for (vi=0; vi<vcount; vi++) {
+				patch->Set_Vertex_Color (vi, Vector3 (Solve[vi].X, Solve[vi].Y, Solve[vi].Z));
+			}
+
+			//
+			//	Let the patch know that it is now prelit
+			//
+			patch->Set_Is_Prelit (true);
 
+		} else {
+			((MeshClass *)Model)->Install_User_Lighting_Array(&(Solve[0]));
+		}
+	}
+
+	AmbientSolve.Resize(0);
+	DiffuseSolve.Resize(0);
+	REF_PTR_RELEASE(Model);
+}
+
+void VertexSolveClass::Compute_Material_Colors(MeshModelClass * model)
+{
 	/*
 	** Fill the mesh ambient and diffuse arrays with the per vertex material
 	** color (either from the material itself or the vertex color array)
@@ -121,6 +551,9 @@ void VertexSolveClass::Light_Mesh(LightSolveContextClass & context,MeshClass * m
 	**			- if this material has any emissive component, leave the vmtl alone
 	**			- else, point the emissive source to the new light solve color array, 
 	**			  make the diffuse and ambient use the material settings.
+	**
+	** Installing a solve changes the vertex materials, which can be shared with meshes
+	** that are installed later.  That is why this runs on the main thread, in order.
 	*/
 	unsigned * dcg = NULL; 
 	for (int pi=0; pi<model->Get_Pass_Count(); pi++) {
@@ -129,7 +562,7 @@ void VertexSolveClass::Light_Mesh(LightSolveContextClass & context,MeshClass * m
 		}
 	}
 	
-	for (vi=0; vi<model->Get_Vertex_Count(); vi++) {
+	for (int vi=0; vi<model->Get_Vertex_Count(); vi++) {
 
 		bool use_array = false;
 		for (int pi=0; pi<model->Get_Pass_Count(); pi++) {
@@ -169,136 +602,58 @@ void VertexSolveClass::Light_Mesh(LightSolveContextClass & context,MeshClass * m
 			MeshDiffuse[vi].Set(1,1,1,1);
 		}
 	}
-
-	/*
-	** Compute the light solve
-	*/
-	LightClass * sun = PhysicsSceneClass::Get_Instance()->Get_Sun_Light();
-	Vector3 scene_ambient = PhysicsSceneClass::Get_Instance()->Get_Ambient_Light();
-	int callback_counter = 0;
-
-	for (vi=0; vi<model->Get_Vertex_Count(); vi++) {
-
-		AmbientSolve[vi].X = scene_ambient.X;
-		AmbientSolve[vi].Y = scene_ambient.Y;
-		AmbientSolve[vi].Z = scene_ambient.Z;
-		AmbientSolve[vi].W = 1.0f;
-		
-		DiffuseSolve[vi].X = 0.0f;
-		DiffuseSolve[vi].Y = 0.0f;
-		DiffuseSolve[vi].Z = 0.0f;
-		DiffuseSolve[vi].W = MeshDiffuse[vi].W;
-
-		/*
-		** Sun
-		*/
-		Add_Light_To_Vertex(context,vi,sun);
-
-		/*
-		** Other lights
-		*/
-		NonRefPhysListIterator it(&lights);
-		while (!it.Is_Done()) {
-			
-			LightPhysClass * light = it.Peek_Obj()->As_LightPhysClass();
-			if ((light) && (light->Peek_Model()) && (light->Peek_Model()->Class_ID() == RenderObjClass::CLASSID_LIGHT)) {
-
-				LightClass * light_obj = (LightClass*)light->Peek_Model();
-
-				Add_Light_To_Vertex(context,vi,light_obj);
-			}
-			it.Next();
-		}
-
-		context.Get_Progress().Set_Current_Vertex(vi);
-
-		callback_counter++;
-		if (callback_counter > 100) {
-			callback_counter = 0;
-			context.Update_Observer();
-		}
-	}
-
-	VectorProcessorClass::Clamp(&(AmbientSolve[0]),&(AmbientSolve[0]), 0.0f, 1.0f,vcount);
-	VectorProcessorClass::Clamp(&(DiffuseSolve[0]),&(DiffuseSolve[0]), 0.0f, 1.0f,vcount);
-
-	/*
-	** Modulate the accumulated light by the material properties
-	*/
-	for (vi=0; vi<vcount; vi++) {
-		Solve[vi].X = AmbientSolve[vi].X * MeshAmbient[vi].X + DiffuseSolve[vi].X * MeshDiffuse[vi].X;
-		Solve[vi].Y = AmbientSolve[vi].Y * MeshAmbient[vi].Y + DiffuseSolve[vi].Y * MeshDiffuse[vi].Y;
-		Solve[vi].Z = AmbientSolve[vi].Z * MeshAmbient[vi].Z + DiffuseSolve[vi].Z * MeshDiffuse[vi].Z;
-		Solve[vi].W = DiffuseSolve[vi].W;
-	}
-	VectorProcessorClass::Clamp(&(Solve[0]),&(Solve[0]), 0.0f, 1.0f,vcount);
-
-	mesh->Install_User_Lighting_Array(&(Solve[0]));
-	context.Update_Observer();
-	REF_PTR_RELEASE(sun);
 }
 
-static Vector3 _offset (0, 0, 0);
 
-void VertexSolveClass::Light_Terrain(LightSolveContextClass & context,RenegadeTerrainPatchClass * patch, NonRefPhysListClass & lights)
+LightSolveJobListClass::LightSolveJobListClass(LightSolveContextClass & context) :
+	Context(context),
+	Sun(NULL),
+	MainThreadID(ThreadClass::_Get_Current_Thread_ID()),
+	TotalVertexCount(0),
+	ProcessedVertexCount(0),
+	AllJobsAdded(false),
+	NextJob(0),
+	NextObject(0)
 {
-	int vi;
-	context.Get_Progress().Set_Current_Mesh_Name(patch->Get_Name());
-	context.Get_Progress().Set_Current_Mesh_Vertex_Count(patch->Get_Vertex_Count());
+	Sun = PhysicsSceneClass::Get_Instance()->Get_Sun_Light();
+	SceneAmbient = PhysicsSceneClass::Get_Instance()->Get_Ambient_Light();
 
 	/*
-	** Get the model and initialize our arrays
+	** Validate the sun's transform here, the jobs only read the cached one
 	*/
-	int vcount = patch->Get_Vertex_Count();
-	Grow_Arrays(vcount);
+	Sun->Get_Transform();
 
-	/*
-	** Transform the positions and normals into world space
-	*/
-	Matrix3D tm = patch->Get_Transform();
-	const Vector3 * src_verts = patch->Get_Vertex_Array();
-	const Vector3 * src_norms = patch->Get_Vertex_Normal_Array();
+	Prepare_Ray_Casts();
+	PhysicsSceneClass::Get_Instance()->Freeze_Static_Culling();
 
-	VectorProcessorClass::Transform(&(Position[0]), src_verts, tm, vcount);
-	tm.Set_Translation(Vector3(0,0,0));
-	VectorProcessorClass::Transform(&(Normal[0]), src_norms, tm, vcount);
+	Context.Get_Progress().Set_Worker_Count(WorkerPoolClass::Get_Thread_Count());
+}
 
-	/*
-	** For heightfield terrains, the mesh ambient and diffuse colors are white
-	*/
-	for (int index = 0; index < vcount; index ++) {
-		MeshAmbient[index].Set (1.0F, 1.0F, 1.0F, 1.0F);
-		MeshDiffuse[index].Set (1.0F, 1.0F, 1.0F, 1.0F);
+LightSolveJobListClass::~LightSolveJobListClass(void)
+{
+	Group.Wait();
+	PhysicsSceneClass::Get_Instance()->Thaw_Static_Culling();
+
+	for (int i=0; i<Jobs.Count(); i++) {
+		delete Jobs[i];
+	}
+	for (int i=0; i<Objects.Count(); i++) {
+		delete Objects[i];
 	}
+	REF_PTR_RELEASE(Sun);
+}
 
-	/*
-	** Compute the light solve
-	*/
-	LightClass * sun = PhysicsSceneClass::Get_Instance()->Get_Sun_Light();
-	Vector3 scene_ambient = PhysicsSceneClass::Get_Instance()->Get_Ambient_Light();
-	int callback_counter = 0;
-
-	for (vi = 0; vi < vcount; vi ++) {
-
-		AmbientSolve[vi].X = scene_ambient.X;
-		AmbientSolve[vi].Y = scene_ambient.Y;
-		AmbientSolve[vi].Z = scene_ambient.Z;
-		AmbientSolve[vi].W = 1.0f;
-		
-		DiffuseSolve[vi].X = 0.0f;
-		DiffuseSolve[vi].Y = 0.0f;
-		DiffuseSolve[vi].Z = 0.0f;
-		DiffuseSolve[vi].W = MeshDiffuse[vi].W;
+LightSolveLightsClass * LightSolveJobListClass::Add_Object(StaticPhysClass * obj)
+{
+	LightSolveLightsClass * lights = new LightSolveLightsClass;
+	lights->FirstJob = Jobs.Count();
+	Objects.Add(lights);
 
-		/*
-		** Sun
-		*/
-		Add_Light_To_Vertex(context,vi,sun);
+	if (obj->Is_Model_Pre_Lit() == false) {
+		NonRefPhysListClass light_list;
+		PhysicsSceneClass::Get_Instance()->Collect_Lights(obj->Get_Cull_Box(),true,false,&light_list);
 
-		/*
-		** Other lights
-		*/
-		NonRefPhysListIterator it(&lights);
+		NonRefPhysListIterator it(&light_list);
 		while (!it.Is_Done()) {
 			
 			LightPhysClass * light = it.Peek_Obj()->As_LightPhysClass();
@@ -306,106 +661,100 @@ void VertexSolveClass::Light_Terrain(LightSolveContextClass & context,RenegadeTe
 
 				LightClass * light_obj = (LightClass*)light->Peek_Model();
 
-				Add_Light_To_Vertex(context,vi,light_obj);
+				/*
+				** Validate the transform here, the jobs only read it
+				*/
+				light_obj->Get_Transform();
+				lights->Lights.Add(light_obj);
 			}
 			it.Next();
 		}
-
-		context.Get_Progress().Set_Current_Vertex(vi);
-
-		callback_counter++;
-		if (callback_counter > 100) {
-			callback_counter = 0;
-			context.Update_Observer();
-		}
 	}
+	return lights;
+}
 
-	VectorProcessorClass::Clamp(&(AmbientSolve[0]),&(AmbientSolve[0]), 0.0f, 1.0f,vcount);
-	VectorProcessorClass::Clamp(&(DiffuseSolve[0]),&(DiffuseSolve[0]), 0.0f, 1.0f,vcount);
+void LightSolveJobListClass::Add_Mesh(RenderObjClass * model,LightSolveLightsClass * lights)
+{
+	VertexSolveClass * job = new VertexSolveClass;
+	job->Init(this,model,lights);
+	Jobs.Add(job);
+	lights->JobCount++;
 
-	/*
-	** Modulate the accumulated light by the material properties
-	*/
-	for (vi=0; vi<vcount; vi++) {
-		Solve[vi].X = AmbientSolve[vi].X * MeshAmbient[vi].X + DiffuseSolve[vi].X * MeshDiffuse[vi].X;
-		Solve[vi].Y = AmbientSolve[vi].Y * MeshAmbient[vi].Y + DiffuseSolve[vi].Y * MeshDiffuse[vi].Y;
-		Solve[vi].Z = AmbientSolve[vi].Z * MeshAmbient[vi].Z + DiffuseSolve[vi].Z * MeshDiffuse[vi].Z;
-		Solve[vi].W = DiffuseSolve[vi].W;
-	}
-	VectorProcessorClass::Clamp(&(Solve[0]),&(Solve[0]), 0.0f, 1.0f,vcount);
+	TotalVertexCount += job->Get_Vertex_Count();
+	Context.Get_Progress().Set_Total_Vertex_Count(TotalVertexCount);
+
+	WorkerPoolClass::Submit(Job_Function,job,0,Group);
 
 	/*
-	**	Pass the resultant vertex colors onto the patch
+	** With no worker threads the job has already run, install it right away
 	*/
-	for (vi=0; vi<vcount; vi++) {
-		patch->Set_Vertex_Color (vi, Vector3 (Solve[vi].X, Solve[vi].Y, Solve[vi].Z));
-	}
-
-	//
-	//	Let the patch know that it is now prelit
-	//
-	patch->Set_Is_Prelit (true);
-	return ;
+	Install_Finished_Jobs();
 }
 
+void LightSolveJobListClass::Finish(void)
+{
+	unsigned last_update = 0;
+	AllJobsAdded = true;
+	for (;;) {
+		Install_Finished_Jobs();
+		if (NextObject >= Objects.Count()) {
+			break;
+		}
 
-void VertexSolveClass::Add_Light_To_Vertex(LightSolveContextClass & context,int vi,LightClass * light_obj)
-{				
-	if (light_obj->Is_Within_Attenuation_Radius(Position[vi])) {
-	
-		// cast ray...
-		bool is_occluded = false;
-
-#pragma message("need a collision group for light occlusion here...")
-		if (context.Is_Occlusion_Enabled()) {
-			CastResultStruct res;
-			Vector3 p0 = Position[vi];
-			Vector3 p1 = light_obj->Get_Position();
-
-			if (light_obj->Get_Type() == LightClass::DIRECTIONAL) {
-				Vector3 dir = -(light_obj->Get_Transform().Get_Z_Vector());
-				p1 = p0 + dir * light_obj->Get_Attenuation_Range();
-			}
-
-			const float MOVE_AMOUNT = 0.25f;		// can't be occluded closer than this
-			Vector3 delta = p1-p0;
-			delta.Normalize();
-			p0 += MOVE_AMOUNT * delta;
+		unsigned time = ::GetTickCount();
+		if (time - last_update >= LIGHT_SOLVE_UPDATE_MS) {
+			last_update = time;
+			Update_Progress();
+			Context.Update_Observer();
+		}
+		ThreadClass::Sleep_Ms(5);
+	}
+	Update_Progress();
+	Context.Update_Observer();
+}
 
-			p0 += _offset;
-			p1 += _offset;
+void LightSolveJobListClass::Job_Function(void * data,int index)
+{
+	((VertexSolveClass *)data)->Compute_Lighting();
+}
 
-			LineSegClass ray(p0,p1);
-			PhysRayCollisionTestClass raytest(ray,&res,0,COLLISION_TYPE_PROJECTILE);
-			raytest.CheckDynamicObjs = false;
-			PhysicsSceneClass::Get_Instance()->Cast_Ray(raytest);
+void LightSolveJobListClass::Install_Finished_Jobs(void)
+{
+	for (;;) {
 
-			if (res.Fraction < 1.0f) {
-				is_occluded = true;
-			}
+		/*
+		** Count off each object once all of its meshes are installed
+		*/
+		while (	(NextObject < Objects.Count()) && 
+					(Objects[NextObject]->FirstJob + Objects[NextObject]->JobCount <= NextJob) &&
+					((NextObject + 1 < Objects.Count()) || AllJobsAdded) ) 
+		{
+			Context.Get_Progress().Increment_Processed_Object_Count();
+			NextObject++;
 		}
 
-		if (!is_occluded) {
-
-			Vector3 ambient;
-			Vector3 diffuse;
-			light_obj->Compute_Lighting(Position[vi],Normal[vi],&ambient,&diffuse);
+		if ((NextJob >= Jobs.Count()) || !Jobs[NextJob]->Is_Finished()) {
+			break;
+		}
 
-			AmbientSolve[vi] += Vector4(ambient.X,ambient.Y,ambient.Z,0.0f);
-			DiffuseSolve[vi] += Vector4(diffuse.X,diffuse.Y,diffuse.Z,0.0f);
+		VertexSolveClass * job = Jobs[NextJob];
+		if (!job->Was_Cancelled()) {
+			WWDEBUG_SAY(("Installing Solve for Mesh: %s\r\n",job->Peek_Model()->Get_Name()));
 		}
+		job->Install();
+		NextJob++;
 	}
 }
 
-void VertexSolveClass::Grow_Arrays(int vcount)
+void LightSolveJobListClass::Update_Progress(void)
 {
-	Position.Uninitialised_Grow(vcount);
-	Normal.Uninitialised_Grow(vcount);
-	AmbientSolve.Uninitialised_Grow(vcount);
-	DiffuseSolve.Uninitialised_Grow(vcount);
-	Solve.Uninitialised_Grow(vcount);
-	MeshAmbient.Uninitialised_Grow(vcount);
-	MeshDiffuse.Uninitialised_Grow(vcount);
+	Context.Get_Progress().Set_Processed_Vertex_Count(ProcessedVertexCount);
+	if (NextJob < Jobs.Count()) {
+		VertexSolveClass * job = Jobs[NextJob];
+		Context.Get_Progress().Set_Current_Mesh_Name(job->Peek_Model()->Get_Name());
+		Context.Get_Progress().Set_Current_Mesh_Vertex_Count(job->Get_Vertex_Count());
+		Context.Get_Progress().Set_Current_Vertex(job->Get_Processed_Vertex_Count());
+	}
 }
 
 
@@ -494,16 +843,22 @@ void LightSolveClass::Compute_Solve(LightSolveContextClass & context,RefPhysList
 	context.Get_Progress().Set_Object_Count(count);
 	
 	/*
-	** Generate a light solve for each static object
+	** Generate a light solve for each static object.  Each mesh is solved
+	** on the worker threads and installed once all of the meshes before it are.
 	*/
-	it.First();
-	while (!it.Is_Done() && !context.Get_Progress().Is_Cancel_Requested()) {
-		StaticPhysClass * obj = it.Peek_Obj()->As_StaticPhysClass();
-		if (obj != NULL) {
-			Compute_Solve(context,obj);
-			context.Get_Progress().Increment_Processed_Object_Count();
+	{
+		LightSolveJobListClass jobs(context);
+
+		it.First();
+		while (!it.Is_Done() && !context.Get_Progress().Is_Cancel_Requested()) {
+			StaticPhysClass * obj = it.Peek_Obj()->As_StaticPhysClass();
+			if (obj != NULL) {
+				Compute_Solve(jobs,obj);
+			}
+			it.Next();
 		}
-		it.Next();
+
+		jobs.Finish();
 	}
 
 	/*
@@ -512,24 +867,20 @@ void LightSolveClass::Compute_Solve(LightSolveContextClass & context,RefPhysList
 	TheDX8MeshRenderer.Invalidate();
 }
 
-void LightSolveClass::Compute_Solve(LightSolveContextClass & context,StaticPhysClass * obj)
+void LightSolveClass::Compute_Solve(LightSolveJobListClass & jobs,StaticPhysClass * obj)
 {
 	WWASSERT(obj != NULL);
-	if (context.Get_Progress().Get_Object_Count() == 0) {
-		context.Get_Progress().Set_Object_Count(1);
-	}
 
 	/*
 	** Generate a light solve for each mesh in this object
 	*/
+	LightSolveLightsClass * lights = jobs.Add_Object(obj);
 	if (obj->Is_Model_Pre_Lit() == false) {
-		NonRefPhysListClass light_list;
-		PhysicsSceneClass::Get_Instance()->Collect_Lights(obj->Get_Cull_Box(),true,false,&light_list);
-		Compute_Solve(context,obj->Peek_Model(),light_list);
+		Compute_Solve(jobs,obj->Peek_Model(),lights);
 	}
 }
 
-void LightSolveClass::Compute_Solve(LightSolveContextClass & context,RenderObjClass * obj,NonRefPhysListClass & light_list)
+void LightSolveClass::Compute_Solve(LightSolveJobListClass & jobs,RenderObjClass * obj,LightSolveLightsClass * lights)
 {
 	/*
 	** Mark this render object as containing a static lighting solve
@@ -543,20 +894,19 @@ void LightSolveClass::Compute_Solve(LightSolveContextClass & context,RenderObjCl
 	for (int i=0; i<obj->Get_Num_Sub_Objects(); i++) {
 		RenderObjClass * sub_obj = obj->Get_Sub_Object(i);
 		if (sub_obj != NULL) {
-			Compute_Solve(context,sub_obj,light_list);
+			Compute_Solve(jobs,sub_obj,lights);
 			REF_PTR_RELEASE(sub_obj);
 		}
 	}
 
 	/*
-	** For all mesh objects, generate a vertex lighting solution.
+	** For all mesh objects, queue up a vertex lighting solution.
 	*/
 	if (obj->Class_ID() == RenderObjClass::CLASSID_MESH) {
-		MeshClass * mesh = (MeshClass*)obj;
-		WWDEBUG_SAY(("Generating Solve for Mesh: %s\r\n",mesh->Get_Name()));
-		TheVertexSolver.Light_Mesh(context,mesh,light_list);		
+		WWDEBUG_SAY(("Generating Solve for Mesh: %s\r\n",obj->Get_Name()));
+		jobs.Add_Mesh(obj,lights);
 	} else if (obj->Class_ID() == RenderObjClass::CLASSID_RENEGADE_TERRAIN) {
-		TheVertexSolver.Light_Terrain(context,(RenegadeTerrainPatchClass *)obj,light_list);
+		jobs.Add_Mesh(obj,lights);
 	}
 }
 
@@ -47,6 +47,8 @@ class StaticPhysClass;
 class RenderObjClass;
 class LightSolveContextClass;
 class LightSolveProgressClass;
+class LightSolveJobListClass;
+class LightSolveLightsClass;
 
 /**
 ** LightSolveClass
@@ -64,8 +66,8 @@ static void		Generate_Static_Light_Solve(LightSolveContextClass & context,RefPhy
 private:
 
 static void		Compute_Solve(LightSolveContextClass & context,RefPhysListClass & obj_list);
-static void		Compute_Solve(LightSolveContextClass & context,StaticPhysClass * phys_obj);
-static void		Compute_Solve(LightSolveContextClass & context,RenderObjClass * model,NonRefPhysListClass & light_list);
+static void		Compute_Solve(LightSolveJobListClass & jobs,StaticPhysClass * phys_obj);
+static void		Compute_Solve(LightSolveJobListClass & jobs,RenderObjClass * model,LightSolveLightsClass * lights);
 static bool		Does_Obj_Get_Static_Light_Solve(StaticPhysClass * obj);
 static bool		Does_Model_Get_Static_Light_Solve(RenderObjClass * model);
 
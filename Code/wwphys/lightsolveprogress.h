@@ -58,8 +58,12 @@ public:
 	int				Get_Current_Mesh_Vertex_Count(void)				{ return CurrentVertexCount; }
 	int				Get_Current_Vertex(void)							{ return CurrentVertex; }
 
+	int				Get_Total_Vertex_Count(void)						{ return TotalVertexCount; }
+	int				Get_Processed_Vertex_Count(void)					{ return ProcessedVertexCount; }
+	int				Get_Worker_Count(void)								{ return WorkerCount; }
+
 	/*
-	** Set status (vertex solver does this)
+	** Set status (vertex solver does this, always from the main thread)
 	*/
 	void				Set_Object_Count(int count)						{ ObjectCount = count; }
 	void				Increment_Processed_Object_Count(void)			{ ProcessedObjectCount++; }
@@ -68,6 +72,10 @@ public:
 	void				Set_Current_Mesh_Vertex_Count(int vcount)		{ CurrentVertexCount = vcount; }
 	void				Set_Current_Vertex(int index)						{ CurrentVertex = index; }	
 
+	void				Set_Total_Vertex_Count(int vcount)				{ TotalVertexCount = vcount; }
+	void				Set_Processed_Vertex_Count(int vcount)			{ ProcessedVertexCount = vcount; }
+	void				Set_Worker_Count(int count)						{ WorkerCount = count; }
+
 	/*
 	** Cancellation request
 	*/
@@ -83,7 +91,11 @@ protected:
 	int				CurrentVertexCount;
 	int				CurrentVertex;
 
-	bool				CancelRequested;
+	int				TotalVertexCount;
+	int				ProcessedVertexCount;
+	int				WorkerCount;
+
+	volatile bool	CancelRequested;
 };
 
 inline LightSolveProgressClass::LightSolveProgressClass(void) :
@@ -92,6 +104,9 @@ inline LightSolveProgressClass::LightSolveProgressClass(void) :
 	CurrentMeshName(NULL),
 	CurrentVertexCount(0),
 	CurrentVertex(0),
+	TotalVertexCount(0),
+	ProcessedVertexCount(0),
+	WorkerCount(0),
 	CancelRequested(false)
 {
 }
@@ -38,4 +38,4 @@
 #include "pathnode.h"
 
 
-DEFINE_AUTO_POOL(PathNodeClass, 512);
\ No newline at end of file
+DEFINE_THREAD_CACHED_AUTO_POOL(PathNodeClass, 512);
\ No newline at end of file
@@ -61,6 +61,8 @@
  *   PhysicsSceneClass::Unregister -- Unregisters the given render object                      *
  *   PhysicsSceneClass::Set_Vis_Sample_Point -- Set the current vis sample point               *
  *   PhysicsSceneClass::Pre_Render_Processing -- processing which occurs prior to rendering    *
+ *   PhysicsSceneClass::Enable_Pipelined_Render_Lists -- collect static objects on a worker    *
+ *   PhysicsSceneClass::Collect_Pipelined_Static_Objects -- static objects from the worker     *
  *   PhysicsSceneClass::Post_Render_Processing -- processing that occurs after rendering       *
  *   PhysicsSceneClass::Optimize_LODs -- Set the LOD level for each object                     *
  *   PhysicsSceneClass::Render -- Render the scene                                             *
@@ -107,12 +109,15 @@
 #include "shader.h"
 #include "lookuptable.h"
 #include "shattersystem.h"
+#include "part_buf.h"
 #include "projectile.h"
 #include "staticphys.h"
 #include "vistable.h"
 #include "meshmdl.h"
 #include "camerashakesystem.h"
+#include "lightprobegrid.h"
 #include "lightenvironment.h"
+#include "rendersnapshot.h"
 #include "dx8wrapper.h"
 #include "physresourcemgr.h"
 #include "phys3.h"
@@ -182,6 +187,7 @@ PhysicsSceneClass::PhysicsSceneClass(void) :
 	SceneAmbientLight(0.5f,0.5f,0.5f),
 	UseSun(false),
 	SunLight(NULL),
+	LightProbes(NULL),
 	VisEnabled(true),
 	VisInverted(false),
 	VisQuickAndDirty(false),
@@ -213,7 +219,9 @@ PhysicsSceneClass::PhysicsSceneClass(void) :
 	CameraShakeSystem(NULL),
 	HighlightMaterialPass(NULL),
 	UpdateOnlyVisibleObjects(false),
-	CurrentFrameNumber(0)
+	CurrentFrameNumber(0),
+	StaticCullingFrozen(0),
+	RenderSnapshot(NULL)
 {
 	WWASSERT_PRINT(TheScene == NULL,"Only one instance of the PhysicsSceneClass is allowed.\r\n");
 	WWMEMLOG(MEM_PHYSICSDATA);
@@ -251,6 +259,11 @@ PhysicsSceneClass::PhysicsSceneClass(void) :
 	*/
 	CameraShakeSystem = new CameraShakeSystemClass;
 
+	/*
+	** Allocate the light probe grid, it stays empty until probes are baked or loaded
+	*/
+	LightProbes = new LightProbeGridClass;
+
 	/*
 	** Allocate the sun light
 	*/
@@ -284,6 +297,9 @@ PhysicsSceneClass::PhysicsSceneClass(void) :
  *=============================================================================================*/
 PhysicsSceneClass::~PhysicsSceneClass(void)
 {
+	delete RenderSnapshot;
+	RenderSnapshot = NULL;
+
 	Remove_All();
 
 	delete StaticCullingSystem;
@@ -294,6 +310,7 @@ PhysicsSceneClass::~PhysicsSceneClass(void)
 	delete DynamicProjectorCullingSystem;
 	delete Pathfinder;
 	delete CameraShakeSystem;
+	delete LightProbes;
 
 	REF_PTR_RELEASE(SunLight);
 
@@ -488,6 +505,7 @@ void PhysicsSceneClass::Add_Static_Object(StaticPhysClass * newtile,int cull_nod
 	WWASSERT(newtile != NULL);
 	WWASSERT(newtile->Peek_Model() != NULL);
 	WWASSERT(newtile->Get_Culling_System() == NULL);
+	WWASSERT(!Is_Static_Culling_Frozen());
 
 	// Add the object to the static culling system
 	StaticCullingSystem->Add_Object(newtile,cull_node_id);
@@ -671,6 +689,7 @@ void PhysicsSceneClass::Remove_Object(PhysClass * obj)
 	} else if (cullsys == StaticCullingSystem) {
 
 		WWASSERT(obj->As_StaticPhysClass() != NULL);
+		WWASSERT(!Is_Static_Culling_Frozen());
 		StaticCullingSystem->Remove_Object(obj->As_StaticPhysClass());
 		StaticObjList.Remove(obj);
 
@@ -1097,6 +1116,7 @@ void PhysicsSceneClass::Pre_Render_Processing(CameraClass & camera)
 	for (rit.First(); !rit.Is_Done(); rit.Next()) {
 		rit.Peek_Obj()->On_Frame_Update();
 	}	
+	ParticleBufferClass::Update_Particle_Buffers(UpdateList);
 
 	// Update culling info for all of the objects in the "dirty cull" list (these are
 	// objects which were added to the scene as pure render objects so I don't assume
@@ -1129,7 +1149,11 @@ void PhysicsSceneClass::Pre_Render_Processing(CameraClass & camera)
 		// Get the lists of visible objects
 		{ 
 			WWPROFILE( "Collect Static Objs" );
-			StaticCullingSystem->Collect_Visible_Objects(camera.Get_Frustum(),pvs,VisibleStaticObjectList,VisibleWSMeshList);
+			if (RenderSnapshot == NULL) {
+				StaticCullingSystem->Collect_Visible_Objects(camera.Get_Frustum(),pvs,VisibleStaticObjectList,VisibleWSMeshList);
+			} else {
+				Collect_Pipelined_Static_Objects(camera,pvs);
+			}
 		}
 
 		// Collect list of the visible dynamic objects
@@ -1158,6 +1182,77 @@ void PhysicsSceneClass::Pre_Render_Processing(CameraClass & camera)
 	REF_PTR_RELEASE(pvs);
 }
 
+/***********************************************************************************************
+ * PhysicsSceneClass::Enable_Pipelined_Render_Lists -- collect static objects on a worker      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * onoff - true to build the static render lists for the next frame on a worker thread         *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Enable_Pipelined_Render_Lists(bool onoff)
+{
+	if (onoff && (RenderSnapshot == NULL)) {
+		RenderSnapshot = new RenderSnapshotClass;
+	} else if (!onoff && (RenderSnapshot != NULL)) {
+		delete RenderSnapshot;
+		RenderSnapshot = NULL;
+	}
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Collect_Pipelined_Static_Objects -- static objects from the worker       *
+ *                                                                                             *
+ *    Uses the lists the worker built from last frame's snapshot if they still cover this      *
+ *    camera, otherwise collects the objects normally.  Either way, a snapshot of this frame   *
+ *    is then handed to the worker to build the lists for the next frame.                      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * camera - camera being rendered                                                              *
+ * pvs - pvs for the camera                                                                    *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Collect_Pipelined_Static_Objects(CameraClass & camera,VisTableClass * pvs)
+{
+	WWASSERT(RenderSnapshot != NULL);
+
+	/*
+	** The inverted pvs is a new table every frame, just do it the normal way
+	*/
+	if ((pvs == NULL) || VisInverted) {
+		StaticCullingSystem->Collect_Visible_Objects(camera.Get_Frustum(),pvs,VisibleStaticObjectList,VisibleWSMeshList);
+		RenderSnapshot->Begin_Static_Render_Lists(camera,NULL,false,0,0,NULL);
+		return;
+	}
+
+	unsigned version = StaticCullingSystem->Get_Change_Count();
+	unsigned vis_version = VisTableManager.Get_Change_Count();
+	if (RenderSnapshot->Install_Static_Render_Lists(camera,pvs,version,vis_version,VisibleStaticObjectList,VisibleWSMeshList)) {
+		CurrentStats.PipelinedRenderListHits++;
+	} else {
+		StaticCullingSystem->Collect_Visible_Objects(camera.Get_Frustum(),pvs,VisibleStaticObjectList,VisibleWSMeshList);
+		CurrentStats.PipelinedRenderListMisses++;
+	}
+
+	RenderSnapshot->Begin_Static_Render_Lists(	camera,
+																pvs,
+																StaticAABTreeCullClass::Is_Hierarchical_Vis_Culling_Enabled(),
+																version,
+																vis_version,
+																StaticCullingSystem );
+}
+
+
 /***********************************************************************************************
  * PhysicsSceneClass::Post_Render_Processing -- processing that occurs after rendering         *
  *                                                                                             *
@@ -1629,7 +1724,9 @@ void PhysicsSceneClass::Render_Backface_Occluders
  *=============================================================================================*/
 void PhysicsSceneClass::Re_Partition_Static_Objects(void)
 {
+	WWASSERT(!Is_Static_Culling_Frozen());
 	StaticCullingSystem->Re_Partition();
+	StaticCullingSystem->Mark_Changed();
 }
 
 
@@ -1757,7 +1854,9 @@ void PhysicsSceneClass::Re_Partition_Static_Projectors(void)
  *=============================================================================================*/
 void PhysicsSceneClass::Update_Culling_System_Bounding_Boxes(void)
 {
+	WWASSERT(!Is_Static_Culling_Frozen());
 	StaticCullingSystem->Update_Bounding_Boxes();
+	StaticCullingSystem->Mark_Changed();
 	StaticLightingSystem->Update_Bounding_Boxes();
 }
 
@@ -1874,6 +1973,7 @@ void PhysicsSceneClass::Per_Frame_Statistics_Update(void)
 		DynamicCullingSystem->Reset_Statistics();
 		StaticCullingSystem->Reset_Statistics();
 		StaticLightingSystem->Reset_Statistics();
+		VisTableManager.Reset_Statistics();
 
 		/*
 		** Copy over LastValidStats, reset
@@ -2122,6 +2222,11 @@ void PhysicsSceneClass::StatsStruct::Reset(void)
 	CullNodesAccepted = 0;
 	CullNodesTriviallyAccepted = 0;
 	CullNodesRejected = 0;
+	VisSectorChanges = 0;
+	VisSectorChangeDecompressions = 0;
+	VisSectorChangeMicroseconds = 0.0f;
+	PipelinedRenderListHits = 0;
+	PipelinedRenderListMisses = 0;
 }
 
 
@@ -74,6 +74,8 @@ class PhysDecalSysClass;
 class MeshClass;
 class VisOptProgressClass;
 class CameraShakeSystemClass;
+class LightProbeGridClass;
+class RenderSnapshotClass;
 class LightEnvironmentClass;
 class StaticAnimPhysClass;
 class StringClass;
@@ -636,6 +638,18 @@ public:
 	void							Compute_Static_Lighting(LightEnvironmentClass * light_env,const Vector3 & obj_center,bool use_sun,int vis_object_id);
 	void							Invalidate_Lighting_Caches(const AABoxClass & bounds);
 
+	/*
+	** Light Probes:  A grid of pre-computed static lighting samples covering the level.  When
+	** present, Compute_Static_Lighting blends the probes around the object rather than collecting
+	** and vis-testing the static lights for each object.  The probes depend on the light vis so
+	** they should be baked after the vis is generated (typically only done in the EDITOR).
+	*/
+	enum { DEFAULT_LIGHT_PROBE_SPACING = 4 };
+
+	void							Bake_Light_Probes(float spacing = DEFAULT_LIGHT_PROBE_SPACING);
+	void							Reset_Light_Probes(void);
+	bool							Has_Light_Probes(void);
+
 	/*
 	** Collision Detection Methods
 	** Set_Collision_Region - collects objects in the given region into a list for subsequent collision checks
@@ -717,6 +731,15 @@ public:
 	void							Update_Culling_System_Bounding_Boxes(void);
 	bool							Verify_Culling_Systems(StringClass & set_error_report);
 
+	/*
+	** While the static culling system is frozen, static objects can't be added, removed or 
+	** re-partitioned so other threads can safely cast rays against them (see LightSolveClass).
+	** Calls nest.
+	*/
+	void							Freeze_Static_Culling(void)				{ StaticCullingFrozen++; }
+	void							Thaw_Static_Culling(void)					{ StaticCullingFrozen--; }
+	bool							Is_Static_Culling_Frozen(void)			{ return StaticCullingFrozen > 0; }
+
 	/*
 	** Visibility System.  
 	** Enable_Vis - turn the vis system on or off
@@ -806,6 +829,7 @@ public:
 	int							Allocate_Vis_Sector_ID(int count = 1);
 	int							Get_Vis_Table_Size(void);		// also max vis *object* ID and vis object count.
 	int							Get_Vis_Table_Count(void);		// also max vis *sector* ID and vis sector count.
+	void							Set_Vis_Cache_Budget(int bytes);	// memory allowed for decompressed vis tables
 
 	VisSampleClass				Update_Vis(const Matrix3D & camera,VisDirBitsType direction_bits = VIS_ALL);
 	VisSampleClass				Update_Vis(const Vector3 & sample_point,const Matrix3D & camera,VisDirBitsType direction_bits = VIS_ALL,CameraClass * alternate_camera = NULL,int user_vis_id = -1);
@@ -943,6 +967,15 @@ public:
 	void							Set_Update_Only_Visible_Objects(bool b) { UpdateOnlyVisibleObjects=b; }
 	bool							Get_Update_Only_Visible_Objects() { return UpdateOnlyVisibleObjects; }
 
+	/*
+	** Pipelined render lists.  When enabled, the static objects for the next frame are 
+	** collected on a worker thread while the game and physics run; Pre_Render_Processing 
+	** then only has to trim that list down to the real frustum.  Falls back to the normal
+	** collection whenever the camera moved or turned too far, or changed vis sectors.
+	*/
+	void							Enable_Pipelined_Render_Lists(bool onoff);
+	bool							Are_Pipelined_Render_Lists_Enabled(void)		{ return RenderSnapshot != NULL; }
+
 	/*
 	** Scene Class methods.  These should *only* be used when absolutely necessary since
 	** it is more efficient to operate through the physics interface (I can keep track
@@ -994,6 +1027,13 @@ public:
 		int	CullNodesTriviallyAccepted;
 		int	CullNodesRejected;
 
+		int	VisSectorChanges;					// times the camera moved into a different vis sector
+		int	VisSectorChangeDecompressions;	// sector changes where the pvs wasn't in the cache
+		float	VisSectorChangeMicroseconds;	// total time spent decompressing for sector changes
+
+		int	PipelinedRenderListHits;		// frames that used the lists built on the worker
+		int	PipelinedRenderListMisses;		// frames that had to collect the static objects themselves
+
 	};
 
 	void							Per_Frame_Statistics_Update(void);
@@ -1009,6 +1049,7 @@ protected:
 	void							Render_Objects(RenderInfoClass& rinfo,RefPhysListClass * static_ws_list,RefPhysListClass * static_list,RefPhysListClass * dyn_list);
 	void							Render_Object(RenderInfoClass & context,PhysClass * obj);
 	void							Render_Backface_Occluders(RenderInfoClass & context,RefPhysListClass *  static_ws_list,RefPhysListClass * static_list);
+	void							Collect_Pipelined_Static_Objects(CameraClass & camera,VisTableClass * pvs);
 
 	void							Optimize_LODs(	CameraClass & camera,
 														RefPhysListClass * dyn_obj_list,
@@ -1023,6 +1064,8 @@ protected:
 	void							Vis_Render_And_Scan(VisRenderContextClass & context,VisSampleClass & sample);
 	void							Merge_Vis_Sector_IDs(uint32 id0,uint32 id1);
 	void							Merge_Vis_Object_IDs(uint32 id0,uint32 id1);
+	void							Remap_Vis_Sector_IDs(const uint32 * id_map,uint32 id_count);
+	void							Remap_Vis_Object_IDs(const uint32 * id_map,uint32 id_count);
 
 	/*
 	** Internal texture-projection functions
@@ -1070,6 +1113,9 @@ protected:
 	void							Add_Collected_Collideable_Objects_To_List(int colgroup,bool static_objs,bool dynamic_objs,NonRefPhysListClass * list);
 	void							Add_Collected_Lights_To_List(bool static_lights,bool dynamic_lights,NonRefPhysListClass * list);
 
+	void							Add_Static_Lights(LightEnvironmentClass * light_env,const Vector3 & obj_center,int vis_object_id);
+	void							Bake_Light_Probe(int index);
+
 	//- Volatile or Constant Member Variables -------------------------------------------------------------
 	// 
 	// These variables do not need to be saved or loaded for one of the following reasons:
@@ -1211,6 +1257,7 @@ protected:
 	float							SunPitch;
 	float							SunYaw;
 	LightClass *				SunLight;
+	LightProbeGridClass *	LightProbes;
 	
 
 	//- Level Dynamic Data --------------------------------------------------------------------------------
@@ -1253,6 +1300,10 @@ protected:
 	bool							UpdateOnlyVisibleObjects;
 	unsigned						CurrentFrameNumber;
 
+	int							StaticCullingFrozen;		// see Freeze_Static_Culling
+
+	RenderSnapshotClass *	RenderSnapshot;			// NULL unless pipelined render lists are enabled
+
 private:
 	
 	/*
@@ -45,6 +45,11 @@
  *   PhysicsSceneClass::Get_Lighting_LOD_Cutoff -- returns the LOD cutoff for lighting         *
  *   PhysicsSceneClass::Compute_Static_Lighting -- Compute the static lighting approximation   *
  *   PhysicsSceneClass::Invalidate_Lighting_Caches -- invalidate lighting caches in the given  *
+ *   PhysicsSceneClass::Add_Static_Lights -- Adds the static lights affecting a point           *
+ *   PhysicsSceneClass::Bake_Light_Probes -- Computes the light probe grid for the level       *
+ *   PhysicsSceneClass::Bake_Light_Probe -- Computes a single light probe                      *
+ *   PhysicsSceneClass::Reset_Light_Probes -- Discards the light probe grid                    *
+ *   PhysicsSceneClass::Has_Light_Probes -- Returns true if the level has light probes         *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
@@ -58,6 +63,9 @@
 #include "lightphys.h"
 #include "light.h"
 #include "lightcull.h"
+#include "lightprobegrid.h"
+#include "lightenvironment.h"
+#include "wwprofile.h"
 
 
 /***********************************************************************************************
@@ -76,6 +84,13 @@
  *=============================================================================================*/
 void PhysicsSceneClass::Set_Lighting_LOD_Cutoff(float intensity)				
 { 
+	/*
+	** The light probes were baked with the old cutoff
+	*/
+	if (intensity != LightEnvironmentClass::Get_Lighting_LOD_Cutoff()) {
+		LightProbes->Invalidate_All();
+	}
+
 	LightEnvironmentClass::Set_Lighting_LOD_Cutoff(intensity); 
 }
 
@@ -277,8 +292,51 @@ void PhysicsSceneClass::Compute_Static_Lighting
 	}
 		
 	/*
-	** Add in the static lights affecting this object
+	** Blend the light probes around the object which are in the same vis sector, so that
+	** lights on the other side of a wall stay out.  Probes that were invalidated since they
+	** were baked are re-computed first.
+	*/
+	LightProbeGridClass::SampleStruct sample;
+	if (	LightProbes->Find_Probes(obj_center,&sample) &&
+			LightProbes->Select_Probes(&sample,(uint32)vis_object_id)	)
+	{
+		for (int i=0; i<8; i++) {
+			if ((sample.Weight[i] > 0.0f) && LightProbes->Is_Probe_Dirty(sample.Index[i])) {
+				Bake_Light_Probe(sample.Index[i]);
+			}
+		}
+		LightProbes->Apply(sample,light_env);
+		return;
+	}
+
+	/*
+	** No usable probes here, add in the static lights affecting this object
 	*/
+	Add_Static_Lights(light_env,obj_center,vis_object_id);
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Add_Static_Lights -- Adds the static lights affecting a point            *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * light_env - light environment to add the lights to                                          *
+ * obj_center - point being lit                                                                *
+ * vis_object_id - vis id of the point, lights that can't see it are skipped                   *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Add_Static_Lights
+(
+	LightEnvironmentClass * light_env,
+	const Vector3 & obj_center,
+	int vis_object_id
+)
+{
 	StaticLightingSystem->Reset_Collection();
 	StaticLightingSystem->Collect_Objects(obj_center);
 	LightPhysClass * light = StaticLightingSystem->Get_First_Collected_Object();
@@ -295,6 +353,71 @@ void PhysicsSceneClass::Compute_Static_Lighting
 }
 
 
+/***********************************************************************************************
+ * PhysicsSceneClass::Bake_Light_Probes -- Computes the light probe grid for the level         *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * spacing - distance between the probes, may be increased for very large levels              *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * The probes use the light vis, so generate the vis first.                                    *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Bake_Light_Probes(float spacing)
+{
+	WWPROFILE("Bake_Light_Probes");
+
+	Vector3 wmin,wmax;
+	Get_Level_Extents(wmin,wmax);
+	LightProbes->Init(wmin,wmax,spacing);
+
+	for (int i=0; i<LightProbes->Get_Probe_Count(); i++) {
+		Bake_Light_Probe(i);
+	}
+	WWDEBUG_SAY(("Baked %d light probes, %.1f apart\r\n",LightProbes->Get_Probe_Count(),LightProbes->Get_Spacing()));
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Bake_Light_Probe -- Computes a single light probe                        *
+ *                                                                                             *
+ * The probe gets the same static lights an object at the probe would get, minus the scene     *
+ * ambient and the sun which are added when the probes are sampled.                            *
+ *=============================================================================================*/
+void PhysicsSceneClass::Bake_Light_Probe(int index)
+{
+	Vector3 pos = LightProbes->Get_Probe_Position(index);
+	const float PROBE_EXTENT = 0.1f;
+	uint32 vis_object_id = Get_Dynamic_Object_Vis_ID(AABoxClass(pos,Vector3(PROBE_EXTENT,PROBE_EXTENT,PROBE_EXTENT)));
+
+	LightEnvironmentClass env;
+	env.Reset(pos,Vector3(0,0,0));
+	Add_Static_Lights(&env,pos,vis_object_id);
+	LightProbes->Set_Probe(index,env,vis_object_id);
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Reset_Light_Probes -- Discards the light probe grid                      *
+ *=============================================================================================*/
+void PhysicsSceneClass::Reset_Light_Probes(void)
+{
+	LightProbes->Reset();
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Has_Light_Probes -- Returns true if the level has light probes           *
+ *=============================================================================================*/
+bool PhysicsSceneClass::Has_Light_Probes(void)
+{
+	return !LightProbes->Is_Empty();
+}
+
+
 /***********************************************************************************************
  * PhysicsSceneClass::Invalidate_Lighting_Caches -- invalidate lighting caches in the given bo *
  *                                                                                             *
@@ -314,6 +437,8 @@ void PhysicsSceneClass::Compute_Static_Lighting
  *=============================================================================================*/
 void PhysicsSceneClass::Invalidate_Lighting_Caches(const AABoxClass & box)
 {
+	LightProbes->Invalidate(box);
+
 	NonRefPhysListClass list;
 	Collect_Objects(box,true,true,&list);
 
@@ -47,6 +47,7 @@
 #include "light.h"
 #include "persistfactory.h"
 #include "wwmemlog.h"
+#include "lightprobegrid.h"
 
  
 /*
@@ -75,6 +76,7 @@ enum
 	PSCENE_SD_CHUNK_SUNLIGHT									= 0x00004800,
 	PSCENE_SD_CHUNK_SCENECLASS									= 0x00004810,
 	PSCENE_SD_CHUNK_VARIABLES									= 0x00004820,
+	PSCENE_SD_CHUNK_LIGHT_PROBES								= 0x00004830,
 
 	PSCENE_SD_VARIABLE_AMBIENT									= 0x00,
 
@@ -181,6 +183,11 @@ void PhysicsSceneClass::Save_Level_Static_Data(ChunkSaveClass & csave)
 	WRITE_MICRO_CHUNK(csave,PSCENE_SD_VARIABLE_AMBIENT,SceneAmbientLight);
 	csave.End_Chunk();
 
+	if (!LightProbes->Is_Empty()) {
+		csave.Begin_Chunk(PSCENE_SD_CHUNK_LIGHT_PROBES);
+		LightProbes->Save(csave);
+		csave.End_Chunk();
+	}
 }
 
 void PhysicsSceneClass::Load_Level_Static_Data(ChunkLoadClass & cload)
@@ -195,8 +202,10 @@ void PhysicsSceneClass::Load_Level_Static_Data(ChunkLoadClass & cload)
 	** - LightCullingSystem structure (not objects)
 	** - DynamicCullingSystem structure (not objects)
 	** - Visibility Tables
+	** - Light probes (older levels don't have them)
 	*/
 	VisTableManager.Reset();
+	LightProbes->Reset();
 	while (cload.Open_Chunk()) {
 		switch (cload.Cur_Chunk_ID()) {
 			case PSCENE_SD_CHUNK_SCENECLASS:
@@ -227,6 +236,10 @@ void PhysicsSceneClass::Load_Level_Static_Data(ChunkLoadClass & cload)
 				Load_Sun_Light(cload);
 				break;
 
+			case PSCENE_SD_CHUNK_LIGHT_PROBES:
+				LightProbes->Load(cload);
+				break;
+
 			case PSCENE_SD_CHUNK_VARIABLES:
 				while (cload.Open_Micro_Chunk()) {
 					switch(cload.Cur_Micro_Chunk_ID()) {
@@ -451,6 +464,7 @@ void PhysicsSceneClass::Load_Static_Objects(ChunkLoadClass & cload)
 			cload.Open_Chunk();
 			if ((cload.Cur_Chunk_ID() == PSCENE_SO_CHUNK_STATIC_OBJECT_AABLINK) && (obj)) {
 				StaticCullingSystem->Load_Object_Linkage(cload,obj);
+				StaticCullingSystem->Mark_Changed();
 			} 
 			cload.Close_Chunk();
 
@@ -51,6 +51,8 @@
  *   PhysicsSceneClass::Optimize_Visibility_Data -- combines and removes redundant vis data    *
  *   PhysicsSceneClass::Merge_Vis_Sector_IDs -- Merges two sector ID's                         *
  *   PhysicsSceneClass::Merge_Vis_Object_IDs -- combines two vis object ID's                   *
+ *   PhysicsSceneClass::Remap_Vis_Sector_IDs -- renumbers all of the vis sector ID's           *
+ *   PhysicsSceneClass::Remap_Vis_Object_IDs -- renumbers all of the vis object ID's           *
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 
@@ -209,6 +211,11 @@ int PhysicsSceneClass::Get_Vis_Table_Count(void)
 	return VisTableManager.Get_Vis_Table_Count();
 }
 
+void PhysicsSceneClass::Set_Vis_Cache_Budget(int bytes)
+{
+	VisTableManager.Set_Cache_Budget(bytes);
+}
+
 void PhysicsSceneClass::Compute_Vis_Sample_Point(const CameraClass & camera,Vector3 * set_point)
 {
 	WWASSERT(set_point != NULL);
@@ -246,6 +253,7 @@ VisTableClass * PhysicsSceneClass::Get_Vis_Table_For_Rendering(const CameraClass
 	// Also, if a sample point hasn't been given, we will skip visibility.
 	// Also, if we don't find a vis sector, we'll try to use the last valid one that we had.
 	int vis_id = -1;
+	bool sector_changed = false;
 	VisTableClass * pvs = NULL;
 	Vector3 vis_sample_point;
 	Compute_Vis_Sample_Point(camera,&vis_sample_point);
@@ -261,7 +269,8 @@ VisTableClass * PhysicsSceneClass::Get_Vis_Table_For_Rendering(const CameraClass
 			}
 		} else {
 
-			if ((LastValidVisId != vis_id) && VisSectorDisplayEnabled)  {
+			sector_changed = (LastValidVisId != vis_id);
+			if (sector_changed && VisSectorDisplayEnabled)  {
 				StaticPhysClass * tile = StaticCullingSystem->Find_Vis_Tile(vis_sample_point);
 				WWDEBUG_SAY (("Vis Sector: %s\n", tile->Peek_Model ()->Get_Name ()));
 			}
@@ -271,7 +280,19 @@ VisTableClass * PhysicsSceneClass::Get_Vis_Table_For_Rendering(const CameraClass
 		}
 		
 		if (vis_id != -1) {
+			
+			/*
+			** Keep track of what it costs to get the pvs when the camera changes sectors
+			*/
+			VisTableMgrClass::StatsStruct before = VisTableManager.Get_Statistics();
 			pvs = VisTableManager.Get_Vis_Table(LastValidVisId);
+
+			if (sector_changed) {
+				const VisTableMgrClass::StatsStruct & after = VisTableManager.Get_Statistics();
+				CurrentStats.VisSectorChanges++;
+				CurrentStats.VisSectorChangeDecompressions += after.Decompressions - before.Decompressions;
+				CurrentStats.VisSectorChangeMicroseconds += after.DecompressMicroseconds - before.DecompressMicroseconds;
+			}
 		}
 
 		if ((VisInverted) && (pvs != NULL)) {
@@ -419,6 +440,7 @@ void PhysicsSceneClass::Internal_Vis_Reset(void)
 		** a massive preprocessing step to actually generate it.
 		*/
 		StaticCullingSystem->Re_Partition();
+		StaticCullingSystem->Mark_Changed();
 		StaticLightingSystem->Re_Partition();
 
 		/*
@@ -804,10 +826,10 @@ void PhysicsSceneClass::Optimize_Visibility_Data(VisOptProgressClass & stats)
 	** Initialize the progress_status.
 	** I'm goint to count one operation per each of the following
 	** - each node in the dynamic aabtree for the "Prune_Redundant_Leaf_Nodes" process
-	** - each vis object for the "Combine_Redundant_Vis_Objects" process
-	** - each vis sector for the "Combine_Redundant_Vis_Sectors" process
+	** - two per vis object for the "Combine_Redundant_Vis_Objects" process (comparing and merging)
+	** - two per vis sector for the "Combine_Redundant_Vis_Sectors" process
 	*/
-	stats.Reset(DynamicObjVisSystem->Partition_Node_Count() + Get_Vis_Table_Size() + Get_Vis_Table_Count());
+	stats.Reset(DynamicObjVisSystem->Partition_Node_Count() + 2*Get_Vis_Table_Size() + 2*Get_Vis_Table_Count());
 	stats.Set_Initial_Bit_Count(VisTableManager.Get_Vis_Table_Size() * VisTableManager.Get_Vis_Table_Count());
 	stats.Set_Initial_Sector_Count(Get_Vis_Table_Count());
 	stats.Set_Initial_Object_Count(Get_Vis_Table_Size());
@@ -885,3 +907,49 @@ void PhysicsSceneClass::Merge_Vis_Object_IDs(uint32 id0,uint32 id1)
 	StaticCullingSystem->Merge_Vis_Object_IDs(id0,id1);
 	DynamicObjVisSystem->Merge_Vis_Object_IDs(id0,id1);
 }
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Remap_Vis_Sector_IDs -- renumbers all of the vis sector ID's             *
+ *                                                                                             *
+ *    Every vis sector ID is replaced with id_map[ID].  This is used by the vis optimization   *
+ *    process to apply all of the sector merges at once.                                       *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * id_map - new ID for each current ID                                                         *
+ * id_count - number of entries in id_map                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Remap_Vis_Sector_IDs(const uint32 * id_map,uint32 id_count)
+{
+	StaticCullingSystem->Remap_Vis_Sector_IDs(id_map,id_count);
+	StaticLightingSystem->Remap_Vis_Sector_IDs(id_map,id_count);
+}
+
+
+/***********************************************************************************************
+ * PhysicsSceneClass::Remap_Vis_Object_IDs -- renumbers all of the vis object ID's             *
+ *                                                                                             *
+ *    Every vis object ID is replaced with id_map[ID].  This is used by the vis optimization   *
+ *    process to apply all of the object merges at once.                                       *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * id_map - new ID for each current ID                                                         *
+ * id_count - number of entries in id_map                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void PhysicsSceneClass::Remap_Vis_Object_IDs(const uint32 * id_map,uint32 id_count)
+{
+	StaticCullingSystem->Remap_Vis_Object_IDs(id_map,id_count);
+	DynamicObjVisSystem->Remap_Vis_Object_IDs(id_map,id_count);
+}
@@ -0,0 +1,418 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : WWPhys                                                       *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/wwphys/rendersnapshot.cpp                    $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ *   RenderSnapshotClass::Install_Static_Render_Lists -- use the lists built by the worker    *
+ *   RenderSnapshotClass::Begin_Static_Render_Lists -- capture a frame and start the worker   *
+ *   RenderSnapshotClass::Can_Use_Frame -- is a captured frame conservative for a camera      *
+ *   RenderSnapshotClass::Build_Frame -- collect the candidate objects for a frame            *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#include "rendersnapshot.h"
+#include "staticaabtreecull.h"
+#include "staticphys.h"
+#include "physlist.h"
+#include "vistable.h"
+#include "camera.h"
+#include "colmath.h"
+#include "colmathfrustum.h"
+#include "wwmath.h"
+#include "wwdebug.h"
+
+
+const float DEFAULT_PADDING = 1.0f;
+const float DEFAULT_VIEW_SCALE = 1.15f;
+const float MAX_ROTATION = 0.25f;						// radians, keeps the widened near plane valid
+
+
+/***************************************************************************************************
+**
+** RenderSnapshotClass Implementation
+**
+***************************************************************************************************/
+
+RenderSnapshotClass::FrameStruct::FrameStruct(void) :
+	IsValid(false),
+	PVS(NULL),
+	VisSectorID(-1),
+	HierarchicalVis(false),
+	StaticVersion(0),
+	VisVersion(0),
+	CameraTransform(1),
+	ZNear(0.0f),
+	ZFar(0.0f),
+	MinRotationCos(1.0f)
+{
+}
+
+RenderSnapshotClass::RenderSnapshotClass(void) :
+	Padding(DEFAULT_PADDING),
+	ViewScale(DEFAULT_VIEW_SCALE),
+	RecordsVersion(0),
+	RecordsVisVersion(0),
+	RecordsValid(false),
+	BuildFrame(-1)
+{
+}
+
+RenderSnapshotClass::~RenderSnapshotClass(void)
+{
+	Reset();
+}
+
+void RenderSnapshotClass::Reset(void)
+{
+	Wait_For_Build();
+	BuildFrame = -1;
+	Release_Frame(Frames[0]);
+	Release_Frame(Frames[1]);
+	Records.Delete_All();
+	RecordsValid = false;
+}
+
+
+/***********************************************************************************************
+ * RenderSnapshotClass::Install_Static_Render_Lists -- use the lists built by the worker      *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * camera - camera being rendered                                                              *
+ * pvs - pvs for the camera (from Get_Vis_Table_For_Rendering)                                 *
+ * static_version - current version of the static objects                                      *
+ * vis_version - current version of the vis tables and vis ids                                 *
+ * static_list, ws_mesh_list - lists to add the visible static objects to                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * false if the last snapshot isn't good enough for this camera; nothing is added then         *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool RenderSnapshotClass::Install_Static_Render_Lists
+(
+	CameraClass & camera,
+	VisTableClass * pvs,
+	unsigned static_version,
+	unsigned vis_version,
+	RefPhysListClass & static_list,
+	RefPhysListClass & ws_mesh_list
+)
+{
+	if (BuildFrame == -1) {
+		return false;
+	}
+
+	Wait_For_Build();
+	FrameStruct & frame = Frames[BuildFrame];
+	if (!Can_Use_Frame(frame,camera,pvs,static_version,vis_version)) {
+		return false;
+	}
+
+	/*
+	** The candidates passed the pvs and a frustum that contains this camera's frustum.  
+	** Finish the job with the real frustum.  An object's box is inside its node's box so 
+	** this gives the same objects as walking the tree would.
+	*/
+	const FrustumClass & frustum = camera.Get_Frustum();
+	for (int i=0; i<frame.Candidates.Count(); i++) {
+		const RecordStruct & record = Records[frame.Candidates[i]];
+		if (CollisionMath::Overlap_Test(frustum,record.Object->Get_Cull_Box()) != CollisionMath::OUTSIDE) {
+			if (record.IsWSMesh) {
+				ws_mesh_list.Add(record.Object);
+			} else {
+				static_list.Add(record.Object);
+			}
+		}
+	}
+	return true;
+}
+
+
+/***********************************************************************************************
+ * RenderSnapshotClass::Begin_Static_Render_Lists -- capture a frame and start the worker     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ * camera - camera being rendered this frame                                                   *
+ * pvs - pvs for the camera, nothing is captured if this is NULL                               *
+ * hierarchical_vis - whether the static culling system uses the hierarchical vis              *
+ * static_version - current version of the static objects                                      *
+ * vis_version - current version of the vis tables and vis ids                                 *
+ * static_culling - static culling system, captured when either version changes                *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ * Main thread only                                                                            *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void RenderSnapshotClass::Begin_Static_Render_Lists
+(
+	CameraClass & camera,
+	VisTableClass * pvs,
+	bool hierarchical_vis,
+	unsigned static_version,
+	unsigned vis_version,
+	StaticAABTreeCullClass * static_culling
+)
+{
+	/*
+	** Capture into the frame that isn't holding last frame's lists
+	*/
+	Wait_For_Build();
+	int index = (BuildFrame == 0) ? 1 : 0;
+	BuildFrame = -1;
+
+	FrameStruct & frame = Frames[index];
+	Release_Frame(frame);
+
+	if ((pvs == NULL) || (static_culling == NULL)) {
+		return;
+	}
+
+	/*
+	** The view plane has to straddle the view axis for the widening below
+	*/
+	camera.Get_View_Plane(frame.ViewportMin,frame.ViewportMax);
+	camera.Get_Clip_Planes(frame.ZNear,frame.ZFar);
+	if (	(frame.ViewportMin.X >= 0.0f) || (frame.ViewportMax.X <= 0.0f) ||
+			(frame.ViewportMin.Y >= 0.0f) || (frame.ViewportMax.Y <= 0.0f) ) 
+	{
+		return;
+	}
+
+	if (!RecordsValid || (RecordsVersion != static_version) || (RecordsVisVersion != vis_version)) {
+		Records.Delete_All(false);
+		static_culling->Capture_Render_Snapshot(*this);
+		RecordsVersion = static_version;
+		RecordsVisVersion = vis_version;
+		RecordsValid = true;
+	}
+
+	/*
+	** Widen the view plane.  Turning the camera by an angle moves each edge of the frustum 
+	** by at most that angle, but near the corners a small turn changes the edge angle more,
+	** by up to 1/cos of the angle to the other pair of edges, so the allowed turn is scaled
+	** down by that.  The near plane is pulled in and the far plane pushed out so the turned
+	** frustum still fits between them.
+	*/
+	float tan_x = MAX(-frame.ViewportMin.X,frame.ViewportMax.X) * ViewScale;
+	float tan_y = MAX(-frame.ViewportMin.Y,frame.ViewportMax.Y) * ViewScale;
+
+	float margin_x = MIN(	WWMath::Atan(-frame.ViewportMin.X * ViewScale) - WWMath::Atan(-frame.ViewportMin.X),
+									WWMath::Atan(frame.ViewportMax.X * ViewScale) - WWMath::Atan(frame.ViewportMax.X)	);
+	float margin_y = MIN(	WWMath::Atan(-frame.ViewportMin.Y * ViewScale) - WWMath::Atan(-frame.ViewportMin.Y),
+									WWMath::Atan(frame.ViewportMax.Y * ViewScale) - WWMath::Atan(frame.ViewportMax.Y)	);
+	float margin = MIN(	margin_x / WWMath::Sqrt(1.0f + tan_y * tan_y),
+								margin_y / WWMath::Sqrt(1.0f + tan_x * tan_x) );
+	margin = WWMath::Clamp(margin,0.0f,MAX_ROTATION);
+
+	frame.CameraTransform = camera.Get_Transform();
+	frame.MinRotationCos = WWMath::Cos(margin);
+	frame.Frustum.Init(	frame.CameraTransform,
+								frame.ViewportMin * ViewScale,
+								frame.ViewportMax * ViewScale,
+								frame.ZNear * 0.5f,
+								frame.ZFar * WWMath::Sqrt(1.0f + tan_x * tan_x + tan_y * tan_y) );
+
+	REF_PTR_SET(frame.PVS,pvs);
+	frame.VisSectorID = pvs->Get_Vis_Sector_ID();
+	frame.HierarchicalVis = hierarchical_vis;
+	frame.StaticVersion = static_version;
+	frame.VisVersion = vis_version;
+	frame.IsValid = true;
+
+	BuildFrame = index;
+	WorkerPoolClass::Submit(Build_Frame_Job,this,index,BuildGroup);
+}
+
+
+/***********************************************************************************************
+ * RenderSnapshotClass::Can_Use_Frame -- is a captured frame conservative for a camera        *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ * true if every object that this camera can see was a candidate in the frame                  *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+bool RenderSnapshotClass::Can_Use_Frame
+(
+	FrameStruct & frame,
+	CameraClass & camera,
+	VisTableClass * pvs,
+	unsigned static_version,
+	unsigned vis_version
+)
+{
+	if (!frame.IsValid || (pvs == NULL)) {
+		return false;
+	}
+	if ((frame.StaticVersion != static_version) || !RecordsValid || (RecordsVersion != static_version)) {
+		return false;
+	}
+	if ((frame.VisVersion != vis_version) || (RecordsVisVersion != vis_version)) {
+		return false;
+	}
+
+	/*
+	** The candidates were culled against the frame's pvs.  A different table for the same
+	** sector (re-decompressed, or rebuilt by the vis system) doesn't have to match it.
+	*/
+	if ((pvs != frame.PVS) || (pvs->Get_Vis_Sector_ID() != frame.VisSectorID)) {
+		return false;
+	}
+
+	Vector2 viewport_min,viewport_max;
+	float znear,zfar;
+	camera.Get_View_Plane(viewport_min,viewport_max);
+	camera.Get_Clip_Planes(znear,zfar);
+	if (	(viewport_min.X != frame.ViewportMin.X) || (viewport_min.Y != frame.ViewportMin.Y) ||
+			(viewport_max.X != frame.ViewportMax.X) || (viewport_max.Y != frame.ViewportMax.Y) ||
+			(znear != frame.ZNear) || (zfar != frame.ZFar) )
+	{
+		return false;
+	}
+
+	/*
+	** Moving the camera is covered by the padding on the boxes, turning it by the widening
+	** of the frustum.  The cosine of the angle turned comes from the trace of the rotation 
+	** between the two transforms.
+	*/
+	const Matrix3D & tm = camera.Get_Transform();
+	if ((tm.Get_Translation() - frame.CameraTransform.Get_Translation()).Length() > Padding) {
+		return false;
+	}
+
+	float trace =	Vector3::Dot_Product(tm.Get_X_Vector(),frame.CameraTransform.Get_X_Vector()) +
+						Vector3::Dot_Product(tm.Get_Y_Vector(),frame.CameraTransform.Get_Y_Vector()) +
+						Vector3::Dot_Product(tm.Get_Z_Vector(),frame.CameraTransform.Get_Z_Vector());
+	if ((trace - 1.0f) * 0.5f < frame.MinRotationCos) {
+		return false;
+	}
+	return true;
+}
+
+
+/***********************************************************************************************
+ * RenderSnapshotClass::Build_Frame -- collect the candidate objects for a frame              *
+ *                                                                                             *
+ *    This is StaticAABTreeCullClass::Collect_Visible_Objects_Recursive run over the records.  *
+ *    It only reads the records and the frame so it can run on any thread.                     *
+ *                                                                                             *
+ * INPUT:                                                                                      *
+ *                                                                                             *
+ * OUTPUT:                                                                                     *
+ *                                                                                             *
+ * WARNINGS:                                                                                   *
+ *                                                                                             *
+ * HISTORY:                                                                                    *
+ *=============================================================================================*/
+void RenderSnapshotClass::Build_Frame(FrameStruct & frame)
+{
+	frame.Candidates.Delete_All(false);
+
+	int count = Records.Count();
+	int i = 0;
+	while (i < count) {
+
+		const RecordStruct & record = Records[i];
+		if (record.Object == NULL) {
+
+			/*
+			** Skip the whole node if it is culled
+			*/
+			if (	(frame.HierarchicalVis && (frame.PVS->Get_Bit(record.VisID) == 0)) ||
+					(CollisionMath::Overlap_Test(frame.Frustum,record.Box) == CollisionMath::OUTSIDE) )
+			{
+				i += record.SkipCount + 1;
+				continue;
+			}
+
+		} else if (	(frame.PVS->Get_Bit(record.VisID) != 0) &&
+						(CollisionMath::Overlap_Test(frame.Frustum,record.Box) != CollisionMath::OUTSIDE) )
+		{
+			frame.Candidates.Add(i);
+		}
+		i++;
+	}
+}
+
+void RenderSnapshotClass::Build_Frame_Job(void * data,int index)
+{
+	RenderSnapshotClass * snapshot = (RenderSnapshotClass *)data;
+	snapshot->Build_Frame(snapshot->Frames[index]);
+}
+
+void RenderSnapshotClass::Wait_For_Build(void)
+{
+	BuildGroup.Wait();
+}
+
+void RenderSnapshotClass::Release_Frame(FrameStruct & frame)
+{
+	REF_PTR_RELEASE(frame.PVS);
+	frame.Candidates.Delete_All(false);
+	frame.IsValid = false;
+}
+
+
+/*
+** Capture interface.  Boxes are padded as they are captured.
+*/
+int RenderSnapshotClass::Begin_Node(const AABoxClass & box,uint32 vis_id)
+{
+	RecordStruct record;
+	record.Box = box;
+	record.Box.Extent += Vector3(Padding,Padding,Padding);
+	record.VisID = vis_id;
+	record.SkipCount = 0;
+	record.Object = NULL;
+	record.IsWSMesh = false;
+	Records.Add(record);
+	return Records.Count() - 1;
+}
+
+void RenderSnapshotClass::End_Node(int record_index)
+{
+	Records[record_index].SkipCount = Records.Count() - record_index - 1;
+}
+
+void RenderSnapshotClass::Add_Object(StaticPhysClass * obj)
+{
+	RecordStruct record;
+	record.Box = obj->Get_Cull_Box();
+	record.Box.Extent += Vector3(Padding,Padding,Padding);
+	record.VisID = obj->Get_Vis_Object_ID();
+	record.SkipCount = 0;
+	record.Object = obj;
+	record.IsWSMesh = obj->Is_World_Space_Mesh();
+	Records.Add(record);
+}
@@ -0,0 +1,181 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : WWPhys                                                       *
+ *                                                                                             *
+ *                     $Archive:: /Commando/Code/wwphys/rendersnapshot.h                      $*
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef RENDERSNAPSHOT_H
+#define RENDERSNAPSHOT_H
+
+#include "always.h"
+#include "aabox.h"
+#include "frustum.h"
+#include "matrix3d.h"
+#include "vector2.h"
+#include "simplevec.h"
+#include "workerpool.h"
+#include "bittype.h"
+
+class CameraClass;
+class VisTableClass;
+class StaticPhysClass;
+class StaticAABTreeCullClass;
+class RefPhysListClass;
+
+
+/**
+** RenderSnapshotClass
+** Lets the static object render lists be built on a worker thread while the main thread goes
+** on to the next frame's game think and physics.
+**
+** The static culling tree is copied into a flat array of node and object records (only when
+** static objects have been added, removed or moved) and each frame the camera and pvs are
+** captured into one of two frame buffers.  A worker walks the records for that frame exactly
+** like StaticAABTreeCullClass::Collect_Visible_Objects does, but against a frustum widened a
+** little and boxes padded a little, and never touches the scene.  The next frame the main
+** thread takes the candidates, if the camera hasn't moved further than the widening covers
+** and the camera still has the same pvs (the same table, and no vis table or vis id has
+** changed since), and tests them against the real frustum.
+** That gives the same objects the culling tree would have, for a fraction of the main
+** thread time.  Otherwise the caller collects the objects the normal way.
+**
+** Static objects are assumed to stay where they were captured between the capture and
+** the next frame; they never move in game.
+*/
+class RenderSnapshotClass
+{
+public:
+
+	RenderSnapshotClass(void);
+	~RenderSnapshotClass(void);
+
+	/*
+	** Waits for the worker and releases everything
+	*/
+	void					Reset(void);
+
+	/*
+	** Padding is the distance the camera may move between frames (boxes are grown by it).
+	** View scale widens the captured view plane, which sets how far the camera may turn.
+	*/
+	void					Set_Padding(float padding)									{ Padding = padding; RecordsValid = false; }
+	float					Get_Padding(void) const										{ return Padding; }
+	void					Set_View_Scale(float scale)								{ ViewScale = scale; }
+	float					Get_View_Scale(void) const									{ return ViewScale; }
+
+	/*
+	** Install the lists built from last frame's snapshot, returns false if they can't be
+	** used for this camera.  static_version must change whenever static objects are added,
+	** removed or moved, vis_version whenever a vis table or the vis ids change.
+	*/
+	bool					Install_Static_Render_Lists(	CameraClass & camera,
+																	VisTableClass * pvs,
+																	unsigned static_version,
+																	unsigned vis_version,
+																	RefPhysListClass & static_list,
+																	RefPhysListClass & ws_mesh_list );
+
+	/*
+	** Capture this frame's camera and pvs and start building the lists for the next frame
+	*/
+	void					Begin_Static_Render_Lists(	CameraClass & camera,
+																VisTableClass * pvs,
+																bool hierarchical_vis,
+																unsigned static_version,
+																unsigned vis_version,
+																StaticAABTreeCullClass * static_culling );
+
+	/*
+	** Capture interface used by StaticAABTreeCullClass::Capture_Render_Snapshot
+	*/
+	int					Begin_Node(const AABoxClass & box,uint32 vis_id);
+	void					End_Node(int record_index);
+	void					Add_Object(StaticPhysClass * obj);
+
+protected:
+
+	/*
+	** Records are in the order Collect_Visible_Objects visits the tree.  A node record is
+	** followed by the records for its objects and then its children; SkipCount is the number
+	** of records after the node that belong to it.
+	*/
+	struct RecordStruct
+	{
+		AABoxClass				Box;					// padded
+		uint32					VisID;
+		int						SkipCount;
+		StaticPhysClass *		Object;				// NULL for nodes, not referenced (see static_version)
+		bool						IsWSMesh;
+	};
+
+	struct FrameStruct
+	{
+		FrameStruct(void);
+
+		bool						IsValid;
+		VisTableClass *		PVS;
+		int						VisSectorID;
+		bool						HierarchicalVis;
+		unsigned					StaticVersion;
+		unsigned					VisVersion;
+		Matrix3D					CameraTransform;
+		Vector2					ViewportMin;
+		Vector2					ViewportMax;
+		float						ZNear;
+		float						ZFar;
+		float						MinRotationCos;		// the camera may turn this far and stay inside Frustum
+		FrustumClass			Frustum;					// widened
+		SimpleDynVecClass<int>	Candidates;			// record indices
+	};
+
+	void					Wait_For_Build(void);
+	void					Release_Frame(FrameStruct & frame);
+	bool					Can_Use_Frame(FrameStruct & frame,CameraClass & camera,VisTableClass * pvs,unsigned static_version,unsigned vis_version);
+	void					Build_Frame(FrameStruct & frame);
+	static void			Build_Frame_Job(void * data,int index);
+
+	float										Padding;
+	float										ViewScale;
+
+	SimpleDynVecClass<RecordStruct>	Records;
+	unsigned									RecordsVersion;
+	unsigned									RecordsVisVersion;
+	bool										RecordsValid;
+
+	FrameStruct								Frames[2];
+	int										BuildFrame;				// frame the worker is building, -1 for none
+	JobGroupClass							BuildGroup;
+
+private:
+
+	// not implemented
+	RenderSnapshotClass(const RenderSnapshotClass &);
+	RenderSnapshotClass & operator = (const RenderSnapshotClass &);
+};
+
+
+#endif //RENDERSNAPSHOT_H
@@ -49,6 +49,7 @@
 #include "visrasterizer.h"
 #include "chunkio.h"
 #include "visrendercontext.h"
+#include "rendersnapshot.h"
 #include "colmathfrustum.h"
 #include "colmathplane.h"
 #include "colmathaabox.h"
@@ -96,7 +97,8 @@ inline StaticPhysClass * get_next_object(StaticPhysClass * tile)
 ** Implementation of StaticAABTreeCullClass
 */
 StaticAABTreeCullClass::StaticAABTreeCullClass(PhysicsSceneClass * pscene) :
-	PhysAABTreeCullClass(pscene)
+	PhysAABTreeCullClass(pscene),
+	ChangeCount(0)
 {
 }
 
@@ -109,6 +111,7 @@ void StaticAABTreeCullClass::Add_Object(PhysClass * obj, int cull_node_id /*= -1
 	WWASSERT(Scene != NULL);
 	WWASSERT(obj->As_StaticPhysClass() != NULL);
 	PhysAABTreeCullClass::Add_Object(obj, cull_node_id);
+	ChangeCount++;
 // (gth) not resetting vis when adding a static object
 //	Scene->Reset_Vis();
 }
@@ -118,6 +121,7 @@ void StaticAABTreeCullClass::Remove_Object(PhysClass * obj)
 	WWASSERT(Scene != NULL);
 	WWASSERT(obj->As_StaticPhysClass() != NULL);
 	PhysAABTreeCullClass::Remove_Object(obj);
+	ChangeCount++;
 // (gth) not resetting vis when removing a static object
 //	Scene->Reset_Vis();
 }
@@ -126,6 +130,7 @@ void StaticAABTreeCullClass::Update_Culling(CullableClass * obj)
 {
 	WWASSERT(Scene != NULL);
 	PhysAABTreeCullClass::Update_Culling(obj);
+	ChangeCount++;
 // (gth) not resetting vis when moving a static object
 //	Scene->Reset_Vis();
 }
@@ -303,8 +308,47 @@ void StaticAABTreeCullClass::Collect_Visible_Objects_No_HVis_Recursive
 }
 
 
+void StaticAABTreeCullClass::Capture_Render_Snapshot(RenderSnapshotClass & snapshot)
+{
+	if (RootNode != NULL) {
+		Capture_Render_Snapshot_Recursive(RootNode,snapshot);
+	}
+}
+
+void StaticAABTreeCullClass::Capture_Render_Snapshot_Recursive
+(
+	AABTreeNodeClass *				node,
+	RenderSnapshotClass &			snapshot
+)
+{
+	/*
+	** Same order as Collect_Visible_Objects_Recursive: the node, its objects, back, front
+	*/
+	int record = snapshot.Begin_Node(node->Box,node->UserData);
+
+	if (node->Object) {
+		StaticPhysClass * obj = get_first_object(node);
+		while (obj) {
+			snapshot.Add_Object(obj);
+			obj = get_next_object(obj);
+		}
+	}
+
+	if (node->Back) {
+		Capture_Render_Snapshot_Recursive(node->Back,snapshot);
+	}
+	if (node->Front) {
+		Capture_Render_Snapshot_Recursive(node->Front,snapshot);
+	}
+
+	snapshot.End_Node(record);
+}
+
+
 void StaticAABTreeCullClass::Assign_Vis_IDs(void)
 {
+	ChangeCount++;
+
 	/*
 	** Allocate sector and object ID's for the objects in the leaf nodes.
 	*/
@@ -606,6 +650,8 @@ bool StaticAABTreeCullClass::Is_Child_Visible
 
 void StaticAABTreeCullClass::Merge_Vis_Object_IDs(uint32 id0,uint32 id1)
 {
+	ChangeCount++;
+
 	/*
 	** Each node and each staticphys object has a vis object id.  
 	** Whenever we encounter one of these with id1, set it to id0.
@@ -639,6 +685,8 @@ void StaticAABTreeCullClass::Merge_Vis_Object_IDs(uint32 id0,uint32 id1)
 
 void StaticAABTreeCullClass::Merge_Vis_Sector_IDs(uint32 id0,uint32 id1)
 {
+	ChangeCount++;
+
 	/*
 	** Each staticphys object may have a vis sector id.
 	** Whenever we encounter one of these with id1, set it to id0.
@@ -666,10 +714,56 @@ void StaticAABTreeCullClass::Merge_Vis_Sector_IDs(uint32 id0,uint32 id1)
 	}
 }
 
+void StaticAABTreeCullClass::Remap_Vis_Object_IDs(const uint32 * id_map,uint32 id_count)
+{
+	ChangeCount++;
+
+	/*
+	** Replace each node and staticphys object id with id_map[id].  Ids outside of the map
+	** (unassigned) are left alone.
+	*/
+	for (int i=0; i<NodeCount; i++) {
+
+		AABTreeNodeClass * node = IndexedNodes[i];
+		if (node->UserData < id_count) {
+			node->UserData = id_map[node->UserData];
+		}
+
+		StaticPhysClass * obj = get_first_object(node);
+		while (obj) {
+			uint32 obj_id = obj->Get_Vis_Object_ID();
+			if (obj_id < id_count) {
+				obj->Set_Vis_Object_ID(id_map[obj_id]);
+			}
+			obj = get_next_object(obj);
+		}
+	}
+}
+
+void StaticAABTreeCullClass::Remap_Vis_Sector_IDs(const uint32 * id_map,uint32 id_count)
+{
+	ChangeCount++;
+
+	for (int i=0; i<NodeCount; i++) {
+
+		AABTreeNodeClass * node = IndexedNodes[i];
+
+		StaticPhysClass * obj = get_first_object(node);
+		while (obj) {
+			uint32 sector_id = obj->Get_Vis_Sector_ID();
+			if (sector_id < id_count) {
+				obj->Set_Vis_Sector_ID(id_map[sector_id]);
+			}
+			obj = get_next_object(obj);
+		}
+	}
+}
+
 
 void StaticAABTreeCullClass::Load_Static_Data(ChunkLoadClass & cload)
 {
 	WWMEMLOG(MEM_CULLINGDATA);
+	ChangeCount++;
 	while(cload.Open_Chunk()) 
 	{
 		switch(cload.Cur_Chunk_ID()) 
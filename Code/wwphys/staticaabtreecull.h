@@ -56,6 +56,7 @@ class VisRenderContextClass;
 class VisSampleClass;
 class ChunkLoadClass;
 class ChunkSaveClass;
+class RenderSnapshotClass;
 
 
 /*
@@ -91,6 +92,15 @@ public:
 																	RefPhysListClass & visobjlist,
 																	RefPhysListClass & wsmeshlist		);
 
+	/*
+	** Copy the tree into a RenderSnapshotClass so the visible objects can be collected on
+	** another thread.  The change count goes up whenever anything that copy depends on
+	** changes (objects added, removed or moved, vis ids reassigned, the tree rebuilt).
+	*/
+	void					Capture_Render_Snapshot(RenderSnapshotClass & snapshot);
+	unsigned				Get_Change_Count(void) const										{ return ChangeCount; }
+	void					Mark_Changed(void)													{ ChangeCount++; }
+
 	/*
 	** Save/Load system.
 	*/
@@ -134,6 +144,7 @@ protected:
 	*/
 	void					Collect_Visible_Objects_Recursive(AABTreeNodeClass * node,VisObjCollectContextClass & context);
 	void					Collect_Visible_Objects_No_HVis_Recursive(AABTreeNodeClass * node,VisObjCollectContextClass & context); 
+	void					Capture_Render_Snapshot_Recursive(AABTreeNodeClass * node,RenderSnapshotClass & snapshot);
 
 	int					Get_Vis_Sector_ID(const Vector3 & sample_point);
 	StaticPhysClass *	Find_Vis_Tile(const Vector3 & sample_point);
@@ -158,12 +169,16 @@ protected:
 	*/
 	void					Merge_Vis_Object_IDs(uint32 id0,uint32 id1);
 	void					Merge_Vis_Sector_IDs(uint32 id0,uint32 id1);
+	void					Remap_Vis_Object_IDs(const uint32 * id_map,uint32 id_count);
+	void					Remap_Vis_Sector_IDs(const uint32 * id_map,uint32 id_count);
 
 	/*
 	** Making Physics Scene a friend so that some of the more ugly vis-system interfaces
 	** can be accessed by it without exposing them to everyone else...
 	*/
 	friend class PhysicsSceneClass;
+
+	unsigned				ChangeCount;
 };
 
 #endif //STATICAABTREECULL_H
\ No newline at end of file
@@ -42,13 +42,412 @@
 #include "vistablemgr.h"
 #include "vistable.h"
 #include "dynamicaabtreecull.h"
+#include "workerpool.h"
 #include "wwdebug.h"
+#include <stdlib.h>
 
 
 const float MIN_OBJECT_MATCH_FRACTION = 0.99f;
 const float MIN_SECTOR_MATCH_FRACTION = 0.99f;
 const float MIN_PRUNE_MATCH_FRACTION = 0.90f;		
 
+const int VIS_OPT_BLOCK_SIZE = 64;						// tables per job for the worker threads
+
+
+/***************************************************************************************************
+**
+** Table transposing.  Bit i of table j in Dest is set to bit j of table i in Src.  Each job fills 
+** in a block of the Dest tables so no two jobs write to the same table.
+**
+***************************************************************************************************/
+
+struct TransposeJobStruct
+{
+	VisTableClass **	Src;
+	int					SrcCount;
+	VisTableClass **	Dest;
+	int					DestCount;
+};
+
+static void Transpose_Job(void * data,int index)
+{
+	TransposeJobStruct * job = (TransposeJobStruct *)data;
+	int first = index * VIS_OPT_BLOCK_SIZE;
+	int last = MIN(first + VIS_OPT_BLOCK_SIZE,job->DestCount);
+
+	for (int j=first; j<last; j++) {
+		VisTableClass * dest = job->Dest[j];
+		for (int i=0; i<job->SrcCount; i++) {
+			dest->Set_Bit(i,job->Src[i]->Get_Bit(j) != 0);
+		}
+	}
+}
+
+
+/***************************************************************************************************
+**
+** VisTableClustererClass
+** Repeatedly merges the two most similar tables in an array until no pair of tables matches
+** better than the minimum match fraction.  This replaces the old approach of merging each table
+** with every later table that matched the original version of it, which was order dependent
+** and renumbered the whole scene after every merge.
+**
+** - Exact duplicates are merged first, found by sorting the tables on their bit count and CRC.
+** - The best partner of every remaining table is then found in parallel blocks of rows of the
+**   match matrix and put into a priority queue.
+** - The best pair is popped and merged.  After a merge only the merged table needs a new best
+**   partner (again found in parallel).  Queue entries whose partner has changed since they
+**   were computed are recomputed when they come out of the queue.
+**
+** Match_Fraction is the number of bits set in both tables over the number set in either, so two
+** tables can never match better than the ratio of their bit counts.  Pairs whose counts are too
+** far apart are skipped without comparing the tables.
+**
+** Tables are always merged into the lower id.  Find_Root gives the table a table ended up in.
+**
+***************************************************************************************************/
+
+class VisTableClustererClass
+{
+public:
+
+	VisTableClustererClass(VisTableClass ** tables,int count,float min_match,VisOptProgressClass & progress);
+
+	int							Cluster(void);
+	int							Find_Root(int id);
+
+protected:
+
+	struct CandidateStruct
+	{
+		float						Match;
+		int						Id;
+		int						Partner;
+		int						Version;				// versions of the two tables when the match was computed
+		int						PartnerVersion;
+	};
+
+	struct DuplicateStruct
+	{
+		int						BitCount;
+		uint32					CRC;
+		int						Id;
+	};
+
+	bool							Is_Live(int id) const								{ return Versions[id] >= 0; }
+	bool							Could_Match(int id0,int id1) const;
+	void							Find_Best_Partner(int id,int first,int last,CandidateStruct * best);
+	void							Find_Best_Partner(int id,CandidateStruct * best);
+	void							Merge(int id0,int id1);
+	void							Merge_Duplicates(void);
+
+	static bool					Is_Better(const CandidateStruct & a,const CandidateStruct & b);
+	void							Push(const CandidateStruct & candidate);
+	void							Pop(CandidateStruct * candidate);
+
+	static int					Duplicate_Compare(const void * a,const void * b);
+	static void					Rows_Job(void * data,int index);
+	static void					Partner_Job(void * data,int index);
+
+	VisTableClass **						Tables;
+	int										Count;
+	int										BlockCount;
+	float										MinMatch;
+	VisOptProgressClass &				Progress;
+
+	SimpleVecClass<int>					BitCounts;
+	SimpleVecClass<int>					Versions;			// bumped on each merge, -1 once merged away
+	SimpleVecClass<int>					Parents;
+	SimpleVecClass<CandidateStruct>	Best;					// per row results of the parallel searches
+	SimpleDynVecClass<CandidateStruct>	Queue;				// binary max-heap of candidate pairs
+	int										PartnerId;			// table whose best partner is being searched for
+	int										MergeCount;
+};
+
+
+VisTableClustererClass::VisTableClustererClass
+(
+	VisTableClass ** tables,
+	int count,
+	float min_match,
+	VisOptProgressClass & progress
+) :
+	Tables(tables),
+	Count(count),
+	BlockCount((count + VIS_OPT_BLOCK_SIZE - 1) / VIS_OPT_BLOCK_SIZE),
+	MinMatch(min_match),
+	Progress(progress),
+	BitCounts(count),
+	Versions(count),
+	Parents(count),
+	Best(MAX(count,BlockCount)),
+	Queue(count),
+	PartnerId(-1),
+	MergeCount(0)
+{
+	for (int i=0; i<count; i++) {
+		BitCounts[i] = Tables[i]->Count_True_Bits();
+		Versions[i] = 0;
+		Parents[i] = i;
+	}
+}
+
+int VisTableClustererClass::Cluster(void)
+{
+	int i;
+	Merge_Duplicates();
+
+	/*
+	** Find the best partner for every table, a block of rows at a time on the worker threads,
+	** and queue them up in order.
+	*/
+	WorkerPoolClass::Parallel_For(Rows_Job,this,BlockCount);
+	for (i=0; i<Count; i++) {
+		if (Best[i].Partner != -1) {
+			Push(Best[i]);
+		}
+	}
+
+	/*
+	** Merge the best pair until there are none left that match well enough
+	*/
+	while (Queue.Count() > 0) {
+		CandidateStruct candidate;
+		Pop(&candidate);
+
+		if (Versions[candidate.Id] != candidate.Version) {
+			continue;		// merged away, or merged into and re-queued at the time
+		}
+		if (Versions[candidate.Partner] != candidate.PartnerVersion) {
+			Find_Best_Partner(candidate.Id,&candidate);
+			if (candidate.Partner != -1) {
+				Push(candidate);
+			}
+			continue;
+		}
+		Merge(candidate.Id,candidate.Partner);
+	}
+	return MergeCount;
+}
+
+int VisTableClustererClass::Find_Root(int id)
+{
+	int root = id;
+	while (Parents[root] != root) {
+		root = Parents[root];
+	}
+	while (Parents[id] != root) {
+		int next = Parents[id];
+		Parents[id] = root;
+		id = next;
+	}
+	return root;
+}
+
+bool VisTableClustererClass::Could_Match(int id0,int id1) const
+{
+	/*
+	** Allow a bit of slack so rounding in Match_Fraction can't make this reject a pair that
+	** would have matched.
+	*/
+	int lo = MIN(BitCounts[id0],BitCounts[id1]);
+	int hi = MAX(BitCounts[id0],BitCounts[id1]);
+	return (float)(lo + 1) >= MinMatch * (float)hi;
+}
+
+void VisTableClustererClass::Find_Best_Partner(int id,int first,int last,CandidateStruct * best)
+{
+	best->Match = MinMatch;
+	best->Id = id;
+	best->Partner = -1;
+	best->Version = Versions[id];
+	best->PartnerVersion = -1;
+
+	for (int j=first; j<last; j++) {
+		if ((j == id) || !Is_Live(j) || !Could_Match(id,j)) {
+			continue;
+		}
+		float match = Tables[id]->Match_Fraction(*(Tables[j]));
+		if (match > best->Match) {
+			best->Match = match;
+			best->Partner = j;
+			best->PartnerVersion = Versions[j];
+		}
+	}
+}
+
+void VisTableClustererClass::Find_Best_Partner(int id,CandidateStruct * best)
+{
+	/*
+	** Search a block of the other tables per job and keep the best of the blocks, the 
+	** earliest one on a tie so the result is the same as searching them in order.
+	*/
+	PartnerId = id;
+	WorkerPoolClass::Parallel_For(Partner_Job,this,BlockCount);
+
+	*best = Best[0];
+	for (int i=1; i<BlockCount; i++) {
+		if (Best[i].Match > best->Match) {
+			*best = Best[i];
+		}
+	}
+}
+
+void VisTableClustererClass::Merge(int id0,int id1)
+{
+	if (id0 > id1) {
+		int tmp = id0;
+		id0 = id1;
+		id1 = tmp;
+	}
+
+	Tables[id0]->Merge(*(Tables[id1]));
+	BitCounts[id0] = Tables[id0]->Count_True_Bits();
+	Versions[id0]++;
+	Versions[id1] = -1;
+	Parents[id1] = id0;
+	MergeCount++;
+	Progress.Increment_Completed_Operations();
+
+	CandidateStruct candidate;
+	Find_Best_Partner(id0,&candidate);
+	if (candidate.Partner != -1) {
+		Push(candidate);
+	}
+}
+
+void VisTableClustererClass::Merge_Duplicates(void)
+{
+	/*
+	** Identical tables match perfectly so they would be the first merges anyway, and merging
+	** them up front keeps large groups of them (empty tables mostly) out of the queue.
+	*/
+	int i,j;
+	SimpleVecClass<DuplicateStruct> keys(Count);
+	for (i=0; i<Count; i++) {
+		keys[i].BitCount = BitCounts[i];
+		keys[i].CRC = Tables[i]->Compute_CRC();
+		keys[i].Id = i;
+	}
+	qsort(&(keys[0]),Count,sizeof(DuplicateStruct),Duplicate_Compare);
+
+	for (i=0; i<Count; i=j) {
+		for (j=i+1; (j<Count) && (keys[j].BitCount == keys[i].BitCount) && (keys[j].CRC == keys[i].CRC); j++) {
+		}
+
+		/*
+		** Merge each table in the run into the first one before it that is really equal
+		*/
+		for (int k=i+1; k<j; k++) {
+			for (int m=i; m<k; m++) {
+				int id0 = keys[m].Id;
+				int id1 = keys[k].Id;
+				if (Is_Live(id0) && Tables[id0]->Is_Equal_To(*(Tables[id1]))) {
+					Versions[id1] = -1;
+					Parents[id1] = id0;
+					MergeCount++;
+					Progress.Increment_Completed_Operations();
+					break;
+				}
+			}
+		}
+	}
+}
+
+bool VisTableClustererClass::Is_Better(const CandidateStruct & a,const CandidateStruct & b)
+{
+	if (a.Match != b.Match) {
+		return a.Match > b.Match;
+	}
+	int a0 = MIN(a.Id,a.Partner);
+	int b0 = MIN(b.Id,b.Partner);
+	if (a0 != b0) {
+		return a0 < b0;
+	}
+	return MAX(a.Id,a.Partner) < MAX(b.Id,b.Partner);
+}
+
+void VisTableClustererClass::Push(const CandidateStruct & candidate)
+{
+	Queue.Add(candidate);
+	int i = Queue.Count() - 1;
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (!Is_Better(Queue[i],Queue[parent])) {
+			break;
+		}
+		CandidateStruct tmp = Queue[i];
+		Queue[i] = Queue[parent];
+		Queue[parent] = tmp;
+		i = parent;
+	}
+}
+
+void VisTableClustererClass::Pop(CandidateStruct * candidate)
+{
+	*candidate = Queue[0];
+	int last = Queue.Count() - 1;
+	Queue[0] = Queue[last];
+	Queue.Delete(last,false);
+
+	int count = Queue.Count();
+	int i = 0;
+	for (;;) {
+		int child = 2 * i + 1;
+		if (child >= count) {
+			break;
+		}
+		if ((child + 1 < count) && Is_Better(Queue[child + 1],Queue[child])) {
+			child++;
+		}
+		if (!Is_Better(Queue[child],Queue[i])) {
+			break;
+		}
+		CandidateStruct tmp = Queue[i];
+		Queue[i] = Queue[child];
+		Queue[child] = tmp;
+		i = child;
+	}
+}
+
+int VisTableClustererClass::Duplicate_Compare(const void * a,const void * b)
+{
+	const DuplicateStruct * key_a = (const DuplicateStruct *)a;
+	const DuplicateStruct * key_b = (const DuplicateStruct *)b;
+	if (key_a->BitCount != key_b->BitCount) {
+		return (key_a->BitCount < key_b->BitCount) ? -1 : 1;
+	}
+	if (key_a->CRC != key_b->CRC) {
+		return (key_a->CRC < key_b->CRC) ? -1 : 1;
+	}
+	return key_a->Id - key_b->Id;
+}
+
+void VisTableClustererClass::Rows_Job(void * data,int index)
+{
+	VisTableClustererClass * clusterer = (VisTableClustererClass *)data;
+	int first = index * VIS_OPT_BLOCK_SIZE;
+	int last = MIN(first + VIS_OPT_BLOCK_SIZE,clusterer->Count);
+
+	for (int i=first; i<last; i++) {
+		if (clusterer->Is_Live(i)) {
+			clusterer->Find_Best_Partner(i,0,clusterer->Count,&(clusterer->Best[i]));
+		} else {
+			clusterer->Best[i].Partner = -1;
+		}
+	}
+	clusterer->Progress.Increment_Completed_Operations(last - first);
+}
+
+void VisTableClustererClass::Partner_Job(void * data,int index)
+{
+	VisTableClustererClass * clusterer = (VisTableClustererClass *)data;
+	int first = index * VIS_OPT_BLOCK_SIZE;
+	int last = MIN(first + VIS_OPT_BLOCK_SIZE,clusterer->Count);
+	clusterer->Find_Best_Partner(clusterer->PartnerId,first,last,&(clusterer->Best[index]));
+}
+
+
 
 /***************************************************************************************************
 **
@@ -158,113 +557,152 @@ void VisOptimizationContextClass::Build_Object_Tables(VisTableMgrClass * vis_mgr
 	/*
 	** Generate the object tables (what sectors can see each object).  Consider the sector
 	** tables columns and the object tables rows of the same 2D grid of visibility bits.
+	** The sector tables are all fetched up front (the vis manager isn't thread safe) and 
+	** then the object tables are filled in by the worker threads, each one doing a block 
+	** of objects.
 	*/
-	int i,j;
+	int i;
 	int sector_count = vis_mgr->Get_Vis_Table_Count();
 	int object_count = vis_mgr->Get_Vis_Table_Size();
 	
+	SimpleVecClass<VisTableClass *> sector_tables(MAX(sector_count,1));
+	SimpleVecClass<VisTableClass *> object_tables(MAX(object_count,1));
+
 	ObjectTables.Resize(object_count);
 	for (i=0; i<object_count; i++) {
 		PVSInfoStruct objinfo;
 		objinfo.Table = NEW_REF(VisTableClass,(sector_count,0));
 		ObjectTables.Add(objinfo);
+		object_tables[i] = objinfo.Table;
 	}
 
 	for (i=0; i<sector_count; i++) {
-
-		/*
-		** Get each sector table
-		*/
-		VisTableClass * sector_table = vis_mgr->Get_Vis_Table(i);
-		if (sector_table == NULL) {
-			sector_table = NEW_REF(VisTableClass,(object_count,0));
-			sector_table->Reset_All();
+		sector_tables[i] = vis_mgr->Get_Vis_Table(i);
+		if (sector_tables[i] == NULL) {
+			sector_tables[i] = NEW_REF(VisTableClass,(object_count,0));
+			sector_tables[i]->Reset_All();
 		}
+	}
 
-		/*
-		** Copy its bits into the object tables
-		*/
-		for (j=0; j<object_count; j++) {
-			ObjectTables[j].Table->Set_Bit(i,sector_table->Get_Bit(j) != 0);
-		}
+	TransposeJobStruct job;
+	job.Src = &(sector_tables[0]);
+	job.SrcCount = sector_count;
+	job.Dest = &(object_tables[0]);
+	job.DestCount = object_count;
+	WorkerPoolClass::Parallel_For(Transpose_Job,&job,(object_count + VIS_OPT_BLOCK_SIZE - 1) / VIS_OPT_BLOCK_SIZE);
 
-		/*
-		** Release it
-		*/
-		REF_PTR_RELEASE(sector_table);
+	for (i=0; i<sector_count; i++) {
+		REF_PTR_RELEASE(sector_tables[i]);
 	}
 }
 
 void VisOptimizationContextClass::Combine_Redundant_Objects(void)
 {
-	int i,j;
-	for (i=0; i<ObjectTables.Count(); i++) {
-
-		/*
-		** Take a copy of object table 'i' for comparisons
-		*/
-		VisTableClass *table_i = NEW_REF (VisTableClass, (*(ObjectTables[i].Table)));
-
-		for (j=i+1; j<ObjectTables.Count(); j++) {
-		
-			/*
-			** Compare table 'j' with the original copy of table 'i'
-			*/
-			float frac = table_i->Match_Fraction(*(ObjectTables[j].Table));
-			if (frac > MinVisObjectMatchFraction) {
-				Combine_Object_Tables(i,j);
-				Stats.Increment_Objects_Merged();
-				j--;
-			}			
-		}
-
-		Stats.Increment_Completed_Operations();
-		REF_PTR_RELEASE (table_i);
+	SimpleVecClass<uint32> id_map;
+	int merged = Cluster_Tables(ObjectTables,MinVisObjectMatchFraction,id_map);
+	if (merged > 0) {
+		Stats.Increment_Objects_Merged(merged);
+		Scene->Remap_Vis_Object_IDs(&(id_map[0]),id_map.Length());
 	}
 }
 
 
 void VisOptimizationContextClass::Build_Sector_Tables_From_Object_Tables(VisTableMgrClass * vis_mgr)
 {
-	int i,j;
-	for (i=0; i<vis_mgr->Get_Vis_Table_Count(); i++) {
+	int i;
+	int sector_count = vis_mgr->Get_Vis_Table_Count();
+	int object_count = ObjectTables.Count();
+
+	SimpleVecClass<VisTableClass *> sector_tables(MAX(sector_count,1));
+	SimpleVecClass<VisTableClass *> object_tables(MAX(object_count,1));
 
+	SectorTables.Resize(sector_count);
+	for (i=0; i<sector_count; i++) {
 		PVSInfoStruct sectorinfo;
-		sectorinfo.Table = NEW_REF(VisTableClass,(ObjectTables.Count(),0));
+		sectorinfo.Table = NEW_REF(VisTableClass,(object_count,0));
 		sectorinfo.UnUsed = (vis_mgr->Has_Vis_Table(i) == false);
-
-		for (j=0; j<ObjectTables.Count(); j++) {
-			sectorinfo.Table->Set_Bit(j,(ObjectTables[j].Table->Get_Bit(i) != 0));
-		}
 		SectorTables.Add(sectorinfo);
+		sector_tables[i] = sectorinfo.Table;
+	}
+	for (i=0; i<object_count; i++) {
+		object_tables[i] = ObjectTables[i].Table;
 	}
+
+	TransposeJobStruct job;
+	job.Src = &(object_tables[0]);
+	job.SrcCount = object_count;
+	job.Dest = &(sector_tables[0]);
+	job.DestCount = sector_count;
+	WorkerPoolClass::Parallel_For(Transpose_Job,&job,(sector_count + VIS_OPT_BLOCK_SIZE - 1) / VIS_OPT_BLOCK_SIZE);
 }
 
 void VisOptimizationContextClass::Combine_Redundant_Sectors(void)
 {
-	int i,j;
-	for (i=0; i<SectorTables.Count(); i++) {
+	SimpleVecClass<uint32> id_map;
+	int merged = Cluster_Tables(SectorTables,MinVisSectorMatchFraction,id_map);
+	if (merged > 0) {
+		Stats.Increment_Sectors_Merged(merged);
+		Scene->Remap_Vis_Sector_IDs(&(id_map[0]),id_map.Length());
+	}
+}
 
-		/*
-		** Take a copy of object table 'i' for comparisons
-		*/
-		VisTableClass *table_i = NEW_REF (VisTableClass, (*(SectorTables[i].Table)));
+int VisOptimizationContextClass::Cluster_Tables
+(
+	DynamicVectorClass<PVSInfoStruct> & tables,
+	float min_match,
+	SimpleVecClass<uint32> & id_map
+)
+{
+	int i;
+	int count = tables.Count();
+	if (count == 0) {
+		return 0;
+	}
 
-		for (j=i+1; j<SectorTables.Count(); j++) {
-	
-			/*
-			** Compare table 'j' with the original copy of table 'i'
-			*/
-			float frac = table_i->Match_Fraction(*(SectorTables[j].Table));
-			if (frac > MinVisSectorMatchFraction) {
-				Combine_Sector_Tables(i,j);
-				Stats.Increment_Sectors_Merged();
-				j--;
-			}			
+	SimpleVecClass<VisTableClass *> table_ptrs(count);
+	for (i=0; i<count; i++) {
+		table_ptrs[i] = tables[i].Table;
+	}
+
+	VisTableClustererClass clusterer(&(table_ptrs[0]),count,min_match,Stats);
+	int merged = clusterer.Cluster();
+
+	/*
+	** Each of these phases was counted as two operations per table; the clusterer has
+	** done one per table plus one per merge.
+	*/
+	Stats.Increment_Completed_Operations(count - merged);
+
+	/*
+	** Compact the tables.  The ones that are left keep their order and every table that
+	** was merged away gets the new id of the table it ended up in.  Tables are always 
+	** merged into a lower id so the root of each table has been placed by the time it is
+	** reached.  A merged sector is only unused if all of its parts were.
+	*/
+	DynamicVectorClass<PVSInfoStruct> compacted;
+	compacted.Resize(count - merged);
+	id_map.Resize(count);
+
+	for (i=0; i<count; i++) {
+		int root = clusterer.Find_Root(i);
+		if (root == i) {
+			id_map[i] = compacted.Count();
+			compacted.Add(tables[i]);
+		} else {
+			WWASSERT(root < i);
+			id_map[i] = id_map[root];
+			if (tables[i].UnUsed == false) {
+				compacted[id_map[i]].UnUsed = false;
+			}
 		}
-		Stats.Increment_Completed_Operations(1);
-		REF_PTR_RELEASE (table_i);
 	}
+
+	tables.Delete_All();
+	tables.Resize(compacted.Count());
+	for (i=0; i<compacted.Count(); i++) {
+		tables.Add(compacted[i]);
+	}
+	return merged;
 }
 
 
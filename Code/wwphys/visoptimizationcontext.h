@@ -41,6 +41,8 @@
 
 #include "always.h"
 #include "vector.h"
+#include "simplevec.h"
+#include "bittype.h"
 
 
 class PhysicsSceneClass;
@@ -54,6 +56,9 @@ class DynamicAABTreeCullClass;
 ** This class encapsulates information needed to optimize the precalculated visibility data
 ** for a level.  It is passed into the dynamic culling system for pruning the useless leaf
 ** nodes.  It also performs merging of both sector and object ids.
+**
+** Objects and sectors are merged by clustering their tables (see VisTableClustererClass in
+** the .cpp) and then renumbering the scene's ids once at the end of each phase.
 */
 class VisOptimizationContextClass
 {	
@@ -105,6 +110,8 @@ protected:
 		bool						UnUsed;
 	};
 
+	int							Cluster_Tables(DynamicVectorClass<PVSInfoStruct> & tables,float min_match,SimpleVecClass<uint32> & id_map);
+
 	float												MinDynCellPruneMatchFraction;
 	float												MinVisObjectMatchFraction;
 	float												MinVisSectorMatchFraction;
@@ -37,6 +37,8 @@
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include "visoptprogress.h"
+#include "systimer.h"
+#include <windows.h>
 
 
 /************************************************************************************
@@ -54,6 +56,7 @@ void VisOptProgressClass::Reset(int total_operation_count)
 {
 	TotalOps = total_operation_count;
 	CompletedOps = 0;
+	StartTime = TIMEGETTIME();
 
 	InitialBitCount = 0;
 	FinalBitCount = 0;
@@ -68,6 +71,24 @@ void VisOptProgressClass::Reset(int total_operation_count)
 	SectorsMerged = 0;
 }
 
+void VisOptProgressClass::Increment_Completed_Operations(int count)
+{
+	::InterlockedExchangeAdd(&CompletedOps,count);
+}
 
+float VisOptProgressClass::Get_Elapsed_Seconds(void)
+{
+	return (float)(TIMEGETTIME() - StartTime) / 1000.0f;
+}
 
-
+float VisOptProgressClass::Get_Estimated_Seconds_Remaining(void)
+{
+	/*
+	** Assume the remaining operations take as long as the ones done so far did on average
+	*/
+	int completed = CompletedOps;
+	if ((completed <= 0) || (completed >= TotalOps)) {
+		return 0.0f;
+	}
+	return Get_Elapsed_Seconds() * (float)(TotalOps - completed) / (float)completed;
+}
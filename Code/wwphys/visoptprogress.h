@@ -51,7 +51,9 @@
 ** valid.
 **
 ** Note that the TotalOperations count is an upper estimate and the process may (will usually)
-** complete before Completed_Operation_Count reaches it.
+** complete before Completed_Operation_Count reaches it.  Parts of the process run on the
+** worker threads so the completed count is updated atomically.  The time remaining is
+** estimated from the rate the operations have been completed at since the Reset.
 */
 class VisOptProgressClass
 {
@@ -62,13 +64,15 @@ public:
 	** Initialization and update
 	*/
 	void						Reset(int total_operation_count);
-	void						Increment_Completed_Operations(int count = 1)	{ CompletedOps += count; }
+	void						Increment_Completed_Operations(int count = 1);
 
 	/*
 	** Accessors
 	*/
 	int						Get_Total_Operation_Count(void)				{ return TotalOps; }
 	int						Get_Completed_Operation_Count(void)			{ return CompletedOps; }
+	float						Get_Elapsed_Seconds(void);
+	float						Get_Estimated_Seconds_Remaining(void);
 	
 	int						Get_Initial_Bit_Count(void)					{ return InitialBitCount; }	
 	int						Get_Final_Bit_Count(void)						{ return FinalBitCount; }
@@ -101,7 +105,8 @@ public:
 protected:
 
 	int						TotalOps;
-	int						CompletedOps;
+	volatile long			CompletedOps;
+	unsigned long			StartTime;											// TIMEGETTIME when Reset was called
 
 	int						InitialBitCount;									// Initial number of bits in the vis system
 	int						FinalBitCount;										// Final number of bits in the vis system
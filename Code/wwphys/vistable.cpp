@@ -44,7 +44,10 @@
 #include "lzo1x.h"
 #include "phys.h"
 #include "wwmemlog.h"
+#include "cpudetect.h"
+#include "crc.h"
 #include <windows.h>
+#include <emmintrin.h>
 
 /*
 ** Chunk ID's used by a visibility table to save itself
@@ -52,44 +55,61 @@
 enum {
 	VISTABLE_CHUNK_BYTECOUNT = 0x00000001,		// number of bytes in this pvs
 	VISTABLE_CHUNK_BYTES,							// pvs bytes, compressed with lzhl (OBSOLETE!)
-	VISTABLE_CHUNK_LZOBYTES							// pvs bytes, compressed with lzo
+	VISTABLE_CHUNK_LZOBYTES,						// pvs bytes, compressed with lzo
+	VISTABLE_CHUNK_RLEBYTES							// pvs longs, run length encoded
 };
 
+/*
+** Run length encoding of the vis longs.  Each run starts with a byte holding the run type in
+** the top two bits and the number of longs in the rest.  A count of zero means a 16bit count
+** follows.  Literal runs are followed by the longs themselves.
+*/
+enum {
+	RLE_RUN_ZEROS = 0x00,
+	RLE_RUN_ONES = 0x40,
+	RLE_RUN_LITERAL = 0x80,
+	RLE_TYPE_MASK = 0xC0,
+	RLE_COUNT_MASK = 0x3F,
+	RLE_MAX_RUN = 0xFFFF,
+};
 
-/**
-** BitCounterClass 
-** This class is used to accelerate some of the bit-vector comparing and counting that
-** goes on in VisTableClass.  
+/*
+** LZO is only used if its output is smaller than this fraction of the run length encoded size
 */
-class BitCounterClass
-{
-public:
-	BitCounterClass(void);
-	
-	int				Count_True_Bits(uint8 byte)							{ return TrueBits[byte]; }
+const float LZO_PREFERRED_RATIO = 0.75f;
 
-protected:
+/*
+** Size of the flag used to mark run length encoded buffers in the raw file format
+*/
+const uint32 RAW_RLE_FLAG = 0x80000000;
 
-	uint8				TrueBits[256];
-};
 
-BitCounterClass::BitCounterClass(void)
+/*
+** Bit counting helpers.  Count_Bits is the usual parallel bit count, the SSE2 version does the
+** same thing on sixteen bytes at once and sums the byte counts with psadbw.
+*/
+static inline int Count_Bits(uint32 val)
 {
-	/*
-	** Initialize the table of how many "on" bits there are
-	** in each number between 0 and 256
-	*/
-	for (int i=0; i<256; i++) {
-		TrueBits[i] = 0;
-		for (int bit=0; bit<8; bit++) {
-			if (i & (1<<bit)) {
-				TrueBits[i]++;
-			}
-		}
-	}
+	val = val - ((val >> 1) & 0x55555555);
+	val = (val & 0x33333333) + ((val >> 2) & 0x33333333);
+	return (((val + (val >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
 }
 
-static BitCounterClass _TheBitCounter;
+static inline __m128i Count_Bits_SSE2(__m128i val)
+{
+	const __m128i mask1 = _mm_set1_epi8(0x55);
+	const __m128i mask2 = _mm_set1_epi8(0x33);
+	const __m128i mask4 = _mm_set1_epi8(0x0F);
+	val = _mm_sub_epi8(val,_mm_and_si128(_mm_srli_epi16(val,1),mask1));
+	val = _mm_add_epi8(_mm_and_si128(val,mask2),_mm_and_si128(_mm_srli_epi16(val,2),mask2));
+	val = _mm_and_si128(_mm_add_epi8(val,_mm_srli_epi16(val,4)),mask4);
+	return _mm_sad_epu8(val,_mm_setzero_si128());
+}
+
+static inline int Sum_Counts_SSE2(__m128i counts)
+{
+	return _mm_cvtsi128_si32(counts) + _mm_cvtsi128_si32(_mm_srli_si128(counts,8));
+}
 
 
 /****************************************************************************************************
@@ -98,6 +118,14 @@ static BitCounterClass _TheBitCounter;
 **
 ****************************************************************************************************/
 
+VisTableClass::KernelType VisTableClass::Kernel = VisTableClass::KERNEL_BEST;
+
+VisTableClass::KernelType VisTableClass::Get_Kernel(void)
+{
+	if (Kernel >= KERNEL_SSE2 && CPUDetectClass::Has_SSE2_Instruction_Set()) return KERNEL_SSE2;
+	return KERNEL_SCALAR;
+}
+
 VisTableClass::VisTableClass(unsigned bitcount,int id) :
 	BitCount(bitcount),
 	Buffer(NULL),
@@ -251,14 +279,32 @@ void VisTableClass::Merge(const VisTableClass & that)
 	if (that.BitCount != BitCount) {
 		return;
 	}
-	for (int i=0; i<Get_Long_Count(); i++) {
+	int long_count = Get_Long_Count();
+	int i = 0;
+	if (Get_Kernel() == KERNEL_SSE2) {
+		for (; i+4 <= long_count; i+=4) {
+			__m128i mine = _mm_loadu_si128((__m128i *)(Buffer + i));
+			__m128i his = _mm_loadu_si128((__m128i *)(that.Buffer + i));
+			_mm_storeu_si128((__m128i *)(Buffer + i),_mm_or_si128(mine,his));
+		}
+	}
+	for (; i<long_count; i++) {
 		Buffer[i] = Buffer[i] | that.Buffer[i];
 	}
 }
 
 void VisTableClass::Invert(void)
 {
-	for (int i=0; i<Get_Long_Count(); i++) {
+	int long_count = Get_Long_Count();
+	int i = 0;
+	if (Get_Kernel() == KERNEL_SSE2) {
+		const __m128i ones = _mm_set1_epi32(-1);
+		for (; i+4 <= long_count; i+=4) {
+			__m128i mine = _mm_loadu_si128((__m128i *)(Buffer + i));
+			_mm_storeu_si128((__m128i *)(Buffer + i),_mm_xor_si128(mine,ones));
+		}
+	}
+	for (; i<long_count; i++) {
 		Buffer[i] = ~Buffer[i];
 	}
 }
@@ -281,12 +327,19 @@ int VisTableClass::Count_Differences(const VisTableClass & that)
 	} 
 
 	int counter = 0;
-	int byte_count = Get_Byte_Count();
-	uint8 * my_bytes = Get_Bytes();
-	uint8 * his_bytes = that.Get_Bytes();
-
-	for (int i=0; i<byte_count; i++) {
-		counter += _TheBitCounter.Count_True_Bits(my_bytes[i] ^ his_bytes[i]);
+	int long_count = Get_Long_Count();
+	int i = 0;
+	if (Get_Kernel() == KERNEL_SSE2) {
+		__m128i counts = _mm_setzero_si128();
+		for (; i+4 <= long_count; i+=4) {
+			__m128i mine = _mm_loadu_si128((__m128i *)(Buffer + i));
+			__m128i his = _mm_loadu_si128((__m128i *)(that.Buffer + i));
+			counts = _mm_add_epi64(counts,Count_Bits_SSE2(_mm_xor_si128(mine,his)));
+		}
+		counter = Sum_Counts_SSE2(counts);
+	}
+	for (; i<long_count; i++) {
+		counter += Count_Bits(Buffer[i] ^ that.Buffer[i]);
 	}
 	return counter;
 }
@@ -294,11 +347,18 @@ int VisTableClass::Count_Differences(const VisTableClass & that)
 int VisTableClass::Count_True_Bits(void)
 {
 	int counter = 0;
-	int byte_count = Get_Byte_Count();
-	uint8 * my_bytes = Get_Bytes();
-
-	for (int i=0; i<byte_count; i++) {
-		counter += _TheBitCounter.Count_True_Bits(my_bytes[i]);
+	int long_count = Get_Long_Count();
+	int i = 0;
+	if (Get_Kernel() == KERNEL_SSE2) {
+		__m128i counts = _mm_setzero_si128();
+		for (; i+4 <= long_count; i+=4) {
+			__m128i mine = _mm_loadu_si128((__m128i *)(Buffer + i));
+			counts = _mm_add_epi64(counts,Count_Bits_SSE2(mine));
+		}
+		counter = Sum_Counts_SSE2(counts);
+	}
+	for (; i<long_count; i++) {
+		counter += Count_Bits(Buffer[i]);
 	}
 	return counter;
 }
@@ -316,13 +376,23 @@ float VisTableClass::Match_Fraction(const VisTableClass & that)
 	int xor_counter = 0;
 	int or_counter = 0;
 
-	int byte_count = Get_Byte_Count();
-	uint8 * my_bytes = Get_Bytes();
-	uint8 * his_bytes = that.Get_Bytes();
-
-	for (int i=0; i<byte_count; i++) {
-		xor_counter += _TheBitCounter.Count_True_Bits(my_bytes[i] ^ his_bytes[i]);
-		or_counter += _TheBitCounter.Count_True_Bits(my_bytes[i] | his_bytes[i]);
+	int long_count = Get_Long_Count();
+	int i = 0;
+	if (Get_Kernel() == KERNEL_SSE2) {
+		__m128i xor_counts = _mm_setzero_si128();
+		__m128i or_counts = _mm_setzero_si128();
+		for (; i+4 <= long_count; i+=4) {
+			__m128i mine = _mm_loadu_si128((__m128i *)(Buffer + i));
+			__m128i his = _mm_loadu_si128((__m128i *)(that.Buffer + i));
+			xor_counts = _mm_add_epi64(xor_counts,Count_Bits_SSE2(_mm_xor_si128(mine,his)));
+			or_counts = _mm_add_epi64(or_counts,Count_Bits_SSE2(_mm_or_si128(mine,his)));
+		}
+		xor_counter = Sum_Counts_SSE2(xor_counts);
+		or_counter = Sum_Counts_SSE2(or_counts);
+	}
+	for (; i<long_count; i++) {
+		xor_counter += Count_Bits(Buffer[i] ^ that.Buffer[i]);
+		or_counter += Count_Bits(Buffer[i] | that.Buffer[i]);
 	}
 
 	/*
@@ -335,6 +405,11 @@ float VisTableClass::Match_Fraction(const VisTableClass & that)
 	}
 }
 
+uint32 VisTableClass::Compute_CRC(void) const
+{
+	return CRC::Memory(Get_Bytes(),Get_Byte_Count());
+}
+
 
 /****************************************************************************************************
 **
@@ -345,13 +420,17 @@ float VisTableClass::Match_Fraction(const VisTableClass & that)
 
 CompressedVisTableClass::CompressedVisTableClass(void) :
 	BufferSize(0),
-	Buffer(NULL)
+	Buffer(NULL),
+	Codec(CODEC_LZO)
 {
 }
 
+CompressedVisTableClass::CodecType CompressedVisTableClass::PreferredCodec = CompressedVisTableClass::CODEC_BEST;
+
 CompressedVisTableClass::CompressedVisTableClass(VisTableClass * bits) :
 	BufferSize(0),
-	Buffer(NULL)
+	Buffer(NULL),
+	Codec(CODEC_LZO)
 {
 	WWMEMLOG(MEM_VIS);
 	WWASSERT(bits != NULL);
@@ -360,7 +439,8 @@ CompressedVisTableClass::CompressedVisTableClass(VisTableClass * bits) :
 
 CompressedVisTableClass::CompressedVisTableClass(const CompressedVisTableClass &that) :
 	BufferSize(0),
-	Buffer(NULL)
+	Buffer(NULL),
+	Codec(CODEC_LZO)
 {
 	(*this) = that;
 }
@@ -381,6 +461,7 @@ const CompressedVisTableClass &CompressedVisTableClass::operator= (const Compres
 	}
 
 	BufferSize = that.BufferSize;
+	Codec = that.Codec;
 	Buffer = new uint8[BufferSize];
 	::memcpy (Buffer, that.Buffer, sizeof(uint8)*BufferSize);
 	return *this;
@@ -432,6 +513,12 @@ void CompressedVisTableClass::Load(ChunkLoadClass & cload)
 		case VISTABLE_CHUNK_LZOBYTES:
 			WWASSERT(cload.Cur_Chunk_Length() == (uint32)BufferSize);
 			cload.Read(Buffer,BufferSize);
+			Codec = CODEC_LZO;
+			break;
+		case VISTABLE_CHUNK_RLEBYTES:
+			WWASSERT(cload.Cur_Chunk_Length() == (uint32)BufferSize);
+			cload.Read(Buffer,BufferSize);
+			Codec = CODEC_RLE;
 			break;
 		default:
 			WWDEBUG_SAY(("Unhandled chunk ID: %d in vistable.cpp\r\n",cload.Cur_Chunk_ID()));
@@ -461,7 +548,11 @@ void CompressedVisTableClass::Save(ChunkSaveClass & csave)
 	csave.Write(&bytecount,sizeof(bytecount));
 	csave.End_Chunk();
 
-	csave.Begin_Chunk(VISTABLE_CHUNK_LZOBYTES);
+	if (Codec == CODEC_RLE) {
+		csave.Begin_Chunk(VISTABLE_CHUNK_RLEBYTES);
+	} else {
+		csave.Begin_Chunk(VISTABLE_CHUNK_LZOBYTES);
+	}
 	csave.Write(Buffer,bytecount);
 	csave.End_Chunk();
 }
@@ -486,6 +577,12 @@ void CompressedVisTableClass::Load (void* hfile)
 		uint32 dwbytes_read = 0L;
 		::ReadFile ((HANDLE)hfile, &BufferSize, sizeof (BufferSize), &dwbytes_read, NULL);
 
+		/*
+		** The top bit of the size marks run length encoded data
+		*/
+		Codec = (BufferSize & RAW_RLE_FLAG) ? CODEC_RLE : CODEC_LZO;
+		BufferSize &= ~RAW_RLE_FLAG;
+
 		/*
 		** Read the buffer
 		*/
@@ -504,7 +601,11 @@ void CompressedVisTableClass::Save (void* hfile)
 		** Write the buffer size
 		*/
 		uint32 dwbytes_written = 0L;
-		::WriteFile ((HANDLE)hfile, &BufferSize, sizeof (BufferSize), &dwbytes_written, NULL);
+		uint32 size = BufferSize;
+		if (Codec == CODEC_RLE) {
+			size |= RAW_RLE_FLAG;
+		}
+		::WriteFile ((HANDLE)hfile, &size, sizeof (size), &dwbytes_written, NULL);
 
 		/*
 		** Write the buffer
@@ -517,37 +618,157 @@ void CompressedVisTableClass::Save (void* hfile)
 
 void CompressedVisTableClass::Compress(uint8 * src_buffer,int src_size)
 {
+	CodecType codec = PreferredCodec;
 	WWMEMLOG(MEM_VIS);
+	WWASSERT(src_size % 4 == 0);
 	if (Buffer != NULL) {
 		delete[] Buffer;
 		Buffer = NULL;
 	}
 	
-	uint8 * comp_buffer = new uint8[LZO_BUFFER_SIZE(src_size)];
-	lzo_uint comp_size;
-	int lzocode = LZOCompressor::Compress(src_buffer,src_size,comp_buffer,&comp_size);
-	WWASSERT(lzocode == LZO_E_OK);
+	/*
+	** Run length encode the longs.  The worst case is a literal run header for every
+	** RLE_MAX_RUN longs.
+	*/
+	int src_count = src_size / 4;
+	uint8 * rle_buffer = NULL;
+	int rle_size = 0;
+	if (codec != CODEC_LZO) {
+		rle_buffer = new uint8[src_size + 3 * (src_count / RLE_MAX_RUN + 1)];
+		rle_size = RLE_Compress((uint32 *)src_buffer,src_count,rle_buffer);
+	}
 
-	BufferSize = comp_size;
-	Buffer = new uint8[BufferSize];
-	memcpy(Buffer,comp_buffer,BufferSize);
+	/*
+	** LZO compress if asked to, or to see if it does a lot better than the run length encoding
+	*/
+	uint8 * lzo_buffer = NULL;
+	lzo_uint lzo_size = 0;
+	if (codec != CODEC_RLE) {
+		lzo_buffer = new uint8[LZO_BUFFER_SIZE(src_size)];
+		int lzocode = LZOCompressor::Compress(src_buffer,src_size,lzo_buffer,&lzo_size);
+		WWASSERT(lzocode == LZO_E_OK);
+	}
+
+	if ((rle_buffer != NULL) && ((lzo_buffer == NULL) || ((float)lzo_size >= LZO_PREFERRED_RATIO * (float)rle_size))) {
+		Codec = CODEC_RLE;
+		BufferSize = rle_size;
+		Buffer = new uint8[BufferSize];
+		memcpy(Buffer,rle_buffer,BufferSize);
+	} else {
+		Codec = CODEC_LZO;
+		BufferSize = lzo_size;
+		Buffer = new uint8[BufferSize];
+		memcpy(Buffer,lzo_buffer,BufferSize);
+	}
+
+	delete[] rle_buffer;
+	delete[] lzo_buffer;
 
 #ifdef WWDEBUG
-	lzo_uint decomp_size;
-	LZOCompressor::Decompress(Buffer,BufferSize,comp_buffer,&decomp_size);
-	WWASSERT(decomp_size == (lzo_uint)src_size);
-	WWASSERT(src_size % 4 == 0);
+	uint8 * test_buffer = new uint8[src_size];
+	Decompress(test_buffer,src_size);
+	WWASSERT(memcmp(test_buffer,src_buffer,src_size) == 0);
+	delete[] test_buffer;
 #endif
-
-	delete[] comp_buffer;
 }
 
 void CompressedVisTableClass::Decompress(uint8 * decomp_buffer,int decomp_size)
 {
 	WWMEMLOG(MEM_VIS);
-	lzo_uint size;
-	LZOCompressor::Decompress(Buffer,BufferSize,decomp_buffer, &size);
-	WWASSERT((int)size == decomp_size);
+	if (Codec == CODEC_RLE) {
+		bool ok = RLE_Decompress(Buffer,BufferSize,(uint32 *)decomp_buffer,decomp_size / 4);
+		WWASSERT(ok);
+		if (!ok) {
+			memset(decomp_buffer,0,decomp_size);
+		}
+	} else {
+		lzo_uint size;
+		LZOCompressor::Decompress(Buffer,BufferSize,decomp_buffer, &size);
+		WWASSERT((int)size == decomp_size);
+	}
+}
+
+static inline uint8 * RLE_Write_Run(uint8 * dest,int type,int count)
+{
+	if (count <= RLE_COUNT_MASK) {
+		*dest++ = (uint8)(type | count);
+	} else {
+		*dest++ = (uint8)type;
+		*dest++ = (uint8)(count & 0xFF);
+		*dest++ = (uint8)(count >> 8);
+	}
+	return dest;
+}
+
+int CompressedVisTableClass::RLE_Compress(const uint32 * src,int src_count,uint8 * dest)
+{
+	uint8 * dest_start = dest;
+	int i = 0;
+	while (i < src_count) {
+
+		int start = i;
+		if ((src[i] == 0) || (src[i] == 0xFFFFFFFF)) {
+
+			/*
+			** Run of zeros or ones.  Even a single long is worth a run since it
+			** takes one byte rather than four.
+			*/
+			uint32 val = src[i];
+			while ((i < src_count) && (src[i] == val) && (i - start < RLE_MAX_RUN)) {
+				i++;
+			}
+			dest = RLE_Write_Run(dest,(val == 0) ? RLE_RUN_ZEROS : RLE_RUN_ONES,i - start);
+
+		} else {
+
+			/*
+			** Literal longs up to the next zero or ones long
+			*/
+			while ((i < src_count) && (src[i] != 0) && (src[i] != 0xFFFFFFFF) && (i - start < RLE_MAX_RUN)) {
+				i++;
+			}
+			dest = RLE_Write_Run(dest,RLE_RUN_LITERAL,i - start);
+			memcpy(dest,src + start,(i - start) * sizeof(uint32));
+			dest += (i - start) * sizeof(uint32);
+		}
+	}
+	return dest - dest_start;
+}
+
+bool CompressedVisTableClass::RLE_Decompress(const uint8 * src,int src_size,uint32 * dest,int dest_count)
+{
+	const uint8 * src_end = src + src_size;
+	int i = 0;
+	while (src < src_end) {
+
+		int type = *src & RLE_TYPE_MASK;
+		int count = *src & RLE_COUNT_MASK;
+		src++;
+		if (count == 0) {
+			if (src + 2 > src_end) return false;
+			count = src[0] | (src[1] << 8);
+			src += 2;
+		}
+		if (i + count > dest_count) return false;
+
+		switch (type) {
+		case RLE_RUN_ZEROS:
+			memset(dest + i,0x00,count * sizeof(uint32));
+			break;
+		case RLE_RUN_ONES:
+			memset(dest + i,0xFF,count * sizeof(uint32));
+			break;
+		case RLE_RUN_LITERAL:
+			if (src + count * sizeof(uint32) > src_end) return false;
+			memcpy(dest + i,src,count * sizeof(uint32));
+			src += count * sizeof(uint32);
+			break;
+		default:
+			return false;
+		}
+		i += count;
+	}
+	return (i == dest_count);
 }
 
 #if 0
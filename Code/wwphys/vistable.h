@@ -56,6 +56,10 @@ class CompressedVisTableClass;
 ** VisTableClass
 ** This is a bit vector which contains a bit for each static node in the world indicating
 ** whether that node can be seen from the current "vis-sector"
+**
+** The bulk operations (Merge, Invert, Count_Differences, Count_True_Bits, Match_Fraction)
+** work on 128 bits at a time when the cpu has SSE2.  Set_Kernel(KERNEL_SCALAR) forces the
+** plain versions for comparison.
 */
 class VisTableClass : public RefCountClass, public MultiListObjectClass
 {
@@ -68,6 +72,7 @@ public:
 	VisTableClass & operator = (const VisTableClass & that);
 
 	int			Get_Bit_Count(void) const								{ return BitCount; }
+	int			Get_Memory_Size(void) const							{ return sizeof(VisTableClass) + Get_Byte_Count(); }
 
 	void			Reset_All(void);
 	void			Set_All(void);
@@ -81,12 +86,22 @@ public:
 	int			Count_Differences(const VisTableClass & that);
 	int			Count_True_Bits(void);
 	float			Match_Fraction(const VisTableClass & that);
+	uint32		Compute_CRC(void) const;
 
 	void			Set_Vis_Sector_ID(int id)								{ VisSectorID = id; }
 	int			Get_Vis_Sector_ID(void)									{ return VisSectorID; }
 	void			Set_Time_Stamp(int timestamp)							{ Timestamp = timestamp; }
 	int			Get_Time_Stamp(void) const								{ return Timestamp; }
 
+	enum KernelType {
+		KERNEL_SCALAR=0,
+		KERNEL_SSE2,
+		KERNEL_BEST
+	};
+
+	static void			Set_Kernel(KernelType kernel)					{ Kernel = kernel; }
+	static KernelType	Get_Kernel(void);
+
 protected:
 
 	void			Alloc_Buffer(int bitcount);
@@ -102,6 +117,8 @@ protected:
 	int			VisSectorID;
 	int			Timestamp;
 
+	static KernelType		Kernel;
+
 	// Not implemented:
 	bool operator == (const VisTableClass & that);
 
@@ -113,11 +130,22 @@ protected:
 ** This is the form that pvs data is stored in memory when it is not being used.  It
 ** is basically a wrapper around an allocated array with functions to compress and
 ** decompress to/from a VisTableClass and functions for saving and loading. 
+**
+** Tables are compressed with either LZO or a run length encoding of the 32bit words.  The
+** run length codec decompresses several times faster (it is just memsets and memcpys) and
+** is used unless LZO does a lot better on a table.  Set_Preferred_Codec can force one codec
+** for comparison.
 */
 class CompressedVisTableClass
 {	
 public:
 
+	enum CodecType {
+		CODEC_LZO=0,
+		CODEC_RLE,
+		CODEC_BEST
+	};
+
 	CompressedVisTableClass(void);
 	CompressedVisTableClass(VisTableClass * bits);
 	CompressedVisTableClass(const CompressedVisTableClass &that);
@@ -131,16 +159,27 @@ public:
 	void			Load(ChunkLoadClass & cload);
 	void			Save(ChunkSaveClass & csave);
 
+	int			Get_Byte_Count(void) const;
+	CodecType	Get_Codec(void) const									{ return Codec; }
+
+	static void			Set_Preferred_Codec(CodecType codec)		{ PreferredCodec = codec; }
+	static CodecType	Get_Preferred_Codec(void)						{ return PreferredCodec; }
+
 protected:
 
-	int			Get_Byte_Count(void) const;
 	uint8 *		Get_Bytes(void);
 
 	void			Compress(uint8 * src_buffer,int src_size);
 	void			Decompress(uint8 * decomp_buffer,int decomp_size);
 	
+	static int	RLE_Compress(const uint32 * src,int src_count,uint8 * dest);
+	static bool	RLE_Decompress(const uint8 * src,int src_size,uint32 * dest,int dest_count);
+
 	int			BufferSize;
 	uint8 *		Buffer;
+	CodecType	Codec;
+
+	static CodecType		PreferredCodec;
 
 	// Not implemented:
 	bool operator == (const CompressedVisTableClass & that);
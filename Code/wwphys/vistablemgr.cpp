@@ -41,9 +41,11 @@
 #include "vistable.h"
 #include "chunkio.h"
 #include "wwmemlog.h"
+#include <windows.h>
 
 
 const int VIS_LRU_FRAMES = 5;
+const int VIS_CACHE_DEFAULT_BUDGET = 1024 * 1024;
 
 /**
 ** VisDecompressionCacheClass
@@ -51,11 +53,15 @@ const int VIS_LRU_FRAMES = 5;
 ** light-sources now use VIS data and didn't want to pay the cpu cost of decompressing their
 ** vis table each time it is needed or the ram cost of keeping them all decompressed all of the
 ** time.
+**
+** Tables are kept until the total size of the cached tables goes over the memory budget,
+** then the least recently used tables are released.  Tables used in the last few frames
+** are only released to make room for new ones.
 */
 class VisDecompressionCacheClass
 {
 public:
-	VisDecompressionCacheClass(void) { }
+	VisDecompressionCacheClass(void) : CurrentTimestamp(0), Budget(VIS_CACHE_DEFAULT_BUDGET), TotalBytes(0) { }
 	~VisDecompressionCacheClass(void) { Reset(0); }
 
 	void						Reset(int vis_sector_count = -1);
@@ -67,12 +73,20 @@ public:
 	void						Set_Current_Timestamp(int timestamp)		{ CurrentTimestamp = timestamp; }
 	int						Get_Current_Timestamp(void)					{ return CurrentTimestamp; }
 
+	void						Set_Budget(int bytes)							{ Budget = bytes; }
+	int						Get_Budget(void) const							{ return Budget; }
+	int						Get_Total_Bytes(void) const					{ return TotalBytes; }
+
 protected:
 
+	void						Release_Head(void);
+
 	SimpleVecClass<VisTableClass *>			Cache;
 	MultiListClass<VisTableClass>				LRUQueue;
 
 	int												CurrentTimestamp;
+	int												Budget;
+	int												TotalBytes;
 };
  
 
@@ -81,17 +95,10 @@ void VisDecompressionCacheClass::Reset(int vis_sector_count)
 	/*
 	** Each table that we have should be in our LRU list
 	*/
-	VisTableClass * pvs = LRUQueue.Peek_Head();
-	while (pvs != NULL) {
-		WWASSERT(Cache[pvs->Get_Vis_Sector_ID()] != NULL);
-		
-		LRUQueue.Remove_Head();
-		
-		int vis_id = pvs->Get_Vis_Sector_ID();
-		REF_PTR_RELEASE(Cache[vis_id]);
-		
-		pvs = LRUQueue.Peek_Head();
+	while (LRUQueue.Peek_Head() != NULL) {
+		Release_Head();
 	}
+	WWASSERT(TotalBytes == 0);
 
 	/*
 	** Sanity check, every pointer in the cache array should now be NULL!
@@ -147,27 +154,44 @@ VisDecompressionCacheClass::Add_Table(VisTableClass * pvs)
 	pvs->Set_Time_Stamp(CurrentTimestamp);
 	REF_PTR_SET(Cache[pvs->Get_Vis_Sector_ID()],pvs);
 	LRUQueue.Add_Tail(pvs);
+	TotalBytes += pvs->Get_Memory_Size();
+
+	/*
+	** Make room for the new table
+	*/
+	while ((TotalBytes > Budget) && (LRUQueue.Peek_Head() != pvs)) {
+		Release_Head();
+	}
 }
 
 void
 VisDecompressionCacheClass::Release_Old_Tables(void)
 {
 	/*
-	** Release any vis table that hasn't been used in X frames
+	** If we're over budget, release any vis table that hasn't been used in X frames
 	*/
 	int timestamp_cutoff = CurrentTimestamp - VIS_LRU_FRAMES;
 
 	VisTableClass * tbl = LRUQueue.Peek_Head();
-	while (tbl && tbl->Get_Time_Stamp() < timestamp_cutoff) {
-		
-		int vis_id = tbl->Get_Vis_Sector_ID();
-		REF_PTR_RELEASE(Cache[vis_id]);
-
-		LRUQueue.Remove_Head();
+	while (tbl && (TotalBytes > Budget) && (tbl->Get_Time_Stamp() < timestamp_cutoff)) {
+		Release_Head();
 		tbl = LRUQueue.Peek_Head();
 	}
 }
 
+void
+VisDecompressionCacheClass::Release_Head(void)
+{
+	VisTableClass * tbl = LRUQueue.Remove_Head();
+	WWASSERT(tbl != NULL);
+
+	int vis_id = tbl->Get_Vis_Sector_ID();
+	WWASSERT(Cache[vis_id] == tbl);
+
+	TotalBytes -= tbl->Get_Memory_Size();
+	REF_PTR_RELEASE(Cache[vis_id]);
+}
+
 
 /*******************************************************************************************
 **
@@ -179,7 +203,7 @@ VisDecompressionCacheClass::Release_Old_Tables(void)
 /*
 ** Save/Load constants
 */
-#define VISMGR_CURRENT_VERSION		0x00010001
+#define VISMGR_CURRENT_VERSION		0x00010002		// 0x00010002: tables may be run length encoded
 
 enum 
 {
@@ -199,7 +223,8 @@ enum
 VisTableMgrClass::VisTableMgrClass(void) :
 	VisSectorCount(0),
 	VisObjectCount(0),
-	FrameCounter(0)
+	FrameCounter(0),
+	ChangeCount(0)
 {
 	WWMEMLOG(MEM_VIS);
 	Cache = new VisDecompressionCacheClass;
@@ -230,6 +255,7 @@ void VisTableMgrClass::Reset(void)
 	VisObjectCount = 1;			// always reserve Object ID 0 for objects that are forced visibile 
 	VisSectorCount = 0;
 	FrameCounter = 0;
+	ChangeCount++;
 
 	/*
 	** reset the decompression cache
@@ -241,6 +267,7 @@ int VisTableMgrClass::Allocate_Vis_Object_ID(int count /*= 1*/)
 {
 	int id = VisObjectCount;
 	VisObjectCount += count;
+	ChangeCount++;
 	return id;
 }
 
@@ -250,6 +277,7 @@ void	VisTableMgrClass::Set_Optimized_Vis_Object_Count(int count)
 	** After the optimization process, we need to simply force the VisObjectCount
 	*/
 	VisObjectCount = count;
+	ChangeCount++;
 }
 
 int VisTableMgrClass::Allocate_Vis_Sector_ID(int count /*= 1*/)
@@ -262,6 +290,7 @@ int VisTableMgrClass::Allocate_Vis_Sector_ID(int count /*= 1*/)
 	
 	VisSectorCount += count;
 	WWASSERT(VisSectorCount == VisTables.Count());
+	ChangeCount++;
 	
 	Cache->Reset(VisSectorCount);
 	return id;
@@ -298,6 +327,7 @@ VisTableClass * VisTableMgrClass::Get_Vis_Table(int id,bool allocate/*= false*/)
 	**   (we will install the compressed version when they release this table)
 	** - else return NULL
 	*/
+	Stats.Lookups++;
 	VisTableClass * pvs = Cache->Get_Table(id);
 
 	if (pvs != NULL) {
@@ -305,6 +335,7 @@ VisTableClass * VisTableMgrClass::Get_Vis_Table(int id,bool allocate/*= false*/)
 		/*
 		** Cache had the table, just return the pointer. (Add-Ref'd by the cache...)
 		*/
+		Stats.CacheHits++;
 		return pvs;
 	
 	} else if (VisTables[id] != NULL) {
@@ -313,7 +344,15 @@ VisTableClass * VisTableMgrClass::Get_Vis_Table(int id,bool allocate/*= false*/)
 		** Cache didn't have it, but we have the compressed version.
 		** Decompress, add to the cache, and return the table.
 		*/
+		LARGE_INTEGER start,end,freq;
+		::QueryPerformanceCounter(&start);
 		pvs = NEW_REF(VisTableClass,(VisTables[id],Get_Vis_Table_Size(),id));
+		::QueryPerformanceCounter(&end);
+		::QueryPerformanceFrequency(&freq);
+
+		Stats.Decompressions++;
+		Stats.DecompressMicroseconds += (float)((double)(end.QuadPart - start.QuadPart) * 1000000.0 / (double)freq.QuadPart);
+
 		Cache->Add_Table(pvs);
 		return pvs;
 	
@@ -354,6 +393,7 @@ void VisTableMgrClass::Update_Vis_Table(int id,VisTableClass * pvs)
 	** compress this one
 	*/
 	VisTables[id] = new CompressedVisTableClass(pvs);
+	ChangeCount++;
 
 	/*
 	** Reset the decompression cache
@@ -373,6 +413,22 @@ void VisTableMgrClass::Notify_Frame_Ended(void)
 	Cache->Release_Old_Tables();
 }
 
+void VisTableMgrClass::Set_Cache_Budget(int bytes)
+{
+	Cache->Set_Budget(bytes);
+	Cache->Release_Old_Tables();
+}
+
+int VisTableMgrClass::Get_Cache_Budget(void) const
+{
+	return Cache->Get_Budget();
+}
+
+int VisTableMgrClass::Get_Cache_Size(void) const
+{
+	return Cache->Get_Total_Bytes();
+}
+
 void VisTableMgrClass::Delete_All_Vis_Tables(void)
 {
 	// delete all allocated tables
@@ -445,6 +501,7 @@ void VisTableMgrClass::Load(ChunkLoadClass & cload)
 
 	// reset the cache
 	Cache->Reset(VisSectorCount);
+	ChangeCount++;
 
 	// read the actual vis tables
 	uint32 id = 0xFFFFFFFF;
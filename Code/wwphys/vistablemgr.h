@@ -76,6 +76,12 @@ public:
 	int								Get_Vis_Table_Count(void) const;
 	void								Set_Optimized_Vis_Object_Count(int count);
 
+	/*
+	** Changes whenever the vis ids are re-allocated or a vis table is replaced, anything 
+	** that holds on to a vis table or to vis ids from an earlier frame can compare this.
+	*/
+	unsigned							Get_Change_Count(void) const						{ return ChangeCount; }
+
 	/*
 	** Access to the actual vis data.  Decompressed tables are cached
 	** behind the scenes so just call this whenever you want a vis table.
@@ -88,9 +94,31 @@ public:
 	bool								Has_Vis_Table(int id);
 
 	/*
-	** Pulse this once per frame to purge the LRU cache
+	** Pulse this once per frame to purge the LRU cache.  Decompressed tables are kept
+	** until the cache goes over its memory budget, then the least recently used ones
+	** are released.
 	*/
 	void								Notify_Frame_Ended(void);
+	void								Set_Cache_Budget(int bytes);
+	int								Get_Cache_Budget(void) const;
+	int								Get_Cache_Size(void) const;
+
+	/*
+	** Statistics, these just accumulate until Reset_Statistics is called.
+	*/
+	struct StatsStruct
+	{
+		StatsStruct(void)													{ Reset(); }
+		void		Reset(void)												{ Lookups = 0; CacheHits = 0; Decompressions = 0; DecompressMicroseconds = 0.0f; }
+
+		int		Lookups;
+		int		CacheHits;
+		int		Decompressions;
+		float		DecompressMicroseconds;
+	};
+
+	const StatsStruct &			Get_Statistics(void) const							{ return Stats; }
+	void								Reset_Statistics(void)								{ Stats.Reset(); }
 
 	/*
 	** Save/Load interface
@@ -108,6 +136,8 @@ protected:
 	SimpleDynVecClass<CompressedVisTableClass *>		VisTables;
 	VisDecompressionCacheClass *							Cache;	
 	unsigned int												FrameCounter;
+	unsigned int												ChangeCount;
+	StatsStruct													Stats;
 };
 
 
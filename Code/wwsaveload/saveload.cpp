@@ -37,6 +37,7 @@
 
 #include "saveload.h"
 #include "saveloadsubsystem.h"
+#include "savesnapshot.h"
 #include "persist.h"
 #include "persistfactory.h"
 #include "chunkio.h"
@@ -44,6 +45,7 @@
 #include "saveloadstatus.h"
 #include "wwhack.h"
 #include "wwprofile.h"
+#include "workerpool.h"
 
 #pragma warning(disable:4201) // warning C4201: nonstandard extension used : nameless struct/union
 #include <windows.h>
@@ -70,6 +72,108 @@ bool SaveLoadSystemClass::Save (ChunkSaveClass &csave,SaveLoadSubSystemClass & s
 	return ok;
 }
 
+/*
+** One sub-system being saved by the list version of Save
+*/
+struct SubSystemSaveStruct
+{
+	SaveLoadSubSystemClass *	SubSystem;
+	MemoryFileClass *				Data;
+	bool								NeedsSave;
+	bool								Ok;
+};
+
+void SaveLoadSystemClass::Save_Sub_System_Job (void * data,int index)
+{
+	SubSystemSaveStruct & job = ((SubSystemSaveStruct *)data)[index];
+
+	job.Data->Open (FileClass::WRITE);
+	ChunkSaveClass csave (job.Data);
+	job.Ok = Save (csave, *job.SubSystem);
+	job.Data->Close ();
+}
+
+bool SaveLoadSystemClass::Save
+(
+	ChunkSaveClass &				csave,
+	SaveLoadSubSystemClass **	subsystems,
+	int								count,
+	SaveSnapshotClass *			snapshot
+)
+{
+	WWPROFILE ("SaveLoadSystemClass::Save");
+
+	//
+	//	Without a snapshot every sub-system saves into a temporary one
+	//
+	SaveSnapshotClass temp_snapshot;
+	bool incremental = (snapshot != NULL);
+	if (snapshot == NULL) {
+		snapshot = &temp_snapshot;
+	}
+
+	SubSystemSaveStruct * jobs = new SubSystemSaveStruct[(count > 0) ? count : 1];
+	for (int index = 0; index < count; index ++) {
+		SaveSnapshotClass::EntryStruct * entry = snapshot->Get_Entry (subsystems[index]);
+		jobs[index].SubSystem	= subsystems[index];
+		jobs[index].Data			= &entry->Data;
+		jobs[index].NeedsSave	= !incremental || !entry->IsValid || subsystems[index]->Has_Changed ();
+		jobs[index].Ok				= true;
+
+		if (jobs[index].NeedsSave) {
+			entry->IsValid = false;
+		}
+
+		//
+		//	Each sub-system has one buffer, so it can only be in the list once
+		//
+#ifdef WWDEBUG
+		for (int prev = 0; prev < index; prev ++) {
+			WWASSERT (subsystems[prev] != subsystems[index]);
+		}
+#endif
+	}
+
+	//
+	//	Start the independent sub-systems on the workers, then save the others here
+	//
+	JobGroupClass group;
+	for (int index = 0; index < count; index ++) {
+		if (jobs[index].NeedsSave && jobs[index].SubSystem->Is_Save_Thread_Safe ()) {
+			WorkerPoolClass::Submit (Save_Sub_System_Job, jobs, index, group);
+		}
+	}
+	for (int index = 0; index < count; index ++) {
+		if (jobs[index].NeedsSave && !jobs[index].SubSystem->Is_Save_Thread_Safe ()) {
+			Save_Sub_System_Job (jobs, index);
+		}
+	}
+	group.Wait ();
+
+	//
+	//	Write the buffers out in list order
+	//
+	bool ok = true;
+	for (int index = 0; index < count; index ++) {
+		SubSystemSaveStruct & job = jobs[index];
+		MemoryFileClass * data = job.Data;
+		if (data->Get_Length () > 0 && csave.Write_Chunks (data->Get_Buffer (), data->Get_Length ()) == 0) {
+			job.Ok = false;
+		}
+		ok &= job.Ok;
+
+		if (incremental) {
+			snapshot->Get_Entry (job.SubSystem)->IsValid = job.Ok;
+			if (job.NeedsSave && job.Ok) {
+				job.SubSystem->Clear_Changed ();
+			}
+		}
+	}
+
+	delete [] jobs;
+	return ok;
+}
+
 bool SaveLoadSystemClass::Load (ChunkLoadClass &cload,bool auto_post_load)
 {
 	WWLOG_PREPARE_TIME_AND_MEMORY("SaveLoadSystemClass::Load");
@@ -55,6 +55,7 @@ class PersistClass;
 class PostLoadableClass;
 class ChunkSaveClass;
 class ChunkLoadClass;
+class SaveSnapshotClass;
 
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -129,6 +130,15 @@ class ChunkLoadClass;
 //   file internally which gives unique id's within that range to all of their sub-systems 
 //   and persist factories.  Never re-use an id or you will break compatibility with older 
 //   versions of your files...
+//
+// - Parallel and incremental saves: saving a list of sub-systems at once lets the ones
+//   that are Is_Save_Thread_Safe() save into memory on the worker pool while the rest
+//   save on the calling thread; the pieces are then written out in list order, so the 
+//   file is byte for byte the one a serial save makes.  Giving that save a 
+//   SaveSnapshotClass keeps each sub-system's bytes so the next save with it only 
+//   re-saves sub-systems that report changes.  Inside a sub-system, PersistCacheClass 
+//   does the same for individual objects.  Loading stays serial since every object
+//   registers with the one pointer remapper and post-load list.
 // 
 //////////////////////////////////////////////////////////////////////////////////
 
@@ -144,9 +154,12 @@ public:
 
 	/*
 	** Save-Load interface.  To create a file, ask each sub-system to save itself.
-	** To load a file just open it and pass it to the load method.
+	** To load a file just open it and pass it to the load method.  Saving a list
+	** of sub-systems may use the worker pool, and with a snapshot only re-saves
+	** the sub-systems that changed since the last save with that snapshot.
 	*/
 	static bool		Save (ChunkSaveClass &csave, SaveLoadSubSystemClass & subsystem);
+	static bool		Save (ChunkSaveClass &csave, SaveLoadSubSystemClass ** subsystems, int count, SaveSnapshotClass * snapshot = NULL);
 	static bool		Load (ChunkLoadClass &cload,bool auto_post_load = true);	
 	static bool		Post_Load_Processing (void(*network_callback)(void));
 	/*
@@ -193,6 +206,8 @@ protected:
 
 	static bool		Is_Post_Load_Callback_Registered(PostLoadableClass * obj);
 
+	static void		Save_Sub_System_Job(void * data,int index);
+
 	static SaveLoadSubSystemClass *		SubSystemListHead;
 	static PersistFactoryClass *			FactoryListHead;
 	static PointerRemapClass				PointerRemapper;
@@ -65,6 +65,12 @@ class ChunkSaveClass;
 // SaveLoadSystem to save the particular set of SaveLoadSubSystems that contain
 // that data.
 //
+// A sub-system whose Save only reads its own objects can say so with
+// Is_Save_Thread_Safe(); SaveLoadSystemClass will then save it on a worker
+// thread into its own buffer when saving a list of sub-systems.  Incremental
+// saves (see SaveSnapshotClass) skip sub-systems which report that nothing
+// has changed since the last snapshot and re-use the bytes saved then.
+//
 //////////////////////////////////////////////////////////////////////////////////
 class SaveLoadSubSystemClass : public PostLoadableClass
 {
@@ -78,6 +84,9 @@ public:
 protected:
 
 	virtual bool				Contains_Data(void) const						{ return true; }
+	virtual bool				Is_Save_Thread_Safe(void) const				{ return false; }
+	virtual bool				Has_Changed(void) const							{ return true; }
+	virtual void				Clear_Changed(void)								{ }
 	virtual bool				Save (ChunkSaveClass &csave) = 0;
 	virtual bool				Load (ChunkLoadClass &cload) = 0;
 
@@ -0,0 +1,177 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "savesnapshot.h"
+#include "persist.h"
+#include "persistfactory.h"
+#include "chunkio.h"
+#include "wwdebug.h"
+#include <string.h>
+
+
+//////////////////////////////////////////////////////////////////////////////////
+//
+//	SaveSnapshotClass
+//
+//////////////////////////////////////////////////////////////////////////////////
+SaveSnapshotClass::SaveSnapshotClass (void)
+{
+}
+
+SaveSnapshotClass::~SaveSnapshotClass (void)
+{
+	for (int i = 0; i < Entries.Count (); i++) {
+		delete Entries[i];
+	}
+	Entries.Delete_All ();
+}
+
+void SaveSnapshotClass::Reset (void)
+{
+	for (int i = 0; i < Entries.Count (); i++) {
+		Entries[i]->Data.Free ();
+		Entries[i]->IsValid = false;
+	}
+}
+
+int SaveSnapshotClass::Get_Size (void) const
+{
+	int size = 0;
+	for (int i = 0; i < Entries.Count (); i++) {
+		if (Entries[i]->IsValid) {
+			size += Entries[i]->Data.Get_Length ();
+		}
+	}
+	return size;
+}
+
+SaveSnapshotClass::EntryStruct * SaveSnapshotClass::Get_Entry (SaveLoadSubSystemClass * subsystem)
+{
+	for (int i = 0; i < Entries.Count (); i++) {
+		if (Entries[i]->SubSystem == subsystem) {
+			return Entries[i];
+		}
+	}
+
+	EntryStruct * entry = new EntryStruct;
+	entry->SubSystem = subsystem;
+	entry->IsValid = false;
+	Entries.Add (entry);
+	return entry;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+//
+//	PersistCacheClass
+//
+//////////////////////////////////////////////////////////////////////////////////
+PersistCacheClass::PersistCacheClass (void) :
+	Count (0),
+	IsChanged (true)
+{
+}
+
+PersistCacheClass::~PersistCacheClass (void)
+{
+	Reset ();
+}
+
+bool PersistCacheClass::Save (ChunkSaveClass & csave, PersistClass * obj)
+{
+	WWASSERT (obj != NULL);
+
+	EntryStruct * entry = NULL;
+	if (Entries.Get (obj, entry) == false) {
+		entry = new EntryStruct;
+		entry->Data = NULL;
+		entry->Size = 0;
+		entry->IsDirty = true;
+		Entries.Insert (obj, entry);
+		Count++;
+	}
+
+	if (entry->IsDirty) {
+
+		//
+		//	Save the object into the scratch file and keep a copy
+		//
+		const PersistFactoryClass & factory = obj->Get_Factory ();
+		Scratch.Open (FileClass::WRITE);
+		ChunkSaveClass scratch_save (&Scratch);
+		scratch_save.Begin_Chunk (factory.Chunk_ID ());
+		factory.Save (scratch_save, obj);
+		scratch_save.End_Chunk ();
+		Scratch.Close ();
+
+		int size = Scratch.Get_Length ();
+		if (size > entry->Size) {
+			delete [] entry->Data;
+			entry->Data = new unsigned char[size];
+		}
+		::memcpy (entry->Data, Scratch.Get_Buffer (), size);
+		entry->Size = size;
+		entry->IsDirty = false;
+	}
+
+	return (csave.Write_Chunks (entry->Data, entry->Size) == (uint32)entry->Size);
+}
+
+void PersistCacheClass::Set_Dirty (PersistClass * obj)
+{
+	EntryStruct * entry = NULL;
+	if (Entries.Get (obj, entry)) {
+		entry->IsDirty = true;
+	}
+	IsChanged = true;
+}
+
+void PersistCacheClass::Set_All_Dirty (void)
+{
+	HashTemplateIterator<PersistClass *,EntryStruct *> it (Entries);
+	for (it.First (); !it.Is_Done (); it.Next ()) {
+		it.Peek_Value ()->IsDirty = true;
+	}
+	IsChanged = true;
+}
+
+void PersistCacheClass::Remove (PersistClass * obj)
+{
+	EntryStruct * entry = NULL;
+	if (Entries.Get (obj, entry)) {
+		Entries.Remove (obj);
+		delete [] entry->Data;
+		delete entry;
+		Count--;
+	}
+	IsChanged = true;
+}
+
+void PersistCacheClass::Reset (void)
+{
+	HashTemplateIterator<PersistClass *,EntryStruct *> it (Entries);
+	for (it.First (); !it.Is_Done (); it.Next ()) {
+		delete [] it.Peek_Value ()->Data;
+		delete it.Peek_Value ();
+	}
+	Entries.Remove_All ();
+	Scratch.Free ();
+	Count = 0;
+	IsChanged = true;
+}
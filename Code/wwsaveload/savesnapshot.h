@@ -0,0 +1,143 @@
+/*
+**	Command & Conquer Renegade(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#ifndef SAVESNAPSHOT_H
+#define SAVESNAPSHOT_H
+
+#include "always.h"
+#include "vector.h"
+#include "hashtemplate.h"
+#include "memfile.h"
+
+class SaveLoadSubSystemClass;
+class PersistClass;
+class ChunkSaveClass;
+
+
+//////////////////////////////////////////////////////////////////////////////////
+//
+//	SaveSnapshotClass
+//
+// Keeps the bytes each sub-system wrote the last time it was saved through 
+// SaveLoadSystemClass::Save with this snapshot.  The next save with it copies
+// those bytes for every sub-system whose Has_Changed() is false instead of 
+// asking it to save again, and calls Clear_Changed() on the ones it did save.
+// The file is the same as a full save as long as the sub-systems report their
+// changes honestly.  Use one snapshot per kind of file (e.g. the autosave).
+//
+//////////////////////////////////////////////////////////////////////////////////
+class SaveSnapshotClass
+{
+public:
+
+	SaveSnapshotClass (void);
+	~SaveSnapshotClass (void);
+
+	/*
+	** Forget everything so that the next save is a full save
+	*/
+	void					Reset (void);
+
+	/*
+	** Bytes kept by the snapshot
+	*/
+	int					Get_Size (void) const;
+
+private:
+
+	struct EntryStruct
+	{
+		SaveLoadSubSystemClass *	SubSystem;
+		MemoryFileClass				Data;
+		bool								IsValid;
+	};
+
+	EntryStruct *		Get_Entry (SaveLoadSubSystemClass * subsystem);
+
+	DynamicVectorClass<EntryStruct *>	Entries;
+
+	friend class SaveLoadSystemClass;
+
+	// Not Implemented
+	SaveSnapshotClass (const SaveSnapshotClass &);
+	SaveSnapshotClass & operator= (const SaveSnapshotClass &);
+};
+
+
+//////////////////////////////////////////////////////////////////////////////////
+//
+//	PersistCacheClass
+//
+// Incremental saving for the objects inside a sub-system.  Save() writes an
+// object the usual way (a chunk with the factory's id around Get_Factory().Save)
+// but keeps the bytes and writes them again on later saves until the object is
+// marked dirty.  The owner of the objects must call Set_Dirty() when one is
+// added or changes and Remove() before one is deleted; a cache entry is keyed
+// by the object's address, which a new object could otherwise re-use.
+//
+// Has_Changed() reports whether anything was marked since Clear_Changed(), 
+// which is what the owning sub-system usually wants to return from its own 
+// Has_Changed().  A cache isn't thread safe, but a sub-system saving on a 
+// worker thread can use its own.
+//
+//////////////////////////////////////////////////////////////////////////////////
+class PersistCacheClass
+{
+public:
+
+	PersistCacheClass (void);
+	~PersistCacheClass (void);
+
+	bool					Save (ChunkSaveClass & csave, PersistClass * obj);
+
+	void					Set_Dirty (PersistClass * obj);
+	void					Set_All_Dirty (void);
+	void					Remove (PersistClass * obj);
+	void					Reset (void);
+
+	bool					Has_Changed (void) const						{ return IsChanged; }
+	void					Clear_Changed (void)								{ IsChanged = false; }
+
+	int					Get_Count (void) const							{ return Count; }
+
+private:
+
+	struct EntryStruct
+	{
+		unsigned char *	Data;
+		int					Size;
+		bool					IsDirty;
+	};
+
+	HashTemplateClass<PersistClass *,EntryStruct *>		Entries;
+	MemoryFileClass												Scratch;
+	int																Count;
+	bool																IsChanged;
+
+	// Not Implemented
+	PersistCacheClass (const PersistCacheClass &);
+	PersistCacheClass & operator= (const PersistCacheClass &);
+};
+
+
+#endif //SAVESNAPSHOT_H
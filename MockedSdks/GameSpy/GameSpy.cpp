@@ -13,6 +13,15 @@ int qr_init(qr_t*, const char*, unsigned short, const char*, const char*, qr_cal
     return 0;
 }
 
+int qr_init_socket(qr_t*, SOCKET, const char*, const char*, qr_callback, qr_callback, qr_callback, qr_callback, void*)
+{
+    return 0;
+}
+
+void qr_parse_query(qr_t, char*, struct sockaddr*)
+{
+}
+
 void qr_shutdown(qr_t)
 {
 }
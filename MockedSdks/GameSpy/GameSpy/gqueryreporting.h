@@ -1,5 +1,7 @@
 #pragma once
 
+#include <winsock.h>
+
 #include "gtypes.h"
 
 typedef void (*qr_callback)(char*, int, void*);
@@ -14,6 +16,17 @@ int qr_init(
     qr_callback,
     qr_callback,
     void*);
+int qr_init_socket(
+    qr_t*,
+    SOCKET,
+    const char*,
+    const char*,
+    qr_callback,
+    qr_callback,
+    qr_callback,
+    qr_callback,
+    void*);
+void qr_parse_query(qr_t, char*, struct sockaddr*);
 void qr_shutdown(qr_t);
 void qr_send_exiting(qr_t);
 void qr_process_queries(qr_t);